@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -27,24 +27,43 @@
  */
 
 #include "apps/oskar_option_parser.h"
-#include "vis/oskar_vis.h"
+#include "binary/oskar_binary.h"
+#include "ms/oskar_measurement_set.h"
+#include "utility/oskar_dir.h"
 #include "utility/oskar_get_error_string.h"
 #include "utility/oskar_version_string.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
 
 #include <string>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <cfloat>
 #include <vector>
 #include <iomanip>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace oskar;
 
 // -----------------------------------------------------------------------------
 static void set_options(OptionParser& opt);
 static bool check_options(OptionParser& opt, int argc, char** argv);
-static bool isCompatible(const oskar_Vis* vis1, const oskar_Vis* vis2);
+static bool is_ms(const string& filename);
+static bool is_compatible(const oskar_VisHeader* h1, const oskar_VisHeader* h2);
+static int add_vis_files(const vector<string>& in_files,
+        const string& out_path, bool verbose);
+#ifndef OSKAR_NO_MS
+static int add_ms(const vector<string>& in_files, const string& out_path,
+        bool verbose);
+static void copy_dir(const string& src, const string& dst, int* status);
+#endif
 static void print_error(int status, const char* message);
 // -----------------------------------------------------------------------------
 
@@ -62,6 +81,17 @@ int main(int argc, char** argv)
     bool verbose = opt.is_set("-q") ? false : true;
     int num_in_files = (int)in_files.size();
 
+    // Check whether inputs are Measurement Sets.
+    int num_ms = 0;
+    for (int i = 0; i < num_in_files; ++i)
+        if (is_ms(in_files[i])) num_ms++;
+    if (num_ms > 0 && (num_ms != num_in_files || !is_ms(out_path)))
+    {
+        cerr << "ERROR: Measurement Sets can only be combined with other "
+                "Measurement Sets." << endl;
+        return OSKAR_ERR_INVALID_ARGUMENT;
+    }
+
     // Print if verbose.
     if (verbose)
     {
@@ -74,60 +104,317 @@ int main(int argc, char** argv)
     }
 
     // Add the data. ==========================================================
-    int status = 0;
-
-    // Load the first visibility structure.
-    oskar_Binary* h;
-    h = oskar_binary_create(in_files[0].c_str(), 'r', &status);
-    oskar_Vis* out = oskar_vis_read(h, &status);
-    oskar_binary_free(h);
-    if (status)
+    if (num_ms > 0)
     {
-        string msg = "Failed to read visibility data file " + in_files[0];
-        print_error(status, msg.c_str());
+#ifndef OSKAR_NO_MS
+        return add_ms(in_files, out_path, verbose);
+#else
+        print_error(OSKAR_ERR_FUNCTION_NOT_AVAILABLE,
+                "OSKAR was not compiled with Measurement Set support.");
+        return OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+#endif
     }
-    oskar_mem_clear_contents(oskar_vis_settings_path(out), &status);
-    // TODO write some sort of tag into here to indicate this is an
-    // accumulated visibility data set...
+    return add_vis_files(in_files, out_path, verbose);
+}
 
-    // Loop over other visibility files and combine.
-    for (int i = 1; i < num_in_files; ++i)
-    {
-        if (status) break;
+// Sums OSKAR visibility files one block at a time, so that memory use
+// depends only on the block size and the number of threads.
+static int add_vis_files(const vector<string>& in_files,
+        const string& out_path, bool verbose)
+{
+    int status = 0;
+    int num_in_files = (int)in_files.size();
+    vector<oskar_Binary*> h(num_in_files, (oskar_Binary*)0);
+    vector<oskar_VisHeader*> hdr(num_in_files, (oskar_VisHeader*)0);
 
-        h = oskar_binary_create(in_files[i].c_str(), 'r', &status);
-        oskar_Vis* in = oskar_vis_read(h, &status);
-        oskar_binary_free(h);
+    // Open all the input files and read their headers.
+    for (int i = 0; i < num_in_files; ++i)
+    {
+        h[i] = oskar_binary_create(in_files[i].c_str(), 'r', &status);
+        hdr[i] = oskar_vis_header_read(h[i], &status);
         if (status)
         {
-            string msg = "Failed to read visibility data file " + in_files[i];
+            string msg = "Failed to read visibility data file " + in_files[i] +
+                    " (older files may need oskar_vis_upgrade_format)";
             print_error(status, msg.c_str());
             break;
         }
-        if (!isCompatible(out, in))
+        if (i > 0 && !is_compatible(hdr[0], hdr[i]))
         {
             cerr << "ERROR: Input visibility data must match!" << endl;
             status = OSKAR_ERR_TYPE_MISMATCH;
+            break;
+        }
+    }
+
+    // Inputs other than the first are read in batches, one per thread.
+    int batch_size = 1;
+#ifdef _OPENMP
+    batch_size = omp_get_max_threads();
+#endif
+    if (batch_size > num_in_files - 1) batch_size = num_in_files - 1;
+    if (batch_size < 1) batch_size = 1;
+    oskar_VisBlock* acc = 0;
+    vector<oskar_VisBlock*> blk(batch_size, (oskar_VisBlock*)0);
+    vector<int> blk_status(batch_size, 0);
+
+    // Create the output file, and the blocks to read into.
+    oskar_Binary* h_out = 0;
+#ifndef OSKAR_NO_MS
+    oskar_MeasurementSet* ms_out = 0;
+#endif
+    if (!status)
+    {
+        if (is_ms(out_path))
+        {
+#ifndef OSKAR_NO_MS
+            ms_out = oskar_vis_header_write_ms(hdr[0], out_path.c_str(), 1,
+                    0, &status);
+#else
+            status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+#endif
+        }
+        else
+            h_out = oskar_vis_header_write(hdr[0], out_path.c_str(), &status);
+        if (status)
+            print_error(status, "Failed to create output file.");
+        acc = oskar_vis_block_create_from_header(OSKAR_CPU, hdr[0], &status);
+        for (int j = 0; j < batch_size; ++j)
+            blk[j] = oskar_vis_block_create_from_header(OSKAR_CPU, hdr[0],
+                    &status);
+    }
+
+    // Loop over blocks.
+    int num_blocks = 0;
+    if (!status)
+    {
+        int max_times_per_block = oskar_vis_header_max_times_per_block(hdr[0]);
+        int num_times = oskar_vis_header_num_times_total(hdr[0]);
+        num_blocks = (num_times + max_times_per_block - 1) /
+                max_times_per_block;
+    }
+    for (int b = 0; b < num_blocks; ++b)
+    {
+        if (status) break;
+        if (verbose)
+            cout << "Adding block " << b + 1 << "/" << num_blocks << endl;
+        oskar_vis_block_read(acc, hdr[0], h[0], b, &status);
+        oskar_Mem* xc = oskar_vis_block_cross_correlations(acc);
+        oskar_Mem* ac = oskar_vis_block_auto_correlations(acc);
+        for (int i = 1; i < num_in_files; i += batch_size)
+        {
+            if (status) break;
+            int n = num_in_files - i;
+            if (n > batch_size) n = batch_size;
+
+            // Read the next batch of inputs in parallel.
+#pragma omp parallel for
+            for (int j = 0; j < n; ++j)
+            {
+                blk_status[j] = 0;
+                oskar_vis_block_read(blk[j], hdr[i + j], h[i + j], b,
+                        &blk_status[j]);
+            }
+
+            // Add them to the output block, in input order.
+            for (int j = 0; j < n; ++j)
+            {
+                if (blk_status[j] && !status)
+                {
+                    status = blk_status[j];
+                    string msg = "Failed to read visibility data file " +
+                            in_files[i + j];
+                    print_error(status, msg.c_str());
+                }
+                if (status) break;
+                if (oskar_vis_block_has_cross_correlations(acc))
+                    oskar_mem_add(xc, xc,
+                            oskar_vis_block_cross_correlations_const(blk[j]),
+                            oskar_mem_length(xc), &status);
+                if (oskar_vis_block_has_auto_correlations(acc))
+                    oskar_mem_add(ac, ac,
+                            oskar_vis_block_auto_correlations_const(blk[j]),
+                            oskar_mem_length(ac), &status);
+                if (status)
+                    print_error(status, "Visibility amplitude addition failed.");
+            }
         }
-        oskar_mem_add(oskar_vis_amplitude(out), oskar_vis_amplitude_const(out),
-                oskar_vis_amplitude_const(in),
-                oskar_mem_length(oskar_vis_amplitude(out)), &status);
+
+        // Write the combined block.
+        if (h_out)
+            oskar_vis_block_write(acc, h_out, b, &status);
+#ifndef OSKAR_NO_MS
+        else if (ms_out)
+            oskar_vis_block_write_ms(acc, hdr[0], ms_out, &status);
+#endif
         if (status)
-            print_error(status, "Visibility amplitude addition failed.");
-        oskar_vis_free(in, &status);
+            print_error(status, "Failed writing output visibility block.");
+    }
+
+    // Clean up.
+    oskar_binary_free(h_out);
+#ifndef OSKAR_NO_MS
+    if (ms_out) oskar_ms_close(ms_out);
+#endif
+    oskar_vis_block_free(acc, &status);
+    for (int j = 0; j < batch_size; ++j)
+        oskar_vis_block_free(blk[j], &status);
+    for (int i = 0; i < num_in_files; ++i)
+    {
+        oskar_vis_header_free(hdr[i], &status);
+        oskar_binary_free(h[i]);
     }
+    return status;
+}
 
-    // Write output data ======================================================
+#ifndef OSKAR_NO_MS
+// Sums the DATA columns of Measurement Sets a range of rows at a time.
+// The output is created as a copy of the first input.
+static int add_ms(const vector<string>& in_files, const string& out_path,
+        bool verbose)
+{
+    int status = 0;
+    int num_in_files = (int)in_files.size();
+    vector<oskar_MeasurementSet*> ms(num_in_files, (oskar_MeasurementSet*)0);
+
+    // Copy the first input to the output.
     if (verbose)
-        cout << "Writing OSKAR visibility file: " << out_path << endl;
-    oskar_vis_write(out, 0, out_path.c_str(), &status);
-    oskar_vis_free(out, &status);
+        cout << "Copying " << in_files[0] << " to " << out_path << endl;
+    copy_dir(in_files[0], out_path, &status);
     if (status)
-        print_error(status, "Failed writing output visibility structure to file.");
+    {
+        print_error(status, "Failed to copy Measurement Set.");
+        return status;
+    }
+
+    // Open the output and the other inputs, and check dimensions match.
+    ms[0] = oskar_ms_open(out_path.c_str());
+    for (int i = 0; i < num_in_files; ++i)
+    {
+        if (i > 0) ms[i] = oskar_ms_open(in_files[i].c_str());
+        if (!ms[i])
+        {
+            status = OSKAR_ERR_FILE_IO;
+            string msg = "Failed to open Measurement Set " + in_files[i];
+            print_error(status, msg.c_str());
+            break;
+        }
+        if (oskar_ms_num_rows(ms[i]) != oskar_ms_num_rows(ms[0]) ||
+                oskar_ms_num_channels(ms[i]) != oskar_ms_num_channels(ms[0]) ||
+                oskar_ms_num_pols(ms[i]) != oskar_ms_num_pols(ms[0]) ||
+                oskar_ms_num_stations(ms[i]) != oskar_ms_num_stations(ms[0]))
+        {
+            cerr << "ERROR: Input Measurement Sets must match!" << endl;
+            status = OSKAR_ERR_DIMENSION_MISMATCH;
+            break;
+        }
+    }
+
+    // Loop over chunks of rows, limiting each buffer to about 64 MB.
+    if (!status)
+    {
+        unsigned int num_rows = oskar_ms_num_rows(ms[0]);
+        unsigned int num_channels = oskar_ms_num_channels(ms[0]);
+        size_t row_len = 2 * num_channels * oskar_ms_num_pols(ms[0]);
+        unsigned int rows_per_chunk = (unsigned int)
+                ((64 * 1024 * 1024) / (row_len * sizeof(float)));
+        if (rows_per_chunk < 1) rows_per_chunk = 1;
+        vector<float> acc(row_len * rows_per_chunk);
+        vector<float> in(row_len * rows_per_chunk);
+        for (unsigned int r = 0; r < num_rows; r += rows_per_chunk)
+        {
+            if (status) break;
+            unsigned int n = num_rows - r;
+            if (n > rows_per_chunk) n = rows_per_chunk;
+            const int len = (int)(row_len * n);
+            oskar_ms_read_vis_f(ms[0], r, 0, num_channels, n, "DATA",
+                    &acc[0], &status);
+            for (int i = 1; i < num_in_files; ++i)
+            {
+                oskar_ms_read_vis_f(ms[i], r, 0, num_channels, n, "DATA",
+                        &in[0], &status);
+                if (status) break;
+#pragma omp parallel for
+                for (int k = 0; k < len; ++k)
+                    acc[k] += in[k];
+            }
+            if (status)
+                print_error(status, "Failed to read Measurement Set data.");
+            else
+                oskar_ms_write_vis_f(ms[0], r, 0, num_channels, n, &acc[0]);
+        }
+    }
 
+    // Clean up.
+    for (int i = 0; i < num_in_files; ++i)
+        if (ms[i]) oskar_ms_close(ms[i]);
     return status;
 }
 
+// Recursively copies a directory.
+static void copy_dir(const string& src, const string& dst, int* status)
+{
+    int num_items = 0;
+    char** items = 0;
+    if (*status) return;
+    if (!oskar_dir_exists(src.c_str()) || !oskar_dir_mkpath(dst.c_str()))
+    {
+        *status = OSKAR_ERR_FILE_IO;
+        return;
+    }
+
+    // Copy files.
+    oskar_dir_items(src.c_str(), NULL, 1, 0, &num_items, &items);
+    vector<char> buffer(1024 * 1024);
+    for (int i = 0; i < num_items; ++i)
+    {
+        char* src_path = oskar_dir_get_path(src.c_str(), items[i]);
+        char* dst_path = oskar_dir_get_path(dst.c_str(), items[i]);
+        FILE* in = fopen(src_path, "rb");
+        FILE* out = fopen(dst_path, "wb");
+        if (!in || !out) *status = OSKAR_ERR_FILE_IO;
+        while (!*status)
+        {
+            size_t n = fread(&buffer[0], 1, buffer.size(), in);
+            if (n == 0) break;
+            if (fwrite(&buffer[0], 1, n, out) != n)
+                *status = OSKAR_ERR_FILE_IO;
+        }
+        if (in) fclose(in);
+        if (out) fclose(out);
+        free(src_path);
+        free(dst_path);
+        free(items[i]);
+    }
+    free(items);
+
+    // Copy sub-directories.
+    items = 0;
+    oskar_dir_items(src.c_str(), NULL, 0, 1, &num_items, &items);
+    for (int i = 0; i < num_items; ++i)
+    {
+        char* src_path = oskar_dir_get_path(src.c_str(), items[i]);
+        char* dst_path = oskar_dir_get_path(dst.c_str(), items[i]);
+        copy_dir(string(src_path), string(dst_path), status);
+        free(src_path);
+        free(dst_path);
+        free(items[i]);
+    }
+    free(items);
+}
+#endif
+
+static bool is_ms(const string& filename)
+{
+    size_t len = filename.length();
+    if (len < 3) return false;
+    string ext = filename.substr(len - 3);
+    if (ext == ".MS" || ext == ".ms") return true;
+    if (len > 4 && (filename.substr(len - 4) == ".MS/" ||
+            filename.substr(len - 4) == ".ms/")) return true;
+    return false;
+}
+
 static void print_error(int status, const char* message)
 {
     cerr << "ERROR[" << status << "] " << message << endl;
@@ -135,40 +422,51 @@ static void print_error(int status, const char* message)
 }
 
 
-static bool isCompatible(const oskar_Vis* v1, const oskar_Vis* v2)
+static bool is_compatible(const oskar_VisHeader* v1, const oskar_VisHeader* v2)
 {
-    if (oskar_vis_num_channels(v1) != oskar_vis_num_channels(v2))
+    if (oskar_vis_header_num_channels_total(v1) !=
+            oskar_vis_header_num_channels_total(v2))
         return false;
-    if (oskar_vis_num_times(v1) != oskar_vis_num_times(v2))
+    if (oskar_vis_header_num_times_total(v1) !=
+            oskar_vis_header_num_times_total(v2))
         return false;
-    if (oskar_vis_num_stations(v1) != oskar_vis_num_stations(v2))
+    if (oskar_vis_header_num_stations(v1) != oskar_vis_header_num_stations(v2))
         return false;
-    if (oskar_vis_num_baselines(v1) != oskar_vis_num_baselines(v2))
+    if (oskar_vis_header_max_times_per_block(v1) !=
+            oskar_vis_header_max_times_per_block(v2))
         return false;
-    if (fabs(oskar_vis_freq_start_hz(v1) -
-            oskar_vis_freq_start_hz(v2)) > DBL_EPSILON)
+    if (oskar_vis_header_max_channels_per_block(v1) !=
+            oskar_vis_header_max_channels_per_block(v2))
         return false;
-    if (fabs(oskar_vis_freq_inc_hz(v1) -
-            oskar_vis_freq_inc_hz(v2)) > DBL_EPSILON)
+    if (oskar_vis_header_write_auto_correlations(v1) !=
+            oskar_vis_header_write_auto_correlations(v2))
         return false;
-    if (fabs(oskar_vis_channel_bandwidth_hz(v1) -
-            oskar_vis_channel_bandwidth_hz(v2)) > DBL_EPSILON)
+    if (oskar_vis_header_write_cross_correlations(v1) !=
+            oskar_vis_header_write_cross_correlations(v2))
         return false;
-    if (fabs(oskar_vis_time_start_mjd_utc(v1) -
-            oskar_vis_time_start_mjd_utc(v2)) > DBL_EPSILON)
+    if (fabs(oskar_vis_header_freq_start_hz(v1) -
+            oskar_vis_header_freq_start_hz(v2)) > DBL_EPSILON)
         return false;
-    if (fabs(oskar_vis_time_inc_sec(v1) -
-            oskar_vis_time_inc_sec(v2)) > DBL_EPSILON)
+    if (fabs(oskar_vis_header_freq_inc_hz(v1) -
+            oskar_vis_header_freq_inc_hz(v2)) > DBL_EPSILON)
         return false;
-    if (fabs(oskar_vis_phase_centre_ra_deg(v1) -
-            oskar_vis_phase_centre_ra_deg(v2)) > DBL_EPSILON)
+    if (fabs(oskar_vis_header_channel_bandwidth_hz(v1) -
+            oskar_vis_header_channel_bandwidth_hz(v2)) > DBL_EPSILON)
         return false;
-    if (fabs(oskar_vis_phase_centre_dec_deg(v1) -
-            oskar_vis_phase_centre_dec_deg(v2)) > DBL_EPSILON)
+    if (fabs(oskar_vis_header_time_start_mjd_utc(v1) -
+            oskar_vis_header_time_start_mjd_utc(v2)) > DBL_EPSILON)
+        return false;
+    if (fabs(oskar_vis_header_time_inc_sec(v1) -
+            oskar_vis_header_time_inc_sec(v2)) > DBL_EPSILON)
+        return false;
+    if (fabs(oskar_vis_header_phase_centre_ra_deg(v1) -
+            oskar_vis_header_phase_centre_ra_deg(v2)) > DBL_EPSILON)
+        return false;
+    if (fabs(oskar_vis_header_phase_centre_dec_deg(v1) -
+            oskar_vis_header_phase_centre_dec_deg(v2)) > DBL_EPSILON)
         return false;
 
-    if (oskar_mem_type(oskar_vis_amplitude_const(v1)) !=
-            oskar_mem_type(oskar_vis_amplitude_const(v2)))
+    if (oskar_vis_header_amp_type(v1) != oskar_vis_header_amp_type(v2))
         return false;
 
     return true;
@@ -176,12 +474,15 @@ static bool isCompatible(const oskar_Vis* v1, const oskar_Vis* v2)
 
 static void set_options(OptionParser& opt)
 {
-    opt.set_description("Application to combine OSKAR binary visibility files.");
-    opt.add_required("OSKAR visibility files...");
+    opt.set_description("Application to combine OSKAR binary visibility "
+            "files, or Measurement Sets, by adding their visibilities.");
+    opt.add_required("OSKAR visibility files or Measurement Sets...");
     opt.add_flag("-o", "Output visibility file name", 1, "out.vis", false, "--output");
     opt.add_flag("-q", "Disable log messages", false, "--quiet");
     opt.add_example("oskar_vis_add file1.vis file2.vis");
     opt.add_example("oskar_vis_add file1.vis file2.vis -o combined.vis");
+    opt.add_example("oskar_vis_add file1.vis file2.vis -o combined.ms");
+    opt.add_example("oskar_vis_add file1.ms file2.ms -o combined.ms");
     opt.add_example("oskar_vis_add -q file1.vis file2.vis file3.vis");
     opt.add_example("oskar_vis_add *.vis");
 }
@@ -201,4 +502,3 @@ static bool check_options(OptionParser& opt, int argc, char** argv)
     }
     return true;
 }
-
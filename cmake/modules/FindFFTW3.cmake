@@ -0,0 +1,37 @@
+# - Find FFTW3
+#==============================================================================
+# Find the native FFTW3 includes and libraries, including the single
+# precision and multi-threaded versions.
+#
+#  FFTW3_INC_DIR         - Specify to choose a non-standard location to
+#                          search for fftw3.h
+#  FFTW3_LIB_DIR         - Specify to choose a non-standard location to
+#                          search for libraries
+#  FFTW3_INCLUDE_DIR     - Where to find fftw3.h
+#  FFTW3_LIBRARIES       - List of libraries when using FFTW3.
+#  FFTW3_FOUND           - True if FFTW3 found.
+#==============================================================================
+
+find_path(FFTW3_INCLUDE_DIR fftw3.h HINTS ${FFTW3_INC_DIR})
+set(fftw3_modules fftw3_threads fftw3f_threads fftw3 fftw3f)
+foreach (module ${fftw3_modules})
+    find_library(FFTW3_LIBRARY_${module} NAMES ${module}
+        HINTS ${FFTW3_LIB_DIR}
+        PATH_SUFFIXES lib)
+    mark_as_advanced(FFTW3_LIBRARY_${module})
+    if (FFTW3_LIBRARY_${module})
+        list(APPEND FFTW3_LIBRARIES ${FFTW3_LIBRARY_${module}})
+    else()
+        set(FFTW3_MISSING_LIBRARY TRUE)
+    endif()
+endforeach()
+if (FFTW3_MISSING_LIBRARY)
+    set(FFTW3_LIBRARIES)
+endif()
+
+# handle the QUIETLY and REQUIRED arguments and set FFTW3_FOUND to TRUE if
+# all listed variables are TRUE
+include(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(FFTW3 DEFAULT_MSG
+    FFTW3_LIBRARIES FFTW3_INCLUDE_DIR)
+mark_as_advanced(FFTW3_INCLUDE_DIR)
@@ -67,6 +67,31 @@ if (NOT WIN32)
             -fvisibility=hidden
             -fdiagnostics-show-option)
 
+        # Check for the glibc vector math library (libmvec), so that
+        # loops over sin() and cos() can be vectorised.
+        if ("${CMAKE_C_COMPILER_ID}" STREQUAL "GNU" AND
+                "${CMAKE_SYSTEM_PROCESSOR}" MATCHES "x86_64|AMD64")
+            include(CheckCSourceCompiles)
+            set(CMAKE_REQUIRED_LIBRARIES m)
+            check_c_source_compiles("
+                #include <emmintrin.h>
+                __m128d _ZGVbN2v_cos(__m128d);
+                __m128d _ZGVbN2v_sin(__m128d);
+                __m128 _ZGVbN4v_cosf(__m128);
+                __m128 _ZGVbN4v_sinf(__m128);
+                int main(void) {
+                    __m128d d = _ZGVbN2v_cos(_mm_set1_pd(1.0));
+                    __m128 f = _ZGVbN4v_cosf(_mm_set1_ps(1.0f));
+                    d = _mm_add_pd(d, _ZGVbN2v_sin(d));
+                    f = _mm_add_ps(f, _ZGVbN4v_sinf(f));
+                    return (int) (_mm_cvtsd_f64(d) + _mm_cvtss_f32(f));
+                }" OSKAR_HAVE_VECTOR_MATH)
+            unset(CMAKE_REQUIRED_LIBRARIES)
+            if (OSKAR_HAVE_VECTOR_MATH)
+                add_definitions(-DOSKAR_HAVE_VECTOR_MATH)
+            endif()
+        endif()
+
          # Additional test flags
 #        append_flags(CMAKE_C_FLAGS
 #            -Wbad-function-cast -Wstack-protector -Wpacked
@@ -269,6 +294,9 @@ if (BUILD_INFO)
     if (CASACORE_FOUND)
         message(STATUS "CASACORE      : ${CASACORE_LIBRARIES}")
     endif()
+    if (FFTW3_FOUND)
+        message(STATUS "FFTW          : ${FFTW3_LIBRARIES}")
+    endif()
     message(STATUS "C++ compiler  : ${CMAKE_CXX_COMPILER}")
     message(STATUS "C compiler    : ${CMAKE_C_COMPILER}")
     if (DEFINED NVCC_COMPILER_BINDIR)
@@ -65,6 +65,11 @@ oskar_Imager* oskar_settings_to_imager(oskar::SettingsTree* s,
         oskar_imager_set_num_devices(h, -1);
     else
         oskar_imager_set_num_devices(h, s->to_int("num_devices", status));
+    if (s->starts_with("num_grid_threads", "auto", status))
+        oskar_imager_set_num_grid_threads(h, -1);
+    else
+        oskar_imager_set_num_grid_threads(h,
+                s->to_int("num_grid_threads", status));
 
     // Set input and output files.
     int num_files = 0;
@@ -75,6 +80,7 @@ oskar_Imager* oskar_settings_to_imager(oskar::SettingsTree* s,
             s->to_int("scale_norm_with_num_input_files", status));
     oskar_imager_set_ms_column(h,
             s->to_string("ms_column", status), status);
+    oskar_imager_set_read_ahead(h, s->to_int("read_ahead", status));
     oskar_imager_set_output_root(h, s->to_string("root_path", status));
 
     // Set remaining imager options.
@@ -52,6 +52,8 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
         oskar_interferometer_set_gpus(h, 0, 0, status);
     else
     {
+        oskar_interferometer_set_use_opencl(h,
+                s->to_int("use_opencl", status), status);
         if (s->starts_with("cuda_device_ids", "all", status))
             oskar_interferometer_set_gpus(h, -1, 0, status);
         else
@@ -108,6 +110,9 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
             s->to_string("ms_filename", status));
     oskar_interferometer_set_force_polarised_ms(h,
             s->to_int("force_polarised_ms", status));
+    oskar_interferometer_set_bda(h, s->to_int("enable_bda", status),
+            s->to_double("enable_bda/max_average_duration_sec", status),
+            s->to_double("enable_bda/max_uvw_distance", status));
     s->end_group();
 
     // Return handle to interferometer simulator.
@@ -36,6 +36,7 @@
 #include <limits.h>
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 
 using oskar::SettingsTree;
 
@@ -43,6 +44,7 @@ using oskar::SettingsTree;
 
 /* Private functions. */
 static void set_station_data(oskar_Station* station, SettingsTree* s,
+        std::vector<const oskar_Element*>& tabulated, double* max_lut_error,
         int* status);
 
 oskar_Telescope* oskar_settings_to_telescope(SettingsTree* s,
@@ -147,8 +149,16 @@ oskar_Telescope* oskar_settings_to_telescope(SettingsTree* s,
             break;
         }
     }
+    double max_lut_error = 0.0;
+    std::vector<const oskar_Element*> tabulated;
     for (int i = 0; i < num_stations; ++i)
-        set_station_data(oskar_telescope_station(t, i), s, status);
+        set_station_data(oskar_telescope_station(t, i), s, tabulated,
+                &max_lut_error, status);
+    s->clear_group();
+    if (!*status && s->to_double("telescope/aperture_array/element_pattern/"
+            "lut_resolution_deg", status) > 0.0)
+        oskar_log_message(log, 'M', 0, "Tabulated element patterns: "
+                "max fractional interpolation error %.3e", max_lut_error);
 
     /* Apply element level overrides. */
     s->clear_group();
@@ -237,7 +247,9 @@ oskar_Telescope* oskar_settings_to_telescope(SettingsTree* s,
 }
 
 
-void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
+void set_station_data(oskar_Station* station, SettingsTree* s,
+        std::vector<const oskar_Element*>& tabulated, double* max_lut_error,
+        int* status)
 {
     if (*status) return;
     s->clear_group();
@@ -261,6 +273,7 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
     char taper_type = s->first_letter("taper/type", status);
     double cosine_power = s->to_double("taper/cosine_power", status);
     double fwhm_rad = s->to_double("taper/gaussian_fwhm_deg", status) * D2R;
+    double lut_res_rad = s->to_double("lut_resolution_deg", status) * D2R;
     for (int i = 0; i < oskar_station_num_element_types(station); ++i)
     {
         oskar_Element* element = oskar_station_element(station, i);
@@ -269,6 +282,22 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
         oskar_element_set_taper_type(element, &taper_type, status);
         oskar_element_set_cosine_power(element, cosine_power);
         oskar_element_set_gaussian_fwhm_rad(element, fwhm_rad);
+        if (lut_res_rad <= 0.0) continue;
+
+        /* Share tables with an identical element, if already tabulated. */
+        size_t j = 0;
+        for (; j < tabulated.size(); ++j)
+            if (!oskar_element_different(element, tabulated[j], status))
+                break;
+        if (j < tabulated.size())
+            oskar_element_share_tables(element, tabulated[j], status);
+        else
+        {
+            double lut_error = 0.0;
+            oskar_element_tabulate(element, lut_res_rad, &lut_error, status);
+            if (lut_error > *max_lut_error) *max_lut_error = lut_error;
+            tabulated.push_back(element);
+        }
     }
 
     /* Recursively set data for child stations. */
@@ -276,6 +305,7 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
     {
         int num_elements = oskar_station_num_elements(station);
         for (int i = 0; i < num_elements; ++i)
-            set_station_data(oskar_station_child(station, i), s, status);
+            set_station_data(oskar_station_child(station, i), s,
+                    tabulated, max_lut_error, status);
     }
 }
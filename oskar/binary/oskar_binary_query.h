@@ -108,6 +108,33 @@ int oskar_binary_query(const oskar_Binary* handle,
         unsigned char data_type, unsigned char id_group, unsigned char id_tag,
         int user_index, size_t* payload_size, int* status);
 
+/**
+ * @brief Return the payload size associated with a standard tag.
+ *
+ * @details
+ * This function is the same as oskar_binary_query(), except that the
+ * search starts from the given index rather than from the index set
+ * using oskar_binary_set_query_search_start().
+ *
+ * As it does not use any state in the handle, this function may be
+ * called concurrently from multiple threads.
+ *
+ * @param[in] handle        Binary data handle.
+ * @param[in] search_start  Index at which to start search query.
+ * @param[in] data_type     Type of the memory. If 0, the type is not checked.
+ * @param[in] id_group      Tag group identifier.
+ * @param[in] id_tag        Tag identifier.
+ * @param[in] user_index    User-defined index.
+ * @param[out] payload_size Payload size in bytes.
+ * @param[in,out] status    Status return code.
+ *
+ * @return Sequence index of the tag in the file, or -1 if not found.
+ */
+OSKAR_BINARY_EXPORT
+int oskar_binary_query_from(const oskar_Binary* handle, int search_start,
+        unsigned char data_type, unsigned char id_group, unsigned char id_tag,
+        int user_index, size_t* payload_size, int* status);
+
 /**
  * @brief Return the payload size associated with an extended tag.
  *
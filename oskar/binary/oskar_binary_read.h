@@ -49,6 +49,10 @@ extern "C" {
  * The tag is specified by its sequence number in the stream, as returned by
  * oskar_binary_query() or oskar_binary_query_ext().
  *
+ * If the file is memory-mapped (see oskar_binary_create()), the data are
+ * copied out of the mapped region, and this function may be called
+ * concurrently from multiple threads using the same handle.
+ *
  * @param[in,out] handle   Binary file handle.
  * @param[in] chunk_index  Sequence index of the chunk's tag in the file.
  * @param[in] data_size    Size of memory available at \p data, in bytes.
@@ -59,6 +63,54 @@ OSKAR_BINARY_EXPORT
 void oskar_binary_read_block(oskar_Binary* handle,
         int chunk_index, size_t data_size, void* data, int* status);
 
+/**
+ * @brief Returns a pointer to the payload of a chunk in a mapped file.
+ *
+ * @details
+ * This function returns a pointer to the payload of a single chunk
+ * in a file that has been opened in mode 'm', without copying any data.
+ * The CRC code of the chunk is checked first, if present.
+ *
+ * The memory is read-only and must not be written to. It is valid only
+ * until oskar_binary_free() is called. Note that the payload is not
+ * guaranteed to be aligned to the size of its data type.
+ *
+ * If the file is not memory-mapped, this function returns NULL
+ * without setting an error, and oskar_binary_read_block() should be
+ * used instead.
+ *
+ * This function may be called concurrently from multiple threads.
+ *
+ * @param[in] handle       Binary file handle.
+ * @param[in] chunk_index  Sequence index of the chunk's tag in the file.
+ * @param[in,out] status   Status return code.
+ *
+ * @return Pointer to the payload, or NULL if the file is not mapped.
+ */
+OSKAR_BINARY_EXPORT
+void* oskar_binary_map_block(const oskar_Binary* handle,
+        int chunk_index, int* status);
+
+/**
+ * @brief Hints that a range of chunks in a mapped file will be read soon.
+ *
+ * @details
+ * This function advises the operating system to start reading the
+ * payloads of the given range of chunks into memory, so that they are
+ * already resident by the time they are accessed.
+ *
+ * Chunks outside the file are ignored.
+ * If the file is not memory-mapped, this function does nothing.
+ *
+ * @param[in] handle       Binary file handle.
+ * @param[in] start_chunk  Sequence index of the first chunk in the range.
+ * @param[in] num_chunks   Number of chunks in the range.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_BINARY_EXPORT
+void oskar_binary_prefetch(const oskar_Binary* handle,
+        int start_chunk, int num_chunks, int* status);
+
 /**
  * @brief Reads a block of binary data for a single tag from an input stream.
  *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, The University of Oxford
+ * Copyright (c) 2014-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -99,7 +99,9 @@ void oskar_crc_free(oskar_CRC* data);
  * @details
  * Updates a CRC value with new data.
  *
- * Uses Intel's "slicing-by-8" algorithm for speed:
+ * For CRC-32C, hardware instructions are used if the CPU supports them
+ * (SSE4.2 on x86-64, or the CRC extension on 64-bit ARM).
+ * Otherwise, this uses Intel's "slicing-by-8" algorithm for speed:
  * http://sourceforge.net/projects/slicing-by-8/
  * http://web.archive.org/web/20121011093914/http://www.intel.com/technology/comms/perfnet/download/CRC_generators.pdf
  * http://create.stephan-brumme.com/crc32/
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -174,6 +174,8 @@ struct oskar_Binary
     int bin_version;            /* Binary format version number. */
     int query_search_start;     /* Index at which to start search query. */
     char open_mode;             /* Mode in which file was opened (read/write). */
+    char* map;                  /* File contents, if memory-mapped. */
+    size_t map_size;            /* Size of memory-mapped region, in bytes. */
 
     /* Tag data. */
     int num_chunks;             /* Number of tags in the index. */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -33,6 +33,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -44,6 +51,7 @@ static void oskar_binary_read_header(FILE* stream, oskar_BinaryHeader* header,
         int* status);
 static void oskar_binary_write_header(FILE* stream, oskar_BinaryHeader* header,
         int* status);
+static void oskar_binary_map(oskar_Binary* handle, const char* filename);
 
 
 oskar_Binary* oskar_binary_create(const char* filename, char mode, int* status)
@@ -54,7 +62,7 @@ oskar_Binary* oskar_binary_create(const char* filename, char mode, int* status)
     int i;
 
     /* Open the file and check or write the header, depending on the mode. */
-    if (mode == 'r')
+    if (mode == 'r' || mode == 'm')
     {
         stream = fopen(filename, "rb");
         if (!stream)
@@ -98,8 +106,10 @@ oskar_Binary* oskar_binary_create(const char* filename, char mode, int* status)
     /* Allocate index and store the stream handle. */
     handle = (oskar_Binary*) malloc(sizeof(oskar_Binary));
     handle->stream = stream;
-    handle->open_mode = mode;
+    handle->open_mode = (mode == 'm') ? 'r' : mode;
     handle->query_search_start = 0;
+    handle->map = 0;
+    handle->map_size = 0;
 
     /* Create the CRC lookup tables. */
     handle->crc_data = oskar_crc_create(OSKAR_CRC_32C);
@@ -293,9 +303,39 @@ oskar_Binary* oskar_binary_create(const char* filename, char mode, int* status)
         handle->num_chunks = i + 1;
     }
 
+    /* Map the file into memory if required. */
+    if (mode == 'm' && !*status)
+        oskar_binary_map(handle, filename);
+
     return handle;
 }
 
+static void oskar_binary_map(oskar_Binary* handle, const char* filename)
+{
+#ifndef _WIN32
+    struct stat st;
+    int fd;
+
+    /* If the file can't be mapped, reads fall back to the stream. */
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) return;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+            (off_t)(size_t) st.st_size == st.st_size)
+    {
+        void* p = mmap(0, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            handle->map = (char*) p;
+            handle->map_size = (size_t) st.st_size;
+        }
+    }
+    close(fd);
+#else
+    (void) handle;
+    (void) filename;
+#endif
+}
+
 static void oskar_binary_resize(oskar_Binary* handle, int m)
 {
     handle->extended = (int*) realloc(handle->extended, m * sizeof(int));
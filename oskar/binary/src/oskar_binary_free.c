@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -30,6 +30,10 @@
 #include "binary/private_binary.h"
 #include <stdlib.h>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,7 +45,11 @@ void oskar_binary_free(oskar_Binary* handle)
     /* Check if structure exists. */
     if (!handle) return;
 
-    /* Close the file. */
+    /* Unmap and close the file. */
+#ifndef _WIN32
+    if (handle->map)
+        munmap(handle->map, handle->map_size);
+#endif
     if (handle->stream)
         fclose(handle->stream);
 
@@ -56,6 +56,14 @@ size_t oskar_binary_tag_payload_size(const oskar_Binary* handle,
 int oskar_binary_query(const oskar_Binary* handle,
         unsigned char data_type, unsigned char id_group, unsigned char id_tag,
         int user_index, size_t* payload_size, int* status)
+{
+    return oskar_binary_query_from(handle, handle->query_search_start,
+            data_type, id_group, id_tag, user_index, payload_size, status);
+}
+
+int oskar_binary_query_from(const oskar_Binary* handle, int search_start,
+        unsigned char data_type, unsigned char id_group, unsigned char id_tag,
+        int user_index, size_t* payload_size, int* status)
 {
     int i;
 
@@ -63,7 +71,8 @@ int oskar_binary_query(const oskar_Binary* handle,
     if (*status) return 0;
 
     /* Find the tag in the index. */
-    for (i = handle->query_search_start; i < handle->num_chunks; ++i)
+    if (search_start < 0) search_start = 0;
+    for (i = search_start; i < handle->num_chunks; ++i)
     {
         if (!(handle->extended[i]) &&
                 ((handle->data_type[i] == (int) data_type) || (!data_type)) &&
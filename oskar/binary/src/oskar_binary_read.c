@@ -26,16 +26,112 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L /* For posix_madvise(). */
+#endif
+
 #include "binary/oskar_binary.h"
 #include "binary/private_binary.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Tells the OS that a range of the mapped file will be needed soon. */
+static void oskar_binary_advise(const oskar_Binary* handle,
+        size_t offset, size_t num_bytes)
+{
+#if !defined(_WIN32) && defined(POSIX_MADV_WILLNEED)
+    size_t start;
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (num_bytes == 0 || page_size <= 0) return;
+    start = offset - offset % (size_t) page_size;
+    posix_madvise(handle->map + start, offset + num_bytes - start,
+            POSIX_MADV_WILLNEED);
+#else
+    (void) handle;
+    (void) offset;
+    (void) num_bytes;
+#endif
+}
+
+void* oskar_binary_map_block(const oskar_Binary* handle,
+        int chunk_index, int* status)
+{
+    char* p;
+    size_t offset, size;
+
+    /* Check if safe to proceed. */
+    if (*status || !handle->map) return 0;
+
+    /* Check index is in range. */
+    if (chunk_index < 0 || chunk_index >= handle->num_chunks)
+    {
+        *status = OSKAR_ERR_BINARY_TAG_OUT_OF_RANGE;
+        return 0;
+    }
+
+    /* Check the payload is inside the file. */
+    offset = (size_t) handle->payload_offset_bytes[chunk_index];
+    size = handle->payload_size_bytes[chunk_index];
+    if (offset > handle->map_size || size > handle->map_size - offset)
+    {
+        *status = OSKAR_ERR_BINARY_READ_FAIL;
+        return 0;
+    }
+    p = handle->map + offset;
+
+    /* Have the whole payload paged in at once, rather than page by page
+     * as the CRC check touches it. */
+    oskar_binary_advise(handle, offset, size);
+
+    /* Check CRC-32 code, if present. */
+    if (handle->crc[chunk_index])
+    {
+        unsigned long crc;
+        crc = handle->crc_header[chunk_index];
+        crc = oskar_crc_update(handle->crc_data, crc, p, size);
+        if (crc != handle->crc[chunk_index])
+        {
+            *status = OSKAR_ERR_BINARY_CRC_FAIL;
+            return 0;
+        }
+    }
+    return p;
+}
+
+void oskar_binary_prefetch(const oskar_Binary* handle,
+        int start_chunk, int num_chunks, int* status)
+{
+    int end_chunk;
+    size_t start, end;
+
+    /* Check if safe to proceed. */
+    if (*status || !handle->map) return;
+
+    /* Clip the range of chunks to those in the file. */
+    end_chunk = start_chunk + num_chunks - 1;
+    if (start_chunk < 0) start_chunk = 0;
+    if (end_chunk >= handle->num_chunks) end_chunk = handle->num_chunks - 1;
+    if (end_chunk < start_chunk) return;
+
+    /* Hint the range of the file spanned by the payloads. */
+    start = (size_t) handle->payload_offset_bytes[start_chunk];
+    end = (size_t) handle->payload_offset_bytes[end_chunk] +
+            handle->payload_size_bytes[end_chunk];
+    if (end > handle->map_size) end = handle->map_size;
+    if (end > start)
+        oskar_binary_advise(handle, start, end - start);
+}
+
 void oskar_binary_read_block(oskar_Binary* handle,
         int chunk_index, size_t data_size, void* data, int* status)
 {
@@ -69,6 +165,17 @@ void oskar_binary_read_block(oskar_Binary* handle,
         return;
     }
 
+    /* Copy the data out of the memory map, if there is one.
+     * (The CRC code is checked there.)
+     * This leaves the stream alone, so it is safe to do concurrently. */
+    if (handle->map)
+    {
+        const void* src = oskar_binary_map_block(handle, chunk_index, status);
+        if (src)
+            memcpy(data, src, handle->payload_size_bytes[chunk_index]);
+        return;
+    }
+
     /* Copy the data out of the stream. */
     if (fseek(handle->stream,
             handle->payload_offset_bytes[chunk_index], SEEK_SET) != 0)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, The University of Oxford
+ * Copyright (c) 2014-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -28,9 +28,37 @@
 
 #include "binary/oskar_crc.h"
 #include "binary/oskar_endian.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+/* Hardware CRC-32C instructions: SSE4.2 on x86-64, and the CRC extension
+ * on 64-bit ARM. Their availability is checked at run time. */
+#if defined(__x86_64__) || defined(_M_X64)
+#    define OSKAR_CRC_HW 1
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#        define OSKAR_CRC_TARGET
+#    else
+#        include <nmmintrin.h>
+#        define OSKAR_CRC_TARGET __attribute__((target("sse4.2")))
+#    endif
+#    define OSKAR_CRC_U8(CRC, V)  _mm_crc32_u8(CRC, V)
+#    define OSKAR_CRC_U64(CRC, V) (uint32_t) _mm_crc32_u64(CRC, V)
+#elif defined(__aarch64__) && defined(__linux__) && defined(__GNUC__)
+#    define OSKAR_CRC_HW 1
+#    include <arm_acle.h>
+#    include <sys/auxv.h>
+#    include <asm/hwcap.h>
+#    define OSKAR_CRC_TARGET __attribute__((target("+crc")))
+#    define OSKAR_CRC_U8(CRC, V)  __crc32cb(CRC, V)
+#    define OSKAR_CRC_U64(CRC, V) __crc32cd(CRC, V)
+#endif
+
+/* Lengths of the three interleaved streams used by the hardware path. */
+#define CRC_LONG 8192
+#define CRC_SHORT 256
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -42,6 +70,8 @@ struct oskar_CRC
     unsigned long init;
     unsigned long xorout;
     unsigned long t[8][256];
+    int hw;
+    uint32_t shift_long[4][256], shift_short[4][256];
 };
 #ifndef OSKAR_CRC_TYPEDEF_
 #define OSKAR_CRC_TYPEDEF_
@@ -49,6 +79,162 @@ typedef struct oskar_CRC oskar_CRC;
 #endif /* OSKAR_CRC_TYPEDEF_ */
 
 
+#ifdef OSKAR_CRC_HW
+static int crc32c_hw_available(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#elif defined(__x86_64__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+}
+
+/* Multiplies a vector by a 32 x 32 matrix over GF(2). */
+static uint32_t gf2_matrix_times(const uint32_t* mat, uint32_t vec)
+{
+    uint32_t sum = 0;
+    while (vec)
+    {
+        if (vec & 1) sum ^= *mat;
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+static void gf2_matrix_square(uint32_t* square, const uint32_t* mat)
+{
+    int n;
+    for (n = 0; n < 32; n++)
+        square[n] = gf2_matrix_times(mat, mat[n]);
+}
+
+/* Fills tables used to shift a CRC forward over len zero bytes, which
+ * allows CRCs of adjacent blocks to be combined.
+ * Uses the method from Mark Adler's crc32c.c:
+ * http://stackoverflow.com/a/17646775 */
+static void crc32c_zeros(uint32_t poly, uint32_t zeros[4][256], size_t len)
+{
+    int n;
+    uint32_t row = 1, even[32], odd[32];
+
+    /* Operator for one zero bit, then for two and four zero bits. */
+    odd[0] = poly;
+    for (n = 1; n < 32; n++)
+    {
+        odd[n] = row;
+        row <<= 1;
+    }
+    gf2_matrix_square(even, odd);
+    gf2_matrix_square(odd, even);
+
+    /* Keep squaring until the operator covers len bytes. */
+    do
+    {
+        gf2_matrix_square(even, odd);
+        len >>= 1;
+        if (len == 0) break;
+        gf2_matrix_square(odd, even);
+        len >>= 1;
+        if (len == 0) memcpy(even, odd, sizeof(even));
+    } while (len);
+
+    /* Tabulate the operator for each byte of the CRC. */
+    for (n = 0; n < 256; n++)
+    {
+        zeros[0][n] = gf2_matrix_times(even, (uint32_t) n);
+        zeros[1][n] = gf2_matrix_times(even, (uint32_t) n << 8);
+        zeros[2][n] = gf2_matrix_times(even, (uint32_t) n << 16);
+        zeros[3][n] = gf2_matrix_times(even, (uint32_t) n << 24);
+    }
+}
+
+static uint32_t crc32c_shift(const uint32_t zeros[4][256], uint32_t crc)
+{
+    return zeros[0][crc & 0xFF] ^ zeros[1][(crc >> 8) & 0xFF] ^
+            zeros[2][(crc >> 16) & 0xFF] ^ zeros[3][crc >> 24];
+}
+
+/* Updates a (non-inverted) CRC-32C value using hardware instructions.
+ * The instruction has a latency of three cycles but a throughput of one
+ * per cycle, so three independent streams are computed together and then
+ * combined. */
+OSKAR_CRC_TARGET
+static uint32_t crc32c_hw(const oskar_CRC* crc_data, uint32_t crc0,
+        const unsigned char* next, size_t len)
+{
+    uint64_t v0, v1, v2;
+    const unsigned char* end;
+
+    /* Align the input to an 8-byte boundary. */
+    while (len && ((size_t) next & 7) != 0)
+    {
+        crc0 = OSKAR_CRC_U8(crc0, *next++);
+        len--;
+    }
+
+    /* Three streams of CRC_LONG bytes each. */
+    while (len >= 3 * CRC_LONG)
+    {
+        uint32_t crc1 = 0, crc2 = 0;
+        end = next + CRC_LONG;
+        do
+        {
+            memcpy(&v0, next, 8);
+            memcpy(&v1, next + CRC_LONG, 8);
+            memcpy(&v2, next + 2 * CRC_LONG, 8);
+            crc0 = OSKAR_CRC_U64(crc0, v0);
+            crc1 = OSKAR_CRC_U64(crc1, v1);
+            crc2 = OSKAR_CRC_U64(crc2, v2);
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(crc_data->shift_long, crc0) ^ crc1;
+        crc0 = crc32c_shift(crc_data->shift_long, crc0) ^ crc2;
+        next += 2 * CRC_LONG;
+        len -= 3 * CRC_LONG;
+    }
+
+    /* Three streams of CRC_SHORT bytes each. */
+    while (len >= 3 * CRC_SHORT)
+    {
+        uint32_t crc1 = 0, crc2 = 0;
+        end = next + CRC_SHORT;
+        do
+        {
+            memcpy(&v0, next, 8);
+            memcpy(&v1, next + CRC_SHORT, 8);
+            memcpy(&v2, next + 2 * CRC_SHORT, 8);
+            crc0 = OSKAR_CRC_U64(crc0, v0);
+            crc1 = OSKAR_CRC_U64(crc1, v1);
+            crc2 = OSKAR_CRC_U64(crc2, v2);
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(crc_data->shift_short, crc0) ^ crc1;
+        crc0 = crc32c_shift(crc_data->shift_short, crc0) ^ crc2;
+        next += 2 * CRC_SHORT;
+        len -= 3 * CRC_SHORT;
+    }
+
+    /* Remaining 8-byte words, then remaining bytes. */
+    end = next + (len - (len & 7));
+    while (next < end)
+    {
+        memcpy(&v0, next, 8);
+        crc0 = OSKAR_CRC_U64(crc0, v0);
+        next += 8;
+    }
+    len &= 7;
+    while (len--)
+        crc0 = OSKAR_CRC_U8(crc0, *next++);
+    return crc0;
+}
+#endif
+
 oskar_CRC* oskar_crc_create(int type)
 {
     int i, j;
@@ -57,6 +243,7 @@ oskar_CRC* oskar_crc_create(int type)
     /* Create the data structure. */
     d = (oskar_CRC*) malloc(sizeof(oskar_CRC));
     d->type = type;
+    d->hw = 0;
 
     /* Set the polynomial, initial and post-XOR values based on type. */
     /* Always need the "reversed" form of the polynomial for this generator. */
@@ -104,6 +291,16 @@ oskar_CRC* oskar_crc_create(int type)
         }
     }
 
+#ifdef OSKAR_CRC_HW
+    /* Use hardware instructions for CRC-32C, if available. */
+    if (type == OSKAR_CRC_32C && crc32c_hw_available())
+    {
+        d->hw = 1;
+        crc32c_zeros((uint32_t) d->poly, d->shift_long, CRC_LONG);
+        crc32c_zeros((uint32_t) d->poly, d->shift_short, CRC_SHORT);
+    }
+#endif
+
     return d;
 }
 
@@ -121,6 +318,11 @@ unsigned long oskar_crc_update(const oskar_CRC* crc_data, unsigned long crc,
     /* Use 8-byte chunks. */
     if (crc != crc_data->init) crc ^= crc_data->xorout;
     byte = (const unsigned char*) data;
+#ifdef OSKAR_CRC_HW
+    if (crc_data->hw)
+        return crc32c_hw(crc_data, (uint32_t) crc, byte, num_bytes) ^
+                crc_data->xorout;
+#endif
     if (oskar_endian() == OSKAR_LITTLE_ENDIAN)
     {
         while (num_bytes >= 8)
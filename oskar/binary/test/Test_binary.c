@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -176,6 +176,61 @@ int main(void)
     oskar_binary_free(h);
     ASSERT_INT_EQ(0, status);
 
+    /* Read the file again, memory-mapped. */
+    h = oskar_binary_create(filename, 'm', &status);
+    ASSERT_INT_EQ(0, status);
+    oskar_binary_read_int(h, 12, 0, 0, &b, &status);
+    ASSERT_INT_EQ(0, status);
+    ASSERT_INT_EQ(b1, b);
+    {
+        int chunk;
+        size_t size = 0;
+        const void* p;
+        data_double = calloc(num_elements_double, sizeof(double));
+        oskar_binary_read(h, OSKAR_DOUBLE,
+                4, 0, 3, size_double, &data_double[0], &status);
+        ASSERT_INT_EQ(0, status);
+        for (i = 0; i < num_elements_double; ++i)
+            ASSERT_DOUBLE_EQ(i * 1234.0, data_double[i]);
+
+        /* Access the payload in place, starting the search past the tag. */
+        chunk = oskar_binary_query_from(h, oskar_binary_num_tags(h),
+                OSKAR_DOUBLE, 1, 10, 987654321, &size, &status);
+        ASSERT_INT_EQ((int) OSKAR_ERR_BINARY_TAG_NOT_FOUND, status);
+        status = 0;
+        chunk = oskar_binary_query_from(h, 0,
+                OSKAR_DOUBLE, 1, 10, 987654321, &size, &status);
+        ASSERT_INT_EQ(0, status);
+        ASSERT_INT_EQ((int) size_double, (int) size);
+        oskar_binary_prefetch(h, chunk, 2, &status);
+        p = oskar_binary_map_block(h, chunk, &status);
+        ASSERT_INT_EQ(0, status);
+        if (!p)
+        {
+            /* Some platforms can't map files, which is not an error. */
+            printf("Memory-mapped file access not available.\n");
+        }
+        else
+        {
+            memcpy(data_double, p, size_double);
+            for (i = 0; i < num_elements_double; ++i)
+                ASSERT_DOUBLE_EQ(i + 1000.0, data_double[i]);
+        }
+        free(data_double);
+    }
+    oskar_binary_free(h);
+    ASSERT_INT_EQ(0, status);
+
+    /* Check that a file that is not mapped is not accessed in place. */
+    h = oskar_binary_create(filename, 'r', &status);
+    if (oskar_binary_map_block(h, 0, &status))
+    {
+        printf("Unexpected mapped access (%s:%i)\n", __FILE__, __LINE__);
+        exit(1);
+    }
+    oskar_binary_free(h);
+    ASSERT_INT_EQ(0, status);
+
     /* Remove the file. */
     remove(filename);
 
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "binary/oskar_crc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ASSERT_ULONG_EQ(V1, V2) \
+    if (V1 != V2) \
+    { \
+        printf("Assert: %lx != %lx (%s:%i)\n", V1, V2, __FILE__, __LINE__); \
+        exit(1); \
+    }
+
+/* Bit-wise CRC-32C, for reference. */
+static unsigned long crc32c_ref(unsigned long crc, const unsigned char* data,
+        size_t num_bytes)
+{
+    int j;
+    crc = ~crc & 0xFFFFFFFFuL;
+    while (num_bytes--)
+    {
+        crc ^= *data++;
+        for (j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ ((crc & 1) * 0x82f63b78uL);
+    }
+    return ~crc & 0xFFFFFFFFuL;
+}
+
+static double throughput_mb_s(const oskar_CRC* crc_data,
+        const unsigned char* data, size_t num_bytes, unsigned long* crc)
+{
+    int i, num_iter = 10;
+    clock_t start = clock();
+    for (i = 0; i < num_iter; ++i)
+        *crc = oskar_crc_compute(crc_data, data, num_bytes);
+    return (num_iter * num_bytes / (1024.0 * 1024.0)) /
+            ((double)(clock() - start + 1) / CLOCKS_PER_SEC);
+}
+
+
+int main(void)
+{
+    size_t i, j, num_bytes = 64 * 1024 * 1024;
+    const size_t lengths[] = {0, 1, 7, 8, 9, 255, 768, 769, 4095,
+            24576, 24583, 50000, 100003};
+    unsigned long crc = 0, crc_table = 0;
+    oskar_CRC *crc32c, *crc32;
+    unsigned char* data;
+
+    /* Create some test data. */
+    data = (unsigned char*) malloc(num_bytes);
+    srand(1);
+    for (i = 0; i < num_bytes; ++i)
+        data[i] = (unsigned char) (rand() & 0xFF);
+    crc32c = oskar_crc_create(OSKAR_CRC_32C);
+    crc32 = oskar_crc_create(OSKAR_CRC_32);
+
+    /* Check the standard check value. */
+    crc = oskar_crc_compute(crc32c, "123456789", 9);
+    ASSERT_ULONG_EQ(0xe3069283uL, crc);
+
+    /* Check against the reference, for many lengths and alignments. */
+    for (i = 0; i < sizeof(lengths) / sizeof(size_t); ++i)
+    {
+        for (j = 0; j < 8; ++j)
+        {
+            unsigned long ref = crc32c_ref(0, data + j, lengths[i]);
+            crc = oskar_crc_compute(crc32c, data + j, lengths[i]);
+            ASSERT_ULONG_EQ(ref, crc);
+
+            /* Check updates in two parts. */
+            crc = oskar_crc_compute(crc32c, data + j, lengths[i] / 3);
+            crc = oskar_crc_update(crc32c, crc, data + j + lengths[i] / 3,
+                    lengths[i] - lengths[i] / 3);
+            if (lengths[i] / 3 > 0)
+                ASSERT_ULONG_EQ(ref, crc);
+        }
+    }
+
+    /* Report throughput. */
+    printf("CRC-32C: %.0f MB/s\n",
+            throughput_mb_s(crc32c, data, num_bytes, &crc));
+    printf("CRC-32 (slicing-by-8): %.0f MB/s\n",
+            throughput_mb_s(crc32, data, num_bytes, &crc_table));
+    ASSERT_ULONG_EQ(crc32c_ref(0, data, num_bytes), crc);
+
+    /* Clean up. */
+    oskar_crc_free(crc32c);
+    oskar_crc_free(crc32);
+    free(data);
+    return 0;
+}
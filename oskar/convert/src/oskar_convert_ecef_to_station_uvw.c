@@ -28,6 +28,7 @@
 
 #include "convert/oskar_convert_ecef_to_station_uvw.h"
 #include "convert/oskar_convert_ecef_to_station_uvw_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 #include "convert/private_convert_ecef_to_station_uvw_inline.h"
 
@@ -209,6 +210,79 @@ void oskar_convert_ecef_to_station_uvw(int num_stations, const oskar_Mem* x,
             *status = OSKAR_ERR_BAD_DATA_TYPE;
         }
     }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_stations + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel("convert_ecef_to_station_uvw_double");
+        else if (type == OSKAR_SINGLE)
+            k = oskar_cl_kernel("convert_ecef_to_station_uvw_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_stations;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(x, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(y, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(z, status));
+        if (type == OSKAR_DOUBLE)
+        {
+            const cl_double trig[] = {sin(ha0_rad), cos(ha0_rad),
+                    sin(dec0_rad), cos(dec0_rad)};
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &trig[0]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &trig[1]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &trig[2]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &trig[3]);
+        }
+        else
+        {
+            const cl_float trig[] = {(cl_float) sin(ha0_rad),
+                    (cl_float) cos(ha0_rad), (cl_float) sin(dec0_rad),
+                    (cl_float) cos(dec0_rad)};
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &trig[0]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &trig[1]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &trig[2]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &trig[3]);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(u, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(v, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(w, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_stations > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
     else
     {
         *status = OSKAR_ERR_BAD_LOCATION;
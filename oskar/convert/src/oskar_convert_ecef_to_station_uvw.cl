@@ -0,0 +1,20 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void convert_ecef_to_station_uvw_REAL(const int num_stations,
+        global const REAL* restrict x,
+        global const REAL* restrict y,
+        global const REAL* restrict z,
+        const REAL sin_ha0, const REAL cos_ha0,
+        const REAL sin_dec0, const REAL cos_dec0,
+        global REAL* restrict u,
+        global REAL* restrict v,
+        global REAL* restrict w)
+{
+    const int i = get_global_id(0);
+    if (i >= num_stations) return;
+    const REAL x_ = x[i], y_ = y[i], z_ = z[i];
+    const REAL t = x_ * cos_ha0 - y_ * sin_ha0;
+    u[i] = x_ * sin_ha0 + y_ * cos_ha0;
+    v[i] = z_ * cos_dec0 - sin_dec0 * t;
+    w[i] = cos_dec0 * t + z_ * sin_dec0;
+}
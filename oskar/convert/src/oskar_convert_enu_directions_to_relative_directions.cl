@@ -0,0 +1,27 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void convert_enu_directions_to_relative_directions_REAL(
+        const int num_points,
+        global const REAL* restrict x,
+        global const REAL* restrict y,
+        global const REAL* restrict z,
+        const REAL cos_ha0, const REAL sin_ha0,
+        const REAL cos_dec0, const REAL sin_dec0,
+        const REAL cos_lat, const REAL sin_lat,
+        global REAL* restrict l,
+        global REAL* restrict m,
+        global REAL* restrict n)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    const REAL x_ = x[i], y_ = y[i], z_ = z[i];
+    REAL t = sin_dec0 * cos_ha0;
+    l[i] = x_ * cos_ha0 - y_ * sin_ha0 * sin_lat + z_ * sin_ha0 * cos_lat;
+    m[i] = x_ * sin_dec0 * sin_ha0 +
+            y_ * (cos_dec0 * cos_lat + t * sin_lat) +
+            z_ * (cos_dec0 * sin_lat - t * cos_lat);
+    t = cos_dec0 * cos_ha0;
+    n[i] = -x_ * cos_dec0 * sin_ha0 +
+            y_ * (sin_dec0 * cos_lat - t * sin_lat) +
+            z_ * (sin_dec0 * sin_lat + t * cos_lat);
+}
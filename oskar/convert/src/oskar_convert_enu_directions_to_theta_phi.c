@@ -28,6 +28,7 @@
 
 #include "convert/oskar_convert_enu_directions_to_theta_phi.h"
 #include "convert/oskar_convert_enu_directions_to_theta_phi_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 #include "convert/private_convert_enu_directions_to_theta_phi_inline.h"
 
@@ -128,6 +129,68 @@ void oskar_convert_enu_directions_to_theta_phi(int num_points,
         else
             *status = OSKAR_ERR_BAD_DATA_TYPE;
     }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_points + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel("convert_enu_directions_to_theta_phi_double");
+        else if (type == OSKAR_SINGLE)
+            k = oskar_cl_kernel("convert_enu_directions_to_theta_phi_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_points;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(x, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(y, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(z, status));
+        if (type == OSKAR_DOUBLE)
+        {
+            const cl_double d = delta_phi;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &d);
+        }
+        else
+        {
+            const cl_float d = (cl_float) delta_phi;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &d);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(theta, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(phi, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_points > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
     else
     {
         *status = OSKAR_ERR_BAD_LOCATION;
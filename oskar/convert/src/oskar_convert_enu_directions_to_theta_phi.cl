@@ -0,0 +1,19 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void convert_enu_directions_to_theta_phi_REAL(const int num_points,
+        global const REAL* restrict x,
+        global const REAL* restrict y,
+        global const REAL* restrict z,
+        const REAL delta_phi,
+        global REAL* restrict theta,
+        global REAL* restrict phi)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    const REAL x_ = x[i], y_ = y[i];
+    const REAL two_pi = (REAL) 6.28318530717958647693;
+    REAL p = fmod(atan2(y_, x_) + delta_phi, two_pi);
+    if (p < (REAL) 0.) p += two_pi; /* Get phi in range 0 to 2 pi. */
+    phi[i] = p;
+    theta[i] = atan2(sqrt(x_*x_ + y_*y_), z[i]);
+}
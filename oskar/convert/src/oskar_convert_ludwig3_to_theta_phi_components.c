@@ -28,6 +28,7 @@
 
 #include "convert/oskar_convert_ludwig3_to_theta_phi_components.h"
 #include "convert/oskar_convert_ludwig3_to_theta_phi_components_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 #include "convert/private_convert_ludwig3_to_theta_phi_components_inline.h"
 
@@ -81,7 +82,57 @@ void oskar_convert_ludwig3_to_theta_phi_components(oskar_Mem* vec,
     location = oskar_mem_location(phi);
 
     /* Convert vector representation from Ludwig-3 to spherical. */
-    if (type == OSKAR_SINGLE)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num, off, str;
+        cl_uint arg = 0;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_points + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel("convert_ludwig3_to_theta_phi_double");
+        else if (type == OSKAR_SINGLE)
+            k = oskar_cl_kernel("convert_ludwig3_to_theta_phi_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_points;
+        off = (cl_int) offset;
+        str = (cl_int) stride;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(phi, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &str);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &off);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(vec, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_points > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (type == OSKAR_SINGLE)
     {
         float2 *h_theta, *v_phi;
         const float *phi_;
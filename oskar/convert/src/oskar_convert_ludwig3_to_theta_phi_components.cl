@@ -0,0 +1,16 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void convert_ludwig3_to_theta_phi_REAL(const int num_points,
+        global const REAL* restrict phi,
+        const int stride, const int offset,
+        global REAL2* restrict vec)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    REAL sin_phi, cos_phi;
+    sin_phi = sincos(phi[i], &cos_phi);
+    const int j = offset + i * stride;
+    const REAL2 h = vec[j], v = vec[j + 1];
+    vec[j]     = h * cos_phi + v * sin_phi;
+    vec[j + 1] = -h * sin_phi + v * cos_phi;
+}
@@ -28,6 +28,7 @@
 
 #include "convert/oskar_convert_relative_directions_to_enu_directions.h"
 #include "convert/oskar_convert_relative_directions_to_enu_directions_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "convert/oskar_convert_relative_directions_to_enu_directions_inline.h"
 #include <math.h>
 
@@ -130,7 +131,77 @@ void oskar_convert_relative_directions_to_enu_directions(
     }
 
     /* Switch on type and location. */
-    if (type == OSKAR_DOUBLE)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        int i;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_points + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel(
+                    "convert_relative_directions_to_enu_directions_double");
+        else
+            k = oskar_cl_kernel(
+                    "convert_relative_directions_to_enu_directions_float");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_points;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(l, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(m, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(n, status));
+        if (type == OSKAR_DOUBLE)
+        {
+            const cl_double trig[] = {cos(ha0), sin(ha0),
+                    cos(dec0), sin(dec0), cos(lat), sin(lat)};
+            for (i = 0; i < 6; ++i)
+                error |= clSetKernelArg(k, arg++, sizeof(cl_double),
+                        &trig[i]);
+        }
+        else
+        {
+            const cl_float trig[] = {(cl_float) cos(ha0),
+                    (cl_float) sin(ha0), (cl_float) cos(dec0),
+                    (cl_float) sin(dec0), (cl_float) cos(lat),
+                    (cl_float) sin(lat)};
+            for (i = 0; i < 6; ++i)
+                error |= clSetKernelArg(k, arg++, sizeof(cl_float),
+                        &trig[i]);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(x, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(y, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(z, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_points > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (type == OSKAR_DOUBLE)
     {
         double *x_, *y_, *z_;
         const double *l_, *m_, *n_;
@@ -155,6 +226,8 @@ void oskar_convert_relative_directions_to_enu_directions(
             *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
 #endif
         }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
     }
     else
     {
@@ -181,6 +254,8 @@ void oskar_convert_relative_directions_to_enu_directions(
             *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
 #endif
         }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
     }
 }
 
@@ -47,9 +47,15 @@ extern "C" {
  * @details
  * Forms visibilities for auto-correlations only.
  *
+ * If \p station_map is not NULL, station s uses row station_map[s] of
+ * \p jones, and the result for each row is evaluated only once, for the
+ * first station using it. Rows must be less than \p num_stations.
+ *
  * @param[in] num_sources    Number of sources.
  * @param[in] num_stations   Number of stations.
  * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
  * @param[in] source_I       Source Stokes I values, in Jy.
  * @param[in] source_Q       Source Stokes Q values, in Jy.
  * @param[in] source_U       Source Stokes U values, in Jy.
@@ -58,8 +64,9 @@ extern "C" {
  */
 OSKAR_EXPORT
 void oskar_auto_correlate_omp_f(const int num_sources, const int num_stations,
-        const float4c* jones, const float* source_I, const float* source_Q,
-        const float* source_U, const float* source_V, float4c* vis);
+        const float4c* jones, const int* station_map, const float* source_I,
+        const float* source_Q, const float* source_U, const float* source_V,
+        float4c* vis);
 
 /**
  * @brief
@@ -68,9 +75,15 @@ void oskar_auto_correlate_omp_f(const int num_sources, const int num_stations,
  * @details
  * Forms visibilities for auto-correlations only.
  *
+ * If \p station_map is not NULL, station s uses row station_map[s] of
+ * \p jones, and the result for each row is evaluated only once, for the
+ * first station using it. Rows must be less than \p num_stations.
+ *
  * @param[in] num_sources    Number of sources.
  * @param[in] num_stations   Number of stations.
  * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
  * @param[in] source_I       Source Stokes I values, in Jy.
  * @param[in] source_Q       Source Stokes Q values, in Jy.
  * @param[in] source_U       Source Stokes U values, in Jy.
@@ -79,8 +92,9 @@ void oskar_auto_correlate_omp_f(const int num_sources, const int num_stations,
  */
 OSKAR_EXPORT
 void oskar_auto_correlate_omp_d(const int num_sources, const int num_stations,
-        const double4c* jones, const double* source_I, const double* source_Q,
-        const double* source_U, const double* source_V, double4c* vis);
+        const double4c* jones, const int* station_map, const double* source_I,
+        const double* source_Q, const double* source_U, const double* source_V,
+        double4c* vis);
 
 #ifdef __cplusplus
 }
@@ -47,16 +47,22 @@ extern "C" {
  * @details
  * Forms visibilities for auto-correlations only.
  *
+ * If \p station_map is not NULL, station s uses row station_map[s] of
+ * \p jones, and the result for each row is evaluated only once, for the
+ * first station using it. Rows must be less than \p num_stations.
+ *
  * @param[in] num_sources    Number of sources.
  * @param[in] num_stations   Number of stations.
  * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
  * @param[in] source_I       Source Stokes I values, in Jy.
  * @param[in,out] vis        Modified output complex visibilities.
  */
 OSKAR_EXPORT
 void oskar_auto_correlate_scalar_omp_f(const int num_sources,
-        const int num_stations, const float2* jones, const float* source_I,
-        float2* vis);
+        const int num_stations, const float2* jones, const int* station_map,
+        const float* source_I, float2* vis);
 
 /**
  * @brief
@@ -65,16 +71,22 @@ void oskar_auto_correlate_scalar_omp_f(const int num_sources,
  * @details
  * Forms visibilities for auto-correlations only.
  *
+ * If \p station_map is not NULL, station s uses row station_map[s] of
+ * \p jones, and the result for each row is evaluated only once, for the
+ * first station using it. Rows must be less than \p num_stations.
+ *
  * @param[in] num_sources    Number of sources.
  * @param[in] num_stations   Number of stations.
  * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
  * @param[in] source_I       Source Stokes I values, in Jy.
  * @param[in,out] vis        Modified output complex visibilities.
  */
 OSKAR_EXPORT
 void oskar_auto_correlate_scalar_omp_d(const int num_sources,
-        const int num_stations, const double2* jones, const double* source_I,
-        double2* vis);
+        const int num_stations, const double2* jones, const int* station_map,
+        const double* source_I, double2* vis);
 
 #ifdef __cplusplus
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -72,6 +72,90 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
         const oskar_Mem* v, const oskar_Mem* w, double gast,
         double frequency_hz, int* status);
 
+/**
+ * @brief Forms visibilities from a set of Jones matrices that exclude
+ * the interferometer phase (i.e. V = K E B E* K*).
+ *
+ * @details
+ * This is equivalent to evaluating the interferometer phase (Jones K)
+ * using oskar_evaluate_jones_K(), joining it with \p E, and then calling
+ * oskar_cross_correlate() with the result. The phase is instead evaluated
+ * for each baseline as it is needed, so neither K nor the joined
+ * Jones matrices need to be stored.
+ *
+ * As for oskar_evaluate_jones_K(), sources with a Stokes I value outside
+ * the range given by \p source_min_jy (exclusive) and
+ * \p source_max_jy (inclusive) are ignored.
+ *
+ * This is currently only available for matrix (polarised) data in CPU memory.
+ * Otherwise, \p status is set to OSKAR_ERR_FUNCTION_NOT_AVAILABLE.
+ *
+ * @param[out] vis           Output visibility amplitudes.
+ * @param[in]  n_sources     Number of sources to use.
+ * @param[in]  E             Set of Jones matrices, excluding Jones K.
+ * @param[in]  sky           Sky model.
+ * @param[in]  tel           Telescope model.
+ * @param[in]  u             Station u coordinates, in metres.
+ * @param[in]  v             Station v coordinates, in metres.
+ * @param[in]  w             Station w coordinates, in metres.
+ * @param[in]  gast          Greenwich apparent sidereal time, in radians.
+ * @param[in]  frequency_hz  Current observation frequency, in Hz.
+ * @param[in]  source_min_jy Minimum allowed source Stokes I value (exclusive).
+ * @param[in]  source_max_jy Maximum allowed source Stokes I value (inclusive).
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_phase(oskar_Mem* vis, int n_sources,
+        const oskar_Jones* E, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double frequency_hz, double source_min_jy,
+        double source_max_jy, int* status);
+
+/**
+ * @brief Forms visibilities for several channels at once.
+ *
+ * @details
+ * For each of \p num_channels channels, this computes the same result as
+ * oskar_cross_correlate(), or as oskar_cross_correlate_phase() if
+ * \p apply_phase is set, using the Jones matrices and sky model for that
+ * channel.
+ *
+ * The sky models for all channels must hold the same sources, so that only
+ * their fluxes differ. For polarised data in CPU memory, all channels are
+ * then correlated in one sweep over the sources, and the terms that do not
+ * depend on frequency are evaluated only once for each baseline and source.
+ * Otherwise, each channel is correlated in turn.
+ *
+ * The visibilities for channel c start at element c * num_baselines of
+ * \p vis.
+ *
+ * @param[out] vis           Output visibility amplitudes, for all channels.
+ * @param[in]  num_channels  Number of channels.
+ * @param[in]  n_sources     Number of sources to use.
+ * @param[in]  J             Per channel, set of Jones matrices
+ *                           (excluding Jones K if \p apply_phase is set).
+ * @param[in]  sky           Per channel, sky model.
+ * @param[in]  tel           Telescope model.
+ * @param[in]  u             Station u coordinates, in metres.
+ * @param[in]  v             Station v coordinates, in metres.
+ * @param[in]  w             Station w coordinates, in metres.
+ * @param[in]  gast          Greenwich apparent sidereal time, in radians.
+ * @param[in]  frequency_hz  Per channel, observation frequency, in Hz.
+ * @param[in]  apply_phase   If set, evaluate the interferometer phase.
+ * @param[in]  source_min_jy Minimum allowed source Stokes I value (exclusive),
+ *                           if \p apply_phase is set.
+ * @param[in]  source_max_jy Maximum allowed source Stokes I value (inclusive),
+ *                           if \p apply_phase is set.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_channels(oskar_Mem* vis, int num_channels,
+        int n_sources, oskar_Jones* const* J, oskar_Sky* const* sky,
+        const oskar_Telescope* tel, const oskar_Mem* u, const oskar_Mem* v,
+        const oskar_Mem* w, double gast, const double* frequency_hz,
+        int apply_phase, double source_min_jy, double source_max_jy,
+        int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,663 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CROSS_CORRELATE_SIMD_OMP_H_
+#define OSKAR_CROSS_CORRELATE_SIMD_OMP_H_
+
+/**
+ * @file oskar_cross_correlate_simd_omp.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Converts station Jones matrices to structure-of-arrays layout
+ * (single precision).
+ *
+ * @details
+ * Copies the (array-of-structures) Jones matrix block into a
+ * structure-of-arrays layout suitable for the vectorised correlator.
+ *
+ * For each station, eight consecutive arrays of length \p num_sources hold
+ * the real and imaginary parts of the a, b, c and d matrix elements,
+ * in that order, so that element k of source i for station s is at
+ * index (s * 8 + k) * num_sources + i.
+ *
+ * The output array must be at least 8 * num_sources * num_stations long.
+ *
+ * @param[in] num_sources   Number of sources.
+ * @param[in] num_stations  Number of stations.
+ * @param[in] jones         Input Jones matrices (station-major).
+ * @param[out] jones_soa    Output Jones matrix components.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_jones_to_soa_f(int num_sources, int num_stations,
+        const float4c* jones, float* jones_soa);
+
+/**
+ * @brief
+ * Converts station Jones matrices to structure-of-arrays layout
+ * (double precision).
+ *
+ * @details
+ * Copies the (array-of-structures) Jones matrix block into a
+ * structure-of-arrays layout suitable for the vectorised correlator.
+ *
+ * For each station, eight consecutive arrays of length \p num_sources hold
+ * the real and imaginary parts of the a, b, c and d matrix elements,
+ * in that order, so that element k of source i for station s is at
+ * index (s * 8 + k) * num_sources + i.
+ *
+ * The output array must be at least 8 * num_sources * num_stations long.
+ *
+ * @param[in] num_sources   Number of sources.
+ * @param[in] num_stations  Number of stations.
+ * @param[in] jones         Input Jones matrices (station-major).
+ * @param[out] jones_soa    Output Jones matrix components.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_jones_to_soa_d(int num_sources, int num_stations,
+        const double4c* jones, double* jones_soa);
+
+/**
+ * @brief
+ * Vectorised correlate function for point and Gaussian sources, with
+ * optional time-average smearing (single precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating Jones matrices for pairs
+ * of stations and summing along the source dimension.
+ *
+ * This is equivalent to the point, Gaussian and time-smearing versions
+ * of the OpenMP correlator, but requires Jones matrices in the
+ * structure-of-arrays layout produced by
+ * oskar_cross_correlate_jones_to_soa_f(), so that the inner loop over
+ * sources can be processed several sources at a time using SIMD
+ * instructions. Where supported by the compiler, versions of the inner
+ * loop are built for AVX-512 and AVX2, and the best one for the host CPU
+ * is selected at run time.
+ *
+ * If \p source_a is NULL, sources are treated as point sources and
+ * \p source_b and \p source_c are ignored.
+ * If \p time_int_sec is not greater than zero, time-average smearing is not
+ * applied and the station x, y coordinates are ignored.
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones_soa      Jones matrix components, in SoA layout.
+ * @param[in] source_I       Source Stokes I values, in Jy.
+ * @param[in] source_Q       Source Stokes Q values, in Jy.
+ * @param[in] source_U       Source Stokes U values, in Jy.
+ * @param[in] source_V       Source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_omp_f(int num_sources, int num_stations,
+        const float* jones_soa, const float* source_I,
+        const float* source_Q, const float* source_U, const float* source_V,
+        const float* source_l, const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b, const float* source_c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float4c* vis);
+
+/**
+ * @brief
+ * Vectorised correlate function for point and Gaussian sources, with
+ * optional time-average smearing (double precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating Jones matrices for pairs
+ * of stations and summing along the source dimension.
+ *
+ * This is equivalent to the point, Gaussian and time-smearing versions
+ * of the OpenMP correlator, but requires Jones matrices in the
+ * structure-of-arrays layout produced by
+ * oskar_cross_correlate_jones_to_soa_d(), so that the inner loop over
+ * sources can be processed several sources at a time using SIMD
+ * instructions. Where supported by the compiler, versions of the inner
+ * loop are built for AVX-512 and AVX2, and the best one for the host CPU
+ * is selected at run time.
+ *
+ * If \p source_a is NULL, sources are treated as point sources and
+ * \p source_b and \p source_c are ignored.
+ * If \p time_int_sec is not greater than zero, time-average smearing is not
+ * applied and the station x, y coordinates are ignored.
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones_soa      Jones matrix components, in SoA layout.
+ * @param[in] source_I       Source Stokes I values, in Jy.
+ * @param[in] source_Q       Source Stokes Q values, in Jy.
+ * @param[in] source_U       Source Stokes U values, in Jy.
+ * @param[in] source_V       Source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_omp_d(int num_sources, int num_stations,
+        const double* jones_soa, const double* source_I,
+        const double* source_Q, const double* source_U,
+        const double* source_V, const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double4c* vis);
+
+/**
+ * @brief
+ * Cache-blocked vectorised correlate function for point and Gaussian
+ * sources, with optional time-average smearing (single precision).
+ *
+ * @details
+ * Computes the same result as oskar_cross_correlate_simd_omp_f(),
+ * but takes Jones matrices in their usual (array-of-structures) layout.
+ *
+ * Stations are grouped into tiles, and each thread processes all baselines
+ * between a pair of tiles for one block of sources at a time. The Jones
+ * matrices for the tiles are copied into a small structure-of-arrays buffer
+ * sized to stay in L2 cache, so each one is reused across many baselines
+ * instead of being re-read from memory for every baseline.
+ *
+ * If \p station_map is not NULL, the Jones matrices for station s are
+ * taken from row station_map[s] of \p jones, so that stations sharing the
+ * same beam need not hold their own copy of it.
+ * If \p source_a is NULL, sources are treated as point sources and
+ * \p source_b and \p source_c are ignored.
+ * If \p time_int_sec is not greater than zero, time-average smearing is not
+ * applied and the station x, y coordinates are ignored.
+ *
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
+ * @param[in] source_I       Source Stokes I values, in Jy.
+ * @param[in] source_Q       Source Stokes Q values, in Jy.
+ * @param[in] source_U       Source Stokes U values, in Jy.
+ * @param[in] source_V       Source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in,out] vis        Modified output complex visibilities.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_tiled_omp_f(int num_sources,
+        int num_stations, const float4c* jones, const int* station_map,
+        const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V,
+        const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        float uv_min_lambda, float uv_max_lambda, float inv_wavelength,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, float4c* vis, int* status);
+
+/**
+ * @brief
+ * Cache-blocked vectorised correlate function for point and Gaussian
+ * sources, with optional time-average smearing (double precision).
+ *
+ * @details
+ * Computes the same result as oskar_cross_correlate_simd_omp_d(),
+ * but takes Jones matrices in their usual (array-of-structures) layout.
+ *
+ * Stations are grouped into tiles, and each thread processes all baselines
+ * between a pair of tiles for one block of sources at a time. The Jones
+ * matrices for the tiles are copied into a small structure-of-arrays buffer
+ * sized to stay in L2 cache, so each one is reused across many baselines
+ * instead of being re-read from memory for every baseline.
+ *
+ * If \p station_map is not NULL, the Jones matrices for station s are
+ * taken from row station_map[s] of \p jones, so that stations sharing the
+ * same beam need not hold their own copy of it.
+ * If \p source_a is NULL, sources are treated as point sources and
+ * \p source_b and \p source_c are ignored.
+ * If \p time_int_sec is not greater than zero, time-average smearing is not
+ * applied and the station x, y coordinates are ignored.
+ *
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones          Matrix of Jones matrices to correlate.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
+ * @param[in] source_I       Source Stokes I values, in Jy.
+ * @param[in] source_Q       Source Stokes Q values, in Jy.
+ * @param[in] source_U       Source Stokes U values, in Jy.
+ * @param[in] source_V       Source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in,out] vis        Modified output complex visibilities.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_tiled_omp_d(int num_sources,
+        int num_stations, const double4c* jones, const int* station_map,
+        const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V,
+        const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double4c* vis, int* status);
+
+/**
+ * @brief
+ * Cache-blocked vectorised correlate function that also applies the
+ * interferometer phase (single precision).
+ *
+ * @details
+ * Computes the same result as oskar_cross_correlate_simd_tiled_omp_f()
+ * with Jones matrices J = K * E, where K is the interferometer phase
+ * (as evaluated by oskar_evaluate_jones_K_f()), but without needing
+ * either K or J. For each baseline and source, the product K_p * conj(K_q)
+ * is evaluated inline from the station (u,v,w) coordinates and
+ * source (l,m,n) direction cosines, and applied to the correlation of the
+ * supplied Jones matrices \p jones.
+ *
+ * Sources with a Stokes I value outside the range given by
+ * \p source_min_jy (exclusive) and \p source_max_jy (inclusive) are
+ * ignored, as they would be by oskar_evaluate_jones_K_f().
+ *
+ * Other parameters are as for oskar_cross_correlate_simd_tiled_omp_f().
+ *
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones          Matrix of Jones matrices, excluding K.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
+ * @param[in] source_I       Source Stokes I values, in Jy.
+ * @param[in] source_Q       Source Stokes Q values, in Jy.
+ * @param[in] source_U       Source Stokes U values, in Jy.
+ * @param[in] source_V       Source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] source_min_jy  Minimum allowed source Stokes I value (exclusive).
+ * @param[in] source_max_jy  Maximum allowed source Stokes I value (inclusive).
+ * @param[in,out] vis        Modified output complex visibilities.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_tiled_phase_omp_f(int num_sources,
+        int num_stations, const float4c* jones, const int* station_map,
+        const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V,
+        const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        float uv_min_lambda, float uv_max_lambda, float inv_wavelength,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, float source_min_jy, float source_max_jy, float4c* vis,
+        int* status);
+
+/**
+ * @brief
+ * Cache-blocked vectorised correlate function that also applies the
+ * interferometer phase (double precision).
+ *
+ * @details
+ * Computes the same result as oskar_cross_correlate_simd_tiled_omp_d()
+ * with Jones matrices J = K * E, where K is the interferometer phase
+ * (as evaluated by oskar_evaluate_jones_K_d()), but without needing
+ * either K or J. For each baseline and source, the product K_p * conj(K_q)
+ * is evaluated inline from the station (u,v,w) coordinates and
+ * source (l,m,n) direction cosines, and applied to the correlation of the
+ * supplied Jones matrices \p jones.
+ *
+ * Sources with a Stokes I value outside the range given by
+ * \p source_min_jy (exclusive) and \p source_max_jy (inclusive) are
+ * ignored, as they would be by oskar_evaluate_jones_K_d().
+ *
+ * Other parameters are as for oskar_cross_correlate_simd_tiled_omp_d().
+ *
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones          Matrix of Jones matrices, excluding K.
+ * @param[in] station_map    Row of \p jones to use for each station
+ *                           (may be NULL).
+ * @param[in] source_I       Source Stokes I values, in Jy.
+ * @param[in] source_Q       Source Stokes Q values, in Jy.
+ * @param[in] source_U       Source Stokes U values, in Jy.
+ * @param[in] source_V       Source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] source_min_jy  Minimum allowed source Stokes I value (exclusive).
+ * @param[in] source_max_jy  Maximum allowed source Stokes I value (inclusive).
+ * @param[in,out] vis        Modified output complex visibilities.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_tiled_phase_omp_d(int num_sources,
+        int num_stations, const double4c* jones, const int* station_map,
+        const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V,
+        const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double source_min_jy, double source_max_jy,
+        double4c* vis, int* status);
+
+/**
+ * @brief
+ * Cache-blocked vectorised correlate function for several channels at once
+ * (single precision).
+ *
+ * @details
+ * For each of \p num_channels channels, this computes the same result as
+ * oskar_cross_correlate_simd_tiled_omp_f(), or as
+ * oskar_cross_correlate_simd_tiled_phase_omp_f() if \p apply_phase is set,
+ * but in one sweep over the sources.
+ *
+ * The source positions and Gaussian parameters and the station coordinates
+ * do not depend on frequency, and nor do the path difference and the
+ * bandwidth-smearing term for each baseline and source, or the time-smearing
+ * and Gaussian terms before scaling by the wavelength. These are evaluated
+ * once for each block of sources and used for all channels.
+ * The Jones matrices, source fluxes, inverse wavelengths and baseline length
+ * filters are given separately for each channel.
+ *
+ * The bandwidth-smearing term depends only on the channel bandwidth,
+ * which must be the same for all channels.
+ *
+ * The visibilities for channel c start at element c * num_baselines of
+ * \p vis, where num_baselines is num_stations * (num_stations - 1) / 2.
+ *
+ * @param[in] num_channels   Number of channels.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones          Per channel, matrix of Jones matrices to
+ *                           correlate (excluding K if \p apply_phase is set).
+ * @param[in] station_map    Per channel, row of \p jones to use for each
+ *                           station (array and entries may be NULL).
+ * @param[in] source_I       Per channel, source Stokes I values, in Jy.
+ * @param[in] source_Q       Per channel, source Stokes Q values, in Jy.
+ * @param[in] source_U       Per channel, source Stokes U values, in Jy.
+ * @param[in] source_V       Per channel, source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Per channel, minimum allowed UV length,
+ *                           in wavelengths.
+ * @param[in] uv_max_lambda  Per channel, maximum allowed UV length,
+ *                           in wavelengths.
+ * @param[in] inv_wavelength Per channel, inverse of the wavelength,
+ *                           in metres.
+ * @param[in] bandwidth_hz   Channel bandwidth, in Hz.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] apply_phase    If set, apply the interferometer phase.
+ * @param[in] source_min_jy  Minimum allowed source Stokes I value (exclusive),
+ *                           if \p apply_phase is set.
+ * @param[in] source_max_jy  Maximum allowed source Stokes I value (inclusive),
+ *                           if \p apply_phase is set.
+ * @param[in,out] vis        Modified output complex visibilities.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_tiled_channels_omp_f(int num_channels,
+        int num_sources, int num_stations, const float4c* const* jones,
+        const int* const* station_map, const float* const* source_I,
+        const float* const* source_Q, const float* const* source_U,
+        const float* const* source_V, const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        const float* uv_min_lambda, const float* uv_max_lambda,
+        const float* inv_wavelength, float bandwidth_hz,
+        float time_int_sec, float gha0_rad, float dec0_rad,
+        int apply_phase, float source_min_jy, float source_max_jy,
+        float4c* vis, int* status);
+
+/**
+ * @brief
+ * Cache-blocked vectorised correlate function for several channels at once
+ * (double precision).
+ *
+ * @details
+ * For each of \p num_channels channels, this computes the same result as
+ * oskar_cross_correlate_simd_tiled_omp_d(), or as
+ * oskar_cross_correlate_simd_tiled_phase_omp_d() if \p apply_phase is set,
+ * but in one sweep over the sources.
+ *
+ * The source positions and Gaussian parameters and the station coordinates
+ * do not depend on frequency, and nor do the path difference and the
+ * bandwidth-smearing term for each baseline and source, or the time-smearing
+ * and Gaussian terms before scaling by the wavelength. These are evaluated
+ * once for each block of sources and used for all channels.
+ * The Jones matrices, source fluxes, inverse wavelengths and baseline length
+ * filters are given separately for each channel.
+ *
+ * The bandwidth-smearing term depends only on the channel bandwidth,
+ * which must be the same for all channels.
+ *
+ * The visibilities for channel c start at element c * num_baselines of
+ * \p vis, where num_baselines is num_stations * (num_stations - 1) / 2.
+ *
+ * @param[in] num_channels   Number of channels.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] jones          Per channel, matrix of Jones matrices to
+ *                           correlate (excluding K if \p apply_phase is set).
+ * @param[in] station_map    Per channel, row of \p jones to use for each
+ *                           station (array and entries may be NULL).
+ * @param[in] source_I       Per channel, source Stokes I values, in Jy.
+ * @param[in] source_Q       Per channel, source Stokes Q values, in Jy.
+ * @param[in] source_U       Per channel, source Stokes U values, in Jy.
+ * @param[in] source_V       Per channel, source Stokes V values, in Jy.
+ * @param[in] source_l       Source l-direction cosines from phase centre.
+ * @param[in] source_m       Source m-direction cosines from phase centre.
+ * @param[in] source_n       Source n-direction cosines from phase centre.
+ * @param[in] source_a       Source Gaussian parameter a (may be NULL).
+ * @param[in] source_b       Source Gaussian parameter b.
+ * @param[in] source_c       Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Per channel, minimum allowed UV length,
+ *                           in wavelengths.
+ * @param[in] uv_max_lambda  Per channel, maximum allowed UV length,
+ *                           in wavelengths.
+ * @param[in] inv_wavelength Per channel, inverse of the wavelength,
+ *                           in metres.
+ * @param[in] bandwidth_hz   Channel bandwidth, in Hz.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] apply_phase    If set, apply the interferometer phase.
+ * @param[in] source_min_jy  Minimum allowed source Stokes I value (exclusive),
+ *                           if \p apply_phase is set.
+ * @param[in] source_max_jy  Maximum allowed source Stokes I value (inclusive),
+ *                           if \p apply_phase is set.
+ * @param[in,out] vis        Modified output complex visibilities.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_simd_tiled_channels_omp_d(int num_channels,
+        int num_sources, int num_stations, const double4c* const* jones,
+        const int* const* station_map, const double* const* source_I,
+        const double* const* source_Q, const double* const* source_U,
+        const double* const* source_V, const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        const double* uv_min_lambda, const double* uv_max_lambda,
+        const double* inv_wavelength, double bandwidth_hz,
+        double time_int_sec, double gha0_rad, double dec0_rad,
+        int apply_phase, double source_min_jy, double source_max_jy,
+        double4c* vis, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_CROSS_CORRELATE_SIMD_OMP_H_ */
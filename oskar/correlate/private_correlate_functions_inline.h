@@ -37,6 +37,20 @@
 #define OMEGA_EARTH  7.272205217e-5  /* radians/sec */
 #define OMEGA_EARTHf 7.272205217e-5f /* radians/sec */
 
+/* Build AVX-512 and AVX2 versions of a function, alongside the default one,
+ * and select between them at run time according to the host CPU.
+ * This needs GNU indirect function support, so is only enabled for
+ * x86-64 Linux builds using GCC or Clang. */
+#if !defined(__CUDACC__) && !defined(__INTEL_COMPILER) && \
+        defined(__x86_64__) && defined(__linux__) && \
+        ((defined(__clang__) && __clang_major__ >= 14) || \
+        (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 6))
+#define OSKAR_SIMD_CLONES \
+        __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define OSKAR_SIMD_CLONES
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
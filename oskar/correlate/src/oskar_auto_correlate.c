@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, The University of Oxford
+ * Copyright (c) 2015-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -31,6 +31,7 @@
 #include "correlate/oskar_auto_correlate_omp.h"
 #include "correlate/oskar_auto_correlate_scalar_cuda.h"
 #include "correlate/oskar_auto_correlate_scalar_omp.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
 #include <float.h>
@@ -44,6 +45,8 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
         const oskar_Sky* sky, int* status)
 {
     int jones_type, base_type, location, matrix_type, n_stations;
+    const int* station_map = 0;
+    oskar_Jones* J_copy = 0;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -91,6 +94,92 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
         return;
     }
 
+    /* Check for stations sharing the data of another station.
+     * Only the CPU kernels look up the row to use for each station,
+     * so otherwise the shared rows must be filled in a copy first. */
+    if (oskar_jones_num_shared_stations(J) > 0)
+    {
+        if (location == OSKAR_CPU)
+            station_map = oskar_mem_int_const(
+                    oskar_jones_station_map_const(J), status);
+        else
+        {
+            J_copy = oskar_jones_create_copy(J, location, status);
+            oskar_jones_expand_shared_stations(J_copy, status);
+            J = J_copy;
+        }
+        if (*status)
+        {
+            oskar_jones_free(J_copy, status);
+            return;
+        }
+    }
+
+    /* Use the OpenCL kernels if the data are in OpenCL device memory. */
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k;
+        cl_int error, n_src, n_stat;
+        cl_uint arg = 0;
+        const int is_dbl = (base_type == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((n_stations + local_size - 1) /
+                local_size) * local_size;
+        if (matrix_type)
+            k = is_dbl ? oskar_cl_kernel("acorr_double") :
+                    oskar_cl_kernel("acorr_float");
+        else
+            k = is_dbl ? oskar_cl_kernel("acorr_scalar_double") :
+                    oskar_cl_kernel("acorr_scalar_float");
+        if (!k)
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+        else
+        {
+            /* Set kernel arguments. */
+            n_src = (cl_int) n_sources;
+            n_stat = (cl_int) n_stations;
+            error = clSetKernelArg(k, arg++, sizeof(cl_int), &n_src);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_int), &n_stat);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                    oskar_mem_cl_buffer_const(oskar_jones_mem_const(J),
+                            status));
+            error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                    oskar_mem_cl_buffer_const(oskar_sky_I_const(sky),
+                            status));
+            if (matrix_type)
+            {
+                error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(oskar_sky_Q_const(sky),
+                                status));
+                error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(oskar_sky_U_const(sky),
+                                status));
+                error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(oskar_sky_V_const(sky),
+                                status));
+            }
+            error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                    oskar_mem_cl_buffer(vis, status));
+            if (!*status && error != CL_SUCCESS)
+                *status = OSKAR_ERR_INVALID_ARGUMENT;
+            if (!*status && n_stations > 0)
+            {
+                /* Launch kernel on current command queue. */
+                error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k,
+                        1, NULL, &global_size, &local_size, 0, NULL, &event);
+                if (error != CL_SUCCESS)
+                    *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+            }
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+        oskar_jones_free(J_copy, status);
+        return;
+    }
+
     /* Select kernel. */
     if (base_type == OSKAR_DOUBLE)
     {
@@ -120,7 +209,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             else /* CPU */
             {
                 oskar_auto_correlate_omp_d(n_sources, n_stations,
-                        J_, I_, Q_, U_, V_, vis_);
+                        J_, station_map, I_, Q_, U_, V_, vis_);
             }
         }
         else /* Scalar version. */
@@ -143,7 +232,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             else /* CPU */
             {
                 oskar_auto_correlate_scalar_omp_d(n_sources, n_stations,
-                        J_, I_, vis_);
+                        J_, station_map, I_, vis_);
             }
         }
     }
@@ -175,7 +264,7 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             else /* CPU */
             {
                 oskar_auto_correlate_omp_f(n_sources, n_stations,
-                        J_, I_, Q_, U_, V_, vis_);
+                        J_, station_map, I_, Q_, U_, V_, vis_);
             }
         }
         else /* Scalar version. */
@@ -198,10 +287,11 @@ void oskar_auto_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             else /* CPU */
             {
                 oskar_auto_correlate_scalar_omp_f(n_sources, n_stations,
-                        J_, I_, vis_);
+                        J_, station_map, I_, vis_);
             }
         }
     }
+    oskar_jones_free(J_copy, status);
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,55 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void acorr_REAL(const int num_sources, const int num_stations,
+        global const REAL8* restrict jones,
+        global const REAL* restrict source_I,
+        global const REAL* restrict source_Q,
+        global const REAL* restrict source_U,
+        global const REAL* restrict source_V,
+        global REAL8* restrict vis)
+{
+    const int s = get_global_id(0);
+    if (s >= num_stations) return;
+    global const REAL8* restrict station = &jones[s * num_sources];
+    REAL8 sum = (REAL8)(0., 0., 0., 0., 0., 0., 0., 0.);
+    for (int i = 0; i < num_sources; ++i) {
+        // Evaluate J * B * J^H, where B is the source brightness matrix.
+        const REAL8 j = station[i];
+        const REAL I = source_I[i], Q = source_Q[i];
+        const REAL U = source_U[i], V = source_V[i];
+        const REAL ba = I + Q, bd = I - Q;
+        REAL2 a, b, c, d;
+        a.x = j.s0 * ba + j.s2 * U + j.s3 * V;
+        a.y = j.s1 * ba + j.s3 * U - j.s2 * V;
+        b.x = j.s2 * bd + j.s0 * U - j.s1 * V;
+        b.y = j.s3 * bd + j.s1 * U + j.s0 * V;
+        c.x = j.s4 * ba + j.s6 * U + j.s7 * V;
+        c.y = j.s5 * ba + j.s7 * U - j.s6 * V;
+        d.x = j.s6 * bd + j.s4 * U - j.s5 * V;
+        d.y = j.s7 * bd + j.s5 * U + j.s4 * V;
+        sum.s0 += a.x * j.s0 + a.y * j.s1 + b.x * j.s2 + b.y * j.s3;
+        sum.s2 += a.x * j.s4 + a.y * j.s5 + b.x * j.s6 + b.y * j.s7;
+        sum.s3 += a.y * j.s4 - a.x * j.s5 + b.y * j.s6 - b.x * j.s7;
+        sum.s4 += c.x * j.s0 + c.y * j.s1 + d.x * j.s2 + d.y * j.s3;
+        sum.s5 += c.y * j.s0 - c.x * j.s1 + d.y * j.s2 - d.x * j.s3;
+        sum.s6 += c.x * j.s4 + c.y * j.s5 + d.x * j.s6 + d.y * j.s7;
+    }
+    // Diagonal terms are real, so leave the imaginary parts blank.
+    vis[s] += sum;
+}
+
+kernel void acorr_scalar_REAL(const int num_sources, const int num_stations,
+        global const REAL2* restrict jones,
+        global const REAL* restrict source_I,
+        global REAL2* restrict vis)
+{
+    const int s = get_global_id(0);
+    if (s >= num_stations) return;
+    global const REAL2* restrict station = &jones[s * num_sources];
+    REAL sum = (REAL) 0.;
+    for (int i = 0; i < num_sources; ++i) {
+        const REAL2 j = station[i];
+        sum += (j.x * j.x + j.y * j.y) * source_I[i];
+    }
+    vis[s].x += sum;
+}
@@ -27,6 +27,7 @@
  */
 
 #include <math.h>
+#include <stdlib.h>
 #include "correlate/private_correlate_functions_inline.h"
 #include "correlate/oskar_auto_correlate_omp.h"
 #include "math/oskar_add_inline.h"
@@ -37,12 +38,29 @@ extern "C" {
 
 /* Single precision. */
 void oskar_auto_correlate_omp_f(const int num_sources, const int num_stations,
-        const float4c* jones, const float* source_I, const float* source_Q,
-        const float* source_U, const float* source_V, float4c* vis)
+        const float4c* jones, const int* station_map, const float* source_I,
+        const float* source_Q, const float* source_U, const float* source_V,
+        float4c* vis)
 {
     int s;
+    float4c* shared_sum = 0;
+    int* first = 0;
 
-    /* Loop over stations. */
+    /* Keep the results for each row of shared data, and find the first
+     * station using each row. */
+    if (station_map)
+    {
+        shared_sum = (float4c*) malloc(num_stations *
+                (sizeof(float4c) + sizeof(int)));
+        if (shared_sum)
+        {
+            first = (int*) (shared_sum + num_stations);
+            for (s = 0; s < num_stations; ++s) first[s] = -1;
+            for (s = num_stations - 1; s >= 0; --s) first[station_map[s]] = s;
+        }
+    }
+
+    /* Loop over the first station using each row. */
 #pragma omp parallel for private(s)
     for (s = 0; s < num_stations; ++s)
     {
@@ -50,11 +68,15 @@ void oskar_auto_correlate_omp_f(const int num_sources, const int num_stations,
         const float4c *station;
         float4c sum, guard;
 
+        /* Skip stations using a row that is evaluated for another station,
+         * if its results can be kept. */
+        if (first && first[station_map[s]] != s) continue;
+
         oskar_clear_complex_matrix_f(&sum);
         oskar_clear_complex_matrix_f(&guard);
 
         /* Pointer to source vector for station. */
-        station = &jones[s * num_sources];
+        station = &jones[(station_map ? station_map[s] : s) * num_sources];
 
         /* Accumulate visibility response for source. */
         for (i = 0; i < num_sources; ++i)
@@ -67,17 +89,45 @@ void oskar_auto_correlate_omp_f(const int num_sources, const int num_stations,
         sum.a.y = 0.0f;
         sum.d.y = 0.0f;
         oskar_add_complex_matrix_in_place_f(&vis[s], &sum);
+        if (shared_sum) shared_sum[station_map[s]] = sum;
+    }
+
+    /* Add results to the other stations using each row. */
+    if (shared_sum)
+    {
+        for (s = 0; s < num_stations; ++s)
+            if (first[station_map[s]] != s)
+                oskar_add_complex_matrix_in_place_f(&vis[s],
+                        &shared_sum[station_map[s]]);
+        free(shared_sum);
     }
 }
 
 /* Double precision. */
 void oskar_auto_correlate_omp_d(const int num_sources, const int num_stations,
-        const double4c* jones, const double* source_I, const double* source_Q,
-        const double* source_U, const double* source_V, double4c* vis)
+        const double4c* jones, const int* station_map, const double* source_I,
+        const double* source_Q, const double* source_U, const double* source_V,
+        double4c* vis)
 {
     int s;
+    double4c* shared_sum = 0;
+    int* first = 0;
 
-    /* Loop over stations. */
+    /* Keep the results for each row of shared data, and find the first
+     * station using each row. */
+    if (station_map)
+    {
+        shared_sum = (double4c*) malloc(num_stations *
+                (sizeof(double4c) + sizeof(int)));
+        if (shared_sum)
+        {
+            first = (int*) (shared_sum + num_stations);
+            for (s = 0; s < num_stations; ++s) first[s] = -1;
+            for (s = num_stations - 1; s >= 0; --s) first[station_map[s]] = s;
+        }
+    }
+
+    /* Loop over the first station using each row. */
 #pragma omp parallel for private(s)
     for (s = 0; s < num_stations; ++s)
     {
@@ -85,10 +135,14 @@ void oskar_auto_correlate_omp_d(const int num_sources, const int num_stations,
         const double4c *station;
         double4c sum;
 
+        /* Skip stations using a row that is evaluated for another station,
+         * if its results can be kept. */
+        if (first && first[station_map[s]] != s) continue;
+
         oskar_clear_complex_matrix_d(&sum);
 
         /* Pointer to source vector for station. */
-        station = &jones[s * num_sources];
+        station = &jones[(station_map ? station_map[s] : s) * num_sources];
 
         /* Accumulate visibility response for source. */
         for (i = 0; i < num_sources; ++i)
@@ -100,6 +154,17 @@ void oskar_auto_correlate_omp_d(const int num_sources, const int num_stations,
         sum.a.y = 0.0;
         sum.d.y = 0.0;
         oskar_add_complex_matrix_in_place_d(&vis[s], &sum);
+        if (shared_sum) shared_sum[station_map[s]] = sum;
+    }
+
+    /* Add results to the other stations using each row. */
+    if (shared_sum)
+    {
+        for (s = 0; s < num_stations; ++s)
+            if (first[station_map[s]] != s)
+                oskar_add_complex_matrix_in_place_d(&vis[s],
+                        &shared_sum[station_map[s]]);
+        free(shared_sum);
     }
 }
 
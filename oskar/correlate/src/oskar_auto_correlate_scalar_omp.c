@@ -27,6 +27,7 @@
  */
 
 #include <math.h>
+#include <stdlib.h>
 #include "correlate/private_correlate_functions_inline.h"
 #include "correlate/oskar_auto_correlate_scalar_omp.h"
 #include "math/oskar_add_inline.h"
@@ -37,12 +38,28 @@ extern "C" {
 
 /* Single precision. */
 void oskar_auto_correlate_scalar_omp_f(const int num_sources,
-        const int num_stations, const float2* jones, const float* source_I,
-        float2* vis)
+        const int num_stations, const float2* jones, const int* station_map,
+        const float* source_I, float2* vis)
 {
     int s;
+    float* shared_sum = 0;
+    int* first = 0;
 
-    /* Loop over stations. */
+    /* Keep the results for each row of shared data, and find the first
+     * station using each row. */
+    if (station_map)
+    {
+        shared_sum = (float*) malloc(num_stations *
+                (sizeof(float) + sizeof(int)));
+        if (shared_sum)
+        {
+            first = (int*) (shared_sum + num_stations);
+            for (s = 0; s < num_stations; ++s) first[s] = -1;
+            for (s = num_stations - 1; s >= 0; --s) first[station_map[s]] = s;
+        }
+    }
+
+    /* Loop over the first station using each row. */
 #pragma omp parallel for private(s)
     for (s = 0; s < num_stations; ++s)
     {
@@ -50,13 +67,17 @@ void oskar_auto_correlate_scalar_omp_f(const int num_sources,
         const float2 *station;
         float2 sum, guard;
 
+        /* Skip stations using a row that is evaluated for another station,
+         * if its results can be kept. */
+        if (first && first[station_map[s]] != s) continue;
+
         sum.x = 0.0f;
         sum.y = 0.0f;
         guard.x = 0.0f;
         guard.y = 0.0f;
 
         /* Pointer to source vector for station. */
-        station = &jones[s * num_sources];
+        station = &jones[(station_map ? station_map[s] : s) * num_sources];
 
         /* Accumulate visibility response for source. */
         for (i = 0; i < num_sources; ++i)
@@ -65,17 +86,43 @@ void oskar_auto_correlate_scalar_omp_f(const int num_sources,
 
         /* Add result to the station visibility. We only need the real part. */
         vis[s].x += sum.x;
+        if (shared_sum) shared_sum[station_map[s]] = sum.x;
+    }
+
+    /* Add results to the other stations using each row. */
+    if (shared_sum)
+    {
+        for (s = 0; s < num_stations; ++s)
+            if (first[station_map[s]] != s)
+                vis[s].x += shared_sum[station_map[s]];
+        free(shared_sum);
     }
 }
 
 /* Double precision. */
 void oskar_auto_correlate_scalar_omp_d(const int num_sources,
-        const int num_stations, const double2* jones, const double* source_I,
-        double2* vis)
+        const int num_stations, const double2* jones, const int* station_map,
+        const double* source_I, double2* vis)
 {
     int s;
+    double* shared_sum = 0;
+    int* first = 0;
 
-    /* Loop over stations. */
+    /* Keep the results for each row of shared data, and find the first
+     * station using each row. */
+    if (station_map)
+    {
+        shared_sum = (double*) malloc(num_stations *
+                (sizeof(double) + sizeof(int)));
+        if (shared_sum)
+        {
+            first = (int*) (shared_sum + num_stations);
+            for (s = 0; s < num_stations; ++s) first[s] = -1;
+            for (s = num_stations - 1; s >= 0; --s) first[station_map[s]] = s;
+        }
+    }
+
+    /* Loop over the first station using each row. */
 #pragma omp parallel for private(s)
     for (s = 0; s < num_stations; ++s)
     {
@@ -83,11 +130,15 @@ void oskar_auto_correlate_scalar_omp_d(const int num_sources,
         const double2 *station;
         double2 sum;
 
+        /* Skip stations using a row that is evaluated for another station,
+         * if its results can be kept. */
+        if (first && first[station_map[s]] != s) continue;
+
         sum.x = 0.0;
         sum.y = 0.0;
 
         /* Pointer to source vector for station. */
-        station = &jones[s * num_sources];
+        station = &jones[(station_map ? station_map[s] : s) * num_sources];
 
         /* Accumulate visibility response for source. */
         for (i = 0; i < num_sources; ++i)
@@ -96,6 +147,16 @@ void oskar_auto_correlate_scalar_omp_d(const int num_sources,
 
         /* Add result to the station visibility. We only need the real part. */
         vis[s].x += sum.x;
+        if (shared_sum) shared_sum[station_map[s]] = sum.x;
+    }
+
+    /* Add results to the other stations using each row. */
+    if (shared_sum)
+    {
+        for (s = 0; s < num_stations; ++s)
+            if (first[station_map[s]] != s)
+                vis[s].x += shared_sum[station_map[s]];
+        free(shared_sum);
     }
 }
 
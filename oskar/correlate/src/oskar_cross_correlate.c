@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -28,13 +28,9 @@
 
 #include "correlate/oskar_cross_correlate.h"
 #include "correlate/oskar_cross_correlate_gaussian_cuda.h"
-#include "correlate/oskar_cross_correlate_gaussian_omp.h"
 #include "correlate/oskar_cross_correlate_gaussian_time_smearing_cuda.h"
-#include "correlate/oskar_cross_correlate_gaussian_time_smearing_omp.h"
 #include "correlate/oskar_cross_correlate_point_cuda.h"
-#include "correlate/oskar_cross_correlate_point_omp.h"
 #include "correlate/oskar_cross_correlate_point_time_smearing_cuda.h"
-#include "correlate/oskar_cross_correlate_point_time_smearing_omp.h"
 #include "correlate/oskar_cross_correlate_gaussian_scalar_cuda.h"
 #include "correlate/oskar_cross_correlate_gaussian_scalar_omp.h"
 #include "correlate/oskar_cross_correlate_gaussian_time_smearing_scalar_cuda.h"
@@ -43,52 +39,239 @@
 #include "correlate/oskar_cross_correlate_point_scalar_omp.h"
 #include "correlate/oskar_cross_correlate_point_time_smearing_scalar_cuda.h"
 #include "correlate/oskar_cross_correlate_point_time_smearing_scalar_omp.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
 #include <float.h>
 #include <math.h>
+#include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+static void cross_correlate(oskar_Mem* vis, int n_sources,
+        const oskar_Jones* J, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double frequency_hz, int apply_phase,
+        double source_min_jy, double source_max_jy, int* status);
+
+static void check_inputs(const oskar_Mem* vis, int num_vis, int n_sources,
+        const oskar_Jones* J, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        int* status);
+
+#ifdef OSKAR_HAVE_OPENCL
+static void cross_correlate_cl(oskar_Mem* vis, int n_sources,
+        const oskar_Jones* J, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        int matrix_type, int use_extended, double uv_filter_min,
+        double uv_filter_max, double inv_wavelength, double frac_bandwidth,
+        double time_avg, double gha0, double dec0, int* status);
+#endif
+
 void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
         const oskar_Sky* sky, const oskar_Telescope* tel, const oskar_Mem* u,
         const oskar_Mem* v, const oskar_Mem* w, double gast,
         double frequency_hz, int* status)
 {
-    int jones_type, base_type, location, matrix_type, n_stations;
-    int use_extended;
-    double inv_wavelength, frac_bandwidth, time_avg, gha0, dec0;
-    double uv_filter_max, uv_filter_min;
+    cross_correlate(vis, n_sources, J, sky, tel, u, v, w, gast, frequency_hz,
+            0, 0.0, 0.0, status);
+}
+
+void oskar_cross_correlate_phase(oskar_Mem* vis, int n_sources,
+        const oskar_Jones* E, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double frequency_hz, double source_min_jy,
+        double source_max_jy, int* status)
+{
+    cross_correlate(vis, n_sources, E, sky, tel, u, v, w, gast, frequency_hz,
+            1, source_min_jy, source_max_jy, status);
+}
+
+void oskar_cross_correlate_channels(oskar_Mem* vis, int num_channels,
+        int n_sources, oskar_Jones* const* J, oskar_Sky* const* sky,
+        const oskar_Telescope* tel, const oskar_Mem* u, const oskar_Mem* v,
+        const oskar_Mem* w, double gast, const double* frequency_hz,
+        int apply_phase, double source_min_jy, double source_max_jy,
+        int* status)
+{
+    int c, n_stations, num_baselines, use_extended;
+    double bandwidth, time_avg, gha0, dec0, *inv_wavelength;
+    double *uv_filter_min, *uv_filter_max;
+    float* par_f;
+    const void **jones, **map, **I_, **Q_, **U_, **V_;
+    void* work;
 
     /* Check if safe to proceed. */
-    if (*status) return;
+    if (*status || num_channels <= 0) return;
 
     /* Get the data dimensions. */
     n_stations = oskar_telescope_num_stations(tel);
-    use_extended = oskar_sky_use_extended(sky);
+    num_baselines = oskar_telescope_num_baselines(tel);
 
-    /* Get bandwidth-smearing terms. */
-    frequency_hz = fabs(frequency_hz);
-    inv_wavelength = frequency_hz / 299792458.0;
-    frac_bandwidth = oskar_telescope_channel_bandwidth_hz(tel) / frequency_hz;
+    /* Only the CPU matrix kernel handles several channels at once,
+     * so otherwise correlate each channel in turn. */
+    if (oskar_mem_location(vis) != OSKAR_CPU || !oskar_mem_is_matrix(vis) ||
+            num_channels == 1)
+    {
+        for (c = 0; c < num_channels; ++c)
+        {
+            const size_t offset = (size_t)c * num_baselines;
+            oskar_Mem* slice = oskar_mem_create_slice(vis, offset,
+                    num_baselines, status);
+            cross_correlate(slice, n_sources, J[c], sky[c], tel, u, v, w,
+                    gast, frequency_hz[c], apply_phase, source_min_jy,
+                    source_max_jy, status);
+            oskar_mem_free_slice(slice, vis, offset, status);
+        }
+        return;
+    }
 
-    /* Get time-average smearing term and Greenwich hour angle. */
+    /* Check the inputs for each channel. */
+    for (c = 0; c < num_channels; ++c)
+    {
+        check_inputs(vis, num_channels * num_baselines, n_sources, J[c],
+                sky[c], tel, u, v, w, status);
+        if (!*status && !oskar_type_is_matrix(oskar_jones_type(J[c])))
+            *status = OSKAR_ERR_TYPE_MISMATCH;
+        if (*status) return;
+    }
+
+    /* Get the terms that are the same for all channels. */
+    use_extended = oskar_sky_use_extended(sky[0]);
+    bandwidth = oskar_telescope_channel_bandwidth_hz(tel);
     time_avg = oskar_telescope_time_average_sec(tel);
     gha0 = gast - oskar_telescope_phase_centre_ra_rad(tel);
     dec0 = oskar_telescope_phase_centre_dec_rad(tel);
+    if (source_min_jy < -FLT_MAX) source_min_jy = -FLT_MAX;
+    if (source_max_jy > FLT_MAX) source_max_jy = FLT_MAX;
 
-    /* Get UV filter parameters in wavelengths. */
-    uv_filter_min = oskar_telescope_uv_filter_min(tel);
-    uv_filter_max = oskar_telescope_uv_filter_max(tel);
-    if (oskar_telescope_uv_filter_units(tel) == OSKAR_METRES)
+    /* Allocate space for the per-channel pointers and parameters. */
+    work = malloc(num_channels *
+            (6 * sizeof(void*) + 3 * sizeof(double) + 3 * sizeof(float)));
+    if (!work)
     {
-        uv_filter_min *= inv_wavelength;
-        uv_filter_max *= inv_wavelength;
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
     }
-    if (uv_filter_max < 0.0 || uv_filter_max > FLT_MAX)
-        uv_filter_max = FLT_MAX;
+    jones = (const void**) work;
+    map = jones + num_channels;
+    I_ = map + num_channels;
+    Q_ = I_ + num_channels;
+    U_ = Q_ + num_channels;
+    V_ = U_ + num_channels;
+    inv_wavelength = (double*) (V_ + num_channels);
+    uv_filter_min = inv_wavelength + num_channels;
+    uv_filter_max = uv_filter_min + num_channels;
+    par_f = (float*) (uv_filter_max + num_channels);
+
+    /* Get the per-channel pointers and parameters. */
+    for (c = 0; c < num_channels; ++c)
+    {
+        const double freq = fabs(frequency_hz[c]);
+        inv_wavelength[c] = freq / 299792458.0;
+        uv_filter_min[c] = oskar_telescope_uv_filter_min(tel);
+        uv_filter_max[c] = oskar_telescope_uv_filter_max(tel);
+        if (oskar_telescope_uv_filter_units(tel) == OSKAR_METRES)
+        {
+            uv_filter_min[c] *= inv_wavelength[c];
+            uv_filter_max[c] *= inv_wavelength[c];
+        }
+        if (uv_filter_max[c] < 0.0 || uv_filter_max[c] > FLT_MAX)
+            uv_filter_max[c] = FLT_MAX;
+        jones[c] = oskar_mem_void_const(oskar_jones_mem_const(J[c]));
+        map[c] = (oskar_jones_num_shared_stations(J[c]) > 0) ?
+                oskar_mem_int_const(oskar_jones_station_map_const(J[c]),
+                        status) : 0;
+        I_[c] = oskar_mem_void_const(oskar_sky_I_const(sky[c]));
+        Q_[c] = oskar_mem_void_const(oskar_sky_Q_const(sky[c]));
+        U_[c] = oskar_mem_void_const(oskar_sky_U_const(sky[c]));
+        V_[c] = oskar_mem_void_const(oskar_sky_V_const(sky[c]));
+    }
+
+    /* Correlate all channels in one sweep over the sources. */
+    if (oskar_mem_precision(vis) == OSKAR_DOUBLE)
+    {
+        const double *l_, *m_, *n_, *a_, *b_, *c_, *u_, *v_, *w_, *x_, *y_;
+        l_ = oskar_mem_double_const(oskar_sky_l_const(sky[0]), status);
+        m_ = oskar_mem_double_const(oskar_sky_m_const(sky[0]), status);
+        n_ = oskar_mem_double_const(oskar_sky_n_const(sky[0]), status);
+        a_ = oskar_mem_double_const(oskar_sky_gaussian_a_const(sky[0]),
+                status);
+        b_ = oskar_mem_double_const(oskar_sky_gaussian_b_const(sky[0]),
+                status);
+        c_ = oskar_mem_double_const(oskar_sky_gaussian_c_const(sky[0]),
+                status);
+        u_ = oskar_mem_double_const(u, status);
+        v_ = oskar_mem_double_const(v, status);
+        w_ = oskar_mem_double_const(w, status);
+        x_ = oskar_mem_double_const(
+                oskar_telescope_station_true_x_offset_ecef_metres_const(tel),
+                status);
+        y_ = oskar_mem_double_const(
+                oskar_telescope_station_true_y_offset_ecef_metres_const(tel),
+                status);
+        oskar_cross_correlate_simd_tiled_channels_omp_d(num_channels,
+                n_sources, n_stations, (const double4c* const*) jones,
+                (const int* const*) map, (const double* const*) I_,
+                (const double* const*) Q_, (const double* const*) U_,
+                (const double* const*) V_, l_, m_, n_,
+                use_extended ? a_ : 0, b_, c_, u_, v_, w_, x_, y_,
+                uv_filter_min, uv_filter_max, inv_wavelength, bandwidth,
+                time_avg, gha0, dec0, apply_phase, source_min_jy,
+                source_max_jy, oskar_mem_double4c(vis, status), status);
+    }
+    else
+    {
+        const float *l_, *m_, *n_, *a_, *b_, *c_, *u_, *v_, *w_, *x_, *y_;
+        for (c = 0; c < num_channels; ++c)
+        {
+            par_f[c] = (float) inv_wavelength[c];
+            par_f[num_channels + c] = (float) uv_filter_min[c];
+            par_f[2 * num_channels + c] = (float) uv_filter_max[c];
+        }
+        l_ = oskar_mem_float_const(oskar_sky_l_const(sky[0]), status);
+        m_ = oskar_mem_float_const(oskar_sky_m_const(sky[0]), status);
+        n_ = oskar_mem_float_const(oskar_sky_n_const(sky[0]), status);
+        a_ = oskar_mem_float_const(oskar_sky_gaussian_a_const(sky[0]),
+                status);
+        b_ = oskar_mem_float_const(oskar_sky_gaussian_b_const(sky[0]),
+                status);
+        c_ = oskar_mem_float_const(oskar_sky_gaussian_c_const(sky[0]),
+                status);
+        u_ = oskar_mem_float_const(u, status);
+        v_ = oskar_mem_float_const(v, status);
+        w_ = oskar_mem_float_const(w, status);
+        x_ = oskar_mem_float_const(
+                oskar_telescope_station_true_x_offset_ecef_metres_const(tel),
+                status);
+        y_ = oskar_mem_float_const(
+                oskar_telescope_station_true_y_offset_ecef_metres_const(tel),
+                status);
+        oskar_cross_correlate_simd_tiled_channels_omp_f(num_channels,
+                n_sources, n_stations, (const float4c* const*) jones,
+                (const int* const*) map, (const float* const*) I_,
+                (const float* const*) Q_, (const float* const*) U_,
+                (const float* const*) V_, l_, m_, n_,
+                use_extended ? a_ : 0, b_, c_, u_, v_, w_, x_, y_,
+                &par_f[num_channels], &par_f[2 * num_channels], par_f,
+                (float) bandwidth, (float) time_avg, (float) gha0,
+                (float) dec0, apply_phase, (float) source_min_jy,
+                (float) source_max_jy, oskar_mem_float4c(vis, status),
+                status);
+    }
+    free(work);
+}
+
+static void check_inputs(const oskar_Mem* vis, int num_vis, int n_sources,
+        const oskar_Jones* J, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        int* status)
+{
+    int jones_type, base_type, location, n_stations;
+    if (*status) return;
 
     /* Check data locations. */
     location = oskar_sky_mem_location(sky);
@@ -106,8 +289,6 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
     /* Check for consistent data types. */
     jones_type = oskar_jones_type(J);
     base_type = oskar_sky_precision(sky);
-    matrix_type = oskar_type_is_matrix(jones_type) &&
-            oskar_mem_is_matrix(vis);
     if (oskar_mem_precision(vis) != base_type ||
             oskar_type_precision(jones_type) != base_type ||
             oskar_mem_type(u) != base_type || oskar_mem_type(v) != base_type ||
@@ -130,6 +311,7 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
     }
 
     /* Check the input dimensions. */
+    n_stations = oskar_telescope_num_stations(tel);
     if (oskar_jones_num_sources(J) < n_sources ||
             (int)oskar_mem_length(u) != n_stations ||
             (int)oskar_mem_length(v) != n_stations ||
@@ -140,11 +322,110 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
     }
 
     /* Check there is enough space for the result. */
-    if ((int)oskar_mem_length(vis) < oskar_telescope_num_baselines(tel))
+    if ((int)oskar_mem_length(vis) < num_vis)
     {
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
         return;
     }
+}
+
+static void cross_correlate(oskar_Mem* vis, int n_sources,
+        const oskar_Jones* J, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double frequency_hz, int apply_phase,
+        double source_min_jy, double source_max_jy, int* status)
+{
+    int jones_type, base_type, location, matrix_type, n_stations;
+    int use_extended;
+    const int* station_map = 0;
+    oskar_Jones* J_copy = 0;
+    double inv_wavelength, frac_bandwidth, time_avg, gha0, dec0;
+    double uv_filter_max, uv_filter_min;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Get the data dimensions. */
+    n_stations = oskar_telescope_num_stations(tel);
+    use_extended = oskar_sky_use_extended(sky);
+
+    /* Get bandwidth-smearing terms. */
+    frequency_hz = fabs(frequency_hz);
+    inv_wavelength = frequency_hz / 299792458.0;
+    frac_bandwidth = oskar_telescope_channel_bandwidth_hz(tel) / frequency_hz;
+
+    /* Get time-average smearing term and Greenwich hour angle. */
+    time_avg = oskar_telescope_time_average_sec(tel);
+    gha0 = gast - oskar_telescope_phase_centre_ra_rad(tel);
+    dec0 = oskar_telescope_phase_centre_dec_rad(tel);
+
+    /* Get UV filter parameters in wavelengths. */
+    uv_filter_min = oskar_telescope_uv_filter_min(tel);
+    uv_filter_max = oskar_telescope_uv_filter_max(tel);
+    if (oskar_telescope_uv_filter_units(tel) == OSKAR_METRES)
+    {
+        uv_filter_min *= inv_wavelength;
+        uv_filter_max *= inv_wavelength;
+    }
+    if (uv_filter_max < 0.0 || uv_filter_max > FLT_MAX)
+        uv_filter_max = FLT_MAX;
+
+    /* Clamp the source filter range, so it can be used in single precision. */
+    if (source_min_jy < -FLT_MAX) source_min_jy = -FLT_MAX;
+    if (source_max_jy > FLT_MAX) source_max_jy = FLT_MAX;
+
+    /* Check the inputs. */
+    check_inputs(vis, oskar_telescope_num_baselines(tel), n_sources, J, sky,
+            tel, u, v, w, status);
+    if (*status) return;
+    location = oskar_sky_mem_location(sky);
+    jones_type = oskar_jones_type(J);
+    base_type = oskar_sky_precision(sky);
+    matrix_type = oskar_type_is_matrix(jones_type) &&
+            oskar_mem_is_matrix(vis);
+
+    /* The interferometer phase can only be applied by the CPU matrix kernel
+     * at present. */
+    if (apply_phase && (location != OSKAR_CPU || !matrix_type))
+    {
+        *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+        return;
+    }
+
+    /* Check for stations sharing the data of another station.
+     * Only the CPU matrix kernel looks up the row to use for each station,
+     * so otherwise the shared rows must be filled in a copy first. */
+    if (oskar_jones_num_shared_stations(J) > 0)
+    {
+        if (location == OSKAR_CPU && matrix_type)
+            station_map = oskar_mem_int_const(
+                    oskar_jones_station_map_const(J), status);
+        else
+        {
+            J_copy = oskar_jones_create_copy(J, location, status);
+            oskar_jones_expand_shared_stations(J_copy, status);
+            J = J_copy;
+        }
+        if (*status)
+        {
+            oskar_jones_free(J_copy, status);
+            return;
+        }
+    }
+
+    /* Use the OpenCL kernels if the data are in OpenCL device memory. */
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cross_correlate_cl(vis, n_sources, J, sky, tel, u, v, w, matrix_type,
+                use_extended, uv_filter_min, uv_filter_max, inv_wavelength,
+                frac_bandwidth, time_avg, gha0, dec0, status);
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+        oskar_jones_free(J_copy, status);
+        return;
+    }
 
     /* Select kernel. */
     if (base_type == OSKAR_DOUBLE)
@@ -223,45 +504,22 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
                 *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
 #endif
             }
+            else if (apply_phase) /* CPU, with interferometer phase. */
+            {
+                oskar_cross_correlate_simd_tiled_phase_omp_d(n_sources,
+                        n_stations, J_, station_map, I_, Q_, U_, V_, l_, m_, n_,
+                        use_extended ? a_ : 0, b_, c_, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0,
+                        source_min_jy, source_max_jy, vis_, status);
+            }
             else /* CPU */
             {
-                if (time_avg > 0.0)
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_time_smearing_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_time_smearing_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                }
-                else /* Non-time-smearing. */
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_omp_d
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, uv_filter_min, uv_filter_max,
-                                inv_wavelength, frac_bandwidth, vis_);
-                    }
-                }
+                oskar_cross_correlate_simd_tiled_omp_d(n_sources,
+                        n_stations, J_, station_map, I_, Q_, U_, V_, l_, m_, n_,
+                        use_extended ? a_ : 0, b_, c_, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0, vis_, status);
             }
         }
         else /* Scalar version. */
@@ -434,45 +692,22 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
                 *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
 #endif
             }
+            else if (apply_phase) /* CPU, with interferometer phase. */
+            {
+                oskar_cross_correlate_simd_tiled_phase_omp_f(n_sources,
+                        n_stations, J_, station_map, I_, Q_, U_, V_, l_, m_, n_,
+                        use_extended ? a_ : 0, b_, c_, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0,
+                        source_min_jy, source_max_jy, vis_, status);
+            }
             else /* CPU */
             {
-                if (time_avg > 0.0)
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_time_smearing_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_time_smearing_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, x_, y_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                time_avg, gha0, dec0, vis_);
-                    }
-                }
-                else /* Non-time-smearing. */
-                {
-                    if (use_extended)
-                    {
-                        oskar_cross_correlate_gaussian_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                a_, b_, c_, u_, v_, w_, uv_filter_min,
-                                uv_filter_max, inv_wavelength, frac_bandwidth,
-                                vis_);
-                    }
-                    else
-                    {
-                        oskar_cross_correlate_point_omp_f
-                        (n_sources, n_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
-                                u_, v_, w_, uv_filter_min, uv_filter_max,
-                                inv_wavelength, frac_bandwidth, vis_);
-                    }
-                }
+                oskar_cross_correlate_simd_tiled_omp_f(n_sources,
+                        n_stations, J_, station_map, I_, Q_, U_, V_, l_, m_, n_,
+                        use_extended ? a_ : 0, b_, c_, u_, v_, w_, x_, y_,
+                        uv_filter_min, uv_filter_max, inv_wavelength,
+                        frac_bandwidth, time_avg, gha0, dec0, vis_, status);
             }
         }
         else /* Scalar version. */
@@ -569,8 +804,135 @@ void oskar_cross_correlate(oskar_Mem* vis, int n_sources, const oskar_Jones* J,
             }
         }
     }
+    oskar_jones_free(J_copy, status);
 }
 
+#ifdef OSKAR_HAVE_OPENCL
+static void cross_correlate_cl(oskar_Mem* vis, int n_sources,
+        const oskar_Jones* J, const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        int matrix_type, int use_extended, double uv_filter_min,
+        double uv_filter_max, double inv_wavelength, double frac_bandwidth,
+        double time_avg, double gha0, double dec0, int* status)
+{
+    cl_device_type dev_type;
+    cl_event event;
+    cl_kernel k;
+    cl_int error, n_src, n_stations, extended;
+    cl_uint arg = 0;
+    int i, is_gpu, is_dbl, num_baselines;
+    size_t global_size, local_size;
+    const double params[] = {uv_filter_min, uv_filter_max, inv_wavelength,
+            frac_bandwidth, time_avg, gha0, dec0};
+    const oskar_Mem* stations[5];
+    const oskar_Mem* sources[10];
+    int num_source_arrays;
+
+    /* Get the appropriate kernel. */
+    is_dbl = oskar_mem_precision(vis) == OSKAR_DOUBLE;
+    clGetDeviceInfo(oskar_cl_device_id(),
+            CL_DEVICE_TYPE, sizeof(cl_device_type), &dev_type, NULL);
+    is_gpu = dev_type & CL_DEVICE_TYPE_GPU;
+    if (matrix_type)
+    {
+        k = is_gpu ? (is_dbl ?
+                oskar_cl_kernel("xcorr_double") :
+                oskar_cl_kernel("xcorr_float")) : (is_dbl ?
+                        oskar_cl_kernel("xcorr_cpu_double") :
+                        oskar_cl_kernel("xcorr_cpu_float"));
+    }
+    else
+    {
+        k = is_gpu ? (is_dbl ?
+                oskar_cl_kernel("xcorr_scalar_double") :
+                oskar_cl_kernel("xcorr_scalar_float")) : (is_dbl ?
+                        oskar_cl_kernel("xcorr_scalar_cpu_double") :
+                        oskar_cl_kernel("xcorr_scalar_cpu_float"));
+    }
+    if (!k)
+    {
+        *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+        return;
+    }
+
+    /* Collect the source and station arrays, in kernel argument order. */
+    num_source_arrays = 0;
+    sources[num_source_arrays++] = oskar_sky_I_const(sky);
+    if (matrix_type)
+    {
+        sources[num_source_arrays++] = oskar_sky_Q_const(sky);
+        sources[num_source_arrays++] = oskar_sky_U_const(sky);
+        sources[num_source_arrays++] = oskar_sky_V_const(sky);
+    }
+    sources[num_source_arrays++] = oskar_sky_l_const(sky);
+    sources[num_source_arrays++] = oskar_sky_m_const(sky);
+    sources[num_source_arrays++] = oskar_sky_n_const(sky);
+    sources[num_source_arrays++] = oskar_sky_gaussian_a_const(sky);
+    sources[num_source_arrays++] = oskar_sky_gaussian_b_const(sky);
+    sources[num_source_arrays++] = oskar_sky_gaussian_c_const(sky);
+    stations[0] = u;
+    stations[1] = v;
+    stations[2] = w;
+    stations[3] = oskar_telescope_station_true_x_offset_ecef_metres_const(tel);
+    stations[4] = oskar_telescope_station_true_y_offset_ecef_metres_const(tel);
+
+    /* Set kernel arguments. */
+    n_src = (cl_int) n_sources;
+    n_stations = (cl_int) oskar_telescope_num_stations(tel);
+    extended = (cl_int) use_extended;
+    error = clSetKernelArg(k, arg++, sizeof(cl_int), &n_src);
+    error |= clSetKernelArg(k, arg++, sizeof(cl_int), &n_stations);
+    error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+            oskar_mem_cl_buffer_const(oskar_jones_mem_const(J), status));
+    for (i = 0; i < num_source_arrays; ++i)
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(sources[i], status));
+    error |= clSetKernelArg(k, arg++, sizeof(cl_int), &extended);
+    for (i = 0; i < 5; ++i)
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(stations[i], status));
+    for (i = 0; i < (int)(sizeof(params) / sizeof(double)); ++i)
+    {
+        if (is_dbl)
+        {
+            const cl_double t = (cl_double) params[i];
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &t);
+        }
+        else
+        {
+            const cl_float t = (cl_float) params[i];
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &t);
+        }
+    }
+    error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+            oskar_mem_cl_buffer(vis, status));
+    num_baselines = (int) (n_stations * (n_stations - 1) / 2);
+    local_size = is_gpu ? 256 : 128;
+    if (is_gpu)
+    {
+        /* One work-group per baseline, reducing over sources. */
+        global_size = num_baselines * local_size;
+        error |= clSetKernelArg(k, arg++, local_size *
+                oskar_mem_element_size(oskar_mem_type(vis)), 0);
+    }
+    else
+    {
+        /* One work-item per baseline. */
+        global_size = ((num_baselines + local_size - 1) /
+                local_size) * local_size;
+    }
+    if (!*status && error != CL_SUCCESS)
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+    if (*status || num_baselines == 0) return;
+
+    /* Launch kernel on current command queue. */
+    error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1, NULL,
+            &global_size, &local_size, 0, NULL, &event);
+    if (error != CL_SUCCESS)
+        *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
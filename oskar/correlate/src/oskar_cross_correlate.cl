@@ -0,0 +1,316 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+inline REAL xcorr_sinc_REAL(const REAL a)
+{
+    return (a == (REAL) 0.) ? (REAL) 1. : sin(a) / a;
+}
+
+// Returns the indices of the stations (p, q) for baseline index b.
+inline void xcorr_stations_REAL(const int num_stations, int b,
+        int* p, int* q)
+{
+    int s = 0;
+    while (b >= num_stations - 1 - s) {
+        b -= num_stations - 1 - s;
+        ++s;
+    }
+    *q = s;
+    *p = s + 1 + b;
+}
+
+// Evaluates the per-baseline terms for stations p and q.
+// Returns 0 if the baseline is excluded by the uv-distance filter.
+inline int xcorr_baseline_terms_REAL(const int p, const int q,
+        global const REAL* restrict u, global const REAL* restrict v,
+        global const REAL* restrict w, global const REAL* restrict x,
+        global const REAL* restrict y, const REAL uv_min_lambda,
+        const REAL uv_max_lambda, const REAL inv_wavelength,
+        const REAL frac_bandwidth, const REAL time_int_sec,
+        const REAL gha0_rad, const REAL dec0_rad,
+        REAL* uu, REAL* vv, REAL* ww, REAL* uu2, REAL* vv2, REAL* uuvv,
+        REAL* du, REAL* dv, REAL* dw)
+{
+    *uu = (u[p] - u[q]) * inv_wavelength;
+    *vv = (v[p] - v[q]) * inv_wavelength;
+    *ww = (w[p] - w[q]) * inv_wavelength;
+    *uu2 = *uu * *uu;
+    *vv2 = *vv * *vv;
+    *uuvv = (REAL) 2. * *uu * *vv;
+    const REAL uv_len = sqrt(*uu2 + *vv2);
+    if (uv_len < uv_min_lambda || uv_len > uv_max_lambda) return 0;
+
+    // Include the common components of the bandwidth smearing term.
+    const REAL f = ((REAL) 3.14159265358979323846) * frac_bandwidth;
+    *uu *= f;
+    *vv *= f;
+    *ww *= f;
+
+    // Compute the deltas for time-average smearing.
+    *du = *dv = *dw = (REAL) 0.;
+    if (time_int_sec > (REAL) 0.) {
+        REAL sin_ha, cos_ha, sin_dec, cos_dec;
+        sin_ha = sincos(gha0_rad, &cos_ha);
+        sin_dec = sincos(dec0_rad, &cos_dec);
+        const REAL t = ((REAL) 3.14159265358979323846) * inv_wavelength;
+        const REAL xx = (x[p] - x[q]) * t;
+        const REAL yy = (y[p] - y[q]) * t;
+        const REAL rot_angle = ((REAL) 7.272205217e-5) * time_int_sec;
+        const REAL temp = (xx * sin_ha + yy * cos_ha) * rot_angle;
+        *du = (xx * cos_ha - yy * sin_ha) * rot_angle;
+        *dv = temp * sin_dec;
+        *dw = -temp * cos_dec;
+    }
+    return 1;
+}
+
+// Evaluates the smearing and source width terms for source i.
+inline REAL xcorr_source_factor_REAL(const int i,
+        global const REAL* restrict l, global const REAL* restrict m,
+        global const REAL* restrict n, global const REAL* restrict a,
+        global const REAL* restrict b, global const REAL* restrict c,
+        const int use_extended, const REAL uu, const REAL vv,
+        const REAL ww, const REAL uu2, const REAL vv2, const REAL uuvv,
+        const REAL du, const REAL dv, const REAL dw)
+{
+    const REAL l_ = l[i], m_ = m[i], n_ = n[i] - (REAL) 1.;
+    REAL f = xcorr_sinc_REAL(uu * l_ + vv * m_ + ww * n_);
+    f *= xcorr_sinc_REAL(du * l_ + dv * m_ + dw * n_);
+    if (use_extended)
+        f *= exp(-(a[i] * uu2 + b[i] * uuvv + c[i] * vv2));
+    return f;
+}
+
+inline REAL2 xcorr_cmul_REAL(const REAL2 a, const REAL2 b)
+{
+    return (REAL2)(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+// Multiplies a by the complex conjugate of b.
+inline REAL2 xcorr_cmulc_REAL(const REAL2 a, const REAL2 b)
+{
+    return (REAL2)(a.x * b.x + a.y * b.y, a.y * b.x - a.x * b.y);
+}
+
+// Evaluates J_p * B * J_q^H for the source brightness matrix B.
+inline REAL8 xcorr_source_vis_REAL(const REAL8 jp, const REAL8 jq,
+        const REAL I, const REAL Q, const REAL U, const REAL V)
+{
+    const REAL2 bb = (REAL2)(U, V);
+    const REAL ba = I + Q, bd = I - Q;
+    REAL2 a, b, c, d, t;
+    a = jp.s01 * ba + xcorr_cmulc_REAL(jp.s23, bb);
+    c = jp.s45 * ba + xcorr_cmulc_REAL(jp.s67, bb);
+    b = jp.s23 * bd + xcorr_cmul_REAL(jp.s01, bb);
+    d = jp.s67 * bd + xcorr_cmul_REAL(jp.s45, bb);
+    REAL8 r;
+    t = xcorr_cmulc_REAL(a, jq.s01) + xcorr_cmulc_REAL(b, jq.s23);
+    r.s01 = t;
+    t = xcorr_cmulc_REAL(a, jq.s45) + xcorr_cmulc_REAL(b, jq.s67);
+    r.s23 = t;
+    t = xcorr_cmulc_REAL(c, jq.s01) + xcorr_cmulc_REAL(d, jq.s23);
+    r.s45 = t;
+    t = xcorr_cmulc_REAL(c, jq.s45) + xcorr_cmulc_REAL(d, jq.s67);
+    r.s67 = t;
+    return r;
+}
+
+kernel void xcorr_REAL(const int num_sources, const int num_stations,
+        global const REAL8* restrict jones,
+        global const REAL* restrict source_I,
+        global const REAL* restrict source_Q,
+        global const REAL* restrict source_U,
+        global const REAL* restrict source_V,
+        global const REAL* restrict source_l,
+        global const REAL* restrict source_m,
+        global const REAL* restrict source_n,
+        global const REAL* restrict source_a,
+        global const REAL* restrict source_b,
+        global const REAL* restrict source_c,
+        const int use_extended,
+        global const REAL* restrict station_u,
+        global const REAL* restrict station_v,
+        global const REAL* restrict station_w,
+        global const REAL* restrict station_x,
+        global const REAL* restrict station_y,
+        const REAL uv_min_lambda, const REAL uv_max_lambda,
+        const REAL inv_wavelength, const REAL frac_bandwidth,
+        const REAL time_int_sec, const REAL gha0_rad, const REAL dec0_rad,
+        global REAL8* restrict vis,
+        local REAL8* restrict smem)
+{
+    // One work-group per baseline.
+    const int block_dim = get_local_size(0);
+    const int thread_idx = get_local_id(0);
+    const int i_bl = get_group_id(0);
+    int p, q;
+    REAL uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+    REAL8 sum = (REAL8)(0., 0., 0., 0., 0., 0., 0., 0.);
+    xcorr_stations_REAL(num_stations, i_bl, &p, &q);
+    const int use_bl = xcorr_baseline_terms_REAL(p, q, station_u,
+            station_v, station_w, station_x, station_y, uv_min_lambda,
+            uv_max_lambda, inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, &uu, &vv, &ww, &uu2, &vv2, &uuvv,
+            &du, &dv, &dw);
+    if (use_bl) {
+        global const REAL8* restrict jp = &jones[p * num_sources];
+        global const REAL8* restrict jq = &jones[q * num_sources];
+        for (int i = thread_idx; i < num_sources; i += block_dim) {
+            const REAL f = xcorr_source_factor_REAL(i, source_l, source_m,
+                    source_n, source_a, source_b, source_c, use_extended,
+                    uu, vv, ww, uu2, vv2, uuvv, du, dv, dw);
+            sum += f * xcorr_source_vis_REAL(jp[i], jq[i], source_I[i],
+                    source_Q[i], source_U[i], source_V[i]);
+        }
+    }
+    smem[thread_idx] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = block_dim / 2; s > 0; s >>= 1) {
+        if (thread_idx < s) smem[thread_idx] += smem[thread_idx + s];
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (thread_idx == 0 && use_bl) vis[i_bl] += smem[0];
+}
+
+kernel void xcorr_cpu_REAL(const int num_sources, const int num_stations,
+        global const REAL8* restrict jones,
+        global const REAL* restrict source_I,
+        global const REAL* restrict source_Q,
+        global const REAL* restrict source_U,
+        global const REAL* restrict source_V,
+        global const REAL* restrict source_l,
+        global const REAL* restrict source_m,
+        global const REAL* restrict source_n,
+        global const REAL* restrict source_a,
+        global const REAL* restrict source_b,
+        global const REAL* restrict source_c,
+        const int use_extended,
+        global const REAL* restrict station_u,
+        global const REAL* restrict station_v,
+        global const REAL* restrict station_w,
+        global const REAL* restrict station_x,
+        global const REAL* restrict station_y,
+        const REAL uv_min_lambda, const REAL uv_max_lambda,
+        const REAL inv_wavelength, const REAL frac_bandwidth,
+        const REAL time_int_sec, const REAL gha0_rad, const REAL dec0_rad,
+        global REAL8* restrict vis)
+{
+    // One work-item per baseline.
+    const int i_bl = get_global_id(0);
+    if (i_bl >= num_stations * (num_stations - 1) / 2) return;
+    int p, q;
+    REAL uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+    REAL8 sum = (REAL8)(0., 0., 0., 0., 0., 0., 0., 0.);
+    xcorr_stations_REAL(num_stations, i_bl, &p, &q);
+    if (!xcorr_baseline_terms_REAL(p, q, station_u, station_v, station_w,
+            station_x, station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec, gha0_rad,
+            dec0_rad, &uu, &vv, &ww, &uu2, &vv2, &uuvv, &du, &dv, &dw))
+        return;
+    global const REAL8* restrict jp = &jones[p * num_sources];
+    global const REAL8* restrict jq = &jones[q * num_sources];
+    for (int i = 0; i < num_sources; ++i) {
+        const REAL f = xcorr_source_factor_REAL(i, source_l, source_m,
+                source_n, source_a, source_b, source_c, use_extended,
+                uu, vv, ww, uu2, vv2, uuvv, du, dv, dw);
+        sum += f * xcorr_source_vis_REAL(jp[i], jq[i], source_I[i],
+                source_Q[i], source_U[i], source_V[i]);
+    }
+    vis[i_bl] += sum;
+}
+
+kernel void xcorr_scalar_REAL(const int num_sources, const int num_stations,
+        global const REAL2* restrict jones,
+        global const REAL* restrict source_I,
+        global const REAL* restrict source_l,
+        global const REAL* restrict source_m,
+        global const REAL* restrict source_n,
+        global const REAL* restrict source_a,
+        global const REAL* restrict source_b,
+        global const REAL* restrict source_c,
+        const int use_extended,
+        global const REAL* restrict station_u,
+        global const REAL* restrict station_v,
+        global const REAL* restrict station_w,
+        global const REAL* restrict station_x,
+        global const REAL* restrict station_y,
+        const REAL uv_min_lambda, const REAL uv_max_lambda,
+        const REAL inv_wavelength, const REAL frac_bandwidth,
+        const REAL time_int_sec, const REAL gha0_rad, const REAL dec0_rad,
+        global REAL2* restrict vis,
+        local REAL2* restrict smem)
+{
+    // One work-group per baseline.
+    const int block_dim = get_local_size(0);
+    const int thread_idx = get_local_id(0);
+    const int i_bl = get_group_id(0);
+    int p, q;
+    REAL uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+    REAL2 sum = (REAL2)(0., 0.);
+    xcorr_stations_REAL(num_stations, i_bl, &p, &q);
+    const int use_bl = xcorr_baseline_terms_REAL(p, q, station_u,
+            station_v, station_w, station_x, station_y, uv_min_lambda,
+            uv_max_lambda, inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, &uu, &vv, &ww, &uu2, &vv2, &uuvv,
+            &du, &dv, &dw);
+    if (use_bl) {
+        global const REAL2* restrict jp = &jones[p * num_sources];
+        global const REAL2* restrict jq = &jones[q * num_sources];
+        for (int i = thread_idx; i < num_sources; i += block_dim) {
+            const REAL f = xcorr_source_factor_REAL(i, source_l, source_m,
+                    source_n, source_a, source_b, source_c, use_extended,
+                    uu, vv, ww, uu2, vv2, uuvv, du, dv, dw);
+            sum += (f * source_I[i]) * xcorr_cmulc_REAL(jp[i], jq[i]);
+        }
+    }
+    smem[thread_idx] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = block_dim / 2; s > 0; s >>= 1) {
+        if (thread_idx < s) smem[thread_idx] += smem[thread_idx + s];
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (thread_idx == 0 && use_bl) vis[i_bl] += smem[0];
+}
+
+kernel void xcorr_scalar_cpu_REAL(const int num_sources,
+        const int num_stations,
+        global const REAL2* restrict jones,
+        global const REAL* restrict source_I,
+        global const REAL* restrict source_l,
+        global const REAL* restrict source_m,
+        global const REAL* restrict source_n,
+        global const REAL* restrict source_a,
+        global const REAL* restrict source_b,
+        global const REAL* restrict source_c,
+        const int use_extended,
+        global const REAL* restrict station_u,
+        global const REAL* restrict station_v,
+        global const REAL* restrict station_w,
+        global const REAL* restrict station_x,
+        global const REAL* restrict station_y,
+        const REAL uv_min_lambda, const REAL uv_max_lambda,
+        const REAL inv_wavelength, const REAL frac_bandwidth,
+        const REAL time_int_sec, const REAL gha0_rad, const REAL dec0_rad,
+        global REAL2* restrict vis)
+{
+    // One work-item per baseline.
+    const int i_bl = get_global_id(0);
+    if (i_bl >= num_stations * (num_stations - 1) / 2) return;
+    int p, q;
+    REAL uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+    REAL2 sum = (REAL2)(0., 0.);
+    xcorr_stations_REAL(num_stations, i_bl, &p, &q);
+    if (!xcorr_baseline_terms_REAL(p, q, station_u, station_v, station_w,
+            station_x, station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec, gha0_rad,
+            dec0_rad, &uu, &vv, &ww, &uu2, &vv2, &uuvv, &du, &dv, &dw))
+        return;
+    global const REAL2* restrict jp = &jones[p * num_sources];
+    global const REAL2* restrict jq = &jones[q * num_sources];
+    for (int i = 0; i < num_sources; ++i) {
+        const REAL f = xcorr_source_factor_REAL(i, source_l, source_m,
+                source_n, source_a, source_b, source_c, use_extended,
+                uu, vv, ww, uu2, vv2, uuvv, du, dv, dw);
+        sum += (f * source_I[i]) * xcorr_cmulc_REAL(jp[i], jq[i]);
+    }
+    vis[i_bl] += sum;
+}
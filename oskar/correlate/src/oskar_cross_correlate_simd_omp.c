@@ -0,0 +1,1706 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "correlate/private_correlate_functions_inline.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Number of sources processed in each block.
+ * Small enough for the block of smearing terms to stay in L1 cache. */
+#define BLOCK_SIZE 256
+
+/* Target size of the pair of station tiles used by the tiled correlator.
+ * Should fit comfortably in L2 cache. */
+#define TILE_BYTES (256 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Single precision. */
+void oskar_cross_correlate_jones_to_soa_f(int num_sources, int num_stations,
+        const float4c* jones, float* jones_soa)
+{
+    int s;
+#pragma omp parallel for private(s)
+    for (s = 0; s < num_stations; ++s)
+    {
+        int i;
+        const float4c* restrict in = &jones[s * num_sources];
+        float* restrict out = &jones_soa[8 * s * num_sources];
+        for (i = 0; i < num_sources; ++i)
+        {
+            out[i]                   = in[i].a.x;
+            out[i + num_sources]     = in[i].a.y;
+            out[i + 2 * num_sources] = in[i].b.x;
+            out[i + 3 * num_sources] = in[i].b.y;
+            out[i + 4 * num_sources] = in[i].c.x;
+            out[i + 5 * num_sources] = in[i].c.y;
+            out[i + 6 * num_sources] = in[i].d.x;
+            out[i + 7 * num_sources] = in[i].d.y;
+        }
+    }
+}
+
+static void evaluate_smearing_f(const int n,
+        const float* restrict l, const float* restrict m,
+        const float* restrict nn, const float* restrict a,
+        const float* restrict b, const float* restrict c,
+        const float uu, const float vv, const float ww,
+        const float uu2, const float vv2, const float uuvv,
+        const float du, const float dv, const float dw,
+        const int time_smearing, float* restrict smear)
+{
+    int i;
+
+    /* Bandwidth smearing. */
+    for (i = 0; i < n; ++i)
+        smear[i] = oskar_sinc_f(uu * l[i] + vv * m[i] + ww * (nn[i] - 1.0f));
+
+    /* Time-average smearing. */
+    if (time_smearing)
+    {
+        for (i = 0; i < n; ++i)
+            smear[i] *= oskar_evaluate_time_smearing_f(du, dv, dw,
+                    l[i], m[i], nn[i]);
+    }
+
+    /* Gaussian source width. */
+    if (a)
+    {
+        for (i = 0; i < n; ++i)
+            smear[i] *= expf(-(a[i] * uu2 + b[i] * uuvv + c[i] * vv2));
+    }
+}
+
+OSKAR_SIMD_CLONES
+static void accumulate_block_f(const int n, const float* restrict smear,
+        const float* restrict I, const float* restrict Q,
+        const float* restrict U, const float* restrict V,
+        const float* restrict jp, const float* restrict jq,
+        const int stride, float* restrict sum)
+{
+    int i;
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    float s4 = 0.0f, s5 = 0.0f, s6 = 0.0f, s7 = 0.0f;
+    const float *pax = jp, *pay = jp + stride;
+    const float *pbx = jp + 2 * stride, *pby = jp + 3 * stride;
+    const float *pcx = jp + 4 * stride, *pcy = jp + 5 * stride;
+    const float *pdx = jp + 6 * stride, *pdy = jp + 7 * stride;
+    const float *qax = jq, *qay = jq + stride;
+    const float *qbx = jq + 2 * stride, *qby = jq + 3 * stride;
+    const float *qcx = jq + 4 * stride, *qcy = jq + 5 * stride;
+    const float *qdx = jq + 6 * stride, *qdy = jq + 7 * stride;
+
+#pragma omp simd reduction(+:s0,s1,s2,s3,s4,s5,s6,s7)
+    for (i = 0; i < n; ++i)
+    {
+        float A, D, bx, by, f;
+        float tax, tay, tbx, tby, tcx, tcy, tdx, tdy;
+
+        /* Source brightness matrix. */
+        A = I[i] + Q[i];
+        D = I[i] - Q[i];
+        bx = U[i];
+        by = V[i];
+
+        /* T = J_p * B. */
+        tax = pax[i] * A + pbx[i] * bx + pby[i] * by;
+        tay = pay[i] * A + pby[i] * bx - pbx[i] * by;
+        tbx = pax[i] * bx - pay[i] * by + pbx[i] * D;
+        tby = pax[i] * by + pay[i] * bx + pby[i] * D;
+        tcx = pcx[i] * A + pdx[i] * bx + pdy[i] * by;
+        tcy = pcy[i] * A + pdy[i] * bx - pdx[i] * by;
+        tdx = pcx[i] * bx - pcy[i] * by + pdx[i] * D;
+        tdy = pcx[i] * by + pcy[i] * bx + pdy[i] * D;
+
+        /* V_pq += T * J_q^H * smear. */
+        f = smear[i];
+        s0 += f * (tax * qax[i] + tay * qay[i] + tbx * qbx[i] + tby * qby[i]);
+        s1 += f * (tay * qax[i] - tax * qay[i] + tby * qbx[i] - tbx * qby[i]);
+        s2 += f * (tax * qcx[i] + tay * qcy[i] + tbx * qdx[i] + tby * qdy[i]);
+        s3 += f * (tay * qcx[i] - tax * qcy[i] + tby * qdx[i] - tbx * qdy[i]);
+        s4 += f * (tcx * qax[i] + tcy * qay[i] + tdx * qbx[i] + tdy * qby[i]);
+        s5 += f * (tcy * qax[i] - tcx * qay[i] + tdy * qbx[i] - tdx * qby[i]);
+        s6 += f * (tcx * qcx[i] + tcy * qcy[i] + tdx * qdx[i] + tdy * qdy[i]);
+        s7 += f * (tcy * qcx[i] - tcx * qcy[i] + tdy * qdx[i] - tdx * qdy[i]);
+    }
+    sum[0] = s0; sum[1] = s1; sum[2] = s2; sum[3] = s3;
+    sum[4] = s4; sum[5] = s5; sum[6] = s6; sum[7] = s7;
+}
+
+void oskar_cross_correlate_simd_omp_f(int num_sources, int num_stations,
+        const float* jones_soa, const float* source_I,
+        const float* source_Q, const float* source_U,
+        const float* source_V, const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        float uv_min_lambda, float uv_max_lambda, float inv_wavelength,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, float4c* vis)
+{
+    int SQ;
+    const int time_smearing = (time_int_sec > 0.0f);
+
+    /* Loop over stations. */
+#pragma omp parallel for private(SQ) schedule(dynamic, 1)
+    for (SQ = 0; SQ < num_stations; ++SQ)
+    {
+        int SP, i, k, start, block_size;
+        const float *station_p, *station_q;
+        float smear[BLOCK_SIZE], block_sum[8];
+
+        /* Pointer to source vector for station q. */
+        station_q = &jones_soa[8 * SQ * num_sources];
+
+        /* Loop over baselines for this station. */
+        for (SP = SQ + 1; SP < num_stations; ++SP)
+        {
+            float uv_len, uu, vv, ww, uu2, vv2, uuvv;
+            float du = 0.0f, dv = 0.0f, dw = 0.0f, sum[8], guard[8];
+
+            /* Pointer to source vector for station p. */
+            station_p = &jones_soa[8 * SP * num_sources];
+
+            /* Get common baseline values. */
+            oskar_evaluate_baseline_terms_inline_f(station_u[SP],
+                    station_u[SQ], station_v[SP], station_v[SQ],
+                    station_w[SP], station_w[SQ], inv_wavelength,
+                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
+
+            /* Apply the baseline length filter. */
+            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                continue;
+
+            /* Compute the deltas for time-average smearing. */
+            if (time_smearing)
+                oskar_evaluate_baseline_deltas_inline_f(station_x[SP],
+                        station_x[SQ], station_y[SP], station_y[SQ],
+                        inv_wavelength, time_int_sec, gha0_rad, dec0_rad,
+                        &du, &dv, &dw);
+
+            /* Loop over blocks of sources. */
+            for (k = 0; k < 8; ++k) sum[k] = guard[k] = 0.0f;
+            for (start = 0; start < num_sources; start += BLOCK_SIZE)
+            {
+                block_size = num_sources - start;
+                if (block_size > BLOCK_SIZE) block_size = BLOCK_SIZE;
+
+                /* Evaluate smearing terms for the block. */
+                evaluate_smearing_f(block_size, &source_l[start],
+                        &source_m[start], &source_n[start],
+                        source_a ? &source_a[start] : 0,
+                        source_a ? &source_b[start] : 0,
+                        source_a ? &source_c[start] : 0,
+                        uu, vv, ww, uu2, vv2, uuvv, du, dv, dw,
+                        time_smearing, smear);
+
+                /* Accumulate visibilities for the block. */
+                accumulate_block_f(block_size, smear, &source_I[start],
+                        &source_Q[start], &source_U[start], &source_V[start],
+                        &station_p[start], &station_q[start], num_sources,
+                        block_sum);
+
+                /* Use Kahan summation to combine the block totals. */
+                for (k = 0; k < 8; ++k)
+                    oskar_kahan_sum_f(&sum[k], block_sum[k], &guard[k]);
+            }
+
+            /* Add result to the baseline visibility. */
+            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
+            vis[i].a.x += sum[0];
+            vis[i].a.y += sum[1];
+            vis[i].b.x += sum[2];
+            vis[i].b.y += sum[3];
+            vis[i].c.x += sum[4];
+            vis[i].c.y += sum[5];
+            vis[i].d.x += sum[6];
+            vis[i].d.y += sum[7];
+        }
+    }
+}
+
+static void copy_tile_f(const int block_size, const int num_sources,
+        const int station_start, const int num_stations,
+        const int* restrict station_map, const float4c* restrict jones,
+        float* restrict tile)
+{
+    int s, i, row;
+    for (s = 0; s < num_stations; ++s)
+    {
+        const float4c* restrict in;
+        float* restrict out = &tile[8 * s * BLOCK_SIZE];
+        row = station_start + s;
+        if (station_map) row = station_map[row];
+        in = &jones[row * num_sources];
+        for (i = 0; i < block_size; ++i)
+        {
+            out[i]                  = in[i].a.x;
+            out[i + BLOCK_SIZE]     = in[i].a.y;
+            out[i + 2 * BLOCK_SIZE] = in[i].b.x;
+            out[i + 3 * BLOCK_SIZE] = in[i].b.y;
+            out[i + 4 * BLOCK_SIZE] = in[i].c.x;
+            out[i + 5 * BLOCK_SIZE] = in[i].c.y;
+            out[i + 6 * BLOCK_SIZE] = in[i].d.x;
+            out[i + 7 * BLOCK_SIZE] = in[i].d.y;
+        }
+    }
+}
+
+static void evaluate_phase_f(const int n,
+        const float* restrict l, const float* restrict m,
+        const float* restrict nn, const float* restrict I,
+        const float filter_min, const float filter_max,
+        const float pu, const float pv, const float pw,
+        float* restrict smear, float* restrict smear_im)
+{
+    int i;
+    for (i = 0; i < n; ++i)
+    {
+        float phase, f;
+
+        /* Sources outside the filter range have no K term. */
+        f = (I[i] > filter_min && I[i] <= filter_max) ? smear[i] : 0.0f;
+
+        /* K_p * conj(K_q) for this source. */
+        phase = pu * l[i] + pv * m[i] + pw * (nn[i] - 1.0f);
+        smear[i] = f * cosf(phase);
+        smear_im[i] = f * sinf(phase);
+    }
+}
+
+OSKAR_SIMD_CLONES
+static void accumulate_block_phase_f(const int n,
+        const float* restrict smear, const float* restrict smear_im,
+        const float* restrict I, const float* restrict Q,
+        const float* restrict U, const float* restrict V,
+        const float* restrict jp, const float* restrict jq,
+        const int stride, float* restrict sum)
+{
+    int i;
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    float s4 = 0.0f, s5 = 0.0f, s6 = 0.0f, s7 = 0.0f;
+    const float *pax = jp, *pay = jp + stride;
+    const float *pbx = jp + 2 * stride, *pby = jp + 3 * stride;
+    const float *pcx = jp + 4 * stride, *pcy = jp + 5 * stride;
+    const float *pdx = jp + 6 * stride, *pdy = jp + 7 * stride;
+    const float *qax = jq, *qay = jq + stride;
+    const float *qbx = jq + 2 * stride, *qby = jq + 3 * stride;
+    const float *qcx = jq + 4 * stride, *qcy = jq + 5 * stride;
+    const float *qdx = jq + 6 * stride, *qdy = jq + 7 * stride;
+
+#pragma omp simd reduction(+:s0,s1,s2,s3,s4,s5,s6,s7)
+    for (i = 0; i < n; ++i)
+    {
+        float A, D, bx, by, fx, fy, mx, my;
+        float tax, tay, tbx, tby, tcx, tcy, tdx, tdy;
+
+        /* Source brightness matrix. */
+        A = I[i] + Q[i];
+        D = I[i] - Q[i];
+        bx = U[i];
+        by = V[i];
+
+        /* T = E_p * B. */
+        tax = pax[i] * A + pbx[i] * bx + pby[i] * by;
+        tay = pay[i] * A + pby[i] * bx - pbx[i] * by;
+        tbx = pax[i] * bx - pay[i] * by + pbx[i] * D;
+        tby = pax[i] * by + pay[i] * bx + pby[i] * D;
+        tcx = pcx[i] * A + pdx[i] * bx + pdy[i] * by;
+        tcy = pcy[i] * A + pdy[i] * bx - pdx[i] * by;
+        tdx = pcx[i] * bx - pcy[i] * by + pdx[i] * D;
+        tdy = pcx[i] * by + pcy[i] * bx + pdy[i] * D;
+
+        /* V_pq += T * E_q^H * (complex weight). */
+        fx = smear[i];
+        fy = smear_im[i];
+        mx = tax * qax[i] + tay * qay[i] + tbx * qbx[i] + tby * qby[i];
+        my = tay * qax[i] - tax * qay[i] + tby * qbx[i] - tbx * qby[i];
+        s0 += fx * mx - fy * my;
+        s1 += fx * my + fy * mx;
+        mx = tax * qcx[i] + tay * qcy[i] + tbx * qdx[i] + tby * qdy[i];
+        my = tay * qcx[i] - tax * qcy[i] + tby * qdx[i] - tbx * qdy[i];
+        s2 += fx * mx - fy * my;
+        s3 += fx * my + fy * mx;
+        mx = tcx * qax[i] + tcy * qay[i] + tdx * qbx[i] + tdy * qby[i];
+        my = tcy * qax[i] - tcx * qay[i] + tdy * qbx[i] - tdx * qby[i];
+        s4 += fx * mx - fy * my;
+        s5 += fx * my + fy * mx;
+        mx = tcx * qcx[i] + tcy * qcy[i] + tdx * qdx[i] + tdy * qdy[i];
+        my = tcy * qcx[i] - tcx * qcy[i] + tdy * qdx[i] - tdx * qdy[i];
+        s6 += fx * mx - fy * my;
+        s7 += fx * my + fy * mx;
+    }
+    sum[0] = s0; sum[1] = s1; sum[2] = s2; sum[3] = s3;
+    sum[4] = s4; sum[5] = s5; sum[6] = s6; sum[7] = s7;
+}
+
+static void correlate_tiled_f(int num_sources,
+        int num_stations, const float4c* jones, const int* station_map,
+        const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V,
+        const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        float uv_min_lambda, float uv_max_lambda, float inv_wavelength,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, int apply_phase, float source_min,
+        float source_max, float4c* vis, int* status)
+{
+    int num_tiles, num_pairs, tile_pair, num_threads = 1;
+    size_t work_size;
+    float* work;
+    const int tile_size = TILE_BYTES / (16 * BLOCK_SIZE * sizeof(float));
+    const int time_smearing = (time_int_sec > 0.0f);
+    num_tiles = (num_stations + tile_size - 1) / tile_size;
+    num_pairs = num_tiles * (num_tiles + 1) / 2;
+    if (*status || num_pairs == 0) return;
+
+    /* Allocate workspace for each thread: the Jones matrices for both
+     * tiles, and the sums and Kahan guards for each baseline in them. */
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    if (num_threads > num_pairs) num_threads = num_pairs;
+#endif
+    work_size = 16 * tile_size * (BLOCK_SIZE + tile_size);
+    work = (float*) malloc(num_threads * work_size * sizeof(float));
+    if (!work)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+
+    /* Loop over pairs of station tiles. */
+#pragma omp parallel num_threads(num_threads)
+    {
+        int thread = 0;
+        float *buf_p, *buf_q, *sum, *guard, block_sum[8];
+        float smear[BLOCK_SIZE], smear_im[BLOCK_SIZE];
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        buf_p = work + thread * work_size;
+        buf_q = buf_p + 8 * tile_size * BLOCK_SIZE;
+        sum = buf_p + 16 * tile_size * BLOCK_SIZE;
+        guard = sum + 8 * tile_size * tile_size;
+#pragma omp for private(tile_pair) schedule(dynamic, 1)
+        for (tile_pair = 0; tile_pair < num_pairs; ++tile_pair)
+        {
+            int tile_q = 0, tile_p = tile_pair, p0, p1, q0, q1, SP, SQ;
+            int i, k, start, block_size;
+            const float* jones_q;
+            float uv_len, uu, vv, ww, uu2, vv2, uuvv;
+            float du = 0.0f, dv = 0.0f, dw = 0.0f;
+            float pu, pv, pw;
+
+            /* Get the station ranges for this pair of tiles. */
+            while (tile_p >= num_tiles - tile_q)
+            {
+                tile_p -= (num_tiles - tile_q);
+                tile_q++;
+            }
+            tile_p += tile_q;
+            q0 = tile_q * tile_size;
+            p0 = tile_p * tile_size;
+            q1 = q0 + tile_size < num_stations ? q0 + tile_size : num_stations;
+            p1 = p0 + tile_size < num_stations ? p0 + tile_size : num_stations;
+            jones_q = (p0 == q0) ? buf_p : buf_q;
+            for (i = 0; i < 16 * tile_size * tile_size; ++i) sum[i] = 0.0f;
+
+            /* Loop over blocks of sources. */
+            for (start = 0; start < num_sources; start += BLOCK_SIZE)
+            {
+                block_size = num_sources - start;
+                if (block_size > BLOCK_SIZE) block_size = BLOCK_SIZE;
+
+                /* Copy the Jones matrices for both tiles into SoA layout. */
+                copy_tile_f(block_size, num_sources, p0, p1 - p0,
+                        station_map, &jones[start], buf_p);
+                if (p0 != q0)
+                    copy_tile_f(block_size, num_sources, q0, q1 - q0,
+                            station_map, &jones[start], buf_q);
+
+                /* Loop over baselines in the pair of tiles. */
+                for (SQ = q0; SQ < q1; ++SQ)
+                {
+                    for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                    {
+                        /* Get common baseline values. */
+                        oskar_evaluate_baseline_terms_inline_f(station_u[SP],
+                                station_u[SQ], station_v[SP], station_v[SQ],
+                                station_w[SP], station_w[SQ], inv_wavelength,
+                                frac_bandwidth, &uv_len, &uu, &vv, &ww,
+                                &uu2, &vv2, &uuvv);
+
+                        /* Apply the baseline length filter. */
+                        if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                            continue;
+
+                        /* Compute the deltas for time-average smearing. */
+                        if (time_smearing)
+                            oskar_evaluate_baseline_deltas_inline_f(
+                                    station_x[SP], station_x[SQ],
+                                    station_y[SP], station_y[SQ],
+                                    inv_wavelength, time_int_sec,
+                                    gha0_rad, dec0_rad, &du, &dv, &dw);
+
+                        /* Evaluate smearing terms for the block. */
+                        evaluate_smearing_f(block_size, &source_l[start],
+                                &source_m[start], &source_n[start],
+                                source_a ? &source_a[start] : 0,
+                                source_a ? &source_b[start] : 0,
+                                source_a ? &source_c[start] : 0,
+                                uu, vv, ww, uu2, vv2, uuvv, du, dv, dw,
+                                time_smearing, smear);
+
+                        /* Accumulate visibilities for the block,
+                         * applying the interferometer phase if required. */
+                        if (apply_phase)
+                        {
+                            pu = 6.28318530717958647692f * inv_wavelength *
+                                    (station_u[SP] - station_u[SQ]);
+                            pv = 6.28318530717958647692f * inv_wavelength *
+                                    (station_v[SP] - station_v[SQ]);
+                            pw = 6.28318530717958647692f * inv_wavelength *
+                                    (station_w[SP] - station_w[SQ]);
+                            evaluate_phase_f(block_size, &source_l[start],
+                                    &source_m[start], &source_n[start],
+                                    &source_I[start], source_min, source_max,
+                                    pu, pv, pw, smear, smear_im);
+                            accumulate_block_phase_f(block_size, smear,
+                                    smear_im, &source_I[start],
+                                    &source_Q[start], &source_U[start],
+                                    &source_V[start],
+                                    &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                    &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                    BLOCK_SIZE, block_sum);
+                        }
+                        else
+                            accumulate_block_f(block_size, smear,
+                                    &source_I[start], &source_Q[start],
+                                    &source_U[start], &source_V[start],
+                                    &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                    &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                    BLOCK_SIZE, block_sum);
+                        i = 8 * ((SQ - q0) * tile_size + (SP - p0));
+                        for (k = 0; k < 8; ++k)
+                            oskar_kahan_sum_f(&sum[i + k], block_sum[k],
+                                    &guard[i + k]);
+                    }
+                }
+            }
+
+            /* Add results to the baseline visibilities.
+             * Sums for filtered baselines are zero. */
+            for (SQ = q0; SQ < q1; ++SQ)
+            {
+                for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                {
+                    i = 8 * ((SQ - q0) * tile_size + (SP - p0));
+                    k = oskar_evaluate_baseline_index_inline(num_stations,
+                            SP, SQ);
+                    vis[k].a.x += sum[i + 0];
+                    vis[k].a.y += sum[i + 1];
+                    vis[k].b.x += sum[i + 2];
+                    vis[k].b.y += sum[i + 3];
+                    vis[k].c.x += sum[i + 4];
+                    vis[k].c.y += sum[i + 5];
+                    vis[k].d.x += sum[i + 6];
+                    vis[k].d.y += sum[i + 7];
+                }
+            }
+        }
+    }
+    free(work);
+}
+
+void oskar_cross_correlate_simd_tiled_omp_f(int num_sources,
+        int num_stations, const float4c* jones, const int* station_map,
+        const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V,
+        const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        float uv_min_lambda, float uv_max_lambda, float inv_wavelength,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, float4c* vis, int* status)
+{
+    correlate_tiled_f(num_sources, num_stations, jones, station_map,
+            source_I, source_Q, source_U, source_V, source_l, source_m,
+            source_n, source_a, source_b, source_c, station_u, station_v,
+            station_w, station_x, station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,
+            0, 0, 0, vis, status);
+}
+
+void oskar_cross_correlate_simd_tiled_phase_omp_f(int num_sources,
+        int num_stations, const float4c* jones, const int* station_map,
+        const float* source_I, const float* source_Q,
+        const float* source_U, const float* source_V,
+        const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        float uv_min_lambda, float uv_max_lambda, float inv_wavelength,
+        float frac_bandwidth, float time_int_sec, float gha0_rad,
+        float dec0_rad, float source_min_jy, float source_max_jy, float4c* vis,
+        int* status)
+{
+    correlate_tiled_f(num_sources, num_stations, jones, station_map,
+            source_I, source_Q, source_U, source_V, source_l, source_m,
+            source_n, source_a, source_b, source_c, station_u, station_v,
+            station_w, station_x, station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,
+            1, source_min_jy, source_max_jy, vis, status);
+}
+
+static void evaluate_channel_terms_f(const int n,
+        const float* restrict l, const float* restrict m,
+        const float* restrict nn, const float* restrict a,
+        const float* restrict b, const float* restrict c,
+        const float bu, const float bv, const float bw, const float kb,
+        const float du, const float dv, const float dw,
+        const int time_smearing, float* restrict path,
+        float* restrict smear, float* restrict t, float* restrict e)
+{
+    int i;
+
+    /* Path difference, in metres, and bandwidth smearing.
+     * The bandwidth-smearing term depends only on the channel bandwidth,
+     * so it is the same for all channels. */
+    for (i = 0; i < n; ++i)
+    {
+        path[i] = bu * l[i] + bv * m[i] + bw * (nn[i] - 1.0f);
+        smear[i] = oskar_sinc_f(kb * path[i]);
+    }
+
+    /* Time-average smearing, for unit inverse wavelength. */
+    if (time_smearing)
+    {
+        for (i = 0; i < n; ++i)
+            t[i] = du * l[i] + dv * m[i] + dw * (nn[i] - 1.0f);
+    }
+
+    /* Gaussian source width, for unit inverse wavelength. */
+    if (a)
+    {
+        const float bu2 = bu * bu, bv2 = bv * bv, buv = 2.0f * bu * bv;
+        for (i = 0; i < n; ++i)
+            e[i] = a[i] * bu2 + b[i] * buv + c[i] * bv2;
+    }
+}
+
+static void evaluate_channel_weights_f(const int n,
+        const float* restrict path, const float* restrict smear,
+        const float* restrict t, const float* restrict e,
+        const float* restrict I, const float inv_wavelength,
+        const int time_smearing, const int gaussian, const int apply_phase,
+        const float filter_min, const float filter_max,
+        float* restrict re, float* restrict im)
+{
+    int i;
+    for (i = 0; i < n; ++i) re[i] = smear[i];
+    if (time_smearing)
+    {
+        for (i = 0; i < n; ++i)
+            re[i] *= oskar_sinc_f(inv_wavelength * t[i]);
+    }
+    if (gaussian)
+    {
+        const float s = inv_wavelength * inv_wavelength;
+        for (i = 0; i < n; ++i)
+            re[i] *= expf(-s * e[i]);
+    }
+    if (apply_phase)
+    {
+        const float k = 6.28318530717958647692f * inv_wavelength;
+        for (i = 0; i < n; ++i)
+        {
+            float f;
+
+            /* Sources outside the filter range have no K term. */
+            f = (I[i] > filter_min && I[i] <= filter_max) ? re[i] : 0.0f;
+
+            /* K_p * conj(K_q) for this source. */
+            re[i] = f * cosf(k * path[i]);
+            im[i] = f * sinf(k * path[i]);
+        }
+    }
+}
+
+void oskar_cross_correlate_simd_tiled_channels_omp_f(int num_channels,
+        int num_sources, int num_stations, const float4c* const* jones,
+        const int* const* station_map, const float* const* source_I,
+        const float* const* source_Q, const float* const* source_U,
+        const float* const* source_V, const float* source_l,
+        const float* source_m, const float* source_n,
+        const float* source_a, const float* source_b,
+        const float* source_c, const float* station_u,
+        const float* station_v, const float* station_w,
+        const float* station_x, const float* station_y,
+        const float* uv_min_lambda, const float* uv_max_lambda,
+        const float* inv_wavelength, float bandwidth_hz,
+        float time_int_sec, float gha0_rad, float dec0_rad,
+        int apply_phase, float source_min_jy, float source_max_jy,
+        float4c* vis, int* status)
+{
+    int num_tiles, num_pairs, tile_pair, num_baselines, num_threads = 1;
+    size_t terms_size, work_size;
+    float* work;
+    const int tile_size = (int) sqrt(TILE_BYTES /
+            (4.0 * BLOCK_SIZE * sizeof(float)));
+    const int time_smearing = (time_int_sec > 0.0f);
+    const float kb = (float) (3.14159265358979323846 * bandwidth_hz /
+            299792458.0);
+    num_tiles = (num_stations + tile_size - 1) / tile_size;
+    num_pairs = num_tiles * (num_tiles + 1) / 2;
+    num_baselines = num_stations * (num_stations - 1) / 2;
+    if (*status || num_pairs == 0 || num_channels <= 0) return;
+
+    /* Allocate workspace for each thread: the Jones matrices for both
+     * tiles, the frequency-independent terms for each baseline in them,
+     * and the sums and Kahan guards for each baseline and channel. */
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    if (num_threads > num_pairs) num_threads = num_pairs;
+#endif
+    terms_size = tile_size * tile_size * BLOCK_SIZE;
+    work_size = 16 * tile_size * BLOCK_SIZE + 4 * terms_size +
+            16 * tile_size * tile_size * num_channels;
+    work = (float*) malloc(num_threads * work_size * sizeof(float));
+    if (!work)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+
+    /* Loop over pairs of station tiles. */
+#pragma omp parallel num_threads(num_threads)
+    {
+        int thread = 0;
+        float *buf_p, *buf_q, *path, *smear, *t, *e, *sum, *guard;
+        float block_sum[8], re[BLOCK_SIZE], im[BLOCK_SIZE];
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        buf_p = work + thread * work_size;
+        buf_q = buf_p + 8 * tile_size * BLOCK_SIZE;
+        path = buf_q + 8 * tile_size * BLOCK_SIZE;
+        smear = path + terms_size;
+        t = smear + terms_size;
+        e = t + terms_size;
+        sum = e + terms_size;
+        guard = sum + 8 * tile_size * tile_size * num_channels;
+#pragma omp for private(tile_pair) schedule(dynamic, 1)
+        for (tile_pair = 0; tile_pair < num_pairs; ++tile_pair)
+        {
+            int tile_q = 0, tile_p = tile_pair, p0, p1, q0, q1, SP, SQ;
+            int c, i, j, k, start, block_size;
+            const float* jones_q;
+            float bu, bv, bw, du = 0.0f, dv = 0.0f, dw = 0.0f, uv_len;
+
+            /* Get the station ranges for this pair of tiles. */
+            while (tile_p >= num_tiles - tile_q)
+            {
+                tile_p -= (num_tiles - tile_q);
+                tile_q++;
+            }
+            tile_p += tile_q;
+            q0 = tile_q * tile_size;
+            p0 = tile_p * tile_size;
+            q1 = q0 + tile_size < num_stations ? q0 + tile_size : num_stations;
+            p1 = p0 + tile_size < num_stations ? p0 + tile_size : num_stations;
+            jones_q = (p0 == q0) ? buf_p : buf_q;
+            for (i = 0; i < 16 * tile_size * tile_size * num_channels; ++i)
+                sum[i] = 0.0f;
+
+            /* Loop over blocks of sources. */
+            for (start = 0; start < num_sources; start += BLOCK_SIZE)
+            {
+                block_size = num_sources - start;
+                if (block_size > BLOCK_SIZE) block_size = BLOCK_SIZE;
+
+                /* Evaluate the frequency-independent terms for the block,
+                 * once for all channels. */
+                for (SQ = q0; SQ < q1; ++SQ)
+                {
+                    for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                    {
+                        j = ((SQ - q0) * tile_size + (SP - p0)) * BLOCK_SIZE;
+                        bu = station_u[SP] - station_u[SQ];
+                        bv = station_v[SP] - station_v[SQ];
+                        bw = station_w[SP] - station_w[SQ];
+                        if (time_smearing)
+                            oskar_evaluate_baseline_deltas_inline_f(
+                                    station_x[SP], station_x[SQ],
+                                    station_y[SP], station_y[SQ],
+                                    1.0f, time_int_sec, gha0_rad, dec0_rad,
+                                    &du, &dv, &dw);
+                        evaluate_channel_terms_f(block_size, &source_l[start],
+                                &source_m[start], &source_n[start],
+                                source_a ? &source_a[start] : 0,
+                                source_a ? &source_b[start] : 0,
+                                source_a ? &source_c[start] : 0,
+                                bu, bv, bw, kb, du, dv, dw, time_smearing,
+                                &path[j], &smear[j], &t[j], &e[j]);
+                    }
+                }
+
+                /* Loop over channels. */
+                for (c = 0; c < num_channels; ++c)
+                {
+                    const int* map = station_map ? station_map[c] : 0;
+                    const float *I_ = source_I[c], *Q_ = source_Q[c];
+                    const float *U_ = source_U[c], *V_ = source_V[c];
+
+                    /* Copy the Jones matrices for both tiles into SoA
+                     * layout. */
+                    copy_tile_f(block_size, num_sources, p0, p1 - p0,
+                            map, &jones[c][start], buf_p);
+                    if (p0 != q0)
+                        copy_tile_f(block_size, num_sources, q0, q1 - q0,
+                                map, &jones[c][start], buf_q);
+
+                    /* Loop over baselines in the pair of tiles. */
+                    for (SQ = q0; SQ < q1; ++SQ)
+                    {
+                        for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                        {
+                            /* Apply the baseline length filter. */
+                            bu = station_u[SP] - station_u[SQ];
+                            bv = station_v[SP] - station_v[SQ];
+                            uv_len = sqrtf(bu * bu + bv * bv) *
+                                    inv_wavelength[c];
+                            if (uv_len < uv_min_lambda[c] ||
+                                    uv_len > uv_max_lambda[c])
+                                continue;
+
+                            /* Accumulate visibilities for the block. */
+                            j = ((SQ - q0) * tile_size + (SP - p0));
+                            evaluate_channel_weights_f(block_size,
+                                    &path[j * BLOCK_SIZE],
+                                    &smear[j * BLOCK_SIZE],
+                                    &t[j * BLOCK_SIZE], &e[j * BLOCK_SIZE],
+                                    &I_[start], inv_wavelength[c],
+                                    time_smearing, source_a != 0,
+                                    apply_phase, source_min_jy, source_max_jy,
+                                    re, im);
+                            if (apply_phase)
+                                accumulate_block_phase_f(block_size, re, im,
+                                        &I_[start], &Q_[start], &U_[start],
+                                        &V_[start],
+                                        &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                        &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                        BLOCK_SIZE, block_sum);
+                            else
+                                accumulate_block_f(block_size, re,
+                                        &I_[start], &Q_[start], &U_[start],
+                                        &V_[start],
+                                        &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                        &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                        BLOCK_SIZE, block_sum);
+                            i = 8 * (c * tile_size * tile_size + j);
+                            for (k = 0; k < 8; ++k)
+                                oskar_kahan_sum_f(&sum[i + k], block_sum[k],
+                                        &guard[i + k]);
+                        }
+                    }
+                }
+            }
+
+            /* Add results to the baseline visibilities for each channel.
+             * Sums for filtered baselines are zero. */
+            for (c = 0; c < num_channels; ++c)
+            {
+                for (SQ = q0; SQ < q1; ++SQ)
+                {
+                    for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                    {
+                        i = 8 * (c * tile_size * tile_size +
+                                (SQ - q0) * tile_size + (SP - p0));
+                        k = c * num_baselines +
+                                oskar_evaluate_baseline_index_inline(
+                                        num_stations, SP, SQ);
+                        vis[k].a.x += sum[i + 0];
+                        vis[k].a.y += sum[i + 1];
+                        vis[k].b.x += sum[i + 2];
+                        vis[k].b.y += sum[i + 3];
+                        vis[k].c.x += sum[i + 4];
+                        vis[k].c.y += sum[i + 5];
+                        vis[k].d.x += sum[i + 6];
+                        vis[k].d.y += sum[i + 7];
+                    }
+                }
+            }
+        }
+    }
+    free(work);
+}
+
+/* Double precision. */
+void oskar_cross_correlate_jones_to_soa_d(int num_sources, int num_stations,
+        const double4c* jones, double* jones_soa)
+{
+    int s;
+#pragma omp parallel for private(s)
+    for (s = 0; s < num_stations; ++s)
+    {
+        int i;
+        const double4c* restrict in = &jones[s * num_sources];
+        double* restrict out = &jones_soa[8 * s * num_sources];
+        for (i = 0; i < num_sources; ++i)
+        {
+            out[i]                   = in[i].a.x;
+            out[i + num_sources]     = in[i].a.y;
+            out[i + 2 * num_sources] = in[i].b.x;
+            out[i + 3 * num_sources] = in[i].b.y;
+            out[i + 4 * num_sources] = in[i].c.x;
+            out[i + 5 * num_sources] = in[i].c.y;
+            out[i + 6 * num_sources] = in[i].d.x;
+            out[i + 7 * num_sources] = in[i].d.y;
+        }
+    }
+}
+
+static void evaluate_smearing_d(const int n,
+        const double* restrict l, const double* restrict m,
+        const double* restrict nn, const double* restrict a,
+        const double* restrict b, const double* restrict c,
+        const double uu, const double vv, const double ww,
+        const double uu2, const double vv2, const double uuvv,
+        const double du, const double dv, const double dw,
+        const int time_smearing, double* restrict smear)
+{
+    int i;
+
+    /* Bandwidth smearing. */
+    for (i = 0; i < n; ++i)
+        smear[i] = oskar_sinc_d(uu * l[i] + vv * m[i] + ww * (nn[i] - 1.0));
+
+    /* Time-average smearing. */
+    if (time_smearing)
+    {
+        for (i = 0; i < n; ++i)
+            smear[i] *= oskar_evaluate_time_smearing_d(du, dv, dw,
+                    l[i], m[i], nn[i]);
+    }
+
+    /* Gaussian source width. */
+    if (a)
+    {
+        for (i = 0; i < n; ++i)
+            smear[i] *= exp(-(a[i] * uu2 + b[i] * uuvv + c[i] * vv2));
+    }
+}
+
+OSKAR_SIMD_CLONES
+static void accumulate_block_d(const int n, const double* restrict smear,
+        const double* restrict I, const double* restrict Q,
+        const double* restrict U, const double* restrict V,
+        const double* restrict jp, const double* restrict jq,
+        const int stride, double* restrict sum)
+{
+    int i;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    double s4 = 0.0, s5 = 0.0, s6 = 0.0, s7 = 0.0;
+    const double *pax = jp, *pay = jp + stride;
+    const double *pbx = jp + 2 * stride, *pby = jp + 3 * stride;
+    const double *pcx = jp + 4 * stride, *pcy = jp + 5 * stride;
+    const double *pdx = jp + 6 * stride, *pdy = jp + 7 * stride;
+    const double *qax = jq, *qay = jq + stride;
+    const double *qbx = jq + 2 * stride, *qby = jq + 3 * stride;
+    const double *qcx = jq + 4 * stride, *qcy = jq + 5 * stride;
+    const double *qdx = jq + 6 * stride, *qdy = jq + 7 * stride;
+
+#pragma omp simd reduction(+:s0,s1,s2,s3,s4,s5,s6,s7)
+    for (i = 0; i < n; ++i)
+    {
+        double A, D, bx, by, f;
+        double tax, tay, tbx, tby, tcx, tcy, tdx, tdy;
+
+        /* Source brightness matrix. */
+        A = I[i] + Q[i];
+        D = I[i] - Q[i];
+        bx = U[i];
+        by = V[i];
+
+        /* T = J_p * B. */
+        tax = pax[i] * A + pbx[i] * bx + pby[i] * by;
+        tay = pay[i] * A + pby[i] * bx - pbx[i] * by;
+        tbx = pax[i] * bx - pay[i] * by + pbx[i] * D;
+        tby = pax[i] * by + pay[i] * bx + pby[i] * D;
+        tcx = pcx[i] * A + pdx[i] * bx + pdy[i] * by;
+        tcy = pcy[i] * A + pdy[i] * bx - pdx[i] * by;
+        tdx = pcx[i] * bx - pcy[i] * by + pdx[i] * D;
+        tdy = pcx[i] * by + pcy[i] * bx + pdy[i] * D;
+
+        /* V_pq += T * J_q^H * smear. */
+        f = smear[i];
+        s0 += f * (tax * qax[i] + tay * qay[i] + tbx * qbx[i] + tby * qby[i]);
+        s1 += f * (tay * qax[i] - tax * qay[i] + tby * qbx[i] - tbx * qby[i]);
+        s2 += f * (tax * qcx[i] + tay * qcy[i] + tbx * qdx[i] + tby * qdy[i]);
+        s3 += f * (tay * qcx[i] - tax * qcy[i] + tby * qdx[i] - tbx * qdy[i]);
+        s4 += f * (tcx * qax[i] + tcy * qay[i] + tdx * qbx[i] + tdy * qby[i]);
+        s5 += f * (tcy * qax[i] - tcx * qay[i] + tdy * qbx[i] - tdx * qby[i]);
+        s6 += f * (tcx * qcx[i] + tcy * qcy[i] + tdx * qdx[i] + tdy * qdy[i]);
+        s7 += f * (tcy * qcx[i] - tcx * qcy[i] + tdy * qdx[i] - tdx * qdy[i]);
+    }
+    sum[0] = s0; sum[1] = s1; sum[2] = s2; sum[3] = s3;
+    sum[4] = s4; sum[5] = s5; sum[6] = s6; sum[7] = s7;
+}
+
+void oskar_cross_correlate_simd_omp_d(int num_sources, int num_stations,
+        const double* jones_soa, const double* source_I,
+        const double* source_Q, const double* source_U,
+        const double* source_V, const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double4c* vis)
+{
+    int SQ;
+    const int time_smearing = (time_int_sec > 0.0);
+
+    /* Loop over stations. */
+#pragma omp parallel for private(SQ) schedule(dynamic, 1)
+    for (SQ = 0; SQ < num_stations; ++SQ)
+    {
+        int SP, i, k, start, block_size;
+        const double *station_p, *station_q;
+        double smear[BLOCK_SIZE], block_sum[8];
+
+        /* Pointer to source vector for station q. */
+        station_q = &jones_soa[8 * SQ * num_sources];
+
+        /* Loop over baselines for this station. */
+        for (SP = SQ + 1; SP < num_stations; ++SP)
+        {
+            double uv_len, uu, vv, ww, uu2, vv2, uuvv;
+            double du = 0.0, dv = 0.0, dw = 0.0, sum[8];
+
+            /* Pointer to source vector for station p. */
+            station_p = &jones_soa[8 * SP * num_sources];
+
+            /* Get common baseline values. */
+            oskar_evaluate_baseline_terms_inline_d(station_u[SP],
+                    station_u[SQ], station_v[SP], station_v[SQ],
+                    station_w[SP], station_w[SQ], inv_wavelength,
+                    frac_bandwidth, &uv_len, &uu, &vv, &ww, &uu2, &vv2, &uuvv);
+
+            /* Apply the baseline length filter. */
+            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                continue;
+
+            /* Compute the deltas for time-average smearing. */
+            if (time_smearing)
+                oskar_evaluate_baseline_deltas_inline_d(station_x[SP],
+                        station_x[SQ], station_y[SP], station_y[SQ],
+                        inv_wavelength, time_int_sec, gha0_rad, dec0_rad,
+                        &du, &dv, &dw);
+
+            /* Loop over blocks of sources. */
+            for (k = 0; k < 8; ++k) sum[k] = 0.0;
+            for (start = 0; start < num_sources; start += BLOCK_SIZE)
+            {
+                block_size = num_sources - start;
+                if (block_size > BLOCK_SIZE) block_size = BLOCK_SIZE;
+
+                /* Evaluate smearing terms for the block. */
+                evaluate_smearing_d(block_size, &source_l[start],
+                        &source_m[start], &source_n[start],
+                        source_a ? &source_a[start] : 0,
+                        source_a ? &source_b[start] : 0,
+                        source_a ? &source_c[start] : 0,
+                        uu, vv, ww, uu2, vv2, uuvv, du, dv, dw,
+                        time_smearing, smear);
+
+                /* Accumulate visibilities for the block. */
+                accumulate_block_d(block_size, smear, &source_I[start],
+                        &source_Q[start], &source_U[start], &source_V[start],
+                        &station_p[start], &station_q[start], num_sources,
+                        block_sum);
+                for (k = 0; k < 8; ++k) sum[k] += block_sum[k];
+            }
+
+            /* Add result to the baseline visibility. */
+            i = oskar_evaluate_baseline_index_inline(num_stations, SP, SQ);
+            vis[i].a.x += sum[0];
+            vis[i].a.y += sum[1];
+            vis[i].b.x += sum[2];
+            vis[i].b.y += sum[3];
+            vis[i].c.x += sum[4];
+            vis[i].c.y += sum[5];
+            vis[i].d.x += sum[6];
+            vis[i].d.y += sum[7];
+        }
+    }
+}
+
+static void copy_tile_d(const int block_size, const int num_sources,
+        const int station_start, const int num_stations,
+        const int* restrict station_map, const double4c* restrict jones,
+        double* restrict tile)
+{
+    int s, i, row;
+    for (s = 0; s < num_stations; ++s)
+    {
+        const double4c* restrict in;
+        double* restrict out = &tile[8 * s * BLOCK_SIZE];
+        row = station_start + s;
+        if (station_map) row = station_map[row];
+        in = &jones[row * num_sources];
+        for (i = 0; i < block_size; ++i)
+        {
+            out[i]                  = in[i].a.x;
+            out[i + BLOCK_SIZE]     = in[i].a.y;
+            out[i + 2 * BLOCK_SIZE] = in[i].b.x;
+            out[i + 3 * BLOCK_SIZE] = in[i].b.y;
+            out[i + 4 * BLOCK_SIZE] = in[i].c.x;
+            out[i + 5 * BLOCK_SIZE] = in[i].c.y;
+            out[i + 6 * BLOCK_SIZE] = in[i].d.x;
+            out[i + 7 * BLOCK_SIZE] = in[i].d.y;
+        }
+    }
+}
+
+static void evaluate_phase_d(const int n,
+        const double* restrict l, const double* restrict m,
+        const double* restrict nn, const double* restrict I,
+        const double filter_min, const double filter_max,
+        const double pu, const double pv, const double pw,
+        double* restrict smear, double* restrict smear_im)
+{
+    int i;
+    for (i = 0; i < n; ++i)
+    {
+        double phase, f;
+
+        /* Sources outside the filter range have no K term. */
+        f = (I[i] > filter_min && I[i] <= filter_max) ? smear[i] : 0.0;
+
+        /* K_p * conj(K_q) for this source. */
+        phase = pu * l[i] + pv * m[i] + pw * (nn[i] - 1.0);
+        smear[i] = f * cos(phase);
+        smear_im[i] = f * sin(phase);
+    }
+}
+
+OSKAR_SIMD_CLONES
+static void accumulate_block_phase_d(const int n,
+        const double* restrict smear, const double* restrict smear_im,
+        const double* restrict I, const double* restrict Q,
+        const double* restrict U, const double* restrict V,
+        const double* restrict jp, const double* restrict jq,
+        const int stride, double* restrict sum)
+{
+    int i;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    double s4 = 0.0, s5 = 0.0, s6 = 0.0, s7 = 0.0;
+    const double *pax = jp, *pay = jp + stride;
+    const double *pbx = jp + 2 * stride, *pby = jp + 3 * stride;
+    const double *pcx = jp + 4 * stride, *pcy = jp + 5 * stride;
+    const double *pdx = jp + 6 * stride, *pdy = jp + 7 * stride;
+    const double *qax = jq, *qay = jq + stride;
+    const double *qbx = jq + 2 * stride, *qby = jq + 3 * stride;
+    const double *qcx = jq + 4 * stride, *qcy = jq + 5 * stride;
+    const double *qdx = jq + 6 * stride, *qdy = jq + 7 * stride;
+
+#pragma omp simd reduction(+:s0,s1,s2,s3,s4,s5,s6,s7)
+    for (i = 0; i < n; ++i)
+    {
+        double A, D, bx, by, fx, fy, mx, my;
+        double tax, tay, tbx, tby, tcx, tcy, tdx, tdy;
+
+        /* Source brightness matrix. */
+        A = I[i] + Q[i];
+        D = I[i] - Q[i];
+        bx = U[i];
+        by = V[i];
+
+        /* T = E_p * B. */
+        tax = pax[i] * A + pbx[i] * bx + pby[i] * by;
+        tay = pay[i] * A + pby[i] * bx - pbx[i] * by;
+        tbx = pax[i] * bx - pay[i] * by + pbx[i] * D;
+        tby = pax[i] * by + pay[i] * bx + pby[i] * D;
+        tcx = pcx[i] * A + pdx[i] * bx + pdy[i] * by;
+        tcy = pcy[i] * A + pdy[i] * bx - pdx[i] * by;
+        tdx = pcx[i] * bx - pcy[i] * by + pdx[i] * D;
+        tdy = pcx[i] * by + pcy[i] * bx + pdy[i] * D;
+
+        /* V_pq += T * E_q^H * (complex weight). */
+        fx = smear[i];
+        fy = smear_im[i];
+        mx = tax * qax[i] + tay * qay[i] + tbx * qbx[i] + tby * qby[i];
+        my = tay * qax[i] - tax * qay[i] + tby * qbx[i] - tbx * qby[i];
+        s0 += fx * mx - fy * my;
+        s1 += fx * my + fy * mx;
+        mx = tax * qcx[i] + tay * qcy[i] + tbx * qdx[i] + tby * qdy[i];
+        my = tay * qcx[i] - tax * qcy[i] + tby * qdx[i] - tbx * qdy[i];
+        s2 += fx * mx - fy * my;
+        s3 += fx * my + fy * mx;
+        mx = tcx * qax[i] + tcy * qay[i] + tdx * qbx[i] + tdy * qby[i];
+        my = tcy * qax[i] - tcx * qay[i] + tdy * qbx[i] - tdx * qby[i];
+        s4 += fx * mx - fy * my;
+        s5 += fx * my + fy * mx;
+        mx = tcx * qcx[i] + tcy * qcy[i] + tdx * qdx[i] + tdy * qdy[i];
+        my = tcy * qcx[i] - tcx * qcy[i] + tdy * qdx[i] - tdx * qdy[i];
+        s6 += fx * mx - fy * my;
+        s7 += fx * my + fy * mx;
+    }
+    sum[0] = s0; sum[1] = s1; sum[2] = s2; sum[3] = s3;
+    sum[4] = s4; sum[5] = s5; sum[6] = s6; sum[7] = s7;
+}
+
+static void correlate_tiled_d(int num_sources,
+        int num_stations, const double4c* jones, const int* station_map,
+        const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V,
+        const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, int apply_phase, double source_min,
+        double source_max, double4c* vis, int* status)
+{
+    int num_tiles, num_pairs, tile_pair, num_threads = 1;
+    size_t work_size;
+    double* work;
+    const int tile_size = TILE_BYTES / (16 * BLOCK_SIZE * sizeof(double));
+    const int time_smearing = (time_int_sec > 0.0);
+    num_tiles = (num_stations + tile_size - 1) / tile_size;
+    num_pairs = num_tiles * (num_tiles + 1) / 2;
+    if (*status || num_pairs == 0) return;
+
+    /* Allocate workspace for each thread: the Jones matrices for both
+     * tiles, and the sums for each baseline in them. */
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    if (num_threads > num_pairs) num_threads = num_pairs;
+#endif
+    work_size = 8 * tile_size * (2 * BLOCK_SIZE + tile_size);
+    work = (double*) malloc(num_threads * work_size * sizeof(double));
+    if (!work)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+
+    /* Loop over pairs of station tiles. */
+#pragma omp parallel num_threads(num_threads)
+    {
+        int thread = 0;
+        double *buf_p, *buf_q, *sum, block_sum[8];
+        double smear[BLOCK_SIZE], smear_im[BLOCK_SIZE];
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        buf_p = work + thread * work_size;
+        buf_q = buf_p + 8 * tile_size * BLOCK_SIZE;
+        sum = buf_p + 16 * tile_size * BLOCK_SIZE;
+#pragma omp for private(tile_pair) schedule(dynamic, 1)
+        for (tile_pair = 0; tile_pair < num_pairs; ++tile_pair)
+        {
+            int tile_q = 0, tile_p = tile_pair, p0, p1, q0, q1, SP, SQ;
+            int i, k, start, block_size;
+            const double* jones_q;
+            double uv_len, uu, vv, ww, uu2, vv2, uuvv;
+            double du = 0.0, dv = 0.0, dw = 0.0;
+            double pu, pv, pw;
+
+            /* Get the station ranges for this pair of tiles. */
+            while (tile_p >= num_tiles - tile_q)
+            {
+                tile_p -= (num_tiles - tile_q);
+                tile_q++;
+            }
+            tile_p += tile_q;
+            q0 = tile_q * tile_size;
+            p0 = tile_p * tile_size;
+            q1 = q0 + tile_size < num_stations ? q0 + tile_size : num_stations;
+            p1 = p0 + tile_size < num_stations ? p0 + tile_size : num_stations;
+            jones_q = (p0 == q0) ? buf_p : buf_q;
+            for (i = 0; i < 8 * tile_size * tile_size; ++i) sum[i] = 0.0;
+
+            /* Loop over blocks of sources. */
+            for (start = 0; start < num_sources; start += BLOCK_SIZE)
+            {
+                block_size = num_sources - start;
+                if (block_size > BLOCK_SIZE) block_size = BLOCK_SIZE;
+
+                /* Copy the Jones matrices for both tiles into SoA layout. */
+                copy_tile_d(block_size, num_sources, p0, p1 - p0,
+                        station_map, &jones[start], buf_p);
+                if (p0 != q0)
+                    copy_tile_d(block_size, num_sources, q0, q1 - q0,
+                            station_map, &jones[start], buf_q);
+
+                /* Loop over baselines in the pair of tiles. */
+                for (SQ = q0; SQ < q1; ++SQ)
+                {
+                    for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                    {
+                        /* Get common baseline values. */
+                        oskar_evaluate_baseline_terms_inline_d(station_u[SP],
+                                station_u[SQ], station_v[SP], station_v[SQ],
+                                station_w[SP], station_w[SQ], inv_wavelength,
+                                frac_bandwidth, &uv_len, &uu, &vv, &ww,
+                                &uu2, &vv2, &uuvv);
+
+                        /* Apply the baseline length filter. */
+                        if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                            continue;
+
+                        /* Compute the deltas for time-average smearing. */
+                        if (time_smearing)
+                            oskar_evaluate_baseline_deltas_inline_d(
+                                    station_x[SP], station_x[SQ],
+                                    station_y[SP], station_y[SQ],
+                                    inv_wavelength, time_int_sec,
+                                    gha0_rad, dec0_rad, &du, &dv, &dw);
+
+                        /* Evaluate smearing terms for the block. */
+                        evaluate_smearing_d(block_size, &source_l[start],
+                                &source_m[start], &source_n[start],
+                                source_a ? &source_a[start] : 0,
+                                source_a ? &source_b[start] : 0,
+                                source_a ? &source_c[start] : 0,
+                                uu, vv, ww, uu2, vv2, uuvv, du, dv, dw,
+                                time_smearing, smear);
+
+                        /* Accumulate visibilities for the block,
+                         * applying the interferometer phase if required. */
+                        if (apply_phase)
+                        {
+                            pu = 6.28318530717958647692 * inv_wavelength *
+                                    (station_u[SP] - station_u[SQ]);
+                            pv = 6.28318530717958647692 * inv_wavelength *
+                                    (station_v[SP] - station_v[SQ]);
+                            pw = 6.28318530717958647692 * inv_wavelength *
+                                    (station_w[SP] - station_w[SQ]);
+                            evaluate_phase_d(block_size, &source_l[start],
+                                    &source_m[start], &source_n[start],
+                                    &source_I[start], source_min, source_max,
+                                    pu, pv, pw, smear, smear_im);
+                            accumulate_block_phase_d(block_size, smear,
+                                    smear_im, &source_I[start],
+                                    &source_Q[start], &source_U[start],
+                                    &source_V[start],
+                                    &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                    &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                    BLOCK_SIZE, block_sum);
+                        }
+                        else
+                            accumulate_block_d(block_size, smear,
+                                    &source_I[start], &source_Q[start],
+                                    &source_U[start], &source_V[start],
+                                    &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                    &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                    BLOCK_SIZE, block_sum);
+                        i = 8 * ((SQ - q0) * tile_size + (SP - p0));
+                        for (k = 0; k < 8; ++k) sum[i + k] += block_sum[k];
+                    }
+                }
+            }
+
+            /* Add results to the baseline visibilities.
+             * Sums for filtered baselines are zero. */
+            for (SQ = q0; SQ < q1; ++SQ)
+            {
+                for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                {
+                    i = 8 * ((SQ - q0) * tile_size + (SP - p0));
+                    k = oskar_evaluate_baseline_index_inline(num_stations,
+                            SP, SQ);
+                    vis[k].a.x += sum[i + 0];
+                    vis[k].a.y += sum[i + 1];
+                    vis[k].b.x += sum[i + 2];
+                    vis[k].b.y += sum[i + 3];
+                    vis[k].c.x += sum[i + 4];
+                    vis[k].c.y += sum[i + 5];
+                    vis[k].d.x += sum[i + 6];
+                    vis[k].d.y += sum[i + 7];
+                }
+            }
+        }
+    }
+    free(work);
+}
+
+void oskar_cross_correlate_simd_tiled_omp_d(int num_sources,
+        int num_stations, const double4c* jones, const int* station_map,
+        const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V,
+        const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double4c* vis, int* status)
+{
+    correlate_tiled_d(num_sources, num_stations, jones, station_map,
+            source_I, source_Q, source_U, source_V, source_l, source_m,
+            source_n, source_a, source_b, source_c, station_u, station_v,
+            station_w, station_x, station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,
+            0, 0, 0, vis, status);
+}
+
+void oskar_cross_correlate_simd_tiled_phase_omp_d(int num_sources,
+        int num_stations, const double4c* jones, const int* station_map,
+        const double* source_I, const double* source_Q,
+        const double* source_U, const double* source_V,
+        const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        double uv_min_lambda, double uv_max_lambda, double inv_wavelength,
+        double frac_bandwidth, double time_int_sec, double gha0_rad,
+        double dec0_rad, double source_min_jy, double source_max_jy,
+        double4c* vis, int* status)
+{
+    correlate_tiled_d(num_sources, num_stations, jones, station_map,
+            source_I, source_Q, source_U, source_V, source_l, source_m,
+            source_n, source_a, source_b, source_c, station_u, station_v,
+            station_w, station_x, station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,
+            1, source_min_jy, source_max_jy, vis, status);
+}
+
+static void evaluate_channel_terms_d(const int n,
+        const double* restrict l, const double* restrict m,
+        const double* restrict nn, const double* restrict a,
+        const double* restrict b, const double* restrict c,
+        const double bu, const double bv, const double bw, const double kb,
+        const double du, const double dv, const double dw,
+        const int time_smearing, double* restrict path,
+        double* restrict smear, double* restrict t, double* restrict e)
+{
+    int i;
+
+    /* Path difference, in metres, and bandwidth smearing.
+     * The bandwidth-smearing term depends only on the channel bandwidth,
+     * so it is the same for all channels. */
+    for (i = 0; i < n; ++i)
+    {
+        path[i] = bu * l[i] + bv * m[i] + bw * (nn[i] - 1.0);
+        smear[i] = oskar_sinc_d(kb * path[i]);
+    }
+
+    /* Time-average smearing, for unit inverse wavelength. */
+    if (time_smearing)
+    {
+        for (i = 0; i < n; ++i)
+            t[i] = du * l[i] + dv * m[i] + dw * (nn[i] - 1.0);
+    }
+
+    /* Gaussian source width, for unit inverse wavelength. */
+    if (a)
+    {
+        const double bu2 = bu * bu, bv2 = bv * bv, buv = 2.0 * bu * bv;
+        for (i = 0; i < n; ++i)
+            e[i] = a[i] * bu2 + b[i] * buv + c[i] * bv2;
+    }
+}
+
+static void evaluate_channel_weights_d(const int n,
+        const double* restrict path, const double* restrict smear,
+        const double* restrict t, const double* restrict e,
+        const double* restrict I, const double inv_wavelength,
+        const int time_smearing, const int gaussian, const int apply_phase,
+        const double filter_min, const double filter_max,
+        double* restrict re, double* restrict im)
+{
+    int i;
+    for (i = 0; i < n; ++i) re[i] = smear[i];
+    if (time_smearing)
+    {
+        for (i = 0; i < n; ++i)
+            re[i] *= oskar_sinc_d(inv_wavelength * t[i]);
+    }
+    if (gaussian)
+    {
+        const double s = inv_wavelength * inv_wavelength;
+        for (i = 0; i < n; ++i)
+            re[i] *= exp(-s * e[i]);
+    }
+    if (apply_phase)
+    {
+        const double k = 6.28318530717958647692 * inv_wavelength;
+        for (i = 0; i < n; ++i)
+        {
+            double f;
+
+            /* Sources outside the filter range have no K term. */
+            f = (I[i] > filter_min && I[i] <= filter_max) ? re[i] : 0.0;
+
+            /* K_p * conj(K_q) for this source. */
+            re[i] = f * cos(k * path[i]);
+            im[i] = f * sin(k * path[i]);
+        }
+    }
+}
+
+void oskar_cross_correlate_simd_tiled_channels_omp_d(int num_channels,
+        int num_sources, int num_stations, const double4c* const* jones,
+        const int* const* station_map, const double* const* source_I,
+        const double* const* source_Q, const double* const* source_U,
+        const double* const* source_V, const double* source_l,
+        const double* source_m, const double* source_n,
+        const double* source_a, const double* source_b,
+        const double* source_c, const double* station_u,
+        const double* station_v, const double* station_w,
+        const double* station_x, const double* station_y,
+        const double* uv_min_lambda, const double* uv_max_lambda,
+        const double* inv_wavelength, double bandwidth_hz,
+        double time_int_sec, double gha0_rad, double dec0_rad,
+        int apply_phase, double source_min_jy, double source_max_jy,
+        double4c* vis, int* status)
+{
+    int num_tiles, num_pairs, tile_pair, num_baselines, num_threads = 1;
+    size_t terms_size, work_size;
+    double* work;
+    const int tile_size = (int) sqrt(TILE_BYTES /
+            (4.0 * BLOCK_SIZE * sizeof(double)));
+    const int time_smearing = (time_int_sec > 0.0);
+    const double kb = (3.14159265358979323846 * bandwidth_hz /
+            299792458.0);
+    num_tiles = (num_stations + tile_size - 1) / tile_size;
+    num_pairs = num_tiles * (num_tiles + 1) / 2;
+    num_baselines = num_stations * (num_stations - 1) / 2;
+    if (*status || num_pairs == 0 || num_channels <= 0) return;
+
+    /* Allocate workspace for each thread: the Jones matrices for both
+     * tiles, the frequency-independent terms for each baseline in them,
+     * and the sums for each baseline and channel. */
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+    if (num_threads > num_pairs) num_threads = num_pairs;
+#endif
+    terms_size = tile_size * tile_size * BLOCK_SIZE;
+    work_size = 16 * tile_size * BLOCK_SIZE + 4 * terms_size +
+            8 * tile_size * tile_size * num_channels;
+    work = (double*) malloc(num_threads * work_size * sizeof(double));
+    if (!work)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+
+    /* Loop over pairs of station tiles. */
+#pragma omp parallel num_threads(num_threads)
+    {
+        int thread = 0;
+        double *buf_p, *buf_q, *path, *smear, *t, *e, *sum;
+        double block_sum[8], re[BLOCK_SIZE], im[BLOCK_SIZE];
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        buf_p = work + thread * work_size;
+        buf_q = buf_p + 8 * tile_size * BLOCK_SIZE;
+        path = buf_q + 8 * tile_size * BLOCK_SIZE;
+        smear = path + terms_size;
+        t = smear + terms_size;
+        e = t + terms_size;
+        sum = e + terms_size;
+#pragma omp for private(tile_pair) schedule(dynamic, 1)
+        for (tile_pair = 0; tile_pair < num_pairs; ++tile_pair)
+        {
+            int tile_q = 0, tile_p = tile_pair, p0, p1, q0, q1, SP, SQ;
+            int c, i, j, k, start, block_size;
+            const double* jones_q;
+            double bu, bv, bw, du = 0.0, dv = 0.0, dw = 0.0, uv_len;
+
+            /* Get the station ranges for this pair of tiles. */
+            while (tile_p >= num_tiles - tile_q)
+            {
+                tile_p -= (num_tiles - tile_q);
+                tile_q++;
+            }
+            tile_p += tile_q;
+            q0 = tile_q * tile_size;
+            p0 = tile_p * tile_size;
+            q1 = q0 + tile_size < num_stations ? q0 + tile_size : num_stations;
+            p1 = p0 + tile_size < num_stations ? p0 + tile_size : num_stations;
+            jones_q = (p0 == q0) ? buf_p : buf_q;
+            for (i = 0; i < 8 * tile_size * tile_size * num_channels; ++i)
+                sum[i] = 0.0;
+
+            /* Loop over blocks of sources. */
+            for (start = 0; start < num_sources; start += BLOCK_SIZE)
+            {
+                block_size = num_sources - start;
+                if (block_size > BLOCK_SIZE) block_size = BLOCK_SIZE;
+
+                /* Evaluate the frequency-independent terms for the block,
+                 * once for all channels. */
+                for (SQ = q0; SQ < q1; ++SQ)
+                {
+                    for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                    {
+                        j = ((SQ - q0) * tile_size + (SP - p0)) * BLOCK_SIZE;
+                        bu = station_u[SP] - station_u[SQ];
+                        bv = station_v[SP] - station_v[SQ];
+                        bw = station_w[SP] - station_w[SQ];
+                        if (time_smearing)
+                            oskar_evaluate_baseline_deltas_inline_d(
+                                    station_x[SP], station_x[SQ],
+                                    station_y[SP], station_y[SQ],
+                                    1.0, time_int_sec, gha0_rad, dec0_rad,
+                                    &du, &dv, &dw);
+                        evaluate_channel_terms_d(block_size, &source_l[start],
+                                &source_m[start], &source_n[start],
+                                source_a ? &source_a[start] : 0,
+                                source_a ? &source_b[start] : 0,
+                                source_a ? &source_c[start] : 0,
+                                bu, bv, bw, kb, du, dv, dw, time_smearing,
+                                &path[j], &smear[j], &t[j], &e[j]);
+                    }
+                }
+
+                /* Loop over channels. */
+                for (c = 0; c < num_channels; ++c)
+                {
+                    const int* map = station_map ? station_map[c] : 0;
+                    const double *I_ = source_I[c], *Q_ = source_Q[c];
+                    const double *U_ = source_U[c], *V_ = source_V[c];
+
+                    /* Copy the Jones matrices for both tiles into SoA
+                     * layout. */
+                    copy_tile_d(block_size, num_sources, p0, p1 - p0,
+                            map, &jones[c][start], buf_p);
+                    if (p0 != q0)
+                        copy_tile_d(block_size, num_sources, q0, q1 - q0,
+                                map, &jones[c][start], buf_q);
+
+                    /* Loop over baselines in the pair of tiles. */
+                    for (SQ = q0; SQ < q1; ++SQ)
+                    {
+                        for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                        {
+                            /* Apply the baseline length filter. */
+                            bu = station_u[SP] - station_u[SQ];
+                            bv = station_v[SP] - station_v[SQ];
+                            uv_len = sqrt(bu * bu + bv * bv) *
+                                    inv_wavelength[c];
+                            if (uv_len < uv_min_lambda[c] ||
+                                    uv_len > uv_max_lambda[c])
+                                continue;
+
+                            /* Accumulate visibilities for the block. */
+                            j = ((SQ - q0) * tile_size + (SP - p0));
+                            evaluate_channel_weights_d(block_size,
+                                    &path[j * BLOCK_SIZE],
+                                    &smear[j * BLOCK_SIZE],
+                                    &t[j * BLOCK_SIZE], &e[j * BLOCK_SIZE],
+                                    &I_[start], inv_wavelength[c],
+                                    time_smearing, source_a != 0,
+                                    apply_phase, source_min_jy, source_max_jy,
+                                    re, im);
+                            if (apply_phase)
+                                accumulate_block_phase_d(block_size, re, im,
+                                        &I_[start], &Q_[start], &U_[start],
+                                        &V_[start],
+                                        &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                        &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                        BLOCK_SIZE, block_sum);
+                            else
+                                accumulate_block_d(block_size, re,
+                                        &I_[start], &Q_[start], &U_[start],
+                                        &V_[start],
+                                        &buf_p[8 * (SP - p0) * BLOCK_SIZE],
+                                        &jones_q[8 * (SQ - q0) * BLOCK_SIZE],
+                                        BLOCK_SIZE, block_sum);
+                            i = 8 * (c * tile_size * tile_size + j);
+                            for (k = 0; k < 8; ++k)
+                                sum[i + k] += block_sum[k];
+                        }
+                    }
+                }
+            }
+
+            /* Add results to the baseline visibilities for each channel.
+             * Sums for filtered baselines are zero. */
+            for (c = 0; c < num_channels; ++c)
+            {
+                for (SQ = q0; SQ < q1; ++SQ)
+                {
+                    for (SP = (SQ + 1 > p0 ? SQ + 1 : p0); SP < p1; ++SP)
+                    {
+                        i = 8 * (c * tile_size * tile_size +
+                                (SQ - q0) * tile_size + (SP - p0));
+                        k = c * num_baselines +
+                                oskar_evaluate_baseline_index_inline(
+                                        num_stations, SP, SQ);
+                        vis[k].a.x += sum[i + 0];
+                        vis[k].a.y += sum[i + 1];
+                        vis[k].b.x += sum[i + 2];
+                        vis[k].b.y += sum[i + 3];
+                        vis[k].c.x += sum[i + 4];
+                        vis[k].c.y += sum[i + 5];
+                        vis[k].d.x += sum[i + 6];
+                        vis[k].d.y += sum[i + 7];
+                    }
+                }
+            }
+        }
+    }
+    free(work);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, The University of Oxford
+ * Copyright (c) 2015-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -171,6 +171,39 @@ protected:
                 time2 * 1000.0);
 #endif
     }
+
+    // Checks that stations sharing the Jones matrices of another station
+    // give the same result as stations holding their own copy of them.
+    void runSharedTest(int matrix)
+    {
+        int i, status = 0, type;
+        oskar_Jones* expanded;
+        oskar_Mem *vis1, *vis2;
+
+        createTestData(OSKAR_DOUBLE, OSKAR_CPU, matrix);
+        for (i = 10; i < 20; ++i)
+            oskar_jones_set_station_shared(jones, i, 3, &status);
+        expanded = oskar_jones_create_copy(jones, OSKAR_CPU, &status);
+        oskar_jones_expand_shared_stations(expanded, &status);
+        type = OSKAR_DOUBLE | OSKAR_COMPLEX;
+        if (matrix) type |= OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, num_stations, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, num_stations, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        oskar_auto_correlate(vis1, oskar_sky_num_sources(sky), expanded, sky,
+                &status);
+        oskar_auto_correlate(vis2, oskar_sky_num_sources(sky), jones, sky,
+                &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_jones_free(expanded, &status);
+        destroyTestData();
+
+        // Compare results.
+        check_values(vis2, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+    }
 };
 
 // CPU only.
@@ -180,6 +213,11 @@ TEST_F(auto_correlate, matrix_singleCPU_doubleCPU)
             OSKAR_CPU, OSKAR_CPU, 1);
 }
 
+TEST_F(auto_correlate, matrix_shared_stations)
+{
+    runSharedTest(1);
+}
+
 #ifdef OSKAR_HAVE_CUDA
 TEST_F(auto_correlate, matrix_singleGPU_doubleGPU)
 {
@@ -221,6 +259,11 @@ TEST_F(auto_correlate, scalar_singleCPU_doubleCPU)
             OSKAR_CPU, OSKAR_CPU, 0);
 }
 
+TEST_F(auto_correlate, scalar_shared_stations)
+{
+    runSharedTest(0);
+}
+
 #ifdef OSKAR_HAVE_CUDA
 TEST_F(auto_correlate, scalar_singleGPU_doubleGPU)
 {
@@ -252,3 +295,32 @@ TEST_F(auto_correlate, scalar_singleCPU_doubleGPU)
             OSKAR_CPU, OSKAR_GPU, 0);
 }
 #endif
+
+#ifdef OSKAR_HAVE_OPENCL
+
+// OpenCL only. ///////////////////////////////////////////////////////////////
+
+TEST_F(auto_correlate, matrix_singleCL_doubleCPU)
+{
+    runTest(OSKAR_SINGLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 1);
+}
+
+TEST_F(auto_correlate, matrix_doubleCL_doubleCPU)
+{
+    runTest(OSKAR_DOUBLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 1);
+}
+
+TEST_F(auto_correlate, scalar_singleCL_doubleCPU)
+{
+    runTest(OSKAR_SINGLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 0);
+}
+
+TEST_F(auto_correlate, scalar_doubleCL_doubleCPU)
+{
+    runTest(OSKAR_DOUBLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 0);
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, The University of Oxford
+ * Copyright (c) 2013-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -31,8 +31,15 @@
 #include "utility/oskar_timer.h"
 
 #include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_gaussian_omp.h"
+#include "correlate/oskar_cross_correlate_gaussian_time_smearing_omp.h"
+#include "correlate/oskar_cross_correlate_point_omp.h"
+#include "correlate/oskar_cross_correlate_point_time_smearing_omp.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
+#include "interferometer/oskar_evaluate_jones_K.h"
 #include "utility/oskar_get_error_string.h"
 #include "math/oskar_kahan_sum.h"
+#include <cfloat>
 #include <cstdlib>
 
 // Comment out this line to disable benchmark timer printing.
@@ -223,11 +230,331 @@ protected:
                 time2 * 1000.0);
 #endif
     }
+
+    // Compares the vectorised CPU correlators (tiled, as used by
+    // oskar_cross_correlate(), and untiled) with the original OpenMP
+    // kernels, in double precision.
+    void runSimdTest(int extended, double time_average)
+    {
+        int num_baselines, status = 0;
+        double frequency = 100e6, inv_wavelength, frac_bandwidth;
+        double gha0 = 1.0, dec0 = 0.0;
+        const double *I_, *Q_, *U_, *V_, *l_, *m_, *n_, *a_, *b_, *c_;
+        const double *u, *v, *w, *x, *y;
+        oskar_Mem *vis1, *vis2;
+
+        createTestData(OSKAR_DOUBLE, OSKAR_CPU, 1);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        vis1 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+                num_baselines, &status);
+        vis2 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+                num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_sky_set_use_extended(sky, extended);
+        oskar_telescope_set_channel_bandwidth(tel, bandwidth);
+        oskar_telescope_set_time_average(tel, time_average);
+        oskar_telescope_set_phase_centre(tel,
+                OSKAR_SPHERICAL_TYPE_EQUATORIAL, 0.0, dec0);
+
+        // Call the reference kernel directly.
+        inv_wavelength = frequency / 299792458.0;
+        frac_bandwidth = bandwidth / frequency;
+        I_ = oskar_mem_double_const(oskar_sky_I_const(sky), &status);
+        Q_ = oskar_mem_double_const(oskar_sky_Q_const(sky), &status);
+        U_ = oskar_mem_double_const(oskar_sky_U_const(sky), &status);
+        V_ = oskar_mem_double_const(oskar_sky_V_const(sky), &status);
+        l_ = oskar_mem_double_const(oskar_sky_l_const(sky), &status);
+        m_ = oskar_mem_double_const(oskar_sky_m_const(sky), &status);
+        n_ = oskar_mem_double_const(oskar_sky_n_const(sky), &status);
+        a_ = oskar_mem_double_const(oskar_sky_gaussian_a_const(sky), &status);
+        b_ = oskar_mem_double_const(oskar_sky_gaussian_b_const(sky), &status);
+        c_ = oskar_mem_double_const(oskar_sky_gaussian_c_const(sky), &status);
+        u = oskar_mem_double_const(u_, &status);
+        v = oskar_mem_double_const(v_, &status);
+        w = oskar_mem_double_const(w_, &status);
+        x = oskar_mem_double_const(
+                oskar_telescope_station_true_x_offset_ecef_metres_const(tel),
+                &status);
+        y = oskar_mem_double_const(
+                oskar_telescope_station_true_y_offset_ecef_metres_const(tel),
+                &status);
+        const double4c* J = oskar_jones_double4c_const(jones, &status);
+        double4c* vis = oskar_mem_double4c(vis1, &status);
+        if (time_average > 0.0 && extended)
+            oskar_cross_correlate_gaussian_time_smearing_omp_d(num_sources,
+                    num_stations, J, I_, Q_, U_, V_, l_, m_, n_, a_, b_, c_,
+                    u, v, w, x, y, 0.0, DBL_MAX, inv_wavelength,
+                    frac_bandwidth, time_average, gha0, dec0, vis);
+        else if (time_average > 0.0)
+            oskar_cross_correlate_point_time_smearing_omp_d(num_sources,
+                    num_stations, J, I_, Q_, U_, V_, l_, m_, n_,
+                    u, v, w, x, y, 0.0, DBL_MAX, inv_wavelength,
+                    frac_bandwidth, time_average, gha0, dec0, vis);
+        else if (extended)
+            oskar_cross_correlate_gaussian_omp_d(num_sources,
+                    num_stations, J, I_, Q_, U_, V_, l_, m_, n_, a_, b_, c_,
+                    u, v, w, 0.0, DBL_MAX, inv_wavelength,
+                    frac_bandwidth, vis);
+        else
+            oskar_cross_correlate_point_omp_d(num_sources,
+                    num_stations, J, I_, Q_, U_, V_, l_, m_, n_,
+                    u, v, w, 0.0, DBL_MAX, inv_wavelength,
+                    frac_bandwidth, vis);
+
+        // Call the untiled vectorised version.
+        oskar_Mem* vis3 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX,
+                OSKAR_CPU, num_baselines, &status);
+        oskar_Mem* soa = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                8 * num_sources * num_stations, &status);
+        oskar_mem_clear_contents(vis3, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_cross_correlate_jones_to_soa_d(num_sources, num_stations, J,
+                oskar_mem_double(soa, &status));
+        oskar_cross_correlate_simd_omp_d(num_sources, num_stations,
+                oskar_mem_double_const(soa, &status), I_, Q_, U_, V_,
+                l_, m_, n_, extended ? a_ : 0, b_, c_, u, v, w, x, y,
+                0.0, DBL_MAX, inv_wavelength, frac_bandwidth, time_average,
+                gha0, dec0, oskar_mem_double4c(vis3, &status));
+
+        // Call the tiled vectorised version.
+        oskar_cross_correlate(vis2, oskar_sky_num_sources(sky), jones, sky,
+                tel, u_, v_, w_, gha0, frequency, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        destroyTestData();
+
+        // Compare results.
+        check_values(vis2, vis1);
+        check_values(vis3, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        oskar_mem_free(vis3, &status);
+        oskar_mem_free(soa, &status);
+    }
+
+    // Checks that stations sharing the Jones matrices of another station
+    // give the same result as stations holding their own copy of them.
+    void runSharedTest(int matrix, int extended, double time_average)
+    {
+        int i, num_baselines, status = 0, type;
+        double frequency = 100e6;
+        oskar_Jones* expanded;
+        oskar_Mem *vis1, *vis2;
+
+        createTestData(OSKAR_DOUBLE, OSKAR_CPU, matrix);
+        for (i = 10; i < 20; ++i)
+            oskar_jones_set_station_shared(jones, i, 3, &status);
+        oskar_jones_set_station_shared(jones, num_stations - 1, 0, &status);
+        expanded = oskar_jones_create_copy(jones, OSKAR_CPU, &status);
+        oskar_jones_expand_shared_stations(expanded, &status);
+        EXPECT_EQ(11, oskar_jones_num_shared_stations(jones));
+        EXPECT_EQ(0, oskar_jones_num_shared_stations(expanded));
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = OSKAR_DOUBLE | OSKAR_COMPLEX;
+        if (matrix) type |= OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_sky_set_use_extended(sky, extended);
+        oskar_telescope_set_channel_bandwidth(tel, bandwidth);
+        oskar_telescope_set_time_average(tel, time_average);
+        oskar_cross_correlate(vis1, oskar_sky_num_sources(sky), expanded,
+                sky, tel, u_, v_, w_, 1.0, frequency, &status);
+        oskar_cross_correlate(vis2, oskar_sky_num_sources(sky), jones,
+                sky, tel, u_, v_, w_, 1.0, frequency, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_jones_free(expanded, &status);
+        destroyTestData();
+
+        // Compare results.
+        check_values(vis2, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+    }
+
+    // Checks that applying the interferometer phase in the correlator
+    // gives the same result as forming J = K * E and correlating that.
+    void runPhaseTest(int precision, int extended, double time_average,
+            double source_min_jy, double source_max_jy)
+    {
+        int num_baselines, status = 0, type;
+        double frequency = 100e6;
+        oskar_Jones *J, *K;
+        oskar_Mem *vis1, *vis2;
+
+        createTestData(precision, OSKAR_CPU, 1);
+        oskar_jones_set_station_shared(jones, 7, 2, &status);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = precision | OSKAR_COMPLEX | OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_sky_set_use_extended(sky, extended);
+        oskar_telescope_set_channel_bandwidth(tel, bandwidth);
+        oskar_telescope_set_time_average(tel, time_average);
+
+        // Form J = K * E and correlate it.
+        K = oskar_jones_create(precision | OSKAR_COMPLEX, OSKAR_CPU,
+                num_stations, num_sources, &status);
+        J = oskar_jones_create(type, OSKAR_CPU, num_stations, num_sources,
+                &status);
+        oskar_evaluate_jones_K(K, num_sources, oskar_sky_l_const(sky),
+                oskar_sky_m_const(sky), oskar_sky_n_const(sky),
+                u_, v_, w_, frequency, oskar_sky_I_const(sky),
+                source_min_jy, source_max_jy, &status);
+        oskar_jones_join(J, K, jones, &status);
+        oskar_cross_correlate(vis1, num_sources, J, sky, tel,
+                u_, v_, w_, 1.0, frequency, &status);
+
+        // Correlate E, applying the phase in the correlator.
+        oskar_cross_correlate_phase(vis2, num_sources, jones, sky, tel,
+                u_, v_, w_, 1.0, frequency, source_min_jy, source_max_jy,
+                &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_jones_free(J, &status);
+        oskar_jones_free(K, &status);
+        destroyTestData();
+
+        // Compare results.
+        check_values(vis2, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+    }
+
+    // Checks that correlating several channels in one sweep over the
+    // sources gives the same result as correlating each channel in turn.
+    void runChannelsTest(int precision, int extended, double time_average,
+            int apply_phase)
+    {
+        int c, num_baselines, status = 0, type;
+        const int num_channels = 3;
+        const double frequency[] = {100e6, 120e6, 145e6};
+        oskar_Jones* J[num_channels];
+        oskar_Sky* sky_c[num_channels];
+        oskar_Mem *vis1, *vis2, *alias;
+
+        createTestData(precision, OSKAR_CPU, 1);
+        oskar_sky_set_use_extended(sky, extended);
+        oskar_telescope_set_channel_bandwidth(tel, bandwidth);
+        oskar_telescope_set_time_average(tel, time_average);
+        oskar_telescope_set_uv_filter(tel, 0.5, 1e9, "Wavelengths",
+                &status);
+        J[0] = jones;
+        sky_c[0] = sky;
+        for (c = 1; c < num_channels; ++c)
+        {
+            J[c] = oskar_jones_create_copy(jones, OSKAR_CPU, &status);
+            oskar_mem_random_range(oskar_jones_mem(J[c]), 1.0, 5.0, &status);
+            sky_c[c] = oskar_sky_create_copy(sky, OSKAR_CPU, &status);
+            oskar_mem_scale_real(oskar_sky_I(sky_c[c]), 0.8 + 0.3 * c,
+                    &status);
+            oskar_mem_scale_real(oskar_sky_Q(sky_c[c]), 0.5 * c, &status);
+        }
+        oskar_jones_set_station_shared(J[1], 7, 2, &status);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = precision | OSKAR_COMPLEX | OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU,
+                num_channels * num_baselines, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU,
+                num_channels * num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Correlate each channel in turn.
+        alias = oskar_mem_create_alias(0, 0, 0, &status);
+        for (c = 0; c < num_channels; ++c)
+        {
+            oskar_mem_set_alias(alias, vis1, c * num_baselines,
+                    num_baselines, &status);
+            if (apply_phase)
+                oskar_cross_correlate_phase(alias, num_sources, J[c],
+                        sky_c[c], tel, u_, v_, w_, 1.0, frequency[c],
+                        1.2, 2.5, &status);
+            else
+                oskar_cross_correlate(alias, num_sources, J[c], sky_c[c],
+                        tel, u_, v_, w_, 1.0, frequency[c], &status);
+        }
+        oskar_mem_free(alias, &status);
+
+        // Correlate all channels together.
+        oskar_cross_correlate_channels(vis2, num_channels, num_sources, J,
+                sky_c, tel, u_, v_, w_, 1.0, frequency, apply_phase,
+                1.2, 2.5, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        for (c = 1; c < num_channels; ++c)
+        {
+            oskar_jones_free(J[c], &status);
+            oskar_sky_free(sky_c[c], &status);
+        }
+        destroyTestData();
+
+        // Compare results.
+        check_values(vis2, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+    }
 };
 
 const double cross_correlate::bandwidth = 1e4;
 
+TEST_F(cross_correlate, matrix_simd_point)
+{
+    runSimdTest(0, 0.0);
+}
+
+TEST_F(cross_correlate, matrix_simd_point_timeSmearing)
+{
+    runSimdTest(0, 10.0);
+}
+
+TEST_F(cross_correlate, matrix_simd_gaussian)
+{
+    runSimdTest(1, 0.0);
+}
+
+TEST_F(cross_correlate, matrix_simd_gaussian_timeSmearing)
+{
+    runSimdTest(1, 10.0);
+}
+
 // CPU only.
+TEST_F(cross_correlate, matrix_shared_stations)
+{
+    runSharedTest(1, 0, 0.0);
+    runSharedTest(1, 1, 10.0);
+}
+
+TEST_F(cross_correlate, scalar_shared_stations)
+{
+    runSharedTest(0, 0, 0.0);
+    runSharedTest(0, 1, 10.0);
+}
+
+TEST_F(cross_correlate, matrix_phase)
+{
+    runPhaseTest(OSKAR_DOUBLE, 0, 0.0, -DBL_MAX, DBL_MAX);
+    runPhaseTest(OSKAR_DOUBLE, 1, 10.0, -DBL_MAX, DBL_MAX);
+    runPhaseTest(OSKAR_DOUBLE, 1, 0.0, 1.2, 1.8);
+    runPhaseTest(OSKAR_SINGLE, 0, 0.0, -DBL_MAX, DBL_MAX);
+    runPhaseTest(OSKAR_SINGLE, 1, 10.0, 1.2, 1.8);
+}
+
+TEST_F(cross_correlate, matrix_channels)
+{
+    runChannelsTest(OSKAR_DOUBLE, 0, 0.0, 0);
+    runChannelsTest(OSKAR_DOUBLE, 1, 10.0, 0);
+    runChannelsTest(OSKAR_DOUBLE, 0, 10.0, 1);
+    runChannelsTest(OSKAR_DOUBLE, 1, 0.0, 1);
+    runChannelsTest(OSKAR_SINGLE, 0, 0.0, 0);
+    runChannelsTest(OSKAR_SINGLE, 1, 10.0, 1);
+}
+
 TEST_F(cross_correlate, matrix_point_singleCPU_doubleCPU)
 {
     runTest(OSKAR_SINGLE, OSKAR_DOUBLE,
@@ -542,6 +869,47 @@ TEST_F(cross_correlate, scalar_gaussian_timeSmearing_singleCPU_doubleGPU)
 }
 #endif
 
+#ifdef OSKAR_HAVE_OPENCL
+
+// OpenCL only. ///////////////////////////////////////////////////////////////
+
+TEST_F(cross_correlate, matrix_point_singleCL_doubleCPU)
+{
+    runTest(OSKAR_SINGLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 1, 0, 0.0);
+}
+
+TEST_F(cross_correlate, matrix_point_doubleCL_doubleCPU)
+{
+    runTest(OSKAR_DOUBLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 1, 0, 0.0);
+}
+
+TEST_F(cross_correlate, matrix_gaussian_timeSmearing_singleCL_doubleCPU)
+{
+    runTest(OSKAR_SINGLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 1, 1, 10.0);
+}
+
+TEST_F(cross_correlate, matrix_gaussian_timeSmearing_doubleCL_doubleCPU)
+{
+    runTest(OSKAR_DOUBLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 1, 1, 10.0);
+}
+
+TEST_F(cross_correlate, scalar_point_doubleCL_doubleCPU)
+{
+    runTest(OSKAR_DOUBLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 0, 0, 0.0);
+}
+
+TEST_F(cross_correlate, scalar_gaussian_timeSmearing_doubleCL_doubleCPU)
+{
+    runTest(OSKAR_DOUBLE, OSKAR_DOUBLE,
+            OSKAR_CL, OSKAR_CPU, 0, 1, 10.0);
+}
+#endif
+
 #if 0
 TEST(KahanSum, sum)
 {
@@ -28,6 +28,11 @@
 
 #include "apps/oskar_option_parser.h"
 #include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_gaussian_omp.h"
+#include "correlate/oskar_cross_correlate_gaussian_time_smearing_omp.h"
+#include "correlate/oskar_cross_correlate_point_omp.h"
+#include "correlate/oskar_cross_correlate_point_time_smearing_omp.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
 #include "sky/oskar_sky.h"
 #include "interferometer/oskar_jones.h"
 #include "mem/oskar_mem.h"
@@ -42,11 +47,14 @@
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
+#include <string>
 #include <vector>
 
+enum { KERNEL_DEFAULT, KERNEL_OMP, KERNEL_SIMD };
+
 int benchmark(int num_stations, int num_sources, int type,
-        int jones_type, int loc, int use_extended, int use_time_ave, int niter,
-        std::vector<double>& times);
+        int jones_type, int loc, int use_extended, int use_time_ave,
+        int kernel, int niter, std::vector<double>& times);
 
 int main(int argc, char** argv)
 {
@@ -60,6 +68,9 @@ int main(int argc, char** argv)
     opt.add_flag("-e", "Use Gaussian sources (default: point sources).");
     opt.add_flag("-t", "Use analytical time averaging (default: no time "
             "averaging).");
+    opt.add_flag("-k", "CPU correlator to use for matrix Jones terms: "
+            "'default' (tiled), 'omp' (untiled) or 'simd' (untiled, "
+            "vectorised).", 1, "default", false);
     opt.add_flag("-r", "Dump raw iteration data to this file.", 1);
     opt.add_flag("-std", "Discard values greater than this number of standard "
             "deviations from the mean.", 1);
@@ -79,7 +90,18 @@ int main(int argc, char** argv)
     opt.get("-n")->getInt(niter);
     int use_extended = opt.is_set("-e") ? OSKAR_TRUE : OSKAR_FALSE;
     int use_time_ave = opt.is_set("-t") ? OSKAR_TRUE : OSKAR_FALSE;
-    std::string raw_file;
+    std::string raw_file, kernel_name;
+    opt.get("-k")->getString(kernel_name);
+    int kernel = KERNEL_DEFAULT;
+    if (kernel_name == "omp")
+        kernel = KERNEL_OMP;
+    else if (kernel_name == "simd")
+        kernel = KERNEL_SIMD;
+    else if (kernel_name != "default")
+    {
+        opt.error("Unknown kernel name");
+        return EXIT_FAILURE;
+    }
     if (opt.is_set("-r"))
         opt.get("-r")->getString(raw_file);
     if (opt.is_set("-std"))
@@ -105,6 +127,7 @@ int main(int argc, char** argv)
         printf("- Jones type: %s\n", (opt.is_set("-s")) ? "scalar" : "matrix");
         printf("- Extended sources: %s\n", (use_extended) ? "true" : "false");
         printf("- Analytical time smearing: %s\n", (use_time_ave) ? "true" : "false");
+        printf("- CPU kernel: %s\n", kernel_name.c_str());
         printf("- Number of iterations: %i\n", niter);
         if (max_std_dev > 0.0)
             printf("- Max standard deviations: %f\n", max_std_dev);
@@ -117,7 +140,7 @@ int main(int argc, char** argv)
     double time_taken_sec = 0.0, average_time_sec = 0.0;
     std::vector<double> times;
     int status = benchmark(num_stations, num_sources, type, jones_type,
-            loc, use_extended, use_time_ave, niter, times);
+            loc, use_extended, use_time_ave, kernel, niter, times);
 
     // Compute total time taken.
     for (int i = 0; i < niter; ++i)
@@ -202,9 +225,132 @@ int main(int argc, char** argv)
     return EXIT_SUCCESS;
 }
 
+// Calls one of the untiled CPU correlators directly.
+static void correlate_cpu(int kernel, oskar_Mem* vis, const oskar_Jones* J,
+        const oskar_Sky* sky, const oskar_Telescope* tel, const oskar_Mem* u,
+        const oskar_Mem* v, const oskar_Mem* w, oskar_Mem* soa,
+        double frequency_hz, int* status)
+{
+    int num_sources = oskar_sky_num_sources(sky);
+    int num_stations = oskar_telescope_num_stations(tel);
+    int ext = oskar_sky_use_extended(sky);
+    double inv_wavelength = frequency_hz / 299792458.0;
+    double frac_bw = oskar_telescope_channel_bandwidth_hz(tel) / frequency_hz;
+    double t_ave = oskar_telescope_time_average_sec(tel);
+    double uv_max = 1e30;
+    if (oskar_mem_is_double(vis))
+    {
+        const double4c* J_ = oskar_jones_double4c_const(J, status);
+        const double *I_, *Q_, *U_, *V_, *l_, *m_, *n_, *a_, *b_, *c_;
+        const double *u_, *v_, *w_, *x_, *y_;
+        double4c* vis_ = oskar_mem_double4c(vis, status);
+        I_ = oskar_mem_double_const(oskar_sky_I_const(sky), status);
+        Q_ = oskar_mem_double_const(oskar_sky_Q_const(sky), status);
+        U_ = oskar_mem_double_const(oskar_sky_U_const(sky), status);
+        V_ = oskar_mem_double_const(oskar_sky_V_const(sky), status);
+        l_ = oskar_mem_double_const(oskar_sky_l_const(sky), status);
+        m_ = oskar_mem_double_const(oskar_sky_m_const(sky), status);
+        n_ = oskar_mem_double_const(oskar_sky_n_const(sky), status);
+        a_ = oskar_mem_double_const(oskar_sky_gaussian_a_const(sky), status);
+        b_ = oskar_mem_double_const(oskar_sky_gaussian_b_const(sky), status);
+        c_ = oskar_mem_double_const(oskar_sky_gaussian_c_const(sky), status);
+        u_ = oskar_mem_double_const(u, status);
+        v_ = oskar_mem_double_const(v, status);
+        w_ = oskar_mem_double_const(w, status);
+        x_ = oskar_mem_double_const(
+                oskar_telescope_station_true_x_offset_ecef_metres_const(tel),
+                status);
+        y_ = oskar_mem_double_const(
+                oskar_telescope_station_true_y_offset_ecef_metres_const(tel),
+                status);
+        if (kernel == KERNEL_SIMD)
+        {
+            double* t = oskar_mem_double(soa, status);
+            oskar_cross_correlate_jones_to_soa_d(num_sources, num_stations,
+                    J_, t);
+            oskar_cross_correlate_simd_omp_d(num_sources, num_stations, t,
+                    I_, Q_, U_, V_, l_, m_, n_, ext ? a_ : 0, b_, c_,
+                    u_, v_, w_, x_, y_, 0.0, uv_max, inv_wavelength,
+                    frac_bw, t_ave, 0.0, 0.0, vis_);
+        }
+        else if (t_ave > 0.0 && ext)
+            oskar_cross_correlate_gaussian_time_smearing_omp_d(num_sources,
+                    num_stations, J_, I_, Q_, U_, V_, l_, m_, n_, a_, b_, c_,
+                    u_, v_, w_, x_, y_, 0.0, uv_max, inv_wavelength,
+                    frac_bw, t_ave, 0.0, 0.0, vis_);
+        else if (t_ave > 0.0)
+            oskar_cross_correlate_point_time_smearing_omp_d(num_sources,
+                    num_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
+                    u_, v_, w_, x_, y_, 0.0, uv_max, inv_wavelength,
+                    frac_bw, t_ave, 0.0, 0.0, vis_);
+        else if (ext)
+            oskar_cross_correlate_gaussian_omp_d(num_sources, num_stations,
+                    J_, I_, Q_, U_, V_, l_, m_, n_, a_, b_, c_, u_, v_, w_,
+                    0.0, uv_max, inv_wavelength, frac_bw, vis_);
+        else
+            oskar_cross_correlate_point_omp_d(num_sources, num_stations,
+                    J_, I_, Q_, U_, V_, l_, m_, n_, u_, v_, w_,
+                    0.0, uv_max, inv_wavelength, frac_bw, vis_);
+    }
+    else
+    {
+        const float4c* J_ = oskar_jones_float4c_const(J, status);
+        const float *I_, *Q_, *U_, *V_, *l_, *m_, *n_, *a_, *b_, *c_;
+        const float *u_, *v_, *w_, *x_, *y_;
+        float4c* vis_ = oskar_mem_float4c(vis, status);
+        I_ = oskar_mem_float_const(oskar_sky_I_const(sky), status);
+        Q_ = oskar_mem_float_const(oskar_sky_Q_const(sky), status);
+        U_ = oskar_mem_float_const(oskar_sky_U_const(sky), status);
+        V_ = oskar_mem_float_const(oskar_sky_V_const(sky), status);
+        l_ = oskar_mem_float_const(oskar_sky_l_const(sky), status);
+        m_ = oskar_mem_float_const(oskar_sky_m_const(sky), status);
+        n_ = oskar_mem_float_const(oskar_sky_n_const(sky), status);
+        a_ = oskar_mem_float_const(oskar_sky_gaussian_a_const(sky), status);
+        b_ = oskar_mem_float_const(oskar_sky_gaussian_b_const(sky), status);
+        c_ = oskar_mem_float_const(oskar_sky_gaussian_c_const(sky), status);
+        u_ = oskar_mem_float_const(u, status);
+        v_ = oskar_mem_float_const(v, status);
+        w_ = oskar_mem_float_const(w, status);
+        x_ = oskar_mem_float_const(
+                oskar_telescope_station_true_x_offset_ecef_metres_const(tel),
+                status);
+        y_ = oskar_mem_float_const(
+                oskar_telescope_station_true_y_offset_ecef_metres_const(tel),
+                status);
+        if (kernel == KERNEL_SIMD)
+        {
+            float* t = oskar_mem_float(soa, status);
+            oskar_cross_correlate_jones_to_soa_f(num_sources, num_stations,
+                    J_, t);
+            oskar_cross_correlate_simd_omp_f(num_sources, num_stations, t,
+                    I_, Q_, U_, V_, l_, m_, n_, ext ? a_ : 0, b_, c_,
+                    u_, v_, w_, x_, y_, 0.0f, uv_max, inv_wavelength,
+                    frac_bw, t_ave, 0.0f, 0.0f, vis_);
+        }
+        else if (t_ave > 0.0 && ext)
+            oskar_cross_correlate_gaussian_time_smearing_omp_f(num_sources,
+                    num_stations, J_, I_, Q_, U_, V_, l_, m_, n_, a_, b_, c_,
+                    u_, v_, w_, x_, y_, 0.0f, uv_max, inv_wavelength,
+                    frac_bw, t_ave, 0.0f, 0.0f, vis_);
+        else if (t_ave > 0.0)
+            oskar_cross_correlate_point_time_smearing_omp_f(num_sources,
+                    num_stations, J_, I_, Q_, U_, V_, l_, m_, n_,
+                    u_, v_, w_, x_, y_, 0.0f, uv_max, inv_wavelength,
+                    frac_bw, t_ave, 0.0f, 0.0f, vis_);
+        else if (ext)
+            oskar_cross_correlate_gaussian_omp_f(num_sources, num_stations,
+                    J_, I_, Q_, U_, V_, l_, m_, n_, a_, b_, c_, u_, v_, w_,
+                    0.0f, uv_max, inv_wavelength, frac_bw, vis_);
+        else
+            oskar_cross_correlate_point_omp_f(num_sources, num_stations,
+                    J_, I_, Q_, U_, V_, l_, m_, n_, u_, v_, w_,
+                    0.0f, uv_max, inv_wavelength, frac_bw, vis_);
+    }
+}
+
 int benchmark(int num_stations, int num_sources, int type,
-        int jones_type, int loc, int use_extended, int use_time_ave, int niter,
-        std::vector<double>& times)
+        int jones_type, int loc, int use_extended, int use_time_ave,
+        int kernel, int niter, std::vector<double>& times)
 {
     int status = 0;
 
@@ -231,15 +377,33 @@ int benchmark(int num_stations, int num_sources, int type,
     v = oskar_mem_create(type, loc, num_stations, &status);
     w = oskar_mem_create(type, loc, num_stations, &status);
 
+    // Fill the Jones matrices and station coordinates with random data.
+    oskar_mem_random_range(oskar_jones_mem(J), 0.1, 1.0, &status);
+    oskar_mem_random_range(u, -1000.0, 1000.0, &status);
+    oskar_mem_random_range(v, -1000.0, 1000.0, &status);
+    oskar_mem_random_range(w, -100.0, 100.0, &status);
+
+    // Select the kernel to use.
+    if (loc != OSKAR_CPU || !oskar_mem_is_matrix(vis))
+        kernel = KERNEL_DEFAULT;
+    oskar_Mem* soa = oskar_mem_create(type, OSKAR_CPU,
+            kernel == KERNEL_SIMD ? 8 * num_sources * num_stations : 0,
+            &status);
+
     // Run benchmark.
     times.resize(niter);
     for (int i = 0; i < niter; ++i)
     {
         oskar_timer_start(timer);
-        oskar_cross_correlate(vis, oskar_sky_num_sources(sky), J, sky, tel, u, v, w,
-                0.0, 100e6, &status);
+        if (kernel == KERNEL_DEFAULT)
+            oskar_cross_correlate(vis, oskar_sky_num_sources(sky), J, sky,
+                    tel, u, v, w, 0.0, 100e6, &status);
+        else
+            correlate_cpu(kernel, vis, J, sky, tel, u, v, w, soa, 100e6,
+                    &status);
         times[i] = oskar_timer_elapsed(timer);
     }
+    oskar_mem_free(soa, &status);
 
     // Free memory.
     oskar_mem_free(u, &status);
@@ -199,6 +199,16 @@ char* const* oskar_imager_input_files(const oskar_Imager* h);
 OSKAR_EXPORT
 const char* oskar_imager_ms_column(const oskar_Imager* h);
 
+/**
+ * @brief
+ * Returns the number of CPU threads used for gridding.
+ *
+ * @details
+ * Returns the number of CPU threads used for gridding and for the FFT.
+ */
+OSKAR_EXPORT
+int oskar_imager_num_grid_threads(const oskar_Imager* h);
+
 /**
  * @brief
  * Returns the number of image planes in use.
@@ -275,6 +285,16 @@ int oskar_imager_plane_type(const oskar_Imager* h);
 OSKAR_EXPORT
 int oskar_imager_precision(const oskar_Imager* h);
 
+/**
+ * @brief
+ * Returns the number of visibility blocks to read ahead.
+ *
+ * @details
+ * Returns the number of visibility blocks to read ahead.
+ */
+OSKAR_EXPORT
+int oskar_imager_read_ahead(const oskar_Imager* h);
+
 /**
  * @brief
  * Returns the option to scale image normalisation by the number of input files.
@@ -600,6 +620,29 @@ void oskar_imager_set_ms_column(oskar_Imager* h, const char* column,
 OSKAR_EXPORT
 void oskar_imager_set_num_devices(oskar_Imager* h, int value);
 
+/**
+ * @brief
+ * Sets the number of CPU threads used for gridding.
+ *
+ * @details
+ * Sets the number of CPU threads used by the FFT and W-projection
+ * algorithms to grid visibility data, and to Fourier transform the grids.
+ * If this is less than 1, all available CPU cores will be used.
+ *
+ * If more than one thread is used, visibilities are sorted into tiles of
+ * the grid, and non-adjacent tiles are gridded concurrently.
+ * If there are at least as many image planes as threads, planes are
+ * gridded concurrently instead, but still using the tiled gridder.
+ * The result does not depend on the number of threads or image planes,
+ * but may differ very slightly from that obtained using a single thread,
+ * as visibilities are summed in a different order.
+ *
+ * @param[in,out] h          Handle to imager.
+ * @param[in]     value      Number of gridding threads to use.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_num_grid_threads(oskar_Imager* h, int value);
+
 /**
  * @brief
  * Sets the root path of output images.
@@ -627,6 +670,26 @@ void oskar_imager_set_output_root(oskar_Imager* h, const char* filename);
 OSKAR_EXPORT
 void oskar_imager_set_oversample(oskar_Imager* h, int value);
 
+/**
+ * @brief
+ * Sets the number of visibility blocks to read ahead.
+ *
+ * @details
+ * Sets the number of visibility blocks to read ahead when running the
+ * imager using oskar_imager_run().
+ *
+ * Blocks are read from input files in a separate thread, so that file
+ * input overlaps with gridding. The read thread can run up to this
+ * number of blocks ahead of the imager, and one buffer is needed
+ * for each, plus one for the block being gridded.
+ * If this is 0, blocks are read in the calling thread instead.
+ *
+ * @param[in,out] h          Handle to imager.
+ * @param[in]     value      Number of blocks to read ahead.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_read_ahead(oskar_Imager* h, int value);
+
 /**
  * @brief
  * Sets the option to scale image normalisation with number of input files.
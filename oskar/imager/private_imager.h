@@ -26,11 +26,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifdef OSKAR_HAVE_CUDA
-#include <cufft.h>
-#endif
-
 #include <fitsio.h>
+#include <math/oskar_fft.h>
 #include <mem/oskar_mem.h>
 #include <log/oskar_log.h>
 #include <utility/oskar_thread.h>
@@ -48,6 +45,15 @@ struct DeviceData
 };
 typedef struct DeviceData DeviceData;
 
+/* Scratch arrays used to select and weight the data for one plane.
+ * There is one set for each thread updating planes concurrently. */
+struct PlaneScratch
+{
+    oskar_Mem *uu_im, *vv_im, *ww_im, *vis_im, *weight_im, *time_im;
+    oskar_Mem *uu_tmp, *vv_tmp, *ww_tmp, *weight_tmp;
+};
+typedef struct PlaneScratch PlaneScratch;
+
 struct oskar_Imager
 {
     char* output_name[4];
@@ -58,6 +64,7 @@ struct oskar_Imager
 
     /* Settings parameters. */
     int imager_prec, num_devices, num_gpus, *gpu_ids, fft_on_gpu;
+    int num_grid_threads, read_ahead;
     int chan_snaps, im_type, num_im_channels, num_im_pols, pol_offset;
     int algorithm, image_size, use_stokes, support, oversample;
     int generate_w_kernels_on_gpu, set_cellsize, set_fov, weighting;
@@ -78,8 +85,9 @@ struct oskar_Imager
     oskar_Mutex* mutex;
 
     /* Scratch data. */
-    oskar_Mem *uu_im, *vv_im, *ww_im, *vis_im, *weight_im, *time_im;
-    oskar_Mem *uu_tmp, *vv_tmp, *ww_tmp, *stokes, *weight_tmp;
+    int num_scratch;
+    PlaneScratch* scratch;
+    oskar_Mem *stokes;
     int coords_only; /* Set if doing a first pass for uniform weighting. */
     int num_planes; /* For each output channel and polarisation. */
     double *plane_norm, delta_l, delta_m, delta_n, M[9];
@@ -90,10 +98,8 @@ struct oskar_Imager
 
     /* FFT imager data. */
     int grid_size;
-    oskar_Mem *conv_func, *corr_func, *fftpack_wsave, *fftpack_work;
-#ifdef OSKAR_HAVE_CUDA
-    cufftHandle cufft_plan;
-#endif
+    oskar_Mem *conv_func, *corr_func;
+    oskar_FFT* fft;
 
     /* W-projection imager data. */
     size_t ww_points;
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_IMAGER_GRID_TILES_H_
+#define OSKAR_IMAGER_GRID_TILES_H_
+
+/**
+ * @file private_imager_grid_tiles.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Visibility data sorted into square tiles of the grid. */
+struct oskar_GridTiles
+{
+    int tile_size, num_tiles_u, num_tiles_v;
+    size_t* tile_start; /* Index of first visibility in each tile. */
+    oskar_Mem *uu, *vv, *ww, *amp, *weight;
+};
+typedef struct oskar_GridTiles oskar_GridTiles;
+
+/**
+ * @brief
+ * Sorts visibility data into tiles of the grid, for parallel gridding.
+ *
+ * @details
+ * Sorts visibility data according to the grid tile containing the
+ * centre of the convolution kernel for each visibility.
+ * Visibilities keep their original order within each tile.
+ *
+ * Tiles are at least 2 * (max_support + 1) cells wide, so the kernels
+ * for visibilities in two tiles that are not adjacent never overlap.
+ * Tiles can therefore be gridded concurrently in four passes, choosing
+ * tiles with the same parity in both u and v in each pass.
+ * The tile size does not depend on the number of threads, so that the
+ * gridded result does not either.
+ *
+ * Visibilities for tile t are stored from index tile_start[t] to
+ * tile_start[t + 1] - 1 of the sorted arrays.
+ *
+ * @param[in] h            Handle to imager.
+ * @param[in] max_support  Largest convolution kernel support size.
+ * @param[in] num_vis      Number of visibilities.
+ * @param[in] uu           Baseline uu coordinates, in wavelengths.
+ * @param[in] vv           Baseline vv coordinates, in wavelengths.
+ * @param[in] ww           Baseline ww coordinates, in wavelengths
+ *                         (may be NULL).
+ * @param[in] amp          Baseline complex visibility amplitudes.
+ * @param[in] weight       Baseline visibility weights.
+ * @param[out] tiles       Sorted visibility data.
+ * @param[in,out] status   Status return code.
+ */
+void oskar_imager_grid_tiles_sort(oskar_Imager* h, int max_support,
+        size_t num_vis, const oskar_Mem* uu, const oskar_Mem* vv,
+        const oskar_Mem* ww, const oskar_Mem* amp, const oskar_Mem* weight,
+        oskar_GridTiles* tiles, int* status);
+
+/**
+ * @brief
+ * Frees memory held by sorted visibility data.
+ *
+ * @param[in,out] tiles    Sorted visibility data.
+ * @param[in,out] status   Status return code.
+ */
+void oskar_imager_grid_tiles_free(oskar_GridTiles* tiles, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_IMAGER_GRID_TILES_H_ */
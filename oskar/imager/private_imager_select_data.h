@@ -36,6 +36,13 @@
 extern "C" {
 #endif
 
+/*
+ * If frequency synthesis selects more than one channel, and the selected
+ * channels are equally spaced, num_channels_out is set to the number of
+ * selected channels, and scale_inc to the relative increment in the
+ * baseline coordinates from one selected channel to the next.
+ * Otherwise num_channels_out is set to 1 and scale_inc to 0.
+ */
 void oskar_imager_select_data(
         const oskar_Imager* h,
         size_t num_rows,
@@ -57,6 +64,8 @@ void oskar_imager_select_data(
         oskar_Mem* vis_out,
         oskar_Mem* weight_out,
         oskar_Mem* time_out,
+        int* num_channels_out,
+        double* scale_inc,
         int* status);
 
 #ifdef __cplusplus
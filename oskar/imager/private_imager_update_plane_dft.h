@@ -36,10 +36,17 @@
 extern "C" {
 #endif
 
+/*
+ * If num_channels > 1, the visibilities are from equally spaced channels,
+ * with dimension order (slowest) channel, baseline (fastest), and the
+ * baseline coordinates of channel c are those of channel 0 scaled by
+ * (1 + c * scale_inc).
+ */
 void oskar_imager_update_plane_dft(oskar_Imager* h, size_t num_vis,
-        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
-        const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* plane,
-        double* plane_norm, int* status);
+        int num_channels, double scale_inc, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, oskar_Mem* plane, double* plane_norm,
+        int* status);
 
 #ifdef __cplusplus
 }
@@ -39,7 +39,7 @@ extern "C" {
 void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
         const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
         const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* plane,
-        double* plane_norm, size_t* num_skipped, int* status);
+        double* plane_norm, size_t* num_skipped, int num_threads, int* status);
 
 #ifdef __cplusplus
 }
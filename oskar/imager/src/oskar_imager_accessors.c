@@ -148,6 +148,12 @@ const char* oskar_imager_ms_column(const oskar_Imager* h)
 }
 
 
+int oskar_imager_num_grid_threads(const oskar_Imager* h)
+{
+    return h->num_grid_threads;
+}
+
+
 int oskar_imager_num_image_planes(const oskar_Imager* h)
 {
     return h->num_planes;
@@ -209,6 +215,12 @@ int oskar_imager_precision(const oskar_Imager* h)
 }
 
 
+int oskar_imager_read_ahead(const oskar_Imager* h)
+{
+    return h->read_ahead;
+}
+
+
 int oskar_imager_scale_norm_with_num_input_files(const oskar_Imager* h)
 {
     return h->scale_norm_with_num_input_files;
@@ -520,6 +532,14 @@ void oskar_imager_set_num_devices(oskar_Imager* h, int value)
 }
 
 
+void oskar_imager_set_num_grid_threads(oskar_Imager* h, int value)
+{
+    if (value < 1) value = oskar_get_num_procs();
+    if (value < 1) value = 1;
+    h->num_grid_threads = value;
+}
+
+
 void oskar_imager_set_output_root(oskar_Imager* h, const char* filename)
 {
     int len = 0;
@@ -540,6 +560,12 @@ void oskar_imager_set_oversample(oskar_Imager* h, int value)
 }
 
 
+void oskar_imager_set_read_ahead(oskar_Imager* h, int value)
+{
+    h->read_ahead = value > 0 ? value : 0;
+}
+
+
 void oskar_imager_set_scale_norm_with_num_input_files(oskar_Imager* h,
         int value)
 {
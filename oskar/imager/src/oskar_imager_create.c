@@ -52,19 +52,8 @@ oskar_Imager* oskar_imager_create(int imager_precision, int* status)
     h->tmr_write = oskar_timer_create(OSKAR_TIMER_NATIVE);
     h->mutex = oskar_mutex_create();
 
-    /* Create scratch arrays. */
+    /* Set precision. Scratch arrays are created when needed. */
     h->imager_prec = imager_precision;
-    h->uu_im       = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->vv_im       = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->ww_im       = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->uu_tmp      = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->vv_tmp      = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->ww_tmp      = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->vis_im      = oskar_mem_create(imager_precision | OSKAR_COMPLEX,
-            OSKAR_CPU, 0, status);
-    h->weight_im   = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->weight_tmp  = oskar_mem_create(imager_precision, OSKAR_CPU, 0, status);
-    h->time_im     = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
 
     /* Check data type. */
     if (imager_precision != OSKAR_SINGLE && imager_precision != OSKAR_DOUBLE)
@@ -76,6 +65,8 @@ oskar_Imager* oskar_imager_create(int imager_precision, int* status)
     /* Set sensible defaults. */
     oskar_imager_set_gpus(h, -1, 0, status);
     oskar_imager_set_num_devices(h, -1);
+    oskar_imager_set_num_grid_threads(h, -1);
+    oskar_imager_set_read_ahead(h, 2);
     oskar_imager_set_algorithm(h, "FFT", status);
     oskar_imager_set_image_type(h, "I", status);
     oskar_imager_set_weighting(h, "Natural", status);
@@ -44,16 +44,6 @@ void oskar_imager_free(oskar_Imager* h, int* status)
     int i;
     if (!h) return;
     oskar_imager_reset_cache(h, status);
-    oskar_mem_free(h->uu_im, status);
-    oskar_mem_free(h->vv_im, status);
-    oskar_mem_free(h->ww_im, status);
-    oskar_mem_free(h->uu_tmp, status);
-    oskar_mem_free(h->vv_tmp, status);
-    oskar_mem_free(h->ww_tmp, status);
-    oskar_mem_free(h->vis_im, status);
-    oskar_mem_free(h->weight_im, status);
-    oskar_mem_free(h->weight_tmp, status);
-    oskar_mem_free(h->time_im, status);
     oskar_timer_free(h->tmr_grid_finalise);
     oskar_timer_free(h->tmr_grid_update);
     oskar_timer_free(h->tmr_init);
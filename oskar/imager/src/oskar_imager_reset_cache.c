@@ -26,12 +26,9 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifdef OSKAR_HAVE_CUDA
-#include <cufft.h>
-#endif
-
 #include "imager/private_imager.h"
 #include "imager/oskar_imager_reset_cache.h"
+#include "imager/private_imager_set_num_scratch.h"
 #include <fitsio.h>
 
 #include <stdlib.h>
@@ -54,15 +51,9 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
 
     /* Clear FFT caches. */
     oskar_mem_free(h->corr_func, status);
-    oskar_mem_free(h->fftpack_wsave, status);
-    oskar_mem_free(h->fftpack_work, status);
-#ifdef OSKAR_HAVE_CUDA
-    cufftDestroy(h->cufft_plan);
-    h->cufft_plan = 0;
-#endif
+    oskar_fft_free(h->fft);
     h->corr_func = 0;
-    h->fftpack_wsave = 0;
-    h->fftpack_work = 0;
+    h->fft = 0;
 
     /* Clear algorithm-specific caches. */
     oskar_mem_free(h->l, status); h->l = 0;
@@ -88,17 +79,8 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
     free(h->weights_grids);
     h->weights_grids = 0;
 
-    /* Collapse temp arrays. */
-    oskar_mem_realloc(h->uu_im, 0, status);
-    oskar_mem_realloc(h->vv_im, 0, status);
-    oskar_mem_realloc(h->ww_im, 0, status);
-    oskar_mem_realloc(h->uu_tmp, 0, status);
-    oskar_mem_realloc(h->vv_tmp, 0, status);
-    oskar_mem_realloc(h->ww_tmp, 0, status);
-    oskar_mem_realloc(h->vis_im, 0, status);
-    oskar_mem_realloc(h->weight_im, 0, status);
-    oskar_mem_realloc(h->weight_tmp, 0, status);
-    oskar_mem_realloc(h->time_im, 0, status);
+    /* Free scratch arrays. */
+    oskar_imager_set_num_scratch(h, 0, status);
     oskar_mem_free(h->stokes, status);
     h->stokes = 0;
 
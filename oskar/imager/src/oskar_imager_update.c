@@ -35,6 +35,7 @@
 #include "imager/private_imager_filter_time.h"
 #include "imager/private_imager_filter_uv.h"
 #include "imager/private_imager_set_num_planes.h"
+#include "imager/private_imager_set_num_scratch.h"
 #include "imager/private_imager_select_data.h"
 #include "imager/private_imager_update_plane_dft.h"
 #include "imager/private_imager_update_plane_fft.h"
@@ -46,11 +47,27 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 static void oskar_imager_allocate_planes(oskar_Imager* h, int *status);
+static void oskar_imager_update_plane_from_rows(oskar_Imager* h,
+        PlaneScratch* s, int c, int p, int num_threads, size_t num_rows,
+        int start_chan, int end_chan, int num_pols, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, const oskar_Mem* time_centroid,
+        int* status);
+static void update_plane(oskar_Imager* h, size_t num_vis,
+        int num_channels, double scale_inc,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* weight_tmp,
+        int num_threads, oskar_Mem* plane, double* plane_norm,
+        oskar_Mem* weights_grid, int* status);
 static void oskar_imager_update_weights_grid(oskar_Imager* h,
         size_t num_points, const oskar_Mem* uu, const oskar_Mem* vv,
         const oskar_Mem* ww, const oskar_Mem* weight, oskar_Mem* weights_grid,
@@ -179,7 +196,7 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
         const oskar_Mem* ww, const oskar_Mem* amps, const oskar_Mem* weight,
         const oskar_Mem* time_centroid, int* status)
 {
-    int c, p, plane;
+    int i, plane, num_planes, num_threads, *plane_status = 0;
     size_t max_num_vis;
     oskar_Mem *tu = 0, *tv = 0, *tw = 0, *ta = 0, *th = 0;
     const oskar_Mem *u_in, *v_in, *w_in, *amp_in = 0, *weight_in;
@@ -247,77 +264,77 @@ void oskar_imager_update(oskar_Imager* h, size_t num_rows, int start_chan,
         weight_in = th;
     }
 
-    /* Ensure work arrays are large enough. */
+    /* Update planes concurrently if there are enough of them to keep the
+     * grid threads busy. Otherwise, update them in turn, and use the
+     * threads to grid each one. The DFT uses all the devices for each plane,
+     * and the coordinate-only pass accumulates W statistics in the imager,
+     * so in these cases the planes are always updated in turn.
+     * Either way, each plane goes through the same (tiled) gridder if more
+     * than one grid thread is set, so the result for a plane does not
+     * depend on the number of planes. */
+    num_planes = h->num_im_channels * h->num_im_pols;
+    num_threads = 1;
+    if (!h->coords_only && num_planes >= h->num_grid_threads &&
+            (h->algorithm == OSKAR_ALGORITHM_FFT ||
+                    h->algorithm == OSKAR_ALGORITHM_WPROJ))
+        num_threads = h->num_grid_threads;
+
+    /* Ensure each thread has work arrays that are large enough. */
     max_num_vis = num_rows;
     if (!h->chan_snaps) max_num_vis *= (1 + end_chan - start_chan);
-    oskar_mem_realloc(h->uu_im, max_num_vis, status);
-    oskar_mem_realloc(h->vv_im, max_num_vis, status);
-    oskar_mem_realloc(h->ww_im, max_num_vis, status);
-    oskar_mem_realloc(h->vis_im, max_num_vis, status);
-    oskar_mem_realloc(h->weight_im, max_num_vis, status);
-    if (h->direction_type == 'R')
+    oskar_imager_set_num_scratch(h, num_threads, status);
+    for (i = 0; i < num_threads && !*status; ++i)
     {
-        oskar_mem_realloc(h->uu_tmp, max_num_vis, status);
-        oskar_mem_realloc(h->vv_tmp, max_num_vis, status);
-        oskar_mem_realloc(h->ww_tmp, max_num_vis, status);
+        PlaneScratch* s = &h->scratch[i];
+        oskar_mem_realloc(s->uu_im, max_num_vis, status);
+        oskar_mem_realloc(s->vv_im, max_num_vis, status);
+        oskar_mem_realloc(s->ww_im, max_num_vis, status);
+        oskar_mem_realloc(s->vis_im, max_num_vis, status);
+        oskar_mem_realloc(s->weight_im, max_num_vis, status);
+        if (h->direction_type == 'R')
+        {
+            oskar_mem_realloc(s->uu_tmp, max_num_vis, status);
+            oskar_mem_realloc(s->vv_tmp, max_num_vis, status);
+            oskar_mem_realloc(s->ww_tmp, max_num_vis, status);
+        }
     }
+    plane_status = (int*) calloc(num_planes, sizeof(int));
+    if (!plane_status && !*status)
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
 
     /* Loop over each image plane being made. */
-    for (c = 0; c < h->num_im_channels; ++c)
+    oskar_timer_resume(h->tmr_grid_update);
+    if (num_threads > 1 && !*status)
     {
-        for (p = 0; p < h->num_im_pols; ++p)
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (plane = 0; plane < num_planes; ++plane)
         {
-            oskar_Mem *pu, *pv, *pw;
-            size_t num_vis = 0;
-            if (*status) break;
-
-            /* Get all visibility data needed to update this plane. */
-            pu = h->uu_im; pv = h->vv_im; pw = h->ww_im;
-            if (h->direction_type == 'R')
-            {
-                pu = h->uu_tmp; pv = h->vv_tmp; pw = h->ww_tmp;
-            }
-            oskar_imager_select_data(h, num_rows, start_chan, end_chan,
-                    num_pols, u_in, v_in, w_in, amp_in, weight_in,
-                    time_centroid, h->im_freqs[c], p,
-                    &num_vis, pu, pv, pw, h->vis_im, h->weight_im,
-                    h->time_im, status);
-
-            /* Skip if nothing was selected. */
-            if (num_vis == 0) continue;
-
-            /* Rotate baseline coordinates if required. */
-            if (h->direction_type == 'R')
-                oskar_imager_rotate_coords(h, num_vis,
-                        h->uu_tmp, h->vv_tmp, h->ww_tmp,
-                        h->uu_im, h->vv_im, h->ww_im);
-
-            /* Overwrite visibilities if making PSF, or phase rotate. */
-            if (h->im_type == OSKAR_IMAGE_TYPE_PSF)
-                oskar_mem_set_value_real(h->vis_im, 1.0, 0, 0, status);
-            else if (h->direction_type == 'R' && !h->coords_only)
-                oskar_imager_rotate_vis(h, num_vis,
-                        h->uu_tmp, h->vv_tmp, h->ww_tmp, h->vis_im);
-
-            /* Apply time and baseline length filters if required. */
-            oskar_imager_filter_time(h, &num_vis, h->uu_im, h->vv_im,
-                    h->ww_im, h->vis_im, h->weight_im, h->time_im, status);
-            oskar_imager_filter_uv(h, &num_vis, h->uu_im, h->vv_im,
-                    h->ww_im, h->vis_im, h->weight_im, status);
-
-            /* Update this image plane with the visibilities. */
-            plane = h->num_im_pols * c + p;
-            if (h->coords_only)
-                oskar_imager_update_plane(h, num_vis, h->uu_im, h->vv_im,
-                        h->ww_im, 0, h->weight_im, 0, 0,
-                        h->weights_grids[plane], status);
-            else
-                oskar_imager_update_plane(h, num_vis, h->uu_im, h->vv_im,
-                        h->ww_im, h->vis_im, h->weight_im,
-                        h->planes[plane], &h->plane_norm[plane],
-                        h->weights_grids[plane], status);
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            oskar_imager_update_plane_from_rows(h, &h->scratch[thread],
+                    plane / h->num_im_pols, plane % h->num_im_pols, 1,
+                    num_rows, start_chan, end_chan, num_pols, u_in, v_in,
+                    w_in, amp_in, weight_in, time_centroid,
+                    &plane_status[plane]);
         }
     }
+    else
+    {
+        for (plane = 0; plane < num_planes && !*status; ++plane)
+            oskar_imager_update_plane_from_rows(h, &h->scratch[0],
+                    plane / h->num_im_pols, plane % h->num_im_pols,
+                    h->num_grid_threads, num_rows, start_chan, end_chan,
+                    num_pols, u_in, v_in, w_in, amp_in, weight_in,
+                    time_centroid, status);
+    }
+    oskar_timer_pause(h->tmr_grid_update);
+
+    /* Report the first error, in plane order. */
+    for (plane = 0; plane < num_planes && plane_status; ++plane)
+        if (!*status) *status = plane_status[plane];
+    free(plane_status);
 
     oskar_mem_free(tu, status);
     oskar_mem_free(tv, status);
@@ -331,11 +348,96 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
         const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
         const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* plane,
         double* plane_norm, oskar_Mem* weights_grid, int* status)
+{
+    if (*status || num_vis == 0) return;
+    oskar_timer_resume(h->tmr_grid_update);
+    oskar_imager_check_init(h, status);
+    oskar_imager_set_num_scratch(h, 1, status);
+    if (!*status)
+        update_plane(h, num_vis, 1, 0.0, uu, vv, ww, amps, weight,
+                h->scratch[0].weight_tmp, h->num_grid_threads,
+                plane, plane_norm, weights_grid, status);
+    oskar_timer_pause(h->tmr_grid_update);
+}
+
+
+static void oskar_imager_update_plane_from_rows(oskar_Imager* h,
+        PlaneScratch* s, int c, int p, int num_threads, size_t num_rows,
+        int start_chan, int end_chan, int num_pols, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, const oskar_Mem* time_centroid,
+        int* status)
+{
+    int plane, num_channels = 1;
+    size_t num_vis = 0, num_selected;
+    double scale_inc = 0.0;
+    oskar_Mem *pu, *pv, *pw;
+    if (*status) return;
+
+    /* Get all visibility data needed to update this plane. */
+    pu = s->uu_im; pv = s->vv_im; pw = s->ww_im;
+    if (h->direction_type == 'R')
+    {
+        pu = s->uu_tmp; pv = s->vv_tmp; pw = s->ww_tmp;
+    }
+    oskar_imager_select_data(h, num_rows, start_chan, end_chan,
+            num_pols, uu, vv, ww, amps, weight, time_centroid,
+            h->im_freqs[c], p, &num_vis, pu, pv, pw, s->vis_im,
+            s->weight_im, s->time_im, &num_channels, &scale_inc, status);
+
+    /* Skip if nothing was selected. */
+    if (num_vis == 0) return;
+    num_selected = num_vis;
+
+    /* Rotate baseline coordinates if required. */
+    if (h->direction_type == 'R')
+        oskar_imager_rotate_coords(h, num_vis,
+                s->uu_tmp, s->vv_tmp, s->ww_tmp,
+                s->uu_im, s->vv_im, s->ww_im);
+
+    /* Overwrite visibilities if making PSF, or phase rotate. */
+    if (h->im_type == OSKAR_IMAGE_TYPE_PSF)
+        oskar_mem_set_value_real(s->vis_im, 1.0, 0, 0, status);
+    else if (h->direction_type == 'R' && !h->coords_only)
+        oskar_imager_rotate_vis(h, num_vis,
+                s->uu_tmp, s->vv_tmp, s->ww_tmp, s->vis_im);
+
+    /* Apply time and baseline length filters if required. */
+    oskar_imager_filter_time(h, &num_vis, s->uu_im, s->vv_im,
+            s->ww_im, s->vis_im, s->weight_im, s->time_im, status);
+    oskar_imager_filter_uv(h, &num_vis, s->uu_im, s->vv_im,
+            s->ww_im, s->vis_im, s->weight_im, status);
+    if (num_vis == 0) return;
+
+    /* The DFT can only share phase terms between equally spaced channels
+     * if the filters did not remove any visibilities. */
+    if (num_vis != num_selected) num_channels = 1;
+
+    /* Update this image plane with the visibilities. */
+    plane = h->num_im_pols * c + p;
+    if (h->coords_only)
+        update_plane(h, num_vis, num_channels, scale_inc,
+                s->uu_im, s->vv_im, s->ww_im, 0,
+                s->weight_im, s->weight_tmp, num_threads, 0, 0,
+                h->weights_grids[plane], status);
+    else
+        update_plane(h, num_vis, num_channels, scale_inc,
+                s->uu_im, s->vv_im, s->ww_im, s->vis_im,
+                s->weight_im, s->weight_tmp, num_threads, h->planes[plane],
+                &h->plane_norm[plane], h->weights_grids[plane], status);
+}
+
+
+static void update_plane(oskar_Imager* h, size_t num_vis,
+        int num_channels, double scale_inc,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* weight_tmp,
+        int num_threads, oskar_Mem* plane, double* plane_norm,
+        oskar_Mem* weights_grid, int* status)
 {
     oskar_Mem *tu = 0, *tv = 0, *tw = 0, *ta = 0, *th = 0;
     const oskar_Mem *pu, *pv, *pw, *pa, *ph;
     if (*status || num_vis == 0) return;
-    oskar_timer_resume(h->tmr_grid_update);
 
     /* Convert precision of input data if required. */
     pu = uu; pv = vv; pw = ww; ph = weight;
@@ -378,9 +480,6 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
             pa = ta;
         }
 
-        /* Check imager is ready. */
-        oskar_imager_check_init(h, status);
-
         /* Re-weight visibilities if required. */
         switch (h->weighting)
         {
@@ -388,15 +487,15 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
             /* Nothing to do. */
             break;
         case OSKAR_WEIGHTING_RADIAL:
-            oskar_imager_weight_radial(num_vis, pu, pv, ph, h->weight_tmp,
+            oskar_imager_weight_radial(num_vis, pu, pv, ph, weight_tmp,
                     status);
-            ph = h->weight_tmp;
+            ph = weight_tmp;
             break;
         case OSKAR_WEIGHTING_UNIFORM:
-            oskar_imager_weight_uniform(num_vis, pu, pv, ph, h->weight_tmp,
+            oskar_imager_weight_uniform(num_vis, pu, pv, ph, weight_tmp,
                     h->cellsize_rad, oskar_imager_plane_size(h), weights_grid,
                     status);
-            ph = h->weight_tmp;
+            ph = weight_tmp;
             break;
         default:
             *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
@@ -408,16 +507,16 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
         {
         case OSKAR_ALGORITHM_DFT_2D:
         case OSKAR_ALGORITHM_DFT_3D:
-            oskar_imager_update_plane_dft(h, num_vis, pu, pv, pw, pa, ph,
-                    plane, plane_norm, status);
+            oskar_imager_update_plane_dft(h, num_vis, num_channels,
+                    scale_inc, pu, pv, pw, pa, ph, plane, plane_norm, status);
             break;
         case OSKAR_ALGORITHM_FFT:
             oskar_imager_update_plane_fft(h, num_vis, pu, pv, pa, ph,
-                    plane, plane_norm, &num_skipped, status);
+                    plane, plane_norm, &num_skipped, num_threads, status);
             break;
         case OSKAR_ALGORITHM_WPROJ:
             oskar_imager_update_plane_wproj(h, num_vis, pu, pv, pw, pa, ph,
-                    plane, plane_norm, &num_skipped, status);
+                    plane, plane_norm, &num_skipped, num_threads, status);
             break;
         default:
             *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
@@ -435,7 +534,6 @@ void oskar_imager_update_plane(oskar_Imager* h, size_t num_vis,
     oskar_mem_free(tw, status);
     oskar_mem_free(ta, status);
     oskar_mem_free(th, status);
-    oskar_timer_pause(h->tmr_grid_update);
 }
 
 
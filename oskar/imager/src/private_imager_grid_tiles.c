@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/oskar_imager.h"
+
+#include "imager/private_imager_grid_tiles.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIN_TILE_SIZE 64
+
+static int tile_coord(int grid_pos, int grid_size, int tile_size)
+{
+    if (grid_pos < 0) grid_pos = 0;
+    if (grid_pos >= grid_size) grid_pos = grid_size - 1;
+    return grid_pos / tile_size;
+}
+
+static void tile_index_d(size_t num_vis, const double* uu, const double* vv,
+        double grid_scale, int grid_size, int tile_size, int num_tiles_u,
+        int* tile)
+{
+    size_t i;
+    const int grid_centre = grid_size / 2;
+    for (i = 0; i < num_vis; ++i)
+    {
+        /* Same rounding as the gridding kernels, but clamped to the grid. */
+        const double pos_u = round(-uu[i] * grid_scale) + grid_centre;
+        const double pos_v = round(vv[i] * grid_scale) + grid_centre;
+        const int grid_u = pos_u < 0.0 ? -1 :
+                (pos_u < grid_size ? (int)pos_u : grid_size);
+        const int grid_v = pos_v < 0.0 ? -1 :
+                (pos_v < grid_size ? (int)pos_v : grid_size);
+        tile[i] = tile_coord(grid_u, grid_size, tile_size) +
+                num_tiles_u * tile_coord(grid_v, grid_size, tile_size);
+    }
+}
+
+static void tile_index_f(size_t num_vis, const float* uu, const float* vv,
+        float grid_scale, int grid_size, int tile_size, int num_tiles_u,
+        int* tile)
+{
+    size_t i;
+    const int grid_centre = grid_size / 2;
+    for (i = 0; i < num_vis; ++i)
+    {
+        /* Same rounding as the gridding kernels, but clamped to the grid. */
+        const float pos_u = roundf(-uu[i] * grid_scale) + grid_centre;
+        const float pos_v = roundf(vv[i] * grid_scale) + grid_centre;
+        const int grid_u = pos_u < 0.0f ? -1 :
+                (pos_u < grid_size ? (int)pos_u : grid_size);
+        const int grid_v = pos_v < 0.0f ? -1 :
+                (pos_v < grid_size ? (int)pos_v : grid_size);
+        tile[i] = tile_coord(grid_u, grid_size, tile_size) +
+                num_tiles_u * tile_coord(grid_v, grid_size, tile_size);
+    }
+}
+
+static void scatter(size_t num_vis, const int* tile, size_t* offset,
+        size_t element_size, const void* in, void* out)
+{
+    size_t i;
+    const char* p_in = (const char*) in;
+    char* p_out = (char*) out;
+    for (i = 0; i < num_vis; ++i)
+        memcpy(p_out + element_size * offset[tile[i]]++,
+                p_in + element_size * i, element_size);
+}
+
+static oskar_Mem* sorted_copy(size_t num_vis, const int* tile,
+        const size_t* tile_start, size_t* offset, int num_tiles,
+        const oskar_Mem* in, int* status)
+{
+    oskar_Mem* out;
+    if (*status || !in) return 0;
+    out = oskar_mem_create(oskar_mem_type(in), OSKAR_CPU, num_vis, status);
+    if (*status) return out;
+    memcpy(offset, tile_start, num_tiles * sizeof(size_t));
+    scatter(num_vis, tile, offset, oskar_mem_element_size(oskar_mem_type(in)),
+            oskar_mem_void_const(in), oskar_mem_void(out));
+    return out;
+}
+
+void oskar_imager_grid_tiles_sort(oskar_Imager* h, int max_support,
+        size_t num_vis, const oskar_Mem* uu, const oskar_Mem* vv,
+        const oskar_Mem* ww, const oskar_Mem* amp, const oskar_Mem* weight,
+        oskar_GridTiles* tiles, int* status)
+{
+    int i, grid_size, num_tiles, *tile;
+    size_t j, *offset;
+    memset(tiles, 0, sizeof(oskar_GridTiles));
+    if (*status) return;
+
+    /* Choose the tile size and allocate scratch arrays. */
+    grid_size = oskar_imager_plane_size(h);
+    tiles->tile_size = 2 * (max_support + 1);
+    if (tiles->tile_size < MIN_TILE_SIZE)
+        tiles->tile_size = MIN_TILE_SIZE;
+    tiles->num_tiles_u = (grid_size + tiles->tile_size - 1) / tiles->tile_size;
+    tiles->num_tiles_v = tiles->num_tiles_u;
+    num_tiles = tiles->num_tiles_u * tiles->num_tiles_v;
+    tiles->tile_start = (size_t*) calloc(num_tiles + 1, sizeof(size_t));
+    offset = (size_t*) calloc(num_tiles, sizeof(size_t));
+    tile = (int*) malloc((num_vis + 1) * sizeof(int));
+    if (!tiles->tile_start || !offset || !tile)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        free(offset);
+        free(tile);
+        return;
+    }
+
+    /* Find the tile containing each visibility. */
+    if (oskar_mem_precision(uu) == OSKAR_DOUBLE)
+        tile_index_d(num_vis, oskar_mem_double_const(uu, status),
+                oskar_mem_double_const(vv, status),
+                grid_size * h->cellsize_rad, grid_size,
+                tiles->tile_size, tiles->num_tiles_u, tile);
+    else
+        tile_index_f(num_vis, oskar_mem_float_const(uu, status),
+                oskar_mem_float_const(vv, status),
+                (float) (grid_size * (float) (h->cellsize_rad)), grid_size,
+                tiles->tile_size, tiles->num_tiles_u, tile);
+
+    /* Counting sort, keeping the original order within each tile. */
+    for (j = 0; j < num_vis; ++j) tiles->tile_start[tile[j] + 1]++;
+    for (i = 0; i < num_tiles; ++i)
+        tiles->tile_start[i + 1] += tiles->tile_start[i];
+    tiles->uu = sorted_copy(num_vis, tile, tiles->tile_start, offset,
+            num_tiles, uu, status);
+    tiles->vv = sorted_copy(num_vis, tile, tiles->tile_start, offset,
+            num_tiles, vv, status);
+    tiles->ww = sorted_copy(num_vis, tile, tiles->tile_start, offset,
+            num_tiles, ww, status);
+    tiles->amp = sorted_copy(num_vis, tile, tiles->tile_start, offset,
+            num_tiles, amp, status);
+    tiles->weight = sorted_copy(num_vis, tile, tiles->tile_start, offset,
+            num_tiles, weight, status);
+    free(offset);
+    free(tile);
+}
+
+void oskar_imager_grid_tiles_free(oskar_GridTiles* tiles, int* status)
+{
+    free(tiles->tile_start);
+    oskar_mem_free(tiles->uu, status);
+    oskar_mem_free(tiles->vv, status);
+    oskar_mem_free(tiles->ww, status);
+    oskar_mem_free(tiles->amp, status);
+    oskar_mem_free(tiles->weight, status);
+    memset(tiles, 0, sizeof(oskar_GridTiles));
+}
+
+#ifdef __cplusplus
+}
+#endif
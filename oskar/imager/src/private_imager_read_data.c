@@ -35,6 +35,7 @@
 #include "ms/oskar_measurement_set.h"
 #include "vis/oskar_vis_block.h"
 #include "vis/oskar_vis_header.h"
+#include "utility/oskar_thread.h"
 #include "utility/oskar_timer.h"
 
 #include <float.h>
@@ -46,114 +47,291 @@
 extern "C" {
 #endif
 
+/*
+ * Blocks are read into a ring of buffers by a separate thread, so that
+ * reading the next blocks overlaps with gridding the current one.
+ * The reader can run up to h->read_ahead blocks ahead of the imager.
+ * If this is zero, blocks are read in the calling thread instead.
+ */
+
+typedef void (*ReadBlockFunc)(void* reader, int block, int slot, int* status);
+
+struct ReadAhead
+{
+    oskar_ConditionVar* cond;
+    oskar_Thread* thread;
+    ReadBlockFunc read;
+    void* reader;
+    int num_slots, num_blocks, num_read, num_used, stop, status;
+};
+typedef struct ReadAhead ReadAhead;
+
+static void* read_ahead_run(void* arg)
+{
+    ReadAhead* q = (ReadAhead*) arg;
+    int b, stop = 0;
+    for (b = 0; b < q->num_blocks && !stop; ++b)
+    {
+        int status = 0;
+
+        /* Wait until the buffer for this block has been used. */
+        oskar_condition_lock(q->cond);
+        while (!q->stop && b - q->num_used >= q->num_slots)
+            oskar_condition_wait(q->cond);
+        stop = q->stop;
+        oskar_condition_unlock(q->cond);
+        if (stop) break;
+
+        /* Read the block, and then tell the imager about it.
+         * This must be done even on error, to avoid deadlock. */
+        q->read(q->reader, b, b % q->num_slots, &status);
+        oskar_condition_lock(q->cond);
+        if (status)
+        {
+            q->status = status;
+            q->stop = stop = 1;
+        }
+        q->num_read = b + 1;
+        oskar_condition_notify_all(q->cond);
+        oskar_condition_unlock(q->cond);
+    }
+    return 0;
+}
+
+/* Returns the number of buffers to use. */
+static int read_ahead_num_slots(const oskar_Imager* h, int num_blocks)
+{
+    const int num_slots = 1 + (h->read_ahead > 0 ? h->read_ahead : 0);
+    if (num_blocks < 1) return 1;
+    return num_slots < num_blocks ? num_slots : num_blocks;
+}
+
+static void read_ahead_start(ReadAhead* q, int num_slots, int num_blocks,
+        ReadBlockFunc read, void* reader, int* status)
+{
+    memset(q, 0, sizeof(ReadAhead));
+    q->read = read;
+    q->reader = reader;
+    q->num_blocks = num_blocks;
+    q->num_slots = num_slots;
+    if (num_slots > 1 && !*status)
+    {
+        q->cond = oskar_condition_create();
+        q->thread = oskar_thread_create(read_ahead_run, (void*)q, 0);
+    }
+}
+
+/* Returns the buffer index holding the block, reading it if required. */
+static int read_ahead_wait(ReadAhead* q, int block, int* status)
+{
+    if (*status) return -1;
+    if (!q->thread)
+    {
+        q->read(q->reader, block, 0, status);
+        return 0;
+    }
+    oskar_condition_lock(q->cond);
+    while (!q->stop && q->num_read <= block)
+        oskar_condition_wait(q->cond);
+    if (q->status) *status = q->status;
+    oskar_condition_unlock(q->cond);
+    return *status ? -1 : block % q->num_slots;
+}
+
+/* Tells the reader that the buffer holding the block can be re-used. */
+static void read_ahead_release(ReadAhead* q, int block)
+{
+    if (!q->thread) return;
+    oskar_condition_lock(q->cond);
+    q->num_used = block + 1;
+    oskar_condition_notify_all(q->cond);
+    oskar_condition_unlock(q->cond);
+}
+
+static void read_ahead_stop(ReadAhead* q)
+{
+    if (!q->thread) return;
+    oskar_condition_lock(q->cond);
+    q->stop = 1;
+    oskar_condition_notify_all(q->cond);
+    oskar_condition_unlock(q->cond);
+    oskar_thread_join(q->thread);
+    oskar_thread_free(q->thread);
+    oskar_condition_free(q->cond);
+    q->thread = 0;
+    q->cond = 0;
+}
+
+static void update_percent_done(oskar_Imager* h, double fraction,
+        int* percent_done, int* percent_next)
+{
+    *percent_done = (int) round(100.0 * fraction);
+    if (h->log && percent_next && *percent_done >= *percent_next)
+    {
+        oskar_log_message(h->log, 'S', -2, "%3d%% ...", *percent_done);
+        *percent_next = 10 + 10 * (*percent_done / 10);
+    }
+}
+
+
+#ifndef OSKAR_NO_MS
+struct MsBuffer
+{
+    oskar_Mem *uvw, *u, *v, *w, *data, *weight, *time_centroid;
+    size_t block_size;
+};
+typedef struct MsBuffer MsBuffer;
+
+struct MsReader
+{
+    oskar_Imager* h;
+    oskar_MeasurementSet* ms;
+    MsBuffer* buf;
+    size_t num_baselines, num_rows;
+};
+typedef struct MsReader MsReader;
+
+static void read_block_ms(void* reader, int block, int slot, int* status)
+{
+    MsReader* r = (MsReader*) reader;
+    MsBuffer* b = &r->buf[slot];
+    size_t allocated, required, start_row, block_size, i;
+    double *uvw_, *u_, *v_, *w_;
+    if (*status) return;
+
+    /* Read rows from Measurement Set. */
+    oskar_timer_resume(r->h->tmr_read);
+    start_row = block * r->num_baselines;
+    block_size = r->num_rows - start_row;
+    if (block_size > r->num_baselines) block_size = r->num_baselines;
+    b->block_size = block_size;
+    allocated = oskar_mem_length(b->uvw) *
+            oskar_mem_element_size(oskar_mem_type(b->uvw));
+    oskar_ms_read_column(r->ms, "UVW", start_row, block_size,
+            allocated, oskar_mem_void(b->uvw), &required, status);
+    allocated = oskar_mem_length(b->weight) *
+            oskar_mem_element_size(oskar_mem_type(b->weight));
+    oskar_ms_read_column(r->ms, "WEIGHT", start_row, block_size,
+            allocated, oskar_mem_void(b->weight), &required, status);
+    allocated = oskar_mem_length(b->time_centroid) *
+            oskar_mem_element_size(oskar_mem_type(b->time_centroid));
+    oskar_ms_read_column(r->ms, "TIME_CENTROID", start_row, block_size,
+            allocated, oskar_mem_void(b->time_centroid), &required, status);
+    allocated = oskar_mem_length(b->data) *
+            oskar_mem_element_size(oskar_mem_type(b->data));
+    oskar_ms_read_column(r->ms, r->h->ms_column, start_row, block_size,
+            allocated, oskar_mem_void(b->data), &required, status);
+
+    /* Split up baseline coordinates. */
+    uvw_ = oskar_mem_double(b->uvw, status);
+    u_ = oskar_mem_double(b->u, status);
+    v_ = oskar_mem_double(b->v, status);
+    w_ = oskar_mem_double(b->w, status);
+    if (!*status)
+    {
+        for (i = 0; i < block_size; ++i)
+        {
+            u_[i] = uvw_[3*i + 0];
+            v_[i] = uvw_[3*i + 1];
+            w_[i] = uvw_[3*i + 2];
+        }
+    }
+    oskar_timer_pause(r->h->tmr_read);
+}
+#endif
+
+
 void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
         int i_file, int num_files, int* percent_done, int* percent_next,
         int* status)
 {
 #ifndef OSKAR_NO_MS
-    oskar_MeasurementSet* ms;
-    oskar_Mem *uvw, *u, *v, *w, *data, *weight, *time_centroid;
-    int num_channels, num_pols, num_stations, type;
-    size_t num_baselines, start_row, num_rows;
-    double *uvw_, *u_, *v_, *w_;
+    MsReader r;
+    ReadAhead q;
+    int num_channels, num_pols, num_stations, num_blocks, num_slots;
+    int type, i, b;
     if (*status) return;
 
     /* Read the header. */
-    ms = oskar_ms_open(filename);
-    if (!ms)
+    r.h = h;
+    r.ms = oskar_ms_open(filename);
+    if (!r.ms)
     {
         *status = OSKAR_ERR_FILE_IO;
         return;
     }
-    num_rows = (size_t) oskar_ms_num_rows(ms);
-    num_stations = (int) oskar_ms_num_stations(ms);
-    num_baselines = num_stations * (num_stations - 1) / 2;
-    num_pols = (int) oskar_ms_num_pols(ms);
-    num_channels = (int) oskar_ms_num_channels(ms);
+    r.num_rows = (size_t) oskar_ms_num_rows(r.ms);
+    num_stations = (int) oskar_ms_num_stations(r.ms);
+    r.num_baselines = num_stations * (num_stations - 1) / 2;
+    num_pols = (int) oskar_ms_num_pols(r.ms);
+    num_channels = (int) oskar_ms_num_channels(r.ms);
+    num_blocks = r.num_baselines == 0 ? 0 : (int)
+            ((r.num_rows + r.num_baselines - 1) / r.num_baselines);
 
     /* Set visibility meta-data. */
     oskar_imager_set_vis_frequency(h,
-            oskar_ms_freq_start_hz(ms),
-            oskar_ms_freq_inc_hz(ms), num_channels);
+            oskar_ms_freq_start_hz(r.ms),
+            oskar_ms_freq_inc_hz(r.ms), num_channels);
     oskar_imager_set_vis_phase_centre(h,
-            oskar_ms_phase_centre_ra_rad(ms) * 180/M_PI,
-            oskar_ms_phase_centre_dec_rad(ms) * 180/M_PI);
-
-    /* Create arrays. */
-    uvw = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 3 * num_baselines, status);
-    u = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines, status);
-    v = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines, status);
-    w = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines, status);
-    weight = oskar_mem_create(OSKAR_SINGLE, OSKAR_CPU,
-            num_baselines * num_pols, status);
-    time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines,
-            status);
-    uvw_ = oskar_mem_double(uvw, status);
-    u_ = oskar_mem_double(u, status);
-    v_ = oskar_mem_double(v, status);
-    w_ = oskar_mem_double(w, status);
+            oskar_ms_phase_centre_ra_rad(r.ms) * 180/M_PI,
+            oskar_ms_phase_centre_dec_rad(r.ms) * 180/M_PI);
+
+    /* Create arrays for each buffer. */
     type = OSKAR_SINGLE | OSKAR_COMPLEX;
     if (num_pols == 4) type |= OSKAR_MATRIX;
-    data = oskar_mem_create(type, OSKAR_CPU,
-            num_baselines * num_channels, status);
+    num_slots = read_ahead_num_slots(h, num_blocks);
+    r.buf = (MsBuffer*) calloc(num_slots, sizeof(MsBuffer));
+    for (i = 0; i < num_slots; ++i)
+    {
+        MsBuffer* buf = &r.buf[i];
+        buf->uvw = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                3 * r.num_baselines, status);
+        buf->u = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
+        buf->v = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
+        buf->w = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
+        buf->weight = oskar_mem_create(OSKAR_SINGLE, OSKAR_CPU,
+                r.num_baselines * num_pols, status);
+        buf->time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
+        buf->data = oskar_mem_create(type, OSKAR_CPU,
+                r.num_baselines * num_channels, status);
+    }
 
     /* Loop over visibility blocks. */
-    for (start_row = 0; start_row < num_rows; start_row += num_baselines)
+    read_ahead_start(&q, num_slots, num_blocks, read_block_ms, &r, status);
+    for (b = 0; b < num_blocks; ++b)
     {
-        size_t allocated, required, block_size, i;
+        MsBuffer* buf;
+        const int slot = read_ahead_wait(&q, b, status);
         if (*status) break;
 
-        /* Read rows from Measurement Set. */
-        oskar_timer_resume(h->tmr_read);
-        block_size = num_rows - start_row;
-        if (block_size > num_baselines) block_size = num_baselines;
-        allocated = oskar_mem_length(uvw) *
-                oskar_mem_element_size(oskar_mem_type(uvw));
-        oskar_ms_read_column(ms, "UVW", start_row, block_size,
-                allocated, oskar_mem_void(uvw), &required, status);
-        allocated = oskar_mem_length(weight) *
-                oskar_mem_element_size(oskar_mem_type(weight));
-        oskar_ms_read_column(ms, "WEIGHT", start_row, block_size,
-                allocated, oskar_mem_void(weight), &required, status);
-        allocated = oskar_mem_length(time_centroid) *
-                oskar_mem_element_size(oskar_mem_type(time_centroid));
-        oskar_ms_read_column(ms, "TIME_CENTROID", start_row, block_size,
-                allocated, oskar_mem_void(time_centroid), &required, status);
-        allocated = oskar_mem_length(data) *
-                oskar_mem_element_size(oskar_mem_type(data));
-        oskar_ms_read_column(ms, h->ms_column, start_row, block_size,
-                allocated, oskar_mem_void(data), &required, status);
-        if (*status) break;
-
-        /* Split up baseline coordinates. */
-        for (i = 0; i < block_size; ++i)
-        {
-            u_[i] = uvw_[3*i + 0];
-            v_[i] = uvw_[3*i + 1];
-            w_[i] = uvw_[3*i + 2];
-        }
-
         /* Update the imager with the data. */
-        oskar_timer_pause(h->tmr_read);
-        oskar_imager_update(h, block_size, 0, num_channels - 1, num_pols,
-                u, v, w, data, weight, time_centroid, status);
-        *percent_done = (int) round(100.0 * (
-                (start_row + block_size) / (double)(num_rows * num_files) +
-                i_file / (double)num_files));
-        if (h->log && percent_next && *percent_done >= *percent_next)
-        {
-            oskar_log_message(h->log, 'S', -2, "%3d%% ...", *percent_done);
-            *percent_next = 10 + 10 * (*percent_done / 10);
-        }
+        buf = &r.buf[slot];
+        oskar_imager_update(h, buf->block_size, 0, num_channels - 1,
+                num_pols, buf->u, buf->v, buf->w, buf->data, buf->weight,
+                buf->time_centroid, status);
+        read_ahead_release(&q, b);
+        update_percent_done(h, (b * r.num_baselines + buf->block_size) /
+                (double)(r.num_rows * num_files) +
+                i_file / (double)num_files, percent_done, percent_next);
     }
-    oskar_mem_free(uvw, status);
-    oskar_mem_free(u, status);
-    oskar_mem_free(v, status);
-    oskar_mem_free(w, status);
-    oskar_mem_free(data, status);
-    oskar_mem_free(weight, status);
-    oskar_mem_free(time_centroid, status);
-    oskar_ms_close(ms);
+    read_ahead_stop(&q);
+    for (i = 0; i < num_slots; ++i)
+    {
+        MsBuffer* buf = &r.buf[i];
+        oskar_mem_free(buf->uvw, status);
+        oskar_mem_free(buf->u, status);
+        oskar_mem_free(buf->v, status);
+        oskar_mem_free(buf->w, status);
+        oskar_mem_free(buf->data, status);
+        oskar_mem_free(buf->weight, status);
+        oskar_mem_free(buf->time_centroid, status);
+    }
+    free(r.buf);
+    oskar_ms_close(r.ms);
 #else
     (void) filename;
     (void) i_file;
@@ -166,149 +344,213 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
 }
 
 
-void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
-        int i_file, int num_files, int* percent_done, int* percent_next,
-        int* status)
+struct VisBuffer
 {
-    oskar_Binary* vis_file;
     oskar_VisBlock* block;
+    oskar_Mem *time_centroid, *scratch, *amp;
+};
+typedef struct VisBuffer VisBuffer;
+
+struct VisReader
+{
+    oskar_Imager* h;
+    oskar_Binary* vis_file;
     oskar_VisHeader* header;
-    oskar_Mem *weight, *time_centroid, *time_slice, *scratch = 0, *ptr;
-    int max_times_per_block, tags_per_block, i_block, num_blocks;
-    int num_times_tot, num_channels_tot, num_stations, num_baselines, num_pols;
+    VisBuffer* buf;
+    int tags_per_block, num_baselines, num_pols;
     double time_start_mjd, time_inc_sec;
+};
+typedef struct VisReader VisReader;
+
+static void read_block_vis(void* reader, int i_block, int slot, int* status)
+{
+    VisReader* r = (VisReader*) reader;
+    VisBuffer* buf = &r->buf[slot];
+    oskar_VisBlock* block;
+    int t, num_times, num_channels, start_time, next, next_status = 0;
+    const int num_baselines = r->num_baselines, num_pols = r->num_pols;
+    double* time_centroid;
+    if (*status) return;
+
+    /* Read the visibility data, replacing the block previously held in
+     * this buffer. Where possible, the arrays in the block alias the
+     * memory-mapped file, so that nothing is copied. */
+    oskar_timer_resume(r->h->tmr_read);
+    oskar_vis_block_free(buf->block, status);
+    buf->block = oskar_vis_block_create_alias_from_binary(r->header,
+            r->vis_file, i_block, status);
+    block = buf->block;
+
+    /* Hint that the next block will be needed soon.
+     * (This does nothing past the end of the file.) */
+    next = oskar_binary_query_from(r->vis_file,
+            (i_block + 1) * r->tags_per_block, OSKAR_INT,
+            OSKAR_TAG_GROUP_VIS_BLOCK, OSKAR_VIS_BLOCK_TAG_DIM_START_AND_SIZE,
+            i_block + 1, 0, &next_status);
+    oskar_binary_prefetch(r->vis_file, next, r->tags_per_block, &next_status);
+    if (*status)
+    {
+        oskar_timer_pause(r->h->tmr_read);
+        return;
+    }
+    start_time   = oskar_vis_block_start_time_index(block);
+    num_times    = oskar_vis_block_num_times(block);
+    num_channels = oskar_vis_block_num_channels(block);
+
+    /* Fill in the time centroid values. */
+    time_centroid = oskar_mem_double(buf->time_centroid, status);
+    if (*status)
+    {
+        oskar_timer_pause(r->h->tmr_read);
+        return;
+    }
+    for (t = 0; t < num_times; ++t)
+    {
+        int b;
+        const double time_centroid_t = r->time_start_mjd +
+                (start_time + t + 0.5) * r->time_inc_sec;
+        for (b = 0; b < num_baselines; ++b)
+            time_centroid[t * num_baselines + b] = time_centroid_t;
+    }
+
+    /* Swap baseline and channel dimensions. */
+    buf->amp = oskar_vis_block_cross_correlations(block);
+#define SWAP_LOOP \
+    for (t = 0; t < num_times; ++t)                                      \
+        for (c = 0; c < num_channels; ++c)                               \
+            for (b = 0; b < num_baselines; ++b)                          \
+                for (p = 0; p < num_pols; ++p)                           \
+                {                                                        \
+                    k = (num_pols * (num_baselines *                     \
+                            (num_channels * t + c) + b) + p) << 1;       \
+                    l = (num_pols * (num_channels *                      \
+                            (num_baselines * t + b) + c) + p) << 1;      \
+                    out[l] = in[k];                                      \
+                    out[l + 1] = in[k + 1];                              \
+                }
+    if (num_channels != 1)
+    {
+        int b, c, p;
+        size_t k, l;
+        if (oskar_mem_precision(buf->amp) == OSKAR_SINGLE)
+        {
+            float *in, *out;
+            in  = oskar_mem_float(buf->amp, status);
+            out = oskar_mem_float(buf->scratch, status);
+            SWAP_LOOP
+        }
+        else
+        {
+            double *in, *out;
+            in  = oskar_mem_double(buf->amp, status);
+            out = oskar_mem_double(buf->scratch, status);
+            SWAP_LOOP
+        }
+        buf->amp = buf->scratch;
+    }
+#undef SWAP_LOOP
+    oskar_timer_pause(r->h->tmr_read);
+}
+
+
+void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
+        int i_file, int num_files, int* percent_done, int* percent_next,
+        int* status)
+{
+    VisReader r;
+    ReadAhead q;
+    oskar_Mem *weight;
+    int max_times_per_block, i_block, num_blocks, num_slots, i;
+    int num_times_tot, num_channels_tot, num_stations;
     if (*status) return;
 
     /* Read the header. */
-    vis_file = oskar_binary_create(filename, 'r', status);
-    header = oskar_vis_header_read(vis_file, status);
+    r.h = h;
+    r.vis_file = oskar_binary_create(filename, 'm', status);
+    r.header = oskar_vis_header_read(r.vis_file, status);
     if (*status)
     {
-        oskar_vis_header_free(header, status);
-        oskar_binary_free(vis_file);
+        oskar_vis_header_free(r.header, status);
+        oskar_binary_free(r.vis_file);
         return;
     }
-    max_times_per_block = oskar_vis_header_max_times_per_block(header);
-    tags_per_block = oskar_vis_header_num_tags_per_block(header);
-    num_times_tot = oskar_vis_header_num_times_total(header);
-    num_channels_tot = oskar_vis_header_num_channels_total(header);
-    num_stations = oskar_vis_header_num_stations(header);
-    num_baselines = num_stations * (num_stations - 1) / 2;
-    num_pols = oskar_type_is_matrix(oskar_vis_header_amp_type(header)) ? 4 : 1;
+    max_times_per_block = oskar_vis_header_max_times_per_block(r.header);
+    r.tags_per_block = oskar_vis_header_num_tags_per_block(r.header);
+    num_times_tot = oskar_vis_header_num_times_total(r.header);
+    num_channels_tot = oskar_vis_header_num_channels_total(r.header);
+    num_stations = oskar_vis_header_num_stations(r.header);
+    r.num_baselines = num_stations * (num_stations - 1) / 2;
+    r.num_pols =
+            oskar_type_is_matrix(oskar_vis_header_amp_type(r.header)) ? 4 : 1;
     num_blocks = (num_times_tot + max_times_per_block - 1) /
             max_times_per_block;
-    time_start_mjd = oskar_vis_header_time_start_mjd_utc(header) * 86400.0;
-    time_inc_sec = oskar_vis_header_time_inc_sec(header);
+    r.time_start_mjd = oskar_vis_header_time_start_mjd_utc(r.header) * 86400.0;
+    r.time_inc_sec = oskar_vis_header_time_inc_sec(r.header);
 
     /* Set visibility meta-data. */
     oskar_imager_set_vis_frequency(h,
-            oskar_vis_header_freq_start_hz(header),
-            oskar_vis_header_freq_inc_hz(header), num_channels_tot);
+            oskar_vis_header_freq_start_hz(r.header),
+            oskar_vis_header_freq_inc_hz(r.header), num_channels_tot);
     oskar_imager_set_vis_phase_centre(h,
-            oskar_vis_header_phase_centre_ra_deg(header),
-            oskar_vis_header_phase_centre_dec_deg(header));
-
-    /* Create scratch arrays. Weights are all 1. */
-    time_centroid = oskar_mem_create(OSKAR_DOUBLE,
-            OSKAR_CPU, num_baselines * max_times_per_block, status);
-    time_slice = oskar_mem_create_alias(0, 0, 0, status);
-    weight = oskar_mem_create(h->imager_prec,
-            OSKAR_CPU, num_baselines * num_pols * max_times_per_block, status);
+            oskar_vis_header_phase_centre_ra_deg(r.header),
+            oskar_vis_header_phase_centre_dec_deg(r.header));
+
+    /* Create scratch arrays for each buffer. Weights are all 1. */
+    weight = oskar_mem_create(h->imager_prec, OSKAR_CPU,
+            r.num_baselines * r.num_pols * max_times_per_block, status);
     oskar_mem_set_value_real(weight, 1.0, 0, 0, status);
-    if (num_channels_tot > 1)
-        scratch = oskar_mem_create(oskar_vis_header_amp_type(header), OSKAR_CPU,
-                num_baselines * num_channels_tot * max_times_per_block, status);
+    num_slots = read_ahead_num_slots(h, num_blocks);
+    r.buf = (VisBuffer*) calloc(num_slots, sizeof(VisBuffer));
+    for (i = 0; i < num_slots; ++i)
+    {
+        VisBuffer* buf = &r.buf[i];
+        buf->time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines * max_times_per_block, status);
+        if (num_channels_tot > 1)
+            buf->scratch = oskar_mem_create(
+                    oskar_vis_header_amp_type(r.header), OSKAR_CPU,
+                    r.num_baselines * num_channels_tot * max_times_per_block,
+                    status);
+    }
 
     /* Loop over visibility blocks. */
-    block = oskar_vis_block_create_from_header(OSKAR_CPU, header, status);
+    read_ahead_start(&q, num_slots, num_blocks, read_block_vis, &r, status);
     for (i_block = 0; i_block < num_blocks; ++i_block)
     {
-        int t, num_times, num_channels, start_time, start_chan, end_chan;
+        VisBuffer* buf;
+        oskar_VisBlock* block;
+        int start_chan, end_chan;
         size_t num_rows;
+        const int slot = read_ahead_wait(&q, i_block, status);
         if (*status) break;
 
-        /* Read the visibility data. */
-        oskar_timer_resume(h->tmr_read);
-        oskar_binary_set_query_search_start(vis_file,
-                i_block * tags_per_block, status);
-        oskar_vis_block_read(block, header, vis_file, i_block, status);
-        start_time   = oskar_vis_block_start_time_index(block);
-        start_chan   = oskar_vis_block_start_channel_index(block);
-        num_times    = oskar_vis_block_num_times(block);
-        num_channels = oskar_vis_block_num_channels(block);
-        num_rows     = num_times * num_baselines;
-        end_chan     = start_chan + num_channels - 1;
-
-        /* Fill in the time centroid values. */
-        for (t = 0; t < num_times; ++t)
-        {
-            oskar_mem_set_alias(time_slice, time_centroid,
-                    t * num_baselines, num_baselines, status);
-            oskar_mem_set_value_real(time_slice,
-                    time_start_mjd + (start_time + t + 0.5) * time_inc_sec,
-                    0, num_baselines, status);
-        }
-
-        /* Swap baseline and channel dimensions. */
-        ptr = oskar_vis_block_cross_correlations(block);
-#define SWAP_LOOP \
-        for (t = 0; t < num_times; ++t)                                  \
-            for (c = 0; c < num_channels; ++c)                           \
-                for (b = 0; b < num_baselines; ++b)                      \
-                    for (p = 0; p < num_pols; ++p)                       \
-                    {                                                    \
-                        k = (num_pols * (num_baselines *                 \
-                                (num_channels * t + c) + b) + p) << 1;   \
-                        l = (num_pols * (num_channels *                  \
-                                (num_baselines * t + b) + c) + p) << 1;  \
-                        out[l] = in[k];                                  \
-                        out[l + 1] = in[k + 1];                          \
-                    }
-        if (num_channels != 1)
-        {
-            int b, c, p;
-            size_t k, l;
-            if (oskar_mem_precision(ptr) == OSKAR_SINGLE)
-            {
-                float *in, *out;
-                in  = oskar_mem_float(ptr, status);
-                out = oskar_mem_float(scratch, status);
-                SWAP_LOOP
-            }
-            else
-            {
-                double *in, *out;
-                in  = oskar_mem_double(ptr, status);
-                out = oskar_mem_double(scratch, status);
-                SWAP_LOOP
-            }
-            ptr = scratch;
-        }
-#undef SWAP_LOOP
-
         /* Update the imager with the data. */
-        oskar_timer_pause(h->tmr_read);
-        oskar_imager_update(h, num_rows, start_chan, end_chan, num_pols,
+        buf = &r.buf[slot];
+        block = buf->block;
+        start_chan = oskar_vis_block_start_channel_index(block);
+        end_chan = start_chan + oskar_vis_block_num_channels(block) - 1;
+        num_rows = oskar_vis_block_num_times(block) * r.num_baselines;
+        oskar_imager_update(h, num_rows, start_chan, end_chan, r.num_pols,
                 oskar_vis_block_baseline_uu_metres(block),
                 oskar_vis_block_baseline_vv_metres(block),
                 oskar_vis_block_baseline_ww_metres(block),
-                ptr, weight, time_centroid, status);
-        *percent_done = (int) round(100.0 * (
-                (i_block + 1) / (double)(num_blocks * num_files) +
-                i_file / (double)num_files));
-        if (h->log && percent_next && *percent_done >= *percent_next)
-        {
-            oskar_log_message(h->log, 'S', -2, "%3d%% ...", *percent_done);
-            *percent_next = 10 + 10 * (*percent_done / 10);
-        }
+                buf->amp, weight, buf->time_centroid, status);
+        read_ahead_release(&q, i_block);
+        update_percent_done(h, (i_block + 1) / (double)(num_blocks * num_files)
+                + i_file / (double)num_files, percent_done, percent_next);
+    }
+    read_ahead_stop(&q);
+    for (i = 0; i < num_slots; ++i)
+    {
+        VisBuffer* buf = &r.buf[i];
+        oskar_mem_free(buf->time_centroid, status);
+        oskar_mem_free(buf->scratch, status);
+        oskar_vis_block_free(buf->block, status);
     }
-    oskar_mem_free(scratch, status);
+    free(r.buf);
     oskar_mem_free(weight, status);
-    oskar_mem_free(time_centroid, status);
-    oskar_mem_free(time_slice, status);
-    oskar_vis_block_free(block, status);
-    oskar_vis_header_free(header, status);
-    oskar_binary_free(vis_file);
+    oskar_vis_header_free(r.header, status);
+    oskar_binary_free(r.vis_file);
 }
 
 #ifdef __cplusplus
@@ -65,9 +65,11 @@ void oskar_imager_select_data(
         oskar_Mem* vis_out,
         oskar_Mem* weight_out,
         oskar_Mem* time_out,
+        int* num_channels_out,
+        double* scale_inc,
         int* status)
 {
-    int i, c, p, num_channels;
+    int i, c, p, num_channels, c_first = 0, c_prev = 0, c_step = 0;
     double inv_wavelength;
     const double s = 0.05;
     const double df = h->freq_inc_hz != 0.0 ? h->freq_inc_hz : 1.0;
@@ -76,6 +78,8 @@ void oskar_imager_select_data(
     /* Initialise. */
     if (*status) return;
     *num_out = 0;
+    *num_channels_out = 1;
+    *scale_inc = 0.0;
 
     /* Override pol_offset if required. */
     p = h->pol_offset;
@@ -128,6 +132,15 @@ void oskar_imager_select_data(
             if (c < start_chan || c > end_chan) continue;
             if (fabs((h->sel_freqs[i] - f0) - c * df) > s * df) continue;
 
+            /* Check whether the selected channels are equally spaced. */
+            if (*num_out == 0)
+                c_first = c;
+            else if (*num_out == num_rows)
+                c_step = c - c_prev;
+            else if (c - c_prev != c_step)
+                c_step = 0;
+            c_prev = c;
+
             /* Copy the baseline coordinates in wavelengths. */
             inv_wavelength = (f0 + c * df) / C0;
             oskar_mem_set_alias(uu_, uu_out, *num_out, num_rows, status);
@@ -159,6 +172,11 @@ void oskar_imager_select_data(
         oskar_mem_free(uu_, status);
         oskar_mem_free(vv_, status);
         oskar_mem_free(ww_, status);
+        if (c_step > 0 && num_rows > 0)
+        {
+            *num_channels_out = (int) (*num_out / num_rows);
+            *scale_inc = c_step * df / (f0 + c_first * df);
+        }
     }
 }
 
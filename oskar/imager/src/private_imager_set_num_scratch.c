@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/private_imager_set_num_scratch.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_imager_set_num_scratch(oskar_Imager* h, int num_scratch,
+        int* status)
+{
+    int i;
+    PlaneScratch* t;
+
+    /* Free everything if required. */
+    if (num_scratch == 0)
+    {
+        for (i = 0; i < h->num_scratch; ++i)
+        {
+            PlaneScratch* s = &h->scratch[i];
+            oskar_mem_free(s->uu_im, status);
+            oskar_mem_free(s->vv_im, status);
+            oskar_mem_free(s->ww_im, status);
+            oskar_mem_free(s->vis_im, status);
+            oskar_mem_free(s->weight_im, status);
+            oskar_mem_free(s->time_im, status);
+            oskar_mem_free(s->uu_tmp, status);
+            oskar_mem_free(s->vv_tmp, status);
+            oskar_mem_free(s->ww_tmp, status);
+            oskar_mem_free(s->weight_tmp, status);
+        }
+        free(h->scratch);
+        h->scratch = 0;
+        h->num_scratch = 0;
+        return;
+    }
+    if (*status || num_scratch <= h->num_scratch) return;
+
+    /* Create empty arrays for each new set. */
+    t = (PlaneScratch*) realloc(h->scratch,
+            num_scratch * sizeof(PlaneScratch));
+    if (!t)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+    h->scratch = t;
+    for (i = h->num_scratch; i < num_scratch; ++i)
+    {
+        PlaneScratch* s = &h->scratch[i];
+        const int prec = h->imager_prec;
+        s->uu_im      = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+        s->vv_im      = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+        s->ww_im      = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+        s->vis_im     = oskar_mem_create(prec | OSKAR_COMPLEX,
+                OSKAR_CPU, 0, status);
+        s->weight_im  = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+        s->time_im    = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+        s->uu_tmp     = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+        s->vv_tmp     = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+        s->ww_tmp     = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+        s->weight_tmp = oskar_mem_create(prec, OSKAR_CPU, 0, status);
+    }
+    h->num_scratch = num_scratch;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -50,14 +50,16 @@ struct ThreadArgs
 {
     oskar_Imager* h;
     oskar_Mem* plane;
-    int thread_id, num_vis;
+    int thread_id, num_vis, num_channels;
+    double scale_inc;
 };
 typedef struct ThreadArgs ThreadArgs;
 
 void oskar_imager_update_plane_dft(oskar_Imager* h, size_t num_vis,
-        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
-        const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* plane,
-        double* plane_norm, int* status)
+        int num_channels, double scale_inc, const oskar_Mem* uu,
+        const oskar_Mem* vv, const oskar_Mem* ww, const oskar_Mem* amps,
+        const oskar_Mem* weight, oskar_Mem* plane, double* plane_norm,
+        int* status)
 {
     size_t i, num_pixels, num_threads;
     oskar_Thread** threads = 0;
@@ -97,6 +99,8 @@ void oskar_imager_update_plane_dft(oskar_Imager* h, size_t num_vis,
         args[i].h = h;
         args[i].thread_id = (int) i;
         args[i].num_vis = (int) num_vis;
+        args[i].num_channels = num_channels;
+        args[i].scale_inc = scale_inc;
         args[i].plane = plane;
     }
 
@@ -142,13 +146,16 @@ static void* run_blocks(void* arg)
     DeviceData* d;
     size_t max_block_size, num_pixels;
     const size_t smallest = 1024, largest = 65536;
-    int i_block, thread_id, num_blocks, num_vis;
+    int i_block, thread_id, num_blocks, num_vis, num_channels;
     int *status;
+    double scale_inc;
 
     /* Get thread function arguments. */
     h = ((ThreadArgs*)arg)->h;
     thread_id = ((ThreadArgs*)arg)->thread_id;
     num_vis = ((ThreadArgs*)arg)->num_vis;
+    num_channels = ((ThreadArgs*)arg)->num_channels;
+    scale_inc = ((ThreadArgs*)arg)->scale_inc;
     plane = ((ThreadArgs*)arg)->plane;
     status = &(h->status);
 
@@ -207,10 +214,17 @@ static void* run_blocks(void* arg)
                     block_size, status);
         }
 
-        /* Run DFT for the block. */
-        oskar_dft_c2r(num_vis, 2.0 * M_PI, d->uu, d->vv, d->ww,
-                d->amp, d->weight, (int) block_size,
-                d->l, d->m, d->n, d->block_dev, status);
+        /* Run DFT for the block.
+         * On the CPU, phases are shared between equally spaced channels. */
+        if (num_channels > 1 && oskar_mem_location(d->uu) == OSKAR_CPU)
+            oskar_dft_c2r_channels(num_channels, num_vis / num_channels,
+                    2.0 * M_PI, 2.0 * M_PI * scale_inc, d->uu, d->vv, d->ww,
+                    d->amp, d->weight, (int) block_size,
+                    d->l, d->m, d->n, d->block_dev, status);
+        else
+            oskar_dft_c2r(num_vis, 2.0 * M_PI, d->uu, d->vv, d->ww,
+                    d->amp, d->weight, (int) block_size,
+                    d->l, d->m, d->n, d->block_dev, status);
 
         /* Copy data to the host and add to existing pixels. */
         oskar_mem_copy(d->block_cpu, d->block_dev, status);
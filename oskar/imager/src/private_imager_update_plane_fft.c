@@ -30,16 +30,97 @@
 #include "imager/oskar_imager.h"
 
 #include "imager/private_imager_update_plane_fft.h"
+#include "imager/private_imager_grid_tiles.h"
 #include "imager/oskar_grid_simple.h"
 
+#include <stdlib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+static void update_plane_fft_tiled(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* amps,
+        const oskar_Mem* weight, oskar_Mem* plane, double* plane_norm,
+        size_t* num_skipped, int num_threads, int* status)
+{
+    oskar_GridTiles tiles;
+    int num_tiles, pass, t, grid_size;
+    size_t *tile_skipped = 0;
+    double *tile_norm = 0;
+    const void *conv, *p_uu, *p_vv, *p_amp, *p_weight;
+    void *grid;
+
+    /* Sort visibilities into tiles of the grid. */
+    grid_size = oskar_imager_plane_size(h);
+    oskar_imager_grid_tiles_sort(h, h->support, num_vis, uu, vv, 0,
+            amps, weight, &tiles, status);
+    num_tiles = tiles.num_tiles_u * tiles.num_tiles_v;
+    tile_skipped = (size_t*) calloc(num_tiles, sizeof(size_t));
+    tile_norm = (double*) calloc(num_tiles, sizeof(double));
+    if (!*status && (!tile_skipped || !tile_norm))
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    if (*status)
+    {
+        free(tile_skipped);
+        free(tile_norm);
+        oskar_imager_grid_tiles_free(&tiles, status);
+        return;
+    }
+
+    /* Grid tiles with the same parity in u and v concurrently. */
+    conv = oskar_mem_void_const(h->conv_func);
+    p_uu = oskar_mem_void_const(tiles.uu);
+    p_vv = oskar_mem_void_const(tiles.vv);
+    p_amp = oskar_mem_void_const(tiles.amp);
+    p_weight = oskar_mem_void_const(tiles.weight);
+    grid = oskar_mem_void(plane);
+    for (pass = 0; pass < 4; ++pass)
+    {
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (t = 0; t < num_tiles; ++t)
+        {
+            const int tu = t % tiles.num_tiles_u, tv = t / tiles.num_tiles_u;
+            const size_t start = tiles.tile_start[t];
+            const size_t num = tiles.tile_start[t + 1] - start;
+            if ((tu & 1) + 2 * (tv & 1) != pass || num == 0) continue;
+            if (h->imager_prec == OSKAR_DOUBLE)
+                oskar_grid_simple_d(h->support, h->oversample,
+                        (const double*) conv, num,
+                        (const double*) p_uu + start,
+                        (const double*) p_vv + start,
+                        (const double*) p_amp + 2 * start,
+                        (const double*) p_weight + start,
+                        h->cellsize_rad, grid_size, &tile_skipped[t],
+                        &tile_norm[t], (double*) grid);
+            else
+                oskar_grid_simple_f(h->support, h->oversample,
+                        (const float*) conv, num,
+                        (const float*) p_uu + start,
+                        (const float*) p_vv + start,
+                        (const float*) p_amp + 2 * start,
+                        (const float*) p_weight + start,
+                        (float) (h->cellsize_rad), grid_size,
+                        &tile_skipped[t], &tile_norm[t], (float*) grid);
+        }
+    }
+
+    /* Sum tile totals in a fixed order. */
+    *num_skipped = 0;
+    for (t = 0; t < num_tiles; ++t)
+    {
+        *num_skipped += tile_skipped[t];
+        *plane_norm += tile_norm[t];
+    }
+    free(tile_skipped);
+    free(tile_norm);
+    oskar_imager_grid_tiles_free(&tiles, status);
+}
+
 void oskar_imager_update_plane_fft(oskar_Imager* h, size_t num_vis,
         const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* amps,
         const oskar_Mem* weight, oskar_Mem* plane, double* plane_norm,
-        size_t* num_skipped, int* status)
+        size_t* num_skipped, int num_threads, int* status)
 {
     int grid_size;
     size_t num_cells;
@@ -51,6 +132,16 @@ void oskar_imager_update_plane_fft(oskar_Imager* h, size_t num_vis,
     if (oskar_mem_length(plane) < num_cells)
         oskar_mem_realloc(plane, num_cells, status);
     if (*status) return;
+
+    /* Use the tiled gridder whenever the imager is set to use more than
+     * one grid thread, even if only one is available for this plane,
+     * so the result does not depend on how planes are shared out. */
+    if (h->num_grid_threads > 1)
+    {
+        update_plane_fft_tiled(h, num_vis, uu, vv, amps, weight, plane,
+                plane_norm, num_skipped, num_threads, status);
+        return;
+    }
     if (h->imager_prec == OSKAR_DOUBLE)
         oskar_grid_simple_d(h->support, h->oversample,
                 oskar_mem_double_const(h->conv_func, status), num_vis,
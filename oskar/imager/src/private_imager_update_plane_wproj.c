@@ -30,6 +30,7 @@
 #include "imager/oskar_imager.h"
 
 #include "imager/private_imager_update_plane_wproj.h"
+#include "imager/private_imager_grid_tiles.h"
 #include "imager/oskar_grid_wproj.h"
 
 #include <stdlib.h>
@@ -44,10 +45,99 @@ extern "C" {
 #define SAVE_OUTPUT_DAT 0
 #define SAVE_GRID 0
 
+static void update_plane_wproj_tiled(oskar_Imager* h, size_t num_vis,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* plane,
+        double* plane_norm, size_t* num_skipped, int num_threads, int* status)
+{
+    oskar_GridTiles tiles;
+    int i, num_tiles, pass, t, grid_size, max_support = 0;
+    size_t *tile_skipped = 0;
+    double *tile_norm = 0;
+    const int* support;
+    const void *kernels, *p_uu, *p_vv, *p_ww, *p_amp, *p_weight;
+    void *grid;
+
+    /* Sort visibilities into tiles of the grid. */
+    grid_size = oskar_imager_plane_size(h);
+    support = oskar_mem_int_const(h->w_support, status);
+    if (*status) return;
+    for (i = 0; i < h->num_w_planes; ++i)
+        if (support[i] > max_support) max_support = support[i];
+    oskar_imager_grid_tiles_sort(h, max_support, num_vis, uu, vv, ww,
+            amps, weight, &tiles, status);
+    num_tiles = tiles.num_tiles_u * tiles.num_tiles_v;
+    tile_skipped = (size_t*) calloc(num_tiles, sizeof(size_t));
+    tile_norm = (double*) calloc(num_tiles, sizeof(double));
+    if (!*status && (!tile_skipped || !tile_norm))
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+    if (*status)
+    {
+        free(tile_skipped);
+        free(tile_norm);
+        oskar_imager_grid_tiles_free(&tiles, status);
+        return;
+    }
+
+    /* Grid tiles with the same parity in u and v concurrently. */
+    kernels = oskar_mem_void_const(h->w_kernels);
+    p_uu = oskar_mem_void_const(tiles.uu);
+    p_vv = oskar_mem_void_const(tiles.vv);
+    p_ww = oskar_mem_void_const(tiles.ww);
+    p_amp = oskar_mem_void_const(tiles.amp);
+    p_weight = oskar_mem_void_const(tiles.weight);
+    grid = oskar_mem_void(plane);
+    for (pass = 0; pass < 4; ++pass)
+    {
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (t = 0; t < num_tiles; ++t)
+        {
+            const int tu = t % tiles.num_tiles_u, tv = t / tiles.num_tiles_u;
+            const size_t start = tiles.tile_start[t];
+            const size_t num = tiles.tile_start[t + 1] - start;
+            if ((tu & 1) + 2 * (tv & 1) != pass || num == 0) continue;
+            if (h->imager_prec == OSKAR_DOUBLE)
+                oskar_grid_wproj_d(h->num_w_planes, support,
+                        h->oversample, h->conv_size_half,
+                        (const double*) kernels, num,
+                        (const double*) p_uu + start,
+                        (const double*) p_vv + start,
+                        (const double*) p_ww + start,
+                        (const double*) p_amp + 2 * start,
+                        (const double*) p_weight + start,
+                        h->cellsize_rad, h->w_scale, grid_size,
+                        &tile_skipped[t], &tile_norm[t], (double*) grid);
+            else
+                oskar_grid_wproj_f(h->num_w_planes, support,
+                        h->oversample, h->conv_size_half,
+                        (const float*) kernels, num,
+                        (const float*) p_uu + start,
+                        (const float*) p_vv + start,
+                        (const float*) p_ww + start,
+                        (const float*) p_amp + 2 * start,
+                        (const float*) p_weight + start,
+                        (float) (h->cellsize_rad), (float) (h->w_scale),
+                        grid_size, &tile_skipped[t], &tile_norm[t],
+                        (float*) grid);
+        }
+    }
+
+    /* Sum tile totals in a fixed order. */
+    *num_skipped = 0;
+    for (t = 0; t < num_tiles; ++t)
+    {
+        *num_skipped += tile_skipped[t];
+        *plane_norm += tile_norm[t];
+    }
+    free(tile_skipped);
+    free(tile_norm);
+    oskar_imager_grid_tiles_free(&tiles, status);
+}
+
 void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
         const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
         const oskar_Mem* amps, const oskar_Mem* weight, oskar_Mem* plane,
-        double* plane_norm, size_t* num_skipped, int* status)
+        double* plane_norm, size_t* num_skipped, int num_threads, int* status)
 {
     int grid_size;
     size_t num_cells;
@@ -59,6 +149,16 @@ void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
     if (oskar_mem_length(plane) < num_cells)
         oskar_mem_realloc(plane, num_cells, status);
     if (*status) return;
+
+    /* Use the tiled gridder whenever the imager is set to use more than
+     * one grid thread, even if only one is available for this plane,
+     * so the result does not depend on how planes are shared out. */
+    if (h->num_grid_threads > 1)
+    {
+        update_plane_wproj_tiled(h, num_vis, uu, vv, ww, amps, weight, plane,
+                plane_norm, num_skipped, num_threads, status);
+        return;
+    }
     if (h->imager_prec == OSKAR_DOUBLE)
         oskar_grid_wproj_d(h->num_w_planes,
                 oskar_mem_int_const(h->w_support, status),
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include "imager/oskar_imager.h"
+#include <cmath>
+
+static void image_dft(int type, const char* algorithm, int per_channel,
+        int size, oskar_Mem** image, int* status)
+{
+    // Create and set up the imager to make one frequency-synthesised plane.
+    int num_rows = 200, num_chan = 40, num_pols = 1;
+    oskar_Imager* im = oskar_imager_create(type, status);
+    oskar_imager_set_algorithm(im, algorithm, status);
+    oskar_imager_set_fov(im, 2.0);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_image_type(im, "I", status);
+    oskar_imager_set_channel_snapshots(im, 0);
+    oskar_imager_set_vis_frequency(im, 100e6, 0.5e6, num_chan);
+    oskar_imager_set_vis_phase_centre(im, 0.0, 60.0);
+
+    // Create visibility data.
+    oskar_Mem* uu = oskar_mem_create(type, OSKAR_CPU, num_rows, status);
+    oskar_Mem* vv = oskar_mem_create(type, OSKAR_CPU, num_rows, status);
+    oskar_Mem* ww = oskar_mem_create(type, OSKAR_CPU, num_rows, status);
+    oskar_Mem* amp = oskar_mem_create(type | OSKAR_COMPLEX,
+            OSKAR_CPU, num_rows * num_chan, status);
+    oskar_Mem* weight = oskar_mem_create(type, OSKAR_CPU,
+            num_rows * num_pols, status);
+    oskar_mem_random_gaussian(uu, 0, 1, 2, 3, 500.0, status);
+    oskar_mem_random_gaussian(vv, 4, 5, 6, 7, 500.0, status);
+    oskar_mem_random_gaussian(ww, 8, 9, 10, 11, 50.0, status);
+    oskar_mem_random_gaussian(amp, 12, 13, 14, 15, 1.0, status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_rows * num_pols, status);
+
+    if (per_channel)
+    {
+        // Update the plane with one channel at a time.
+        oskar_Mem* amp_c = oskar_mem_create(type | OSKAR_COMPLEX,
+                OSKAR_CPU, num_rows, status);
+        for (int c = 0; c < num_chan; ++c)
+        {
+            for (int r = 0; r < num_rows; ++r)
+                oskar_mem_copy_contents(amp_c, amp, r,
+                        r * num_chan + c, 1, status);
+            oskar_imager_update(im, num_rows, c, c, num_pols,
+                    uu, vv, ww, amp_c, weight, 0, status);
+        }
+        oskar_mem_free(amp_c, status);
+    }
+    else
+    {
+        // Update the plane with all channels together.
+        oskar_imager_update(im, num_rows, 0, num_chan - 1, num_pols,
+                uu, vv, ww, amp, weight, 0, status);
+    }
+    oskar_imager_finalise(im, 1, image, 0, 0, status);
+
+    // Clean up.
+    oskar_imager_free(im, status);
+    oskar_mem_free(uu, status);
+    oskar_mem_free(vv, status);
+    oskar_mem_free(ww, status);
+    oskar_mem_free(amp, status);
+    oskar_mem_free(weight, status);
+}
+
+static void compare_dft_channels(int type, const char* algorithm, double tol)
+{
+    // The DFT of equally spaced channels shares phase terms between
+    // channels. Check that it agrees with one channel at a time.
+    int status = 0, size = 32;
+    oskar_Mem *image[2] = {0, 0};
+    image_dft(type, algorithm, 0, size, &image[0], &status);
+    image_dft(type, algorithm, 1, size, &image[1], &status);
+    ASSERT_EQ(0, status);
+    ASSERT_TRUE(image[0] != 0);
+    ASSERT_TRUE(image[1] != 0);
+    double max_abs = 0.0, max_diff = 0.0;
+    for (int i = 0; i < size * size; ++i)
+    {
+        double t0 = oskar_mem_get_element(image[0], i, &status);
+        double t1 = oskar_mem_get_element(image[1], i, &status);
+        if (fabs(t1) > max_abs) max_abs = fabs(t1);
+        if (fabs(t1 - t0) > max_diff) max_diff = fabs(t1 - t0);
+    }
+    EXPECT_GT(max_abs, 0.0);
+    EXPECT_LT(max_diff / max_abs, tol);
+    oskar_mem_free(image[0], &status);
+    oskar_mem_free(image[1], &status);
+}
+
+TEST(imager, dft_channels_2d)
+{
+    compare_dft_channels(OSKAR_DOUBLE, "DFT 2D", 1e-10);
+    compare_dft_channels(OSKAR_SINGLE, "DFT 2D", 1e-4);
+}
+
+TEST(imager, dft_channels_3d)
+{
+    compare_dft_channels(OSKAR_DOUBLE, "DFT 3D", 1e-10);
+}
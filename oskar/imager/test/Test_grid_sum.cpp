@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, The University of Oxford
+ * Copyright (c) 2016-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -28,6 +28,8 @@
 
 #include <gtest/gtest.h>
 #include "imager/oskar_imager.h"
+#include <cmath>
+#include <cstring>
 
 // #define WRITE_FITS 1
 #ifdef WRITE_FITS
@@ -110,3 +112,188 @@ TEST(imager, grid_sum)
     oskar_mem_free(weight, &status);
     oskar_mem_free(grid, &status);
 }
+
+static void grid_random_vis(int type, const char* algorithm,
+        int num_threads, int size, oskar_Mem* grid, double* plane_norm,
+        int* status)
+{
+    // Create and set up the imager.
+    oskar_Imager* im = oskar_imager_create(type, status);
+    oskar_imager_set_algorithm(im, algorithm, status);
+    oskar_imager_set_fov(im, 5.0);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_num_grid_threads(im, num_threads);
+    if (!strcmp(algorithm, "W-projection"))
+    {
+        oskar_imager_set_num_w_planes(im, 16);
+        oskar_imager_set_generate_w_kernels_on_gpu(im, 0);
+    }
+
+    // Create visibility data, some of which falls off the grid.
+    int num_vis = 50000;
+    oskar_Mem* uu = oskar_mem_create(type, OSKAR_CPU, num_vis, status);
+    oskar_Mem* vv = oskar_mem_create(type, OSKAR_CPU, num_vis, status);
+    oskar_Mem* ww = oskar_mem_create(type, OSKAR_CPU, num_vis, status);
+    oskar_Mem* vis = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis,
+            status);
+    oskar_Mem* weight = oskar_mem_create(type, OSKAR_CPU, num_vis, status);
+    oskar_mem_random_gaussian(uu, 0, 1, 2, 3, 2000.0, status);
+    oskar_mem_random_gaussian(vv, 4, 5, 6, 7, 2000.0, status);
+    oskar_mem_random_gaussian(ww, 12, 13, 14, 15, 200.0, status);
+    oskar_mem_random_gaussian(vis, 8, 9, 10, 11, 1.0, status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_vis, status);
+
+    // Grid visibility data.
+    oskar_mem_clear_contents(grid, status);
+    *plane_norm = 0.0;
+    oskar_imager_update_plane(im, num_vis, uu, vv, ww, vis, weight, grid,
+            plane_norm, 0, status);
+
+    // Clean up.
+    oskar_imager_free(im, status);
+    oskar_mem_free(uu, status);
+    oskar_mem_free(vv, status);
+    oskar_mem_free(ww, status);
+    oskar_mem_free(vis, status);
+    oskar_mem_free(weight, status);
+}
+
+static void compare_grid_threads(const char* algorithm, int size)
+{
+    int status = 0, grid_size = size * size;
+    int types[] = {OSKAR_DOUBLE, OSKAR_SINGLE};
+    for (int k = 0; k < 2; ++k)
+    {
+        int type = types[k];
+        double norm[3];
+        oskar_Mem* grid[3];
+        for (int i = 0; i < 3; ++i)
+            grid[i] = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+                    grid_size, &status);
+
+        // Grid the same data using 1, 2 and 4 threads.
+        grid_random_vis(type, algorithm, 1, size, grid[0], &norm[0], &status);
+        grid_random_vis(type, algorithm, 2, size, grid[1], &norm[1], &status);
+        grid_random_vis(type, algorithm, 4, size, grid[2], &norm[2], &status);
+        ASSERT_EQ(0, status);
+        EXPECT_GT(norm[0], 0.0);
+        EXPECT_NEAR(norm[0], norm[1], 1e-10 * norm[0]);
+
+        // Threaded results must be identical to each other,
+        // and agree with the serial result to within rounding error.
+        double max_rel = 0.0, max_abs = 0.0;
+        for (int j = 0; j < 2 * grid_size; ++j)
+        {
+            double v0, v1, v2;
+            if (type == OSKAR_DOUBLE)
+            {
+                v0 = oskar_mem_double(grid[0], &status)[j];
+                v1 = oskar_mem_double(grid[1], &status)[j];
+                v2 = oskar_mem_double(grid[2], &status)[j];
+            }
+            else
+            {
+                v0 = oskar_mem_float(grid[0], &status)[j];
+                v1 = oskar_mem_float(grid[1], &status)[j];
+                v2 = oskar_mem_float(grid[2], &status)[j];
+            }
+            ASSERT_EQ(v1, v2);
+            if (fabs(v0) > max_abs) max_abs = fabs(v0);
+            if (fabs(v1 - v0) > max_rel) max_rel = fabs(v1 - v0);
+        }
+        EXPECT_GT(max_abs, 0.0);
+        EXPECT_LT(max_rel / max_abs, type == OSKAR_DOUBLE ? 1e-10 : 1e-4);
+        EXPECT_EQ(norm[1], norm[2]);
+        for (int i = 0; i < 3; ++i) oskar_mem_free(grid[i], &status);
+    }
+}
+
+TEST(imager, grid_threads)
+{
+    compare_grid_threads("FFT", 1024);
+}
+
+TEST(imager, grid_threads_wproj)
+{
+    compare_grid_threads("W-projection", 256);
+}
+
+static void image_random_vis(int type, int num_threads, int size,
+        int num_grids, oskar_Mem** grids, int* status)
+{
+    // Create and set up the imager to make one plane per channel
+    // and polarisation.
+    int num_rows = 20000, num_chan = 4, num_pols = 4;
+    oskar_Imager* im = oskar_imager_create(type, status);
+    oskar_imager_set_fov(im, 5.0);
+    oskar_imager_set_size(im, size, status);
+    oskar_imager_set_image_type(im, "Linear", status);
+    oskar_imager_set_channel_snapshots(im, 1);
+    oskar_imager_set_vis_frequency(im, 100e6, 1e6, num_chan);
+    oskar_imager_set_vis_phase_centre(im, 0.0, 60.0);
+    oskar_imager_set_num_grid_threads(im, num_threads);
+
+    // Create visibility data.
+    oskar_Mem* uu = oskar_mem_create(type, OSKAR_CPU, num_rows, status);
+    oskar_Mem* vv = oskar_mem_create(type, OSKAR_CPU, num_rows, status);
+    oskar_Mem* ww = oskar_mem_create(type, OSKAR_CPU, num_rows, status);
+    oskar_Mem* amp = oskar_mem_create(type | OSKAR_COMPLEX | OSKAR_MATRIX,
+            OSKAR_CPU, num_rows * num_chan, status);
+    oskar_Mem* weight = oskar_mem_create(type, OSKAR_CPU,
+            num_rows * num_pols, status);
+    oskar_mem_random_gaussian(uu, 0, 1, 2, 3, 2000.0, status);
+    oskar_mem_random_gaussian(vv, 4, 5, 6, 7, 2000.0, status);
+    oskar_mem_random_gaussian(amp, 8, 9, 10, 11, 1.0, status);
+    oskar_mem_set_value_real(weight, 1.0, 0, num_rows * num_pols, status);
+
+    // Grid visibility data.
+    oskar_imager_update(im, num_rows, 0, num_chan - 1, num_pols,
+            uu, vv, ww, amp, weight, 0, status);
+    oskar_imager_finalise(im, 0, 0, num_grids, grids, status);
+
+    // Clean up.
+    oskar_imager_free(im, status);
+    oskar_mem_free(uu, status);
+    oskar_mem_free(vv, status);
+    oskar_mem_free(ww, status);
+    oskar_mem_free(amp, status);
+    oskar_mem_free(weight, status);
+}
+
+TEST(imager, plane_threads)
+{
+    // Update 16 planes using 1, 4 and 32 threads.
+    // With 4 threads, planes are gridded concurrently; with 32, they are
+    // gridded in turn, using all the threads for each one. Both must use
+    // the same gridder, so the results must be identical, and agree with
+    // the serial result to within rounding error.
+    int status = 0, size = 256, num_grids = 16;
+    oskar_Mem *grids[3][16];
+    int num_threads[] = {1, 4, 32};
+    for (int k = 0; k < 3; ++k)
+    {
+        for (int i = 0; i < num_grids; ++i) grids[k][i] = 0;
+        image_random_vis(OSKAR_DOUBLE, num_threads[k], size, num_grids,
+                grids[k], &status);
+    }
+    ASSERT_EQ(0, status);
+    for (int i = 0; i < num_grids; ++i)
+    {
+        ASSERT_TRUE(grids[0][i] != 0);
+        ASSERT_TRUE(grids[1][i] != 0);
+        ASSERT_TRUE(grids[2][i] != 0);
+        const double* t0 = oskar_mem_double_const(grids[0][i], &status);
+        const double* t1 = oskar_mem_double_const(grids[1][i], &status);
+        const double* t2 = oskar_mem_double_const(grids[2][i], &status);
+        double max_abs = 0.0, max_diff = 0.0;
+        for (int j = 0; j < 2 * size * size; ++j)
+        {
+            ASSERT_EQ(t1[j], t2[j]) << "Plane " << i;
+            if (fabs(t0[j]) > max_abs) max_abs = fabs(t0[j]);
+            if (fabs(t1[j] - t0[j]) > max_diff) max_diff = fabs(t1[j] - t0[j]);
+        }
+        EXPECT_GT(max_abs, 0.0) << "Plane " << i;
+        EXPECT_LT(max_diff / max_abs, 1e-10) << "Plane " << i;
+        for (int k = 0; k < 3; ++k) oskar_mem_free(grids[k][i], &status);
+    }
+}
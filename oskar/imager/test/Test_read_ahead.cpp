@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "binary/oskar_binary.h"
+#include "imager/oskar_imager.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static void write_test_vis(const char* filename, int* status)
+{
+    const int num_stations = 10, num_times = 9, max_times_per_block = 2;
+    const int num_channels = 3;
+    const int num_blocks = (num_times + max_times_per_block - 1) /
+            max_times_per_block;
+    oskar_VisHeader* hdr = oskar_vis_header_create(OSKAR_SINGLE_COMPLEX,
+            OSKAR_DOUBLE, max_times_per_block, num_times, num_channels,
+            num_channels, num_stations, 0, 1, status);
+    oskar_vis_header_set_phase_centre(hdr, 0, 20.0, 40.0);
+    oskar_vis_header_set_freq_start_hz(hdr, 100e6);
+    oskar_vis_header_set_freq_inc_hz(hdr, 1e6);
+    oskar_vis_header_set_time_start_mjd_utc(hdr, 57000.0);
+    oskar_vis_header_set_time_inc_sec(hdr, 10.0);
+    oskar_VisBlock* blk = oskar_vis_block_create_from_header(OSKAR_CPU,
+            hdr, status);
+    oskar_Binary* file = oskar_vis_header_write(hdr, filename, status);
+    for (int b = 0; b < num_blocks; ++b)
+    {
+        int block_times = num_times - b * max_times_per_block;
+        if (block_times > max_times_per_block)
+            block_times = max_times_per_block;
+        oskar_vis_block_set_num_times(blk, block_times, status);
+        oskar_vis_block_set_start_time_index(blk, b * max_times_per_block);
+        oskar_mem_random_gaussian(oskar_vis_block_baseline_uu_metres(blk),
+                b, 1, 2, 3, 200.0, status);
+        oskar_mem_random_gaussian(oskar_vis_block_baseline_vv_metres(blk),
+                b, 4, 5, 6, 200.0, status);
+        oskar_mem_random_gaussian(oskar_vis_block_baseline_ww_metres(blk),
+                b, 7, 8, 9, 10.0, status);
+        oskar_mem_random_gaussian(oskar_vis_block_cross_correlations(blk),
+                b, 10, 11, 12, 1.0, status);
+        oskar_vis_block_write(blk, file, b, status);
+    }
+    oskar_binary_free(file);
+    oskar_vis_block_free(blk, status);
+    oskar_vis_header_free(hdr, status);
+}
+
+static oskar_Mem* run_imager(const char* filename, int read_ahead,
+        int* status)
+{
+    oskar_Mem* image = 0;
+    oskar_Imager* im = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_fov(im, 4.0);
+    oskar_imager_set_size(im, 128, status);
+    oskar_imager_set_num_grid_threads(im, 1);
+    oskar_imager_set_read_ahead(im, read_ahead);
+    oskar_imager_set_input_files(im, 1, &filename, status);
+    oskar_imager_run(im, 1, &image, 0, 0, status);
+    oskar_imager_free(im, status);
+    return image;
+}
+
+TEST(imager, read_ahead)
+{
+    int status = 0;
+    const char* filename = "temp_test_imager_read_ahead.vis";
+    write_test_vis(filename, &status);
+    ASSERT_EQ(0, status);
+
+    // Images made with and without read-ahead must be identical.
+    oskar_Mem* image0 = run_imager(filename, 0, &status);
+    ASSERT_EQ(0, status);
+    ASSERT_EQ(128u * 128u, oskar_mem_length(image0));
+    double peak = 0.0;
+    for (size_t i = 0; i < oskar_mem_length(image0); ++i)
+        peak = std::max(peak, fabs(oskar_mem_double(image0, &status)[i]));
+    EXPECT_GT(peak, 0.0);
+    for (int read_ahead = 1; read_ahead <= 8; read_ahead *= 2)
+    {
+        oskar_Mem* image = run_imager(filename, read_ahead, &status);
+        ASSERT_EQ(0, status);
+        ASSERT_EQ(oskar_mem_length(image0), oskar_mem_length(image));
+        const double* a = oskar_mem_double_const(image0, &status);
+        const double* b = oskar_mem_double_const(image, &status);
+        for (size_t i = 0; i < oskar_mem_length(image); ++i)
+            ASSERT_EQ(a[i], b[i]) << "read_ahead = " << read_ahead;
+        oskar_mem_free(image, &status);
+    }
+    oskar_mem_free(image0, &status);
+    remove(filename);
+}
@@ -50,8 +50,14 @@ extern "C" {
  * Evaluates station beams for a telescope model at the specified source
  * positions, storing the results in the Jones matrix data structure.
  *
- * If all stations are marked as identical, the results for the first station
- * are copied into the results for the others.
+ * The dimensions of \p E are set to the number of stations in the
+ * telescope model by \p num_points.
+ *
+ * If station beam duplication is allowed, the beam is evaluated only once
+ * for each group of identical stations found by oskar_telescope_analyse(),
+ * and \p E holds only one row for each group, which is shared by all the
+ * stations in it (see oskar_jones_set_size_shared()). \p E then need only
+ * have been created with space for one row per group.
  *
  * @param[out] E            Output set of Jones matrices.
  * @param[in]  num_points   Number of direction cosines given.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -51,6 +51,9 @@ extern "C" {
  * array centre.
  *
  * The output set of Jones matrices (K) are scalar complex values.
+ * Stations are processed in parallel using OpenMP. If the vector math
+ * library is available (OSKAR_HAVE_VECTOR_MATH), the loops over sources
+ * are vectorised.
  *
  * @param[out] jones             Output set of Jones matrices.
  * @param[in]  num_sources       Number of sources.
@@ -83,6 +86,9 @@ void oskar_evaluate_jones_K_f(float2* jones, int num_sources, const float* l,
  * array centre.
  *
  * The output set of Jones matrices (K) are scalar complex values.
+ * Stations are processed in parallel using OpenMP. If the vector math
+ * library is available (OSKAR_HAVE_VECTOR_MATH), the loops over sources
+ * are vectorised.
  *
  * @param[out] jones             Output set of Jones matrices.
  * @param[in]  num_sources       Number of sources.
@@ -110,6 +110,10 @@ void oskar_evaluate_jones_R_d(double4c* jones, int num_sources,
  * ( cos(q)  -sin(q) )
  * ( sin(q)   cos(q) )
  *
+ * If station beam duplication is allowed, the matrices are evaluated only
+ * for the first station, and all stations share that row of \p R
+ * (see oskar_jones_set_size_shared()).
+ *
  * @param[out] R          Output set of Jones matrices.
  * @param[in] num_sources Number of sources to use from coordinate arrays.
  * @param[in] ra_rad      Input Right Ascension values, in radians.
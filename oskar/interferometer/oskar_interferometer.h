@@ -91,6 +91,14 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
 OSKAR_EXPORT
 void oskar_interferometer_run(oskar_Interferometer* h, int* status);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_bda(oskar_Interferometer* h, int enable,
+        double max_duration_sec, double max_uvw_distance_wavelengths);
+
+OSKAR_EXPORT
+void oskar_interferometer_set_block_callback(oskar_Interferometer* h,
+        void (*callback)(const oskar_VisBlock*, int, void*), void* user_data);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_coords_only(oskar_Interferometer* h, int value,
         int* status);
@@ -124,6 +132,10 @@ void oskar_interferometer_set_max_times_per_block(oskar_Interferometer* h,
 OSKAR_EXPORT
 void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_num_output_buffers(oskar_Interferometer* h,
+        int value);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels);
@@ -156,6 +168,10 @@ OSKAR_EXPORT
 void oskar_interferometer_set_source_flux_range(oskar_Interferometer* h,
         double min_jy, double max_jy);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_use_opencl(oskar_Interferometer* h, int value,
+        int* status);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_zero_failed_gaussians(oskar_Interferometer* h,
         int value);
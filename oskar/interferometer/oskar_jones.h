@@ -57,5 +57,6 @@ typedef struct oskar_Jones oskar_Jones;
 #include <interferometer/oskar_jones_join.h>
 #include <interferometer/oskar_jones_set_real_scalar.h>
 #include <interferometer/oskar_jones_set_size.h>
+#include <interferometer/oskar_jones_set_station_shared.h>
 
 #endif /* OSKAR_JONES_H_ */
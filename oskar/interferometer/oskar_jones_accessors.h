@@ -126,6 +126,57 @@ oskar_Mem* oskar_jones_mem(oskar_Jones* jones);
 OSKAR_EXPORT
 const oskar_Mem* oskar_jones_mem_const(const oskar_Jones* jones);
 
+/**
+ * @brief
+ * Returns the number of stations sharing the data of another station.
+ *
+ * @details
+ * Returns the number of stations that do not need a row of the matrix
+ * block of their own (the number of stations less the number of rows
+ * used), as set by oskar_jones_set_station_shared() or
+ * oskar_jones_set_size_shared(). This is zero only if each station uses
+ * its own row.
+ *
+ * @param[in]     jones  Pointer to data structure.
+ *
+ * @return The number of shared stations.
+ */
+OSKAR_EXPORT
+int oskar_jones_num_shared_stations(const oskar_Jones* jones);
+
+/**
+ * @brief
+ * Returns the index of the row holding the data for a station.
+ *
+ * @details
+ * Returns the index of the row of the matrix block that holds the data
+ * for the given station. This is the station index itself, unless
+ * the block has shared stations.
+ *
+ * @param[in]     jones   Pointer to data structure.
+ * @param[in]     station Station index.
+ *
+ * @return The row index.
+ */
+OSKAR_EXPORT
+int oskar_jones_station_row(const oskar_Jones* jones, int station);
+
+/**
+ * @brief
+ * Returns a read-only pointer to the station sharing map.
+ *
+ * @details
+ * Returns a read-only pointer to the integer array in CPU memory that
+ * gives the row index for each station. The contents are only valid for
+ * the first oskar_jones_num_stations() elements.
+ *
+ * @param[in]     jones  Pointer to data structure.
+ *
+ * @return A pointer to the memory structure.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_jones_station_map_const(const oskar_Jones* jones);
+
 /**
  * @brief
  * Returns a pointer to the matrix block as a float2.
@@ -44,6 +44,11 @@ extern "C" {
  * @brief Returns a pointer (contained in an oskar_Mem) to the set of Jones
  * matrices for a specified station index.
  *
+ * @details
+ * This always returns row \p station_index of the block, whether or not
+ * the station shares the data of another station: use
+ * oskar_jones_station_row() to find the row holding its data.
+ *
  * @param[out] J_station       oskar_Mem pointer to the set of Jones matrices
  *                             for the specified station.
  * @param[in]  J               OSKAR Jones structure containing Jones matrices
@@ -59,6 +59,14 @@ extern "C" {
  * size of J2. For example, J3 could be a full 2x2 complex matrix and J2 a
  * complex scalar, but not vice versa.
  *
+ * If either input has stations that share the data of another station
+ * (see oskar_jones_set_station_shared()), one row of the result is
+ * evaluated for each distinct pair of input rows, and the output holds
+ * only those rows (see oskar_jones_set_size_shared()), so that sharing
+ * common to both inputs is kept. An input that shares a single row between
+ * all stations (such as Jones R for identical stations) therefore keeps
+ * the sharing of the other input.
+ *
  * @param[in,out] j3 If not NULL, then pointer to the output data structure.
  * @param[in,out] j1 On input, pointer to data structure for the first set of
  *                   matrices; on output, the result, if \p j3 is NULL.
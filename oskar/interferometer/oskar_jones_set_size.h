@@ -47,6 +47,7 @@ extern "C" {
  * a resize.
  *
  * The new size must be less than or equal to the existing capacity.
+ * Any station sharing is cleared, so every station uses its own row.
  *
  * @param[in] jones Pointer to the structure.
  * @param[in] num_stations Number of elements in the station dimension.
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_JONES_SET_STATION_SHARED_H_
+#define OSKAR_JONES_SET_STATION_SHARED_H_
+
+/**
+ * @file oskar_jones_set_station_shared.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Marks a station as sharing the matrix data of another station.
+ *
+ * @details
+ * Points station \p station at the row of the Jones matrix block used by
+ * station \p source_station, so that the row is broadcast to both stations
+ * without copying any data.
+ *
+ * Rows are not owned by stations: any other stations that were using the
+ * same row as \p station keep using it, and its contents are left alone.
+ * Use oskar_jones_station_row() to find the row holding the data for a
+ * station, rather than assuming that it is the station index.
+ *
+ * Functions that read the block (oskar_jones_join(), oskar_cross_correlate()
+ * and oskar_auto_correlate()) honour the sharing.
+ *
+ * @param[in,out] jones          Pointer to data structure.
+ * @param[in]     station        Index of station to share data.
+ * @param[in]     source_station Index of station holding the data.
+ * @param[in,out] status         Status return code.
+ */
+OSKAR_EXPORT
+void oskar_jones_set_station_shared(oskar_Jones* jones, int station,
+        int source_station, int* status);
+
+/**
+ * @brief
+ * Sets the size of the block, holding only the rows used by the stations.
+ *
+ * @details
+ * Sets the dimensions of the Jones matrix block, and the row used by
+ * each station, so that only one row need be held for each group of
+ * stations that share the same data. Station i uses row
+ * \p station_rows[i], and the rows must be numbered in the order in
+ * which they are first used (so \p station_rows[0] is 0, and each
+ * subsequent value is at most one more than the largest before it).
+ *
+ * The block is enlarged if it is too small to hold the rows, but is not
+ * otherwise resized, so it may be created with space only for the number
+ * of distinct rows. No data are copied.
+ *
+ * @param[in,out] jones        Pointer to data structure.
+ * @param[in]     num_stations Number of elements in the station dimension.
+ * @param[in]     num_sources  Number of elements in the source dimension.
+ * @param[in]     station_rows Row index for each station.
+ * @param[in,out] status       Status return code.
+ */
+OSKAR_EXPORT
+void oskar_jones_set_size_shared(oskar_Jones* jones, int num_stations,
+        int num_sources, const int* station_rows, int* status);
+
+/**
+ * @brief
+ * Marks every station as holding its own matrix data.
+ *
+ * @details
+ * Resets the station sharing map so that each station uses its own row
+ * of the Jones matrix block, enlarging the block if it holds fewer rows
+ * than stations. No data are copied, so rows that were
+ * previously shared will hold stale values: this should be called before
+ * evaluating data for all stations. Use oskar_jones_expand_shared_stations()
+ * to keep the values of shared rows instead.
+ *
+ * @param[in,out] jones  Pointer to data structure.
+ * @param[in,out] status Status return code.
+ */
+OSKAR_EXPORT
+void oskar_jones_clear_shared_stations(oskar_Jones* jones, int* status);
+
+/**
+ * @brief
+ * Copies the data for shared stations into their own rows.
+ *
+ * @details
+ * Copies the data for each shared station into the row for that station,
+ * and then resets the station sharing map, so that the block can be passed
+ * to functions that do not consider the sharing. The block is enlarged
+ * first if it holds fewer rows than stations.
+ *
+ * @param[in,out] jones  Pointer to data structure.
+ * @param[in,out] status Status return code.
+ */
+OSKAR_EXPORT
+void oskar_jones_expand_shared_stations(oskar_Jones* jones, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_JONES_SET_STATION_SHARED_H_ */
@@ -38,6 +38,11 @@ struct oskar_Jones
     int cap_stations; /* Slowest varying dimension. */
     int cap_sources;  /* Fastest varying dimension. */
     oskar_Mem* data;  /* Matrix data. */
+
+    /* Row sharing: station i uses the data held in row station_map[i].
+     * Only the rows that are used need be held. */
+    int num_shared;          /* Number of stations less rows used. */
+    oskar_Mem* station_map;  /* Row index for each station (CPU, integer). */
 };
 
 #ifndef OSKAR_JONES_TYPEDEF_
@@ -27,9 +27,12 @@
  */
 
 #include "interferometer/oskar_evaluate_jones_E.h"
-#include "interferometer/oskar_jones_get_station_pointer.h"
+#include "interferometer/oskar_jones_accessors.h"
+#include "interferometer/oskar_jones_set_station_shared.h"
 #include "telescope/station/oskar_evaluate_station_beam.h"
 
+#include <stdlib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,6 +44,8 @@ void oskar_evaluate_jones_E(oskar_Jones* E, int num_points, int coord_type,
 {
     int i, num_stations;
     oskar_Mem *E_st;
+    size_t offset;
+    const oskar_Mem* type_map;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -54,48 +59,59 @@ void oskar_evaluate_jones_E(oskar_Jones* E, int num_points, int coord_type,
     }
 
     /* Evaluate the station beams. */
-    E_st = oskar_mem_create_alias(0, 0, 0, status);
+    type_map = oskar_telescope_station_type_map_const(tel);
     if (oskar_telescope_allow_station_beam_duplication(tel) &&
-            oskar_telescope_identical_stations(tel))
+            (int)oskar_mem_length(type_map) == num_stations)
     {
-        /* Identical stations. */
-        oskar_Mem *E0; /* Pointer to row of E for station 0. */
-        const oskar_Station* station0;
-
-        /* Evaluate the beam pattern for station 0 */
-        E0 = oskar_mem_create_alias(0, 0, 0, status);
-        station0 = oskar_telescope_station_const(tel, 0);
-        oskar_jones_get_station_pointer(E0, E, 0, status);
-
-        oskar_evaluate_station_beam(E0, num_points, coord_type, x, y, z,
-                oskar_telescope_phase_centre_ra_rad(tel),
-                oskar_telescope_phase_centre_dec_rad(tel),
-                station0, work, time_index, frequency_hz, gast, status);
+        /* Hold one row for each group of identical stations. */
+        int num_rows = 0, *rows;
+        const int* type_ = oskar_mem_int_const(type_map, status);
+        rows = (int*) malloc(num_stations * sizeof(int));
+        if (!rows)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            return;
+        }
+        for (i = 0; i < num_stations; ++i)
+            rows[i] = (type_[i] == i) ? num_rows++ : rows[type_[i]];
+        oskar_jones_set_size_shared(E, num_stations, num_points, rows,
+                status);
 
-        /* Copy E for station 0 into memory for other stations. */
-        for (i = 1; i < num_stations; ++i)
+        /* Evaluate one beam for each group. */
+        for (i = 0; i < num_stations; ++i)
         {
-            oskar_jones_get_station_pointer(E_st, E, i, status);
-            oskar_mem_copy_contents(E_st, E0, 0, 0,
-                    oskar_mem_length(E0), status);
+            const oskar_Station* station;
+            if (type_[i] != i) continue;
+            station = oskar_telescope_station_const(tel, i);
+            offset = (size_t)rows[i] * num_points;
+            E_st = oskar_mem_create_slice(oskar_jones_mem(E), offset,
+                    num_points, status);
+            oskar_evaluate_station_beam(E_st, num_points, coord_type,
+                    x, y, z, oskar_telescope_phase_centre_ra_rad(tel),
+                    oskar_telescope_phase_centre_dec_rad(tel),
+                    station, work, time_index, frequency_hz, gast, status);
+            oskar_mem_free_slice(E_st, oskar_jones_mem(E), offset, status);
         }
-        oskar_mem_free(E0, status);
+        free(rows);
     }
     else
     {
         /* Different stations. */
+        oskar_jones_set_size(E, num_stations, num_points, status);
         for (i = 0; i < num_stations; ++i)
         {
             const oskar_Station* station;
             station = oskar_telescope_station_const(tel, i);
-            oskar_jones_get_station_pointer(E_st, E, i, status);
+            offset = (size_t)i * num_points;
+            E_st = oskar_mem_create_slice(oskar_jones_mem(E), offset,
+                    num_points, status);
             oskar_evaluate_station_beam(E_st, num_points, coord_type, x, y, z,
                     oskar_telescope_phase_centre_ra_rad(tel),
                     oskar_telescope_phase_centre_dec_rad(tel),
                     station, work, time_index, frequency_hz, gast, status);
+            oskar_mem_free_slice(E_st, oskar_jones_mem(E), offset, status);
         }
     }
-    oskar_mem_free(E_st, status);
 }
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -28,6 +28,7 @@
 
 #include "interferometer/oskar_evaluate_jones_K.h"
 #include "interferometer/oskar_evaluate_jones_K_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 #include "math/oskar_cmath.h"
 
@@ -35,6 +36,105 @@
 extern "C" {
 #endif
 
+#ifdef OSKAR_HAVE_VECTOR_MATH
+/* glibc declares the vector (libmvec) variants of these functions only
+ * when compiling with -ffast-math, so declare them here instead. */
+__attribute__((__simd__("notinbranch"))) double cos(double);
+__attribute__((__simd__("notinbranch"))) double sin(double);
+__attribute__((__simd__("notinbranch"))) float cosf(float);
+__attribute__((__simd__("notinbranch"))) float sinf(float);
+#endif
+
+/*
+ * Filtered sources are masked rather than skipped,
+ * so that the loops over sources can be vectorised.
+ *
+ * If a vector math library is available, cos() and sin() are evaluated
+ * in separate loops, as otherwise the compiler would combine them into a
+ * call to sincos(), which has no vector variant.
+ */
+
+static void evaluate_station_f(float2* restrict station_ptr, int num_sources,
+        const float* l, const float* m, const float* n,
+        float us, float vs, float ws, const float* source_filter,
+        float source_filter_min, float source_filter_max)
+{
+    int s;
+#ifdef OSKAR_HAVE_VECTOR_MATH
+#pragma omp simd
+    for (s = 0; s < num_sources; ++s)
+    {
+        float phase, mask;
+        mask = (source_filter[s] > source_filter_min &&
+                source_filter[s] <= source_filter_max) ? 1.0f : 0.0f;
+        phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0f);
+        station_ptr[s].x = mask * cosf(phase);
+    }
+#pragma omp simd
+    for (s = 0; s < num_sources; ++s)
+    {
+        float phase, mask;
+        mask = (source_filter[s] > source_filter_min &&
+                source_filter[s] <= source_filter_max) ? 1.0f : 0.0f;
+        phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0f);
+        station_ptr[s].y = mask * sinf(phase);
+    }
+#else
+#pragma omp simd
+    for (s = 0; s < num_sources; ++s)
+    {
+        float phase, mask;
+        mask = (source_filter[s] > source_filter_min &&
+                source_filter[s] <= source_filter_max) ? 1.0f : 0.0f;
+        phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0f);
+        /* Double precision versions are converted to sincos() by the
+         * compiler, so they're faster and more accurate
+         * than sinf(), cosf(). */
+        station_ptr[s].x = mask * cos(phase);
+        station_ptr[s].y = mask * sin(phase);
+    }
+#endif
+}
+
+static void evaluate_station_d(double2* restrict station_ptr,
+        int num_sources, const double* l, const double* m, const double* n,
+        double us, double vs, double ws, const double* source_filter,
+        double source_filter_min, double source_filter_max)
+{
+    int s;
+#ifdef OSKAR_HAVE_VECTOR_MATH
+#pragma omp simd
+    for (s = 0; s < num_sources; ++s)
+    {
+        double phase, mask;
+        mask = (source_filter[s] > source_filter_min &&
+                source_filter[s] <= source_filter_max) ? 1.0 : 0.0;
+        phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0);
+        station_ptr[s].x = mask * cos(phase);
+    }
+#pragma omp simd
+    for (s = 0; s < num_sources; ++s)
+    {
+        double phase, mask;
+        mask = (source_filter[s] > source_filter_min &&
+                source_filter[s] <= source_filter_max) ? 1.0 : 0.0;
+        phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0);
+        station_ptr[s].y = mask * sin(phase);
+    }
+#else
+#pragma omp simd
+    for (s = 0; s < num_sources; ++s)
+    {
+        double phase, mask;
+        mask = (source_filter[s] > source_filter_min &&
+                source_filter[s] <= source_filter_max) ? 1.0 : 0.0;
+        phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0);
+        station_ptr[s].x = mask * cos(phase);
+        station_ptr[s].y = mask * sin(phase);
+    }
+#endif
+}
+
 /* Single precision. */
 void oskar_evaluate_jones_K_f(float2* jones, int num_sources, const float* l,
         const float* m, const float* n, int num_stations,
@@ -42,46 +142,15 @@ void oskar_evaluate_jones_K_f(float2* jones, int num_sources, const float* l,
         const float* source_filter, float source_filter_min,
         float source_filter_max)
 {
-    int a, s;
+    int a;
 
     /* Loop over stations. */
+#pragma omp parallel for private(a)
     for (a = 0; a < num_stations; ++a)
     {
-        float us, vs, ws;
-        float2* station_ptr;
-
-        /* Get the station data. */
-        station_ptr = &jones[a * num_sources];
-        us = wavenumber * u[a];
-        vs = wavenumber * v[a];
-        ws = wavenumber * w[a];
-
-        /* Loop over sources. */
-        for (s = 0; s < num_sources; ++s)
-        {
-            float phase;
-            float2 weight;
-
-            /* Calculate the source phase. */
-            if (source_filter[s] > source_filter_min &&
-                    source_filter[s] <= source_filter_max)
-            {
-                phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0f);
-                /* Double precision versions are converted to sincos() by the
-                 * compiler, so they're faster and more accurate
-                 * than sinf(), cosf(). */
-                weight.x = cos(phase);
-                weight.y = sin(phase);
-            }
-            else
-            {
-                weight.x = 0.0f;
-                weight.y = 0.0f;
-            }
-
-            /* Store the result. */
-            station_ptr[s] = weight;
-        }
+        evaluate_station_f(&jones[a * num_sources], num_sources, l, m, n,
+                wavenumber * u[a], wavenumber * v[a], wavenumber * w[a],
+                source_filter, source_filter_min, source_filter_max);
     }
 }
 
@@ -92,43 +161,15 @@ void oskar_evaluate_jones_K_d(double2* jones, int num_sources, const double* l,
         const double* source_filter, double source_filter_min,
         double source_filter_max)
 {
-    int a, s;
+    int a;
 
     /* Loop over stations. */
+#pragma omp parallel for private(a)
     for (a = 0; a < num_stations; ++a)
     {
-        double us, vs, ws;
-        double2* station_ptr;
-
-        /* Get the station data. */
-        station_ptr = &jones[a * num_sources];
-        us = wavenumber * u[a];
-        vs = wavenumber * v[a];
-        ws = wavenumber * w[a];
-
-        /* Loop over sources. */
-        for (s = 0; s < num_sources; ++s)
-        {
-            double phase;
-            double2 weight;
-
-            /* Calculate the source phase. */
-            if (source_filter[s] > source_filter_min &&
-                    source_filter[s] <= source_filter_max)
-            {
-                phase = us * l[s] + vs * m[s] + ws * (n[s] - 1.0);
-                weight.x = cos(phase);
-                weight.y = sin(phase);
-            }
-            else
-            {
-                weight.x = 0.0;
-                weight.y = 0.0;
-            }
-
-            /* Store the result. */
-            station_ptr[s] = weight;
-        }
+        evaluate_station_d(&jones[a * num_sources], num_sources, l, m, n,
+                wavenumber * u[a], wavenumber * v[a], wavenumber * w[a],
+                source_filter, source_filter_min, source_filter_max);
     }
 }
 
@@ -182,7 +223,85 @@ void oskar_evaluate_jones_K(oskar_Jones* K, int num_sources,
     }
 
     /* Evaluate Jones matrices. */
-    if (location == OSKAR_GPU)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k;
+        cl_int error, n_src, n_stat;
+        cl_uint arg = 0;
+        const int is_dbl = (jones_type == OSKAR_DOUBLE_COMPLEX);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_sources + local_size - 1) /
+                local_size) * local_size;
+        k = is_dbl ? oskar_cl_kernel("evaluate_jones_K_double") :
+                oskar_cl_kernel("evaluate_jones_K_float");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        n_src = (cl_int) num_sources;
+        n_stat = (cl_int) num_stations;
+        error = clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(oskar_jones_mem(K), status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &n_src);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(l, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(m, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(n, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &n_stat);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(u, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(v, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(w, status));
+        if (is_dbl)
+        {
+            const cl_double k_ = (cl_double) wavenumber;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &k_);
+        }
+        else
+        {
+            const cl_float k_ = (cl_float) wavenumber;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &k_);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(source_filter, status));
+        if (is_dbl)
+        {
+            const cl_double f_min = (cl_double) source_filter_min;
+            const cl_double f_max = (cl_double) source_filter_max;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &f_min);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &f_max);
+        }
+        else
+        {
+            const cl_float f_min = (cl_float) source_filter_min;
+            const cl_float f_max = (cl_float) source_filter_max;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &f_min);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &f_max);
+        }
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_sources > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (location == OSKAR_GPU)
     {
 #ifdef OSKAR_HAVE_CUDA
         if (jones_type == OSKAR_SINGLE_COMPLEX)
@@ -0,0 +1,32 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void evaluate_jones_K_REAL(global REAL2* restrict jones,
+        const int num_sources,
+        global const REAL* restrict l,
+        global const REAL* restrict m,
+        global const REAL* restrict n,
+        const int num_stations,
+        global const REAL* restrict u,
+        global const REAL* restrict v,
+        global const REAL* restrict w,
+        const REAL wavenumber,
+        global const REAL* restrict source_filter,
+        const REAL source_filter_min,
+        const REAL source_filter_max)
+{
+    // One work-item per source; loop over stations.
+    const int s = get_global_id(0);
+    if (s >= num_sources) return;
+    const REAL f = source_filter[s];
+    const REAL mask = (f > source_filter_min && f <= source_filter_max) ?
+            (REAL) 1. : (REAL) 0.;
+    const REAL l_ = wavenumber * l[s];
+    const REAL m_ = wavenumber * m[s];
+    const REAL n_ = wavenumber * (n[s] - (REAL) 1.);
+    for (int a = 0; a < num_stations; ++a) {
+        REAL re, im;
+        const REAL phase = u[a] * l_ + v[a] * m_ + w[a] * n_;
+        im = sincos(phase, &re);
+        jones[a * num_sources + s] = (REAL2)(mask * re, mask * im);
+    }
+}
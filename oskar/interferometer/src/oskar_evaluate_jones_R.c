@@ -27,11 +27,13 @@
  */
 
 #include <math.h>
+#include <stdlib.h>
 
 #include "interferometer/oskar_jones.h"
 #include "interferometer/oskar_evaluate_jones_R.h"
 #include "interferometer/oskar_evaluate_jones_R_cuda.h"
 #include "sky/oskar_parallactic_angle.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
 #ifdef __cplusplus
@@ -164,7 +166,80 @@ void oskar_evaluate_jones_R(oskar_Jones* R, int num_sources,
 
     /* Evaluate Jones matrix for each source for appropriate stations. */
     R_station = oskar_mem_create_alias(0, 0, 0, status);
-    if (location == OSKAR_GPU)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k;
+        cl_int error, n_src, offset;
+        const int is_dbl = (base_type == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_sources + local_size - 1) /
+                local_size) * local_size;
+        k = is_dbl ? oskar_cl_kernel("evaluate_jones_R_double") :
+                oskar_cl_kernel("evaluate_jones_R_float");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            oskar_mem_free(R_station, status);
+            return;
+        }
+        n_src = (cl_int) num_sources;
+        for (i = 0; i < n && !*status; ++i)
+        {
+            cl_uint arg = 0;
+            const oskar_Station* station;
+
+            /* Get station data. Each station writes at an offset into the
+             * whole block, as sub-buffers must be aligned. */
+            station = oskar_telescope_station_const(telescope, i);
+            latitude = oskar_station_lat_rad(station);
+            lst = gast + oskar_station_lon_rad(station);
+            offset = (cl_int) (i * oskar_jones_num_sources(R));
+
+            /* Set kernel arguments. */
+            error = clSetKernelArg(k, arg++, sizeof(cl_int), &n_src);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                    oskar_mem_cl_buffer_const(ra_rad, status));
+            error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                    oskar_mem_cl_buffer_const(dec_rad, status));
+            if (is_dbl)
+            {
+                const cl_double cos_lat = (cl_double) cos(latitude);
+                const cl_double sin_lat = (cl_double) sin(latitude);
+                const cl_double lst_ = (cl_double) lst;
+                error |= clSetKernelArg(k, arg++, sizeof(cl_double), &cos_lat);
+                error |= clSetKernelArg(k, arg++, sizeof(cl_double), &sin_lat);
+                error |= clSetKernelArg(k, arg++, sizeof(cl_double), &lst_);
+            }
+            else
+            {
+                const cl_float cos_lat = (cl_float) cos(latitude);
+                const cl_float sin_lat = (cl_float) sin(latitude);
+                const cl_float lst_ = (cl_float) lst;
+                error |= clSetKernelArg(k, arg++, sizeof(cl_float), &cos_lat);
+                error |= clSetKernelArg(k, arg++, sizeof(cl_float), &sin_lat);
+                error |= clSetKernelArg(k, arg++, sizeof(cl_float), &lst_);
+            }
+            error |= clSetKernelArg(k, arg++, sizeof(cl_int), &offset);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                    oskar_mem_cl_buffer(oskar_jones_mem(R), status));
+            if (!*status && error != CL_SUCCESS)
+                *status = OSKAR_ERR_INVALID_ARGUMENT;
+            if (!*status && num_sources > 0)
+            {
+                /* Launch kernel on current command queue. */
+                error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                        NULL, &global_size, &local_size, 0, NULL, &event);
+                if (error != CL_SUCCESS)
+                    *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+            }
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (location == OSKAR_GPU)
     {
 #ifdef OSKAR_HAVE_CUDA
         for (i = 0; i < n; ++i)
@@ -232,20 +307,20 @@ void oskar_evaluate_jones_R(oskar_Jones* R, int num_sources,
         }
     }
 
-    /* Copy data for station 0 to stations 1 to n, if using a common sky. */
+    /* Share the data for station 0 with all stations, if using a common
+     * sky, so that joins with Jones R keep any sharing of the other term. */
     if (oskar_telescope_allow_station_beam_duplication(telescope))
     {
-        oskar_Mem* R0;
-        R0 = oskar_mem_create_alias(0, 0, 0, status);
-        oskar_jones_get_station_pointer(R0, R, 0, status);
-        for (i = 1; i < num_stations; ++i)
-        {
-            oskar_jones_get_station_pointer(R_station, R, i, status);
-            oskar_mem_copy_contents(R_station, R0, 0, 0,
-                    oskar_mem_length(R0), status);
-        }
-        oskar_mem_free(R0, status);
+        int* rows = (int*) calloc(num_stations, sizeof(int));
+        if (rows)
+            oskar_jones_set_size_shared(R, num_stations,
+                    oskar_jones_num_sources(R), rows, status);
+        else
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        free(rows);
     }
+    else
+        oskar_jones_clear_shared_stations(R, status);
     oskar_mem_free(R_station, status);
 }
 
@@ -0,0 +1,19 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void evaluate_jones_R_REAL(const int num_sources,
+        global const REAL* restrict ra_rad,
+        global const REAL* restrict dec_rad,
+        const REAL cos_lat, const REAL sin_lat, const REAL lst_rad,
+        const int offset_out, global REAL8* restrict jones)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    REAL sin_dec, cos_dec, sin_ha, cos_ha, sin_q, cos_q;
+    sin_dec = sincos(dec_rad[i], &cos_dec);
+    sin_ha = sincos(lst_rad - ra_rad[i], &cos_ha);
+    const REAL y = cos_lat * sin_ha;
+    const REAL x = sin_lat * cos_dec - cos_lat * sin_dec * cos_ha;
+    sin_q = sincos(atan2(y, x), &cos_q);
+    jones[i + offset_out] = (REAL8)(cos_q, (REAL) 0., -sin_q, (REAL) 0.,
+            sin_q, (REAL) 0., cos_q, (REAL) 0.);
+}
@@ -41,12 +41,15 @@
 #include "log/oskar_log.h"
 #include "sky/oskar_sky.h"
 #include "telescope/oskar_telescope.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_cuda_mem_log.h"
 #include "utility/oskar_device_utils.h"
 #include "utility/oskar_get_memory_usage.h"
 #include "utility/oskar_get_num_procs.h"
 #include "utility/oskar_thread.h"
 #include "utility/oskar_timer.h"
+#include "vis/oskar_bda.h"
+#include "vis/oskar_bda_write_ms.h"
 #include "vis/oskar_vis_block.h"
 #include "vis/oskar_vis_block_write_ms.h"
 #include "vis/oskar_vis_header.h"
@@ -65,20 +68,34 @@
 extern "C" {
 #endif
 
+/* Maximum number of channels correlated together in one sweep over
+ * the sources, and total memory allowed for their extra Jones E matrices,
+ * shared between all compute devices. */
+#define MAX_CHANNEL_BATCH 8
+#define MAX_CHANNEL_BATCH_BYTES (256 << 20)
+
 /* Memory allocated per compute device (may be either CPU or GPU). */
 struct DeviceData
 {
     /* Host memory. */
     oskar_VisBlock* vis_block_cpu[2]; /* On host, for copy back & write. */
 
+    /* Work queues: ranges of work unit indices, one per buffered block. */
+    oskar_Mutex* queue_lock;
+    int queue_begin[2], queue_end[2];
+
     /* Device memory. */
     int previous_chunk_index;
+    int apply_K;                /* If set, Jones K and J are formed. */
     oskar_VisBlock* vis_block;  /* Device memory block. */
     oskar_Mem *u, *v, *w;
     oskar_Sky* chunk;           /* The unmodified sky chunk being processed. */
     oskar_Sky* chunk_clip;      /* Copy of the chunk after horizon clipping. */
     oskar_Telescope* tel;       /* Telescope model, created as a copy. */
     oskar_Jones *J, *R, *E, *K, *Z;
+    int num_channel_batch;      /* Number of channels correlated together. */
+    oskar_Jones* E_batch[MAX_CHANNEL_BATCH]; /* Jones E for each channel. */
+    oskar_Sky* sky_batch[MAX_CHANNEL_BATCH]; /* Sky chunk for each channel. */
     oskar_StationWork* station_work;
 
     /* Timers. */
@@ -92,22 +109,44 @@ struct DeviceData
 };
 typedef struct DeviceData DeviceData;
 
+/* Output sinks, each of which is written by its own thread. */
+enum OSKAR_INTERFEROMETER_SINK
+{
+    SINK_VIS,
+    SINK_MS,
+    SINK_CALLBACK,
+    NUM_SINKS
+};
+
 
 struct oskar_Interferometer
 {
     /* Settings. */
-    int prec, num_devices, num_gpus, *gpu_ids, num_channels, num_time_steps;
+    int prec, dev_loc, num_devices, num_gpus, *gpu_ids;
+    int num_channels, num_time_steps;
     int max_sources_per_chunk, max_times_per_block;
     int apply_horizon_clip, force_polarised_ms, zero_failed_gaussians;
-    int coords_only;
+    int coords_only, bda_enabled;
     double freq_start_hz, freq_inc_hz, time_start_mjd_utc, time_inc_sec;
     double source_min_jy, source_max_jy;
+    double bda_max_duration_sec, bda_max_uvw_wavelengths;
     char correlation_type, *vis_name, *ms_name, *settings_path;
 
     /* State. */
-    int init_sky, work_unit_index, status;
+    int init_sky, status;
     oskar_Mutex* mutex;
-    oskar_Barrier* barrier;
+
+    /* Work scheduler state, one per buffered block. */
+    int queue_block_index[2], num_devices_done[2], num_blocks_combined;
+    oskar_ConditionVar* block_cond;
+
+    /* Output stage: a ring of combined blocks on the host, which is
+     * shared by the sinks, and the number of blocks written to each sink. */
+    int num_output_buffers, num_sinks, sinks[NUM_SINKS];
+    int num_blocks_written[NUM_SINKS];
+    oskar_VisBlock** output_blocks;
+    void (*block_callback)(const oskar_VisBlock*, int, void*);
+    void* block_callback_data;
 
     /* Sky model and telescope model. */
     int num_sources_total, num_sky_chunks;
@@ -118,10 +157,11 @@ struct oskar_Interferometer
     oskar_Log* log;
     oskar_VisHeader* header;
     oskar_MeasurementSet* ms;
+    oskar_BDA* bda; /* Baseline-dependent averaging of Measurement Set. */
     oskar_Binary* vis;
     oskar_Mem* temp;
     oskar_Timer* tmr_sim;   /* The total time for the simulation. */
-    oskar_Timer* tmr_write; /* The time spent writing vis blocks. */
+    oskar_Timer* tmr_write[NUM_SINKS]; /* The time spent writing blocks. */
 
     /* Array of DeviceData structures, one per compute device. */
     DeviceData* d;
@@ -134,10 +174,21 @@ typedef struct oskar_Interferometer oskar_Interferometer;
 
 /* Private method prototypes. */
 
+static void sim_time(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, double gast, int* status);
 static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
-        oskar_Sky* sky, int channel_index_block, int time_index_block,
-        int time_index_simulation, int* status);
+        oskar_Sky* sky, int channel_index_block, int num_channels_batch,
+        int time_index_block, int time_index_simulation, double gast,
+        int* status);
+static void fill_work_queues(oskar_Interferometer* h, int block_index);
+static int next_work_unit(oskar_Interferometer* h, int device_id,
+        int block_index, int num_times_block);
 static void free_device_data(oskar_Interferometer* h, int* status);
+static void set_device(const oskar_Interferometer* h, int id, int* status);
+static void free_output_buffers(oskar_Interferometer* h, int* status);
+static void set_up_output_buffers(oskar_Interferometer* h, int* status);
+static void write_sink(oskar_Interferometer* h, int sink,
+        const oskar_VisBlock* block, int block_index, int* status);
 static void set_up_device_data(oskar_Interferometer* h, int* status);
 static void set_up_vis_header(oskar_Interferometer* h, int* status);
 static void record_timing(oskar_Interferometer* h);
@@ -208,23 +259,28 @@ int oskar_interferometer_coords_only(const oskar_Interferometer* h)
 
 oskar_Interferometer* oskar_interferometer_create(int precision, int* status)
 {
+    int i;
     oskar_Interferometer* h = 0;
     h = (oskar_Interferometer*) calloc(1, sizeof(oskar_Interferometer));
     h->prec      = precision;
     h->tmr_sim   = oskar_timer_create(OSKAR_TIMER_NATIVE);
-    h->tmr_write = oskar_timer_create(OSKAR_TIMER_NATIVE);
+    for (i = 0; i < NUM_SINKS; ++i)
+        h->tmr_write[i] = oskar_timer_create(OSKAR_TIMER_NATIVE);
     h->temp      = oskar_mem_create(precision, OSKAR_CPU, 0, status);
     h->mutex     = oskar_mutex_create();
-    h->barrier   = oskar_barrier_create(0);
+    h->block_cond = oskar_condition_create();
+    oskar_interferometer_reset_work_unit_index(h);
 
     /* Set sensible defaults. */
     h->max_sources_per_chunk = 16384;
+    h->dev_loc = OSKAR_GPU;
     oskar_interferometer_set_gpus(h, -1, 0, status);
     oskar_interferometer_set_num_devices(h, -1);
     oskar_interferometer_set_correlation_type(h, "Cross-correlations", status);
     oskar_interferometer_set_horizon_clip(h, 1);
     oskar_interferometer_set_source_flux_range(h, -DBL_MAX, DBL_MAX);
     oskar_interferometer_set_max_times_per_block(h, 10);
+    oskar_interferometer_set_num_output_buffers(h, 3);
     return h;
 }
 
@@ -302,7 +358,7 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status)
     int i;
     if (!h) return;
     oskar_interferometer_reset_cache(h, status);
-    for (i = 0; i < h->num_gpus; ++i)
+    for (i = 0; i < h->num_gpus && h->dev_loc == OSKAR_GPU; ++i)
     {
         oskar_device_set(h->gpu_ids[i], status);
         oskar_device_reset();
@@ -312,9 +368,10 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status)
     oskar_telescope_free(h->tel, status);
     oskar_mem_free(h->temp, status);
     oskar_timer_free(h->tmr_sim);
-    oskar_timer_free(h->tmr_write);
+    for (i = 0; i < NUM_SINKS; ++i)
+        oskar_timer_free(h->tmr_write[i]);
     oskar_mutex_free(h->mutex);
-    oskar_barrier_free(h->barrier);
+    oskar_condition_free(h->block_cond);
     free(h->sky_chunks);
     free(h->gpu_ids);
     free(h->vis_name);
@@ -347,20 +404,33 @@ int oskar_interferometer_num_vis_blocks(const oskar_Interferometer* h)
 void oskar_interferometer_reset_cache(oskar_Interferometer* h, int* status)
 {
     free_device_data(h, status);
+    free_output_buffers(h, status);
     oskar_binary_free(h->vis);
     oskar_vis_header_free(h->header, status);
+    oskar_bda_free(h->bda);
 #ifndef OSKAR_NO_MS
     oskar_ms_close(h->ms);
 #endif
     h->vis = 0;
     h->header = 0;
+    h->bda = 0;
     h->ms = 0;
 }
 
 
 void oskar_interferometer_reset_work_unit_index(oskar_Interferometer* h)
 {
-    h->work_unit_index = 0;
+    int i;
+    oskar_condition_lock(h->block_cond);
+    for (i = 0; i < 2; ++i)
+    {
+        h->queue_block_index[i] = -1;
+        h->num_devices_done[i] = 0;
+    }
+    h->num_blocks_combined = 0;
+    for (i = 0; i < NUM_SINKS; ++i)
+        h->num_blocks_written[i] = 0;
+    oskar_condition_unlock(h->block_cond);
 }
 
 
@@ -385,7 +455,7 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
 
     /* Set the GPU to use. (Supposed to be a very low-overhead call.) */
     if (device_id >= 0 && device_id < h->num_gpus)
-        oskar_device_set(h->gpu_ids[device_id], status);
+        set_device(h, h->gpu_ids[device_id], status);
 
     /* Clear the visibility block. */
     i_active = block_index % 2; /* Index of the active buffer. */
@@ -409,17 +479,22 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
     oskar_vis_block_set_num_times(d->vis_block, num_times_block, status);
     oskar_vis_block_set_start_time_index(d->vis_block, time_index_start);
 
+    /* Fill the work queues for this block, if no other device has yet. */
+    oskar_condition_lock(h->block_cond);
+    fill_work_queues(h, block_index);
+    oskar_condition_unlock(h->block_cond);
+
     /* Go though all possible work units in the block. A work unit is defined
      * as the simulation for one time and one sky chunk. */
     while (!h->coords_only)
     {
         oskar_Sky* sky;
-        int i_work_unit, i_chunk, i_time, i_channel, sim_time_idx;
+        int i_work_unit, i_chunk, i_time, i_channel, sim_time_idx, n_batch;
+        double gast;
 
-        oskar_mutex_lock(h->mutex);
-        i_work_unit = (h->work_unit_index)++;
-        oskar_mutex_unlock(h->mutex);
-        if ((i_work_unit >= num_times_block * total_chunks) || *status) break;
+        i_work_unit = next_work_unit(h, device_id, block_index,
+                num_times_block);
+        if (i_work_unit < 0 || *status) break;
 
         /* Convert slice index to chunk/time index. */
         i_chunk      = i_work_unit / num_times_block;
@@ -434,23 +509,29 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
             oskar_timer_pause(d->tmr_copy);
         }
         sky = h->apply_horizon_clip ? d->chunk_clip : d->chunk;
+        gast = oskar_convert_mjd_to_gast_fast(
+                obs_start_mjd + dt_dump_days * (sim_time_idx + 0.5));
 
         /* Apply horizon clip if required. */
         if (h->apply_horizon_clip)
         {
-            double gast, mjd;
-            mjd = obs_start_mjd + dt_dump_days * (sim_time_idx + 0.5);
-            gast = oskar_convert_mjd_to_gast_fast(mjd);
             oskar_timer_resume(d->tmr_clip);
             oskar_sky_horizon_clip(d->chunk_clip, d->chunk, d->tel, gast,
                     d->station_work, status);
             oskar_timer_pause(d->tmr_clip);
         }
 
-        /* Simulate all baselines for all channels for this time and chunk. */
-        for (i_channel = 0; i_channel < num_channels; ++i_channel)
+        /* Evaluate the frequency-independent terms for this time. */
+        sim_time(h, d, sky, gast, status);
+
+        /* Simulate all baselines for all channels for this time and chunk,
+         * correlating up to d->num_channel_batch channels together. */
+        for (i_channel = 0; i_channel < num_channels; i_channel += n_batch)
         {
             if (*status) break;
+            n_batch = num_channels - i_channel;
+            if (n_batch > d->num_channel_batch)
+                n_batch = d->num_channel_batch;
             if (h->log)
             {
                 oskar_mutex_lock(h->mutex);
@@ -458,11 +539,12 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
                         "Chunk %*i/%i, Channel %*i/%i [Device %i, %i sources]",
                         disp_width(total_times), sim_time_idx + 1, total_times,
                         disp_width(total_chunks), i_chunk + 1, total_chunks,
-                        disp_width(num_channels), i_channel + 1, num_channels,
-                        device_id, oskar_sky_num_sources(sky));
+                        disp_width(num_channels), i_channel + n_batch,
+                        num_channels, device_id, oskar_sky_num_sources(sky));
                 oskar_mutex_unlock(h->mutex);
             }
-            sim_baselines(h, d, sky, i_channel, i_time, sim_time_idx, status);
+            sim_baselines(h, d, sky, i_channel, n_batch, i_time,
+                    sim_time_idx, gast, status);
         }
         d->previous_chunk_index = i_chunk;
     }
@@ -478,18 +560,27 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
 struct ThreadArgs
 {
     oskar_Interferometer* h;
-    int num_threads, thread_id;
+    int thread_id, sink;
 };
 typedef struct ThreadArgs ThreadArgs;
 
+/* Must be called with h->block_cond locked. */
+static int num_blocks_released(const oskar_Interferometer* h)
+{
+    int i, num = h->num_blocks_combined;
+    for (i = 0; i < h->num_sinks; ++i)
+        if (h->num_blocks_written[h->sinks[i]] < num)
+            num = h->num_blocks_written[h->sinks[i]];
+    return num;
+}
+
 static void* run_blocks(void* arg)
 {
     oskar_Interferometer* h;
-    int b, thread_id, device_id, num_blocks, num_threads, *status;
+    int b, thread_id, device_id, num_blocks, *status;
 
     /* Get thread function arguments. */
     h = ((ThreadArgs*)arg)->h;
-    num_threads = ((ThreadArgs*)arg)->num_threads;
     thread_id = ((ThreadArgs*)arg)->thread_id;
     device_id = thread_id - 1;
     status = &(h->status);
@@ -502,57 +593,125 @@ static void* run_blocks(void* arg)
 
     /* Loop over blocks of observation time, running simulation and file
      * writing one block at a time. Simulation and file output are overlapped
-     * by using double buffering, and a dedicated thread is used for file
-     * output.
+     * by using double buffering for each device, and a ring of output
+     * buffers that are written by a separate thread for each output sink.
      *
-     * Thread 0 is used for file writes.
+     * Thread 0 is used to combine blocks into the output buffers.
      * Threads 1 to n (mapped to compute devices) do the simulation.
+     * The remaining threads (see write_blocks()) each write to one sink.
      *
-     * Note that no write is launched on the first loop counter (as no
-     * data are ready yet) and no simulation is performed for the last loop
-     * counter (which corresponds to the last block + 1) as this iteration
-     * simply writes the last block.
+     * There are no barriers between blocks: a device that runs out of work
+     * units to take or steal in one block moves straight on to the next,
+     * while other devices are still finishing their last work units.
+     * A device only waits if the host buffer it needs has not yet been
+     * combined, and thread 0 only waits if every output buffer is still
+     * waiting to be written by at least one sink, so slow writes stall the
+     * devices only when the whole ring is full.
      */
     num_blocks = oskar_interferometer_num_vis_blocks(h);
-    for (b = 0; b < num_blocks + 1; ++b)
+    for (b = 0; b < num_blocks; ++b)
     {
-        if ((thread_id > 0 || num_threads == 1) && b < num_blocks)
-            oskar_interferometer_run_block(h, b, device_id, status);
-        if (thread_id == 0 && b > 0)
+        if (thread_id == 0)
         {
             oskar_VisBlock* block;
-            block = oskar_interferometer_finalise_block(h, b - 1, status);
-            oskar_interferometer_write_block(h, block, b - 1, status);
-        }
 
-        /* Barrier 1: Reset work unit index and print status. */
-        oskar_barrier_wait(h->barrier);
-        if (thread_id == 0)
-        {
-            oskar_interferometer_reset_work_unit_index(h);
-            if (b < num_blocks && h->log && !*status)
+            /* Wait until all devices have finished this block,
+             * and until its output buffer has been written by all sinks. */
+            oskar_condition_lock(h->block_cond);
+            while (h->queue_block_index[b % 2] != b ||
+                    h->num_devices_done[b % 2] < h->num_devices ||
+                    num_blocks_released(h) <= b - h->num_output_buffers)
+                oskar_condition_wait(h->block_cond);
+            oskar_condition_unlock(h->block_cond);
+            if (h->log && !*status)
+            {
+                oskar_mutex_lock(h->mutex);
                 oskar_log_message(h->log, 'S', 0, "Block %*i/%i (%3.0f%%) "
                         "complete. Simulation time elapsed: %.3f s",
                         disp_width(num_blocks), b+1, num_blocks,
                         100.0 * (b+1) / (double)num_blocks,
                         oskar_timer_elapsed(h->tmr_sim));
+                oskar_mutex_unlock(h->mutex);
+            }
+
+            /* Combine the block into the next output buffer, releasing the
+             * device host buffers, then tell the write threads about it.
+             * This must be done even on error, to avoid deadlock. */
+            block = oskar_interferometer_finalise_block(h, b, status);
+            if (block)
+                oskar_vis_block_copy(
+                        h->output_blocks[b % h->num_output_buffers],
+                        block, status);
+            oskar_condition_lock(h->block_cond);
+            h->num_blocks_combined = b + 1;
+            oskar_condition_notify_all(h->block_cond);
+            oskar_condition_unlock(h->block_cond);
         }
+        else
+        {
+            /* Wait until the host buffer used two blocks ago is combined. */
+            oskar_condition_lock(h->block_cond);
+            while (h->num_blocks_combined < b - 1)
+                oskar_condition_wait(h->block_cond);
+            oskar_condition_unlock(h->block_cond);
+
+            /* Run the block, and then tell the combining thread about it.
+             * This must be done even on error, to avoid deadlock. */
+            oskar_interferometer_run_block(h, b, device_id, status);
+            oskar_condition_lock(h->block_cond);
+            fill_work_queues(h, b);
+            h->num_devices_done[b % 2]++;
+            oskar_condition_notify_all(h->block_cond);
+            oskar_condition_unlock(h->block_cond);
+        }
+    }
+    return 0;
+}
+
+static void* write_blocks(void* arg)
+{
+    oskar_Interferometer* h;
+    int b, sink, num_blocks, *status;
+
+    /* Get thread function arguments. */
+    h = ((ThreadArgs*)arg)->h;
+    sink = ((ThreadArgs*)arg)->sink;
+    status = &(h->status);
+
+#ifdef _OPENMP
+    /* Disable any nested parallelism. */
+    omp_set_nested(0);
+    omp_set_num_threads(1);
+#endif
 
-        /* Barrier 2: Synchronise before moving to the next block. */
-        oskar_barrier_wait(h->barrier);
+    /* Write each output buffer to this sink as soon as it is ready.
+     * The counter must be updated even on error, to avoid deadlock. */
+    num_blocks = oskar_interferometer_num_vis_blocks(h);
+    for (b = 0; b < num_blocks; ++b)
+    {
+        oskar_condition_lock(h->block_cond);
+        while (h->num_blocks_combined <= b)
+            oskar_condition_wait(h->block_cond);
+        oskar_condition_unlock(h->block_cond);
+        write_sink(h, sink, h->output_blocks[b % h->num_output_buffers],
+                b, status);
+        oskar_condition_lock(h->block_cond);
+        h->num_blocks_written[sink] = b + 1;
+        oskar_condition_notify_all(h->block_cond);
+        oskar_condition_unlock(h->block_cond);
     }
     return 0;
 }
 
 void oskar_interferometer_run(oskar_Interferometer* h, int* status)
 {
-    int i, num_threads;
+    int i, num_devices, num_threads;
     oskar_Thread** threads = 0;
     ThreadArgs* args = 0;
     if (*status || !h) return;
 
     /* Check the visibilities are going somewhere. */
-    if (!h->vis_name
+    if (!h->vis_name && !h->block_callback
 #ifndef OSKAR_NO_MS
             && !h->ms_name
 #endif
@@ -570,17 +729,31 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
 
     /* Initialise if required. */
     oskar_interferometer_check_init(h, status);
+    set_up_output_buffers(h, status);
+    if (*status) return;
+
+    /* Get the list of output sinks. */
+    h->num_sinks = 0;
+    if (h->vis_name)
+        h->sinks[h->num_sinks++] = SINK_VIS;
+#ifndef OSKAR_NO_MS
+    if (h->ms_name)
+        h->sinks[h->num_sinks++] = SINK_MS;
+#endif
+    if (h->block_callback)
+        h->sinks[h->num_sinks++] = SINK_CALLBACK;
 
-    /* Set up worker threads. */
-    num_threads = h->num_devices + 1;
-    oskar_barrier_set_num_threads(h->barrier, num_threads);
+    /* Set up worker threads: one to combine blocks, one per device,
+     * and one per output sink. */
+    num_devices = h->num_devices;
+    num_threads = num_devices + 1 + h->num_sinks;
     threads = (oskar_Thread**) calloc(num_threads, sizeof(oskar_Thread*));
     args = (ThreadArgs*) calloc(num_threads, sizeof(ThreadArgs));
     for (i = 0; i < num_threads; ++i)
     {
         args[i].h = h;
-        args[i].num_threads = num_threads;
         args[i].thread_id = i;
+        args[i].sink = (i > num_devices) ? h->sinks[i - num_devices - 1] : -1;
     }
 
     /* Record memory usage. */
@@ -588,7 +761,7 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     {
         oskar_log_section(h->log, 'M', "Initial memory usage");
 #ifdef OSKAR_HAVE_CUDA
-        for (i = 0; i < h->num_gpus; ++i)
+        for (i = 0; i < h->num_gpus && h->dev_loc == OSKAR_GPU; ++i)
             oskar_cuda_mem_log(h->log, 0, h->gpu_ids[i]);
 #endif
         system_mem_log(h->log);
@@ -604,7 +777,8 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     /* Start the worker threads. */
     oskar_interferometer_reset_work_unit_index(h);
     for (i = 0; i < num_threads; ++i)
-        threads[i] = oskar_thread_create(run_blocks, (void*)&args[i], 0);
+        threads[i] = oskar_thread_create(args[i].sink < 0 ?
+                run_blocks : write_blocks, (void*)&args[i], 0);
 
     /* Wait for worker threads to finish. */
     for (i = 0; i < num_threads; ++i)
@@ -623,7 +797,7 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     {
         oskar_log_section(h->log, 'M', "Final memory usage");
 #ifdef OSKAR_HAVE_CUDA
-        for (i = 0; i < h->num_gpus; ++i)
+        for (i = 0; i < h->num_gpus && h->dev_loc == OSKAR_GPU; ++i)
             oskar_cuda_mem_log(h->log, 0, h->gpu_ids[i]);
 #endif
         system_mem_log(h->log);
@@ -670,6 +844,9 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
         if (h->ms_name)
             oskar_log_value(h->log, 'M', 1,
                     "Measurement Set", "%s", h->ms_name);
+        if (h->bda)
+            oskar_log_value(h->log, 'M', 2, "Averaged rows", "%d",
+                    oskar_bda_num_rows_total(h->bda));
 
         /* Write simulation log to the output files. */
         log_data = oskar_log_file_data(h->log, &log_size);
@@ -688,6 +865,23 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
 }
 
 
+void oskar_interferometer_set_bda(oskar_Interferometer* h, int enable,
+        double max_duration_sec, double max_uvw_distance_wavelengths)
+{
+    h->bda_enabled = enable;
+    h->bda_max_duration_sec = max_duration_sec;
+    h->bda_max_uvw_wavelengths = max_uvw_distance_wavelengths;
+}
+
+
+void oskar_interferometer_set_block_callback(oskar_Interferometer* h,
+        void (*callback)(const oskar_VisBlock*, int, void*), void* user_data)
+{
+    h->block_callback = callback;
+    h->block_callback_data = user_data;
+}
+
+
 void oskar_interferometer_set_coords_only(oskar_Interferometer* h, int value,
         int* status)
 {
@@ -723,7 +917,8 @@ void oskar_interferometer_set_gpus(oskar_Interferometer* h, int num,
     int i, num_gpus_avail;
     if (*status || !h) return;
     free_device_data(h, status);
-    num_gpus_avail = oskar_device_count(status);
+    num_gpus_avail = (h->dev_loc == OSKAR_CL) ?
+            (int) oskar_cl_num_devices() : oskar_device_count(status);
     if (*status) return;
     if (num < 0)
     {
@@ -753,7 +948,7 @@ void oskar_interferometer_set_gpus(oskar_Interferometer* h, int num,
     }
     for (i = 0; i < h->num_gpus; ++i)
     {
-        oskar_device_set(h->gpu_ids[i], status);
+        set_device(h, h->gpu_ids[i], status);
         if (*status) return;
     }
 }
@@ -798,6 +993,15 @@ void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value)
 }
 
 
+void oskar_interferometer_set_num_output_buffers(oskar_Interferometer* h,
+        int value)
+{
+    int status = 0;
+    free_output_buffers(h, &status);
+    h->num_output_buffers = (value < 1) ? 1 : value;
+}
+
+
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels)
 {
@@ -880,7 +1084,14 @@ void oskar_interferometer_set_telescope_model(oskar_Interferometer* h,
     /* Analyse the telescope model. */
     oskar_telescope_analyse(h->tel, status);
     if (h->log)
+    {
         oskar_telescope_log_summary(h->tel, h->log, status);
+        if (h->apply_horizon_clip)
+            oskar_log_value(h->log, 'M', 0, "Horizon clip station groups",
+                    "%d (of %d stations)",
+                    oskar_telescope_num_horizon_groups(h->tel),
+                    oskar_telescope_num_stations(h->tel));
+    }
 }
 
 
@@ -923,6 +1134,20 @@ void oskar_interferometer_set_source_flux_range(oskar_Interferometer* h,
 }
 
 
+void oskar_interferometer_set_use_opencl(oskar_Interferometer* h, int value,
+        int* status)
+{
+    if (*status || !h) return;
+    if ((h->dev_loc == OSKAR_CL) == (value != 0)) return;
+
+    /* Free device memory before changing the type of device,
+     * then select all devices of the new type. */
+    oskar_interferometer_set_gpus(h, 0, 0, status);
+    h->dev_loc = value ? OSKAR_CL : OSKAR_GPU;
+    oskar_interferometer_set_gpus(h, -1, 0, status);
+}
+
+
 void oskar_interferometer_set_zero_failed_gaussians(oskar_Interferometer* h,
         int value)
 {
@@ -939,33 +1164,55 @@ const oskar_VisHeader* oskar_interferometer_vis_header(oskar_Interferometer* h)
 void oskar_interferometer_write_block(oskar_Interferometer* h,
         const oskar_VisBlock* block, int block_index, int* status)
 {
-    if (*status) return;
-
-    /* Open files only if required, and write the block into them. */
-    oskar_timer_resume(h->tmr_write);
+    /* Write the block into any files that have been specified. */
 #ifndef OSKAR_NO_MS
-    if (h->ms_name && !h->ms)
-        h->ms = oskar_vis_header_write_ms(h->header, h->ms_name, OSKAR_TRUE,
-                h->force_polarised_ms, status);
-    if (h->ms) oskar_vis_block_write_ms(block, h->header, h->ms, status);
+    write_sink(h, SINK_MS, block, block_index, status);
 #endif
-    if (h->vis_name && !h->vis)
-        h->vis = oskar_vis_header_write(h->header, h->vis_name, status);
-    if (h->vis) oskar_vis_block_write(block, h->vis, block_index, status);
-    oskar_timer_pause(h->tmr_write);
+    write_sink(h, SINK_VIS, block, block_index, status);
 }
 
 
 /* Private methods. */
 
-static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
-        oskar_Sky* sky, int channel_index_block, int time_index_block,
-        int time_index_simulation, int* status)
+static void sim_time(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, double gast, int* status)
 {
-    int num_baselines, num_stations, num_src, num_times_block, num_channels;
-    double dt_dump_days, t_start, t_dump, gast, frequency, ra0, dec0;
+    int num_stations, num_src;
     const oskar_Mem *x, *y, *z;
-    oskar_Mem* alias = 0;
+    num_stations = oskar_telescope_num_stations(d->tel);
+    num_src      = oskar_sky_num_sources(sky);
+    if (num_src == 0 || h->coords_only) return;
+
+    /* Evaluate station u,v,w coordinates. */
+    x = oskar_telescope_station_true_x_offset_ecef_metres_const(d->tel);
+    y = oskar_telescope_station_true_y_offset_ecef_metres_const(d->tel);
+    z = oskar_telescope_station_true_z_offset_ecef_metres_const(d->tel);
+    oskar_convert_ecef_to_station_uvw(num_stations, x, y, z,
+            oskar_telescope_phase_centre_ra_rad(d->tel),
+            oskar_telescope_phase_centre_dec_rad(d->tel), gast,
+            d->u, d->v, d->w, status);
+
+    /* Evaluate parallactic angle (Jones R: matrix).
+     * TODO Move this into station beam evaluation instead. */
+    if (d->R)
+    {
+        oskar_jones_set_size(d->R, num_stations, num_src, status);
+        oskar_timer_resume(d->tmr_E);
+        oskar_evaluate_jones_R(d->R, num_src, oskar_sky_ra_rad_const(sky),
+                oskar_sky_dec_rad_const(sky), d->tel, gast, status);
+        oskar_timer_pause(d->tmr_E);
+    }
+}
+
+
+static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
+        oskar_Sky* sky, int channel_index_block, int num_channels_batch,
+        int time_index_block, int time_index_simulation, double gast,
+        int* status)
+{
+    int c, num_baselines, num_stations, num_src, num_times_block;
+    int num_channels;
+    double frequency[MAX_CHANNEL_BATCH];
 
     /* Get dimensions. */
     num_baselines   = oskar_telescope_num_baselines(d->tel);
@@ -978,114 +1225,227 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
      * or if block time index requested is outside the valid range. */
     if (num_src == 0 || time_index_block >= num_times_block) return;
 
-    /* Get the time and frequency of the visibility slice being simulated. */
-    dt_dump_days = h->time_inc_sec / 86400.0;
-    t_start = h->time_start_mjd_utc;
-    t_dump = t_start + dt_dump_days * (time_index_simulation + 0.5);
-    gast = oskar_convert_mjd_to_gast_fast(t_dump);
-    frequency = h->freq_start_hz + channel_index_block * h->freq_inc_hz;
-
-    /* Scale source fluxes with spectral index and rotation measure. */
-    oskar_sky_scale_flux_with_frequency(sky, frequency, status);
+    /* Evaluate the source fluxes and Jones matrices for each channel.
+     * Station u,v,w coordinates and Jones R for this time are
+     * frequency-independent, and have already been evaluated. */
+    d->sky_batch[0] = sky;
+    for (c = 0; c < num_channels_batch; ++c)
+    {
+        oskar_Sky* sky_c = d->sky_batch[c];
+        oskar_Jones* E_c = d->E_batch[c];
 
-    /* Evaluate station u,v,w coordinates. */
-    ra0 = oskar_telescope_phase_centre_ra_rad(d->tel);
-    dec0 = oskar_telescope_phase_centre_dec_rad(d->tel);
-    x = oskar_telescope_station_true_x_offset_ecef_metres_const(d->tel);
-    y = oskar_telescope_station_true_y_offset_ecef_metres_const(d->tel);
-    z = oskar_telescope_station_true_z_offset_ecef_metres_const(d->tel);
-    oskar_convert_ecef_to_station_uvw(num_stations, x, y, z, ra0, dec0, gast,
-            d->u, d->v, d->w, status);
+        /* Get the frequency of the visibility slice being simulated. */
+        frequency[c] = h->freq_start_hz +
+                (channel_index_block + c) * h->freq_inc_hz;
 
-    /* Set dimensions of Jones matrices. */
-    if (d->R)
-        oskar_jones_set_size(d->R, num_stations, num_src, status);
-    if (d->Z)
-        oskar_jones_set_size(d->Z, num_stations, num_src, status);
-    oskar_jones_set_size(d->J, num_stations, num_src, status);
-    oskar_jones_set_size(d->E, num_stations, num_src, status);
-    oskar_jones_set_size(d->K, num_stations, num_src, status);
-
-    /* Evaluate station beam (Jones E: may be matrix). */
-    oskar_timer_resume(d->tmr_E);
-    oskar_evaluate_jones_E(d->E, num_src, OSKAR_RELATIVE_DIRECTIONS,
-            oskar_sky_l(sky), oskar_sky_m(sky), oskar_sky_n(sky), d->tel,
-            gast, frequency, d->station_work, time_index_simulation, status);
-    oskar_timer_pause(d->tmr_E);
+        /* Scale source fluxes with spectral index and rotation measure,
+         * starting from those of the previous channel. */
+        if (c > 0)
+        {
+            oskar_timer_resume(d->tmr_copy);
+            oskar_sky_copy(sky_c, d->sky_batch[c - 1], status);
+            oskar_timer_pause(d->tmr_copy);
+        }
+        oskar_sky_scale_flux_with_frequency(sky_c, frequency[c], status);
 
-#if 0
-    /* Evaluate ionospheric phase (Jones Z: scalar) and join with Jones E.
-     * NOTE this is currently only a CPU implementation. */
-    if (d->Z)
-    {
-        oskar_evaluate_jones_Z(d->Z, num_src, sky, d->tel,
-                &settings->ionosphere, gast, frequency, &(d->workJonesZ),
-                status);
-        oskar_timer_resume(d->tmr_join);
-        oskar_jones_join(d->E, d->Z, d->E, status);
-        oskar_timer_pause(d->tmr_join);
-    }
-#endif
+        /* Set dimensions of Jones matrices. */
+        if (d->Z)
+            oskar_jones_set_size(d->Z, num_stations, num_src, status);
+        if (d->apply_K)
+        {
+            oskar_jones_set_size(d->J, num_stations, num_src, status);
+            oskar_jones_set_size(d->K, num_stations, num_src, status);
+        }
 
-    /* Evaluate parallactic angle (Jones R: matrix), and join with Jones Z*E.
-     * TODO Move this into station beam evaluation instead. */
-    if (d->R)
-    {
+        /* Evaluate station beam (Jones E: may be matrix).
+         * This also sets the dimensions of Jones E, which holds only
+         * one row for each group of identical stations. */
         oskar_timer_resume(d->tmr_E);
-        oskar_evaluate_jones_R(d->R, num_src, oskar_sky_ra_rad_const(sky),
-                oskar_sky_dec_rad_const(sky), d->tel, gast, status);
+        oskar_evaluate_jones_E(E_c, num_src, OSKAR_RELATIVE_DIRECTIONS,
+                oskar_sky_l(sky), oskar_sky_m(sky), oskar_sky_n(sky), d->tel,
+                gast, frequency[c], d->station_work, time_index_simulation,
+                status);
         oskar_timer_pause(d->tmr_E);
-        oskar_timer_resume(d->tmr_join);
-        oskar_jones_join(d->R, d->E, d->R, status);
-        oskar_timer_pause(d->tmr_join);
-    }
 
-    /* Evaluate interferometer phase (Jones K: scalar). */
-    oskar_timer_resume(d->tmr_K);
-    oskar_evaluate_jones_K(d->K, num_src, oskar_sky_l_const(sky),
-            oskar_sky_m_const(sky), oskar_sky_n_const(sky), d->u, d->v, d->w,
-            frequency, oskar_sky_I_const(sky),
-            h->source_min_jy, h->source_max_jy, status);
-    oskar_timer_pause(d->tmr_K);
+#if 0
+        /* Evaluate ionospheric phase (Jones Z: scalar) and join with Jones E.
+         * NOTE this is currently only a CPU implementation. */
+        if (d->Z)
+        {
+            oskar_evaluate_jones_Z(d->Z, num_src, sky, d->tel,
+                    &settings->ionosphere, gast, frequency[c],
+                    &(d->workJonesZ), status);
+            oskar_timer_resume(d->tmr_join);
+            oskar_jones_join(E_c, d->Z, E_c, status);
+            oskar_timer_pause(d->tmr_join);
+        }
+#endif
 
-    /* Join Jones K with Jones Z*E. */
-    oskar_timer_resume(d->tmr_join);
-    oskar_jones_join(d->J, d->K, d->R ? d->R : d->E, status);
-    oskar_timer_pause(d->tmr_join);
+        /* Join Jones Z*E with parallactic angle (Jones R), keeping Jones R
+         * unmodified so it can be used for the other channels. */
+        if (d->R)
+        {
+            oskar_timer_resume(d->tmr_join);
+            oskar_jones_join(0, E_c, d->R, status);
+            oskar_timer_pause(d->tmr_join);
+        }
 
-    /* Create alias for auto/cross-correlations. */
-    oskar_timer_resume(d->tmr_correlate);
-    alias = oskar_mem_create_alias(0, 0, 0, status);
+        /* Evaluate interferometer phase (Jones K: scalar),
+         * and join Jones K with Jones Z*E, if required. */
+        if (d->apply_K)
+        {
+            oskar_timer_resume(d->tmr_K);
+            oskar_evaluate_jones_K(d->K, num_src, oskar_sky_l_const(sky),
+                    oskar_sky_m_const(sky), oskar_sky_n_const(sky),
+                    d->u, d->v, d->w, frequency[c], oskar_sky_I_const(sky_c),
+                    h->source_min_jy, h->source_max_jy, status);
+            oskar_timer_pause(d->tmr_K);
+            oskar_timer_resume(d->tmr_join);
+            oskar_jones_join(d->J, d->K, E_c, status);
+            oskar_timer_pause(d->tmr_join);
+        }
+    }
 
-    /* Auto-correlate for this time and channel. */
+    /* Auto-correlate for this time and each channel. */
+    oskar_timer_resume(d->tmr_correlate);
     if (oskar_vis_block_has_auto_correlations(d->vis_block))
     {
-        oskar_mem_set_alias(alias,
-                oskar_vis_block_auto_correlations(d->vis_block),
-                num_stations *
-                (num_channels * time_index_block + channel_index_block),
-                num_stations, status);
-        oskar_auto_correlate(alias, num_src, d->J, sky, status);
+        oskar_Mem* acorr = oskar_vis_block_auto_correlations(d->vis_block);
+        for (c = 0; c < num_channels_batch; ++c)
+        {
+            const size_t offset = num_stations * (num_channels *
+                    time_index_block + channel_index_block + c);
+            oskar_Mem* slice = oskar_mem_create_slice(acorr, offset,
+                    num_stations, status);
+            oskar_auto_correlate(slice, num_src,
+                    d->apply_K ? d->J : d->E_batch[c], d->sky_batch[c],
+                    status);
+            oskar_mem_free_slice(slice, acorr, offset, status);
+        }
     }
 
-    /* Cross-correlate for this time and channel. */
+    /* Cross-correlate for this time and all channels in the batch. */
     if (oskar_vis_block_has_cross_correlations(d->vis_block))
     {
-        oskar_mem_set_alias(alias,
-                oskar_vis_block_cross_correlations(d->vis_block),
-                num_baselines *
-                (num_channels * time_index_block + channel_index_block),
-                num_baselines, status);
-        oskar_cross_correlate(alias, num_src, d->J, sky, d->tel,
-                d->u, d->v, d->w, gast, frequency, status);
+        oskar_Mem* xcorr = oskar_vis_block_cross_correlations(d->vis_block);
+        const size_t offset = num_baselines *
+                (num_channels * time_index_block + channel_index_block);
+        oskar_Mem* slice = oskar_mem_create_slice(xcorr, offset,
+                num_baselines * num_channels_batch, status);
+        if (d->apply_K)
+            oskar_cross_correlate(slice, num_src, d->J, sky, d->tel,
+                    d->u, d->v, d->w, gast, frequency[0], status);
+        else
+            oskar_cross_correlate_channels(slice, num_channels_batch,
+                    num_src, d->E_batch, d->sky_batch, d->tel,
+                    d->u, d->v, d->w, gast, frequency, 1,
+                    h->source_min_jy, h->source_max_jy, status);
+        oskar_mem_free_slice(slice, xcorr, offset, status);
     }
-
-    /* Free alias for auto/cross-correlations. */
-    oskar_mem_free(alias, status);
     oskar_timer_pause(d->tmr_correlate);
 }
 
 
+/* Must be called with h->block_cond locked. */
+static void fill_work_queues(oskar_Interferometer* h, int block_index)
+{
+    int i, i_buffer, num_units, num_times_block;
+    i_buffer = block_index % 2;
+    if (h->queue_block_index[i_buffer] == block_index) return;
+
+    /* Work units are ordered by sky chunk, then by time.
+     * Give each device a contiguous range of them, so that each device
+     * starts on the same sky chunks in every block. */
+    num_times_block = h->num_time_steps - block_index * h->max_times_per_block;
+    if (num_times_block > h->max_times_per_block)
+        num_times_block = h->max_times_per_block;
+    num_units = h->coords_only ? 0 : num_times_block * h->num_sky_chunks;
+    for (i = 0; i < h->num_devices; ++i)
+    {
+        DeviceData* d = &h->d[i];
+        oskar_mutex_lock(d->queue_lock);
+        d->queue_begin[i_buffer] = (int)(((size_t) num_units * i) /
+                h->num_devices);
+        d->queue_end[i_buffer] = (int)(((size_t) num_units * (i + 1)) /
+                h->num_devices);
+        oskar_mutex_unlock(d->queue_lock);
+    }
+    h->queue_block_index[i_buffer] = block_index;
+    h->num_devices_done[i_buffer] = 0;
+}
+
+
+/* Returns the next work unit index for the device, or -1 if none are left. */
+static int next_work_unit(oskar_Interferometer* h, int device_id,
+        int block_index, int num_times_block)
+{
+    int i, i_buffer, i_work_unit = -1;
+    DeviceData* d = &h->d[device_id];
+    i_buffer = block_index % 2;
+
+    /* Take from the front of this device's own queue. */
+    oskar_mutex_lock(d->queue_lock);
+    if (d->queue_begin[i_buffer] < d->queue_end[i_buffer])
+        i_work_unit = (d->queue_begin[i_buffer])++;
+    oskar_mutex_unlock(d->queue_lock);
+    if (i_work_unit >= 0) return i_work_unit;
+
+    /* Otherwise, steal from the back of another device's queue.
+     * Prefer a victim whose last work units use the sky chunk already held
+     * by this device, then the victim with the most work units left. */
+    for (;;)
+    {
+        int victim = -1, victim_affine = 0, victim_units = 0;
+        int begin, end, steal_begin, chunk_begin;
+        DeviceData* v;
+        for (i = 0; i < h->num_devices; ++i)
+        {
+            int affine, num_units;
+            if (i == device_id) continue;
+            v = &h->d[i];
+            oskar_mutex_lock(v->queue_lock);
+            begin = v->queue_begin[i_buffer];
+            end = v->queue_end[i_buffer];
+            oskar_mutex_unlock(v->queue_lock);
+            num_units = end - begin;
+            if (num_units <= 0) continue;
+            affine = ((end - 1) / num_times_block == d->previous_chunk_index);
+            if (affine > victim_affine || (affine == victim_affine &&
+                    num_units > victim_units))
+            {
+                victim = i;
+                victim_affine = affine;
+                victim_units = num_units;
+            }
+        }
+        if (victim < 0) return -1;
+
+        /* Steal the back half of the victim's queue, but only up to the
+         * start of its last sky chunk if that is the one held here. */
+        v = &h->d[victim];
+        oskar_mutex_lock(v->queue_lock);
+        begin = v->queue_begin[i_buffer];
+        end = v->queue_end[i_buffer];
+        steal_begin = end - (end - begin + 1) / 2;
+        chunk_begin = d->previous_chunk_index * num_times_block;
+        if ((end - 1) / num_times_block == d->previous_chunk_index &&
+                steal_begin < chunk_begin)
+            steal_begin = chunk_begin;
+        if (steal_begin < end)
+            v->queue_end[i_buffer] = steal_begin;
+        oskar_mutex_unlock(v->queue_lock);
+        if (steal_begin >= end) continue; /* Victim ran out: try again. */
+
+        /* Keep the rest of the stolen range in this device's own queue. */
+        oskar_mutex_lock(d->queue_lock);
+        d->queue_begin[i_buffer] = steal_begin + 1;
+        d->queue_end[i_buffer] = end;
+        oskar_mutex_unlock(d->queue_lock);
+        return steal_begin;
+    }
+}
+
+
 static void set_up_vis_header(oskar_Interferometer* h, int* status)
 {
     int num_stations, vis_type;
@@ -1156,7 +1516,8 @@ static void set_up_vis_header(oskar_Interferometer* h, int* status)
 
 static void set_up_device_data(oskar_Interferometer* h, int* status)
 {
-    int i, dev_loc, complx, vistype, num_stations, num_src;
+    int i, j, dev_loc, complx, vistype, num_stations, num_src, num_beams;
+    const oskar_Mem* type_map;
     if (*status) return;
 
     /* Get local variables. */
@@ -1167,6 +1528,18 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
     if (oskar_telescope_pol_mode(h->tel) == OSKAR_POL_MODE_FULL)
         vistype |= OSKAR_MATRIX;
 
+    /* Jones E holds one row for each group of identical stations,
+     * if station beam duplication is allowed. */
+    num_beams = num_stations;
+    type_map = oskar_telescope_station_type_map_const(h->tel);
+    if (oskar_telescope_allow_station_beam_duplication(h->tel) &&
+            (int)oskar_mem_length(type_map) == num_stations)
+    {
+        const int* type_ = oskar_mem_int_const(type_map, status);
+        for (i = 0, num_beams = 0; i < num_stations; ++i)
+            if (type_[i] == i) num_beams++;
+    }
+
     /* Expand the number of devices to the number of selected GPUs,
      * if required. */
     if (h->num_devices < h->num_gpus)
@@ -1180,14 +1553,18 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
         /* Select the device. */
         if (i < h->num_gpus)
         {
-            oskar_device_set(h->gpu_ids[i], status);
-            dev_loc = OSKAR_GPU;
+            set_device(h, h->gpu_ids[i], status);
+            dev_loc = h->dev_loc;
         }
         else
         {
             dev_loc = OSKAR_CPU;
         }
 
+        /* Work queue lock. */
+        if (!d->queue_lock)
+            d->queue_lock = oskar_mutex_create();
+
         /* Timers. */
         if (!d->tmr_compute)
         {
@@ -1223,32 +1600,74 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
             d->chunk = oskar_sky_create(h->prec, dev_loc, num_src, status);
             d->chunk_clip = oskar_sky_create(h->prec, dev_loc, num_src, status);
             d->tel = oskar_telescope_create_copy(h->tel, dev_loc, status);
-            d->J = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
-                    status);
             d->R = oskar_type_is_matrix(vistype) ? oskar_jones_create(vistype,
                     dev_loc, num_stations, num_src, status) : 0;
-            d->E = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
-                    status);
-            d->K = oskar_jones_create(complx, dev_loc, num_stations, num_src,
+            d->E = oskar_jones_create(vistype, dev_loc, num_beams, num_src,
                     status);
             d->Z = 0;
             d->station_work = oskar_station_work_create(h->prec, dev_loc,
                     status);
         }
+
+        /* Polarised data on the CPU can be correlated with the
+         * interferometer phase evaluated for each baseline as it is needed,
+         * so then Jones K and J are not needed. Auto-correlations use
+         * Jones J to exclude sources outside the flux range, so need it
+         * if the range is limited. */
+        d->apply_K = !(dev_loc == OSKAR_CPU && oskar_type_is_matrix(vistype) &&
+                (!oskar_vis_header_write_auto_correlations(h->header) ||
+                        (h->source_min_jy <= -DBL_MAX &&
+                                h->source_max_jy >= DBL_MAX)));
+        if (d->apply_K && !d->K)
+        {
+            d->J = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
+                    status);
+            d->K = oskar_jones_create(complx, dev_loc, num_stations, num_src,
+                    status);
+        }
+
+        /* Without Jones K, several channels can be correlated together,
+         * sharing the terms that do not depend on frequency. Each extra
+         * channel needs its own copy of Jones E and the sky chunk, so the
+         * memory for these is divided between all devices. */
+        d->num_channel_batch = 1;
+        if (!d->apply_K)
+        {
+            size_t jones_bytes = oskar_mem_element_size(vistype) *
+                    (size_t) num_beams * (size_t) num_src;
+            size_t num_extra = jones_bytes > 0 ?
+                    MAX_CHANNEL_BATCH_BYTES / ((size_t) h->num_devices *
+                            jones_bytes) : 0;
+            if (num_extra > MAX_CHANNEL_BATCH - 1)
+                num_extra = MAX_CHANNEL_BATCH - 1;
+            d->num_channel_batch += (int) num_extra;
+            if (d->num_channel_batch > h->num_channels)
+                d->num_channel_batch = h->num_channels;
+        }
+        d->E_batch[0] = d->E;
+        for (j = 1; j < d->num_channel_batch; ++j)
+        {
+            if (d->E_batch[j]) continue;
+            d->E_batch[j] = oskar_jones_create(vistype, dev_loc,
+                    num_beams, num_src, status);
+            d->sky_batch[j] = oskar_sky_create(h->prec, dev_loc, num_src,
+                    status);
+        }
     }
 }
 
 
 static void free_device_data(oskar_Interferometer* h, int* status)
 {
-    int i;
+    int i, j;
     if (!h->d) return;
     for (i = 0; i < h->num_devices; ++i)
     {
         DeviceData* d = &(h->d[i]);
         if (!d) continue;
         if (i < h->num_gpus)
-            oskar_device_set(h->gpu_ids[i], status);
+            set_device(h, h->gpu_ids[i], status);
+        oskar_mutex_free(d->queue_lock);
         oskar_timer_free(d->tmr_compute);
         oskar_timer_free(d->tmr_copy);
         oskar_timer_free(d->tmr_clip);
@@ -1270,11 +1689,96 @@ static void free_device_data(oskar_Interferometer* h, int* status)
         oskar_jones_free(d->E, status);
         oskar_jones_free(d->K, status);
         oskar_jones_free(d->R, status);
+        for (j = 1; j < MAX_CHANNEL_BATCH; ++j)
+        {
+            oskar_jones_free(d->E_batch[j], status);
+            oskar_sky_free(d->sky_batch[j], status);
+        }
         memset(d, 0, sizeof(DeviceData));
     }
 }
 
 
+static void set_device(const oskar_Interferometer* h, int id, int* status)
+{
+    if (h->dev_loc == OSKAR_CL)
+        oskar_cl_set_device((unsigned int) id, status);
+    else
+        oskar_device_set(id, status);
+}
+
+
+static void free_output_buffers(oskar_Interferometer* h, int* status)
+{
+    int i;
+    if (!h->output_blocks) return;
+    for (i = 0; i < h->num_output_buffers; ++i)
+        oskar_vis_block_free(h->output_blocks[i], status);
+    free(h->output_blocks);
+    h->output_blocks = 0;
+}
+
+
+static void set_up_output_buffers(oskar_Interferometer* h, int* status)
+{
+    int i;
+    if (*status) return;
+    if (!h->output_blocks)
+    {
+        h->output_blocks = (oskar_VisBlock**) calloc(h->num_output_buffers,
+                sizeof(oskar_VisBlock*));
+        for (i = 0; i < h->num_output_buffers; ++i)
+            h->output_blocks[i] = oskar_vis_block_create_from_header(
+                    OSKAR_CPU, h->header, status);
+    }
+}
+
+
+static void write_sink(oskar_Interferometer* h, int sink,
+        const oskar_VisBlock* block, int block_index, int* status)
+{
+    if (*status) return;
+
+    /* Open files only if required, and write the block into them. */
+    oskar_timer_resume(h->tmr_write[sink]);
+    switch (sink)
+    {
+#ifndef OSKAR_NO_MS
+    case SINK_MS:
+        if (h->ms_name && !h->ms)
+            h->ms = oskar_vis_header_write_ms(h->header, h->ms_name,
+                    OSKAR_TRUE, h->force_polarised_ms, status);
+        if (h->ms && h->bda_enabled)
+        {
+            /* Average the block, and write any averages it completes. */
+            if (!h->bda)
+                h->bda = oskar_bda_create(h->header,
+                        (int) oskar_ms_num_pols(h->ms),
+                        h->bda_max_duration_sec, h->bda_max_uvw_wavelengths,
+                        status);
+            oskar_bda_add_block(h->bda, block, status);
+            oskar_bda_write_ms(h->bda, h->ms, status);
+        }
+        else if (h->ms)
+            oskar_vis_block_write_ms(block, h->header, h->ms, status);
+        break;
+#endif
+    case SINK_VIS:
+        if (h->vis_name && !h->vis)
+            h->vis = oskar_vis_header_write(h->header, h->vis_name, status);
+        if (h->vis) oskar_vis_block_write(block, h->vis, block_index, status);
+        break;
+    case SINK_CALLBACK:
+        if (h->block_callback)
+            h->block_callback(block, block_index, h->block_callback_data);
+        break;
+    default:
+        break;
+    }
+    oskar_timer_pause(h->tmr_write[sink]);
+}
+
+
 static void record_timing(oskar_Interferometer* h)
 {
     /* Obtain component times. */
@@ -1303,8 +1807,14 @@ static void record_timing(oskar_Interferometer* h)
     for (i = 0; i < h->num_devices; ++i)
         oskar_log_value(h->log, 'M', 0, "Compute", "%.3f s [Device %i]",
                 compute_times[i], i);
-    oskar_log_value(h->log, 'M', 0, "Write", "%.3f s",
-            oskar_timer_elapsed(h->tmr_write));
+    for (i = 0; i < h->num_sinks; ++i)
+    {
+        const int sink = h->sinks[i];
+        oskar_log_value(h->log, 'M', 0, "Write", "%.3f s [%s]",
+                oskar_timer_elapsed(h->tmr_write[sink]),
+                sink == SINK_VIS ? "OSKAR binary file" :
+                sink == SINK_MS ? "Measurement Set" : "Callback");
+    }
     oskar_log_message(h->log, 'M', 0, "Compute components:");
     oskar_log_value(h->log, 'M', 1, "Copy", "%4.1f%%",
             (t_copy / t_compute) * 100.0);
@@ -65,6 +65,22 @@ const oskar_Mem* oskar_jones_mem_const(const oskar_Jones* jones)
     return jones->data;
 }
 
+int oskar_jones_num_shared_stations(const oskar_Jones* jones)
+{
+    return jones->num_shared;
+}
+
+int oskar_jones_station_row(const oskar_Jones* jones, int station)
+{
+    if (jones->num_shared == 0) return station;
+    return ((const int*) oskar_mem_void_const(jones->station_map))[station];
+}
+
+const oskar_Mem* oskar_jones_station_map_const(const oskar_Jones* jones)
+{
+    return jones->station_map;
+}
+
 /* Single precision. */
 
 float2* oskar_jones_float2(oskar_Jones* jones, int* status)
@@ -69,6 +69,9 @@ oskar_Jones* oskar_jones_create(int type, int location, int num_stations,
     jones->cap_stations = num_stations;
     jones->cap_sources = num_sources;
     jones->data = oskar_mem_create(type, location, n_elements, status);
+    jones->num_shared = 0;
+    jones->station_map = oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
+    oskar_jones_clear_shared_stations(jones, status);
 
     /* Return pointer to the structure. */
     return jones;
@@ -52,6 +52,8 @@ oskar_Jones* oskar_jones_create_copy(const oskar_Jones* src, int location,
     jones->cap_stations = src->cap_stations;
     jones->cap_sources = src->cap_sources;
     oskar_mem_copy(jones->data, src->data, status);
+    oskar_mem_copy(jones->station_map, src->station_map, status);
+    jones->num_shared = src->num_shared;
 
     /* Return pointer to the new structure. */
     return jones;
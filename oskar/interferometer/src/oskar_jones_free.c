@@ -41,6 +41,7 @@ void oskar_jones_free(oskar_Jones* jones, int* status)
 
     /* Free the memory held by the structure. */
     oskar_mem_free(jones->data, status);
+    oskar_mem_free(jones->station_map, status);
 
     /* Free the structure itself. */
     free(jones);
@@ -29,10 +29,15 @@
 #include "interferometer/private_jones.h"
 #include "interferometer/oskar_jones.h"
 
+#include <stdlib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+static void join_shared(oskar_Jones* j3, const oskar_Jones* j1,
+        const oskar_Jones* j2, int* status);
+
 void oskar_jones_join(oskar_Jones* j3, oskar_Jones* j1, const oskar_Jones* j2,
         int* status)
 {
@@ -57,11 +62,120 @@ void oskar_jones_join(oskar_Jones* j3, oskar_Jones* j1, const oskar_Jones* j2,
     if (n_stations1 != n_stations2 || n_stations1 != n_stations3)
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
 
+    /* Only multiply distinct rows if either input has shared stations. */
+    if (j1->num_shared > 0 || j2->num_shared > 0)
+    {
+        join_shared(j3, j1, j2, status);
+        return;
+    }
+
     /* Multiply the array elements. */
     num_elements = n_sources1 * n_stations1;
+    oskar_jones_clear_shared_stations(j3, status);
     oskar_mem_multiply(j3->data, j1->data, j2->data, num_elements, status);
 }
 
+#define ROW(J, MAP, I) ((J)->num_shared > 0 ? (MAP)[I] : (I))
+
+static void join_shared(oskar_Jones* j3, const oskar_Jones* j1,
+        const oskar_Jones* j2, int* status)
+{
+    int i, k, r1, r2, num_rows = 0, num_sources, num_stations;
+    int ascending = 1, descending = 1;
+    int *out_map, *row1, *row2, *first, *next;
+    const int *map1, *map2;
+    oskar_Mem *in1 = j1->data, *in2 = j2->data, *copy = 0;
+    oskar_Mem *slice1, *slice2, *slice3;
+    size_t offset;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Allocate space for the output map, the input rows used by each
+     * output row, and lists of output rows using each row of input 1. */
+    num_sources = j1->num_sources;
+    num_stations = j1->num_stations;
+    map1 = oskar_mem_int_const(j1->station_map, status);
+    map2 = oskar_mem_int_const(j2->station_map, status);
+    out_map = (int*) malloc(5 * num_stations * sizeof(int));
+    if (!out_map)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+    row1 = out_map + num_stations;
+    row2 = row1 + num_stations;
+    first = row2 + num_stations;
+    next = first + num_stations;
+    for (i = 0; i < num_stations; ++i) first[i] = -1;
+
+    /* One output row is needed for each distinct pair of input rows,
+     * numbered in the order in which the pairs are first used. */
+    for (i = 0; i < num_stations; ++i)
+    {
+        r1 = ROW(j1, map1, i);
+        r2 = ROW(j2, map2, i);
+        for (k = first[r1]; k >= 0; k = next[k])
+            if (row2[k] == r2) break;
+        if (k < 0)
+        {
+            k = num_rows++;
+            row1[k] = r1;
+            row2[k] = r2;
+            next[k] = first[r1];
+            first[r1] = k;
+        }
+        out_map[i] = k;
+    }
+
+    /* If the output is also an input, output row k must not be written
+     * while an input row with that index is still needed. The rows can be
+     * written in place in ascending or descending order if every output
+     * row uses input rows at or after (or before) its own index.
+     * Otherwise, use a copy of the input. */
+    for (k = 0; k < num_rows; ++k)
+    {
+        if ((j3 == j1 && row1[k] < k) || (j3 == j2 && row2[k] < k))
+            ascending = 0;
+        if ((j3 == j1 && row1[k] > k) || (j3 == j2 && row2[k] > k))
+            descending = 0;
+    }
+    if (!ascending && !descending)
+    {
+        copy = oskar_mem_create_copy(j3->data,
+                oskar_mem_location(j3->data), status);
+        if (j3 == j1) in1 = copy;
+        if (j3 == j2) in2 = copy;
+        ascending = 1;
+    }
+
+    /* Set the output dimensions and map, so that it holds only the rows
+     * that are needed. This may move the data of the output block. */
+    oskar_jones_set_size_shared(j3, num_stations, num_sources, out_map,
+            status);
+    if (j3 == j1 && !copy) in1 = j3->data;
+    if (j3 == j2 && !copy) in2 = j3->data;
+
+    /* Multiply the rows. */
+    for (i = 0; i < num_rows; ++i)
+    {
+        k = ascending ? i : num_rows - 1 - i;
+        offset = (size_t)k * num_sources;
+        slice1 = oskar_mem_create_slice(in1, (size_t)row1[k] * num_sources,
+                num_sources, status);
+        slice2 = oskar_mem_create_slice(in2, (size_t)row2[k] * num_sources,
+                num_sources, status);
+        slice3 = oskar_mem_create_slice(j3->data, offset, num_sources,
+                status);
+        oskar_mem_multiply(slice3, slice1, slice2, num_sources, status);
+        oskar_mem_free_slice(slice1, 0, 0, status);
+        oskar_mem_free_slice(slice2, 0, 0, status);
+        oskar_mem_free_slice(slice3, j3->data, offset, status);
+    }
+    oskar_mem_free(copy, status);
+    free(out_map);
+}
+
 #ifdef __cplusplus
 }
 #endif
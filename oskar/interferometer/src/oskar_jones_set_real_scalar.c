@@ -29,6 +29,7 @@
 #include "interferometer/private_jones.h"
 
 #include "interferometer/oskar_jones_set_real_scalar.h"
+#include "interferometer/oskar_jones_set_station_shared.h"
 #include "mem/oskar_mem.h"
 
 #ifdef __cplusplus
@@ -37,7 +38,8 @@ extern "C" {
 
 void oskar_jones_set_real_scalar(oskar_Jones* jones, double scalar, int* status)
 {
-    /* Set the value. */
+    /* Set the value for every station. */
+    oskar_jones_clear_shared_stations(jones, status);
     oskar_mem_set_value_real(jones->data, scalar, 0, 0, status);
 }
 
@@ -29,6 +29,7 @@
 #include "interferometer/private_jones.h"
 
 #include "interferometer/oskar_jones_set_size.h"
+#include "interferometer/oskar_jones_set_station_shared.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,6 +54,9 @@ void oskar_jones_set_size(oskar_Jones* jones, int num_stations,
     /* Set the new dimension sizes, but don't actually resize the memory. */
     jones->num_stations = num_stations;
     jones->num_sources = num_sources;
+
+    /* Rows are no longer shared. */
+    oskar_jones_clear_shared_stations(jones, status);
 }
 
 #ifdef __cplusplus
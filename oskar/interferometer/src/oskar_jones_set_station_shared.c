@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "interferometer/private_jones.h"
+#include "interferometer/oskar_jones.h"
+#include "mem/oskar_mem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void reserve_rows(oskar_Jones* jones, int num_rows, int num_sources,
+        int* status);
+
+void oskar_jones_set_station_shared(oskar_Jones* jones, int station,
+        int source_station, int* status)
+{
+    int i, row, *map;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Check station indices are in range. */
+    if (station < 0 || station >= jones->num_stations ||
+            source_station < 0 || source_station >= jones->num_stations)
+    {
+        *status = OSKAR_ERR_OUT_OF_RANGE;
+        return;
+    }
+
+    /* Make sure the map covers all the stations. */
+    if ((int)oskar_mem_length(jones->station_map) < jones->num_stations)
+    {
+        oskar_jones_clear_shared_stations(jones, status);
+        if (*status) return;
+    }
+
+    /* Point the station at the row holding the data. Other stations that
+     * use the row previously used by the station keep using that row, so
+     * its contents are left alone; otherwise, one fewer row is used. */
+    map = oskar_mem_int(jones->station_map, status);
+    row = (jones->num_shared > 0) ? map[source_station] : source_station;
+    if (map[station] == row) return;
+    for (i = 0; i < jones->num_stations; ++i)
+        if (i != station && map[i] == map[station]) break;
+    if (i == jones->num_stations) jones->num_shared++;
+    map[station] = row;
+}
+
+void oskar_jones_set_size_shared(oskar_Jones* jones, int num_stations,
+        int num_sources, const int* station_rows, int* status)
+{
+    int i, num_rows = 0, *map;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Check the rows are numbered in the order they are first used. */
+    for (i = 0; i < num_stations; ++i)
+    {
+        if (station_rows[i] < 0 || station_rows[i] > num_rows)
+        {
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+            return;
+        }
+        if (station_rows[i] == num_rows) num_rows++;
+    }
+
+    /* Make sure there is space for the rows that are used. */
+    reserve_rows(jones, num_rows, num_sources, status);
+    if ((int)oskar_mem_length(jones->station_map) < num_stations)
+        oskar_mem_realloc(jones->station_map, num_stations, status);
+    if (*status) return;
+
+    /* Set the dimensions and store the map. */
+    jones->num_stations = num_stations;
+    jones->num_sources = num_sources;
+    jones->num_shared = num_stations - num_rows;
+    map = oskar_mem_int(jones->station_map, status);
+    for (i = 0; i < num_stations; ++i) map[i] = station_rows[i];
+}
+
+void oskar_jones_clear_shared_stations(oskar_Jones* jones, int* status)
+{
+    int i, num_stations, *map;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Make sure every station can have its own row. */
+    num_stations = jones->num_stations;
+    reserve_rows(jones, num_stations, jones->num_sources, status);
+
+    /* Resize the map if required, and set it to the identity. */
+    if ((int)oskar_mem_length(jones->station_map) < num_stations)
+        oskar_mem_realloc(jones->station_map, num_stations, status);
+    else if (jones->num_shared == 0)
+        return;
+    map = oskar_mem_int(jones->station_map, status);
+    if (*status) return;
+    for (i = 0; i < num_stations; ++i) map[i] = i;
+    jones->num_shared = 0;
+}
+
+void oskar_jones_expand_shared_stations(oskar_Jones* jones, int* status)
+{
+    int i, num_sources, num_stations, in_place = 1;
+    const int* map;
+    oskar_Mem* src;
+
+    /* Check if safe to proceed. */
+    if (*status || jones->num_shared == 0) return;
+
+    /* Make sure every station can have its own row. */
+    num_sources = jones->num_sources;
+    num_stations = jones->num_stations;
+    reserve_rows(jones, num_stations, num_sources, status);
+    map = oskar_mem_int_const(jones->station_map, status);
+    if (*status) return;
+
+    /* The rows can be filled in place, last station first, if no station
+     * uses a row after its own. Otherwise, copy from the original data. */
+    for (i = 0; i < num_stations; ++i)
+        if (map[i] > i) in_place = 0;
+    src = in_place ? jones->data :
+            oskar_mem_create_copy(jones->data,
+                    oskar_mem_location(jones->data), status);
+
+    /* Copy the data for each station into its own row. */
+    for (i = num_stations - 1; i >= 0; --i)
+    {
+        if (in_place && map[i] == i) continue;
+        oskar_mem_copy_contents(jones->data, src,
+                (size_t)i * num_sources, (size_t)map[i] * num_sources,
+                num_sources, status);
+    }
+    if (!in_place) oskar_mem_free(src, status);
+    oskar_jones_clear_shared_stations(jones, status);
+}
+
+static void reserve_rows(oskar_Jones* jones, int num_rows, int num_sources,
+        int* status)
+{
+    size_t num_elements;
+    if (*status) return;
+    num_elements = (size_t)num_rows * num_sources;
+    if (num_elements <= (size_t)jones->cap_stations * jones->cap_sources)
+        return;
+    oskar_mem_realloc(jones->data, num_elements, status);
+    jones->cap_stations = num_rows;
+    jones->cap_sources = num_sources;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -313,8 +313,198 @@ static void test_ones(int precision, int location)
     ASSERT_EQ(0, status);
 }
 
+static void t_join_shared(int in_place)
+{
+    int i, status = 0;
+    oskar_Jones *in1, *in2, *out, *exp1, *exp2, *out_exp;
+
+    // Create inputs, with some stations sharing the data of others.
+    in1 = oskar_jones_create(DCM, CPU, stations, sources, &status);
+    in2 = oskar_jones_create(DC, CPU, stations, sources, &status);
+    out = in_place ? in1 :
+            oskar_jones_create(DCM, CPU, stations, sources, &status);
+    srand(2);
+    oskar_mem_random_range(oskar_jones_mem(in1), 1.0, 2.0, &status);
+    oskar_mem_random_range(oskar_jones_mem(in2), 1.0, 2.0, &status);
+    for (i = 5; i < 10; ++i)
+    {
+        oskar_jones_set_station_shared(in1, i, 2, &status);
+        oskar_jones_set_station_shared(in2, i, 2, &status);
+    }
+    oskar_jones_set_station_shared(in1, 20, 1, &status);
+    oskar_jones_set_station_shared(in1, 21, 20, &status);
+    EXPECT_EQ(1, oskar_jones_station_row(in1, 21));
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Join copies of the inputs with the shared rows filled in.
+    exp1 = oskar_jones_create_copy(in1, CPU, &status);
+    exp2 = oskar_jones_create_copy(in2, CPU, &status);
+    oskar_jones_expand_shared_stations(exp1, &status);
+    oskar_jones_expand_shared_stations(exp2, &status);
+    out_exp = oskar_jones_create(DCM, CPU, stations, sources, &status);
+    oskar_jones_join(out_exp, exp1, exp2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Join the inputs, and check that only the common sharing remains.
+    oskar_jones_join(out, in1, in2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(5, oskar_jones_num_shared_stations(out));
+    EXPECT_EQ(2, oskar_jones_station_row(out, 7));
+    EXPECT_EQ(15, oskar_jones_station_row(out, 20));
+    oskar_jones_expand_shared_stations(out, &status);
+    check_values(oskar_jones_mem(out), oskar_jones_mem(out_exp));
+
+    // Free memory.
+    if (!in_place) oskar_jones_free(out, &status);
+    oskar_jones_free(in1, &status);
+    oskar_jones_free(in2, &status);
+    oskar_jones_free(exp1, &status);
+    oskar_jones_free(exp2, &status);
+    oskar_jones_free(out_exp, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
 // CPU only. //////////////////////////////////////////////////////////////////
 
+TEST(Jones, join_shared_stations)
+{
+    t_join_shared(0);
+}
+
+TEST(Jones, join_in_place_shared_stations)
+{
+    t_join_shared(1);
+}
+
+TEST(Jones, join_keeps_sharing_of_common_row)
+{
+    int i, status = 0, num_rows = 0, rows[stations];
+    oskar_Jones *E, *R, *E_exp, *R_exp, *out_exp;
+
+    // Create a block holding one row for each group of three stations,
+    // and a block sharing a single row between all stations.
+    for (i = 0; i < stations; ++i)
+        rows[i] = (i % 3 == 0) ? num_rows++ : rows[i - 1];
+    E = oskar_jones_create(DCM, CPU, num_rows, sources, &status);
+    R = oskar_jones_create(DCM, CPU, stations, sources, &status);
+    srand(3);
+    oskar_mem_random_range(oskar_jones_mem(E), 1.0, 2.0, &status);
+    oskar_mem_random_range(oskar_jones_mem(R), 1.0, 2.0, &status);
+    oskar_jones_set_size_shared(E, stations, sources, rows, &status);
+    for (i = 0; i < stations; ++i) rows[i] = 0;
+    oskar_jones_set_size_shared(R, stations, sources, rows, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(stations - num_rows, oskar_jones_num_shared_stations(E));
+    EXPECT_EQ(stations - 1, oskar_jones_num_shared_stations(R));
+
+    // Join copies of the inputs with the shared rows filled in.
+    E_exp = oskar_jones_create_copy(E, CPU, &status);
+    R_exp = oskar_jones_create_copy(R, CPU, &status);
+    oskar_jones_expand_shared_stations(E_exp, &status);
+    oskar_jones_expand_shared_stations(R_exp, &status);
+    out_exp = oskar_jones_create(DCM, CPU, stations, sources, &status);
+    oskar_jones_join(out_exp, E_exp, R_exp, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Join in place, and check that the block still holds only its rows.
+    oskar_jones_join(0, E, R, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(stations - num_rows, oskar_jones_num_shared_stations(E));
+    EXPECT_EQ((size_t)(num_rows * sources),
+            oskar_mem_length(oskar_jones_mem(E)));
+    for (i = 0; i < stations; ++i)
+        EXPECT_EQ(i / 3, oskar_jones_station_row(E, i));
+    oskar_jones_expand_shared_stations(E, &status);
+    check_values(oskar_jones_mem(E), oskar_jones_mem(out_exp));
+
+    // Free memory.
+    oskar_jones_free(E, &status);
+    oskar_jones_free(R, &status);
+    oskar_jones_free(E_exp, &status);
+    oskar_jones_free(R_exp, &status);
+    oskar_jones_free(out_exp, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(Jones, set_size_shared)
+{
+    int i, status = 0, rows[stations];
+    oskar_Jones* jones;
+    oskar_Mem* row;
+
+    // Create a block with space for only three rows.
+    for (i = 0; i < stations; ++i)
+        rows[i] = (i < 3) ? i : i % 3;
+    jones = oskar_jones_create(DC, CPU, 3, sources, &status);
+    oskar_jones_set_size_shared(jones, stations, sources, rows, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(stations, oskar_jones_num_stations(jones));
+    EXPECT_EQ(stations - 3, oskar_jones_num_shared_stations(jones));
+    EXPECT_EQ(1, oskar_jones_station_row(jones, 7));
+    for (i = 0; i < 3; ++i)
+        oskar_mem_set_value_real(oskar_jones_mem(jones), i + 1.0,
+                i * sources, sources, &status);
+
+    // Check that each station gets the data for its row when expanded.
+    oskar_jones_expand_shared_stations(jones, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, oskar_jones_num_shared_stations(jones));
+    row = oskar_mem_create_alias(0, 0, 0, &status);
+    for (i = 0; i < stations; ++i)
+    {
+        oskar_jones_get_station_pointer(row, jones, i, &status);
+        const double2* p = oskar_mem_double2_const(row, &status);
+        EXPECT_DOUBLE_EQ(rows[i] + 1.0, p[0].x);
+        EXPECT_DOUBLE_EQ(rows[i] + 1.0, p[sources - 1].x);
+    }
+    oskar_mem_free(row, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check that rows must be numbered in the order they are first used.
+    rows[0] = 1;
+    oskar_jones_set_size_shared(jones, stations, sources, rows, &status);
+    EXPECT_EQ((int)OSKAR_ERR_INVALID_ARGUMENT, status);
+    status = 0;
+    oskar_jones_free(jones, &status);
+}
+
+TEST(Jones, set_station_shared_keeps_other_stations)
+{
+    int status = 0;
+    oskar_Jones *jones, *orig;
+    oskar_Mem *row, *row_orig;
+
+    // Share row 1 with station 0, then point station 1 at row 2.
+    jones = oskar_jones_create(DC, CPU, stations, sources, &status);
+    srand(4);
+    oskar_mem_random_range(oskar_jones_mem(jones), 1.0, 2.0, &status);
+    orig = oskar_jones_create_copy(jones, CPU, &status);
+    oskar_jones_set_station_shared(jones, 0, 1, &status);
+    oskar_jones_set_station_shared(jones, 1, 2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Station 0 must still use the data originally in row 1.
+    EXPECT_EQ(1, oskar_jones_station_row(jones, 0));
+    EXPECT_EQ(2, oskar_jones_station_row(jones, 1));
+    EXPECT_EQ(1, oskar_jones_num_shared_stations(jones));
+    oskar_jones_expand_shared_stations(jones, &status);
+    row = oskar_mem_create_alias(0, 0, 0, &status);
+    row_orig = oskar_mem_create_alias(0, 0, 0, &status);
+    oskar_jones_get_station_pointer(row, jones, 0, &status);
+    oskar_jones_get_station_pointer(row_orig, orig, 1, &status);
+    EXPECT_FALSE(oskar_mem_different(row, row_orig, 0, &status));
+    oskar_jones_get_station_pointer(row, jones, 1, &status);
+    oskar_jones_get_station_pointer(row_orig, orig, 2, &status);
+    EXPECT_FALSE(oskar_mem_different(row, row_orig, 0, &status));
+
+    // Free memory.
+    oskar_mem_free(row, &status);
+    oskar_mem_free(row_orig, &status);
+    oskar_jones_free(jones, &status);
+    oskar_jones_free(orig, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
 TEST(Jones, join_scal_scal_scal_singleCPU_doubleCPU)
 {
     t_join(SC, SC, SC, CPU, CPU, CPU,
@@ -29,6 +29,7 @@
 #include <gtest/gtest.h>
 
 #include "interferometer/oskar_evaluate_jones_K.h"
+#include "math/oskar_cmath.h"
 #include "utility/oskar_device_utils.h"
 #include "utility/oskar_get_error_string.h"
 #include "utility/oskar_timer.h"
@@ -127,3 +128,86 @@ TEST(Jones_K, test_double)
 {
     run_test(OSKAR_DOUBLE, 1e-8);
 }
+
+static void run_reference_test(int type, double tol)
+{
+    int num_sources = 1003;
+    int num_stations = 7;
+    int status = 0;
+    double I_min = 0.2, I_max = 0.8;
+    double freq_hz = 150e6;
+    double wavenumber = 2.0 * M_PI * freq_hz / 299792458.0;
+    oskar_Jones* K = oskar_jones_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+            num_stations, num_sources, &status);
+    oskar_Mem* l = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    oskar_Mem* m = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    oskar_Mem* n = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    oskar_Mem* I = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    oskar_Mem* u = oskar_mem_create(type, OSKAR_CPU, num_stations, &status);
+    oskar_Mem* v = oskar_mem_create(type, OSKAR_CPU, num_stations, &status);
+    oskar_Mem* w = oskar_mem_create(type, OSKAR_CPU, num_stations, &status);
+    srand(3);
+    oskar_mem_random_range(l, -1.0, 1.0, &status);
+    oskar_mem_random_range(m, -1.0, 1.0, &status);
+    oskar_mem_random_range(n, -1.0, 1.0, &status);
+    oskar_mem_random_range(I, 0.0, 1.0, &status);
+    oskar_mem_random_range(u, -100.0, 100.0, &status);
+    oskar_mem_random_range(v, -100.0, 100.0, &status);
+    oskar_mem_random_range(w, -100.0, 100.0, &status);
+    oskar_evaluate_jones_K(K, num_sources, l, m, n, u, v, w,
+            freq_hz, I, I_min, I_max, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Compare against the phase evaluated directly in double precision.
+    oskar_Mem* K_ref = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_stations * num_sources, &status);
+    double2* k = oskar_mem_double2(K_ref, &status);
+    for (int a = 0; a < num_stations; ++a)
+    {
+        double us = wavenumber * oskar_mem_get_element(u, a, &status);
+        double vs = wavenumber * oskar_mem_get_element(v, a, &status);
+        double ws = wavenumber * oskar_mem_get_element(w, a, &status);
+        for (int s = 0; s < num_sources; ++s)
+        {
+            double phase, flux;
+            int i = a * num_sources + s;
+            flux = oskar_mem_get_element(I, s, &status);
+            phase = us * oskar_mem_get_element(l, s, &status) +
+                    vs * oskar_mem_get_element(m, s, &status) +
+                    ws * (oskar_mem_get_element(n, s, &status) - 1.0);
+            k[i].x = (flux > I_min && flux <= I_max) ? cos(phase) : 0.0;
+            k[i].y = (flux > I_min && flux <= I_max) ? sin(phase) : 0.0;
+        }
+    }
+    oskar_Mem* K_out = oskar_mem_convert_precision(oskar_jones_mem_const(K),
+            OSKAR_DOUBLE, &status);
+    const double2* k_out = oskar_mem_double2_const(K_out, &status);
+    for (int i = 0; i < num_stations * num_sources; ++i)
+    {
+        EXPECT_NEAR(k[i].x, k_out[i].x, tol);
+        EXPECT_NEAR(k[i].y, k_out[i].y, tol);
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_mem_free(I, &status);
+    oskar_mem_free(u, &status);
+    oskar_mem_free(v, &status);
+    oskar_mem_free(w, &status);
+    oskar_mem_free(K_ref, &status);
+    oskar_mem_free(K_out, &status);
+    oskar_jones_free(K, &status);
+}
+
+TEST(Jones_K, cpu_reference_single)
+{
+    // Phases are of order 10^3 radians.
+    run_reference_test(OSKAR_SINGLE, 5e-3);
+}
+
+TEST(Jones_K, cpu_reference_double)
+{
+    run_reference_test(OSKAR_DOUBLE, 1e-10);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "interferometer/oskar_evaluate_jones_R.h"
+#include "math/oskar_cmath.h"
+#include "telescope/oskar_telescope.h"
+#include "utility/oskar_cl_utils.h"
+#include "utility/oskar_get_error_string.h"
+
+static void run_test(int type, int location, int duplicate, double tol)
+{
+    const double deg2rad = M_PI / 180.0;
+    const int num_sources = 300, num_stations = 5;
+    int status = 0;
+    oskar_Jones* R = oskar_jones_create(type | OSKAR_COMPLEX | OSKAR_MATRIX,
+            OSKAR_CPU, num_stations, num_sources, &status);
+    oskar_Jones* R2 = oskar_jones_create(type | OSKAR_COMPLEX | OSKAR_MATRIX,
+            location, num_stations, num_sources, &status);
+    oskar_Mem* ra = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    oskar_Mem* dec = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    oskar_Telescope* tel = oskar_telescope_create(type, OSKAR_CPU,
+            num_stations, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_telescope_set_allow_station_beam_duplication(tel, duplicate);
+    for (int i = 0; i < num_stations; ++i)
+        oskar_station_set_position(oskar_telescope_station(tel, i),
+                (20.0 + 5.0 * i) * deg2rad, (-30.0 + 3.0 * i) * deg2rad, 0.0);
+    for (int i = 0; i < num_sources; ++i)
+    {
+        const double ra_ = (1.2 * i) * deg2rad, dec_ = (-85.0 + 0.5 * i);
+        if (type == OSKAR_DOUBLE)
+        {
+            oskar_mem_double(ra, &status)[i] = ra_;
+            oskar_mem_double(dec, &status)[i] = dec_ * deg2rad;
+        }
+        else
+        {
+            oskar_mem_float(ra, &status)[i] = (float) ra_;
+            oskar_mem_float(dec, &status)[i] = (float) (dec_ * deg2rad);
+        }
+    }
+    oskar_Mem* ra2 = oskar_mem_create_copy(ra, location, &status);
+    oskar_Mem* dec2 = oskar_mem_create_copy(dec, location, &status);
+    oskar_Telescope* tel2 = oskar_telescope_create_copy(tel, location,
+            &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Evaluate Jones R on the CPU and on the device.
+    const double gast = 1.3;
+    oskar_evaluate_jones_R(R, num_sources, ra, dec, tel, gast, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_evaluate_jones_R(R2, num_sources, ra2, dec2, tel2, gast, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the results are consistent for every station.
+    oskar_Mem* R_cpu = oskar_mem_create_copy(oskar_jones_mem(R2), OSKAR_CPU,
+            &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const int num_rows = duplicate ? 1 : num_stations;
+    double max_err = 0.0;
+    for (int i = 0; i < num_rows * num_sources * 8; ++i)
+    {
+        const double a = (type == OSKAR_DOUBLE) ?
+                oskar_mem_double(oskar_jones_mem(R), &status)[i] :
+                oskar_mem_float(oskar_jones_mem(R), &status)[i];
+        const double b = (type == OSKAR_DOUBLE) ?
+                oskar_mem_double(R_cpu, &status)[i] :
+                oskar_mem_float(R_cpu, &status)[i];
+        if (fabs(a - b) > max_err) max_err = fabs(a - b);
+    }
+    EXPECT_LT(max_err, tol);
+    for (int i = 0; i < num_stations; ++i)
+        EXPECT_EQ(oskar_jones_station_row(R, i),
+                oskar_jones_station_row(R2, i));
+
+    // Free memory.
+    oskar_jones_free(R, &status);
+    oskar_jones_free(R2, &status);
+    oskar_mem_free(ra, &status);
+    oskar_mem_free(dec, &status);
+    oskar_mem_free(ra2, &status);
+    oskar_mem_free(dec2, &status);
+    oskar_mem_free(R_cpu, &status);
+    oskar_telescope_free(tel, &status);
+    oskar_telescope_free(tel2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+#ifdef OSKAR_HAVE_CUDA
+TEST(evaluate_jones_R, test_single_gpu)
+{
+    run_test(OSKAR_SINGLE, OSKAR_GPU, 0, 1e-5);
+}
+
+TEST(evaluate_jones_R, test_double_gpu)
+{
+    run_test(OSKAR_DOUBLE, OSKAR_GPU, 0, 1e-12);
+}
+#endif
+
+#ifdef OSKAR_HAVE_OPENCL
+TEST(evaluate_jones_R, test_single_cl)
+{
+    if (oskar_cl_num_devices() == 0) return;
+    run_test(OSKAR_SINGLE, OSKAR_CL, 0, 1e-5);
+    run_test(OSKAR_SINGLE, OSKAR_CL, 1, 1e-5);
+}
+
+TEST(evaluate_jones_R, test_double_cl)
+{
+    if (oskar_cl_num_devices() == 0) return;
+    run_test(OSKAR_DOUBLE, OSKAR_CL, 0, 1e-12);
+    run_test(OSKAR_DOUBLE, OSKAR_CL, 1, 1e-12);
+}
+#endif
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "binary/oskar_binary.h"
+#include "interferometer/oskar_interferometer.h"
+#include "math/oskar_cmath.h"
+#include "sky/oskar_sky.h"
+#include "telescope/oskar_telescope.h"
+#include "utility/oskar_cl_utils.h"
+#include "utility/oskar_get_error_string.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct CallbackData
+{
+    std::vector<int> block_indices;
+    std::vector<std::vector<char> > blocks;
+};
+
+static void store_block(const oskar_VisBlock* block, int block_index,
+        void* user_data)
+{
+    CallbackData* data = (CallbackData*) user_data;
+    const oskar_Mem* xc = oskar_vis_block_cross_correlations_const(block);
+    const char* p = (const char*) oskar_mem_void_const(xc);
+    size_t bytes = oskar_mem_length(xc) *
+            oskar_mem_element_size(oskar_mem_type(xc));
+    data->block_indices.push_back(block_index);
+    data->blocks.push_back(std::vector<char>(p, p + bytes));
+}
+
+static void run_sim(int num_output_buffers, const char* filename,
+        CallbackData* data, int* status)
+{
+    const double deg2rad = M_PI / 180.0;
+    const int num_stations = 6, num_sources = 50;
+
+    // Create a telescope model.
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_stations, status);
+    oskar_telescope_set_position(tel, 20.0 * deg2rad, -30.0 * deg2rad, 0.0);
+    oskar_telescope_set_phase_centre(tel, OSKAR_SPHERICAL_TYPE_EQUATORIAL,
+            10.0 * deg2rad, -40.0 * deg2rad);
+    oskar_telescope_set_station_type(tel, "Isotropic", status);
+    oskar_telescope_set_pol_mode(tel, "Scalar", status);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        double offset[] = {100.0 * i, -50.0 * i * i, 10.0 * i};
+        oskar_telescope_set_station_coords(tel, i, offset, offset,
+                offset, offset, status);
+    }
+
+    // Create a sky model.
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_sources, status);
+    for (int i = 0; i < num_sources; ++i)
+        oskar_sky_set_source(sky, i, (10.0 + 0.1 * i) * deg2rad,
+                (-40.0 + 0.05 * i) * deg2rad, 1.0 + i, 0.0, 0.0, 0.0,
+                100e6, 0.0, 0.0, 0.0, 0.0, 0.0, status);
+
+    // Run the simulation, writing to a file and to the callback.
+    oskar_Interferometer* h = oskar_interferometer_create(OSKAR_DOUBLE,
+            status);
+    oskar_interferometer_set_gpus(h, 0, 0, status);
+    oskar_interferometer_set_num_devices(h, 2);
+    oskar_interferometer_set_max_sources_per_chunk(h, 16);
+    oskar_interferometer_set_max_times_per_block(h, 2);
+    oskar_interferometer_set_num_output_buffers(h, num_output_buffers);
+    oskar_interferometer_set_observation_frequency(h, 100e6, 10e6, 3);
+    oskar_interferometer_set_observation_time(h, 51544.5, 600.0, 11);
+    oskar_interferometer_set_telescope_model(h, tel, status);
+    oskar_interferometer_set_sky_model(h, sky, status);
+    oskar_interferometer_set_output_vis_file(h, filename);
+    oskar_interferometer_set_block_callback(h, store_block, data);
+    oskar_interferometer_run(h, status);
+    oskar_interferometer_free(h, status);
+    oskar_telescope_free(tel, status);
+    oskar_sky_free(sky, status);
+}
+
+TEST(interferometer, output_sinks)
+{
+    const int num_buffers[] = {1, 3};
+    for (int k = 0; k < 2; ++k)
+    {
+        int status = 0;
+        CallbackData data;
+        const char* filename = "temp_test_interferometer_sinks.vis";
+        run_sim(num_buffers[k], filename, &data, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Check the callback saw every block, in order.
+        ASSERT_EQ(6, (int)data.block_indices.size());
+        for (int b = 0; b < (int)data.block_indices.size(); ++b)
+            EXPECT_EQ(b, data.block_indices[b]);
+        int num_nonzero = 0;
+        for (size_t i = 0; i < data.blocks[0].size(); ++i)
+            if (data.blocks[0][i] != 0) num_nonzero++;
+        EXPECT_GT(num_nonzero, 0);
+
+        // Check the file contains the same data as the callback.
+        oskar_Binary* file = oskar_binary_create(filename, 'r', &status);
+        oskar_VisHeader* hdr = oskar_vis_header_read(file, &status);
+        oskar_VisBlock* blk = oskar_vis_block_create_from_header(OSKAR_CPU,
+                hdr, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        for (int b = 0; b < (int)data.blocks.size(); ++b)
+        {
+            oskar_vis_block_read(blk, hdr, file, b, &status);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            const oskar_Mem* xc = oskar_vis_block_cross_correlations_const(blk);
+            ASSERT_EQ(data.blocks[b].size(), oskar_mem_length(xc) *
+                    oskar_mem_element_size(oskar_mem_type(xc)));
+            EXPECT_EQ(0, memcmp(&data.blocks[b][0],
+                    oskar_mem_void_const(xc), data.blocks[b].size()));
+        }
+        oskar_vis_block_free(blk, &status);
+        oskar_vis_header_free(hdr, &status);
+        oskar_binary_free(file);
+        remove(filename);
+    }
+}
+
+static void run_polarised_sim(const char* correlation_type,
+        int allow_duplication, CallbackData* data, int* status)
+{
+    const double deg2rad = M_PI / 180.0;
+    const int num_stations = 6, num_sources = 50;
+
+    // Create a telescope model.
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_stations, status);
+    oskar_telescope_set_position(tel, 20.0 * deg2rad, -30.0 * deg2rad, 0.0);
+    oskar_telescope_set_phase_centre(tel, OSKAR_SPHERICAL_TYPE_EQUATORIAL,
+            10.0 * deg2rad, -40.0 * deg2rad);
+    oskar_telescope_set_station_type(tel, "Isotropic", status);
+    oskar_telescope_set_pol_mode(tel, "Full", status);
+    oskar_telescope_set_channel_bandwidth(tel, 1e6);
+    oskar_telescope_set_time_average(tel, 10.0);
+    oskar_telescope_set_allow_station_beam_duplication(tel,
+            allow_duplication);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        double offset[] = {100.0 * i, -50.0 * i * i, 10.0 * i};
+        oskar_telescope_set_station_coords(tel, i, offset, offset,
+                offset, offset, status);
+    }
+
+    // Create a sky model, with fluxes that vary with frequency.
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_sources, status);
+    for (int i = 0; i < num_sources; ++i)
+        oskar_sky_set_source(sky, i, (10.0 + 0.1 * i) * deg2rad,
+                (-40.0 + 0.05 * i) * deg2rad, 1.0 + i, 0.2 * i, 0.1, 0.0,
+                100e6, -0.7 + 0.02 * i, 2.0, 0.0, 0.0, 0.0, status);
+
+    // Run the simulation. A flux range is set, so Jones K is formed
+    // separately for each channel if auto-correlations are also needed.
+    oskar_Interferometer* h = oskar_interferometer_create(OSKAR_DOUBLE,
+            status);
+    oskar_interferometer_set_gpus(h, 0, 0, status);
+    oskar_interferometer_set_num_devices(h, 1);
+    oskar_interferometer_set_max_sources_per_chunk(h, 16);
+    oskar_interferometer_set_max_times_per_block(h, 2);
+    oskar_interferometer_set_correlation_type(h, correlation_type, status);
+    oskar_interferometer_set_source_flux_range(h, 0.0, 1e9);
+    oskar_interferometer_set_observation_frequency(h, 100e6, 10e6, 5);
+    oskar_interferometer_set_observation_time(h, 51544.5, 600.0, 3);
+    oskar_interferometer_set_telescope_model(h, tel, status);
+    oskar_interferometer_set_sky_model(h, sky, status);
+    oskar_interferometer_set_block_callback(h, store_block, data);
+    oskar_interferometer_run(h, status);
+    oskar_interferometer_free(h, status);
+    oskar_telescope_free(tel, status);
+    oskar_sky_free(sky, status);
+}
+
+TEST(interferometer, channel_batch)
+{
+    // Cross-correlations only: all channels are correlated together.
+    // Both: each channel is correlated separately, using Jones K.
+    int status = 0;
+    CallbackData batched, separate;
+    run_polarised_sim("Cross-correlations", 0, &batched, &status);
+    run_polarised_sim("Both", 0, &separate, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(batched.blocks.size(), separate.blocks.size());
+    for (size_t b = 0; b < batched.blocks.size(); ++b)
+    {
+        const size_t num = batched.blocks[b].size() / sizeof(double);
+        ASSERT_EQ(batched.blocks[b].size(), separate.blocks[b].size());
+        ASSERT_GT(num, 0u);
+        const double* v1 = (const double*) &batched.blocks[b][0];
+        const double* v2 = (const double*) &separate.blocks[b][0];
+        for (size_t i = 0; i < num; ++i)
+            EXPECT_NEAR(v1[i], v2[i], 1e-9 * (1.0 + fabs(v2[i])));
+    }
+}
+
+TEST(interferometer, shared_station_beams)
+{
+    // The stations are identical, so with beam duplication allowed
+    // Jones E holds a single row shared by all stations.
+    const char* types[] = {"Cross-correlations", "Both"};
+    for (int k = 0; k < 2; ++k)
+    {
+        int status = 0;
+        CallbackData shared, distinct;
+        run_polarised_sim(types[k], 1, &shared, &status);
+        run_polarised_sim(types[k], 0, &distinct, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_EQ(shared.blocks.size(), distinct.blocks.size());
+        for (size_t b = 0; b < shared.blocks.size(); ++b)
+        {
+            const size_t num = shared.blocks[b].size() / sizeof(double);
+            ASSERT_EQ(shared.blocks[b].size(), distinct.blocks[b].size());
+            ASSERT_GT(num, 0u);
+            const double* v1 = (const double*) &shared.blocks[b][0];
+            const double* v2 = (const double*) &distinct.blocks[b][0];
+            for (size_t i = 0; i < num; ++i)
+                EXPECT_NEAR(v1[i], v2[i], 1e-9 * (1.0 + fabs(v2[i])));
+        }
+    }
+}
+
+#ifdef OSKAR_HAVE_OPENCL
+static void run_device_sim(const char* station_type, int use_opencl,
+        CallbackData* data, int* status)
+{
+    const double deg2rad = M_PI / 180.0;
+    const int num_stations = 5, num_sources = 40, num_elements = 9;
+
+    // Create a telescope model. Aperture arrays hold a grid of tapered
+    // dipoles with gain and phase errors, and a different spacing in each
+    // station. Dipoles in alternate stations have different orientations.
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_stations, status);
+    oskar_telescope_set_position(tel, 20.0 * deg2rad, -30.0 * deg2rad, 0.0);
+    oskar_telescope_set_phase_centre(tel, OSKAR_SPHERICAL_TYPE_EQUATORIAL,
+            10.0 * deg2rad, -40.0 * deg2rad);
+    oskar_telescope_set_pol_mode(tel, "Full", status);
+    oskar_telescope_set_gaussian_station_beam_width(tel, 5.0, 100e6);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        double offset[] = {100.0 * i, -50.0 * i * i, 10.0 * i};
+        oskar_Station* station = oskar_telescope_station(tel, i);
+        oskar_telescope_set_station_coords(tel, i, offset, offset,
+                offset, offset, status);
+        oskar_station_resize(station, num_elements, status);
+        oskar_station_resize_element_types(station, 1, status);
+        for (int j = 0; j < num_elements; ++j)
+        {
+            double xyz[] = {(1.5 + 0.1 * i) * (j % 3 - 1),
+                    (1.5 + 0.1 * i) * (j / 3 - 1), 0.0};
+            oskar_station_set_element_coords(station, j, xyz, xyz, status);
+            oskar_station_set_element_errors(station, j, 1.0 + 0.01 * j,
+                    0.05, 0.01 * j, 0.02, status);
+            if (i % 2)
+            {
+                oskar_station_set_element_feed_angle(station, 1, j,
+                        10.0 * j, 0.0, 0.0, status);
+                oskar_station_set_element_feed_angle(station, 0, j,
+                        10.0 * j, 0.0, 0.0, status);
+            }
+        }
+        oskar_Element* element = oskar_station_element(station, 0);
+        oskar_element_set_element_type(element, "Dipole", status);
+        oskar_element_set_dipole_length(element, 0.5, "Wavelengths", status);
+        oskar_element_set_taper_type(element, "Cosine", status);
+        oskar_element_set_cosine_power(element, 1.5);
+    }
+    oskar_telescope_set_station_type(tel, station_type, status);
+
+    // Create a sky model, with fluxes that vary with frequency.
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_sources, status);
+    for (int i = 0; i < num_sources; ++i)
+        oskar_sky_set_source(sky, i, (10.0 + 0.2 * i) * deg2rad,
+                (-40.0 + 0.1 * i) * deg2rad, 1.0 + i, 0.2 * i, 0.1, 0.0,
+                100e6, -0.7 + 0.02 * i, 2.0, 0.0, 0.0, 0.0, status);
+
+    // Run the simulation on the CPU or on an OpenCL device.
+    oskar_Interferometer* h = oskar_interferometer_create(OSKAR_DOUBLE,
+            status);
+    oskar_interferometer_set_gpus(h, 0, 0, status);
+    if (use_opencl)
+        oskar_interferometer_set_use_opencl(h, 1, status);
+    oskar_interferometer_set_num_devices(h, 1);
+    oskar_interferometer_set_max_sources_per_chunk(h, 16);
+    oskar_interferometer_set_max_times_per_block(h, 2);
+    oskar_interferometer_set_correlation_type(h, "Both", status);
+    oskar_interferometer_set_observation_frequency(h, 100e6, 10e6, 3);
+    oskar_interferometer_set_observation_time(h, 51544.5, 600.0, 3);
+    oskar_interferometer_set_telescope_model(h, tel, status);
+    oskar_interferometer_set_sky_model(h, sky, status);
+    oskar_interferometer_set_block_callback(h, store_block, data);
+    oskar_interferometer_run(h, status);
+    oskar_interferometer_free(h, status);
+    oskar_telescope_free(tel, status);
+    oskar_sky_free(sky, status);
+}
+
+TEST(interferometer, compare_cl)
+{
+    const char* types[] = {"Isotropic", "Gaussian beam", "Aperture array"};
+    if (oskar_cl_num_devices() == 0) return;
+    for (int k = 0; k < 3; ++k)
+    {
+        int status = 0;
+        CallbackData cpu, cl;
+        run_device_sim(types[k], 0, &cpu, &status);
+        run_device_sim(types[k], 1, &cl, &status);
+        ASSERT_EQ(0, status) << types[k] << ": " <<
+                oskar_get_error_string(status);
+        ASSERT_EQ(cpu.blocks.size(), cl.blocks.size());
+        for (size_t b = 0; b < cpu.blocks.size(); ++b)
+        {
+            const size_t num = cpu.blocks[b].size() / sizeof(double);
+            ASSERT_EQ(cpu.blocks[b].size(), cl.blocks[b].size());
+            ASSERT_GT(num, 0u);
+            const double* v1 = (const double*) &cpu.blocks[b][0];
+            const double* v2 = (const double*) &cl.blocks[b][0];
+            for (size_t i = 0; i < num; ++i)
+                ASSERT_NEAR(v1[i], v2[i], 1e-9 * (1.0 + fabs(v1[i])))
+                        << types[k] << ": block " << b << ", index " << i;
+        }
+    }
+}
+#endif
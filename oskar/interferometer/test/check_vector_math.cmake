@@ -0,0 +1,22 @@
+#
+# oskar/interferometer/test/check_vector_math.cmake
+#
+# Checks that the OSKAR library calls the vector variants of sin() and cos()
+# in both precisions, i.e. that the loops over sources in
+# oskar_evaluate_jones_K_f() and oskar_evaluate_jones_K_d() were vectorised.
+#
+# Usage: cmake -DNM=<nm> -DLIB=<library> -P check_vector_math.cmake
+#
+
+execute_process(COMMAND ${NM} -D ${LIB}
+    OUTPUT_VARIABLE symbols RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Unable to list symbols in ${LIB}")
+endif()
+foreach (func cos sin cosf sinf)
+    if (NOT symbols MATCHES "_ZGV[bcde]N[0-9]+v_${func}[@\n]")
+        message(FATAL_ERROR "No vector variant of ${func}() is called: "
+            "the Jones K loops were not vectorised.")
+    endif()
+    message(STATUS "Found vector variant of ${func}()")
+endforeach()
@@ -62,6 +62,59 @@ void oskar_dft_c2r(
         oskar_Mem* output,
         int* status);
 
+/**
+ * @brief
+ * Performs a complex-to-real DFT of data from a set of equally spaced
+ * channels.
+ *
+ * @details
+ * Computes the same result as oskar_dft_c2r() for the data from all
+ * \p num_channels channels, where the input positions for channel c are
+ * those for channel 0 scaled by the wavenumber
+ * \p wavenumber_start + c * \p wavenumber_inc.
+ * The output is the sum over all channels.
+ * Phases are advanced from one channel to the next by complex
+ * multiplication, rather than evaluated again for each channel.
+ *
+ * The input data and weights must have dimension order
+ * (slowest) channel, input point (fastest).
+ *
+ * This function is currently only available for data in CPU memory.
+ *
+ * @param[in] num_channels     Number of channels.
+ * @param[in] num_in           Number of input points per channel.
+ * @param[in] wavenumber_start Wavenumber (2 pi / wavelength) of channel 0.
+ * @param[in] wavenumber_inc   Wavenumber increment between channels.
+ * @param[in] x_in             Array of input x positions for channel 0.
+ * @param[in] y_in             Array of input y positions for channel 0.
+ * @param[in] z_in             Array of input z positions (may be NULL).
+ * @param[in] data_in          Array of complex input data.
+ * @param[in] weights_in       Array of input data weights.
+ * @param[in] num_out          Number of output points.
+ * @param[in] x_out            Array of output 1/x positions.
+ * @param[in] y_out            Array of output 1/y positions.
+ * @param[in] z_out            Array of output 1/z positions (may be NULL).
+ * @param[out] output          Array of computed output points.
+ * @param[in,out] status       Status return code.
+ */
+OSKAR_EXPORT
+void oskar_dft_c2r_channels(
+        int num_channels,
+        int num_in,
+        double wavenumber_start,
+        double wavenumber_inc,
+        const oskar_Mem* x_in,
+        const oskar_Mem* y_in,
+        const oskar_Mem* z_in,
+        const oskar_Mem* data_in,
+        const oskar_Mem* weights_in,
+        int num_out,
+        const oskar_Mem* x_out,
+        const oskar_Mem* y_out,
+        const oskar_Mem* z_out,
+        oskar_Mem* output,
+        int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,7 @@
 #include "math/oskar_dft_c2r_2d_omp.h"
 #include "math/oskar_dft_c2r_3d_cuda.h"
 #include "math/oskar_dft_c2r_3d_omp.h"
+#include "math/oskar_dft_c2r_channels_omp.h"
 #include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
@@ -365,3 +366,103 @@ void oskar_dft_c2r(
         *status = OSKAR_ERR_BAD_LOCATION;
     }
 }
+
+void oskar_dft_c2r_channels(
+        int num_channels,
+        int num_in,
+        double wavenumber_start,
+        double wavenumber_inc,
+        const oskar_Mem* x_in,
+        const oskar_Mem* y_in,
+        const oskar_Mem* z_in,
+        const oskar_Mem* data_in,
+        const oskar_Mem* weights_in,
+        int num_out,
+        const oskar_Mem* x_out,
+        const oskar_Mem* y_out,
+        const oskar_Mem* z_out,
+        oskar_Mem* output,
+        int* status)
+{
+    int type, is_3d;
+    if (*status) return;
+
+    /* Find out what we have. */
+    type = oskar_mem_precision(output);
+    is_3d = (z_in != NULL && z_out != NULL && oskar_mem_length(z_out) > 0);
+    if (!oskar_mem_is_complex(data_in) ||
+            oskar_mem_precision(data_in) != type ||
+            oskar_mem_is_complex(output) ||
+            oskar_mem_is_complex(weights_in) ||
+            oskar_mem_is_matrix(weights_in))
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+    if (oskar_mem_precision(weights_in) != type ||
+            oskar_mem_type(x_in) != type ||
+            oskar_mem_type(y_in) != type ||
+            oskar_mem_type(x_out) != type ||
+            oskar_mem_type(y_out) != type ||
+            (is_3d && (oskar_mem_type(z_in) != type ||
+                    oskar_mem_type(z_out) != type)))
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* Only CPU memory is supported. */
+    if (oskar_mem_location(output) != OSKAR_CPU ||
+            oskar_mem_location(data_in) != OSKAR_CPU ||
+            oskar_mem_location(weights_in) != OSKAR_CPU ||
+            oskar_mem_location(x_in) != OSKAR_CPU ||
+            oskar_mem_location(y_in) != OSKAR_CPU ||
+            oskar_mem_location(x_out) != OSKAR_CPU ||
+            oskar_mem_location(y_out) != OSKAR_CPU ||
+            (is_3d && (oskar_mem_location(z_in) != OSKAR_CPU ||
+                    oskar_mem_location(z_out) != OSKAR_CPU)))
+    {
+        *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+        return;
+    }
+
+    /* Check the input dimensions. */
+    if ((int)oskar_mem_length(x_in) < num_in ||
+            (int)oskar_mem_length(y_in) < num_in ||
+            (int)oskar_mem_length(data_in) < num_channels * num_in ||
+            (int)oskar_mem_length(weights_in) < num_channels * num_in)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Resize output array if needed. */
+    if ((int)oskar_mem_length(output) < num_out)
+        oskar_mem_realloc(output, num_out, status);
+    if (*status) return;
+
+    if (type == OSKAR_DOUBLE)
+        oskar_dft_c2r_channels_omp_d(num_channels, num_in,
+                wavenumber_start, wavenumber_inc,
+                oskar_mem_double_const(x_in, status),
+                oskar_mem_double_const(y_in, status),
+                is_3d ? oskar_mem_double_const(z_in, status) : 0,
+                oskar_mem_double2_const(data_in, status),
+                oskar_mem_double_const(weights_in, status),
+                num_out, oskar_mem_double_const(x_out, status),
+                oskar_mem_double_const(y_out, status),
+                is_3d ? oskar_mem_double_const(z_out, status) : 0,
+                oskar_mem_double(output, status));
+    else
+        oskar_dft_c2r_channels_omp_f(num_channels, num_in,
+                (float)wavenumber_start, (float)wavenumber_inc,
+                oskar_mem_float_const(x_in, status),
+                oskar_mem_float_const(y_in, status),
+                is_3d ? oskar_mem_float_const(z_in, status) : 0,
+                oskar_mem_float2_const(data_in, status),
+                oskar_mem_float_const(weights_in, status),
+                num_out, oskar_mem_float_const(x_out, status),
+                oskar_mem_float_const(y_out, status),
+                is_3d ? oskar_mem_float_const(z_out, status) : 0,
+                oskar_mem_float(output, status));
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifdef OSKAR_HAVE_CUDA
+#include <cufft.h>
+#endif
+#ifdef OSKAR_HAVE_FFTW
+#include <fftw3.h>
+#endif
+
+#include "math/oskar_fft.h"
+#include "math/oskar_fftpack_cfft.h"
+#include "math/oskar_fftpack_cfft_f.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of lines transformed together by FFTPACK in each block. */
+#define FFT_BLOCK 32
+
+struct oskar_FFT
+{
+    int precision, location, num_dim, dim_size, num_threads;
+    oskar_Mem *fftpack_wsave, *fftpack_work;
+#ifdef OSKAR_HAVE_CUDA
+    cufftHandle cufft_plan;
+#endif
+#ifdef OSKAR_HAVE_FFTW
+    fftw_plan fftw_plan_d;
+    fftwf_plan fftw_plan_f;
+    int fftw_alignment;
+#endif
+};
+
+#ifdef OSKAR_HAVE_FFTW
+static void fft_fftw(oskar_FFT* h, void* data);
+#else
+static void fft_fftpack(oskar_FFT* h, void* data);
+#endif
+
+oskar_FFT* oskar_fft_create(int precision, int location, int num_dim,
+        int dim_size, int num_threads, int* status)
+{
+    oskar_FFT* h = 0;
+    if (*status) return 0;
+    if (precision != OSKAR_SINGLE && precision != OSKAR_DOUBLE)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return 0;
+    }
+    if ((num_dim != 1 && num_dim != 2) || dim_size < 1)
+    {
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        return 0;
+    }
+    h = (oskar_FFT*) calloc(1, sizeof(oskar_FFT));
+    h->precision = precision;
+    h->location = location;
+    h->num_dim = num_dim;
+    h->dim_size = dim_size;
+    h->num_threads = num_threads > 0 ? num_threads : 1;
+    if (location == OSKAR_GPU)
+    {
+#ifdef OSKAR_HAVE_CUDA
+        if (num_dim == 1)
+            cufftPlan1d(&h->cufft_plan, dim_size,
+                    precision == OSKAR_DOUBLE ? CUFFT_Z2Z : CUFFT_C2C, 1);
+        else
+            cufftPlan2d(&h->cufft_plan, dim_size, dim_size,
+                    precision == OSKAR_DOUBLE ? CUFFT_Z2Z : CUFFT_C2C);
+#else
+        *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location == OSKAR_CPU)
+    {
+#ifndef OSKAR_HAVE_FFTW
+        /* Initialise FFTPACK, with work space for each thread. */
+        const int len_save = 2 * dim_size +
+                (int)(log((double)dim_size) / log(2.0)) + 4;
+        h->fftpack_wsave = oskar_mem_create(precision, OSKAR_CPU,
+                len_save, status);
+        h->fftpack_work = oskar_mem_create(precision, OSKAR_CPU,
+                2 * FFT_BLOCK * (size_t)dim_size * h->num_threads, status);
+        if (*status)
+        {
+            oskar_fft_free(h);
+            return 0;
+        }
+        if (precision == OSKAR_DOUBLE)
+            oskar_fftpack_cfftmi(dim_size,
+                    oskar_mem_double(h->fftpack_wsave, status));
+        else
+            oskar_fftpack_cfftmi_f(dim_size,
+                    oskar_mem_float(h->fftpack_wsave, status));
+#endif
+    }
+    else
+        *status = OSKAR_ERR_BAD_LOCATION;
+    if (*status)
+    {
+        oskar_fft_free(h);
+        return 0;
+    }
+    return h;
+}
+
+
+void oskar_fft_exec(oskar_FFT* h, oskar_Mem* data, int* status)
+{
+    size_t num_cells;
+    oskar_Mem *data_copy = 0, *data_ptr = data;
+    if (*status) return;
+    if (oskar_mem_precision(data) != h->precision ||
+            !oskar_mem_is_complex(data))
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+    num_cells = (size_t) h->dim_size;
+    if (h->num_dim == 2) num_cells *= h->dim_size;
+    if (oskar_mem_length(data) < num_cells)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    if (oskar_mem_location(data) != h->location)
+    {
+        data_copy = oskar_mem_create_copy(data, h->location, status);
+        data_ptr = data_copy;
+    }
+    if (*status)
+    {
+        oskar_mem_free(data_copy, status);
+        return;
+    }
+    if (h->location == OSKAR_GPU)
+    {
+#ifdef OSKAR_HAVE_CUDA
+        if (h->precision == OSKAR_DOUBLE)
+            cufftExecZ2Z(h->cufft_plan, oskar_mem_void(data_ptr),
+                    oskar_mem_void(data_ptr), CUFFT_FORWARD);
+        else
+            cufftExecC2C(h->cufft_plan, oskar_mem_void(data_ptr),
+                    oskar_mem_void(data_ptr), CUFFT_FORWARD);
+#endif
+    }
+    else
+    {
+#ifdef OSKAR_HAVE_FFTW
+        fft_fftw(h, oskar_mem_void(data_ptr));
+#else
+        fft_fftpack(h, oskar_mem_void(data_ptr));
+#endif
+    }
+    if (data_copy)
+    {
+        oskar_mem_copy(data, data_copy, status);
+        oskar_mem_free(data_copy, status);
+    }
+}
+
+
+void oskar_fft_free(oskar_FFT* h)
+{
+    int status = 0;
+    if (!h) return;
+    oskar_mem_free(h->fftpack_wsave, &status);
+    oskar_mem_free(h->fftpack_work, &status);
+#ifdef OSKAR_HAVE_CUDA
+    if (h->location == OSKAR_GPU)
+        cufftDestroy(h->cufft_plan);
+#endif
+#ifdef OSKAR_HAVE_FFTW
+    if (h->fftw_plan_d) fftw_destroy_plan(h->fftw_plan_d);
+    if (h->fftw_plan_f) fftwf_destroy_plan(h->fftw_plan_f);
+#endif
+    free(h);
+}
+
+
+#ifdef OSKAR_HAVE_FFTW
+void fft_fftw(oskar_FFT* h, void* data)
+{
+    static int threads_initialised = 0;
+    const int n = h->dim_size;
+    if (!threads_initialised)
+    {
+        fftw_init_threads();
+        fftwf_init_threads();
+        threads_initialised = 1;
+    }
+
+    /* Plans are made for the first array, and re-used while the alignment
+     * of subsequent arrays is the same. Planning with FFTW_ESTIMATE does
+     * not overwrite the data. */
+    if (h->precision == OSKAR_DOUBLE)
+    {
+        fftw_complex* p = (fftw_complex*) data;
+        const int alignment = fftw_alignment_of((double*) data);
+        if (!h->fftw_plan_d || alignment != h->fftw_alignment)
+        {
+            if (h->fftw_plan_d) fftw_destroy_plan(h->fftw_plan_d);
+            fftw_plan_with_nthreads(h->num_threads);
+            h->fftw_plan_d = (h->num_dim == 1) ?
+                    fftw_plan_dft_1d(n, p, p, FFTW_FORWARD, FFTW_ESTIMATE) :
+                    fftw_plan_dft_2d(n, n, p, p, FFTW_FORWARD, FFTW_ESTIMATE);
+            h->fftw_alignment = alignment;
+        }
+        fftw_execute_dft(h->fftw_plan_d, p, p);
+    }
+    else
+    {
+        fftwf_complex* p = (fftwf_complex*) data;
+        const int alignment = fftwf_alignment_of((float*) data);
+        if (!h->fftw_plan_f || alignment != h->fftw_alignment)
+        {
+            if (h->fftw_plan_f) fftwf_destroy_plan(h->fftw_plan_f);
+            fftwf_plan_with_nthreads(h->num_threads);
+            h->fftw_plan_f = (h->num_dim == 1) ?
+                    fftwf_plan_dft_1d(n, p, p, FFTW_FORWARD, FFTW_ESTIMATE) :
+                    fftwf_plan_dft_2d(n, n, p, p, FFTW_FORWARD, FFTW_ESTIMATE);
+            h->fftw_alignment = alignment;
+        }
+        fftwf_execute_dft(h->fftw_plan_f, p, p);
+    }
+}
+#else
+
+
+void fft_fftpack(oskar_FFT* h, void* data)
+{
+    int b;
+    const int n = h->dim_size, num_blocks = (n + FFT_BLOCK - 1) / FFT_BLOCK;
+    const int num_rows = (h->num_dim == 1) ? 1 : n;
+    const size_t work_size = 2 * FFT_BLOCK * (size_t)n;
+    const double scale = (h->num_dim == 1) ? (double)n : (double)n * n;
+    if (n == 1) return;
+
+    /* FFTPACK normalises by 1 / n for each dimension, so scale the
+     * output to match FFTW and cuFFT.
+     *
+     * In 2D, columns are transformed first, in blocks of adjacent columns
+     * so that memory is accessed contiguously across each block, and then
+     * each row is transformed and scaled while it is still in cache. */
+    if (h->precision == OSKAR_DOUBLE)
+    {
+        double *c = (double*) data;
+        double *wsave = (double*) oskar_mem_void(h->fftpack_wsave);
+        double *work = (double*) oskar_mem_void(h->fftpack_work);
+        if (h->num_dim == 2)
+        {
+#pragma omp parallel for num_threads(h->num_threads) schedule(dynamic, 1)
+            for (b = 0; b < num_blocks; ++b)
+            {
+                int thread = 0;
+                const int lot = (b + 1) * FFT_BLOCK <= n ?
+                        FFT_BLOCK : n - b * FFT_BLOCK;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                oskar_fftpack_cfftmf(lot, 1, n, n, c + 2 * b * FFT_BLOCK,
+                        wsave, work + thread * work_size);
+            }
+        }
+#pragma omp parallel for num_threads(h->num_threads) schedule(dynamic, 1)
+        for (b = 0; b < num_rows; ++b)
+        {
+            int thread = 0, i;
+            double *row = c + 2 * (size_t)b * n;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            oskar_fftpack_cfftmf(1, n, n, 1, row, wsave,
+                    work + thread * work_size);
+            for (i = 0; i < 2 * n; ++i) row[i] *= scale;
+        }
+    }
+    else
+    {
+        float *c = (float*) data;
+        float *wsave = (float*) oskar_mem_void(h->fftpack_wsave);
+        float *work = (float*) oskar_mem_void(h->fftpack_work);
+        const float scale_f = (float) scale;
+        if (h->num_dim == 2)
+        {
+#pragma omp parallel for num_threads(h->num_threads) schedule(dynamic, 1)
+            for (b = 0; b < num_blocks; ++b)
+            {
+                int thread = 0;
+                const int lot = (b + 1) * FFT_BLOCK <= n ?
+                        FFT_BLOCK : n - b * FFT_BLOCK;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                oskar_fftpack_cfftmf_f(lot, 1, n, n, c + 2 * b * FFT_BLOCK,
+                        wsave, work + thread * work_size);
+            }
+        }
+#pragma omp parallel for num_threads(h->num_threads) schedule(dynamic, 1)
+        for (b = 0; b < num_rows; ++b)
+        {
+            int thread = 0, i;
+            float *row = c + 2 * (size_t)b * n;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            oskar_fftpack_cfftmf_f(1, n, n, 1, row, wsave,
+                    work + thread * work_size);
+            for (i = 0; i < 2 * n; ++i) row[i] *= scale_f;
+        }
+    }
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
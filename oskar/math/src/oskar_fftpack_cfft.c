@@ -167,6 +167,19 @@ void oskar_fftpack_cfft2i(const int l, const int m, double *wsave)
 }
 
 
+void oskar_fftpack_cfftmf(const int lot, const int jump, const int n,
+        const int inc, double *c, double *wsave, double *work)
+{
+    cfftmf(lot, jump, n, inc, c, wsave, work);
+}
+
+
+void oskar_fftpack_cfftmi(const int n, double *wsave)
+{
+    cfftmi(n, wsave);
+}
+
+
 void cfftmb(const int lot, const int jump, const int n, const int inc,
         double *c, double *wsave, double *work)
 {
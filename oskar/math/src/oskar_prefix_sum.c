@@ -28,6 +28,7 @@
 
 #include "math/oskar_prefix_sum.h"
 #include "math/oskar_prefix_sum_cuda.h"
+#include "utility/oskar_cl_utils.h"
 
 static size_t get_block_size(size_t num_elements)
 {
@@ -131,6 +132,51 @@ void oskar_prefix_sum(size_t num_elements, const oskar_Mem* in,
         oskar_mem_free(block_sums, status);
 #else
         *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_device_type dev_type;
+        cl_event event;
+        cl_int error, n, init, excl;
+        cl_kernel k;
+        cl_uint arg = 0;
+        size_t local_size;
+        k = oskar_cl_kernel("prefix_sum_int");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+        clGetDeviceInfo(oskar_cl_device_id(),
+                CL_DEVICE_TYPE, sizeof(cl_device_type), &dev_type, NULL);
+        local_size = (dev_type & CL_DEVICE_TYPE_GPU) ? 256 : 128;
+
+        /* Set kernel arguments. */
+        n = (cl_int) num_elements;
+        init = (cl_int) init_val;
+        excl = (cl_int) exclusive;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &n);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(in, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(out, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &init);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &excl);
+        error |= clSetKernelArg(k, arg++, local_size * sizeof(cl_int), 0);
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_elements > 0)
+        {
+            /* Launch a single work-group on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &local_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
 #endif
     }
     else
@@ -0,0 +1,45 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+// Launched as a single work-group: each work-item scans a contiguous chunk.
+// The input and output arrays may be the same.
+kernel void prefix_sum_int(const int num_elements,
+        global const int* in,
+        global int* out,
+        const int init_val,
+        const int exclusive,
+        local int* restrict scratch)
+{
+    const int block_dim = get_local_size(0);
+    const int thread_idx = get_local_id(0);
+    const int chunk = (num_elements + block_dim - 1) / block_dim;
+    const int start = min(thread_idx * chunk, num_elements);
+    const int end = min(start + chunk, num_elements);
+
+    // Sum this work-item's chunk.
+    int sum = 0;
+    for (int i = start; i < end; ++i) sum += in[i];
+    scratch[thread_idx] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // Inclusive scan of the chunk sums.
+    for (int s = 1; s < block_dim; s <<= 1) {
+        const int t = (thread_idx >= s) ? scratch[thread_idx - s] : 0;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        scratch[thread_idx] += t;
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    sum = (exclusive ? init_val : 0) + scratch[thread_idx] - sum;
+
+    // Write the scan of this chunk.
+    for (int i = start; i < end; ++i) {
+        const int x = in[i];
+        if (exclusive) {
+            out[i] = sum;
+            sum += x;
+        }
+        else {
+            sum += x;
+            out[i] = sum;
+        }
+    }
+}
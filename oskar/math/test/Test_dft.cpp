@@ -123,3 +123,113 @@ TEST(dft, c2r)
     oskar_mem_free(v, &status);
     oskar_mem_free(w, &status);
 }
+
+static void run_channels_test(int type, int use_3d, double tol)
+{
+    int c, status = 0, side = 16;
+    int num_baselines = 200, num_channels = 40;
+    int num_pixels = side * side, num_vis = num_channels * num_baselines;
+    double fov = 4.0 * M_PI / 180.0;
+    double k0 = 2.0 * M_PI * 100e6 / 299792458.;
+    double k_inc = 2.0 * M_PI * 0.5e6 / 299792458.;
+    oskar_Mem *l, *m, *n, *u, *v, *w, *amp, *wt, *uu, *vv, *ww, *t;
+    oskar_Mem *out_ref, *out;
+    l = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    m = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    n = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    u = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+    v = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+    w = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+    amp = oskar_mem_create(type | OSKAR_COMPLEX, OSKAR_CPU, num_vis, &status);
+    wt = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    uu = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    vv = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    ww = oskar_mem_create(type, OSKAR_CPU, num_vis, &status);
+    out_ref = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    out = oskar_mem_create(type, OSKAR_CPU, num_pixels, &status);
+    t = oskar_mem_create_alias(0, 0, 0, &status);
+
+    /* Generate input data. */
+    srand(1);
+    oskar_evaluate_image_lmn_grid(side, side, fov, fov, 0, l, m, n, &status);
+    oskar_mem_random_range(u, -1000., 1000., &status);
+    oskar_mem_random_range(v, -1000., 1000., &status);
+    oskar_mem_random_range(w, -200., 200., &status);
+    oskar_mem_random_range(amp, -1.0, 1.0, &status);
+    oskar_mem_random_range(wt, 0.5, 1.0, &status);
+
+    /* Scale the positions explicitly for each channel. */
+    for (c = 0; c < num_channels; ++c)
+    {
+        double scale = (k0 + c * k_inc) / k0;
+        oskar_mem_set_alias(t, uu, c * num_baselines, num_baselines, &status);
+        oskar_mem_copy_contents(t, u, 0, 0, num_baselines, &status);
+        oskar_mem_scale_real(t, scale, &status);
+        oskar_mem_set_alias(t, vv, c * num_baselines, num_baselines, &status);
+        oskar_mem_copy_contents(t, v, 0, 0, num_baselines, &status);
+        oskar_mem_scale_real(t, scale, &status);
+        oskar_mem_set_alias(t, ww, c * num_baselines, num_baselines, &status);
+        oskar_mem_copy_contents(t, w, 0, 0, num_baselines, &status);
+        oskar_mem_scale_real(t, scale, &status);
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    /* Compare with the DFT of all points. */
+    oskar_dft_c2r(num_vis, k0, uu, vv, ww, amp, wt, num_pixels,
+            l, m, use_3d ? n : 0, out_ref, &status);
+    oskar_dft_c2r_channels(num_channels, num_baselines, k0, k_inc,
+            u, v, w, amp, wt, num_pixels, l, m, use_3d ? n : 0,
+            out, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    double max_ref = 0.0, max_err = 0.0;
+    for (int i = 0; i < num_pixels; ++i)
+    {
+        double ref = oskar_mem_get_element(out_ref, i, &status);
+        double err = fabs(oskar_mem_get_element(out, i, &status) - ref);
+        if (fabs(ref) > max_ref) max_ref = fabs(ref);
+        if (err > max_err) max_err = err;
+    }
+    EXPECT_LT(max_err / max_ref, tol);
+
+    /* Only CPU memory is supported. */
+    status = 0;
+    oskar_Mem* out_dev = oskar_mem_create(type, OSKAR_GPU, 0, &status);
+    if (!status)
+    {
+        oskar_dft_c2r_channels(num_channels, num_baselines, k0, k_inc,
+                u, v, w, amp, wt, num_pixels, l, m, 0, out_dev, &status);
+        EXPECT_EQ((int) OSKAR_ERR_FUNCTION_NOT_AVAILABLE, status);
+    }
+    status = 0;
+
+    oskar_mem_free(out_dev, &status);
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_mem_free(u, &status);
+    oskar_mem_free(v, &status);
+    oskar_mem_free(w, &status);
+    oskar_mem_free(amp, &status);
+    oskar_mem_free(wt, &status);
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(out_ref, &status);
+    oskar_mem_free(out, &status);
+    oskar_mem_free(t, &status);
+}
+
+TEST(dft, c2r_channels_2d_single)
+{
+    run_channels_test(OSKAR_SINGLE, 0, 1e-4);
+}
+
+TEST(dft, c2r_channels_2d_double)
+{
+    run_channels_test(OSKAR_DOUBLE, 0, 1e-10);
+}
+
+TEST(dft, c2r_channels_3d_double)
+{
+    run_channels_test(OSKAR_DOUBLE, 1, 1e-10);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "math/oskar_fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// Compares an FFT against a direct evaluation of the 2D DFT.
+static void check_fft_2d(int prec, int size, int num_threads, double tol)
+{
+    int status = 0;
+    size_t num_cells = size * size;
+    oskar_Mem* data = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+            num_cells, &status);
+    oskar_mem_random_uniform(data, 1, 2, 3, 4, &status);
+    oskar_Mem* in = oskar_mem_convert_precision(data, OSKAR_DOUBLE, &status);
+    ASSERT_EQ(0, status);
+    const double* x = oskar_mem_double_const(in, &status);
+
+    // Transform the data.
+    oskar_FFT* fft = oskar_fft_create(prec, OSKAR_CPU, 2, size,
+            num_threads, &status);
+    oskar_fft_exec(fft, data, &status);
+    ASSERT_EQ(0, status);
+
+    // Check against the DFT.
+    double max_err = 0.0;
+    for (int ky = 0; ky < size; ++ky)
+    {
+        for (int kx = 0; kx < size; ++kx)
+        {
+            double re = 0.0, im = 0.0, out_re, out_im;
+            for (int y = 0; y < size; ++y)
+            {
+                for (int x_ = 0; x_ < size; ++x_)
+                {
+                    const double arg = -2.0 * M_PI *
+                            ((double)((kx * x_) % size) / size +
+                            (double)((ky * y) % size) / size);
+                    const double c = cos(arg), s = sin(arg);
+                    const double a = x[2 * (y * size + x_)];
+                    const double b = x[2 * (y * size + x_) + 1];
+                    re += a * c - b * s;
+                    im += a * s + b * c;
+                }
+            }
+            const size_t j = ky * size + kx;
+            if (prec == OSKAR_DOUBLE)
+            {
+                out_re = oskar_mem_double(data, &status)[2 * j];
+                out_im = oskar_mem_double(data, &status)[2 * j + 1];
+            }
+            else
+            {
+                out_re = oskar_mem_float(data, &status)[2 * j];
+                out_im = oskar_mem_float(data, &status)[2 * j + 1];
+            }
+            max_err = std::max(max_err, fabs(out_re - re));
+            max_err = std::max(max_err, fabs(out_im - im));
+        }
+    }
+    EXPECT_LT(max_err, tol * size * size);
+
+    // Clean up.
+    oskar_fft_free(fft);
+    oskar_mem_free(data, &status);
+    oskar_mem_free(in, &status);
+}
+
+TEST(fft, 2d_double)
+{
+    check_fft_2d(OSKAR_DOUBLE, 48, 1, 1e-12);
+    check_fft_2d(OSKAR_DOUBLE, 48, 4, 1e-12);
+    check_fft_2d(OSKAR_DOUBLE, 70, 3, 1e-12);
+}
+
+TEST(fft, 2d_single)
+{
+    check_fft_2d(OSKAR_SINGLE, 64, 4, 1e-5);
+}
+
+TEST(fft, 1d)
+{
+    int status = 0, size = 100;
+    oskar_Mem* data = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            size, &status);
+    double* x = oskar_mem_double(data, &status);
+    for (int i = 0; i < size; ++i)
+    {
+        x[2 * i] = cos(2.0 * M_PI * 3 * i / size);
+        x[2 * i + 1] = sin(2.0 * M_PI * 3 * i / size);
+    }
+
+    // A single complex exponential transforms to a single spike.
+    oskar_FFT* fft = oskar_fft_create(OSKAR_DOUBLE, OSKAR_CPU, 1, size,
+            1, &status);
+    oskar_fft_exec(fft, data, &status);
+    ASSERT_EQ(0, status);
+    for (int i = 0; i < size; ++i)
+    {
+        EXPECT_NEAR(i == 3 ? size : 0.0, x[2 * i], 1e-10);
+        EXPECT_NEAR(0.0, x[2 * i + 1], 1e-10);
+    }
+    oskar_fft_free(fft);
+    oskar_mem_free(data, &status);
+}
@@ -92,6 +92,7 @@ enum OSKAR_MEM_LOCATION
 #include <mem/oskar_mem_create_alias.h>
 #include <mem/oskar_mem_create_alias_from_raw.h>
 #include <mem/oskar_mem_create_copy.h>
+#include <mem/oskar_mem_create_slice.h>
 #include <mem/oskar_mem_data_type_string.h>
 #include <mem/oskar_mem_different.h>
 #include <mem/oskar_mem_element_size.h>
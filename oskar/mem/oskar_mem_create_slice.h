@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_MEM_CREATE_SLICE_H_
+#define OSKAR_MEM_CREATE_SLICE_H_
+
+/**
+ * @file oskar_mem_create_slice.h
+ */
+
+#include <oskar_global.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Creates a handle to part of an existing memory block.
+ *
+ * @details
+ * This function returns an alias of part of an existing memory block,
+ * as oskar_mem_create_alias() does, unless the block is in OpenCL memory
+ * and the offset is not aligned as the device requires for sub-buffers.
+ * In that case, the part is copied into a new memory block instead.
+ *
+ * The handle must be released using oskar_mem_free_slice(), which
+ * copies the contents back to the source if required.
+ *
+ * @param[in] src           Handle to source memory block.
+ * @param[in] offset        Offset number of elements from start of source memory block.
+ * @param[in] num_elements  Number of elements in the returned array.
+ * @param[in,out]  status   Status return code.
+ *
+ * @return A handle to the slice.
+ */
+OSKAR_EXPORT
+oskar_Mem* oskar_mem_create_slice(const oskar_Mem* src, size_t offset,
+        size_t num_elements, int* status);
+
+/**
+ * @brief
+ * Releases a handle created by oskar_mem_create_slice().
+ *
+ * @details
+ * If \p dst is not NULL and the slice holds a copy, the contents of the
+ * slice are first copied back to \p dst at the given offset.
+ * Set \p dst to NULL if the slice was only read.
+ *
+ * @param[in] slice         Handle returned by oskar_mem_create_slice().
+ * @param[in] dst           Handle to source memory block, or NULL.
+ * @param[in] offset        Offset number of elements used to create the slice.
+ * @param[in,out]  status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_mem_free_slice(oskar_Mem* slice, oskar_Mem* dst, size_t offset,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_MEM_CREATE_SLICE_H_ */
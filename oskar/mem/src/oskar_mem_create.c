@@ -62,6 +62,9 @@ oskar_Mem* oskar_mem_create(int type, int location, size_t num_elements,
     mem->num_elements = 0;
     mem->owner = 1;
     mem->data = NULL;
+#ifdef OSKAR_HAVE_OPENCL
+    mem->buffer = 0;
+#endif
 
     /* Check if allocation should happen or not. */
     if (!status || *status || num_elements == 0)
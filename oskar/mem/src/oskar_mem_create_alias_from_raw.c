@@ -55,6 +55,9 @@ oskar_Mem* oskar_mem_create_alias_from_raw(void* ptr, int type, int location,
     mem->num_elements = num_elements;
     mem->owner = 0; /* Structure does not own the memory. */
     mem->data = ptr;
+#ifdef OSKAR_HAVE_OPENCL
+    mem->buffer = 0;
+#endif
 
     /* Return a handle the structure .*/
     return mem;
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/oskar_mem.h"
+#include "mem/private_mem.h"
+#include "utility/oskar_cl_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+oskar_Mem* oskar_mem_create_slice(const oskar_Mem* src, size_t offset,
+        size_t num_elements, int* status)
+{
+#ifdef OSKAR_HAVE_OPENCL
+    if (src->location & OSKAR_CL)
+    {
+        cl_uint align_bits = 0;
+        const size_t offset_bytes =
+                offset * oskar_mem_element_size(src->type);
+        clGetDeviceInfo(oskar_cl_device_id(), CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+                sizeof(cl_uint), &align_bits, NULL);
+        if (align_bits < 8 || offset_bytes % (align_bits / 8) != 0)
+        {
+            oskar_Mem* slice = oskar_mem_create(src->type, src->location,
+                    num_elements, status);
+            oskar_mem_copy_contents(slice, src, 0, offset, num_elements,
+                    status);
+            return slice;
+        }
+    }
+#endif
+    return oskar_mem_create_alias(src, offset, num_elements, status);
+}
+
+void oskar_mem_free_slice(oskar_Mem* slice, oskar_Mem* dst, size_t offset,
+        int* status)
+{
+    if (!slice) return;
+    if (dst && slice->owner)
+        oskar_mem_copy_contents(dst, slice, offset, 0, slice->num_elements,
+                status);
+    oskar_mem_free(slice, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -32,11 +32,24 @@
 
 #include "mem/oskar_mem.h"
 #include "mem/private_mem.h"
+#include "utility/oskar_cl_utils.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifdef OSKAR_HAVE_OPENCL
+static void read_cl(const oskar_Mem* mem, size_t index, size_t size,
+        void* val, int* status)
+{
+    cl_int error;
+    error = clEnqueueReadBuffer(oskar_cl_command_queue(), mem->buffer,
+            CL_TRUE, index * size, size, val, 0, NULL, NULL);
+    if (error != CL_SUCCESS)
+        *status = OSKAR_ERR_MEMORY_COPY_FAILURE;
+}
+#endif
+
 double oskar_mem_get_element(const oskar_Mem* mem, size_t index, int* status)
 {
     int precision, location;
@@ -85,6 +98,30 @@ double oskar_mem_get_element(const oskar_Mem* mem, size_t index, int* status)
         }
 #else
         *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        switch (precision)
+        {
+        case OSKAR_DOUBLE:
+        {
+            double val = 0.0;
+            read_cl(mem, index, sizeof(double), &val, status);
+            return val;
+        }
+        case OSKAR_SINGLE:
+        {
+            float val = 0.0f;
+            read_cl(mem, index, sizeof(float), &val, status);
+            return val;
+        }
+        default:
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
 #endif
     }
     else
@@ -153,6 +190,26 @@ double2 oskar_mem_get_element_complex(const oskar_Mem* mem, size_t index,
             *status = OSKAR_ERR_BAD_DATA_TYPE;
 #else
         *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        if (type == OSKAR_DOUBLE_COMPLEX)
+        {
+            read_cl(mem, index, sizeof(double2), &val, status);
+        }
+        else if (type == OSKAR_SINGLE_COMPLEX)
+        {
+            float2 temp;
+            read_cl(mem, index, sizeof(float2), &temp, status);
+            val.x = (double) temp.x;
+            val.y = (double) temp.y;
+        }
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
 #endif
     }
     else
@@ -241,6 +298,32 @@ double4c oskar_mem_get_element_matrix(const oskar_Mem* mem, size_t index,
             *status = OSKAR_ERR_BAD_DATA_TYPE;
 #else
         *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        if (type == OSKAR_DOUBLE_COMPLEX_MATRIX)
+        {
+            read_cl(mem, index, sizeof(double4c), &val, status);
+        }
+        else if (type == OSKAR_SINGLE_COMPLEX_MATRIX)
+        {
+            float4c temp;
+            read_cl(mem, index, sizeof(float4c), &temp, status);
+            val.a.x = (double) temp.a.x;
+            val.a.y = (double) temp.a.y;
+            val.b.x = (double) temp.b.x;
+            val.b.y = (double) temp.b.y;
+            val.c.x = (double) temp.c.x;
+            val.c.y = (double) temp.c.y;
+            val.d.x = (double) temp.d.x;
+            val.d.y = (double) temp.d.y;
+        }
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
 #endif
     }
     else
@@ -143,13 +143,16 @@ void oskar_mem_realloc(oskar_Mem* mem, size_t num_elements, int* status)
         /* Allocate and initialise a new block of memory. */
         cl_int error = 0;
         size_t copy_size;
-        cl_mem mem_new;
-        mem_new = clCreateBuffer(oskar_cl_context(),
-                CL_MEM_READ_WRITE, new_size, NULL, &error);
-        if (error != CL_SUCCESS)
+        cl_mem mem_new = 0;
+        if (new_size > 0)
         {
-            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
-            return;
+            mem_new = clCreateBuffer(oskar_cl_context(),
+                    CL_MEM_READ_WRITE, new_size, NULL, &error);
+            if (error != CL_SUCCESS)
+            {
+                *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+                return;
+            }
         }
 
         /* Copy contents of old block to new block. */
@@ -166,7 +169,8 @@ void oskar_mem_realloc(oskar_Mem* mem, size_t num_elements, int* status)
         }
 
         /* Free the old buffer. */
-        clReleaseMemObject(mem->buffer);
+        if (mem->buffer)
+            clReleaseMemObject(mem->buffer);
 
         /* Set the new meta-data. */
         mem->buffer = mem_new;
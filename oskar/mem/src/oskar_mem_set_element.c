@@ -32,6 +32,7 @@
 
 #include "mem/oskar_mem.h"
 #include "mem/private_mem.h"
+#include "utility/oskar_cl_utils.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -97,6 +98,32 @@ void oskar_mem_set_element_real(oskar_Mem* mem, size_t index,
             *status = OSKAR_ERR_BAD_DATA_TYPE;
 #else
         *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_int error = CL_SUCCESS;
+        if (precision == OSKAR_DOUBLE)
+        {
+            error = clEnqueueWriteBuffer(oskar_cl_command_queue(),
+                    mem->buffer, CL_TRUE, index * sizeof(double),
+                    sizeof(double), &val, 0, NULL, NULL);
+        }
+        else if (precision == OSKAR_SINGLE)
+        {
+            float temp;
+            temp = (float) val;
+            error = clEnqueueWriteBuffer(oskar_cl_command_queue(),
+                    mem->buffer, CL_TRUE, index * sizeof(float),
+                    sizeof(float), &temp, 0, NULL, NULL);
+        }
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+        if (error != CL_SUCCESS)
+            *status = OSKAR_ERR_MEMORY_COPY_FAILURE;
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
 #endif
     }
     else
@@ -33,7 +33,7 @@
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
-    oskar_cl_init("GPU", "AMD|NVIDIA");
+    oskar_cl_init(NULL, NULL);
     int val = RUN_ALL_TESTS();
     oskar_device_reset();
     oskar_cl_free();
@@ -230,6 +230,25 @@ void oskar_ms_set_station_coords_f(oskar_MeasurementSet* p,
 OSKAR_MS_EXPORT
 void oskar_ms_set_time_range(oskar_MeasurementSet* p);
 
+/**
+ * @brief
+ * Returns a staging buffer owned by the Measurement Set handle.
+ *
+ * @details
+ * Returns a pointer to a host buffer of at least the given size, which
+ * callers can use to assemble data before writing it, to avoid allocating
+ * memory for every block of data.
+ *
+ * The buffer is resized if necessary, so its contents are not preserved
+ * between calls. It is freed when the Measurement Set is closed.
+ *
+ * @param[in] size_bytes Minimum size of the buffer, in bytes.
+ *
+ * @return Pointer to the buffer, or NULL if it could not be allocated.
+ */
+OSKAR_MS_EXPORT
+void* oskar_ms_stage_buffer(oskar_MeasurementSet* p, size_t size_bytes);
+
 /**
  * @brief
  * Returns the time increment in the Measurement Set.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -107,6 +107,44 @@ void oskar_ms_write_coords_f(oskar_MeasurementSet* p,
         const float* uu, const float* vv, const float* ww,
         double exposure_sec, double interval_sec, double time_stamp);
 
+/**
+ * @details
+ * Writes coordinate data for a list of independent rows to the main table.
+ *
+ * @details
+ * This function writes the supplied list of baseline coordinates and
+ * row metadata to the main table of the Measurement Set,
+ * extending it if necessary.
+ *
+ * Unlike oskar_ms_write_coords_d(), the antenna indices, time stamp,
+ * interval and weight are given separately for each row, so the rows
+ * need not form a complete set of baselines at a single time.
+ * This is used to write data that have been averaged by a different
+ * amount on each baseline.
+ *
+ * The time stamps are given in units of (MJD) * 86400, i.e. seconds since
+ * Julian date 2400000.5. The sigma column is set to 1 / sqrt(weight).
+ *
+ * @param[in] start_row     The start row index to write (zero-based).
+ * @param[in] num_rows      Number of rows to write to the main table.
+ * @param[in] antenna1      First antenna index of each row.
+ * @param[in] antenna2      Second antenna index of each row.
+ * @param[in] uu            Baseline u-coordinates, in metres.
+ * @param[in] vv            Baseline v-coordinates, in metres.
+ * @param[in] ww            Baseline w-coordinates, in metres.
+ * @param[in] exposure_sec  The exposure length of each row, in seconds.
+ * @param[in] interval_sec  The interval length of each row, in seconds.
+ * @param[in] time_stamp    Centre time stamp of each row.
+ * @param[in] weight        The weight of each row.
+ */
+OSKAR_MS_EXPORT
+void oskar_ms_write_coords_rows_d(oskar_MeasurementSet* p,
+        unsigned int start_row, unsigned int num_rows,
+        const int* antenna1, const int* antenna2,
+        const double* uu, const double* vv, const double* ww,
+        const double* exposure_sec, const double* interval_sec,
+        const double* time_stamp, const double* weight);
+
 /**
  * @details
  * Writes visibility data to the main table.
@@ -173,6 +211,34 @@ void oskar_ms_write_vis_f(oskar_MeasurementSet* p,
         unsigned int num_channels, unsigned int num_baselines,
         const float* vis);
 
+/**
+ * @details
+ * Writes visibility data for a range of rows to the main table.
+ *
+ * @details
+ * This function writes the given block of visibility data to the
+ * data column of the Measurement Set, extending it if necessary.
+ *
+ * Unlike oskar_ms_write_vis_f(), the data must already be in the
+ * order used by the Measurement Set, so it is written without being copied.
+ * This allows the rows for several time steps to be written in one call.
+ *
+ * The dimensionality of the complex \p vis data block is:
+ * (num_rows * num_channels * num_pols),
+ * with num_pols the fastest varying dimension, then num_channels,
+ * and num_rows the slowest.
+ *
+ * @param[in] start_row     The start row index to write (zero-based).
+ * @param[in] start_channel The start channel index of the visibility block.
+ * @param[in] num_channels  The number of channels in the visibility block.
+ * @param[in] num_rows      The number of rows in the visibility block.
+ * @param[in] vis           Pointer to complex visibility block.
+ */
+OSKAR_MS_EXPORT
+void oskar_ms_write_vis_rows_f(oskar_MeasurementSet* p,
+        unsigned int start_row, unsigned int start_channel,
+        unsigned int num_channels, unsigned int num_rows, const float* vis);
+
 #ifdef __cplusplus
 }
 #endif
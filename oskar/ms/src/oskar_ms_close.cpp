@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -44,6 +44,8 @@ void oskar_ms_close(oskar_MeasurementSet* p)
         delete p->ms;
     free(p->a1);
     free(p->a2);
+    free(p->vis_buffer);
+    free(p->stage_buffer);
     free(p->app_name);
     free(p);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -32,6 +32,9 @@
 #include <tables/Tables.h>
 #include <casa/Arrays/Vector.h>
 
+#include <cmath>
+#include <cstdlib>
+
 using namespace casa;
 
 static void oskar_ms_create_baseline_indices(oskar_MeasurementSet* p,
@@ -159,6 +162,61 @@ void oskar_ms_write_coords_f(oskar_MeasurementSet* p,
             exposure_sec, interval_sec, time_stamp);
 }
 
+void oskar_ms_write_coords_rows_d(oskar_MeasurementSet* p,
+        unsigned int start_row, unsigned int num_rows,
+        const int* antenna1, const int* antenna2,
+        const double* uu, const double* vv, const double* ww,
+        const double* exposure_sec, const double* interval_sec,
+        const double* time_stamp, const double* weight)
+{
+    MSMainColumns* msmc = p->msmc;
+    if (!msmc) return;
+
+    // Allocate storage for a (u,v,w) coordinate and a visibility weight.
+    Vector<Double> uvw(3);
+    Vector<Float> row_weight(p->num_pols), row_sigma(p->num_pols);
+
+    // Get references to columns.
+    ArrayColumn<Double>& col_uvw = msmc->uvw();
+    ScalarColumn<Int>& col_antenna1 = msmc->antenna1();
+    ScalarColumn<Int>& col_antenna2 = msmc->antenna2();
+    ArrayColumn<Float>& col_weight = msmc->weight();
+    ArrayColumn<Float>& col_sigma = msmc->sigma();
+    ScalarColumn<Double>& col_exposure = msmc->exposure();
+    ScalarColumn<Double>& col_interval = msmc->interval();
+    ScalarColumn<Double>& col_time = msmc->time();
+    ScalarColumn<Double>& col_timeCentroid = msmc->timeCentroid();
+
+    // Add new rows if required.
+    oskar_ms_ensure_num_rows(p, start_row + num_rows);
+
+    // Loop over rows to add.
+    for (unsigned int r = 0; r < num_rows; ++r)
+    {
+        // Write the data to the Measurement Set.
+        unsigned int row = r + start_row;
+        uvw(0) = uu[r]; uvw(1) = vv[r]; uvw(2) = ww[r];
+        row_weight = (Float) weight[r];
+        row_sigma = (Float) (1.0 / sqrt(weight[r]));
+        col_uvw.put(row, uvw);
+        col_antenna1.put(row, antenna1[r]);
+        col_antenna2.put(row, antenna2[r]);
+        col_weight.put(row, row_weight);
+        col_sigma.put(row, row_sigma);
+        col_exposure.put(row, exposure_sec[r]);
+        col_interval.put(row, interval_sec[r]);
+        col_time.put(row, time_stamp[r]);
+        col_timeCentroid.put(row, time_stamp[r]);
+
+        // Update time range if required.
+        if (time_stamp[r] - interval_sec[r]/2.0 < p->start_time)
+            p->start_time = time_stamp[r] - interval_sec[r]/2.0;
+        if (time_stamp[r] + interval_sec[r]/2.0 > p->end_time)
+            p->end_time = time_stamp[r] + interval_sec[r]/2.0;
+    }
+    p->data_written = 1;
+}
+
 template <typename T>
 void oskar_ms_write_vis(oskar_MeasurementSet* p,
         unsigned int start_row, unsigned int start_channel,
@@ -167,10 +225,19 @@ void oskar_ms_write_vis(oskar_MeasurementSet* p,
     MSMainColumns* msmc = p->msmc;
     if (!msmc) return;
 
-    // Allocate storage for the block of visibility data.
+    // Get storage for the block of visibility data.
     unsigned int num_pols = p->num_pols;
+    size_t size_bytes = num_pols * num_channels * num_baselines *
+            sizeof(Complex);
+    if (size_bytes > p->vis_buffer_size)
+    {
+        void* t = realloc(p->vis_buffer, size_bytes);
+        if (!t) return;
+        p->vis_buffer = t;
+        p->vis_buffer_size = size_bytes;
+    }
     IPosition shape(3, num_pols, num_channels, num_baselines);
-    Array<Complex> vis_data(shape);
+    Array<Complex> vis_data(shape, (Complex*) p->vis_buffer, SHARE);
 
     // Copy visibility data into the array,
     // swapping baseline and channel dimensions.
@@ -223,3 +290,32 @@ void oskar_ms_write_vis_f(oskar_MeasurementSet* p,
     oskar_ms_write_vis(p, start_row, start_channel,
             num_channels, num_baselines, vis);
 }
+
+void oskar_ms_write_vis_rows_f(oskar_MeasurementSet* p,
+        unsigned int start_row, unsigned int start_channel,
+        unsigned int num_channels, unsigned int num_rows, const float* vis)
+{
+    MSMainColumns* msmc = p->msmc;
+    if (!msmc) return;
+
+    // Wrap the supplied data, which is already in the order of the column.
+    unsigned int num_pols = p->num_pols;
+    IPosition shape(3, num_pols, num_channels, num_rows);
+    const Array<Complex> vis_data(shape, (Complex*) vis, SHARE);
+
+    // Add new rows if required.
+    oskar_ms_ensure_num_rows(p, start_row + num_rows);
+
+    // Create the slicers for the column.
+    IPosition start1(1, start_row);
+    IPosition length1(1, num_rows);
+    Slicer row_range(start1, length1);
+    IPosition start2(2, 0, start_channel);
+    IPosition length2(2, num_pols, num_channels);
+    Slicer array_section(start2, length2);
+
+    // Write visibilities to DATA column.
+    ArrayColumn<Complex>& col_data = msmc->data();
+    col_data.putColumnRange(row_range, array_section, vis_data);
+    p->data_written = 1;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2014, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -49,9 +49,17 @@ extern "C" {
  * Copies sources into another sky model that are above the horizon of
  * stations.
  *
+ * If oskar_telescope_analyse() has been called, stations are divided into
+ * a bounded number of groups with similar horizons
+ * (see oskar_telescope_num_horizon_groups()), so that most sources need
+ * only be tested against one horizon per group. Otherwise, every source is
+ * tested against the horizon of every station. The result is the same
+ * in both cases.
+ *
  * @param[out] out          The output sky model.
  * @param[in]  in           The input sky model.
  * @param[in]  telescope    The telescope model.
+ * @param[in]  gast         The Greenwich apparent sidereal time, in radians.
  * @param[in]  work         Work arrays.
  * @param[in,out]  status   Status return code.
  */
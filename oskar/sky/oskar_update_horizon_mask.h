@@ -64,6 +64,47 @@ void oskar_update_horizon_mask(int num_sources, const oskar_Mem* l,
         const double dec0_rad, const double lat_rad, oskar_Mem* mask,
         int* status);
 
+/**
+ * @brief
+ * Ensures source mask value is 1 if the source is visible from any station
+ * in a set of station groups.
+ *
+ * @details
+ * This function sets the horizon mask to 1 if a source is visible from
+ * at least one of the stations supplied.
+ *
+ * Stations are supplied in groups with similar horizons. The first station
+ * in each group is used to decide whether a source is above or below the
+ * horizon of all stations in the group, using the supplied margin
+ * (the sine of the largest angle between the local zenith of the first
+ * station and that of any other station in the group, plus a small tolerance).
+ * Only sources within the margin are tested against each station in the
+ * group, so the result is identical to calling oskar_update_horizon_mask()
+ * for every station.
+ *
+ * The zenith direction of each station is given as the (l, m, n) direction
+ * cosines of its local zenith relative to the phase centre, stored
+ * consecutively in \p station_dir. These must be in the same precision
+ * and location as the source direction cosines.
+ *
+ * @param[in] num_sources   The number of source positions.
+ * @param[in] l             Source l-direction cosines relative to phase centre.
+ * @param[in] m             Source m-direction cosines relative to phase centre.
+ * @param[in] n             Source n-direction cosines relative to phase centre.
+ * @param[in] num_groups    The number of station groups.
+ * @param[in] group_start   Integer index of first station in each group,
+ *                          with a final entry holding the number of stations.
+ * @param[in] group_margin  Horizon margin for each group.
+ * @param[in] station_dir   Zenith direction cosines of each station.
+ * @param[in,out] mask      The input and output mask vector.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_update_horizon_mask_grouped(int num_sources, const oskar_Mem* l,
+        const oskar_Mem* m, const oskar_Mem* n, int num_groups,
+        const oskar_Mem* group_start, const oskar_Mem* group_margin,
+        const oskar_Mem* station_dir, oskar_Mem* mask, int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -85,6 +85,56 @@ void oskar_update_horizon_mask_cuda_d(int num_sources, const double* d_l,
         const double* d_m, const double* d_n, const double l_mul,
         const double m_mul, const double n_mul, int* d_mask);
 
+/**
+ * @brief
+ * Ensures source mask value is 1 if the source is visible from any station
+ * in a set of station groups (single precision).
+ *
+ * @details
+ * This kernel updates the horizon mask to determine whether a source is
+ * visible from any station, using groups of stations with similar horizons.
+ *
+ * @param[in] num_sources     The number of source positions.
+ * @param[in] d_l             Source l-direction cosines relative to phase centre.
+ * @param[in] d_m             Source m-direction cosines relative to phase centre.
+ * @param[in] d_n             Source n-direction cosines relative to phase centre.
+ * @param[in] num_groups      The number of station groups.
+ * @param[in] d_group_start   Index of first station in each group.
+ * @param[in] d_group_margin  Horizon margin for each group.
+ * @param[in] d_station_dir   Zenith direction cosines of each station.
+ * @param[in,out] d_mask      The input and output mask vector.
+ */
+OSKAR_EXPORT
+void oskar_update_horizon_mask_grouped_cuda_f(int num_sources,
+        const float* d_l, const float* d_m, const float* d_n,
+        int num_groups, const int* d_group_start, const float* d_group_margin,
+        const float* d_station_dir, int* d_mask);
+
+/**
+ * @brief
+ * Ensures source mask value is 1 if the source is visible from any station
+ * in a set of station groups (double precision).
+ *
+ * @details
+ * This kernel updates the horizon mask to determine whether a source is
+ * visible from any station, using groups of stations with similar horizons.
+ *
+ * @param[in] num_sources     The number of source positions.
+ * @param[in] d_l             Source l-direction cosines relative to phase centre.
+ * @param[in] d_m             Source m-direction cosines relative to phase centre.
+ * @param[in] d_n             Source n-direction cosines relative to phase centre.
+ * @param[in] num_groups      The number of station groups.
+ * @param[in] d_group_start   Index of first station in each group.
+ * @param[in] d_group_margin  Horizon margin for each group.
+ * @param[in] d_station_dir   Zenith direction cosines of each station.
+ * @param[in,out] d_mask      The input and output mask vector.
+ */
+OSKAR_EXPORT
+void oskar_update_horizon_mask_grouped_cuda_d(int num_sources,
+        const double* d_l, const double* d_m, const double* d_n,
+        int num_groups, const int* d_group_start, const double* d_group_margin,
+        const double* d_station_dir, int* d_mask);
+
 #ifdef __cplusplus
 }
 #endif
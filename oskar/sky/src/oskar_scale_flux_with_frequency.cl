@@ -0,0 +1,37 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void scale_flux_with_frequency_REAL(const int num_sources,
+        const REAL frequency,
+        global REAL* restrict I,
+        global REAL* restrict Q,
+        global REAL* restrict U,
+        global REAL* restrict V,
+        global REAL* restrict ref_freq,
+        global const REAL* restrict sp_index,
+        global const REAL* restrict rm)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+
+    /* Get reference frequency. */
+    const REAL freq0 = ref_freq[i];
+    if (freq0 == (REAL) 0.) return;
+
+    /* Compute (lambda^2 - lambda0^2) as a difference of two squares. */
+    const REAL c0 = (REAL) 299792458.;
+    const REAL lambda = c0 / frequency, lambda0 = c0 / freq0;
+    const REAL delta_lambda_squared = (lambda - lambda0) * (lambda + lambda0);
+
+    /* Compute sin(2 beta) and cos(2 beta). */
+    REAL sin_b, cos_b;
+    sin_b = sincos((REAL) 2. * rm[i] * delta_lambda_squared, &cos_b);
+
+    /* Set new values and update reference frequency. */
+    const REAL scale = pow(frequency / freq0, sp_index[i]);
+    const REAL Q_ = scale * Q[i], U_ = scale * U[i];
+    I[i] *= scale;
+    V[i] *= scale;
+    Q[i] = Q_ * cos_b - U_ * sin_b;
+    U[i] = Q_ * sin_b + U_ * cos_b;
+    ref_freq[i] = frequency;
+}
@@ -30,6 +30,7 @@
 #include "sky/oskar_sky.h"
 #include "sky/oskar_sky_copy_source_data.h"
 #include "sky/oskar_sky_copy_source_data_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
 #define CF(m) oskar_mem_float(m, status)
@@ -66,6 +67,101 @@ extern "C" {
                 num_out++; \
             }
 
+#ifdef OSKAR_HAVE_OPENCL
+static void copy_source_data_cl(int num_in, int* num_out,
+        const oskar_Sky* in, const oskar_Mem* horizon_mask,
+        const oskar_Mem* indices, oskar_Sky* out, int* status)
+{
+    cl_event event;
+    cl_kernel k;
+    cl_int error, num, last[2];
+    cl_uint arg = 0;
+    int i;
+    const size_t local_size = 128;
+    const size_t global_size = ((num_in + local_size - 1) /
+            local_size) * local_size;
+    const oskar_Mem* src[] = {
+            oskar_sky_ra_rad_const(in), oskar_sky_dec_rad_const(in),
+            oskar_sky_I_const(in), oskar_sky_Q_const(in),
+            oskar_sky_U_const(in), oskar_sky_V_const(in),
+            oskar_sky_reference_freq_hz_const(in),
+            oskar_sky_spectral_index_const(in),
+            oskar_sky_rotation_measure_rad_const(in),
+            oskar_sky_l_const(in), oskar_sky_m_const(in),
+            oskar_sky_n_const(in), oskar_sky_gaussian_a_const(in),
+            oskar_sky_gaussian_b_const(in), oskar_sky_gaussian_c_const(in),
+            oskar_sky_fwhm_major_rad_const(in),
+            oskar_sky_fwhm_minor_rad_const(in),
+            oskar_sky_position_angle_rad_const(in)};
+    oskar_Mem* dst[] = {
+            oskar_sky_ra_rad(out), oskar_sky_dec_rad(out),
+            oskar_sky_I(out), oskar_sky_Q(out),
+            oskar_sky_U(out), oskar_sky_V(out),
+            oskar_sky_reference_freq_hz(out),
+            oskar_sky_spectral_index(out),
+            oskar_sky_rotation_measure_rad(out),
+            oskar_sky_l(out), oskar_sky_m(out),
+            oskar_sky_n(out), oskar_sky_gaussian_a(out),
+            oskar_sky_gaussian_b(out), oskar_sky_gaussian_c(out),
+            oskar_sky_fwhm_major_rad(out),
+            oskar_sky_fwhm_minor_rad(out),
+            oskar_sky_position_angle_rad(out)};
+    *num_out = 0;
+    if (num_in == 0) return;
+    k = oskar_sky_precision(out) == OSKAR_DOUBLE ?
+            oskar_cl_kernel("sky_copy_source_data_double") :
+            oskar_cl_kernel("sky_copy_source_data_float");
+    if (!k)
+    {
+        *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+        return;
+    }
+
+    /* Set kernel arguments. */
+    num = (cl_int) num_in;
+    error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+    error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+            oskar_mem_cl_buffer_const(horizon_mask, status));
+    error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+            oskar_mem_cl_buffer_const(indices, status));
+    for (i = 0; i < (int)(sizeof(src) / sizeof(src[0])); ++i)
+    {
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(src[i], status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(dst[i], status));
+    }
+    if (!*status && error != CL_SUCCESS)
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+    if (*status) return;
+
+    /* Launch kernel on current command queue. */
+    error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1, NULL,
+            &global_size, &local_size, 0, NULL, &event);
+    if (error != CL_SUCCESS)
+    {
+        *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        return;
+    }
+
+    /* The number of sources copied follows from the last index and mask. */
+    error = clEnqueueReadBuffer(oskar_cl_command_queue(),
+            *oskar_mem_cl_buffer_const(horizon_mask, status), CL_TRUE,
+            (num_in - 1) * sizeof(cl_int), sizeof(cl_int), &last[0],
+            0, NULL, NULL);
+    error |= clEnqueueReadBuffer(oskar_cl_command_queue(),
+            *oskar_mem_cl_buffer_const(indices, status), CL_TRUE,
+            (num_in - 1) * sizeof(cl_int), sizeof(cl_int), &last[1],
+            0, NULL, NULL);
+    if (error != CL_SUCCESS)
+    {
+        *status = OSKAR_ERR_MEMORY_COPY_FAILURE;
+        return;
+    }
+    *num_out = (int) (last[0] ? last[1] + 1 : last[1]);
+}
+#endif
+
 void oskar_sky_copy_source_data(const oskar_Sky* in,
         const oskar_Mem* horizon_mask, const oskar_Mem* indices,
         oskar_Sky* out, int* status)
@@ -139,6 +235,15 @@ void oskar_sky_copy_source_data(const oskar_Sky* in,
             oskar_device_check_error(status);
 #else
             *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+        }
+        else if (oskar_sky_mem_location(in) & OSKAR_CL)
+        {
+#ifdef OSKAR_HAVE_OPENCL
+            copy_source_data_cl(num_in, &num_out, in, horizon_mask,
+                    indices, out, status);
+#else
+            *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
 #endif
         }
         else if (oskar_sky_mem_location(in) == OSKAR_CPU)
@@ -211,6 +316,15 @@ void oskar_sky_copy_source_data(const oskar_Sky* in,
             oskar_device_check_error(status);
 #else
             *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+        }
+        else if (oskar_sky_mem_location(in) & OSKAR_CL)
+        {
+#ifdef OSKAR_HAVE_OPENCL
+            copy_source_data_cl(num_in, &num_out, in, horizon_mask,
+                    indices, out, status);
+#else
+            *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
 #endif
         }
         else if (oskar_sky_mem_location(in) == OSKAR_CPU)
@@ -0,0 +1,47 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+#define SKY_COPY_REAL(A) o_##A[j] = A[i];
+
+kernel void sky_copy_source_data_REAL(const int num,
+        global const int* restrict mask, global const int* restrict indices,
+        global const REAL* restrict ra, global REAL* restrict o_ra,
+        global const REAL* restrict dec, global REAL* restrict o_dec,
+        global const REAL* restrict I, global REAL* restrict o_I,
+        global const REAL* restrict Q, global REAL* restrict o_Q,
+        global const REAL* restrict U, global REAL* restrict o_U,
+        global const REAL* restrict V, global REAL* restrict o_V,
+        global const REAL* restrict ref, global REAL* restrict o_ref,
+        global const REAL* restrict sp, global REAL* restrict o_sp,
+        global const REAL* restrict rm, global REAL* restrict o_rm,
+        global const REAL* restrict l, global REAL* restrict o_l,
+        global const REAL* restrict m, global REAL* restrict o_m,
+        global const REAL* restrict n, global REAL* restrict o_n,
+        global const REAL* restrict a, global REAL* restrict o_a,
+        global const REAL* restrict b, global REAL* restrict o_b,
+        global const REAL* restrict c, global REAL* restrict o_c,
+        global const REAL* restrict major, global REAL* restrict o_major,
+        global const REAL* restrict minor, global REAL* restrict o_minor,
+        global const REAL* restrict pa, global REAL* restrict o_pa)
+{
+    const int i = get_global_id(0);
+    if (i >= num || !mask[i]) return;
+    const int j = indices[i];
+    SKY_COPY_REAL(ra)
+    SKY_COPY_REAL(dec)
+    SKY_COPY_REAL(I)
+    SKY_COPY_REAL(Q)
+    SKY_COPY_REAL(U)
+    SKY_COPY_REAL(V)
+    SKY_COPY_REAL(ref)
+    SKY_COPY_REAL(sp)
+    SKY_COPY_REAL(rm)
+    SKY_COPY_REAL(l)
+    SKY_COPY_REAL(m)
+    SKY_COPY_REAL(n)
+    SKY_COPY_REAL(a)
+    SKY_COPY_REAL(b)
+    SKY_COPY_REAL(c)
+    SKY_COPY_REAL(major)
+    SKY_COPY_REAL(minor)
+    SKY_COPY_REAL(pa)
+}
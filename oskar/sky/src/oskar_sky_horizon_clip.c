@@ -30,6 +30,7 @@
 #include "sky/oskar_sky.h"
 #include "sky/oskar_sky_copy_source_data.h"
 #include "sky/oskar_update_horizon_mask.h"
+#include "math/oskar_cmath.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,9 +42,10 @@ void oskar_sky_horizon_clip(oskar_Sky* out, const oskar_Sky* in,
         const oskar_Telescope* telescope, double gast,
         oskar_StationWork* work, int* status)
 {
-    int i, num_stations, location, num_in;
-    oskar_Mem *horizon_mask, *source_indices;
+    int i, j, num_stations, location, type, num_in;
     double ra0, dec0;
+    oskar_Mem *horizon_mask, *source_indices;
+    const oskar_Mem* group_station;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -71,6 +73,7 @@ void oskar_sky_horizon_clip(oskar_Sky* out, const oskar_Sky* in,
 
     /* Get remaining properties of input sky model. */
     num_in = oskar_sky_num_sources(in);
+    type = oskar_sky_precision(in);
     ra0 = oskar_sky_reference_ra_rad(in);
     dec0 = oskar_sky_reference_dec_rad(in);
 
@@ -87,13 +90,78 @@ void oskar_sky_horizon_clip(oskar_Sky* out, const oskar_Sky* in,
     /* Create the horizon mask. */
     oskar_mem_clear_contents(horizon_mask, status);
     num_stations = oskar_telescope_num_stations(telescope);
-    for (i = 0; i < num_stations; ++i)
+    group_station = oskar_telescope_horizon_group_station_const(telescope);
+    if ((int)oskar_mem_length(group_station) != num_stations ||
+            oskar_telescope_precision(telescope) != type)
+    {
+        /* Stations have not been grouped: test each one in turn. */
+        for (i = 0; i < num_stations; ++i)
+        {
+            const oskar_Station* s = oskar_telescope_station_const(telescope,
+                    i);
+            oskar_update_horizon_mask(num_in, oskar_sky_l_const(in),
+                    oskar_sky_m_const(in), oskar_sky_n_const(in),
+                    ha0(oskar_station_lon_rad(s), ra0, gast), dec0,
+                    oskar_station_lat_rad(s), horizon_mask, status);
+        }
+    }
+    else
     {
-        const oskar_Station* s = oskar_telescope_station_const(telescope, i);
-        oskar_update_horizon_mask(num_in, oskar_sky_l_const(in),
+        double cos_dec0, sin_dec0;
+        const int* station_index;
+        const oskar_Mem *start, *margin;
+        oskar_Mem *dir, *dir_cpu, *start_copy = 0, *margin_copy = 0;
+
+        /* Get the local zenith direction of each station, in group order. */
+        dir = oskar_station_work_zenith_dir(work);
+        dir_cpu = (location == OSKAR_CPU) ?
+                dir : oskar_station_work_zenith_dir_cpu(work);
+        if ((int)oskar_mem_length(dir_cpu) != 3 * num_stations)
+            oskar_mem_realloc(dir_cpu, 3 * num_stations, status);
+        station_index = oskar_mem_int_const(group_station, status);
+        cos_dec0 = cos(dec0);
+        sin_dec0 = sin(dec0);
+        for (i = 0; i < num_stations && !*status; ++i)
+        {
+            double ha, cos_ha0, sin_lat, cos_lat, d[3];
+            const oskar_Station* s = oskar_telescope_station_const(telescope,
+                    station_index[i]);
+            ha = ha0(oskar_station_lon_rad(s), ra0, gast);
+            cos_ha0 = cos(ha);
+            sin_lat = sin(oskar_station_lat_rad(s));
+            cos_lat = cos(oskar_station_lat_rad(s));
+            d[0] = cos_lat * sin(ha);
+            d[1] = sin_lat * cos_dec0 - cos_lat * cos_ha0 * sin_dec0;
+            d[2] = sin_lat * sin_dec0 + cos_lat * cos_ha0 * cos_dec0;
+            for (j = 0; j < 3; ++j)
+            {
+                if (type == OSKAR_DOUBLE)
+                    oskar_mem_double(dir_cpu, status)[3 * i + j] = d[j];
+                else
+                    oskar_mem_float(dir_cpu, status)[3 * i + j] =
+                            (float) d[j];
+            }
+        }
+        if (dir != dir_cpu)
+            oskar_mem_copy(dir, dir_cpu, status);
+
+        /* The station groups are normally stored with the telescope model
+         * in the same location as the sky model, so are used in place. */
+        start = oskar_telescope_horizon_group_start_const(telescope);
+        margin = oskar_telescope_horizon_group_margin_const(telescope);
+        if (oskar_mem_location(start) != location)
+        {
+            start = start_copy = oskar_mem_create_copy(start, location,
+                    status);
+            margin = margin_copy = oskar_mem_create_copy(margin, location,
+                    status);
+        }
+        oskar_update_horizon_mask_grouped(num_in, oskar_sky_l_const(in),
                 oskar_sky_m_const(in), oskar_sky_n_const(in),
-                ha0(oskar_station_lon_rad(s), ra0, gast), dec0,
-                oskar_station_lat_rad(s), horizon_mask, status);
+                oskar_telescope_num_horizon_groups(telescope),
+                start, margin, dir, horizon_mask, status);
+        oskar_mem_free(start_copy, status);
+        oskar_mem_free(margin_copy, status);
     }
 
     /* Apply exclusive prefix sum to mask to get source output indices. */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -26,12 +26,23 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "sky/private_sky.h"
 #include "sky/oskar_sky.h"
-#include "utility/oskar_getline.h"
-#include "utility/oskar_string_to_array.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,12 +51,35 @@ extern "C" {
 static const double deg2rad = 1.74532925199432957692369e-2;
 static const double arcsec2rad = 4.84813681109535993589914e-6;
 
+/* Number of source parameters, and approximate size of a chunk of lines. */
+#define NUM_PARAM 12
+#define CHUNK_BYTES (1 << 20)
+
+typedef struct
+{
+    const char *start, *end; /* Line-aligned range of the file. */
+    double* par;             /* Parameters of each source in the range. */
+    int capacity, num_sources, offset, error;
+} Chunk;
+
+typedef struct
+{
+    char* data;
+    size_t size;
+    int mapped;
+} FileBuffer;
+
+static void file_open(FileBuffer* file, const char* filename, int* status);
+static void file_close(FileBuffer* file);
+static void parse_chunk(Chunk* c);
+static void set_sources(oskar_Sky* sky, const Chunk* c);
+
 oskar_Sky* oskar_sky_load(const char* filename, int type, int* status)
 {
-    int n = 0;
-    FILE* file;
-    char* line = 0;
-    size_t bufsize = 0;
+    int i, n = 0, capacity = 0, num_chunks, max_chunks = 1;
+    const char *pos, *end;
+    FileBuffer file;
+    Chunk* chunks = 0;
     oskar_Sky* sky;
 
     /* Check if safe to proceed. */
@@ -58,89 +92,304 @@ oskar_Sky* oskar_sky_load(const char* filename, int type, int* status)
         return 0;
     }
 
-    /* Open the file. */
-    file = fopen(filename, "r");
-    if (!file)
+    /* Map the file into memory. */
+    file_open(&file, filename, status);
+    if (*status)
     {
-        *status = OSKAR_ERR_FILE_IO;
+        file_close(&file);
         return 0;
     }
 
     /* Initialise the sky model. */
     sky = oskar_sky_create(type, OSKAR_CPU, 0, status);
 
-    /* Loop over lines in file. */
-    while (oskar_getline(&line, &bufsize, file) != OSKAR_ERR_EOF)
+    /* Parse one chunk of lines per thread at a time. */
+#ifdef _OPENMP
+    max_chunks = omp_get_max_threads();
+#endif
+    chunks = (Chunk*) calloc(max_chunks, sizeof(Chunk));
+    if (!chunks) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+
+    /* Stream through the file. */
+    pos = file.data;
+    end = file.data + file.size;
+    while (!*status && pos < end)
+    {
+        /* Split the next part of the file at line boundaries. */
+        for (num_chunks = 0; num_chunks < max_chunks && pos < end;
+                ++num_chunks)
+        {
+            const char* chunk_end = end;
+            if ((size_t)(end - pos) > CHUNK_BYTES)
+            {
+                chunk_end = (const char*) memchr(pos + CHUNK_BYTES, '\n',
+                        end - (pos + CHUNK_BYTES));
+                chunk_end = chunk_end ? chunk_end + 1 : end;
+            }
+            chunks[num_chunks].start = pos;
+            chunks[num_chunks].end = chunk_end;
+            pos = chunk_end;
+        }
+
+        /* Parse the chunks in parallel. */
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+        for (i = 0; i < num_chunks; ++i)
+            parse_chunk(&chunks[i]);
+
+        /* Find where each chunk goes in the sky model. */
+        for (i = 0; i < num_chunks; ++i)
+        {
+            if (chunks[i].error && !*status) *status = chunks[i].error;
+            chunks[i].offset = n;
+            n += chunks[i].num_sources;
+        }
+        if (*status) break;
+
+        /* Grow the arrays geometrically, to avoid repeated copies. */
+        if (n > capacity)
+        {
+            capacity = (n > 2 * capacity) ? n : 2 * capacity;
+            oskar_sky_resize(sky, capacity, status);
+            if (*status) break;
+        }
+
+        /* Copy the source parameters into the sky model. */
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+        for (i = 0; i < num_chunks; ++i)
+            set_sources(sky, &chunks[i]);
+    }
+
+    /* Set the size to be the actual number of elements loaded. */
+    oskar_sky_resize(sky, n, status);
+
+    /* Free the chunk buffers and unmap the file. */
+    for (i = 0; chunks && i < max_chunks; ++i)
+        free(chunks[i].par);
+    free(chunks);
+    file_close(&file);
+
+    /* Check if an error occurred. */
+    if (*status)
+    {
+        oskar_sky_free(sky, status);
+        sky = 0;
+    }
+
+    /* Return a handle to the sky model. */
+    return sky;
+}
+
+
+/*
+ * Splits the line into numbers in the same way as oskar_string_to_array_d(),
+ * without modifying it: tokens are separated by spaces, commas or tabs,
+ * a token starting with '#' ends the line, and tokens that are not
+ * numbers are skipped.
+ */
+static int parse_line(const char* p, const char* end, double* par)
+{
+    int num_read = 0;
+    while (num_read < NUM_PARAM)
+    {
+        char buffer[128], *token, *token_end;
+        size_t len = 0;
+        double val;
+
+        /* Find the next token. */
+        while (p < end && (*p == ' ' || *p == ',' || *p == '\t')) ++p;
+        if (p >= end || *p == '#') break;
+        while (p + len < end && p[len] != ' ' && p[len] != ',' &&
+                p[len] != '\t') ++len;
+
+        /* Convert it from a null-terminated copy. */
+        token = (len < sizeof(buffer)) ? buffer : (char*) malloc(len + 1);
+        if (!token) break;
+        memcpy(token, p, len);
+        token[len] = '\0';
+        val = strtod(token, &token_end);
+        if (token_end != token) par[num_read++] = val;
+        if (token != buffer) free(token);
+        p += len;
+    }
+    return num_read;
+}
+
+
+static void parse_chunk(Chunk* c)
+{
+    const char *p = c->start, *line_end;
+    c->num_sources = 0;
+    c->error = 0;
+    for (; p < c->end; p = line_end + 1)
     {
-        /* Set defaults. */
         /* RA, Dec, I, Q, U, V, freq0, spix, RM, FWHM maj, FWHM min, PA */
         double par[] = {0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0.};
-        size_t num_param = sizeof(par) / sizeof(double);
-        size_t num_required = 3, num_read = 0;
+        double* out;
+        int num_read;
 
         /* Load source parameters (require at least RA, Dec, Stokes I). */
-        num_read = oskar_string_to_array_d(line, num_param, par);
-        if (num_read < num_required)
+        line_end = (const char*) memchr(p, '\n', c->end - p);
+        if (!line_end) line_end = c->end;
+        num_read = parse_line(p, line_end, par);
+        if (num_read < 3)
             continue;
-
-        /* Ensure enough space in arrays. */
-        if (oskar_sky_num_sources(sky) <= n)
+        if (num_read == 10)
         {
-            oskar_sky_resize(sky, n + 100, status);
-            if (*status)
-                break;
+            c->error = OSKAR_ERR_BAD_SKY_FILE;
+            return;
         }
 
+        /* Ensure enough space in the chunk buffer. */
+        if (c->num_sources >= c->capacity)
+        {
+            void* t;
+            const int capacity = (c->capacity > 0) ? 2 * c->capacity : 4096;
+            t = realloc(c->par, capacity * NUM_PARAM * sizeof(double));
+            if (!t)
+            {
+                c->error = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+                return;
+            }
+            c->par = (double*) t;
+            c->capacity = capacity;
+        }
+        out = &c->par[NUM_PARAM * c->num_sources++];
+        out[0] = par[0] * deg2rad;
+        out[1] = par[1] * deg2rad;
+        memcpy(&out[2], &par[2], 6 * sizeof(double));
         if (num_read <= 9)
         {
             /* RA, Dec, I, Q, U, V, freq0, spix, RM */
-            oskar_sky_set_source(sky, n, par[0] * deg2rad,
-                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
-                    par[6], par[7], par[8], 0.0, 0.0, 0.0, status);
+            out[8] = par[8];
+            out[9] = out[10] = out[11] = 0.0;
         }
         else if (num_read == 11)
         {
             /* Old format, with no rotation measure. */
             /* RA, Dec, I, Q, U, V, freq0, spix, FWHM maj, FWHM min, PA */
-            oskar_sky_set_source(sky, n, par[0] * deg2rad,
-                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
-                    par[6], par[7], 0.0, par[8] * arcsec2rad,
-                    par[9] * arcsec2rad, par[10] * deg2rad, status);
+            out[8] = 0.0;
+            out[9] = par[8] * arcsec2rad;
+            out[10] = par[9] * arcsec2rad;
+            out[11] = par[10] * deg2rad;
         }
-        else if (num_read == 12)
+        else
         {
             /* New format. */
             /* RA, Dec, I, Q, U, V, freq0, spix, RM, FWHM maj, FWHM min, PA */
-            oskar_sky_set_source(sky, n, par[0] * deg2rad,
-                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
-                    par[6], par[7], par[8], par[9] * arcsec2rad,
-                    par[10] * arcsec2rad, par[11] * deg2rad, status);
+            out[8] = par[8];
+            out[9] = par[9] * arcsec2rad;
+            out[10] = par[10] * arcsec2rad;
+            out[11] = par[11] * deg2rad;
+        }
+    }
+}
+
+
+static void set_sources(oskar_Sky* sky, const Chunk* c)
+{
+    int i, j;
+    oskar_Mem* mem[NUM_PARAM];
+    mem[0] = sky->ra_rad;
+    mem[1] = sky->dec_rad;
+    mem[2] = sky->I;
+    mem[3] = sky->Q;
+    mem[4] = sky->U;
+    mem[5] = sky->V;
+    mem[6] = sky->reference_freq_hz;
+    mem[7] = sky->spectral_index;
+    mem[8] = sky->rm_rad;
+    mem[9] = sky->fwhm_major_rad;
+    mem[10] = sky->fwhm_minor_rad;
+    mem[11] = sky->pa_rad;
+    for (j = 0; j < NUM_PARAM; ++j)
+    {
+        if (oskar_mem_precision(mem[j]) == OSKAR_DOUBLE)
+        {
+            double* out = (double*) oskar_mem_void(mem[j]) + c->offset;
+            for (i = 0; i < c->num_sources; ++i)
+                out[i] = c->par[NUM_PARAM * i + j];
         }
         else
         {
-            /* Error. */
-            *status = OSKAR_ERR_BAD_SKY_FILE;
-            break;
+            float* out = (float*) oskar_mem_void(mem[j]) + c->offset;
+            for (i = 0; i < c->num_sources; ++i)
+                out[i] = (float) c->par[NUM_PARAM * i + j];
         }
-        ++n;
     }
+}
 
-    /* Set the size to be the actual number of elements loaded. */
-    oskar_sky_resize(sky, n, status);
 
-    /* Free the line buffer and close the file. */
-    if (line) free(line);
-    fclose(file);
+static void file_open(FileBuffer* file, const char* filename, int* status)
+{
+    FILE* stream;
+    file->data = 0;
+    file->size = 0;
+    file->mapped = 0;
+#ifndef _WIN32
+    {
+        struct stat st;
+        int fd = open(filename, O_RDONLY);
+        if (fd < 0)
+        {
+            *status = OSKAR_ERR_FILE_IO;
+            return;
+        }
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            void* p = mmap(0, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+                    fd, 0);
+            if (p != MAP_FAILED)
+            {
+#ifdef MADV_SEQUENTIAL
+                madvise(p, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
+                file->data = (char*) p;
+                file->size = (size_t) st.st_size;
+                file->mapped = 1;
+            }
+        }
+        close(fd);
+        if (file->mapped) return;
+    }
+#endif
 
-    /* Check if an error occurred. */
-    if (*status)
+    /* Fall back to reading the whole file into memory. */
+    stream = fopen(filename, "rb");
+    if (!stream)
     {
-        oskar_sky_free(sky, status);
-        sky = 0;
+        *status = OSKAR_ERR_FILE_IO;
+        return;
+    }
+    for (;;)
+    {
+        void* t;
+        size_t capacity = file->size ? 2 * file->size : 65536, num_read;
+        t = realloc(file->data, capacity);
+        if (!t)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            break;
+        }
+        file->data = (char*) t;
+        num_read = fread(file->data + file->size, 1,
+                capacity - file->size, stream);
+        file->size += num_read;
+        if (file->size < capacity) break;
     }
+    fclose(stream);
+}
 
-    /* Return a handle to the sky model. */
-    return sky;
+
+static void file_close(FileBuffer* file)
+{
+#ifndef _WIN32
+    if (file->mapped)
+    {
+        munmap(file->data, file->size);
+        return;
+    }
+#endif
+    free(file->data);
 }
 
 #ifdef __cplusplus
@@ -29,6 +29,7 @@
 #include "sky/oskar_sky.h"
 #include "sky/oskar_scale_flux_with_frequency_cuda.h"
 #include "sky/oskar_scale_flux_with_frequency.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
 #ifdef __cplusplus
@@ -49,7 +50,76 @@ void oskar_sky_scale_flux_with_frequency(oskar_Sky* model, double frequency,
     num_sources = oskar_sky_num_sources(model);
 
     /* Scale the flux values. */
-    if (type == OSKAR_SINGLE)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_sources + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel("scale_flux_with_frequency_double");
+        else if (type == OSKAR_SINGLE)
+            k = oskar_cl_kernel("scale_flux_with_frequency_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_sources;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        if (type == OSKAR_DOUBLE)
+        {
+            const cl_double freq = frequency;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &freq);
+        }
+        else
+        {
+            const cl_float freq = (cl_float) frequency;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &freq);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(oskar_sky_I(model), status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(oskar_sky_Q(model), status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(oskar_sky_U(model), status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(oskar_sky_V(model), status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(oskar_sky_reference_freq_hz(model),
+                        status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(
+                        oskar_sky_spectral_index_const(model), status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(
+                        oskar_sky_rotation_measure_rad_const(model), status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_sources > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (type == OSKAR_SINGLE)
     {
         float *I, *Q, *U, *V, *ref;
         const float *spix, *rm;
@@ -28,8 +28,13 @@
 
 #include "sky/oskar_update_horizon_mask.h"
 #include "sky/oskar_update_horizon_mask_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include <math.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -45,7 +50,6 @@ void oskar_update_horizon_mask(int num_sources, const oskar_Mem* l,
     if (*status) return;
     type = oskar_mem_precision(l);
     location = oskar_mem_location(mask);
-    mask_ = oskar_mem_int(mask, status);
     cos_ha0  = cos(ha0_rad);
     sin_dec0 = sin(dec0_rad);
     cos_dec0 = cos(dec0_rad);
@@ -54,6 +58,74 @@ void oskar_update_horizon_mask(int num_sources, const oskar_Mem* l,
     ll = cos_lat * sin(ha0_rad);
     mm = sin_lat * cos_dec0 - cos_lat * cos_ha0 * sin_dec0;
     nn = sin_lat * sin_dec0 + cos_lat * cos_ha0 * cos_dec0;
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_sources + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel("update_horizon_mask_double");
+        else if (type == OSKAR_SINGLE)
+            k = oskar_cl_kernel("update_horizon_mask_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_sources;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(l, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(m, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(n, status));
+        if (type == OSKAR_DOUBLE)
+        {
+            const cl_double ll_ = ll, mm_ = mm, nn_ = nn;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &ll_);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &mm_);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &nn_);
+        }
+        else
+        {
+            const cl_float ll_ = (cl_float) ll;
+            const cl_float mm_ = (cl_float) mm;
+            const cl_float nn_ = (cl_float) nn;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &ll_);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &mm_);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &nn_);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(mask, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_sources > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+        return;
+    }
+    mask_ = oskar_mem_int(mask, status);
     switch (type)
     {
     case OSKAR_SINGLE:
@@ -114,6 +186,184 @@ void oskar_update_horizon_mask(int num_sources, const oskar_Mem* l,
     }
 }
 
+void oskar_update_horizon_mask_grouped(int num_sources, const oskar_Mem* l,
+        const oskar_Mem* m, const oskar_Mem* n, int num_groups,
+        const oskar_Mem* group_start, const oskar_Mem* group_margin,
+        const oskar_Mem* station_dir, oskar_Mem* mask, int* status)
+{
+    int i, type, location, *mask_;
+    const int* start_;
+    if (*status) return;
+    type = oskar_mem_precision(l);
+    location = oskar_mem_location(mask);
+    if (oskar_mem_precision(group_margin) != type ||
+            oskar_mem_precision(station_dir) != type ||
+            oskar_mem_type(group_start) != OSKAR_INT)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (oskar_mem_location(l) != location ||
+            oskar_mem_location(group_start) != location ||
+            oskar_mem_location(group_margin) != location ||
+            oskar_mem_location(station_dir) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num, groups;
+        cl_uint arg = 0;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_sources + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel("update_horizon_mask_grouped_double");
+        else if (type == OSKAR_SINGLE)
+            k = oskar_cl_kernel("update_horizon_mask_grouped_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_sources;
+        groups = (cl_int) num_groups;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(l, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(m, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(n, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &groups);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(group_start, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(group_margin, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(station_dir, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(mask, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_sources > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+        return;
+    }
+    mask_ = oskar_mem_int(mask, status);
+    start_ = oskar_mem_int_const(group_start, status);
+    switch (type)
+    {
+    case OSKAR_SINGLE:
+    {
+        const float *l_, *m_, *n_, *margin_, *dir_;
+        l_ = oskar_mem_float_const(l, status);
+        m_ = oskar_mem_float_const(m, status);
+        n_ = oskar_mem_float_const(n, status);
+        margin_ = oskar_mem_float_const(group_margin, status);
+        dir_ = oskar_mem_float_const(station_dir, status);
+        if (location == OSKAR_GPU)
+        {
+#ifdef OSKAR_HAVE_CUDA
+            oskar_update_horizon_mask_grouped_cuda_f(num_sources, l_, m_, n_,
+                    num_groups, start_, margin_, dir_, mask_);
+#else
+            *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+        }
+        else if (location == OSKAR_CPU)
+        {
+#pragma omp parallel for private(i)
+            for (i = 0; i < num_sources; ++i)
+            {
+                int g, j;
+                const float ll = l_[i], mm = m_[i], nn = n_[i];
+                for (g = 0; g < num_groups; ++g)
+                {
+                    const int start = start_[g], end = start_[g + 1];
+                    const float* d = &dir_[3 * start];
+                    const float dot = ll * d[0] + mm * d[1] + nn * d[2];
+                    if (dot > margin_[g]) break;
+                    if (dot < -margin_[g]) continue;
+                    for (j = start; j < end; ++j, d += 3)
+                        if ((ll * d[0] + mm * d[1] + nn * d[2]) > 0.) break;
+                    if (j < end) break;
+                }
+                if (g < num_groups) mask_[i] = 1;
+            }
+        }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
+        break;
+    }
+    case OSKAR_DOUBLE:
+    {
+        const double *l_, *m_, *n_, *margin_, *dir_;
+        l_ = oskar_mem_double_const(l, status);
+        m_ = oskar_mem_double_const(m, status);
+        n_ = oskar_mem_double_const(n, status);
+        margin_ = oskar_mem_double_const(group_margin, status);
+        dir_ = oskar_mem_double_const(station_dir, status);
+        if (location == OSKAR_GPU)
+        {
+#ifdef OSKAR_HAVE_CUDA
+            oskar_update_horizon_mask_grouped_cuda_d(num_sources, l_, m_, n_,
+                    num_groups, start_, margin_, dir_, mask_);
+#else
+            *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+        }
+        else if (location == OSKAR_CPU)
+        {
+#pragma omp parallel for private(i)
+            for (i = 0; i < num_sources; ++i)
+            {
+                int g, j;
+                const double ll = l_[i], mm = m_[i], nn = n_[i];
+                for (g = 0; g < num_groups; ++g)
+                {
+                    const int start = start_[g], end = start_[g + 1];
+                    const double* d = &dir_[3 * start];
+                    const double dot = ll * d[0] + mm * d[1] + nn * d[2];
+                    if (dot > margin_[g]) break;
+                    if (dot < -margin_[g]) continue;
+                    for (j = start; j < end; ++j, d += 3)
+                        if ((ll * d[0] + mm * d[1] + nn * d[2]) > 0.) break;
+                    if (j < end) break;
+                }
+                if (g < num_groups) mask_[i] = 1;
+            }
+        }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
+        break;
+    }
+    default:
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        break;
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,40 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void update_horizon_mask_REAL(const int num_sources,
+        global const REAL* restrict l,
+        global const REAL* restrict m,
+        global const REAL* restrict n,
+        const REAL l_mul, const REAL m_mul, const REAL n_mul,
+        global int* restrict mask)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    mask[i] |= ((l[i] * l_mul + m[i] * m_mul + n[i] * n_mul) > (REAL) 0.);
+}
+
+kernel void update_horizon_mask_grouped_REAL(const int num_sources,
+        global const REAL* restrict l,
+        global const REAL* restrict m,
+        global const REAL* restrict n,
+        const int num_groups,
+        global const int* restrict group_start,
+        global const REAL* restrict group_margin,
+        global const REAL* restrict station_dir,
+        global int* restrict mask)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    const REAL ll = l[i], mm = m[i], nn = n[i];
+    int g, j;
+    for (g = 0; g < num_groups; ++g) {
+        const int start = group_start[g], end = group_start[g + 1];
+        global const REAL* d = &station_dir[3 * start];
+        const REAL dot = ll * d[0] + mm * d[1] + nn * d[2];
+        if (dot > group_margin[g]) break;
+        if (dot < -group_margin[g]) continue;
+        for (j = start; j < end; ++j, d += 3)
+            if ((ll * d[0] + mm * d[1] + nn * d[2]) > (REAL) 0.) break;
+        if (j < end) break;
+    }
+    if (g < num_groups) mask[i] = 1;
+}
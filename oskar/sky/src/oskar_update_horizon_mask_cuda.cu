@@ -40,6 +40,32 @@ void oskar_update_horizon_mask_cudak(const int num_sources,
     mask[i] |= ((l[i] * l_mul + m[i] * m_mul + n[i] * n_mul) > (T) 0.);
 }
 
+template<typename T>
+__global__
+void oskar_update_horizon_mask_grouped_cudak(const int num_sources,
+        const T* restrict l, const T* restrict m, const T* restrict n,
+        const int num_groups, const int* restrict group_start,
+        const T* restrict group_margin, const T* restrict station_dir,
+        int* restrict mask)
+{
+    int g, j;
+    const int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= num_sources) return;
+    const T l_ = l[i], m_ = m[i], n_ = n[i];
+    for (g = 0; g < num_groups; ++g)
+    {
+        const int start = group_start[g], end = group_start[g + 1];
+        const T* d = &station_dir[3 * start];
+        const T dot = l_ * d[0] + m_ * d[1] + n_ * d[2];
+        if (dot > group_margin[g]) break;
+        if (dot < -group_margin[g]) continue;
+        for (j = start; j < end; ++j, d += 3)
+            if ((l_ * d[0] + m_ * d[1] + n_ * d[2]) > (T) 0.) break;
+        if (j < end) break;
+    }
+    if (g < num_groups) mask[i] = 1;
+}
+
 void oskar_update_horizon_mask_cuda_f(int num_sources, const float* d_l,
         const float* d_m, const float* d_n, const float l_mul,
         const float m_mul, const float n_mul, int* d_mask)
@@ -61,3 +87,27 @@ void oskar_update_horizon_mask_cuda_d(int num_sources, const double* d_l,
     OSKAR_CUDAK_CONF(num_blocks, num_threads) (
             num_sources, d_l, d_m, d_n, l_mul, m_mul, n_mul, d_mask);
 }
+
+void oskar_update_horizon_mask_grouped_cuda_f(int num_sources,
+        const float* d_l, const float* d_m, const float* d_n,
+        int num_groups, const int* d_group_start, const float* d_group_margin,
+        const float* d_station_dir, int* d_mask)
+{
+    int num_threads = 256;
+    int num_blocks = (num_sources + num_threads - 1) / num_threads;
+    oskar_update_horizon_mask_grouped_cudak<float>
+    OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_sources, d_l, d_m, d_n,
+            num_groups, d_group_start, d_group_margin, d_station_dir, d_mask);
+}
+
+void oskar_update_horizon_mask_grouped_cuda_d(int num_sources,
+        const double* d_l, const double* d_m, const double* d_n,
+        int num_groups, const int* d_group_start, const double* d_group_margin,
+        const double* d_station_dir, int* d_mask)
+{
+    int num_threads = 256;
+    int num_blocks = (num_sources + num_threads - 1) / num_threads;
+    oskar_update_horizon_mask_grouped_cudak<double>
+    OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_sources, d_l, d_m, d_n,
+            num_groups, d_group_start, d_group_margin, d_station_dir, d_mask);
+}
@@ -30,6 +30,7 @@
 
 #include "telescope/oskar_telescope.h"
 #include "sky/oskar_sky.h"
+#include "sky/oskar_update_horizon_mask.h"
 #include "convert/oskar_convert_lon_lat_to_relative_directions.h"
 #include "utility/oskar_get_error_string.h"
 #include "utility/oskar_timer.h"
@@ -574,6 +575,124 @@ TEST(SkyModel, horizon_clip)
 }
 
 
+TEST(SkyModel, horizon_clip_grouped)
+{
+    int status = 0;
+    const double deg2rad = M_PI / 180.0;
+    const int n_sources = 100000, n_core = 200, n_remote = 100;
+    const int n_stations = n_core + n_remote;
+    const double gast_values[] = {0.0, 1.3, 4.2};
+    oskar_Timer* tmr = oskar_timer_create(OSKAR_TIMER_NATIVE);
+
+    for (int t = 0; t < 2; ++t)
+    {
+        int type = (t == 0) ? OSKAR_SINGLE : OSKAR_DOUBLE;
+
+        // Generate random sources over the whole sky.
+        srand(7);
+        oskar_Sky* sky_in = oskar_sky_create(type, OSKAR_CPU,
+                n_sources, &status);
+        for (int i = 0; i < n_sources; ++i)
+        {
+            double ra = 2.0 * M_PI * rand() / (double)RAND_MAX;
+            double dec = asin(2.0 * rand() / (double)RAND_MAX - 1.0);
+            oskar_sky_set_source(sky_in, i, ra, dec, 1.0, 0.0, 0.0, 0.0,
+                    100e6, 0.0, 0.0, 0.0, 0.0, 0.0, &status);
+        }
+        oskar_sky_evaluate_relative_directions(sky_in, 0.3, -0.4, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Create a telescope with a compact core and remote stations.
+        oskar_Telescope* tel = oskar_telescope_create(type, OSKAR_CPU,
+                n_stations, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        for (int i = 0; i < n_stations; ++i)
+        {
+            double lon, lat;
+            if (i < n_core)
+            {
+                lon = 116.7 + 0.6 * (rand() / (double)RAND_MAX - 0.5);
+                lat = -26.7 + 0.6 * (rand() / (double)RAND_MAX - 0.5);
+            }
+            else
+            {
+                lon = 360.0 * rand() / (double)RAND_MAX;
+                lat = 180.0 * rand() / (double)RAND_MAX - 90.0;
+            }
+            oskar_station_set_position(oskar_telescope_station(tel, i),
+                    lon * deg2rad, lat * deg2rad, 0.0);
+        }
+        EXPECT_EQ(0, oskar_telescope_num_horizon_groups(tel));
+        oskar_telescope_analyse(tel, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        int n_groups = oskar_telescope_num_horizon_groups(tel);
+        EXPECT_GT(n_groups, 0);
+        EXPECT_LE(n_groups, 64);
+
+        oskar_StationWork* work = oskar_station_work_create(type, OSKAR_CPU,
+                &status);
+        oskar_Sky* sky_out = oskar_sky_create(type, OSKAR_CPU, 0, &status);
+        oskar_Mem* mask = oskar_mem_create(OSKAR_INT, OSKAR_CPU,
+                n_sources, &status);
+        double t_ref = 0.0, t_grouped = 0.0;
+        for (int k = 0; k < (int)(sizeof(gast_values) / sizeof(double)); ++k)
+        {
+            // Reference mask: test every station in turn.
+            const double gast = gast_values[k];
+            const double ra0 = oskar_sky_reference_ra_rad(sky_in);
+            const double dec0 = oskar_sky_reference_dec_rad(sky_in);
+            oskar_mem_clear_contents(mask, &status);
+            oskar_timer_start(tmr);
+            for (int i = 0; i < n_stations; ++i)
+            {
+                const oskar_Station* s = oskar_telescope_station_const(tel, i);
+                oskar_update_horizon_mask(n_sources, oskar_sky_l_const(sky_in),
+                        oskar_sky_m_const(sky_in), oskar_sky_n_const(sky_in),
+                        gast + oskar_station_lon_rad(s) - ra0, dec0,
+                        oskar_station_lat_rad(s), mask, &status);
+            }
+            t_ref += oskar_timer_elapsed(tmr);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+            // Grouped horizon clip.
+            oskar_timer_start(tmr);
+            oskar_sky_horizon_clip(sky_out, sky_in, tel, gast, work, &status);
+            t_grouped += oskar_timer_elapsed(tmr);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+            // Check the same sources were kept, in the same order.
+            const int* m = oskar_mem_int_const(mask, &status);
+            const oskar_Mem* ra_in = oskar_sky_ra_rad_const(sky_in);
+            const oskar_Mem* ra_out = oskar_sky_ra_rad_const(sky_out);
+            int n_out = 0;
+            for (int i = 0; i < n_sources; ++i)
+            {
+                if (!m[i]) continue;
+                ASSERT_LT(n_out, oskar_sky_num_sources(sky_out));
+                if (type == OSKAR_DOUBLE)
+                    ASSERT_EQ(oskar_mem_double_const(ra_in, &status)[i],
+                            oskar_mem_double_const(ra_out, &status)[n_out]);
+                else
+                    ASSERT_EQ(oskar_mem_float_const(ra_in, &status)[i],
+                            oskar_mem_float_const(ra_out, &status)[n_out]);
+                n_out++;
+            }
+            ASSERT_EQ(n_out, oskar_sky_num_sources(sky_out));
+        }
+        printf("%s: %d stations in %d groups; "
+                "per-station %.4f s, grouped %.4f s\n",
+                type == OSKAR_DOUBLE ? "Double" : "Single",
+                n_stations, n_groups, t_ref, t_grouped);
+
+        oskar_mem_free(mask, &status);
+        oskar_sky_free(sky_out, &status);
+        oskar_station_work_free(work, &status);
+        oskar_telescope_free(tel, &status);
+        oskar_sky_free(sky_in, &status);
+    }
+    oskar_timer_free(tmr);
+}
+
 TEST(SkyModel, resize)
 {
     int status = 0;
@@ -1146,6 +1265,96 @@ TEST(SkyModel, load_ascii)
 }
 
 
+TEST(SkyModel, load_ascii_formats)
+{
+    int status = 0;
+    const double deg2rad = 1.74532925199432957692369e-2;
+    const double arcsec2rad = 4.84813681109535993589914e-6;
+    const char* filename = "temp_sources_formats.osm";
+
+    // Write a file mixing all line formats, comments, blank lines, short
+    // rows and separators, ending without a newline.
+    FILE* file = fopen(filename, "w");
+    if (!file) FAIL() << "Unable to create test file";
+    fprintf(file, "# RA, Dec, I, Q, U, V, freq0, spix, RM, maj, min, PA\n");
+    fprintf(file, "10.0 20.0 1.5\n");
+    fprintf(file, "\n  \t\n");
+    fprintf(file, "11.0,21.0, 2.5\t0.1 0.2 0.3 100e6 -0.7 # comment\r\n");
+    fprintf(file, "12.0 22.0\n");
+    fprintf(file, "1.0 foo\n");
+    fprintf(file, "13.0 23.0 3.5 0.1 0.2 0.3 100e6 -0.7 30.0 20.0 45.0\n");
+    fprintf(file, "# 1 2 3 4 5 6 7 8 9 10\n");
+    fprintf(file, "14.0 23.0 4.5 0.1 0.2 0.3 100e6 -0.7 5.0 30.0 20.0 45.0");
+    fclose(file);
+
+    // Check every column of every source, in both precisions.
+    const double expected[][12] = {
+            {10.0 * deg2rad, 20.0 * deg2rad, 1.5, 0., 0., 0., 0., 0., 0.,
+                    0., 0., 0.},
+            {11.0 * deg2rad, 21.0 * deg2rad, 2.5, 0.1, 0.2, 0.3, 100e6,
+                    -0.7, 0., 0., 0., 0.},
+            {13.0 * deg2rad, 23.0 * deg2rad, 3.5, 0.1, 0.2, 0.3, 100e6,
+                    -0.7, 0., 30.0 * arcsec2rad, 20.0 * arcsec2rad,
+                    45.0 * deg2rad},
+            {14.0 * deg2rad, 23.0 * deg2rad, 4.5, 0.1, 0.2, 0.3, 100e6,
+                    -0.7, 5.0, 30.0 * arcsec2rad, 20.0 * arcsec2rad,
+                    45.0 * deg2rad}
+    };
+    const int num_sources = sizeof(expected) / sizeof(expected[0]);
+    for (int t = 0; t < 2; ++t)
+    {
+        int type = (t == 0) ? OSKAR_SINGLE : OSKAR_DOUBLE;
+        oskar_Sky* sky = oskar_sky_load(filename, type, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_EQ(type, oskar_sky_precision(sky));
+        ASSERT_EQ(num_sources, oskar_sky_num_sources(sky));
+        oskar_Mem* col[] = {oskar_sky_ra_rad(sky), oskar_sky_dec_rad(sky),
+                oskar_sky_I(sky), oskar_sky_Q(sky), oskar_sky_U(sky),
+                oskar_sky_V(sky), oskar_sky_reference_freq_hz(sky),
+                oskar_sky_spectral_index(sky),
+                oskar_sky_rotation_measure_rad(sky),
+                oskar_sky_fwhm_major_rad(sky), oskar_sky_fwhm_minor_rad(sky),
+                oskar_sky_position_angle_rad(sky)};
+        for (int i = 0; i < num_sources; ++i)
+        {
+            for (int j = 0; j < 12; ++j)
+            {
+                if (type == OSKAR_SINGLE)
+                    EXPECT_FLOAT_EQ((float)expected[i][j],
+                            oskar_mem_float(col[j], &status)[i])
+                            << "Source " << i << ", column " << j;
+                else
+                    EXPECT_DOUBLE_EQ(expected[i][j],
+                            oskar_mem_double(col[j], &status)[i])
+                            << "Source " << i << ", column " << j;
+            }
+        }
+        oskar_sky_free(sky, &status);
+    }
+
+    // Check that a line with 10 columns is rejected.
+    file = fopen(filename, "a");
+    if (!file) FAIL() << "Unable to open test file";
+    fprintf(file, "\n1 2 3 4 5 6 7 8 9 10\n");
+    fclose(file);
+    oskar_Sky* sky = oskar_sky_load(filename, OSKAR_DOUBLE, &status);
+    EXPECT_EQ((int)OSKAR_ERR_BAD_SKY_FILE, status);
+    EXPECT_TRUE(sky == NULL);
+    status = 0;
+
+    // Check that an empty file gives an empty sky model.
+    file = fopen(filename, "w");
+    if (!file) FAIL() << "Unable to create test file";
+    fclose(file);
+    sky = oskar_sky_load(filename, OSKAR_DOUBLE, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_TRUE(sky != NULL);
+    EXPECT_EQ(0, oskar_sky_num_sources(sky));
+    oskar_sky_free(sky, &status);
+    remove(filename);
+}
+
+
 TEST(SkyModel, read_write)
 {
     oskar_Sky *sky, *sky2;
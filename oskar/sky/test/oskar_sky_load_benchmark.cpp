@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "apps/oskar_option_parser.h"
+#include "sky/oskar_sky.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_getline.h"
+#include "utility/oskar_string_to_array.h"
+#include "utility/oskar_timer.h"
+#include "oskar_version.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static void write_file(const char* filename, int num_lines, int* status);
+static oskar_Sky* load_line_by_line(const char* filename, int type,
+        int* status);
+
+int main(int argc, char** argv)
+{
+    oskar::OptionParser opt("oskar_sky_load_benchmark", OSKAR_VERSION_STR);
+    opt.add_flag("-n", "Number of lines in the generated sky model file.",
+            1, "1000000", false);
+    opt.add_flag("-sp", "Use single precision (default: double precision)");
+    opt.add_flag("-f", "Name of the temporary sky model file.", 1,
+            "temp_sky_load_benchmark.osm", false);
+    if (!opt.check_options(argc, argv))
+        return EXIT_FAILURE;
+
+    int num_lines = 0, status = 0;
+    std::string filename;
+    opt.get("-n")->getInt(num_lines);
+    opt.get("-f")->getString(filename);
+    int type = opt.is_set("-sp") ? OSKAR_SINGLE : OSKAR_DOUBLE;
+
+    // Write the file.
+    write_file(filename.c_str(), num_lines, &status);
+    if (status)
+    {
+        fprintf(stderr, "ERROR: Unable to write '%s'\n", filename.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Load it with the line-by-line loader and with oskar_sky_load().
+    oskar_Timer* tmr = oskar_timer_create(OSKAR_TIMER_NATIVE);
+    oskar_timer_start(tmr);
+    oskar_Sky* sky_ref = load_line_by_line(filename.c_str(), type, &status);
+    double t_ref = oskar_timer_elapsed(tmr);
+    oskar_timer_start(tmr);
+    oskar_Sky* sky = oskar_sky_load(filename.c_str(), type, &status);
+    double t_new = oskar_timer_elapsed(tmr);
+    oskar_timer_free(tmr);
+    remove(filename.c_str());
+    if (status)
+    {
+        fprintf(stderr, "ERROR: %s\n", oskar_get_error_string(status));
+        oskar_sky_free(sky_ref, &status);
+        oskar_sky_free(sky, &status);
+        return EXIT_FAILURE;
+    }
+
+    // Check the results agree.
+    int num_sources = oskar_sky_num_sources(sky);
+    int same = (num_sources == oskar_sky_num_sources(sky_ref));
+    if (same)
+    {
+        oskar_Mem* a[] = {oskar_sky_ra_rad(sky), oskar_sky_dec_rad(sky),
+                oskar_sky_I(sky), oskar_sky_Q(sky), oskar_sky_U(sky),
+                oskar_sky_V(sky), oskar_sky_reference_freq_hz(sky),
+                oskar_sky_spectral_index(sky),
+                oskar_sky_rotation_measure_rad(sky),
+                oskar_sky_fwhm_major_rad(sky), oskar_sky_fwhm_minor_rad(sky),
+                oskar_sky_position_angle_rad(sky)};
+        oskar_Mem* b[] = {oskar_sky_ra_rad(sky_ref),
+                oskar_sky_dec_rad(sky_ref), oskar_sky_I(sky_ref),
+                oskar_sky_Q(sky_ref), oskar_sky_U(sky_ref),
+                oskar_sky_V(sky_ref), oskar_sky_reference_freq_hz(sky_ref),
+                oskar_sky_spectral_index(sky_ref),
+                oskar_sky_rotation_measure_rad(sky_ref),
+                oskar_sky_fwhm_major_rad(sky_ref),
+                oskar_sky_fwhm_minor_rad(sky_ref),
+                oskar_sky_position_angle_rad(sky_ref)};
+        for (int i = 0; i < 12; ++i)
+            if (oskar_mem_different(a[i], b[i], 0, &status)) same = 0;
+    }
+    printf("Loaded %d sources (%s precision)\n", num_sources,
+            type == OSKAR_DOUBLE ? "double" : "single");
+    printf("- Line-by-line loader: %.3f sec\n", t_ref);
+    printf("- oskar_sky_load():    %.3f sec\n", t_new);
+    if (!same)
+        fprintf(stderr, "ERROR: Sky models differ\n");
+    oskar_sky_free(sky_ref, &status);
+    oskar_sky_free(sky, &status);
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void write_file(const char* filename, int num_lines, int* status)
+{
+    FILE* file = fopen(filename, "w");
+    if (!file)
+    {
+        *status = OSKAR_ERR_FILE_IO;
+        return;
+    }
+    srand(2);
+    for (int i = 0; i < num_lines; ++i)
+    {
+        double r[12];
+        for (int j = 0; j < 12; ++j) r[j] = 360.0 * rand() / RAND_MAX;
+        switch (i % 5)
+        {
+        case 0:
+            fprintf(file, "# comment %d\n", i);
+            break;
+        case 1:
+            fprintf(file, "%.12f %.12f %.9e\n", r[0], r[1], r[2]);
+            break;
+        case 2:
+            fprintf(file, "%.12f,%.12f, %.9e\t%.3f %.3f %.3f %.6e %.3f\n",
+                    r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+            break;
+        case 3:
+            fprintf(file, "%.12f %.12f %.9e %.3f %.3f %.3f %.6e %.3f "
+                    "%.3f %.3f %.3f\n", r[0], r[1], r[2], r[3], r[4], r[5],
+                    r[6], r[7], r[8], r[9], r[10]);
+            break;
+        default:
+            fprintf(file, "%.12f %.12f %.9e %.3f %.3f %.3f %.6e %.3f "
+                    "%.3f %.3f %.3f %.3f\n", r[0], r[1], r[2], r[3], r[4],
+                    r[5], r[6], r[7], r[8], r[9], r[10], r[11]);
+            break;
+        }
+    }
+    fclose(file);
+}
+
+/* The loader used before oskar_sky_load() parsed the file in chunks. */
+static oskar_Sky* load_line_by_line(const char* filename, int type,
+        int* status)
+{
+    const double deg2rad = 1.74532925199432957692369e-2;
+    const double arcsec2rad = 4.84813681109535993589914e-6;
+    int n = 0;
+    char* line = 0;
+    size_t bufsize = 0;
+    if (*status) return 0;
+    FILE* file = fopen(filename, "r");
+    if (!file)
+    {
+        *status = OSKAR_ERR_FILE_IO;
+        return 0;
+    }
+    oskar_Sky* sky = oskar_sky_create(type, OSKAR_CPU, 0, status);
+    while (oskar_getline(&line, &bufsize, file) != OSKAR_ERR_EOF)
+    {
+        double par[] = {0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0.};
+        size_t num_read = oskar_string_to_array_d(line, 12, par);
+        if (num_read < 3) continue;
+        if (oskar_sky_num_sources(sky) <= n)
+            oskar_sky_resize(sky, n + 100, status);
+        if (num_read <= 9)
+            oskar_sky_set_source(sky, n, par[0] * deg2rad,
+                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
+                    par[6], par[7], par[8], 0.0, 0.0, 0.0, status);
+        else if (num_read == 11)
+            oskar_sky_set_source(sky, n, par[0] * deg2rad,
+                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
+                    par[6], par[7], 0.0, par[8] * arcsec2rad,
+                    par[9] * arcsec2rad, par[10] * deg2rad, status);
+        else if (num_read == 12)
+            oskar_sky_set_source(sky, n, par[0] * deg2rad,
+                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
+                    par[6], par[7], par[8], par[9] * arcsec2rad,
+                    par[10] * arcsec2rad, par[11] * deg2rad, status);
+        else
+            *status = OSKAR_ERR_BAD_SKY_FILE;
+        if (*status) break;
+        ++n;
+    }
+    oskar_sky_resize(sky, n, status);
+    free(line);
+    fclose(file);
+    return sky;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SPLINES_EVALUATE_MULTI_H_
+#define OSKAR_SPLINES_EVALUATE_MULTI_H_
+
+/**
+ * @file oskar_splines_evaluate_multi.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates several surfaces fitted by splines at the same positions.
+ *
+ * @details
+ * This function evaluates a set of bicubic spline surfaces at the given
+ * positions, writing the value of surface \p k at point \p i to
+ * element (offset + k + i * stride) of the output array.
+ *
+ * On the CPU, the knot interval search and B-spline basis functions are
+ * computed only once per point for consecutive surfaces that share the
+ * same knots, and points are processed in parallel using OpenMP.
+ *
+ * @param[out] output      Output values.
+ * @param[in] offset       Offset of the first surface into the output array.
+ * @param[in] stride       Output stride between points.
+ * @param[in] num_splines  Number of surfaces to evaluate.
+ * @param[in] splines      Array of pointers to spline data structures.
+ * @param[in] num_points   Number of positions.
+ * @param[in] x            List of x coordinates.
+ * @param[in] y            List of y coordinates.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_splines_evaluate_multi(oskar_Mem* output, int offset, int stride,
+        int num_splines, const oskar_Splines* const* splines, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SPLINES_EVALUATE_MULTI_H_ */
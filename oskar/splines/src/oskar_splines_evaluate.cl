@@ -0,0 +1,56 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+// Finds the knot interval containing x, and evaluates the four non-zero
+// cubic B-splines there. Returns the index of the first coefficient.
+inline int splines_bicubic_basis_REAL(global const REAL* restrict t,
+        const int n, REAL x, REAL* h)
+{
+    const int nk1 = n - 4;
+    int l = 4;
+    REAL hh[3];
+    if (x < t[3]) x = t[3];
+    if (x > t[nk1]) x = t[nk1];
+    while (!(x < t[l] || l == nk1)) l++;
+    h[0] = (REAL) 1.;
+    for (int j = 1; j <= 3; ++j) {
+        for (int i = 0; i < j; ++i) hh[i] = h[i];
+        h[0] = (REAL) 0.;
+        for (int i = 0; i < j; ++i) {
+            const int li = l + i, lj = li - j;
+            const REAL f = hh[i] / (t[li] - t[lj]);
+            h[i] += f * (t[li] - x);
+            h[i + 1] = f * (x - t[lj]);
+        }
+    }
+    return l - 4;
+}
+
+kernel void splines_bicubic_REAL(const int num_points,
+        global const REAL* restrict x,
+        global const REAL* restrict y,
+        const int nx, global const REAL* restrict tx,
+        const int ny, global const REAL* restrict ty,
+        global const REAL* restrict c,
+        const int stride, const int offset,
+        global REAL* restrict out)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    REAL wx[4], wy[4], sum = (REAL) 0.;
+    const int lx = splines_bicubic_basis_REAL(tx, nx, x[i], wx);
+    const int ly = splines_bicubic_basis_REAL(ty, ny, y[i], wy);
+    int l1 = lx * (ny - 4) + ly;
+    for (int a = 0; a < 4; ++a, l1 += ny - 4)
+        for (int b = 0; b < 4; ++b)
+            sum += c[l1 + b] * wx[a] * wy[b];
+    out[offset + i * stride] = sum;
+}
+
+kernel void splines_zero_REAL(const int num_points,
+        const int stride, const int offset,
+        global REAL* restrict out)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    out[offset + i * stride] = (REAL) 0.;
+}
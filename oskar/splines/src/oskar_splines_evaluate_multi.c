@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "splines/private_splines.h"
+#include "splines/oskar_dierckx_bispev_bicubic_cuda.h"
+#include "splines/oskar_splines.h"
+#include "utility/oskar_cl_utils.h"
+#include "utility/oskar_device_utils.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Minimum number of points worth evaluating on multiple threads. */
+#define MIN_POINTS_PARALLEL 256
+
+typedef struct
+{
+    const void *tx, *ty, *c;
+    int nx, ny, same_knots;
+} SplineData;
+
+/*
+ * Finds the knot interval containing x, and evaluates the four non-zero
+ * cubic B-splines there using the recurrence relation of de Boor and Cox
+ * (as in DIERCKX fpbisp and fpbspl). Returns the index of the first
+ * coefficient in the interval.
+ */
+static int bicubic_basis_f(const float* t, int n, float x, float* h)
+{
+    int i, j, l, nk1 = n - 4;
+    float f, hh[3];
+    if (x < t[3]) x = t[3];
+    if (x > t[nk1]) x = t[nk1];
+    l = 4;
+    while (!(x < t[l] || l == nk1)) l++;
+    h[0] = 1.0f;
+    for (j = 1; j <= 3; ++j)
+    {
+        for (i = 0; i < j; ++i) hh[i] = h[i];
+        h[0] = 0.0f;
+        for (i = 0; i < j; ++i)
+        {
+            const int li = l + i, lj = li - j;
+            f = hh[i] / (t[li] - t[lj]);
+            h[i] += f * (t[li] - x);
+            h[i + 1] = f * (x - t[lj]);
+        }
+    }
+    return l - 4;
+}
+
+static int bicubic_basis_d(const double* t, int n, double x, double* h)
+{
+    int i, j, l, nk1 = n - 4;
+    double f, hh[3];
+    if (x < t[3]) x = t[3];
+    if (x > t[nk1]) x = t[nk1];
+    l = 4;
+    while (!(x < t[l] || l == nk1)) l++;
+    h[0] = 1.0;
+    for (j = 1; j <= 3; ++j)
+    {
+        for (i = 0; i < j; ++i) hh[i] = h[i];
+        h[0] = 0.0;
+        for (i = 0; i < j; ++i)
+        {
+            const int li = l + i, lj = li - j;
+            f = hh[i] / (t[li] - t[lj]);
+            h[i] += f * (t[li] - x);
+            h[i + 1] = f * (x - t[lj]);
+        }
+    }
+    return l - 4;
+}
+
+static void evaluate_cpu_f(const SplineData* s, int num_splines,
+        int num_points, const float* x, const float* y, int stride,
+        float* out)
+{
+    int i;
+#pragma omp parallel for if(num_points >= MIN_POINTS_PARALLEL)
+    for (i = 0; i < num_points; ++i)
+    {
+        int k, lx = 0, ly = 0;
+        float wx[4], wy[4];
+        for (k = 0; k < num_splines; ++k)
+        {
+            int a, b, l1;
+            const float *tx, *ty, *c;
+            float sum = 0.0f;
+            if (!s[k].c)
+            {
+                out[i * stride + k] = 0.0f;
+                continue;
+            }
+            tx = (const float*) s[k].tx;
+            ty = (const float*) s[k].ty;
+            c  = (const float*) s[k].c;
+            if (!s[k].same_knots)
+            {
+                lx = bicubic_basis_f(tx, s[k].nx, x[i], wx);
+                ly = bicubic_basis_f(ty, s[k].ny, y[i], wy);
+            }
+            l1 = lx * (s[k].ny - 4) + ly;
+            for (a = 0; a < 4; ++a, l1 += s[k].ny - 4)
+                for (b = 0; b < 4; ++b)
+                    sum += c[l1 + b] * wx[a] * wy[b];
+            out[i * stride + k] = sum;
+        }
+    }
+}
+
+static void evaluate_cpu_d(const SplineData* s, int num_splines,
+        int num_points, const double* x, const double* y, int stride,
+        double* out)
+{
+    int i;
+#pragma omp parallel for if(num_points >= MIN_POINTS_PARALLEL)
+    for (i = 0; i < num_points; ++i)
+    {
+        int k, lx = 0, ly = 0;
+        double wx[4], wy[4];
+        for (k = 0; k < num_splines; ++k)
+        {
+            int a, b, l1;
+            const double *tx, *ty, *c;
+            double sum = 0.0;
+            if (!s[k].c)
+            {
+                out[i * stride + k] = 0.0;
+                continue;
+            }
+            tx = (const double*) s[k].tx;
+            ty = (const double*) s[k].ty;
+            c  = (const double*) s[k].c;
+            if (!s[k].same_knots)
+            {
+                lx = bicubic_basis_d(tx, s[k].nx, x[i], wx);
+                ly = bicubic_basis_d(ty, s[k].ny, y[i], wy);
+            }
+            l1 = lx * (s[k].ny - 4) + ly;
+            for (a = 0; a < 4; ++a, l1 += s[k].ny - 4)
+                for (b = 0; b < 4; ++b)
+                    sum += c[l1 + b] * wx[a] * wy[b];
+            out[i * stride + k] = sum;
+        }
+    }
+}
+
+void oskar_splines_evaluate_multi(oskar_Mem* output, int offset, int stride,
+        int num_splines, const oskar_Splines* const* splines, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, int* status)
+{
+    int k, type, location;
+    SplineData* s;
+
+    /* Check if safe to proceed. */
+    if (*status || num_splines < 1) return;
+
+    /* Check types and locations. */
+    type = oskar_mem_precision(output);
+    location = oskar_mem_location(output);
+    if (type != oskar_mem_type(x) || type != oskar_mem_type(y))
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (location != oskar_mem_location(x) || location != oskar_mem_location(y))
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (type != OSKAR_SINGLE && type != OSKAR_DOUBLE)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+    for (k = 0; k < num_splines; ++k)
+    {
+        if (splines[k]->precision != type)
+        {
+            *status = OSKAR_ERR_TYPE_MISMATCH;
+            return;
+        }
+        if (splines[k]->mem_location != location)
+        {
+            *status = OSKAR_ERR_LOCATION_MISMATCH;
+            return;
+        }
+    }
+
+    /* Get pointers to the knots and coefficients of each surface. */
+    s = (SplineData*) calloc(num_splines, sizeof(SplineData));
+    if (!s)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+    for (k = 0; k < num_splines; ++k)
+    {
+        const oskar_Splines* p = splines[k];
+        s[k].nx = p->num_knots_x_theta;
+        s[k].ny = p->num_knots_y_phi;
+        if (s[k].nx > 0 && s[k].ny > 0)
+        {
+            s[k].tx = oskar_mem_void_const(p->knots_x_theta);
+            s[k].ty = oskar_mem_void_const(p->knots_y_phi);
+            s[k].c  = oskar_mem_void_const(p->coeff);
+        }
+        if (!s[k].tx || !s[k].ty || !s[k].c)
+            s[k].tx = s[k].ty = s[k].c = 0;
+    }
+
+    /* Evaluate the surfaces. */
+    if (location == OSKAR_CPU)
+    {
+        /* Check if the basis functions can be reused from the last one.
+         * Knots are only dereferenced here, as they are in host memory. */
+        const size_t element_size = oskar_mem_element_size(type);
+        for (k = 1; k < num_splines; ++k)
+        {
+            if (s[k].c && s[k - 1].c && s[k].nx == s[k - 1].nx &&
+                    s[k].ny == s[k - 1].ny)
+                s[k].same_knots =
+                    !memcmp(s[k].tx, s[k - 1].tx, s[k].nx * element_size) &&
+                    !memcmp(s[k].ty, s[k - 1].ty, s[k].ny * element_size);
+        }
+        if (type == OSKAR_SINGLE)
+            evaluate_cpu_f(s, num_splines, num_points,
+                    oskar_mem_float_const(x, status),
+                    oskar_mem_float_const(y, status), stride,
+                    oskar_mem_float(output, status) + offset);
+        else
+            evaluate_cpu_d(s, num_splines, num_points,
+                    oskar_mem_double_const(x, status),
+                    oskar_mem_double_const(y, status), stride,
+                    oskar_mem_double(output, status) + offset);
+    }
+    else if (location == OSKAR_GPU)
+    {
+#ifdef OSKAR_HAVE_CUDA
+        for (k = 0; k < num_splines; ++k)
+        {
+            if (type == OSKAR_SINGLE)
+                oskar_dierckx_bispev_bicubic_cuda_f(
+                        (const float*) s[k].tx, s[k].nx,
+                        (const float*) s[k].ty, s[k].ny,
+                        (const float*) s[k].c, num_points,
+                        oskar_mem_float_const(x, status),
+                        oskar_mem_float_const(y, status), stride,
+                        oskar_mem_float(output, status) + offset + k);
+            else
+                oskar_dierckx_bispev_bicubic_cuda_d(
+                        (const double*) s[k].tx, s[k].nx,
+                        (const double*) s[k].ty, s[k].ny,
+                        (const double*) s[k].c, num_points,
+                        oskar_mem_double_const(x, status),
+                        oskar_mem_double_const(y, status), stride,
+                        oskar_mem_double(output, status) + offset + k);
+        }
+        oskar_device_check_error(status);
+#else
+        *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k_eval, k_zero;
+        cl_int error, num, str;
+        const int is_dbl = (type == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_points + local_size - 1) /
+                local_size) * local_size;
+        k_eval = is_dbl ? oskar_cl_kernel("splines_bicubic_double") :
+                oskar_cl_kernel("splines_bicubic_float");
+        k_zero = is_dbl ? oskar_cl_kernel("splines_zero_double") :
+                oskar_cl_kernel("splines_zero_float");
+        if (!k_eval || !k_zero)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            free(s);
+            return;
+        }
+        num = (cl_int) num_points;
+        str = (cl_int) stride;
+        for (k = 0; k < num_splines && !*status && num_points > 0; ++k)
+        {
+            cl_kernel kernel;
+            cl_uint arg = 0;
+            const oskar_Splines* p = splines[k];
+            const cl_int off = (cl_int) (offset + k);
+
+            /* Set kernel arguments.
+             * (Surfaces without coefficients evaluate to zero.) */
+            if (s[k].nx > 0 && s[k].ny > 0 && oskar_mem_length(p->coeff) > 0)
+            {
+                const cl_int nx = (cl_int) s[k].nx, ny = (cl_int) s[k].ny;
+                kernel = k_eval;
+                error = clSetKernelArg(kernel, arg++, sizeof(cl_int), &num);
+                error |= clSetKernelArg(kernel, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(x, status));
+                error |= clSetKernelArg(kernel, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(y, status));
+                error |= clSetKernelArg(kernel, arg++, sizeof(cl_int), &nx);
+                error |= clSetKernelArg(kernel, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(p->knots_x_theta, status));
+                error |= clSetKernelArg(kernel, arg++, sizeof(cl_int), &ny);
+                error |= clSetKernelArg(kernel, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(p->knots_y_phi, status));
+                error |= clSetKernelArg(kernel, arg++, sizeof(cl_mem),
+                        oskar_mem_cl_buffer_const(p->coeff, status));
+            }
+            else
+            {
+                kernel = k_zero;
+                error = clSetKernelArg(kernel, arg++, sizeof(cl_int), &num);
+            }
+            error |= clSetKernelArg(kernel, arg++, sizeof(cl_int), &str);
+            error |= clSetKernelArg(kernel, arg++, sizeof(cl_int), &off);
+            error |= clSetKernelArg(kernel, arg++, sizeof(cl_mem),
+                    oskar_mem_cl_buffer(output, status));
+            if (!*status && error != CL_SUCCESS)
+                *status = OSKAR_ERR_INVALID_ARGUMENT;
+            if (!*status)
+            {
+                /* Launch kernel on current command queue. */
+                error = clEnqueueNDRangeKernel(oskar_cl_command_queue(),
+                        kernel, 1, NULL, &global_size, &local_size,
+                        0, NULL, &event);
+                if (error != CL_SUCCESS)
+                    *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+            }
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else
+        *status = OSKAR_ERR_BAD_LOCATION;
+    free(s);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "splines/oskar_splines.h"
+#include "splines/oskar_dierckx_bispev.h"
+#include "utility/oskar_cl_utils.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cmath>
+#include <cstdlib>
+
+static double fn(int k, double x, double y)
+{
+    switch (k)
+    {
+    case 0:  return sin(3.0 * x) * cos(2.0 * y);
+    case 1:  return exp(-((x - 0.5) * (x - 0.5) + y * y) * 4.0);
+    default: return x * x - 2.0 * x * y + 0.5 * y;
+    }
+}
+
+static oskar_Splines* fit(int k, int n, double r, int* status)
+{
+    double avg_frac_err = 0.005;
+    oskar_Mem *x, *y, *z, *w;
+    oskar_Splines* s = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU, status);
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, n * n, status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, n * n, status);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, n * n, status);
+    w = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, n * n, status);
+    double *x_ = oskar_mem_double(x, status), *y_ = oskar_mem_double(y, status);
+    double *z_ = oskar_mem_double(z, status), *w_ = oskar_mem_double(w, status);
+    for (int j = 0, i = 0; j < n; ++j)
+    {
+        for (int l = 0; l < n; ++l, ++i)
+        {
+            x_[i] = r * l / (n - 1.0);
+            y_[i] = r * j / (n - 1.0);
+            z_[i] = fn(k, x_[i], y_[i]);
+            w_[i] = 1.0;
+        }
+    }
+    oskar_splines_fit(s, n * n, x_, y_, z_, w_, OSKAR_SPLINES_LINEAR, 1,
+            &avg_frac_err, 1.5, 1.0, 1e-14, status);
+    oskar_mem_free(x, status);
+    oskar_mem_free(y, status);
+    oskar_mem_free(z, status);
+    oskar_mem_free(w, status);
+    return s;
+}
+
+static double bispev(const oskar_Splines* s, double x, double y)
+{
+    int ier = 0, iwrk[2];
+    double z = 0.0, wrk[8];
+    const int nx = oskar_splines_num_knots_x_theta(s);
+    const int ny = oskar_splines_num_knots_y_phi(s);
+    const double* tx = (const double*)
+            oskar_mem_void_const(oskar_splines_knots_x_theta_const(s));
+    const double* ty = (const double*)
+            oskar_mem_void_const(oskar_splines_knots_y_phi_const(s));
+    const double* c = (const double*)
+            oskar_mem_void_const(oskar_splines_coeff_const(s));
+
+    // Clamp to the knot range, as the evaluation functions do.
+    if (x < tx[3]) x = tx[3];
+    if (x > tx[nx - 4]) x = tx[nx - 4];
+    if (y < ty[3]) y = ty[3];
+    if (y > ty[ny - 4]) y = ty[ny - 4];
+    oskar_dierckx_bispev_d(tx, nx, ty, ny, c, 3, 3, &x, 1, &y, 1, &z,
+            wrk, 8, iwrk, 2, &ier);
+    return ier == 0 ? z : NAN;
+}
+
+static void evaluate(int location, int num_splines,
+        const oskar_Splines* const* splines, const oskar_Mem* x,
+        const oskar_Mem* y, oskar_Mem** multi, oskar_Mem** single,
+        int* status)
+{
+    const int num_points = (int) oskar_mem_length(x);
+    oskar_Mem *x_ = oskar_mem_create_copy(x, location, status);
+    oskar_Mem *y_ = oskar_mem_create_copy(y, location, status);
+    oskar_Splines** s = (oskar_Splines**) calloc(num_splines, sizeof(void*));
+    oskar_Mem *out_multi = oskar_mem_create(OSKAR_DOUBLE, location,
+            num_points * num_splines, status);
+    oskar_Mem *out_single = oskar_mem_create(OSKAR_DOUBLE, location,
+            num_points * num_splines, status);
+    for (int k = 0; k < num_splines; ++k)
+    {
+        s[k] = oskar_splines_create(OSKAR_DOUBLE, location, status);
+        oskar_splines_copy(s[k], splines[k], status);
+    }
+
+    // Evaluate all surfaces together, and each surface separately.
+    oskar_splines_evaluate_multi(out_multi, 0, num_splines, num_splines,
+            s, num_points, x_, y_, status);
+    for (int k = 0; k < num_splines; ++k)
+        oskar_splines_evaluate(out_single, k, num_splines, s[k],
+                num_points, x_, y_, status);
+    *multi = oskar_mem_create_copy(out_multi, OSKAR_CPU, status);
+    *single = oskar_mem_create_copy(out_single, OSKAR_CPU, status);
+
+    // Clean up.
+    for (int k = 0; k < num_splines; ++k)
+        oskar_splines_free(s[k], status);
+    free(s);
+    oskar_mem_free(x_, status);
+    oskar_mem_free(y_, status);
+    oskar_mem_free(out_multi, status);
+    oskar_mem_free(out_single, status);
+}
+
+TEST(splines_evaluate_multi, compare_with_single)
+{
+    int status = 0;
+    const int num_points = 10000, num_splines = 6;
+    oskar_Splines* s[num_splines];
+
+    // Fit surfaces on different grids. Include a copy of the first one,
+    // so the basis functions are reused, and an empty surface, which must
+    // give zeros. The last two have the same number of knots, but the
+    // knots are in different places.
+    s[0] = fit(0, 30, 1.0, &status);
+    s[1] = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    oskar_splines_copy(s[1], s[0], &status);
+    s[2] = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    s[3] = fit(1, 25, 1.0, &status);
+    s[4] = fit(2, 20, 1.0, &status);
+    s[5] = fit(2, 20, 1.1, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_TRUE(oskar_splines_have_coeffs(s[0]));
+    ASSERT_FALSE(oskar_splines_have_coeffs(s[2]));
+    ASSERT_EQ(oskar_splines_num_knots_x_theta(s[4]),
+            oskar_splines_num_knots_x_theta(s[5]));
+    ASSERT_EQ(oskar_splines_num_knots_y_phi(s[4]),
+            oskar_splines_num_knots_y_phi(s[5]));
+
+    // Generate random points, some of which are outside the knot range.
+    oskar_Mem *x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_points, &status);
+    oskar_Mem *y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_points, &status);
+    double *x_ = oskar_mem_double(x, &status);
+    double *y_ = oskar_mem_double(y, &status);
+    srand(2017);
+    for (int i = 0; i < num_points; ++i)
+    {
+        x_[i] = 1.2 * rand() / (double) RAND_MAX - 0.1;
+        y_[i] = 1.2 * rand() / (double) RAND_MAX - 0.1;
+    }
+
+    // Evaluate on the CPU.
+    oskar_Mem *multi = 0, *single = 0;
+    evaluate(OSKAR_CPU, num_splines, s, x, y, &multi, &single, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double *m_ = oskar_mem_double_const(multi, &status);
+    const double *s_ = oskar_mem_double_const(single, &status);
+    for (int i = 0; i < num_points; ++i)
+    {
+        for (int k = 0; k < num_splines; ++k)
+        {
+            const int j = i * num_splines + k;
+            ASSERT_DOUBLE_EQ(s_[j], m_[j]);
+            if (k == 2)
+                ASSERT_EQ(0.0, m_[j]);
+            else
+                ASSERT_NEAR(bispev(s[k], x_[i], y_[i]), m_[j], 1e-12);
+        }
+        ASSERT_EQ(m_[i * num_splines], m_[i * num_splines + 1]);
+    }
+
+#ifdef OSKAR_HAVE_CUDA
+    // Evaluate on the GPU, and compare with the CPU.
+    oskar_Mem *multi_gpu = 0, *single_gpu = 0;
+    evaluate(OSKAR_GPU, num_splines, s, x, y, &multi_gpu, &single_gpu,
+            &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double *mg_ = oskar_mem_double_const(multi_gpu, &status);
+    const double *sg_ = oskar_mem_double_const(single_gpu, &status);
+    for (int i = 0; i < num_points * num_splines; ++i)
+    {
+        ASSERT_NEAR(m_[i], mg_[i], 1e-10);
+        ASSERT_NEAR(m_[i], sg_[i], 1e-10);
+    }
+    oskar_mem_free(multi_gpu, &status);
+    oskar_mem_free(single_gpu, &status);
+#endif
+
+#ifdef OSKAR_HAVE_OPENCL
+    // Evaluate with OpenCL, and compare with the CPU.
+    if (oskar_cl_num_devices() > 0)
+    {
+        oskar_Mem *multi_cl = 0, *single_cl = 0;
+        evaluate(OSKAR_CL, num_splines, s, x, y, &multi_cl, &single_cl,
+                &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        const double *mc_ = oskar_mem_double_const(multi_cl, &status);
+        const double *sc_ = oskar_mem_double_const(single_cl, &status);
+        for (int i = 0; i < num_points * num_splines; ++i)
+        {
+            ASSERT_NEAR(m_[i], mc_[i], 1e-10);
+            ASSERT_NEAR(m_[i], sc_[i], 1e-10);
+        }
+        oskar_mem_free(multi_cl, &status);
+        oskar_mem_free(single_cl, &status);
+    }
+#endif
+
+    // Clean up.
+    for (int k = 0; k < num_splines; ++k)
+        oskar_splines_free(s[k], &status);
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(multi, &status);
+    oskar_mem_free(single, &status);
+}
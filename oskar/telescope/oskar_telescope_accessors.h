@@ -315,6 +315,128 @@ int oskar_telescope_num_stations(const oskar_Telescope* model);
 OSKAR_EXPORT
 int oskar_telescope_identical_stations(const oskar_Telescope* model);
 
+/**
+ * @brief
+ * Returns the number of groups of identical stations.
+ *
+ * @details
+ * Returns the number of groups of identical stations in the telescope model.
+ *
+ * Note that this value is only valid after calling
+ * oskar_telescope_analyse().
+ *
+ * @param[in] model Pointer to telescope model.
+ *
+ * @return The number of groups of identical stations.
+ */
+OSKAR_EXPORT
+int oskar_telescope_num_station_types(const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the map of stations to groups of identical stations.
+ *
+ * @details
+ * Returns an integer array, in CPU memory, giving for each station the
+ * index of the first station in the telescope model identical to it.
+ * Stations which are the first of their group map to themselves.
+ *
+ * Note that this array is only valid after calling
+ * oskar_telescope_analyse(); otherwise it is empty.
+ *
+ * @param[in] model Pointer to telescope model.
+ *
+ * @return A handle to the station type map.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_telescope_station_type_map_const(
+        const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the number of groups of stations with similar horizons.
+ *
+ * @details
+ * Returns the number of groups of stations with similar horizons used by
+ * oskar_sky_horizon_clip().
+ *
+ * Stations are grouped by longitude and latitude so that all stations in
+ * a group lie within a small angle of the first one. The group radius
+ * starts at 1 degree, and is increased if needed to keep the number
+ * of groups no larger than 64.
+ *
+ * Note that this value is only valid after calling
+ * oskar_telescope_analyse().
+ *
+ * @param[in] model Pointer to telescope model.
+ *
+ * @return The number of horizon groups.
+ */
+OSKAR_EXPORT
+int oskar_telescope_num_horizon_groups(const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the start index of each horizon group.
+ *
+ * @details
+ * Returns an integer array, in the same location as the telescope model,
+ * giving the index of the first station of each horizon group in
+ * the array returned by oskar_telescope_horizon_group_station_const().
+ * A final entry holds the number of stations.
+ *
+ * Note that this array is only valid after calling
+ * oskar_telescope_analyse(); otherwise it is empty.
+ *
+ * @param[in] model Pointer to telescope model.
+ *
+ * @return A handle to the horizon group start indices.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_telescope_horizon_group_start_const(
+        const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the horizon margin of each horizon group.
+ *
+ * @details
+ * Returns an array, in the same precision and location as the telescope
+ * model, giving the sine of the largest angle between the local zenith of
+ * the first station in each horizon group and that of any other station
+ * in the group, plus a small tolerance.
+ *
+ * Note that this array is only valid after calling
+ * oskar_telescope_analyse(); otherwise it is empty.
+ *
+ * @param[in] model Pointer to telescope model.
+ *
+ * @return A handle to the horizon group margins.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_telescope_horizon_group_margin_const(
+        const oskar_Telescope* model);
+
+/**
+ * @brief
+ * Returns the station indices in horizon group order.
+ *
+ * @details
+ * Returns an integer array, in CPU memory, holding the index of each
+ * station in the telescope model, sorted by horizon group.
+ * The first station of each group comes first in the group.
+ *
+ * Note that this array is only valid after calling
+ * oskar_telescope_analyse(); otherwise it is empty.
+ *
+ * @param[in] model Pointer to telescope model.
+ *
+ * @return A handle to the station indices.
+ */
+OSKAR_EXPORT
+const oskar_Mem* oskar_telescope_horizon_group_station_const(
+        const oskar_Telescope* model);
+
 /**
  * @brief
  * Returns the flag specifying whether station beam duplication is enabled.
@@ -74,6 +74,12 @@ struct oskar_Telescope
     int max_station_size;                             /* Maximum station size (number of elements) */
     int max_station_depth;                            /* Maximum station depth. */
     int identical_stations;                           /* True if all stations are identical. */
+    int num_station_types;                            /* Number of groups of identical stations. */
+    oskar_Mem* station_type_map;                      /* Index of first identical station, for each station (CPU). */
+    int num_horizon_groups;                           /* Number of groups of stations with similar horizons. */
+    oskar_Mem* horizon_group_start;                   /* Index of first station in each horizon group, and number of stations. */
+    oskar_Mem* horizon_group_margin;                  /* Horizon margin of each group. */
+    oskar_Mem* horizon_group_station;                 /* Station indices, in horizon group order (CPU). */
     int allow_station_beam_duplication;               /* True if station beam duplication is allowed. */
     int enable_numerical_patterns;                    /* True if numerical element patterns are enabled. */
 };
@@ -134,6 +134,40 @@ int oskar_telescope_identical_stations(const oskar_Telescope* model)
     return model->identical_stations;
 }
 
+int oskar_telescope_num_station_types(const oskar_Telescope* model)
+{
+    return model->num_station_types;
+}
+
+const oskar_Mem* oskar_telescope_station_type_map_const(
+        const oskar_Telescope* model)
+{
+    return model->station_type_map;
+}
+
+int oskar_telescope_num_horizon_groups(const oskar_Telescope* model)
+{
+    return model->num_horizon_groups;
+}
+
+const oskar_Mem* oskar_telescope_horizon_group_start_const(
+        const oskar_Telescope* model)
+{
+    return model->horizon_group_start;
+}
+
+const oskar_Mem* oskar_telescope_horizon_group_margin_const(
+        const oskar_Telescope* model)
+{
+    return model->horizon_group_margin;
+}
+
+const oskar_Mem* oskar_telescope_horizon_group_station_const(
+        const oskar_Telescope* model)
+{
+    return model->horizon_group_station;
+}
+
 int oskar_telescope_allow_station_beam_duplication(
         const oskar_Telescope* model)
 {
@@ -31,11 +31,23 @@
 
 #include "telescope/station/oskar_station_analyse.h"
 #include "telescope/station/oskar_station_different.h"
+#include "math/oskar_cmath.h"
+
+#include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Initial angular radius of a horizon group, and maximum number of groups. */
+#define GROUP_RADIUS_RAD (1.0 * M_PI / 180.0)
+#define MAX_GROUPS 64
+
+/* Tolerance added to group margins to allow for rounding errors. */
+#define MARGIN_TOL 1e-5
+
+static void group_stations_by_horizon(oskar_Telescope* model, int* status);
+
 static void max_station_size_and_depth(const oskar_Station* s,
         int* max_elements, int* max_depth, int depth)
 {
@@ -78,7 +90,8 @@ static void set_child_station_locations(oskar_Station* s,
 
 void oskar_telescope_analyse(oskar_Telescope* model, int* status)
 {
-    int i = 0, finished_identical_station_check = 0, num_stations;
+    int i = 0, j = 0, finished_identical_station_check = 0, num_stations;
+    int* type_map;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -106,24 +119,161 @@ void oskar_telescope_analyse(oskar_Telescope* model, int* status)
     /* Check if safe to proceed. */
     if (*status) return;
 
-    /* Check if we need to examine every station. */
-    if (finished_identical_station_check)
+    /* Map each station to the first station identical to it. */
+    oskar_mem_realloc(model->station_type_map, num_stations, status);
+    type_map = oskar_mem_int(model->station_type_map, status);
+    if (*status) return;
+    model->num_station_types = 0;
+    for (i = 0; i < num_stations; ++i)
     {
-        model->identical_stations = 0;
+        type_map[i] = i;
+
+        /* Check if we need to examine every station. */
+        if (finished_identical_station_check)
+        {
+            model->num_station_types++;
+            continue;
+        }
+
+        /* Compare with the first station of each group found so far. */
+        for (j = 0; j < i; ++j)
+        {
+            if (type_map[j] == j && !oskar_station_different(
+                    oskar_telescope_station_const(model, j),
+                    oskar_telescope_station_const(model, i), status))
+            {
+                type_map[i] = j;
+                break;
+            }
+        }
+        if (type_map[i] == i)
+            model->num_station_types++;
     }
-    else
+    model->identical_stations = !finished_identical_station_check &&
+            model->num_station_types <= 1;
+
+    /* Group stations with similar horizons, for the horizon clip. */
+    group_stations_by_horizon(model, status);
+}
+
+
+/* Greedily assigns each station to the first group whose first station
+ * lies within the group radius on the sphere, doubling the radius if
+ * too many groups are needed. */
+static void group_stations_by_horizon(oskar_Telescope* model, int* status)
+{
+    int i, j, num_stations, num_groups = 0;
+    int *group, *group_start, *station_index;
+    double cos_radius, radius = GROUP_RADIUS_RAD, *group_radius, *v;
+    oskar_Mem *start, *margin;
+    if (*status) return;
+
+    /* Create scratch arrays in CPU memory. */
+    num_stations = model->num_stations;
+    start = oskar_mem_create(OSKAR_INT, OSKAR_CPU, num_stations + 1, status);
+    margin = oskar_mem_create(model->precision, OSKAR_CPU, num_stations,
+            status);
+    oskar_mem_realloc(model->horizon_group_station, num_stations, status);
+    group_start = oskar_mem_int(start, status);
+    station_index = oskar_mem_int(model->horizon_group_station, status);
+    v = (double*) malloc((3 * num_stations + 1) * sizeof(double));
+    group = (int*) malloc((2 * num_stations + 1) * sizeof(int));
+    group_radius = (double*) malloc((num_stations + 1) * sizeof(double));
+    if (*status)
+    {
+        oskar_mem_free(start, status);
+        oskar_mem_free(margin, status);
+        free(group_radius);
+        free(group);
+        free(v);
+        return;
+    }
+
+    /* Get Earth-fixed unit vector of each station's local zenith. */
+    for (i = 0; i < num_stations; ++i)
     {
-        /* Check if the stations are different. */
-        for (i = 1; i < num_stations; ++i)
+        double lon, lat;
+        const oskar_Station* s = oskar_telescope_station_const(model, i);
+        lon = oskar_station_lon_rad(s);
+        lat = oskar_station_lat_rad(s);
+        v[3 * i + 0] = cos(lat) * cos(lon);
+        v[3 * i + 1] = cos(lat) * sin(lon);
+        v[3 * i + 2] = sin(lat);
+    }
+
+    /* Assign stations to groups. group[num_stations + g] holds the
+     * first station in group g. */
+    while (num_stations > 0)
+    {
+        cos_radius = radius < M_PI ? cos(radius) : -2.0;
+        num_groups = 0;
+        for (i = 0; i < num_stations; ++i)
         {
-            if (oskar_station_different(oskar_telescope_station(model, 0),
-                    oskar_telescope_station(model, i), status))
+            const double* a = &v[3 * i];
+            for (j = 0; j < num_groups; ++j)
             {
-                model->identical_stations = 0;
-                break;
+                const double* b = &v[3 * group[num_stations + j]];
+                if (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] >= cos_radius)
+                    break;
+            }
+            if (j == num_groups)
+            {
+                if (num_groups == MAX_GROUPS) break;
+                group[num_stations + num_groups++] = i;
             }
+            group[i] = j;
         }
+        if (i == num_stations) break;
+        radius *= 2.0;
     }
+
+    /* Sort stations by group, keeping the first station of each group
+     * first, and find the largest angle between it and the others. */
+    for (j = 0; j <= num_groups; ++j) group_start[j] = 0;
+    for (i = 0; i < num_stations; ++i) group_start[group[i] + 1]++;
+    for (j = 0; j < num_groups; ++j)
+    {
+        group_start[j + 1] += group_start[j];
+        group_radius[j] = 0.0;
+    }
+    for (i = 0; i < num_stations; ++i)
+    {
+        double t;
+        const int g = group[i];
+        const double* a = &v[3 * i];
+        const double* b = &v[3 * group[num_stations + g]];
+        t = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        t = acos(t > 1.0 ? 1.0 : (t < -1.0 ? -1.0 : t));
+        if (t > group_radius[g]) group_radius[g] = t;
+        station_index[group_start[g]++] = i;
+    }
+    for (j = num_groups; j > 0; --j) group_start[j] = group_start[j - 1];
+    group_start[0] = 0;
+
+    /* A source further than (90 deg + radius) from the first station in
+     * a group is below the horizon of every station in the group, and one
+     * closer than (90 deg - radius) is above all their horizons. */
+    for (j = 0; j < num_groups; ++j)
+    {
+        double t = group_radius[j] < M_PI / 2.0 ? sin(group_radius[j]) : 1.0;
+        t += MARGIN_TOL;
+        if (model->precision == OSKAR_DOUBLE)
+            oskar_mem_double(margin, status)[j] = t;
+        else
+            oskar_mem_float(margin, status)[j] = (float) t;
+    }
+
+    /* Store the groups in the telescope model's memory location. */
+    oskar_mem_realloc(start, num_groups + 1, status);
+    oskar_mem_realloc(margin, num_groups, status);
+    oskar_mem_copy(model->horizon_group_start, start, status);
+    oskar_mem_copy(model->horizon_group_margin, margin, status);
+    model->num_horizon_groups = *status ? 0 : num_groups;
+    oskar_mem_free(start, status);
+    oskar_mem_free(margin, status);
+    free(group_radius);
+    free(group);
+    free(v);
 }
 
 #ifdef __cplusplus
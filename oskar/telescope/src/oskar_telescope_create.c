@@ -69,6 +69,8 @@ oskar_Telescope* oskar_telescope_create(int type, int location,
     telescope->max_station_size = 0;
     telescope->max_station_depth = 1;
     telescope->identical_stations = 0;
+    telescope->num_station_types = 0;
+    telescope->num_horizon_groups = 0;
     telescope->allow_station_beam_duplication = 0;
     telescope->enable_numerical_patterns = 1;
     telescope->lon_rad = 0.0;
@@ -112,6 +114,14 @@ oskar_Telescope* oskar_telescope_create(int type, int location,
             oskar_mem_create(type, location, num_stations, status);
     telescope->station_measured_z_enu_metres =
             oskar_mem_create(type, location, num_stations, status);
+    telescope->station_type_map =
+            oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
+    telescope->horizon_group_start =
+            oskar_mem_create(OSKAR_INT, location, 0, status);
+    telescope->horizon_group_margin =
+            oskar_mem_create(type, location, 0, status);
+    telescope->horizon_group_station =
+            oskar_mem_create(OSKAR_INT, OSKAR_CPU, 0, status);
 
     /* Initialise the station structures. */
     telescope->station = NULL;
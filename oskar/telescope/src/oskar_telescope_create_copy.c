@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2016, The University of Oxford
+ * Copyright (c) 2013-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -28,6 +28,8 @@
 
 #include "telescope/private_telescope.h"
 #include "telescope/oskar_telescope.h"
+#include "telescope/station/element/private_element.h"
+#include "telescope/station/element/private_element_lut.h"
 
 #include <stdlib.h>
 
@@ -35,6 +37,8 @@
 extern "C" {
 #endif
 
+static void forget_lut_copies(const oskar_Station* station);
+
 oskar_Telescope* oskar_telescope_create_copy(const oskar_Telescope* src,
         int location, int* status)
 {
@@ -55,6 +59,8 @@ oskar_Telescope* oskar_telescope_create_copy(const oskar_Telescope* src,
     telescope->max_station_size = src->max_station_size;
     telescope->max_station_depth = src->max_station_depth;
     telescope->identical_stations = src->identical_stations;
+    telescope->num_station_types = src->num_station_types;
+    telescope->num_horizon_groups = src->num_horizon_groups;
     telescope->allow_station_beam_duplication = src->allow_station_beam_duplication;
     telescope->enable_numerical_patterns = src->enable_numerical_patterns;
     telescope->lon_rad = src->lon_rad;
@@ -98,6 +104,14 @@ oskar_Telescope* oskar_telescope_create_copy(const oskar_Telescope* src,
             src->station_measured_y_enu_metres, status);
     oskar_mem_copy(telescope->station_measured_z_enu_metres,
             src->station_measured_z_enu_metres, status);
+    oskar_mem_copy(telescope->station_type_map, src->station_type_map,
+            status);
+    oskar_mem_copy(telescope->horizon_group_start, src->horizon_group_start,
+            status);
+    oskar_mem_copy(telescope->horizon_group_margin,
+            src->horizon_group_margin, status);
+    oskar_mem_copy(telescope->horizon_group_station,
+            src->horizon_group_station, status);
 
     /* Copy each station. */
     telescope->station = malloc(src->num_stations * sizeof(oskar_Station*));
@@ -107,10 +121,27 @@ oskar_Telescope* oskar_telescope_create_copy(const oskar_Telescope* src,
                 oskar_telescope_station_const(src, i), location, status);
     }
 
+    /* Element pattern tables shared between stations are now copied once.
+     * Make sure that a later copy does not use these tables. */
+    for (i = 0; i < src->num_stations; ++i)
+        forget_lut_copies(oskar_telescope_station_const(src, i));
+
     /* Return pointer to data structure. */
     return telescope;
 }
 
+static void forget_lut_copies(const oskar_Station* station)
+{
+    int i;
+    if (!station) return;
+    for (i = 0; i < oskar_station_num_element_types(station); ++i)
+        oskar_element_lut_forget_copy(
+                oskar_station_element_const(station, i)->lut);
+    if (oskar_station_has_child(station))
+        for (i = 0; i < oskar_station_num_elements(station); ++i)
+            forget_lut_copies(oskar_station_child_const(station, i));
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,10 @@ void oskar_telescope_free(oskar_Telescope* telescope, int* status)
     oskar_mem_free(telescope->station_measured_x_enu_metres, status);
     oskar_mem_free(telescope->station_measured_y_enu_metres, status);
     oskar_mem_free(telescope->station_measured_z_enu_metres, status);
+    oskar_mem_free(telescope->station_type_map, status);
+    oskar_mem_free(telescope->horizon_group_start, status);
+    oskar_mem_free(telescope->horizon_group_margin, status);
+    oskar_mem_free(telescope->horizon_group_station, status);
 
     /* Free each station. */
     for (i = 0; i < telescope->num_stations; ++i)
@@ -52,6 +52,8 @@ void oskar_telescope_log_summary(const oskar_Telescope* telescope,
             oskar_telescope_max_station_depth(telescope));
     oskar_log_value(log, 'M', 0, "Identical stations", "%s",
             oskar_telescope_identical_stations(telescope) ? "true" : "false");
+    oskar_log_value(log, 'M', 0, "Num. station types", "%d",
+            oskar_telescope_num_station_types(telescope));
 }
 
 #ifdef __cplusplus
@@ -108,6 +108,14 @@ void oskar_telescope_resize(oskar_Telescope* telescope, int size, int* status)
     oskar_mem_realloc(telescope->station_measured_z_enu_metres,
             size, status);
 
+    /* Station groups must be found again by oskar_telescope_analyse(). */
+    oskar_mem_realloc(telescope->station_type_map, 0, status);
+    oskar_mem_realloc(telescope->horizon_group_start, 0, status);
+    oskar_mem_realloc(telescope->horizon_group_margin, 0, status);
+    oskar_mem_realloc(telescope->horizon_group_station, 0, status);
+    telescope->num_station_types = 0;
+    telescope->num_horizon_groups = 0;
+
     /* Store the new size. */
     telescope->num_stations = size;
 }
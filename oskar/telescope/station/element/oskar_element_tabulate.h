@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_ELEMENT_TABULATE_H_
+#define OSKAR_ELEMENT_TABULATE_H_
+
+/**
+ * @file oskar_element_tabulate.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Tabulates fitted element pattern data on a regular (theta, phi) grid.
+ *
+ * @details
+ * This function evaluates the fitted spline surfaces at each frequency
+ * on a regular grid of (theta, phi) positions, spanning 0 to pi in theta
+ * and 0 to 2 pi in phi, with the given grid spacing.
+ * Subsequent calls to oskar_element_evaluate() will then use bilinear
+ * interpolation of these tables instead of evaluating the splines.
+ *
+ * The accuracy of the tables is checked by comparing the interpolated and
+ * spline values at the centre of every grid cell. The largest difference,
+ * as a fraction of the largest absolute value in the same table, is
+ * returned in \p max_error.
+ *
+ * If \p resolution_rad is not positive, any existing tables are removed.
+ *
+ * The element model must reside in CPU memory.
+ *
+ * @param[in,out] model       Element model structure.
+ * @param[in] resolution_rad  Grid spacing in theta and phi, in radians.
+ * @param[out] max_error      Maximum fractional interpolation error.
+ * @param[in,out] status      Status return code.
+ */
+OSKAR_EXPORT
+void oskar_element_tabulate(oskar_Element* model, double resolution_rad,
+        double* max_error, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_ELEMENT_TABULATE_H_ */
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_EVALUATE_ELEMENT_LUT_H_
+#define OSKAR_EVALUATE_ELEMENT_LUT_H_
+
+/**
+ * @file oskar_evaluate_element_lut.h
+ */
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates tabulated element patterns at source positions.
+ *
+ * @details
+ * This function uses bilinear interpolation to evaluate a set of element
+ * patterns that have been tabulated on a regular grid of (theta, phi)
+ * positions, spanning 0 to pi in theta and 0 to 2 pi in phi.
+ *
+ * The table holds \p num_surfaces real values at each grid node,
+ * with theta varying slowest. The value of surface \p k at point \p i is
+ * written to real element (offset + k + i * stride) of the output array,
+ * which may be real or complex.
+ *
+ * @param[out] output      Output values.
+ * @param[in] offset       Offset of the first surface into the output array.
+ * @param[in] stride       Output stride between points, in real elements.
+ * @param[in] num_surfaces Number of values at each table node.
+ * @param[in] table        Table of values.
+ * @param[in] num_theta    Number of grid nodes in theta.
+ * @param[in] num_phi      Number of grid nodes in phi.
+ * @param[in] num_points   Number of points.
+ * @param[in] theta        Point position (modified) theta values in rad.
+ * @param[in] phi          Point position (modified) phi values in rad.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_lut(oskar_Mem* output, int offset, int stride,
+        int num_surfaces, const oskar_Mem* table, int num_theta, int num_phi,
+        int num_points, const oskar_Mem* theta, const oskar_Mem* phi,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_EVALUATE_ELEMENT_LUT_H_ */
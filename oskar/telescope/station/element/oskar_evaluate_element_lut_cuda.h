@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_EVALUATE_ELEMENT_LUT_CUDA_H_
+#define OSKAR_EVALUATE_ELEMENT_LUT_CUDA_H_
+
+/**
+ * @file oskar_evaluate_element_lut_cuda.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates tabulated element patterns at source positions using CUDA
+ * (single precision).
+ *
+ * @details
+ * This function uses bilinear interpolation to evaluate a set of element
+ * patterns that have been tabulated on a regular grid of (theta, phi)
+ * positions.
+ *
+ * Note that all pointers refer to device memory.
+ *
+ * @param[in] num_points       Number of points.
+ * @param[in] d_theta          Point position (modified) theta values in rad.
+ * @param[in] d_phi            Point position (modified) phi values in rad.
+ * @param[in] num_surfaces     Number of values at each table node.
+ * @param[in] num_theta        Number of grid nodes in theta.
+ * @param[in] num_phi          Number of grid nodes in phi.
+ * @param[in] inv_delta_theta  Inverse of the grid spacing in theta, in 1/rad.
+ * @param[in] inv_delta_phi    Inverse of the grid spacing in phi, in 1/rad.
+ * @param[in] d_table          Table of values.
+ * @param[in] stride           Output stride between points.
+ * @param[out] d_out           Output values.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_lut_cuda_f(int num_points, const float* d_theta,
+        const float* d_phi, int num_surfaces, int num_theta, int num_phi,
+        float inv_delta_theta, float inv_delta_phi, const float* d_table,
+        int stride, float* d_out);
+
+/**
+ * @brief
+ * Evaluates tabulated element patterns at source positions using CUDA
+ * (double precision).
+ *
+ * @details
+ * This function uses bilinear interpolation to evaluate a set of element
+ * patterns that have been tabulated on a regular grid of (theta, phi)
+ * positions.
+ *
+ * Note that all pointers refer to device memory.
+ *
+ * @param[in] num_points       Number of points.
+ * @param[in] d_theta          Point position (modified) theta values in rad.
+ * @param[in] d_phi            Point position (modified) phi values in rad.
+ * @param[in] num_surfaces     Number of values at each table node.
+ * @param[in] num_theta        Number of grid nodes in theta.
+ * @param[in] num_phi          Number of grid nodes in phi.
+ * @param[in] inv_delta_theta  Inverse of the grid spacing in theta, in 1/rad.
+ * @param[in] inv_delta_phi    Inverse of the grid spacing in phi, in 1/rad.
+ * @param[in] d_table          Table of values.
+ * @param[in] stride           Output stride between points.
+ * @param[out] d_out           Output values.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_element_lut_cuda_d(int num_points, const double* d_theta,
+        const double* d_phi, int num_surfaces, int num_theta, int num_phi,
+        double inv_delta_theta, double inv_delta_phi, const double* d_table,
+        int stride, double* d_out);
+
+#ifdef __CUDACC__
+
+/* Kernels. */
+
+__global__
+void oskar_evaluate_element_lut_cudak_f(const int num_points,
+        const float* restrict theta, const float* restrict phi,
+        const int num_surfaces, const int num_theta, const int num_phi,
+        const float inv_delta_theta, const float inv_delta_phi,
+        const float* restrict table, const int stride, float* out);
+
+__global__
+void oskar_evaluate_element_lut_cudak_d(const int num_points,
+        const double* restrict theta, const double* restrict phi,
+        const int num_surfaces, const int num_theta, const int num_phi,
+        const double inv_delta_theta, const double inv_delta_phi,
+        const double* restrict table, const int stride, double* out);
+
+#endif /* __CUDACC__ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_EVALUATE_ELEMENT_LUT_CUDA_H_ */
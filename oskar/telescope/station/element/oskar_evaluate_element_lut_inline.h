@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_EVALUATE_ELEMENT_LUT_INLINE_H_
+#define OSKAR_EVALUATE_ELEMENT_LUT_INLINE_H_
+
+/**
+ * @file oskar_evaluate_element_lut_inline.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Interpolates a set of tabulated element patterns at one point
+ * (single precision).
+ *
+ * @details
+ * The table holds \p num_surfaces values at each node of a regular grid of
+ * (theta, phi) positions, with theta varying slowest. The grid starts at
+ * (0, 0) and the node spacing is given by the inverse of the
+ * \p inv_delta_theta and \p inv_delta_phi parameters.
+ * Positions outside the grid are clamped to its edges.
+ *
+ * @param[in] theta            Point position (modified) theta value in rad.
+ * @param[in] phi              Point position (modified) phi value in rad.
+ * @param[in] num_surfaces     Number of values at each table node.
+ * @param[in] num_theta        Number of grid nodes in theta.
+ * @param[in] num_phi          Number of grid nodes in phi.
+ * @param[in] inv_delta_theta  Inverse of the grid spacing in theta, in 1/rad.
+ * @param[in] inv_delta_phi    Inverse of the grid spacing in phi, in 1/rad.
+ * @param[in] table            Table of values.
+ * @param[out] out             Interpolated values, one per surface.
+ */
+OSKAR_INLINE
+void oskar_evaluate_element_lut_inline_f(const float theta, const float phi,
+        const int num_surfaces, const int num_theta, const int num_phi,
+        const float inv_delta_theta, const float inv_delta_phi,
+        const float* table, float* out)
+{
+    int i, j, k;
+    float ft, fp, w00, w01, w10, w11;
+    const float *t0, *t1;
+
+    /* Find the grid cell and the position within it. */
+    ft = theta * inv_delta_theta;
+    fp = phi * inv_delta_phi;
+    i = (int)ft;
+    j = (int)fp;
+    if (i > num_theta - 2) i = num_theta - 2;
+    if (i < 0) i = 0;
+    if (j > num_phi - 2) j = num_phi - 2;
+    if (j < 0) j = 0;
+    ft -= i;
+    fp -= j;
+    if (ft > 1.0f) ft = 1.0f;
+    if (ft < 0.0f) ft = 0.0f;
+    if (fp > 1.0f) fp = 1.0f;
+    if (fp < 0.0f) fp = 0.0f;
+
+    /* Bilinear interpolation of each surface. */
+    w00 = (1.0f - ft) * (1.0f - fp);
+    w01 = (1.0f - ft) * fp;
+    w10 = ft * (1.0f - fp);
+    w11 = ft * fp;
+    t0 = table + (i * num_phi + j) * num_surfaces;
+    t1 = t0 + num_phi * num_surfaces;
+    for (k = 0; k < num_surfaces; ++k)
+    {
+        out[k] = w00 * t0[k] + w01 * t0[k + num_surfaces] +
+                w10 * t1[k] + w11 * t1[k + num_surfaces];
+    }
+}
+
+/**
+ * @brief
+ * Interpolates a set of tabulated element patterns at one point
+ * (double precision).
+ *
+ * @details
+ * The table holds \p num_surfaces values at each node of a regular grid of
+ * (theta, phi) positions, with theta varying slowest. The grid starts at
+ * (0, 0) and the node spacing is given by the inverse of the
+ * \p inv_delta_theta and \p inv_delta_phi parameters.
+ * Positions outside the grid are clamped to its edges.
+ *
+ * @param[in] theta            Point position (modified) theta value in rad.
+ * @param[in] phi              Point position (modified) phi value in rad.
+ * @param[in] num_surfaces     Number of values at each table node.
+ * @param[in] num_theta        Number of grid nodes in theta.
+ * @param[in] num_phi          Number of grid nodes in phi.
+ * @param[in] inv_delta_theta  Inverse of the grid spacing in theta, in 1/rad.
+ * @param[in] inv_delta_phi    Inverse of the grid spacing in phi, in 1/rad.
+ * @param[in] table            Table of values.
+ * @param[out] out             Interpolated values, one per surface.
+ */
+OSKAR_INLINE
+void oskar_evaluate_element_lut_inline_d(const double theta, const double phi,
+        const int num_surfaces, const int num_theta, const int num_phi,
+        const double inv_delta_theta, const double inv_delta_phi,
+        const double* table, double* out)
+{
+    int i, j, k;
+    double ft, fp, w00, w01, w10, w11;
+    const double *t0, *t1;
+
+    /* Find the grid cell and the position within it. */
+    ft = theta * inv_delta_theta;
+    fp = phi * inv_delta_phi;
+    i = (int)ft;
+    j = (int)fp;
+    if (i > num_theta - 2) i = num_theta - 2;
+    if (i < 0) i = 0;
+    if (j > num_phi - 2) j = num_phi - 2;
+    if (j < 0) j = 0;
+    ft -= i;
+    fp -= j;
+    if (ft > 1.0) ft = 1.0;
+    if (ft < 0.0) ft = 0.0;
+    if (fp > 1.0) fp = 1.0;
+    if (fp < 0.0) fp = 0.0;
+
+    /* Bilinear interpolation of each surface. */
+    w00 = (1.0 - ft) * (1.0 - fp);
+    w01 = (1.0 - ft) * fp;
+    w10 = ft * (1.0 - fp);
+    w11 = ft * fp;
+    t0 = table + (i * num_phi + j) * num_surfaces;
+    t1 = t0 + num_phi * num_surfaces;
+    for (k = 0; k < num_surfaces; ++k)
+    {
+        out[k] = w00 * t0[k] + w01 * t0[k + num_surfaces] +
+                w10 * t1[k] + w11 * t1[k + num_surfaces];
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_EVALUATE_ELEMENT_LUT_INLINE_H_ */
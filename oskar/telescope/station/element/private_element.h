@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2016, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -32,6 +32,35 @@
 #include <splines/oskar_splines.h>
 #include <mem/oskar_mem.h>
 
+/* Look-up tables of the fitted data, per frequency.
+ * Each table holds all the surfaces for one port at each node of a
+ * regular (theta, phi) grid, and is empty if there is no fitted data.
+ * The tables are reference-counted so that identical elements, and their
+ * copies in the same memory location, can share them. They must not be
+ * modified once made. */
+struct oskar_ElementLUT
+{
+    int ref_count;
+    int precision;
+    int mem_location;
+    int num_freq;
+    int num_theta;
+    int num_phi;
+    oskar_Mem** x;
+    oskar_Mem** y;
+    oskar_Mem** scalar;
+
+    /* Most recent copy in other memory, and the tables it was copied from.
+     * These are not references, and are cleared when either is freed. */
+    struct oskar_ElementLUT* copy;
+    struct oskar_ElementLUT* origin;
+};
+
+#ifndef OSKAR_ELEMENT_LUT_TYPEDEF_
+#define OSKAR_ELEMENT_LUT_TYPEDEF_
+typedef struct oskar_ElementLUT oskar_ElementLUT;
+#endif /* OSKAR_ELEMENT_LUT_TYPEDEF_ */
+
 struct oskar_Element
 {
     int precision;
@@ -79,6 +108,9 @@ struct oskar_Element
     oskar_Splines** y_v_im;
     oskar_Splines** scalar_re;
     oskar_Splines** scalar_im;
+
+    /* Optional look-up tables of the fitted data (NULL if not tabulated). */
+    oskar_ElementLUT* lut;
 };
 
 #ifndef OSKAR_ELEMENT_TYPEDEF_
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_PRIVATE_ELEMENT_LUT_H_
+#define OSKAR_PRIVATE_ELEMENT_LUT_H_
+
+/**
+ * @file private_element_lut.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/station/element/private_element.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Creates a set of empty element pattern look-up tables.
+ *
+ * @details
+ * Creates tables for the given number of frequencies and grid size,
+ * with a reference count of one. Each table is initially empty.
+ *
+ * @param[in] precision    Enumerated precision of the tables.
+ * @param[in] location     Enumerated memory location of the tables.
+ * @param[in] num_freq     Number of frequencies.
+ * @param[in] num_theta    Number of grid nodes in theta.
+ * @param[in] num_phi      Number of grid nodes in phi.
+ * @param[in,out] status   Status return code.
+ */
+oskar_ElementLUT* oskar_element_lut_create(int precision, int location,
+        int num_freq, int num_theta, int num_phi, int* status);
+
+/**
+ * @brief
+ * Returns a reference to a copy of element pattern look-up tables.
+ *
+ * @details
+ * If the tables are already in the required memory location, they are not
+ * copied, and a new reference to them is returned instead.
+ *
+ * Otherwise, the most recent copy made in that location is reused, if it
+ * still exists, so that tables shared by identical elements are only copied
+ * once when a telescope model is copied. Call
+ * oskar_element_lut_forget_copy() once the copy is complete, so that it is
+ * not reused by a later copy (perhaps on a different device).
+ *
+ * @param[in] src          Tables to copy.
+ * @param[in] location     Enumerated memory location of the copy.
+ * @param[in,out] status   Status return code.
+ */
+oskar_ElementLUT* oskar_element_lut_copy(oskar_ElementLUT* src, int location,
+        int* status);
+
+/**
+ * @brief
+ * Forgets the most recent copy of element pattern look-up tables.
+ *
+ * @param[in] lut          Tables that were copied (may be NULL).
+ */
+void oskar_element_lut_forget_copy(oskar_ElementLUT* lut);
+
+/**
+ * @brief
+ * Releases a reference to element pattern look-up tables.
+ *
+ * @details
+ * The tables are freed when the last reference to them is released.
+ *
+ * @param[in] lut          Tables to release (may be NULL).
+ * @param[in,out] status   Status return code.
+ */
+void oskar_element_lut_release(oskar_ElementLUT* lut, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_PRIVATE_ELEMENT_LUT_H_ */
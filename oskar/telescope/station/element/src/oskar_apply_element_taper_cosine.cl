@@ -0,0 +1,19 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void taper_cosine_scalar_REAL(const int num_sources,
+        const REAL cos_power, global const REAL* restrict theta,
+        global REAL2* restrict jones)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    jones[i] *= pow(cos(theta[i]), cos_power);
+}
+
+kernel void taper_cosine_matrix_REAL(const int num_sources,
+        const REAL cos_power, global const REAL* restrict theta,
+        global REAL8* restrict jones)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    jones[i] *= pow(cos(theta[i]), cos_power);
+}
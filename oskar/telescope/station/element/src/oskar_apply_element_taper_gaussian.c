@@ -28,6 +28,7 @@
 
 #include "telescope/station/element/oskar_apply_element_taper_gaussian.h"
 #include "telescope/station/element/oskar_apply_element_taper_gaussian_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 #include <math.h>
 
@@ -153,7 +154,70 @@ void oskar_apply_element_taper_gaussian(oskar_Mem* jones, int num_sources,
     }
 
     /* Check precision. */
-    if (precision == OSKAR_SINGLE)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const int is_dbl = (precision == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_sources + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_SINGLE_COMPLEX || type == OSKAR_DOUBLE_COMPLEX)
+            k = is_dbl ? oskar_cl_kernel("taper_gaussian_scalar_double") :
+                    oskar_cl_kernel("taper_gaussian_scalar_float");
+        else if (type == OSKAR_SINGLE_COMPLEX_MATRIX ||
+                type == OSKAR_DOUBLE_COMPLEX_MATRIX)
+            k = is_dbl ? oskar_cl_kernel("taper_gaussian_matrix_double") :
+                    oskar_cl_kernel("taper_gaussian_matrix_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_sources;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        if (is_dbl)
+        {
+            const cl_double inv_2sigma_sq = M_4LN2 / (fwhm * fwhm);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double),
+                    &inv_2sigma_sq);
+        }
+        else
+        {
+            const cl_float inv_2sigma_sq = (cl_float)
+                    (M_4LN2 / (fwhm * fwhm));
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float),
+                    &inv_2sigma_sq);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(theta, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(jones, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_sources > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (precision == OSKAR_SINGLE)
     {
         const float* theta_;
         theta_ = oskar_mem_float_const(theta, status);
@@ -0,0 +1,21 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void taper_gaussian_scalar_REAL(const int num_sources,
+        const REAL inv_2sigma_sq, global const REAL* restrict theta,
+        global REAL2* restrict jones)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    const REAL theta_sq = theta[i] * theta[i];
+    jones[i] *= exp(-theta_sq * inv_2sigma_sq);
+}
+
+kernel void taper_gaussian_matrix_REAL(const int num_sources,
+        const REAL inv_2sigma_sq, global const REAL* restrict theta,
+        global REAL8* restrict jones)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    const REAL theta_sq = theta[i] * theta[i];
+    jones[i] *= exp(-theta_sq * inv_2sigma_sq);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -27,6 +27,7 @@
  */
 
 #include "telescope/station/element/private_element.h"
+#include "telescope/station/element/private_element_lut.h"
 #include "telescope/station/element/oskar_element.h"
 
 #ifdef __cplusplus
@@ -48,6 +49,22 @@ void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
     dst->gaussian_fwhm_rad = src->gaussian_fwhm_rad;
     dst->dipole_length = src->dipole_length;
     dst->dipole_length_units = src->dipole_length_units;
+    dst->x_element_type = src->x_element_type;
+    dst->y_element_type = src->y_element_type;
+    dst->x_taper_type = src->x_taper_type;
+    dst->y_taper_type = src->y_taper_type;
+    dst->x_dipole_length_units = src->x_dipole_length_units;
+    dst->y_dipole_length_units = src->y_dipole_length_units;
+    dst->x_dipole_length = src->x_dipole_length;
+    dst->y_dipole_length = src->y_dipole_length;
+    dst->x_taper_cosine_power = src->x_taper_cosine_power;
+    dst->y_taper_cosine_power = src->y_taper_cosine_power;
+    dst->x_taper_gaussian_fwhm_rad = src->x_taper_gaussian_fwhm_rad;
+    dst->y_taper_gaussian_fwhm_rad = src->y_taper_gaussian_fwhm_rad;
+    dst->x_taper_ref_freq_hz = src->x_taper_ref_freq_hz;
+    dst->y_taper_ref_freq_hz = src->y_taper_ref_freq_hz;
+    dst->coord_sys = src->coord_sys;
+    dst->max_radius_rad = src->max_radius_rad;
 
     /* Resize the arrays. */
     oskar_element_resize_freq_data(dst, src->num_freq, status);
@@ -70,6 +87,10 @@ void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
         oskar_splines_copy(dst->scalar_re[i], src->scalar_re[i], status);
         oskar_splines_copy(dst->scalar_im[i], src->scalar_im[i], status);
     }
+
+    /* Share or copy the look-up tables. */
+    oskar_element_lut_release(dst->lut, status);
+    dst->lut = oskar_element_lut_copy(src->lut, dst->mem_location, status);
 }
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -54,6 +54,16 @@ oskar_Element* oskar_element_create(int precision, int location, int* status)
     data->dipole_length_units = OSKAR_WAVELENGTHS;
     data->cosine_power = 0.0;
     data->gaussian_fwhm_rad = 0.0;
+    data->x_element_type = data->y_element_type = data->element_type;
+    data->x_taper_type = data->y_taper_type = data->taper_type;
+    data->x_dipole_length = data->y_dipole_length = data->dipole_length;
+    data->x_dipole_length_units = data->y_dipole_length_units =
+            data->dipole_length_units;
+    data->x_taper_cosine_power = data->y_taper_cosine_power = 0.0;
+    data->x_taper_gaussian_fwhm_rad = data->y_taper_gaussian_fwhm_rad = 0.0;
+    data->x_taper_ref_freq_hz = data->y_taper_ref_freq_hz = 0.0;
+    data->coord_sys = 0;
+    data->max_radius_rad = 0.0;
 
     /* Check type. */
     if (precision != OSKAR_SINGLE && precision != OSKAR_DOUBLE)
@@ -75,6 +85,7 @@ oskar_Element* oskar_element_create(int precision, int location, int* status)
     data->y_v_im = 0;
     data->scalar_re = 0;
     data->scalar_im = 0;
+    data->lut = 0;
 
     /* Return pointer to the structure. */
     return data;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -32,6 +32,7 @@
 #include "telescope/station/element/oskar_apply_element_taper_cosine.h"
 #include "telescope/station/element/oskar_apply_element_taper_gaussian.h"
 #include "telescope/station/element/oskar_evaluate_dipole_pattern.h"
+#include "telescope/station/element/oskar_evaluate_element_lut.h"
 #include "telescope/station/element/oskar_evaluate_geometric_dipole_pattern.h"
 #include "convert/oskar_convert_enu_directions_to_theta_phi.h"
 #include "convert/oskar_convert_ludwig3_to_theta_phi_components.h"
@@ -52,6 +53,7 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
 {
     int element_type, taper_type, freq_id;
     double dipole_length_m;
+    const oskar_Splines* splines[4];
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -100,14 +102,19 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
                     oskar_element_freqs_hz_const(model));
 
             /* Evaluate spline pattern for dipole X. */
-            oskar_splines_evaluate(output, 0, 8, model->x_h_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 1, 8, model->x_h_im[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 2, 8, model->x_v_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 3, 8, model->x_v_im[freq_id],
-                    num_points, theta, phi, status);
+            if (model->lut && oskar_mem_length(model->lut->x[freq_id]) > 0)
+                oskar_evaluate_element_lut(output, 0, 8, 4,
+                        model->lut->x[freq_id], model->lut->num_theta,
+                        model->lut->num_phi, num_points, theta, phi, status);
+            else
+            {
+                splines[0] = model->x_h_re[freq_id];
+                splines[1] = model->x_h_im[freq_id];
+                splines[2] = model->x_v_re[freq_id];
+                splines[3] = model->x_v_im[freq_id];
+                oskar_splines_evaluate_multi(output, 0, 8, 4, splines,
+                        num_points, theta, phi, status);
+            }
 
             /* Convert from Ludwig-3 to spherical representation. */
             oskar_convert_ludwig3_to_theta_phi_components(output, 0, 4,
@@ -139,14 +146,19 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
                     oskar_element_freqs_hz_const(model));
 
             /* Evaluate spline pattern for dipole Y. */
-            oskar_splines_evaluate(output, 4, 8, model->y_h_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 5, 8, model->y_h_im[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 6, 8, model->y_v_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 7, 8, model->y_v_im[freq_id],
-                    num_points, theta, phi, status);
+            if (model->lut && oskar_mem_length(model->lut->y[freq_id]) > 0)
+                oskar_evaluate_element_lut(output, 4, 8, 4,
+                        model->lut->y[freq_id], model->lut->num_theta,
+                        model->lut->num_phi, num_points, theta, phi, status);
+            else
+            {
+                splines[0] = model->y_h_re[freq_id];
+                splines[1] = model->y_h_im[freq_id];
+                splines[2] = model->y_v_re[freq_id];
+                splines[3] = model->y_v_im[freq_id];
+                oskar_splines_evaluate_multi(output, 4, 8, 4, splines,
+                        num_points, theta, phi, status);
+            }
 
             /* Convert from Ludwig-3 to spherical representation. */
             oskar_convert_ludwig3_to_theta_phi_components(output, 2, 4,
@@ -177,10 +189,17 @@ void oskar_element_evaluate(const oskar_Element* model, oskar_Mem* output,
                     oskar_element_num_freq(model),
                     oskar_element_freqs_hz_const(model));
 
-            oskar_splines_evaluate(output, 0, 2, model->scalar_re[freq_id],
-                    num_points, theta, phi, status);
-            oskar_splines_evaluate(output, 1, 2, model->scalar_im[freq_id],
-                    num_points, theta, phi, status);
+            if (model->lut && oskar_mem_length(model->lut->scalar[freq_id]) > 0)
+                oskar_evaluate_element_lut(output, 0, 2, 2,
+                        model->lut->scalar[freq_id], model->lut->num_theta,
+                        model->lut->num_phi, num_points, theta, phi, status);
+            else
+            {
+                splines[0] = model->scalar_re[freq_id];
+                splines[1] = model->scalar_im[freq_id];
+                oskar_splines_evaluate_multi(output, 0, 2, 2, splines,
+                        num_points, theta, phi, status);
+            }
         }
         else if (element_type == OSKAR_ELEMENT_TYPE_DIPOLE)
         {
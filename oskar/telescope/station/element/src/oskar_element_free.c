@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -27,6 +27,7 @@
  */
 
 #include "telescope/station/element/private_element.h"
+#include "telescope/station/element/private_element_lut.h"
 #include "telescope/station/element/oskar_element.h"
 
 #ifdef __cplusplus
@@ -69,6 +70,7 @@ void oskar_element_free(oskar_Element* data, int* status)
     free(data->y_v_im);
     free(data->scalar_re);
     free(data->scalar_im);
+    oskar_element_lut_release(data->lut, status);
 
     /* Free the structure itself. */
     free(data);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, The University of Oxford
+ * Copyright (c) 2014-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -27,6 +27,7 @@
  */
 
 #include "telescope/station/element/private_element.h"
+#include "telescope/station/element/private_element_lut.h"
 #include "telescope/station/element/oskar_element.h"
 
 #ifdef __cplusplus
@@ -99,8 +100,10 @@ void oskar_element_resize_freq_data(oskar_Element* model, int size,
         return;
     }
 
-    /* Store the new size. */
+    /* Store the new size. Any look-up tables no longer match the data. */
     model->num_freq = size;
+    oskar_element_lut_release(model->lut, status);
+    model->lut = 0;
 }
 
 static void realloc_arrays(oskar_Element* e, int size, int* status)
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/private_element.h"
+#include "telescope/station/element/private_element_lut.h"
+#include "telescope/station/element/oskar_element.h"
+#include "telescope/station/element/oskar_evaluate_element_lut.h"
+
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void tabulate(oskar_Mem* lut, int num_splines,
+        const oskar_Splines* const* splines, int num_theta, int num_phi,
+        const oskar_Mem* theta_nodes, const oskar_Mem* phi_nodes,
+        const oskar_Mem* theta_cells, const oskar_Mem* phi_cells,
+        oskar_Mem* ref, oskar_Mem* test, double* max_error, int* status);
+
+void oskar_element_tabulate(oskar_Element* model, double resolution_rad,
+        double* max_error, int* status)
+{
+    int i, j, num_theta, num_phi, num_nodes, num_cells, type;
+    oskar_Mem *theta_nodes, *phi_nodes, *theta_cells, *phi_cells, *ref, *test;
+    oskar_ElementLUT* lut;
+    const oskar_Splines* splines[4];
+
+    /* Check if safe to proceed. */
+    *max_error = 0.0;
+    if (*status) return;
+
+    /* Check location. */
+    if (model->mem_location != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+
+    /* Remove existing tables if required. */
+    if (resolution_rad <= 0.0)
+    {
+        oskar_element_lut_release(model->lut, status);
+        model->lut = 0;
+        return;
+    }
+
+    /* Get the grid size. */
+    num_theta = (int)ceil(M_PI / resolution_rad) + 1;
+    num_phi = (int)ceil(2.0 * M_PI / resolution_rad) + 1;
+    num_nodes = num_theta * num_phi;
+    num_cells = (num_theta - 1) * (num_phi - 1);
+
+    /* Get coordinates of the grid nodes and the cell centres. */
+    type = model->precision;
+    theta_nodes = oskar_mem_create(type, OSKAR_CPU, num_nodes, status);
+    phi_nodes = oskar_mem_create(type, OSKAR_CPU, num_nodes, status);
+    theta_cells = oskar_mem_create(type, OSKAR_CPU, num_cells, status);
+    phi_cells = oskar_mem_create(type, OSKAR_CPU, num_cells, status);
+    ref = oskar_mem_create(type, OSKAR_CPU, 4 * num_cells, status);
+    test = oskar_mem_create(type, OSKAR_CPU, 4 * num_cells, status);
+    for (i = 0; i < num_theta && !*status; ++i)
+    {
+        const double t = i * M_PI / (num_theta - 1);
+        for (j = 0; j < num_phi; ++j)
+        {
+            const double p = j * 2.0 * M_PI / (num_phi - 1);
+            oskar_mem_set_element_real(theta_nodes, i * num_phi + j, t, status);
+            oskar_mem_set_element_real(phi_nodes, i * num_phi + j, p, status);
+            if (i == num_theta - 1 || j == num_phi - 1) continue;
+            oskar_mem_set_element_real(theta_cells, i * (num_phi - 1) + j,
+                    t + 0.5 * M_PI / (num_theta - 1), status);
+            oskar_mem_set_element_real(phi_cells, i * (num_phi - 1) + j,
+                    p + M_PI / (num_phi - 1), status);
+        }
+    }
+    lut = oskar_element_lut_create(type, OSKAR_CPU, model->num_freq,
+            num_theta, num_phi, status);
+
+    /* Tabulate the fitted data at each frequency. */
+    for (i = 0; i < model->num_freq; ++i)
+    {
+        splines[0] = model->x_h_re[i];
+        splines[1] = model->x_h_im[i];
+        splines[2] = model->x_v_re[i];
+        splines[3] = model->x_v_im[i];
+        tabulate(lut->x[i], 4, splines, num_theta, num_phi,
+                theta_nodes, phi_nodes, theta_cells, phi_cells, ref, test,
+                max_error, status);
+        splines[0] = model->y_h_re[i];
+        splines[1] = model->y_h_im[i];
+        splines[2] = model->y_v_re[i];
+        splines[3] = model->y_v_im[i];
+        tabulate(lut->y[i], 4, splines, num_theta, num_phi,
+                theta_nodes, phi_nodes, theta_cells, phi_cells, ref, test,
+                max_error, status);
+        splines[0] = model->scalar_re[i];
+        splines[1] = model->scalar_im[i];
+        tabulate(lut->scalar[i], 2, splines, num_theta, num_phi,
+                theta_nodes, phi_nodes, theta_cells, phi_cells, ref, test,
+                max_error, status);
+    }
+
+    /* Replace any existing tables, which may be shared with other elements. */
+    if (!*status)
+    {
+        oskar_element_lut_release(model->lut, status);
+        model->lut = lut;
+    }
+    else
+        oskar_element_lut_release(lut, status);
+
+    /* Free scratch arrays. */
+    oskar_mem_free(theta_nodes, status);
+    oskar_mem_free(phi_nodes, status);
+    oskar_mem_free(theta_cells, status);
+    oskar_mem_free(phi_cells, status);
+    oskar_mem_free(ref, status);
+    oskar_mem_free(test, status);
+}
+
+static void tabulate(oskar_Mem* lut, int num_splines,
+        const oskar_Splines* const* splines, int num_theta, int num_phi,
+        const oskar_Mem* theta_nodes, const oskar_Mem* phi_nodes,
+        const oskar_Mem* theta_cells, const oskar_Mem* phi_cells,
+        oskar_Mem* ref, oskar_Mem* test, double* max_error, int* status)
+{
+    int i, have_data = 0;
+    size_t k, num_values;
+    double peak = 0.0, max_diff = 0.0;
+    if (*status) return;
+
+    /* Leave the table empty if there is no fitted data. */
+    for (i = 0; i < num_splines; ++i)
+        if (oskar_splines_num_knots_x_theta(splines[i]) > 0) have_data = 1;
+    if (!have_data)
+    {
+        oskar_mem_realloc(lut, 0, status);
+        return;
+    }
+
+    /* Evaluate the splines at the grid nodes. */
+    oskar_mem_realloc(lut, num_splines * num_theta * num_phi, status);
+    oskar_splines_evaluate_multi(lut, 0, num_splines, num_splines, splines,
+            num_theta * num_phi, theta_nodes, phi_nodes, status);
+
+    /* Compare splines and table at the cell centres. */
+    num_values = num_splines * (num_theta - 1) * (num_phi - 1);
+    oskar_splines_evaluate_multi(ref, 0, num_splines, num_splines, splines,
+            (num_theta - 1) * (num_phi - 1), theta_cells, phi_cells, status);
+    oskar_evaluate_element_lut(test, 0, num_splines, num_splines, lut,
+            num_theta, num_phi, (num_theta - 1) * (num_phi - 1),
+            theta_cells, phi_cells, status);
+    if (*status) return;
+    if (oskar_mem_precision(lut) == OSKAR_DOUBLE)
+    {
+        const double *t, *r, *l;
+        t = oskar_mem_double_const(test, status);
+        r = oskar_mem_double_const(ref, status);
+        l = oskar_mem_double_const(lut, status);
+        for (k = 0; k < oskar_mem_length(lut); ++k)
+            if (fabs(l[k]) > peak) peak = fabs(l[k]);
+        for (k = 0; k < num_values; ++k)
+            if (fabs(t[k] - r[k]) > max_diff) max_diff = fabs(t[k] - r[k]);
+    }
+    else
+    {
+        const float *t, *r, *l;
+        t = oskar_mem_float_const(test, status);
+        r = oskar_mem_float_const(ref, status);
+        l = oskar_mem_float_const(lut, status);
+        for (k = 0; k < oskar_mem_length(lut); ++k)
+            if (fabs(l[k]) > peak) peak = fabs(l[k]);
+        for (k = 0; k < num_values; ++k)
+            if (fabs(t[k] - r[k]) > max_diff) max_diff = fabs(t[k] - r[k]);
+    }
+    if (peak > 0.0 && max_diff / peak > *max_error)
+        *max_error = max_diff / peak;
+}
+
+#ifdef __cplusplus
+}
+#endif
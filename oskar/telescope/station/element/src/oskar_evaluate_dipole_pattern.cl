@@ -0,0 +1,47 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+// Returns the real parts of (E_theta, E_phi) for a dipole along x.
+inline REAL2 dipole_pattern_REAL(const REAL theta, const REAL phi,
+        const REAL kL, const REAL cos_kL)
+{
+    REAL sin_theta, cos_theta, sin_phi, cos_phi;
+    sin_theta = sincos(theta, &cos_theta);
+    sin_phi = sincos(phi, &cos_phi);
+    const REAL denom = (REAL) 1. +
+            cos_phi * cos_phi * (cos_theta * cos_theta - (REAL) 1.);
+    if (denom == (REAL) 0.) return (REAL2)(0., 0.);
+    const REAL t = (cos(kL * cos_phi * sin_theta) - cos_kL) / denom;
+    return (REAL2)(-cos_phi * cos_theta * t, sin_phi * t);
+}
+
+kernel void dipole_REAL(const int num_points,
+        global const REAL* restrict theta,
+        global const REAL* restrict phi,
+        const REAL kL, const REAL cos_kL,
+        const int stride, const int offset,
+        global REAL2* restrict pattern)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    const REAL2 e = dipole_pattern_REAL(theta[i], phi[i], kL, cos_kL);
+    const int i_out = offset + i * stride;
+    pattern[i_out] = (REAL2)(e.x, 0.);
+    pattern[i_out + 1] = (REAL2)(e.y, 0.);
+}
+
+kernel void dipole_scalar_REAL(const int num_points,
+        global const REAL* restrict theta,
+        global const REAL* restrict phi,
+        const REAL kL, const REAL cos_kL,
+        const int stride, const int offset,
+        global REAL2* restrict pattern)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    const REAL theta_ = theta[i], phi_ = phi[i];
+    const REAL2 x = dipole_pattern_REAL(theta_, phi_, kL, cos_kL);
+    const REAL2 y = dipole_pattern_REAL(theta_,
+            phi_ + (REAL) 1.57079632679489661923, kL, cos_kL);
+    const REAL amp = sqrt((REAL) 0.5 * (dot(x, x) + dot(y, y)));
+    pattern[offset + i * stride] = (REAL2)(amp, 0.);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/oskar_evaluate_element_lut.h"
+#include "telescope/station/element/oskar_evaluate_element_lut_cuda.h"
+#include "telescope/station/element/oskar_evaluate_element_lut_inline.h"
+#include "utility/oskar_cl_utils.h"
+#include "utility/oskar_device_utils.h"
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_evaluate_element_lut(oskar_Mem* output, int offset, int stride,
+        int num_surfaces, const oskar_Mem* table, int num_theta, int num_phi,
+        int num_points, const oskar_Mem* theta, const oskar_Mem* phi,
+        int* status)
+{
+    int i, precision, location;
+    double inv_delta_theta, inv_delta_phi;
+
+    /* Check if safe to proceed. */
+    if (*status) return;
+
+    /* Check that all arrays are co-located. */
+    location = oskar_mem_location(output);
+    if (oskar_mem_location(table) != location ||
+            oskar_mem_location(theta) != location ||
+            oskar_mem_location(phi) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+
+    /* Check that the types match. */
+    precision = oskar_mem_precision(output);
+    if (oskar_mem_type(table) != precision ||
+            oskar_mem_type(theta) != precision ||
+            oskar_mem_type(phi) != precision)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* Check the table dimensions. */
+    if (num_theta < 2 || num_phi < 2 || (int)oskar_mem_length(table) <
+            num_theta * num_phi * num_surfaces)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    inv_delta_theta = (num_theta - 1) / M_PI;
+    inv_delta_phi = (num_phi - 1) / (2.0 * M_PI);
+
+    if (location == OSKAR_CPU)
+    {
+        if (precision == OSKAR_SINGLE)
+        {
+            const float *theta_, *phi_, *table_;
+            float* out;
+            theta_ = oskar_mem_float_const(theta, status);
+            phi_   = oskar_mem_float_const(phi, status);
+            table_ = oskar_mem_float_const(table, status);
+            out    = oskar_mem_float(output, status) + offset;
+#pragma omp parallel for
+            for (i = 0; i < num_points; ++i)
+                oskar_evaluate_element_lut_inline_f(theta_[i], phi_[i],
+                        num_surfaces, num_theta, num_phi,
+                        (float)inv_delta_theta, (float)inv_delta_phi,
+                        table_, out + i * stride);
+        }
+        else if (precision == OSKAR_DOUBLE)
+        {
+            const double *theta_, *phi_, *table_;
+            double* out;
+            theta_ = oskar_mem_double_const(theta, status);
+            phi_   = oskar_mem_double_const(phi, status);
+            table_ = oskar_mem_double_const(table, status);
+            out    = oskar_mem_double(output, status) + offset;
+#pragma omp parallel for
+            for (i = 0; i < num_points; ++i)
+                oskar_evaluate_element_lut_inline_d(theta_[i], phi_[i],
+                        num_surfaces, num_theta, num_phi,
+                        inv_delta_theta, inv_delta_phi,
+                        table_, out + i * stride);
+        }
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+    }
+    else if (location == OSKAR_GPU)
+    {
+#ifdef OSKAR_HAVE_CUDA
+        if (precision == OSKAR_SINGLE)
+            oskar_evaluate_element_lut_cuda_f(num_points,
+                    oskar_mem_float_const(theta, status),
+                    oskar_mem_float_const(phi, status), num_surfaces,
+                    num_theta, num_phi, (float)inv_delta_theta,
+                    (float)inv_delta_phi, oskar_mem_float_const(table, status),
+                    stride, oskar_mem_float(output, status) + offset);
+        else if (precision == OSKAR_DOUBLE)
+            oskar_evaluate_element_lut_cuda_d(num_points,
+                    oskar_mem_double_const(theta, status),
+                    oskar_mem_double_const(phi, status), num_surfaces,
+                    num_theta, num_phi, inv_delta_theta, inv_delta_phi,
+                    oskar_mem_double_const(table, status),
+                    stride, oskar_mem_double(output, status) + offset);
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+        oskar_device_check_error(status);
+#else
+        *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
+    }
+    else if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num, num_surf, num_t, num_p, off, str;
+        cl_uint arg = 0;
+        const int is_dbl = (precision == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_points + local_size - 1) /
+                local_size) * local_size;
+        k = is_dbl ? oskar_cl_kernel("evaluate_element_lut_double") :
+                oskar_cl_kernel("evaluate_element_lut_float");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_points;
+        num_surf = (cl_int) num_surfaces;
+        num_t = (cl_int) num_theta;
+        num_p = (cl_int) num_phi;
+        off = (cl_int) offset;
+        str = (cl_int) stride;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(theta, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(phi, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &num_surf);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &num_t);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &num_p);
+        if (is_dbl)
+        {
+            const cl_double inv_dt = inv_delta_theta;
+            const cl_double inv_dp = inv_delta_phi;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &inv_dt);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &inv_dp);
+        }
+        else
+        {
+            const cl_float inv_dt = (cl_float) inv_delta_theta;
+            const cl_float inv_dp = (cl_float) inv_delta_phi;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &inv_dt);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &inv_dp);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(table, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &str);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &off);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(output, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_points > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else
+        *status = OSKAR_ERR_BAD_LOCATION;
+}
+
+#ifdef __cplusplus
+}
+#endif
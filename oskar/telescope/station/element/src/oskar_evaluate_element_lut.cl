@@ -0,0 +1,33 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void evaluate_element_lut_REAL(const int num_points,
+        global const REAL* restrict theta,
+        global const REAL* restrict phi,
+        const int num_surfaces, const int num_theta, const int num_phi,
+        const REAL inv_delta_theta, const REAL inv_delta_phi,
+        global const REAL* restrict table,
+        const int stride, const int offset,
+        global REAL* restrict out)
+{
+    const int p = get_global_id(0);
+    if (p >= num_points) return;
+
+    /* Find the grid cell and the position within it. */
+    REAL ft = theta[p] * inv_delta_theta, fp = phi[p] * inv_delta_phi;
+    const int i = clamp((int)ft, 0, num_theta - 2);
+    const int j = clamp((int)fp, 0, num_phi - 2);
+    ft = clamp(ft - i, (REAL) 0., (REAL) 1.);
+    fp = clamp(fp - j, (REAL) 0., (REAL) 1.);
+
+    /* Bilinear interpolation of each surface. */
+    const REAL w00 = ((REAL) 1. - ft) * ((REAL) 1. - fp);
+    const REAL w01 = ((REAL) 1. - ft) * fp;
+    const REAL w10 = ft * ((REAL) 1. - fp);
+    const REAL w11 = ft * fp;
+    const int t0 = (i * num_phi + j) * num_surfaces;
+    const int t1 = t0 + num_phi * num_surfaces;
+    for (int k = 0; k < num_surfaces; ++k)
+        out[offset + p * stride + k] =
+                w00 * table[t0 + k] + w01 * table[t0 + k + num_surfaces] +
+                w10 * table[t1 + k] + w11 * table[t1 + k + num_surfaces];
+}
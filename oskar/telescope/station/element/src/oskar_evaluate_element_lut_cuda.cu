@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/oskar_evaluate_element_lut_cuda.h"
+#include "telescope/station/element/oskar_evaluate_element_lut_inline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Kernel wrappers. ======================================================== */
+
+/* Single precision. */
+void oskar_evaluate_element_lut_cuda_f(int num_points, const float* d_theta,
+        const float* d_phi, int num_surfaces, int num_theta, int num_phi,
+        float inv_delta_theta, float inv_delta_phi, const float* d_table,
+        int stride, float* d_out)
+{
+    int num_blocks, num_threads = 256;
+    num_blocks = (num_points + num_threads - 1) / num_threads;
+    oskar_evaluate_element_lut_cudak_f
+    OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_points, d_theta, d_phi,
+            num_surfaces, num_theta, num_phi, inv_delta_theta, inv_delta_phi,
+            d_table, stride, d_out);
+}
+
+/* Double precision. */
+void oskar_evaluate_element_lut_cuda_d(int num_points, const double* d_theta,
+        const double* d_phi, int num_surfaces, int num_theta, int num_phi,
+        double inv_delta_theta, double inv_delta_phi, const double* d_table,
+        int stride, double* d_out)
+{
+    int num_blocks, num_threads = 256;
+    num_blocks = (num_points + num_threads - 1) / num_threads;
+    oskar_evaluate_element_lut_cudak_d
+    OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_points, d_theta, d_phi,
+            num_surfaces, num_theta, num_phi, inv_delta_theta, inv_delta_phi,
+            d_table, stride, d_out);
+}
+
+
+/* Kernels. ================================================================ */
+
+/* Single precision. */
+__global__
+void oskar_evaluate_element_lut_cudak_f(const int num_points,
+        const float* restrict theta, const float* restrict phi,
+        const int num_surfaces, const int num_theta, const int num_phi,
+        const float inv_delta_theta, const float inv_delta_phi,
+        const float* restrict table, const int stride, float* out)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= num_points) return;
+    oskar_evaluate_element_lut_inline_f(theta[i], phi[i], num_surfaces,
+            num_theta, num_phi, inv_delta_theta, inv_delta_phi, table,
+            out + i * stride);
+}
+
+/* Double precision. */
+__global__
+void oskar_evaluate_element_lut_cudak_d(const int num_points,
+        const double* restrict theta, const double* restrict phi,
+        const int num_surfaces, const int num_theta, const int num_phi,
+        const double inv_delta_theta, const double inv_delta_phi,
+        const double* restrict table, const int stride, double* out)
+{
+    const int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= num_points) return;
+    oskar_evaluate_element_lut_inline_d(theta[i], phi[i], num_surfaces,
+            num_theta, num_phi, inv_delta_theta, inv_delta_phi, table,
+            out + i * stride);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -29,6 +29,7 @@
 #include "telescope/station/element/oskar_evaluate_geometric_dipole_pattern.h"
 #include "telescope/station/element/oskar_evaluate_geometric_dipole_pattern_cuda.h"
 #include "telescope/station/element/oskar_evaluate_geometric_dipole_pattern_inline.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 #include "math/oskar_cmath.h"
 
@@ -171,7 +172,57 @@ void oskar_evaluate_geometric_dipole_pattern(oskar_Mem* pattern, int num_points,
     }
 
     /* Check the location. */
-    if (location == OSKAR_GPU)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num, off, str;
+        cl_uint arg = 0;
+        const int is_dbl = (precision == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_points + local_size - 1) /
+                local_size) * local_size;
+        if (oskar_mem_is_matrix(pattern))
+            k = is_dbl ? oskar_cl_kernel("geometric_dipole_double") :
+                    oskar_cl_kernel("geometric_dipole_float");
+        else
+            k = is_dbl ? oskar_cl_kernel("geometric_dipole_scalar_double") :
+                    oskar_cl_kernel("geometric_dipole_scalar_float");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_points;
+        off = (cl_int) offset;
+        str = (cl_int) stride;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(theta, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(phi, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &str);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_int), &off);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(pattern, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_points > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (location == OSKAR_GPU)
     {
 #ifdef OSKAR_HAVE_CUDA
         if (type == OSKAR_SINGLE_COMPLEX_MATRIX)
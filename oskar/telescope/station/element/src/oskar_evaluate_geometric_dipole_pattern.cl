@@ -0,0 +1,30 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void geometric_dipole_REAL(const int num_points,
+        global const REAL* restrict theta,
+        global const REAL* restrict phi,
+        const int stride, const int offset,
+        global REAL2* restrict pattern)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    REAL sin_phi, cos_phi;
+    sin_phi = sincos(phi[i], &cos_phi);
+    const int i_out = offset + i * stride;
+    pattern[i_out] = (REAL2)(cos(theta[i]) * cos_phi, 0.);
+    pattern[i_out + 1] = (REAL2)(-sin_phi, 0.);
+}
+
+kernel void geometric_dipole_scalar_REAL(const int num_points,
+        global const REAL* restrict theta,
+        global const REAL* restrict phi,
+        const int stride, const int offset,
+        global REAL2* restrict pattern)
+{
+    const int i = get_global_id(0);
+    if (i >= num_points) return;
+    // Sum of the squared magnitudes for X and Y dipoles is 1 + cos^2(theta).
+    const REAL cos_theta = cos(theta[i]);
+    const REAL amp = sqrt((REAL) 0.5 * ((REAL) 1. + cos_theta * cos_theta));
+    pattern[offset + i * stride] = (REAL2)(amp, 0.);
+}
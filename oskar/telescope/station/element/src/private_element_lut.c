@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/element/private_element_lut.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+oskar_ElementLUT* oskar_element_lut_create(int precision, int location,
+        int num_freq, int num_theta, int num_phi, int* status)
+{
+    int i;
+    oskar_ElementLUT* lut;
+    if (*status) return 0;
+    lut = (oskar_ElementLUT*) calloc(1, sizeof(oskar_ElementLUT));
+    if (!lut)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return 0;
+    }
+    lut->ref_count = 1;
+    lut->precision = precision;
+    lut->mem_location = location;
+    lut->num_freq = num_freq;
+    lut->num_theta = num_theta;
+    lut->num_phi = num_phi;
+    lut->x = (oskar_Mem**) calloc(num_freq, sizeof(oskar_Mem*));
+    lut->y = (oskar_Mem**) calloc(num_freq, sizeof(oskar_Mem*));
+    lut->scalar = (oskar_Mem**) calloc(num_freq, sizeof(oskar_Mem*));
+    if (num_freq > 0 && (!lut->x || !lut->y || !lut->scalar))
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        lut->num_freq = 0;
+    }
+    for (i = 0; i < lut->num_freq; ++i)
+    {
+        lut->x[i] = oskar_mem_create(precision, location, 0, status);
+        lut->y[i] = oskar_mem_create(precision, location, 0, status);
+        lut->scalar[i] = oskar_mem_create(precision, location, 0, status);
+    }
+    return lut;
+}
+
+oskar_ElementLUT* oskar_element_lut_copy(oskar_ElementLUT* src, int location,
+        int* status)
+{
+    int i;
+    oskar_ElementLUT* lut;
+    if (*status || !src) return 0;
+
+    /* Share the tables if they are already in the right place. */
+    if (src->mem_location == location)
+    {
+        src->ref_count++;
+        return src;
+    }
+    if (src->copy && src->copy->mem_location == location)
+    {
+        src->copy->ref_count++;
+        return src->copy;
+    }
+
+    /* Copy the tables, and remember the copy. */
+    lut = oskar_element_lut_create(src->precision, location,
+            src->num_freq, src->num_theta, src->num_phi, status);
+    if (!lut) return 0;
+    for (i = 0; i < lut->num_freq; ++i)
+    {
+        oskar_mem_copy(lut->x[i], src->x[i], status);
+        oskar_mem_copy(lut->y[i], src->y[i], status);
+        oskar_mem_copy(lut->scalar[i], src->scalar[i], status);
+    }
+    oskar_element_lut_forget_copy(src);
+    src->copy = lut;
+    lut->origin = src;
+    return lut;
+}
+
+void oskar_element_lut_forget_copy(oskar_ElementLUT* lut)
+{
+    if (!lut || !lut->copy) return;
+    lut->copy->origin = 0;
+    lut->copy = 0;
+}
+
+void oskar_element_lut_release(oskar_ElementLUT* lut, int* status)
+{
+    int i;
+    if (!lut || --lut->ref_count > 0) return;
+    oskar_element_lut_forget_copy(lut);
+    if (lut->origin) lut->origin->copy = 0;
+    for (i = 0; i < lut->num_freq; ++i)
+    {
+        oskar_mem_free(lut->x[i], status);
+        oskar_mem_free(lut->y[i], status);
+        oskar_mem_free(lut->scalar[i], status);
+    }
+    free(lut->x);
+    free(lut->y);
+    free(lut->scalar);
+    free(lut);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -83,6 +83,12 @@ oskar_Mem* oskar_station_work_horizon_mask(oskar_StationWork* work);
 OSKAR_EXPORT
 oskar_Mem* oskar_station_work_source_indices(oskar_StationWork* work);
 
+OSKAR_EXPORT
+oskar_Mem* oskar_station_work_zenith_dir(oskar_StationWork* work);
+
+OSKAR_EXPORT
+oskar_Mem* oskar_station_work_zenith_dir_cpu(oskar_StationWork* work);
+
 OSKAR_EXPORT
 oskar_Mem* oskar_station_work_enu_direction_x(oskar_StationWork* work);
 
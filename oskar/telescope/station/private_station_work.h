@@ -35,6 +35,8 @@ struct oskar_StationWork
 {
     oskar_Mem* horizon_mask;     /* Integer. */
     oskar_Mem* source_indices;   /* Integer. */
+    oskar_Mem* zenith_dir;       /* Real scalar. Station zenith directions. */
+    oskar_Mem* zenith_dir_cpu;   /* Real scalar. As above, in CPU memory. */
 
     oskar_Mem* enu_direction_x;  /* Real scalar. ENU direction cosine. */
     oskar_Mem* enu_direction_y;  /* Real scalar. ENU direction cosine. */
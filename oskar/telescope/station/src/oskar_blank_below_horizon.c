@@ -28,6 +28,7 @@
 
 #include "telescope/station/oskar_blank_below_horizon.h"
 #include "telescope/station/oskar_blank_below_horizon_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
 #ifdef __cplusplus
@@ -143,7 +144,61 @@ void oskar_blank_below_horizon(oskar_Mem* data, const oskar_Mem* mask,
     }
 
     /* Zero the value of any positions below the horizon. */
-    if (precision == OSKAR_SINGLE)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const int is_dbl = (precision == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_sources + local_size - 1) /
+                local_size) * local_size;
+        if (oskar_type_precision(type) != precision)
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (oskar_type_is_scalar(type) && oskar_type_is_complex(type))
+            k = is_dbl ? oskar_cl_kernel("blank_below_horizon_scalar_double") :
+                    oskar_cl_kernel("blank_below_horizon_scalar_float");
+        else if (oskar_type_is_matrix(type))
+            k = is_dbl ? oskar_cl_kernel("blank_below_horizon_matrix_double") :
+                    oskar_cl_kernel("blank_below_horizon_matrix_float");
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_sources;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(mask, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(data, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_sources > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (precision == OSKAR_SINGLE)
     {
         const float* mask_;
         mask_ = oskar_mem_float_const(mask, status);
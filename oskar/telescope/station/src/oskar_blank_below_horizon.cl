@@ -0,0 +1,17 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void blank_below_horizon_scalar_REAL(const int num_sources,
+        global const REAL* restrict mask, global REAL2* restrict jones)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    if (mask[i] < (REAL) 0) jones[i] = (REAL2) ((REAL) 0, (REAL) 0);
+}
+
+kernel void blank_below_horizon_matrix_REAL(const int num_sources,
+        global const REAL* restrict mask, global REAL8* restrict jones)
+{
+    const int i = get_global_id(0);
+    if (i >= num_sources) return;
+    if (mask[i] < (REAL) 0) jones[i] = (REAL8) ((REAL) 0);
+}
@@ -28,6 +28,7 @@
 
 #include "telescope/station/oskar_evaluate_element_weights_dft.h"
 #include "telescope/station/oskar_evaluate_element_weights_dft_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 #include <math.h>
 
@@ -143,7 +144,76 @@ void oskar_evaluate_element_weights_dft(oskar_Mem* weights, int num_elements,
     }
 
     /* Generate DFT weights: switch on type and location. */
-    if (type == OSKAR_DOUBLE)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const int is_dbl = (type == OSKAR_DOUBLE);
+        const size_t local_size = 128;
+        const size_t global_size = ((num_elements + local_size - 1) /
+                local_size) * local_size;
+        k = is_dbl ? oskar_cl_kernel("evaluate_element_weights_dft_double") :
+                oskar_cl_kernel("evaluate_element_weights_dft_float");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_elements;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        if (is_dbl)
+        {
+            const cl_double w = (cl_double) wavenumber;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &w);
+        }
+        else
+        {
+            const cl_float w = (cl_float) wavenumber;
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &w);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(x, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(y, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(z, status));
+        if (is_dbl)
+        {
+            const cl_double b[] = {x_beam, y_beam, z_beam};
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &b[0]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &b[1]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_double), &b[2]);
+        }
+        else
+        {
+            const cl_float b[] = {(cl_float) x_beam, (cl_float) y_beam,
+                    (cl_float) z_beam};
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &b[0]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &b[1]);
+            error |= clSetKernelArg(k, arg++, sizeof(cl_float), &b[2]);
+        }
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(weights, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_elements > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (type == OSKAR_DOUBLE)
     {
         const double *x_, *y_, *z_;
         double2* weights_;
@@ -167,6 +237,8 @@ void oskar_evaluate_element_weights_dft(oskar_Mem* weights, int num_elements,
             oskar_evaluate_element_weights_dft_d(weights_, num_elements,
                     wavenumber, x_, y_, z_, x_beam, y_beam, z_beam);
         }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
     }
     else if (type == OSKAR_SINGLE)
     {
@@ -194,6 +266,8 @@ void oskar_evaluate_element_weights_dft(oskar_Mem* weights, int num_elements,
                     (float)wavenumber, x_, y_, z_, (float)x_beam,
                     (float)y_beam, (float)z_beam);
         }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
     }
     else
     {
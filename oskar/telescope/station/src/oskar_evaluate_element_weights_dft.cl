@@ -0,0 +1,14 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void evaluate_element_weights_dft_REAL(const int num_elements,
+        const REAL wavenumber, global const REAL* restrict x,
+        global const REAL* restrict y, global const REAL* restrict z,
+        const REAL x_beam, const REAL y_beam, const REAL z_beam,
+        global REAL2* restrict weights)
+{
+    const int i = get_global_id(0);
+    if (i >= num_elements) return;
+    const REAL phase = wavenumber *
+            (x[i] * x_beam + y[i] * y_beam + z[i] * z_beam);
+    weights[i] = (REAL2) (cos(-phase), sin(-phase));
+}
@@ -28,6 +28,7 @@
 
 #include "telescope/station/oskar_evaluate_element_weights_errors.h"
 #include "telescope/station/oskar_evaluate_element_weights_errors_cuda.h"
+#include "utility/oskar_cl_utils.h"
 #include <math.h>
 
 #ifdef __cplusplus
@@ -146,7 +147,54 @@ void oskar_evaluate_element_weights_errors(int num_elements,
             station_id, 0x12345678, 1.0, status);
 
     /* Generate weights errors: switch on type and location. */
-    if (type == OSKAR_DOUBLE)
+    if (location & OSKAR_CL)
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        cl_event event;
+        cl_kernel k = 0;
+        cl_int error, num;
+        cl_uint arg = 0;
+        const size_t local_size = 128;
+        const size_t global_size = ((num_elements + local_size - 1) /
+                local_size) * local_size;
+        if (type == OSKAR_DOUBLE)
+            k = oskar_cl_kernel("evaluate_element_weights_errors_double");
+        else
+            k = oskar_cl_kernel("evaluate_element_weights_errors_float");
+        if (!k)
+        {
+            *status = OSKAR_ERR_FUNCTION_NOT_AVAILABLE;
+            return;
+        }
+
+        /* Set kernel arguments. */
+        num = (cl_int) num_elements;
+        error = clSetKernelArg(k, arg++, sizeof(cl_int), &num);
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(gain, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(gain_error, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(phase, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer_const(phase_error, status));
+        error |= clSetKernelArg(k, arg++, sizeof(cl_mem),
+                oskar_mem_cl_buffer(errors, status));
+        if (!*status && error != CL_SUCCESS)
+            *status = OSKAR_ERR_INVALID_ARGUMENT;
+        if (!*status && num_elements > 0)
+        {
+            /* Launch kernel on current command queue. */
+            error = clEnqueueNDRangeKernel(oskar_cl_command_queue(), k, 1,
+                    NULL, &global_size, &local_size, 0, NULL, &event);
+            if (error != CL_SUCCESS)
+                *status = OSKAR_ERR_KERNEL_LAUNCH_FAILURE;
+        }
+#else
+        *status = OSKAR_ERR_OPENCL_NOT_AVAILABLE;
+#endif
+    }
+    else if (type == OSKAR_DOUBLE)
     {
         const double *gain_, *gain_error_, *phase_, *phase_error_;
         double2* errors_;
@@ -170,6 +218,8 @@ void oskar_evaluate_element_weights_errors(int num_elements,
             oskar_evaluate_element_weights_errors_d(num_elements,
                     gain_, gain_error_, phase_, phase_error_, errors_);
         }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
     }
     else if (type == OSKAR_SINGLE)
     {
@@ -195,6 +245,8 @@ void oskar_evaluate_element_weights_errors(int num_elements,
             oskar_evaluate_element_weights_errors_f(num_elements,
                     gain_, gain_error_, phase_, phase_error_, errors_);
         }
+        else
+            *status = OSKAR_ERR_BAD_LOCATION;
     }
     else
     {
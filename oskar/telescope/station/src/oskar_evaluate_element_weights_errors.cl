@@ -0,0 +1,18 @@
+/* Copyright (c) 2017, The University of Oxford. See LICENSE file. */
+
+kernel void evaluate_element_weights_errors_REAL(const int num_elements,
+        global const REAL* restrict amp_gain,
+        global const REAL* restrict amp_error,
+        global const REAL* restrict phase_offset,
+        global const REAL* restrict phase_error,
+        global REAL2* restrict errors)
+{
+    const int i = get_global_id(0);
+    if (i >= num_elements) return;
+
+    /* Scale the normalised Gaussian random numbers already in the array. */
+    const REAL2 r = errors[i];
+    const REAL amp = r.x * amp_error[i] + amp_gain[i];
+    const REAL phase = r.y * phase_error[i] + phase_offset[i];
+    errors[i] = (REAL2) (amp * cos(phase), amp * sin(phase));
+}
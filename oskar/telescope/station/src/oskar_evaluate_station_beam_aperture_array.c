@@ -73,10 +73,6 @@ void oskar_evaluate_station_beam_aperture_array(oskar_Mem* beam,
     else
     {
         oskar_Mem *c_beam, *c_x, *c_y, *c_z;
-        c_beam = oskar_mem_create_alias(0, 0, 0, status);
-        c_x = oskar_mem_create_alias(0, 0, 0, status);
-        c_y = oskar_mem_create_alias(0, 0, 0, status);
-        c_z = oskar_mem_create_alias(0, 0, 0, status);
 
         /* Split up list of input points into manageable chunks. */
         for (start = 0; start < num_points; start += MAX_CHUNK_SIZE)
@@ -87,23 +83,23 @@ void oskar_evaluate_station_beam_aperture_array(oskar_Mem* beam,
             chunk_size = num_points - start;
             if (chunk_size > MAX_CHUNK_SIZE) chunk_size = MAX_CHUNK_SIZE;
 
-            /* Get pointers to start of chunk input data. */
-            oskar_mem_set_alias(c_beam, beam, start, chunk_size, status);
-            oskar_mem_set_alias(c_x, x, start, chunk_size, status);
-            oskar_mem_set_alias(c_y, y, start, chunk_size, status);
-            oskar_mem_set_alias(c_z, z, start, chunk_size, status);
+            /* Get handles to the chunk input and output data. */
+            c_beam = oskar_mem_create_slice(beam, start, chunk_size, status);
+            c_x = oskar_mem_create_slice(x, start, chunk_size, status);
+            c_y = oskar_mem_create_slice(y, start, chunk_size, status);
+            c_z = oskar_mem_create_slice(z, start, chunk_size, status);
 
             /* Start recursive call at depth 1 (depth 0 is element level). */
             oskar_evaluate_station_beam_aperture_array_private(c_beam, station,
                     chunk_size, c_x, c_y, c_z, gast, frequency_hz, work,
                     time_index, 1, status);
-        }
 
-        /* Release handles for chunk memory. */
-        oskar_mem_free(c_beam, status);
-        oskar_mem_free(c_x, status);
-        oskar_mem_free(c_y, status);
-        oskar_mem_free(c_z, status);
+            /* Release handles for chunk memory. */
+            oskar_mem_free_slice(c_beam, beam, start, status);
+            oskar_mem_free_slice(c_x, 0, 0, status);
+            oskar_mem_free_slice(c_y, 0, 0, status);
+            oskar_mem_free_slice(c_z, 0, 0, status);
+        }
     }
 }
 
@@ -211,9 +207,6 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
             element_block = oskar_station_work_beam(work, beam,
                     num_elements * num_points, 0, status);
 
-            /* Create alias into element block. */
-            element = oskar_mem_create_alias(element_block, 0, 0, status);
-
             /* Loop over elements and evaluate response for each. */
             element_type_array = oskar_station_element_types_cpu_const(s);
             num_element_types = oskar_station_num_element_types(s);
@@ -226,14 +219,16 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
                     *status = OSKAR_ERR_OUT_OF_RANGE;
                     break;
                 }
-                oskar_mem_set_alias(element, element_block, i * num_points,
-                        num_points, status);
+                element = oskar_mem_create_slice(element_block,
+                        (size_t)i * num_points, num_points, status);
                 oskar_element_evaluate(
                         oskar_station_element_const(s, element_type_idx),
                         element,
                         oskar_station_element_x_alpha_rad(s, i) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
                         oskar_station_element_y_alpha_rad(s, i),
                         num_points, x, y, z, frequency_hz, theta, phi, status);
+                oskar_mem_free_slice(element, element_block,
+                        (size_t)i * num_points, status);
             }
 
             /* Generate beamforming weights. */
@@ -249,9 +244,6 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
                     weights, num_points, x, y, (is_3d ? z : 0),
                     element_block, beam, status);
 
-            /* Free element alias. */
-            oskar_mem_free(element, status);
-
             /* Normalise array response if required. */
             if (oskar_station_normalise_array_pattern(s))
                 oskar_mem_scale_real(beam, 1.0 / num_elements, status);
@@ -283,7 +275,7 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
         {
             /* Set up the output buffer for the first station. */
             oskar_Mem* output0;
-            output0 = oskar_mem_create_alias(signal, 0, num_points, status);
+            output0 = oskar_mem_create_slice(signal, 0, num_points, status);
 
             /* Recursive call. */
             oskar_evaluate_station_beam_aperture_array_private(output0,
@@ -297,7 +289,7 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
                 oskar_mem_copy_contents(signal, output0, i * num_points, 0,
                         oskar_mem_length(output0), status);
             }
-            oskar_mem_free(output0, status);
+            oskar_mem_free_slice(output0, signal, 0, status);
         }
         else
         {
@@ -306,15 +298,16 @@ static void oskar_evaluate_station_beam_aperture_array_private(oskar_Mem* beam,
             {
                 /* Set up the output buffer for this station. */
                 oskar_Mem* output;
-                output = oskar_mem_create_alias(signal, i * num_points,
-                        num_points, status);
+                output = oskar_mem_create_slice(signal,
+                        (size_t)i * num_points, num_points, status);
 
                 /* Recursive call. */
                 oskar_evaluate_station_beam_aperture_array_private(output,
                         oskar_station_child_const(s, i), num_points,
                         x, y, z, gast, frequency_hz, work, time_index,
                         depth + 1, status);
-                oskar_mem_free(output, status);
+                oskar_mem_free_slice(output, signal, (size_t)i * num_points,
+                        status);
             }
         }
 
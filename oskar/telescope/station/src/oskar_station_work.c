@@ -51,6 +51,8 @@ oskar_StationWork* oskar_station_work_create(int type,
     /* Initialise arrays. */
     work->horizon_mask = oskar_mem_create(OSKAR_INT, location, 0, status);
     work->source_indices = oskar_mem_create(OSKAR_INT, location, 0, status);
+    work->zenith_dir = oskar_mem_create(type, location, 0, status);
+    work->zenith_dir_cpu = oskar_mem_create(type, OSKAR_CPU, 0, status);
     work->theta_modified = oskar_mem_create(type, location, 0, status);
     work->phi_modified = oskar_mem_create(type, location, 0, status);
     work->enu_direction_x = oskar_mem_create(type, location, 0, status);
@@ -76,6 +78,8 @@ void oskar_station_work_free(oskar_StationWork* work, int* status)
 
     oskar_mem_free(work->horizon_mask, status);
     oskar_mem_free(work->source_indices, status);
+    oskar_mem_free(work->zenith_dir, status);
+    oskar_mem_free(work->zenith_dir_cpu, status);
     oskar_mem_free(work->theta_modified, status);
     oskar_mem_free(work->phi_modified, status);
     oskar_mem_free(work->enu_direction_x, status);
@@ -105,6 +109,16 @@ oskar_Mem* oskar_station_work_source_indices(oskar_StationWork* work)
     return work->source_indices;
 }
 
+oskar_Mem* oskar_station_work_zenith_dir(oskar_StationWork* work)
+{
+    return work->zenith_dir;
+}
+
+oskar_Mem* oskar_station_work_zenith_dir_cpu(oskar_StationWork* work)
+{
+    return work->zenith_dir_cpu;
+}
+
 oskar_Mem* oskar_station_work_enu_direction_x(oskar_StationWork* work)
 {
     return work->enu_direction_x;
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "telescope/station/element/oskar_element.h"
+#include "utility/oskar_cl_utils.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_timer.h"
+
+#include "math/oskar_cmath.h"
+#include <cstdio>
+#include <cstdlib>
+
+static oskar_Element* create_fitted_element(double freq_hz, int* status)
+{
+    const char* filename = "temp_test_element_tabulate.txt";
+
+    // Write a smooth numerical element pattern in Ludwig-3 format.
+    FILE* file = fopen(filename, "w");
+    if (!file) return 0;
+    fprintf(file, "Theta Phi Abs(Dir.) Abs(Horiz) Phase(Horiz) "
+            "Abs(Verti) Phase(Verti) Ax.Ratio\n");
+    for (int t = 0; t <= 180; t += 10)
+    {
+        for (int p = 0; p < 360; p += 10)
+        {
+            double theta = t * M_PI / 180.0, phi = p * M_PI / 180.0;
+            double h = cos(theta / 2.0) * (1.0 + 0.2 * cos(phi));
+            double v = 0.5 * sin(theta) * sin(phi) + 0.1;
+            fprintf(file, "%d %d 0 %.6f %.3f %.6f %.3f 0\n",
+                    t, p, h, 30.0 * cos(theta), v, 20.0 * sin(phi));
+        }
+    }
+    fclose(file);
+
+    // Load and fit the pattern.
+    oskar_Element* element = oskar_element_create(OSKAR_DOUBLE, OSKAR_CPU,
+            status);
+    oskar_element_load_cst(element, NULL, 1, freq_hz, filename, 0.02, 1.5,
+            0, 0, status);
+    remove(filename);
+    return element;
+}
+
+static void random_directions(oskar_Mem* x, oskar_Mem* y, oskar_Mem* z,
+        int num_points, int* status)
+{
+    srand(1);
+    for (int i = 0; i < num_points; ++i)
+    {
+        double el = asin((double)rand() / RAND_MAX);
+        double az = 2.0 * M_PI * rand() / RAND_MAX;
+        oskar_mem_double(x, status)[i] = cos(el) * sin(az);
+        oskar_mem_double(y, status)[i] = cos(el) * cos(az);
+        oskar_mem_double(z, status)[i] = sin(el);
+    }
+}
+
+TEST(element_tabulate, compare_with_splines)
+{
+    int status = 0;
+    const int num_points = 10000;
+    const double freq_hz = 100e6;
+    oskar_Element* element = create_fitted_element(freq_hz, &status);
+    ASSERT_TRUE(element != NULL);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate random directions above the horizon.
+    oskar_Mem *x, *y, *z, *theta, *phi, *out_spline, *out_lut;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    phi = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    out_spline = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    out_lut = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    random_directions(x, y, z, num_points, &status);
+
+    // Evaluate the pattern using the splines and the look-up table.
+    oskar_Timer* tmr = oskar_timer_create(OSKAR_TIMER_NATIVE);
+    oskar_timer_start(tmr);
+    oskar_element_evaluate(element, out_spline, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    double t_spline = oskar_timer_elapsed(tmr);
+    double max_error = 1.0;
+    oskar_element_tabulate(element, 0.25 * M_PI / 180.0, &max_error, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_GT(max_error, 0.0);
+    EXPECT_LT(max_error, 1e-3);
+    oskar_timer_start(tmr);
+    oskar_element_evaluate(element, out_lut, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    double t_lut = oskar_timer_elapsed(tmr);
+    oskar_timer_free(tmr);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    printf("Max table error %.3e; evaluation time: splines %.4f s, "
+            "table %.4f s\n", max_error, t_spline, t_lut);
+
+    // Check the values are close.
+    const double *a = oskar_mem_double_const(out_spline, &status);
+    const double *b = oskar_mem_double_const(out_lut, &status);
+    double peak = 0.0, max_diff = 0.0;
+    for (int i = 0; i < 8 * num_points; ++i)
+    {
+        if (fabs(a[i]) > peak) peak = fabs(a[i]);
+        if (fabs(a[i] - b[i]) > max_diff) max_diff = fabs(a[i] - b[i]);
+    }
+    EXPECT_GT(peak, 0.0);
+    EXPECT_LE(max_diff, 2.0 * max_error * peak);
+
+    // Check that removing the tables restores the spline values.
+    oskar_element_tabulate(element, 0.0, &max_error, &status);
+    oskar_element_evaluate(element, out_lut, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, oskar_mem_different(out_spline, out_lut, 0, &status));
+
+    // Clean up.
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(theta, &status);
+    oskar_mem_free(phi, &status);
+    oskar_mem_free(out_spline, &status);
+    oskar_mem_free(out_lut, &status);
+    oskar_element_free(element, &status);
+}
+
+TEST(element_tabulate, share_tables)
+{
+    int status = 0;
+    const int num_points = 1000;
+    const double freq_hz = 100e6;
+    oskar_Element *a = 0, *b = 0, *c = 0;
+    a = create_fitted_element(freq_hz, &status);
+    ASSERT_TRUE(a != NULL);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate random directions above the horizon.
+    oskar_Mem *x, *y, *z, *theta, *phi, *out_spline, *out_lut, *out;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    phi = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    out_spline = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    out_lut = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    out = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    random_directions(x, y, z, num_points, &status);
+
+    // Evaluate using the splines, then using the tables.
+    double max_error = 0.0;
+    oskar_element_evaluate(a, out_spline, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    oskar_element_tabulate(a, 1.0 * M_PI / 180.0, &max_error, &status);
+    oskar_element_evaluate(a, out_lut, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(1, oskar_mem_different(out_spline, out_lut, 0, &status));
+
+    // Copies must use the tables, even after the original has been freed.
+    b = oskar_element_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    oskar_element_copy(b, a, &status);
+    oskar_element_free(a, &status);
+    oskar_element_evaluate(b, out, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, oskar_mem_different(out_lut, out, 0, &status));
+
+    // Removing tables from one element must not affect the other.
+    c = oskar_element_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    oskar_element_copy(c, b, &status);
+    oskar_element_tabulate(c, 0.0, &max_error, &status);
+    oskar_element_evaluate(c, out, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, oskar_mem_different(out_spline, out, 0, &status));
+    oskar_element_evaluate(b, out, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, oskar_mem_different(out_lut, out, 0, &status));
+
+    // Share the tables explicitly.
+    EXPECT_EQ(0, oskar_element_different(b, c, &status));
+    oskar_element_share_tables(c, b, &status);
+    oskar_element_free(b, &status);
+    oskar_element_evaluate(c, out, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(0, oskar_mem_different(out_lut, out, 0, &status));
+
+#ifdef OSKAR_HAVE_CUDA
+    // Check that tables are copied to and evaluated on the GPU.
+    {
+        oskar_Element* d = oskar_element_create(OSKAR_DOUBLE, OSKAR_GPU,
+                &status);
+        oskar_Mem *x_d, *y_d, *z_d, *theta_d, *phi_d, *out_d;
+        oskar_element_copy(d, c, &status);
+        x_d = oskar_mem_create_copy(x, OSKAR_GPU, &status);
+        y_d = oskar_mem_create_copy(y, OSKAR_GPU, &status);
+        z_d = oskar_mem_create_copy(z, OSKAR_GPU, &status);
+        theta_d = oskar_mem_create(OSKAR_DOUBLE, OSKAR_GPU, num_points,
+                &status);
+        phi_d = oskar_mem_create(OSKAR_DOUBLE, OSKAR_GPU, num_points,
+                &status);
+        out_d = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_GPU,
+                num_points, &status);
+        oskar_element_evaluate(d, out_d, M_PI / 2.0, 0.0, num_points,
+                x_d, y_d, z_d, freq_hz, theta_d, phi_d, &status);
+        oskar_mem_copy(out, out_d, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        EXPECT_EQ(1, oskar_mem_different(out_spline, out, 0, &status));
+        oskar_mem_free(x_d, &status);
+        oskar_mem_free(y_d, &status);
+        oskar_mem_free(z_d, &status);
+        oskar_mem_free(theta_d, &status);
+        oskar_mem_free(phi_d, &status);
+        oskar_mem_free(out_d, &status);
+        oskar_element_free(d, &status);
+    }
+#endif
+
+    // Clean up.
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(theta, &status);
+    oskar_mem_free(phi, &status);
+    oskar_mem_free(out_spline, &status);
+    oskar_mem_free(out_lut, &status);
+    oskar_mem_free(out, &status);
+    oskar_element_free(c, &status);
+}
+
+#ifdef OSKAR_HAVE_OPENCL
+static double max_diff_cl(const oskar_Element* element, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        double freq_hz, int* status)
+{
+    oskar_Element* e;
+    oskar_Mem *x_cl, *y_cl, *z_cl, *theta, *phi, *out_cpu, *out_cl, *temp;
+    const int type = OSKAR_DOUBLE_COMPLEX_MATRIX;
+    e = oskar_element_create(OSKAR_DOUBLE, OSKAR_CL, status);
+    oskar_element_copy(e, element, status);
+    x_cl = oskar_mem_create_copy(x, OSKAR_CL, status);
+    y_cl = oskar_mem_create_copy(y, OSKAR_CL, status);
+    z_cl = oskar_mem_create_copy(z, OSKAR_CL, status);
+    out_cl = oskar_mem_create(type, OSKAR_CL, num_points, status);
+    theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CL, num_points, status);
+    phi = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CL, num_points, status);
+    oskar_element_evaluate(e, out_cl, M_PI / 2.0, 0.0, num_points,
+            x_cl, y_cl, z_cl, freq_hz, theta, phi, status);
+    temp = oskar_mem_create_copy(out_cl, OSKAR_CPU, status);
+    oskar_mem_free(theta, status);
+    oskar_mem_free(phi, status);
+
+    // Evaluate on the CPU.
+    theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    phi = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    out_cpu = oskar_mem_create(type, OSKAR_CPU, num_points, status);
+    oskar_element_evaluate(element, out_cpu, M_PI / 2.0, 0.0, num_points,
+            x, y, z, freq_hz, theta, phi, status);
+    double max_diff = 0.0;
+    if (!*status)
+    {
+        const double *a = oskar_mem_double_const(out_cpu, status);
+        const double *b = oskar_mem_double_const(temp, status);
+        for (int i = 0; i < 8 * num_points; ++i)
+            if (fabs(a[i] - b[i]) > max_diff) max_diff = fabs(a[i] - b[i]);
+    }
+
+    // Clean up.
+    oskar_mem_free(x_cl, status);
+    oskar_mem_free(y_cl, status);
+    oskar_mem_free(z_cl, status);
+    oskar_mem_free(theta, status);
+    oskar_mem_free(phi, status);
+    oskar_mem_free(out_cpu, status);
+    oskar_mem_free(out_cl, status);
+    oskar_mem_free(temp, status);
+    oskar_element_free(e, status);
+    return max_diff;
+}
+
+TEST(element_tabulate, compare_cl)
+{
+    int status = 0;
+    const int num_points = 1000;
+    const double freq_hz = 100e6;
+    const char* tapers[] = {"None", "Cosine", "Gaussian"};
+    if (oskar_cl_num_devices() == 0) return;
+    oskar_Element* element = create_fitted_element(freq_hz, &status);
+    ASSERT_TRUE(element != NULL);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_element_set_cosine_power(element, 1.5);
+    oskar_element_set_gaussian_fwhm_rad(element, 60.0 * M_PI / 180.0);
+
+    // Generate random directions above the horizon.
+    oskar_Mem *x, *y, *z;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    random_directions(x, y, z, num_points, &status);
+
+    // Compare splines and tables, with each taper, against the CPU.
+    for (int lut = 0; lut < 2; ++lut)
+    {
+        double max_error = 0.0;
+        oskar_element_tabulate(element, lut ? 1.0 * M_PI / 180.0 : 0.0,
+                &max_error, &status);
+        for (int t = 0; t < 3; ++t)
+        {
+            oskar_element_set_taper_type(element, tapers[t], &status);
+            double max_diff = max_diff_cl(element, num_points, x, y, z,
+                    freq_hz, &status);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            EXPECT_LT(max_diff, 1e-10) << "Taper " << tapers[t] <<
+                    (lut ? " (table)" : " (splines)");
+        }
+    }
+
+    // Clean up.
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_element_free(element, &status);
+}
+#endif
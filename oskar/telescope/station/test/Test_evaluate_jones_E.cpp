@@ -128,7 +128,8 @@ TEST(evaluate_jones_E, evaluate_e)
     oskar_Mem *E_station = oskar_mem_create_alias(0, 0, 0, &error);
     for (int j = 0; j < num_stations; ++j)
     {
-        oskar_jones_get_station_pointer(E_station, E, j, &error);
+        oskar_jones_get_station_pointer(E_station, E,
+                oskar_jones_station_row(E, j), &error);
         ASSERT_EQ(0, error) << oskar_get_error_string(error);
         oskar_mem_save_ascii(file, 4, num_pts - 1, &error,
                 oskar_station_work_enu_direction_x(work),
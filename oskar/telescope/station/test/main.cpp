@@ -27,6 +27,7 @@
  */
 
 #include <gtest/gtest.h>
+#include "utility/oskar_cl_utils.h"
 #include "utility/oskar_device_utils.h"
 
 int main(int argc, char** argv)
@@ -34,5 +35,6 @@ int main(int argc, char** argv)
     ::testing::InitGoogleTest(&argc, argv);
     int val = RUN_ALL_TESTS();
     oskar_device_reset();
+    oskar_cl_free();
     return val;
 }
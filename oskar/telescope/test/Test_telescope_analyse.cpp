@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "utility/oskar_get_error_string.h"
+#include "mem/oskar_mem.h"
+#include "telescope/oskar_telescope.h"
+
+static void set_station_layout(oskar_Station* st, int num_elements,
+        double spacing, int* status)
+{
+    oskar_station_resize(st, num_elements, status);
+    for (int j = 0; j < num_elements; ++j)
+    {
+        double xyz[3];
+        xyz[0] = spacing * j;
+        xyz[1] = 0.5 * spacing * j;
+        xyz[2] = 0.0;
+        oskar_station_set_element_coords(st, j, xyz, xyz, status);
+    }
+}
+
+TEST(telescope_analyse, station_types)
+{
+    int status = 0, num_stations = 7;
+    oskar_Telescope* tel = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_stations, &status);
+
+    // Use three different station layouts.
+    for (int i = 0; i < num_stations; ++i)
+        set_station_layout(oskar_telescope_station(tel, i), 10,
+                1.0 + (i % 3), &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_telescope_analyse(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(3, oskar_telescope_num_station_types(tel));
+    EXPECT_FALSE(oskar_telescope_identical_stations(tel));
+    ASSERT_EQ(num_stations,
+            (int)oskar_mem_length(oskar_telescope_station_type_map_const(tel)));
+    const int* type_map = oskar_mem_int_const(
+            oskar_telescope_station_type_map_const(tel), &status);
+    for (int i = 0; i < num_stations; ++i)
+        EXPECT_EQ(i % 3, type_map[i]);
+
+    // Check the map is kept by a copy.
+    oskar_Telescope* copy = oskar_telescope_create_copy(tel, OSKAR_CPU,
+            &status);
+    EXPECT_EQ(3, oskar_telescope_num_station_types(copy));
+    EXPECT_EQ(0, oskar_mem_different(oskar_telescope_station_type_map_const(tel),
+            oskar_telescope_station_type_map_const(copy), 0, &status));
+    oskar_telescope_free(copy, &status);
+
+    // Make all stations the same.
+    for (int i = 0; i < num_stations; ++i)
+        set_station_layout(oskar_telescope_station(tel, i), 10, 1.0, &status);
+    oskar_telescope_analyse(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_EQ(1, oskar_telescope_num_station_types(tel));
+    EXPECT_TRUE(oskar_telescope_identical_stations(tel));
+    type_map = oskar_mem_int_const(
+            oskar_telescope_station_type_map_const(tel), &status);
+    for (int i = 0; i < num_stations; ++i)
+        EXPECT_EQ(0, type_map[i]);
+    oskar_telescope_free(tel, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
@@ -57,8 +57,6 @@ string find_replace(string subject, const string& search, const string& replace)
 
 struct CLGlobal
 {
-    unsigned int current_device;
-
     struct CLDevice
     {
         string name;
@@ -69,7 +67,6 @@ struct CLGlobal
         cl_context context;
         cl_command_queue queue;
         cl_program program;
-        map<string, cl_kernel> kernel;
 #endif
 
         CLDevice()
@@ -93,11 +90,6 @@ struct CLGlobal
                 clFlush(queue);
                 clFinish(queue);
             }
-            for (map<string, cl_kernel>::iterator i = kernel.begin();
-                    i != kernel.end(); ++i)
-            {
-                clReleaseKernel(i->second);
-            }
             if (queue) clReleaseCommandQueue(queue);
             if (program) clReleaseProgram(program);
             if (context) clReleaseContext(context);
@@ -108,18 +100,46 @@ struct CLGlobal
     // Data stored per device.
     vector<CLDevice*> device;
 
-    CLGlobal() : current_device(0) {}
+    // Incremented whenever the devices are set up or freed.
+    unsigned int generation;
 
-    ~CLGlobal()
-    {
-        clear();
-    }
+    CLGlobal() : generation(0) {}
 
     void clear()
     {
         for (size_t i = 0; i < device.size(); ++i)
             delete device[i];
         device.clear();
+        generation++;
+    }
+};
+
+// The selected device and the kernels used by one thread.
+// Kernel arguments are not thread-safe, so each thread has its own
+// kernel objects, created from the program built for each device.
+struct CLThread
+{
+    unsigned int current_device;
+    unsigned int generation;
+#ifdef OSKAR_HAVE_OPENCL
+    vector<map<string, cl_kernel> > kernel;
+#endif
+
+    CLThread() : current_device(0), generation(0) {}
+
+    void release_kernels()
+    {
+#ifdef OSKAR_HAVE_OPENCL
+        for (size_t i = 0; i < kernel.size(); ++i)
+        {
+            for (map<string, cl_kernel>::iterator j = kernel[i].begin();
+                    j != kernel[i].end(); ++j)
+            {
+                if (j->second) clReleaseKernel(j->second);
+            }
+        }
+        kernel.clear();
+#endif
     }
 };
 
@@ -128,6 +148,10 @@ struct CLGlobal
 
 using namespace oskar;
 
+// OpenCL contexts, command queues and programs, shared by all threads
+// so that memory allocated in one thread can be used by any other.
+static CLGlobal oskar_cl_;
+
 // Thread-local OpenCL data.
 // This cannot be a non-pointer type.
 static
@@ -136,10 +160,10 @@ __declspec(thread)
 #else
 __thread
 #endif
-CLGlobal* oskar_cl_ = 0;
+CLThread* oskar_cl_thread_ = 0;
 
 // Global pointers to all thread-local objects.
-static vector<oskar::CLGlobal*> oskar_cl_all_;
+static vector<oskar::CLThread*> oskar_cl_all_;
 
 struct LocalMutex
 {
@@ -163,37 +187,79 @@ struct LocalMutex
 };
 static LocalMutex mutex;
 
+// Releases the kernels used by a thread when it exits.
+struct CLThreadExit
+{
+    ~CLThreadExit()
+    {
+        if (!oskar_cl_thread_) return;
+        mutex.lock();
+        for (size_t i = 0; i < oskar_cl_all_.size(); ++i)
+        {
+            if (oskar_cl_all_[i] == oskar_cl_thread_)
+            {
+                oskar_cl_all_.erase(oskar_cl_all_.begin() + i);
+                break;
+            }
+        }
+        oskar_cl_thread_->release_kernels();
+        mutex.unlock();
+        delete oskar_cl_thread_;
+        oskar_cl_thread_ = 0;
+    }
+};
+
+static void oskar_cl_init_devices(const char* device_type,
+        const char* device_vendor);
+
 void oskar_cl_ensure(int no_init)
 {
-    if (!oskar_cl_)
+    if (!oskar_cl_thread_)
     {
         // Allocate structure and store a pointer to it so it can be
         // accessed by oskar_cl_free().
-        oskar_cl_ = new oskar::CLGlobal();
+        static thread_local CLThreadExit thread_exit;
+        (void) thread_exit;
+        oskar_cl_thread_ = new oskar::CLThread();
         mutex.lock();
-        oskar_cl_all_.push_back(oskar_cl_);
+        oskar_cl_all_.push_back(oskar_cl_thread_);
+        mutex.unlock();
+    }
+    if (oskar_cl_.device.size() == 0 && !no_init)
+    {
+        // Set up the devices once, if no other thread has done so.
+        mutex.lock();
+        if (oskar_cl_.device.size() == 0)
+            oskar_cl_init_devices(NULL, NULL);
         mutex.unlock();
     }
-    if (oskar_cl_->device.size() == 0 && !no_init)
-        oskar_cl_init(NULL, NULL);
 }
 
 void oskar_cl_free(void)
 {
     mutex.lock();
     for (size_t i = 0; i < oskar_cl_all_.size(); ++i)
-        delete oskar_cl_all_[i];
-    oskar_cl_all_.clear();
+        oskar_cl_all_[i]->release_kernels();
+    oskar_cl_.clear();
     mutex.unlock();
 }
 
 void oskar_cl_init(const char* device_type, const char* device_vendor)
+{
+    oskar_cl_ensure(1);
+    mutex.lock();
+    oskar_cl_init_devices(device_type, device_vendor);
+    mutex.unlock();
+}
+
+// Must be called with the mutex locked.
+static void oskar_cl_init_devices(const char* device_type,
+        const char* device_vendor)
 {
 #ifdef OSKAR_HAVE_OPENCL
     cl_uint num_platforms = 0;
     cl_device_type dev_type = CL_DEVICE_TYPE_ALL;
     cl_int error = 0;
-    oskar_cl_ensure(1);
 
     // Get environment variables if parameters not given.
     if (!device_type || strlen(device_type) == 0)
@@ -232,13 +298,12 @@ void oskar_cl_init(const char* device_type, const char* device_vendor)
     }
 
     // Clear any existing contexts.
-    oskar_cl_->clear();
+    for (size_t i = 0; i < oskar_cl_all_.size(); ++i)
+        oskar_cl_all_[i]->release_kernels();
+    oskar_cl_.clear();
 
     // Get the OpenCL platform IDs.
-    // The first OpenCL call doesn't seem to be thread-safe.
-    mutex.lock();
     error = clGetPlatformIDs(0, 0, &num_platforms);
-    mutex.unlock();
     if (num_platforms == 0)
     {
         fprintf(stderr, "No OpenCL platforms found.\n");
@@ -291,8 +356,8 @@ void oskar_cl_init(const char* device_type, const char* device_vendor)
             }
 
             // Store the device ID, name, device and driver versions.
-            oskar_cl_->device.push_back(new CLGlobal::CLDevice());
-            CLGlobal::CLDevice* device = oskar_cl_->device.back();
+            oskar_cl_.device.push_back(new CLGlobal::CLDevice());
+            CLGlobal::CLDevice* device = oskar_cl_.device.back();
             device->id = devices[j];
             clGetDeviceInfo(devices[j], CL_DEVICE_NAME, 0, 0, &len);
             t = (char*) realloc(t, len);
@@ -382,35 +447,7 @@ void oskar_cl_init(const char* device_type, const char* device_vendor)
                 break;
             }
 
-            // Get all the kernels from the program.
-            cl_uint num_kernels = 0;
-            error = clCreateKernelsInProgram(device->program,
-                    0, NULL, &num_kernels);
-            if (error != CL_SUCCESS)
-            {
-                fprintf(stderr,
-                        "clCreateKernelsInProgram error (%d).\n", error);
-                break;
-            }
-            if (num_kernels == 0) continue;
-            vector<cl_kernel> kernels(num_kernels);
-            error = clCreateKernelsInProgram(device->program,
-                    num_kernels, &kernels[0], NULL);
-            if (error != CL_SUCCESS)
-            {
-                fprintf(stderr,
-                        "clCreateKernelsInProgram error (%d).\n", error);
-                break;
-            }
-            for (cl_uint k = 0; k < num_kernels; ++k)
-            {
-                clGetKernelInfo(kernels[k], CL_KERNEL_FUNCTION_NAME,
-                        0, NULL, &len);
-                t = (char*) realloc(t, len);
-                clGetKernelInfo(kernels[k], CL_KERNEL_FUNCTION_NAME,
-                        len, t, NULL);
-                device->kernel[string(t)] = kernels[k];
-            }
+            // Kernels are created by each thread when first needed.
             free(t);
         }
     }
@@ -425,36 +462,50 @@ void oskar_cl_init(const char* device_type, const char* device_vendor)
 cl_command_queue oskar_cl_command_queue(void)
 {
     oskar_cl_ensure(0);
-    unsigned int i = oskar_cl_->current_device;
-    return i < oskar_cl_->device.size() ? oskar_cl_->device[i]->queue : 0;
+    unsigned int i = oskar_cl_thread_->current_device;
+    return i < oskar_cl_.device.size() ? oskar_cl_.device[i]->queue : 0;
 }
 
 cl_context oskar_cl_context(void)
 {
     oskar_cl_ensure(0);
-    unsigned int i = oskar_cl_->current_device;
-    return i < oskar_cl_->device.size() ? oskar_cl_->device[i]->context : 0;
+    unsigned int i = oskar_cl_thread_->current_device;
+    return i < oskar_cl_.device.size() ? oskar_cl_.device[i]->context : 0;
 }
 
 cl_device_id oskar_cl_device_id(void)
 {
     oskar_cl_ensure(0);
-    unsigned int i = oskar_cl_->current_device;
-    return i < oskar_cl_->device.size() ? oskar_cl_->device[i]->id : 0;
+    unsigned int i = oskar_cl_thread_->current_device;
+    return i < oskar_cl_.device.size() ? oskar_cl_.device[i]->id : 0;
 }
 
 cl_kernel oskar_cl_kernel(const char* name)
 {
     oskar_cl_ensure(0);
-    unsigned int i = oskar_cl_->current_device;
-    if (i < oskar_cl_->device.size())
+    CLThread* t = oskar_cl_thread_;
+    unsigned int i = t->current_device;
+    if (i >= oskar_cl_.device.size() || !oskar_cl_.device[i]->program)
+        return 0;
+
+    // Discard kernels from programs that have since been freed.
+    if (t->generation != oskar_cl_.generation)
     {
-        CLGlobal::CLDevice* device = oskar_cl_->device[i];
-        map<string, cl_kernel>::iterator j = device->kernel.find(name);
-        if (j != device->kernel.end())
-            return j->second;
+        t->release_kernels();
+        t->generation = oskar_cl_.generation;
     }
-    return 0;
+    if (t->kernel.size() < oskar_cl_.device.size())
+        t->kernel.resize(oskar_cl_.device.size());
+
+    // Create the kernel for this thread if it has not been used yet.
+    map<string, cl_kernel>::iterator j = t->kernel[i].find(name);
+    if (j != t->kernel[i].end())
+        return j->second;
+    cl_int error = 0;
+    cl_kernel k = clCreateKernel(oskar_cl_.device[i]->program, name, &error);
+    if (error != CL_SUCCESS) k = 0;
+    t->kernel[i][string(name)] = k;
+    return k;
 }
 
 #endif
@@ -462,46 +513,46 @@ cl_kernel oskar_cl_kernel(const char* name)
 const char* oskar_cl_device_cl_version(void)
 {
     oskar_cl_ensure(0);
-    unsigned int i = oskar_cl_->current_device;
-    return i < oskar_cl_->device.size() ?
-            oskar_cl_->device[i]->cl_version.c_str() : 0;
+    unsigned int i = oskar_cl_thread_->current_device;
+    return i < oskar_cl_.device.size() ?
+            oskar_cl_.device[i]->cl_version.c_str() : 0;
 }
 
 const char* oskar_cl_device_driver_version(void)
 {
     oskar_cl_ensure(0);
-    unsigned int i = oskar_cl_->current_device;
-    return i < oskar_cl_->device.size() ?
-            oskar_cl_->device[i]->driver_version.c_str() : 0;
+    unsigned int i = oskar_cl_thread_->current_device;
+    return i < oskar_cl_.device.size() ?
+            oskar_cl_.device[i]->driver_version.c_str() : 0;
 }
 
 const char* oskar_cl_device_name(void)
 {
     oskar_cl_ensure(0);
-    unsigned int i = oskar_cl_->current_device;
-    return i < oskar_cl_->device.size() ?
-            oskar_cl_->device[i]->name.c_str() : 0;
+    unsigned int i = oskar_cl_thread_->current_device;
+    return i < oskar_cl_.device.size() ?
+            oskar_cl_.device[i]->name.c_str() : 0;
 }
 
 unsigned int oskar_cl_get_device(void)
 {
     oskar_cl_ensure(0);
-    return oskar_cl_->current_device;
+    return oskar_cl_thread_->current_device;
 }
 
 unsigned int oskar_cl_num_devices(void)
 {
     oskar_cl_ensure(0);
-    return (unsigned int) oskar_cl_->device.size();
+    return (unsigned int) oskar_cl_.device.size();
 }
 
 void oskar_cl_set_device(unsigned int device, int* status)
 {
     oskar_cl_ensure(0);
-    if (device >= oskar_cl_->device.size())
+    if (device >= oskar_cl_.device.size())
     {
         *status = OSKAR_ERR_OUT_OF_RANGE;
         return;
     }
-    oskar_cl_->current_device = device;
+    oskar_cl_thread_->current_device = device;
 }
@@ -68,6 +68,30 @@ void* thread_barriers(void* arg)
     return 0;
 }
 
+struct ConditionArgs
+{
+    int thread_id, num_threads, *counter;
+    oskar_ConditionVar* var;
+};
+typedef struct ConditionArgs ConditionArgs;
+
+void* thread_condition(void* arg)
+{
+    ConditionArgs* args = (ConditionArgs*) arg;
+    for (int i = 0; i < 4; ++i)
+    {
+        // Wait for this thread's turn, then pass it on to the next one.
+        oskar_condition_lock(args->var);
+        while (*(args->counter) % args->num_threads != args->thread_id)
+            oskar_condition_wait(args->var);
+        print_from_thread(i, args->thread_id, "My turn");
+        (*(args->counter))++;
+        oskar_condition_notify_all(args->var);
+        oskar_condition_unlock(args->var);
+    }
+    return 0;
+}
+
 TEST(thread, create_and_join)
 {
     // Get the number of CPU cores.
@@ -124,3 +148,41 @@ TEST(thread, barriers)
     free(args);
     free(threads);
 }
+
+TEST(thread, condition_variable)
+{
+    // Set the number of threads.
+    int num_threads = 4, counter = 0;
+
+    // Create the shared condition variable.
+    oskar_ConditionVar* var = oskar_condition_create();
+
+    // Allocate thread array and thread arguments for each thread.
+    oskar_Thread** threads = (oskar_Thread**)
+            calloc((size_t) num_threads, sizeof(oskar_Thread*));
+    ConditionArgs* args = (ConditionArgs*)
+            calloc((size_t) num_threads, sizeof(ConditionArgs));
+
+    // Start all the threads in reverse order.
+    for (int i = num_threads - 1; i >= 0; --i)
+    {
+        args[i].var = var;
+        args[i].counter = &counter;
+        args[i].num_threads = num_threads;
+        args[i].thread_id = i;
+        threads[i] = oskar_thread_create(thread_condition,
+                (void*)(&args[i]), 0);
+    }
+
+    // Wait for all threads to finish.
+    for (int i = 0; i < num_threads; ++i)
+        oskar_thread_join(threads[i]);
+    ASSERT_EQ(4 * num_threads, counter);
+
+    // Clean up.
+    for (int i = 0; i < num_threads; ++i)
+        oskar_thread_free(threads[i]);
+    oskar_condition_free(var);
+    free(args);
+    free(threads);
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_BDA_H_
+#define OSKAR_BDA_H_
+
+/**
+ * @file oskar_bda.h
+ */
+
+#include <oskar_global.h>
+#include <vis/oskar_vis_block.h>
+#include <vis/oskar_vis_header.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct oskar_BDA;
+#ifndef OSKAR_BDA_TYPEDEF_
+#define OSKAR_BDA_TYPEDEF_
+typedef struct oskar_BDA oskar_BDA;
+#endif /* OSKAR_BDA_TYPEDEF_ */
+
+/**
+ * @brief
+ * Creates a baseline-dependent averaging (BDA) stage.
+ *
+ * @details
+ * Creates a new processing stage that averages visibility data in time,
+ * by an amount that depends on the baseline.
+ *
+ * Visibility blocks are added in time order using oskar_bda_add_block().
+ * Consecutive time samples on each baseline are averaged together for as
+ * long as the baseline (u,v,w) track stays shorter than
+ * \p max_uvw_distance_wavelengths, and the averaging interval stays
+ * no longer than \p max_duration_sec. Short baselines move slowly in the
+ * (u,v,w) plane, so are averaged over more time samples than long baselines.
+ * The distance is evaluated at the highest frequency in the header,
+ * and all channels are averaged together.
+ *
+ * Averages may span multiple visibility blocks. Completed averages are
+ * held as rows in the order used by the Measurement Set, until they are
+ * removed using oskar_bda_clear_rows().
+ *
+ * The structure must be deallocated using oskar_bda_free() when it is
+ * no longer required.
+ *
+ * @param[in] hdr          Pointer to the visibility header.
+ * @param[in] num_pols_out Number of polarisations in the output rows (1 or 4).
+ * @param[in] max_duration_sec  Maximum averaging interval, in seconds.
+ * @param[in] max_uvw_distance_wavelengths  Maximum (u,v,w) distance moved
+ *                                          during an average, in wavelengths.
+ * @param[in,out]  status  Status return code.
+ *
+ * @return A handle to the new data structure.
+ */
+OSKAR_EXPORT
+oskar_BDA* oskar_bda_create(const oskar_VisHeader* hdr, int num_pols_out,
+        double max_duration_sec, double max_uvw_distance_wavelengths,
+        int* status);
+
+/**
+ * @brief
+ * Adds a visibility block to the baseline-dependent averages.
+ *
+ * @details
+ * Adds each time sample in the visibility block to the current average on
+ * each baseline, first completing any averages that would otherwise
+ * exceed the limits.
+ *
+ * Blocks must be added in time order, must contain all channels,
+ * and must be in CPU memory.
+ * If the block contains the last time sample in the observation,
+ * all averages are completed.
+ *
+ * @param[in,out] h        Handle to the BDA stage.
+ * @param[in] blk          Visibility block to add.
+ * @param[in,out]  status  Status return code.
+ */
+OSKAR_EXPORT
+void oskar_bda_add_block(oskar_BDA* h, const oskar_VisBlock* blk,
+        int* status);
+
+/**
+ * @brief
+ * Completes all current averages.
+ *
+ * @details
+ * Completes the current average on every baseline, so that all data added
+ * so far are available as output rows.
+ *
+ * @param[in,out] h        Handle to the BDA stage.
+ * @param[in,out]  status  Status return code.
+ */
+OSKAR_EXPORT
+void oskar_bda_flush(oskar_BDA* h, int* status);
+
+/**
+ * @brief
+ * Removes all completed output rows.
+ *
+ * @details
+ * Removes all completed output rows, once they have been written.
+ *
+ * @param[in,out] h        Handle to the BDA stage.
+ */
+OSKAR_EXPORT
+void oskar_bda_clear_rows(oskar_BDA* h);
+
+/**
+ * @brief
+ * Frees memory held by the BDA stage.
+ *
+ * @param[in,out] h        Handle to the BDA stage.
+ */
+OSKAR_EXPORT
+void oskar_bda_free(oskar_BDA* h);
+
+/* Accessors for completed output rows. */
+
+/**
+ * @brief Returns the number of completed output rows.
+ */
+OSKAR_EXPORT
+int oskar_bda_num_rows(const oskar_BDA* h);
+
+/**
+ * @brief Returns the total number of rows completed since creation.
+ */
+OSKAR_EXPORT
+int oskar_bda_num_rows_total(const oskar_BDA* h);
+
+/**
+ * @brief Returns the number of channels in each output row.
+ */
+OSKAR_EXPORT
+int oskar_bda_num_channels(const oskar_BDA* h);
+
+/**
+ * @brief Returns the number of polarisations in each output row.
+ */
+OSKAR_EXPORT
+int oskar_bda_num_pols(const oskar_BDA* h);
+
+/**
+ * @brief Returns the first station index of each output row.
+ */
+OSKAR_EXPORT
+const int* oskar_bda_antenna1(const oskar_BDA* h);
+
+/**
+ * @brief Returns the second station index of each output row.
+ */
+OSKAR_EXPORT
+const int* oskar_bda_antenna2(const oskar_BDA* h);
+
+/**
+ * @brief Returns the average baseline u-coordinate of each row, in metres.
+ */
+OSKAR_EXPORT
+const double* oskar_bda_uu_metres(const oskar_BDA* h);
+
+/**
+ * @brief Returns the average baseline v-coordinate of each row, in metres.
+ */
+OSKAR_EXPORT
+const double* oskar_bda_vv_metres(const oskar_BDA* h);
+
+/**
+ * @brief Returns the average baseline w-coordinate of each row, in metres.
+ */
+OSKAR_EXPORT
+const double* oskar_bda_ww_metres(const oskar_BDA* h);
+
+/**
+ * @brief
+ * Returns the centre time of each output row.
+ *
+ * @details
+ * Returns the centre time of each output row, in units of (MJD) * 86400,
+ * as used by the Measurement Set.
+ */
+OSKAR_EXPORT
+const double* oskar_bda_time_centroid(const oskar_BDA* h);
+
+/**
+ * @brief Returns the averaging interval of each output row, in seconds.
+ */
+OSKAR_EXPORT
+const double* oskar_bda_interval_sec(const oskar_BDA* h);
+
+/**
+ * @brief Returns the exposure time of each output row, in seconds.
+ */
+OSKAR_EXPORT
+const double* oskar_bda_exposure_sec(const oskar_BDA* h);
+
+/**
+ * @brief Returns the weight (number of samples averaged) of each row.
+ */
+OSKAR_EXPORT
+const double* oskar_bda_weight(const oskar_BDA* h);
+
+/**
+ * @brief
+ * Returns the averaged visibility amplitudes.
+ *
+ * @details
+ * Returns the averaged complex visibility amplitudes, with dimension order
+ * (slowest) row, channel, polarisation (fastest).
+ */
+OSKAR_EXPORT
+const float* oskar_bda_vis(const oskar_BDA* h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_BDA_H_ */
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SYSTEM_NOISE_INLINE_H_
+#define OSKAR_SYSTEM_NOISE_INLINE_H_
+
+/**
+ * @file oskar_system_noise_inline.h
+ */
+
+#include <oskar_global.h>
+#ifdef __CUDACC__
+/* Must include this first to avoid type conflicts. */
+#include <vector_types.h>
+#endif
+#include <utility/oskar_vector_types.h>
+#include <math/private_random_helpers.h>
+
+/* The Random123 generators are device-only functions under nvcc, so these
+ * must be device functions in both the host and device compilation passes. */
+#ifdef __CUDACC__
+#define OSKAR_SYSTEM_NOISE_INLINE __device__ __forceinline__
+#else
+#define OSKAR_SYSTEM_NOISE_INLINE OSKAR_INLINE
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Each function adds noise to a single visibility, using random numbers
+ * generated from the given counter, so that each visibility can be
+ * processed independently of all others.
+ *
+ * Scalar visibilities use one pair of random numbers per counter value,
+ * while polarised visibilities use two sets of four, from counter values
+ * counter and counter + 1.
+ */
+
+/**
+ * @brief
+ * Adds noise to a scalar cross-correlation (single precision).
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       Counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std1          Noise standard deviation of first station.
+ * @param[in] std2          Noise standard deviation of second station.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_cross_scalar_f(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const float std1, const float std2, float2* vis)
+{
+    double r[2], std;
+    OSKAR_R123_GENERATE_2(seed, counter, block_idx)
+    oskar_box_muller_d(u.i[0], u.i[1], &r[0], &r[1]);
+    std = sqrt((double)(std1 * std2)) * (1.0 / sqrt(2.0));
+    vis->x += std * r[0];
+    vis->y += std * r[1];
+}
+
+/**
+ * @brief
+ * Adds noise to a scalar cross-correlation (double precision).
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       Counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std1          Noise standard deviation of first station.
+ * @param[in] std2          Noise standard deviation of second station.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_cross_scalar_d(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const double std1, const double std2, double2* vis)
+{
+    double r[2], std;
+    OSKAR_R123_GENERATE_2(seed, counter, block_idx)
+    oskar_box_muller_d(u.i[0], u.i[1], &r[0], &r[1]);
+    std = sqrt(std1 * std2) * (1.0 / sqrt(2.0));
+    vis->x += std * r[0];
+    vis->y += std * r[1];
+}
+
+/**
+ * @brief
+ * Adds noise to a scalar autocorrelation (single precision).
+ *
+ * @details
+ * Phases are all zero after autocorrelation, so the imaginary component
+ * is not modified.
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       Counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std           Noise standard deviation of the station.
+ * @param[in] sefd_factor   Factor for conversion of sigma to SEFD.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_auto_scalar_f(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const float std, const double sefd_factor, float2* vis)
+{
+    double r[2], mean;
+    OSKAR_R123_GENERATE_2(seed, counter, block_idx)
+    oskar_box_muller_d(u.i[0], u.i[1], &r[0], &r[1]);
+    mean = sqrt(2.0) * std;
+    vis->x += (double)std * r[0] + mean * sefd_factor;
+}
+
+/**
+ * @brief
+ * Adds noise to a scalar autocorrelation (double precision).
+ *
+ * @details
+ * Phases are all zero after autocorrelation, so the imaginary component
+ * is not modified.
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       Counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std           Noise standard deviation of the station.
+ * @param[in] sefd_factor   Factor for conversion of sigma to SEFD.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_auto_scalar_d(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const double std, const double sefd_factor, double2* vis)
+{
+    double r[2], mean;
+    OSKAR_R123_GENERATE_2(seed, counter, block_idx)
+    oskar_box_muller_d(u.i[0], u.i[1], &r[0], &r[1]);
+    mean = std * sefd_factor * sqrt(2.0);
+    vis->x += std * r[0] + mean;
+}
+
+/* Generates eight Gaussian random numbers from two consecutive counters. */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_gaussian8(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        double r[8])
+{
+    {
+        OSKAR_R123_GENERATE_4(seed, counter, block_idx, 0, 0)
+        oskar_box_muller_d(u.i[0], u.i[1], &r[0], &r[1]);
+        oskar_box_muller_d(u.i[2], u.i[3], &r[2], &r[3]);
+    }
+    {
+        OSKAR_R123_GENERATE_4(seed, counter + 1, block_idx, 0, 0)
+        oskar_box_muller_d(u.i[0], u.i[1], &r[4], &r[5]);
+        oskar_box_muller_d(u.i[2], u.i[3], &r[6], &r[7]);
+    }
+}
+
+/**
+ * @brief
+ * Adds noise to a polarised cross-correlation (single precision).
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       First counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std1          Noise standard deviation of first station.
+ * @param[in] std2          Noise standard deviation of second station.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_cross_matrix_f(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const float std1, const float std2, float4c* vis)
+{
+    double r[8], std;
+    oskar_system_noise_gaussian8(seed, counter, block_idx, r);
+    std = sqrt((double)(std1 * std2));
+    vis->a.x += std * r[0];
+    vis->a.y += std * r[1];
+    vis->b.x += std * r[2];
+    vis->b.y += std * r[3];
+    vis->c.x += std * r[4];
+    vis->c.y += std * r[5];
+    vis->d.x += std * r[6];
+    vis->d.y += std * r[7];
+}
+
+/**
+ * @brief
+ * Adds noise to a polarised cross-correlation (double precision).
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       First counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std1          Noise standard deviation of first station.
+ * @param[in] std2          Noise standard deviation of second station.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_cross_matrix_d(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const double std1, const double std2, double4c* vis)
+{
+    double r[8], std;
+    oskar_system_noise_gaussian8(seed, counter, block_idx, r);
+    std = sqrt(std1 * std2);
+    vis->a.x += std * r[0];
+    vis->a.y += std * r[1];
+    vis->b.x += std * r[2];
+    vis->b.y += std * r[3];
+    vis->c.x += std * r[4];
+    vis->c.y += std * r[5];
+    vis->d.x += std * r[6];
+    vis->d.y += std * r[7];
+}
+
+/**
+ * @brief
+ * Adds noise to a polarised autocorrelation (single precision).
+ *
+ * @details
+ * Phases are all zero after autocorrelation, so the imaginary components
+ * of the diagonal terms are not modified.
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       First counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std           Noise standard deviation of the station.
+ * @param[in] sefd_factor   Factor for conversion of sigma to SEFD.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_auto_matrix_f(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const float std, const double sefd_factor, float4c* vis)
+{
+    double r[8], s, mean;
+    oskar_system_noise_gaussian8(seed, counter, block_idx, r);
+    s = std * sqrt(2.0);
+    mean = s * sefd_factor;
+    vis->a.x += s * r[0] + mean;
+    vis->b.x += s * r[1];
+    vis->b.y += s * r[2];
+    vis->c.x += s * r[3];
+    vis->c.y += s * r[4];
+    vis->d.x += s * r[5] + mean;
+}
+
+/**
+ * @brief
+ * Adds noise to a polarised autocorrelation (double precision).
+ *
+ * @details
+ * Phases are all zero after autocorrelation, so the imaginary components
+ * of the diagonal terms are not modified.
+ *
+ * @param[in] seed          Random number seed.
+ * @param[in] counter       First counter value for this visibility.
+ * @param[in] block_idx     Visibility block index.
+ * @param[in] std           Noise standard deviation of the station.
+ * @param[in] sefd_factor   Factor for conversion of sigma to SEFD.
+ * @param[in,out] vis       Visibility to which to add noise.
+ */
+OSKAR_SYSTEM_NOISE_INLINE
+void oskar_system_noise_auto_matrix_d(const unsigned int seed,
+        const unsigned int counter, const unsigned int block_idx,
+        const double std, const double sefd_factor, double4c* vis)
+{
+    double r[8], s, mean;
+    oskar_system_noise_gaussian8(seed, counter, block_idx, r);
+    s = std * sqrt(2.0);
+    mean = s * sefd_factor;
+    vis->a.x += s * r[0] + mean;
+    vis->b.x += s * r[1];
+    vis->b.y += s * r[2];
+    vis->c.x += s * r[3];
+    vis->c.y += s * r[4];
+    vis->d.x += s * r[5] + mean;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SYSTEM_NOISE_INLINE_H_ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2016, The University of Oxford
+ * Copyright (c) 2015-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -66,6 +66,7 @@ enum OSKAR_VIS_BLOCK_TAGS
 #include <vis/oskar_vis_block_clear.h>
 #include <vis/oskar_vis_block_copy.h>
 #include <vis/oskar_vis_block_create.h>
+#include <vis/oskar_vis_block_create_alias_from_binary.h>
 #include <vis/oskar_vis_block_create_from_header.h>
 #include <vis/oskar_vis_block_free.h>
 #include <vis/oskar_vis_block_read.h>
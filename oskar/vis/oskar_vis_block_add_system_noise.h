@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2016, The University of Oxford
+ * Copyright (c) 2015-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -44,10 +44,21 @@ extern "C" {
 /**
  * @brief Add a random Gaussian noise component to the visibilities.
  *
+ * @details
+ * Adds uncorrelated system noise to all channels and times in the
+ * visibility block, which may be in either CPU or GPU memory.
+ *
+ * Random numbers are generated using a counter-based generator, with
+ * counters derived directly from the block, time, baseline and station
+ * indices, so the result is the same regardless of the number of threads
+ * used, or the device on which the block is stored.
+ *
  * @param[in,out] vis             Visibility structure to which to add noise.
- * @param[in]     telescope       Telescope model in use.
+ * @param[in]     header          Visibility header.
+ * @param[in]     telescope       Telescope model in use (in CPU memory).
  * @param[in]     block_index     Simulation time index for the block.
- * @param[in,out] station_work    Work buffer of length num_stations.
+ * @param[in,out] station_work    Work buffer in CPU memory, resized to
+ *                                num_channels * num_stations if needed.
  * @param[in,out] status          Status return code.
  */
 OSKAR_EXPORT
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_VIS_BLOCK_ADD_SYSTEM_NOISE_CUDA_H_
+#define OSKAR_VIS_BLOCK_ADD_SYSTEM_NOISE_CUDA_H_
+
+/**
+ * @file oskar_vis_block_add_system_noise_cuda.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Adds system noise to scalar visibilities using CUDA (single precision).
+ *
+ * @details
+ * Adds uncorrelated Gaussian noise to all cross- and autocorrelations in
+ * a visibility block, for all channels and times. Each visibility derives
+ * its random number counter from its time and baseline index, so the
+ * result does not depend on the order of evaluation.
+ *
+ * Note that all pointers refer to device memory.
+ *
+ * @param[in] num_times       Number of times in the block.
+ * @param[in] num_channels    Number of channels in the block.
+ * @param[in] num_stations    Number of stations.
+ * @param[in] seed            Random number seed.
+ * @param[in] block_idx       Visibility block index.
+ * @param[in] d_station_std   Noise standard deviation for each channel
+ *                            and station (station index fastest varying).
+ * @param[in] sefd_factor     Factor for conversion of sigma to SEFD.
+ * @param[in,out] d_xcorr     Cross-correlations (or NULL if not present).
+ * @param[in,out] d_acorr     Autocorrelations (or NULL if not present).
+ */
+OSKAR_EXPORT
+void oskar_vis_block_add_system_noise_cuda_scalar_f(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const float* d_station_std,
+        double sefd_factor, float2* d_xcorr, float2* d_acorr);
+
+/**
+ * @brief
+ * Adds system noise to scalar visibilities using CUDA (double precision).
+ *
+ * @details
+ * Adds uncorrelated Gaussian noise to all cross- and autocorrelations in
+ * a visibility block, for all channels and times. Each visibility derives
+ * its random number counter from its time and baseline index, so the
+ * result does not depend on the order of evaluation.
+ *
+ * Note that all pointers refer to device memory.
+ *
+ * @param[in] num_times       Number of times in the block.
+ * @param[in] num_channels    Number of channels in the block.
+ * @param[in] num_stations    Number of stations.
+ * @param[in] seed            Random number seed.
+ * @param[in] block_idx       Visibility block index.
+ * @param[in] d_station_std   Noise standard deviation for each channel
+ *                            and station (station index fastest varying).
+ * @param[in] sefd_factor     Factor for conversion of sigma to SEFD.
+ * @param[in,out] d_xcorr     Cross-correlations (or NULL if not present).
+ * @param[in,out] d_acorr     Autocorrelations (or NULL if not present).
+ */
+OSKAR_EXPORT
+void oskar_vis_block_add_system_noise_cuda_scalar_d(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const double* d_station_std,
+        double sefd_factor, double2* d_xcorr, double2* d_acorr);
+
+/**
+ * @brief
+ * Adds system noise to polarised visibilities using CUDA (single precision).
+ *
+ * @details
+ * Adds uncorrelated Gaussian noise to all cross- and autocorrelations in
+ * a visibility block, for all channels and times. Each visibility derives
+ * its random number counter from its time and baseline index, so the
+ * result does not depend on the order of evaluation.
+ *
+ * Note that all pointers refer to device memory.
+ *
+ * @param[in] num_times       Number of times in the block.
+ * @param[in] num_channels    Number of channels in the block.
+ * @param[in] num_stations    Number of stations.
+ * @param[in] seed            Random number seed.
+ * @param[in] block_idx       Visibility block index.
+ * @param[in] d_station_std   Noise standard deviation for each channel
+ *                            and station (station index fastest varying).
+ * @param[in] sefd_factor     Factor for conversion of sigma to SEFD.
+ * @param[in,out] d_xcorr     Cross-correlations (or NULL if not present).
+ * @param[in,out] d_acorr     Autocorrelations (or NULL if not present).
+ */
+OSKAR_EXPORT
+void oskar_vis_block_add_system_noise_cuda_matrix_f(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const float* d_station_std,
+        double sefd_factor, float4c* d_xcorr, float4c* d_acorr);
+
+/**
+ * @brief
+ * Adds system noise to polarised visibilities using CUDA (double precision).
+ *
+ * @details
+ * Adds uncorrelated Gaussian noise to all cross- and autocorrelations in
+ * a visibility block, for all channels and times. Each visibility derives
+ * its random number counter from its time and baseline index, so the
+ * result does not depend on the order of evaluation.
+ *
+ * Note that all pointers refer to device memory.
+ *
+ * @param[in] num_times       Number of times in the block.
+ * @param[in] num_channels    Number of channels in the block.
+ * @param[in] num_stations    Number of stations.
+ * @param[in] seed            Random number seed.
+ * @param[in] block_idx       Visibility block index.
+ * @param[in] d_station_std   Noise standard deviation for each channel
+ *                            and station (station index fastest varying).
+ * @param[in] sefd_factor     Factor for conversion of sigma to SEFD.
+ * @param[in,out] d_xcorr     Cross-correlations (or NULL if not present).
+ * @param[in,out] d_acorr     Autocorrelations (or NULL if not present).
+ */
+OSKAR_EXPORT
+void oskar_vis_block_add_system_noise_cuda_matrix_d(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const double* d_station_std,
+        double sefd_factor, double4c* d_xcorr, double4c* d_acorr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_VIS_BLOCK_ADD_SYSTEM_NOISE_CUDA_H_ */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_VIS_BLOCK_CREATE_ALIAS_FROM_BINARY_H_
+#define OSKAR_VIS_BLOCK_CREATE_ALIAS_FROM_BINARY_H_
+
+/**
+ * @file oskar_vis_block_create_alias_from_binary.h
+ */
+
+#include <oskar_global.h>
+#include <binary/oskar_binary.h>
+#include <vis/oskar_vis_header.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Creates a read-only visibility block that aliases data in a mapped file.
+ *
+ * @details
+ * This function creates a visibility block in CPU memory holding the
+ * data for one block of an OSKAR binary visibility file.
+ *
+ * If the file was opened in mode 'm' (see oskar_binary_create()),
+ * the visibility and coordinate arrays in the block are aliases of the
+ * payloads in the mapped file, so no data are copied. Arrays whose payloads
+ * are not suitably aligned, or that come from a file that is not mapped,
+ * are read into memory owned by the block instead.
+ *
+ * The block must not be modified, and it must be freed using
+ * oskar_vis_block_free() before the binary file handle is freed.
+ *
+ * Unlike oskar_vis_block_read(), this function does not modify the file
+ * handle, so if the file is mapped, it may be called concurrently from
+ * multiple threads to read different blocks of the same file.
+ *
+ * @param[in]     hdr         The visibility header.
+ * @param[in]     h           The OSKAR binary file handle, opened for read.
+ * @param[in]     block_index The visibility block index.
+ * @param[in,out] status      Status return code.
+ *
+ * @return A handle to the new visibility block.
+ */
+OSKAR_EXPORT
+oskar_VisBlock* oskar_vis_block_create_alias_from_binary(
+        const oskar_VisHeader* hdr, oskar_Binary* h, int block_index,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_VIS_BLOCK_CREATE_ALIAS_FROM_BINARY_H_ */
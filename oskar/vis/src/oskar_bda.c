@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vis/oskar_bda.h"
+#include "math/oskar_cmath.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define C_0 299792458.0
+
+struct oskar_BDA
+{
+    /* Dimensions and settings. */
+    int num_stations, num_baselines, num_rows_per_time, num_times_total;
+    int num_channels, num_pols_in, num_pols_out, max_samples;
+    double max_distance_metres, time_start_sec, time_inc_sec;
+    double time_average_sec;
+
+    /* Source of each row within a time step, and its station indices. */
+    int *row_src, *row_a1, *row_a2;
+
+    /* Current average on each row. */
+    int *ave_count, *ave_start;
+    double *ave_dist, *ave_uu, *ave_vv, *ave_ww;
+    double *last_uu, *last_vv, *last_ww;
+    double* ave_vis; /* Dimension order: channel, row, polarisation. */
+
+    /* Completed output rows. */
+    int num_rows, num_rows_total, capacity;
+    int *ant1, *ant2;
+    double *uu, *vv, *ww, *time, *interval, *exposure, *weight;
+    float* vis;
+};
+
+static void* grow(void* ptr, size_t size_bytes, int* status)
+{
+    void* t;
+    if (*status) return ptr;
+    t = realloc(ptr, size_bytes);
+    if (!t)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return ptr;
+    }
+    return t;
+}
+
+/* Completes the current average on a row, and appends it to the output. */
+static void complete_average(oskar_BDA* h, int r, int* status)
+{
+    int c, i, k;
+    size_t n;
+    double s;
+    float* out;
+    const int count = h->ave_count[r];
+    const int n_in = 2 * h->num_pols_in, n_out = 2 * h->num_pols_out;
+    if (*status || count == 0) return;
+
+    /* Resize the output arrays if needed. */
+    if (h->num_rows >= h->capacity)
+    {
+        h->capacity += h->num_rows_per_time;
+        n = (size_t) h->capacity;
+        h->ant1 = (int*) grow(h->ant1, n * sizeof(int), status);
+        h->ant2 = (int*) grow(h->ant2, n * sizeof(int), status);
+        h->uu = (double*) grow(h->uu, n * sizeof(double), status);
+        h->vv = (double*) grow(h->vv, n * sizeof(double), status);
+        h->ww = (double*) grow(h->ww, n * sizeof(double), status);
+        h->time = (double*) grow(h->time, n * sizeof(double), status);
+        h->interval = (double*) grow(h->interval, n * sizeof(double), status);
+        h->exposure = (double*) grow(h->exposure, n * sizeof(double), status);
+        h->weight = (double*) grow(h->weight, n * sizeof(double), status);
+        h->vis = (float*) grow(h->vis,
+                n * h->num_channels * n_out * sizeof(float), status);
+        if (*status) return;
+    }
+
+    /* Store the averaged coordinates and row metadata. */
+    s = 1.0 / count;
+    i = h->num_rows++;
+    h->num_rows_total++;
+    h->ant1[i] = h->row_a1[r];
+    h->ant2[i] = h->row_a2[r];
+    h->uu[i] = h->ave_uu[r] * s;
+    h->vv[i] = h->ave_vv[r] * s;
+    h->ww[i] = h->ave_ww[r] * s;
+    h->time[i] = h->time_start_sec +
+            (h->ave_start[r] + 0.5 * count) * h->time_inc_sec;
+    h->interval[i] = count * h->time_inc_sec;
+    h->exposure[i] = count * h->time_average_sec;
+    h->weight[i] = (double) count;
+
+    /* Store the averaged amplitudes, and clear the accumulators. */
+    out = h->vis + (size_t) i * h->num_channels * n_out;
+    for (c = 0; c < h->num_channels; ++c, out += n_out)
+    {
+        double* in = h->ave_vis +
+                n_in * ((size_t) c * h->num_rows_per_time + r);
+        if (n_in == n_out)
+        {
+            for (k = 0; k < n_in; ++k) out[k] = (float) (in[k] * s);
+        }
+        else
+        {
+            /* Scalar data: XX = YY = amplitude, XY = YX = 0. */
+            out[0] = (float) (in[0] * s); out[1] = (float) (in[1] * s);
+            out[2] = 0.0f;                out[3] = 0.0f;
+            out[4] = 0.0f;                out[5] = 0.0f;
+            out[6] = out[0];              out[7] = out[1];
+        }
+        for (k = 0; k < n_in; ++k) in[k] = 0.0;
+    }
+    h->ave_count[r] = 0;
+    h->ave_dist[r] = 0.0;
+    h->ave_uu[r] = 0.0;
+    h->ave_vv[r] = 0.0;
+    h->ave_ww[r] = 0.0;
+}
+
+static void accumulate_f(oskar_BDA* h, int t, const float* xcorr,
+        const float* acorr)
+{
+    int c, k, r;
+    const int n_in = 2 * h->num_pols_in;
+    for (c = 0; c < h->num_channels; ++c)
+    {
+        const int tc = h->num_channels * t + c;
+        double* out = h->ave_vis + (size_t) n_in * h->num_rows_per_time * c;
+        for (r = 0; r < h->num_rows_per_time; ++r, out += n_in)
+        {
+            const int src = h->row_src[r];
+            const float* in = (src < 0) ?
+                    acorr + n_in * (h->num_stations * tc - src - 1) :
+                    xcorr + n_in * (h->num_baselines * tc + src);
+            for (k = 0; k < n_in; ++k) out[k] += in[k];
+        }
+    }
+}
+
+static void accumulate_d(oskar_BDA* h, int t, const double* xcorr,
+        const double* acorr)
+{
+    int c, k, r;
+    const int n_in = 2 * h->num_pols_in;
+    for (c = 0; c < h->num_channels; ++c)
+    {
+        const int tc = h->num_channels * t + c;
+        double* out = h->ave_vis + (size_t) n_in * h->num_rows_per_time * c;
+        for (r = 0; r < h->num_rows_per_time; ++r, out += n_in)
+        {
+            const int src = h->row_src[r];
+            const double* in = (src < 0) ?
+                    acorr + n_in * (h->num_stations * tc - src - 1) :
+                    xcorr + n_in * (h->num_baselines * tc + src);
+            for (k = 0; k < n_in; ++k) out[k] += in[k];
+        }
+    }
+}
+
+oskar_BDA* oskar_bda_create(const oskar_VisHeader* hdr, int num_pols_out,
+        double max_duration_sec, double max_uvw_distance_wavelengths,
+        int* status)
+{
+    oskar_BDA* h;
+    int a1, a2, b, i, have_autocorr, have_crosscorr, n;
+    double freq_max_hz;
+    if (*status) return 0;
+
+    /* Create and initialise the structure. */
+    h = (oskar_BDA*) calloc(1, sizeof(oskar_BDA));
+    n = oskar_vis_header_num_stations(hdr);
+    have_autocorr = oskar_vis_header_write_auto_correlations(hdr);
+    have_crosscorr = oskar_vis_header_write_cross_correlations(hdr);
+    h->num_stations = n;
+    h->num_baselines = n * (n - 1) / 2;
+    h->num_rows_per_time = (have_crosscorr ? h->num_baselines : 0) +
+            (have_autocorr ? n : 0);
+    h->num_times_total = oskar_vis_header_num_times_total(hdr);
+    h->num_channels = oskar_vis_header_num_channels_total(hdr);
+    h->num_pols_in = oskar_type_is_matrix(oskar_vis_header_amp_type(hdr)) ?
+            4 : 1;
+    h->num_pols_out = num_pols_out;
+    h->time_start_sec = oskar_vis_header_time_start_mjd_utc(hdr) * 86400.0;
+    h->time_inc_sec = oskar_vis_header_time_inc_sec(hdr);
+    h->time_average_sec = oskar_vis_header_time_average_sec(hdr);
+
+    /* Check the polarisation dimension: num_pols_in can be less than
+     * num_pols_out, but not vice-versa. */
+    if ((num_pols_out != 1 && num_pols_out != 4) ||
+            h->num_pols_in > num_pols_out)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        free(h);
+        return 0;
+    }
+
+    /* Get the limits. The (u,v,w) distance is converted to metres at the
+     * highest frequency, where it is most restrictive. */
+    freq_max_hz = oskar_vis_header_freq_start_hz(hdr);
+    if (oskar_vis_header_freq_inc_hz(hdr) > 0.0)
+        freq_max_hz += (h->num_channels - 1) *
+                oskar_vis_header_freq_inc_hz(hdr);
+    if (!(freq_max_hz > 0.0) || !(h->time_inc_sec > 0.0))
+    {
+        *status = OSKAR_ERR_OUT_OF_RANGE;
+        free(h);
+        return 0;
+    }
+    h->max_distance_metres = max_uvw_distance_wavelengths * C_0 / freq_max_hz;
+    h->max_samples = (int) floor(max_duration_sec / h->time_inc_sec + 1e-6);
+    if (h->max_samples < 1) h->max_samples = 1;
+
+    /* Get the source of each output row within a time step, in the order
+     * used by the Measurement Set:
+     * non-negative values are cross-correlation baseline indices,
+     * negative values are -(1 + station index) for auto-correlations. */
+    n = h->num_rows_per_time;
+    h->row_src = (int*) calloc(n, sizeof(int));
+    h->row_a1 = (int*) calloc(n, sizeof(int));
+    h->row_a2 = (int*) calloc(n, sizeof(int));
+    for (a1 = 0, b = 0, i = 0; a1 < h->num_stations; ++a1)
+    {
+        if (have_autocorr)
+        {
+            h->row_a1[i] = a1;
+            h->row_a2[i] = a1;
+            h->row_src[i++] = -(1 + a1);
+        }
+        if (have_crosscorr)
+        {
+            for (a2 = a1 + 1; a2 < h->num_stations; ++a2)
+            {
+                h->row_a1[i] = a1;
+                h->row_a2[i] = a2;
+                h->row_src[i++] = b++;
+            }
+        }
+    }
+
+    /* Allocate the accumulators. */
+    h->ave_count = (int*) calloc(n, sizeof(int));
+    h->ave_start = (int*) calloc(n, sizeof(int));
+    h->ave_dist = (double*) calloc(n, sizeof(double));
+    h->ave_uu = (double*) calloc(n, sizeof(double));
+    h->ave_vv = (double*) calloc(n, sizeof(double));
+    h->ave_ww = (double*) calloc(n, sizeof(double));
+    h->last_uu = (double*) calloc(n, sizeof(double));
+    h->last_vv = (double*) calloc(n, sizeof(double));
+    h->last_ww = (double*) calloc(n, sizeof(double));
+    h->ave_vis = (double*) calloc((size_t) n * h->num_channels *
+            2 * h->num_pols_in, sizeof(double));
+    if (!h->ave_vis && n > 0 && h->num_channels > 0)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        oskar_bda_free(h);
+        return 0;
+    }
+    return h;
+}
+
+void oskar_bda_add_block(oskar_BDA* h, const oskar_VisBlock* blk,
+        int* status)
+{
+    int r, t, num_times, start_time, prec;
+    const oskar_Mem *uu, *vv, *ww, *xcorr, *acorr;
+    if (*status) return;
+
+    /* Check the block is compatible. */
+    if (oskar_vis_block_location(blk) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    if (oskar_vis_block_num_stations(blk) != h->num_stations ||
+            oskar_vis_block_num_channels(blk) != h->num_channels ||
+            oskar_vis_block_start_channel_index(blk) != 0 ||
+            oskar_vis_block_num_pols(blk) != h->num_pols_in)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+    num_times = oskar_vis_block_num_times(blk);
+    start_time = oskar_vis_block_start_time_index(blk);
+    uu = oskar_vis_block_baseline_uu_metres_const(blk);
+    vv = oskar_vis_block_baseline_vv_metres_const(blk);
+    ww = oskar_vis_block_baseline_ww_metres_const(blk);
+    xcorr = oskar_vis_block_cross_correlations_const(blk);
+    acorr = oskar_vis_block_auto_correlations_const(blk);
+    prec = oskar_mem_precision(xcorr);
+
+    /* Loop over time samples in the block. */
+    for (t = 0; t < num_times; ++t)
+    {
+        /* Complete any averages that would go beyond the limits if this
+         * sample were added, then add the coordinates of this sample. */
+        for (r = 0; r < h->num_rows_per_time; ++r)
+        {
+            double u = 0.0, v = 0.0, w = 0.0, d = 0.0;
+            const int src = h->row_src[r];
+            if (src >= 0)
+            {
+                const size_t j = (size_t) h->num_baselines * t + src;
+                if (prec == OSKAR_DOUBLE)
+                {
+                    u = oskar_mem_double_const(uu, status)[j];
+                    v = oskar_mem_double_const(vv, status)[j];
+                    w = oskar_mem_double_const(ww, status)[j];
+                }
+                else
+                {
+                    u = oskar_mem_float_const(uu, status)[j];
+                    v = oskar_mem_float_const(vv, status)[j];
+                    w = oskar_mem_float_const(ww, status)[j];
+                }
+            }
+            if (h->ave_count[r] > 0)
+            {
+                const double du = u - h->last_uu[r];
+                const double dv = v - h->last_vv[r];
+                const double dw = w - h->last_ww[r];
+                d = sqrt(du * du + dv * dv + dw * dw);
+                if (h->ave_dist[r] + d > h->max_distance_metres ||
+                        h->ave_count[r] >= h->max_samples)
+                {
+                    complete_average(h, r, status);
+                    d = 0.0;
+                }
+            }
+            if (h->ave_count[r] == 0)
+                h->ave_start[r] = start_time + t;
+            h->ave_count[r]++;
+            h->ave_dist[r] += d;
+            h->ave_uu[r] += u;
+            h->ave_vv[r] += v;
+            h->ave_ww[r] += w;
+            h->last_uu[r] = u;
+            h->last_vv[r] = v;
+            h->last_ww[r] = w;
+        }
+        if (*status) return;
+
+        /* Add the amplitudes of this sample. */
+        if (prec == OSKAR_DOUBLE)
+            accumulate_d(h, t, oskar_mem_double_const(xcorr, status),
+                    oskar_mem_double_const(acorr, status));
+        else
+            accumulate_f(h, t, oskar_mem_float_const(xcorr, status),
+                    oskar_mem_float_const(acorr, status));
+    }
+
+    /* Complete all averages at the end of the observation. */
+    if (start_time + num_times >= h->num_times_total)
+        oskar_bda_flush(h, status);
+}
+
+void oskar_bda_flush(oskar_BDA* h, int* status)
+{
+    int r;
+    for (r = 0; r < h->num_rows_per_time; ++r)
+        complete_average(h, r, status);
+}
+
+void oskar_bda_clear_rows(oskar_BDA* h)
+{
+    h->num_rows = 0;
+}
+
+void oskar_bda_free(oskar_BDA* h)
+{
+    if (!h) return;
+    free(h->row_src);
+    free(h->row_a1);
+    free(h->row_a2);
+    free(h->ave_count);
+    free(h->ave_start);
+    free(h->ave_dist);
+    free(h->ave_uu);
+    free(h->ave_vv);
+    free(h->ave_ww);
+    free(h->last_uu);
+    free(h->last_vv);
+    free(h->last_ww);
+    free(h->ave_vis);
+    free(h->ant1);
+    free(h->ant2);
+    free(h->uu);
+    free(h->vv);
+    free(h->ww);
+    free(h->time);
+    free(h->interval);
+    free(h->exposure);
+    free(h->weight);
+    free(h->vis);
+    free(h);
+}
+
+int oskar_bda_num_rows(const oskar_BDA* h)
+{
+    return h->num_rows;
+}
+
+int oskar_bda_num_rows_total(const oskar_BDA* h)
+{
+    return h->num_rows_total;
+}
+
+int oskar_bda_num_channels(const oskar_BDA* h)
+{
+    return h->num_channels;
+}
+
+int oskar_bda_num_pols(const oskar_BDA* h)
+{
+    return h->num_pols_out;
+}
+
+const int* oskar_bda_antenna1(const oskar_BDA* h)
+{
+    return h->ant1;
+}
+
+const int* oskar_bda_antenna2(const oskar_BDA* h)
+{
+    return h->ant2;
+}
+
+const double* oskar_bda_uu_metres(const oskar_BDA* h)
+{
+    return h->uu;
+}
+
+const double* oskar_bda_vv_metres(const oskar_BDA* h)
+{
+    return h->vv;
+}
+
+const double* oskar_bda_ww_metres(const oskar_BDA* h)
+{
+    return h->ww;
+}
+
+const double* oskar_bda_time_centroid(const oskar_BDA* h)
+{
+    return h->time;
+}
+
+const double* oskar_bda_interval_sec(const oskar_BDA* h)
+{
+    return h->interval;
+}
+
+const double* oskar_bda_exposure_sec(const oskar_BDA* h)
+{
+    return h->exposure;
+}
+
+const double* oskar_bda_weight(const oskar_BDA* h)
+{
+    return h->weight;
+}
+
+const float* oskar_bda_vis(const oskar_BDA* h)
+{
+    return h->vis;
+}
+
+#ifdef __cplusplus
+}
+#endif
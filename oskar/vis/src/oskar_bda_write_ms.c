@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ms/oskar_measurement_set.h"
+#include "vis/oskar_bda_write_ms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_bda_write_ms(oskar_BDA* h, oskar_MeasurementSet* ms, int* status)
+{
+    unsigned int num_rows, start_row;
+    if (*status) return;
+
+    /* Check that there is something to write. */
+    num_rows = (unsigned int) oskar_bda_num_rows(h);
+    if (num_rows == 0) return;
+
+    /* Check the dimensions match. */
+    if ((int) oskar_ms_num_pols(ms) != oskar_bda_num_pols(h) ||
+            (int) oskar_ms_num_channels(ms) != oskar_bda_num_channels(h))
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Append the rows to the main table, and remove them from the stage. */
+    start_row = oskar_ms_num_rows(ms);
+    oskar_ms_write_vis_rows_f(ms, start_row, 0, oskar_bda_num_channels(h),
+            num_rows, oskar_bda_vis(h));
+    oskar_ms_write_coords_rows_d(ms, start_row, num_rows,
+            oskar_bda_antenna1(h), oskar_bda_antenna2(h),
+            oskar_bda_uu_metres(h), oskar_bda_vv_metres(h),
+            oskar_bda_ww_metres(h), oskar_bda_exposure_sec(h),
+            oskar_bda_interval_sec(h), oskar_bda_time_centroid(h),
+            oskar_bda_weight(h));
+    oskar_bda_clear_rows(h);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2016, The University of Oxford
+ * Copyright (c) 2015-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -28,272 +28,236 @@
 
 #include "vis/private_vis_block.h"
 #include "vis/oskar_vis_block.h"
-#include "math/oskar_random_gaussian.h"
+#include "vis/oskar_vis_block_add_system_noise_cuda.h"
+#include "vis/oskar_system_noise_inline.h"
 #include "math/oskar_find_closest_match.h"
+#include "utility/oskar_device_utils.h"
 #include <math.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-static void oskar_get_station_std_dev_for_channel(oskar_Mem* station_std_dev,
-        double frequency_hz, const oskar_Telescope* tel, int* status)
+/* Gets the noise standard deviation of each station in each channel. */
+static void oskar_get_station_std_dev(oskar_Mem* station_std_dev,
+        int num_channels, double freq_start_hz, double freq_inc_hz,
+        const oskar_Telescope* tel, int* status)
 {
-    int i, j, num_stations;
+    int c, i, j, num_stations;
     const oskar_Mem *noise_freq, *noise_rms;
     const oskar_Station *station;
 
     /* Ensure output array is big enough. */
     num_stations = oskar_telescope_num_stations(tel);
-    if ((int)oskar_mem_length(station_std_dev) < num_stations)
-        oskar_mem_realloc(station_std_dev, num_stations, status);
+    if ((int)oskar_mem_length(station_std_dev) < num_channels * num_stations)
+        oskar_mem_realloc(station_std_dev, num_channels * num_stations,
+                status);
 
     /* Loop over stations and get noise value standard deviation for each. */
-    for (i = 0; i < num_stations; ++i)
+    for (c = 0; c < num_channels; ++c)
     {
-        station = oskar_telescope_station_const(tel, i);
-        noise_freq = oskar_station_noise_freq_hz_const(station);
-        noise_rms = oskar_station_noise_rms_jy_const(station);
-        j = oskar_find_closest_match(frequency_hz, noise_freq, status);
-        oskar_mem_copy_contents(station_std_dev, noise_rms, i, j, 1, status);
+        const double frequency_hz = freq_start_hz + c * freq_inc_hz;
+        for (i = 0; i < num_stations; ++i)
+        {
+            station = oskar_telescope_station_const(tel, i);
+            noise_freq = oskar_station_noise_freq_hz_const(station);
+            noise_rms = oskar_station_noise_rms_jy_const(station);
+            j = oskar_find_closest_match(frequency_hz, noise_freq, status);
+            oskar_mem_copy_contents(station_std_dev, noise_rms,
+                    c * num_stations + i, j, 1, status);
+        }
     }
 }
 
-/* Applies noise to data in a visibility block, for the given channel. */
-static void oskar_vis_block_apply_noise(oskar_VisBlock* vis,
-        const oskar_Mem* station_std_dev, unsigned int seed,
-        unsigned int block_idx, unsigned int channel_idx,
-        double channel_bandwidth_hz, double time_int_sec, int* status)
-{
-    int a1, a2, have_autocorr, have_crosscorr, block_start, b, c = 0, t;
-    int num_baselines, num_channels, num_stations, num_times;
-    void *acorr_ptr, *xcorr_ptr;
-    double rnd[8], std, mean, sefd_conversion;
-    const double inv_sqrt2 = 1.0 / sqrt(2.0);
-
-    /* Get pointer to start of block, and block dimensions. */
-    have_autocorr  = oskar_vis_block_has_auto_correlations(vis);
-    have_crosscorr = oskar_vis_block_has_cross_correlations(vis);
-    acorr_ptr      = oskar_mem_void(oskar_vis_block_auto_correlations(vis));
-    xcorr_ptr      = oskar_mem_void(oskar_vis_block_cross_correlations(vis));
-    num_baselines  = oskar_vis_block_num_baselines(vis);
-    num_channels   = oskar_vis_block_num_channels(vis);
-    num_stations   = oskar_vis_block_num_stations(vis);
-    num_times      = oskar_vis_block_num_times(vis);
-
-    /* Get factor for conversion of sigma to SEFD. */
-    sefd_conversion = sqrt(2.0*channel_bandwidth_hz * time_int_sec);
-
-    /* If we are adding noise directly to Stokes I, the noise is defined
-     * as single dipole noise, so we have to divide by sqrt(2) to take into
-     * account of the two different dipoles that go into the calculation of
-     * Stokes I. For polarised visibilities this is not required, as this
-     * falls out naturally when evaluating Stokes I from the dipole
-     * correlations (i.e. I = 0.5 (XX+YY) ). */
+/*
+ * Random number counters are derived directly from the time, baseline
+ * and station indices, so that the loops can run in any order on any
+ * number of threads. For each time step, counters run over all baselines
+ * and then all stations (in that order), with two counters for each
+ * polarised visibility. The counter sequence restarts in each channel.
+ */
 
-    switch (oskar_mem_type(oskar_vis_block_cross_correlations(vis)))
+/* Adds noise to all scalar visibilities in the block (single precision). */
+static void add_noise_scalar_f(int num_times, int num_channels,
+        int num_stations, unsigned int seed, unsigned int block_idx,
+        unsigned int counters_per_time, unsigned int counter_offset,
+        const float* station_std, double sefd_factor,
+        float2* xcorr, float2* acorr)
+{
+    int k, num_rows;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    num_rows = num_times * num_channels * num_stations;
+    if (xcorr)
     {
-    case OSKAR_SINGLE_COMPLEX:
+#pragma omp parallel for schedule(dynamic, 16) private(k)
+        for (k = 0; k < num_rows; ++k)
+        {
+            int a2, b;
+            const int a1 = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            const float* s = station_std + c * num_stations;
+            float2* v = xcorr + num_baselines * tc;
+            b = a1 * (2 * num_stations - a1 - 1) / 2;
+            for (a2 = a1 + 1; a2 < num_stations; ++a2, ++b)
+                oskar_system_noise_cross_scalar_f(seed,
+                        b + counters_per_time * t, block_idx,
+                        s[a1], s[a2], &v[b]);
+        }
+    }
+    if (acorr)
     {
-        const float* station_std;
-        float2* data;
-        station_std = oskar_mem_float_const(station_std_dev, status);
-        for (t = 0; t < num_times; ++t)
+#pragma omp parallel for private(k)
+        for (k = 0; k < num_rows; ++k)
         {
-            if (have_crosscorr)
-            {
-                /* Cross-correlation noise. */
-                block_start = num_baselines * (num_channels * t + channel_idx);
-                data = (float2*) xcorr_ptr + block_start;
-                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                {
-                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                    {
-                        oskar_random_gaussian2(seed, c++, block_idx, rnd);
-                        std = sqrt(station_std[a1] * station_std[a2]) * inv_sqrt2;
-                        data[b].x += std * rnd[0];
-                        data[b].y += std * rnd[1];
-                    }
-                }
-            }
+            const int a = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            oskar_system_noise_auto_scalar_f(seed,
+                    counter_offset + a + counters_per_time * t,
+                    block_idx, station_std[c * num_stations + a],
+                    sefd_factor, &acorr[k]);
+        }
+    }
+}
 
-            if (have_autocorr)
-            {
-                /* Autocorrelation noise. Phases are all zero after
-                 * autocorrelation, so ignore the imaginary components. */
-                block_start = num_stations * (num_channels * t + channel_idx);
-                data = (float2*) acorr_ptr + block_start;
-                for (a1 = 0; a1 < num_stations; ++a1)
-                {
-                    oskar_random_gaussian2(seed, c++, block_idx, rnd);
-                    std = station_std[a1];
-                    mean = sqrt(2.0)*station_std[a1];
-                    data[a1].x += std * rnd[0] + mean * sefd_conversion;
-                }
-            }
+/* Adds noise to all scalar visibilities in the block (double precision). */
+static void add_noise_scalar_d(int num_times, int num_channels,
+        int num_stations, unsigned int seed, unsigned int block_idx,
+        unsigned int counters_per_time, unsigned int counter_offset,
+        const double* station_std, double sefd_factor,
+        double2* xcorr, double2* acorr)
+{
+    int k, num_rows;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    num_rows = num_times * num_channels * num_stations;
+    if (xcorr)
+    {
+#pragma omp parallel for schedule(dynamic, 16) private(k)
+        for (k = 0; k < num_rows; ++k)
+        {
+            int a2, b;
+            const int a1 = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            const double* s = station_std + c * num_stations;
+            double2* v = xcorr + num_baselines * tc;
+            b = a1 * (2 * num_stations - a1 - 1) / 2;
+            for (a2 = a1 + 1; a2 < num_stations; ++a2, ++b)
+                oskar_system_noise_cross_scalar_d(seed,
+                        b + counters_per_time * t, block_idx,
+                        s[a1], s[a2], &v[b]);
         }
-        break;
     }
-    case OSKAR_SINGLE_COMPLEX_MATRIX:
+    if (acorr)
     {
-        const float* station_std;
-        float4c* data;
-        station_std = oskar_mem_float_const(station_std_dev, status);
-        for (t = 0; t < num_times; ++t)
+#pragma omp parallel for private(k)
+        for (k = 0; k < num_rows; ++k)
         {
-            if (have_crosscorr)
-            {
-                /* Cross-correlation noise. */
-                block_start = num_baselines * (num_channels * t + channel_idx);
-                data = (float4c*) xcorr_ptr + block_start;
-                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                {
-                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                    {
-                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
-                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd + 4);
-                        std = sqrt(station_std[a1] * station_std[a2]);
-                        data[b].a.x += std * rnd[0];
-                        data[b].a.y += std * rnd[1];
-                        data[b].b.x += std * rnd[2];
-                        data[b].b.y += std * rnd[3];
-                        data[b].c.x += std * rnd[4];
-                        data[b].c.y += std * rnd[5];
-                        data[b].d.x += std * rnd[6];
-                        data[b].d.y += std * rnd[7];
-                    }
-                }
-            }
+            const int a = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            oskar_system_noise_auto_scalar_d(seed,
+                    counter_offset + a + counters_per_time * t,
+                    block_idx, station_std[c * num_stations + a],
+                    sefd_factor, &acorr[k]);
+        }
+    }
+}
 
-            if (have_autocorr)
-            {
-                /* Autocorrelation noise. Phases are all zero after
-                 * autocorrelation, so ignore the imaginary components. */
-                block_start = num_stations * (num_channels * t + channel_idx);
-                data = (float4c*) acorr_ptr + block_start;
-                for (a1 = 0; a1 < num_stations; ++a1)
-                {
-                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
-                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd + 4);
-                    std = station_std[a1] * sqrt(2.0);
-                    mean = std * sefd_conversion;
-                    data[a1].a.x += std * rnd[0] + mean;
-                    data[a1].b.x += std * rnd[1];
-                    data[a1].b.y += std * rnd[2];
-                    data[a1].c.x += std * rnd[3];
-                    data[a1].c.y += std * rnd[4];
-                    data[a1].d.x += std * rnd[5] + mean;
-                }
-            }
+/* Adds noise to all polarised visibilities in the block (single precision). */
+static void add_noise_matrix_f(int num_times, int num_channels,
+        int num_stations, unsigned int seed, unsigned int block_idx,
+        unsigned int counters_per_time, unsigned int counter_offset,
+        const float* station_std, double sefd_factor,
+        float4c* xcorr, float4c* acorr)
+{
+    int k, num_rows;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    num_rows = num_times * num_channels * num_stations;
+    if (xcorr)
+    {
+#pragma omp parallel for schedule(dynamic, 16) private(k)
+        for (k = 0; k < num_rows; ++k)
+        {
+            int a2, b;
+            const int a1 = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            const float* s = station_std + c * num_stations;
+            float4c* v = xcorr + num_baselines * tc;
+            b = a1 * (2 * num_stations - a1 - 1) / 2;
+            for (a2 = a1 + 1; a2 < num_stations; ++a2, ++b)
+                oskar_system_noise_cross_matrix_f(seed,
+                        2 * b + counters_per_time * t, block_idx,
+                        s[a1], s[a2], &v[b]);
         }
-        break;
     }
-    case OSKAR_DOUBLE_COMPLEX:
+    if (acorr)
     {
-        const double* station_std;
-        double2* data;
-        station_std = oskar_mem_double_const(station_std_dev, status);
-        for (t = 0; t < num_times; ++t)
+#pragma omp parallel for private(k)
+        for (k = 0; k < num_rows; ++k)
         {
-            if (have_crosscorr)
-            {
-                /* Cross-correlation noise. */
-                block_start = num_baselines * (num_channels * t + channel_idx);
-                data = (double2*) xcorr_ptr + block_start;
-                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                {
-                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                    {
-                        oskar_random_gaussian2(seed, c++, block_idx, rnd);
-                        std = sqrt(station_std[a1] * station_std[a2]) * inv_sqrt2;
-                        data[b].x += std * rnd[0];
-                        data[b].y += std * rnd[1];
-                    }
-                }
-            }
+            const int a = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            oskar_system_noise_auto_matrix_f(seed,
+                    counter_offset + 2 * a + counters_per_time * t,
+                    block_idx, station_std[c * num_stations + a],
+                    sefd_factor, &acorr[k]);
+        }
+    }
+}
 
-            if (have_autocorr)
-            {
-                /* Autocorrelation noise. Phases are all zero after
-                 * autocorrelation, so ignore the imaginary components. */
-                block_start = num_stations * (num_channels * t + channel_idx);
-                data = (double2*) acorr_ptr + block_start;
-                for (a1 = 0; a1 < num_stations; ++a1)
-                {
-                    oskar_random_gaussian2(seed, c++, block_idx, rnd);
-                    std  = station_std[a1];
-                    mean = station_std[a1] * sefd_conversion * sqrt(2.0);
-                    data[a1].x += std * rnd[0] + mean;
-                }
-            }
+/* Adds noise to all polarised visibilities in the block (double precision). */
+static void add_noise_matrix_d(int num_times, int num_channels,
+        int num_stations, unsigned int seed, unsigned int block_idx,
+        unsigned int counters_per_time, unsigned int counter_offset,
+        const double* station_std, double sefd_factor,
+        double4c* xcorr, double4c* acorr)
+{
+    int k, num_rows;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    num_rows = num_times * num_channels * num_stations;
+    if (xcorr)
+    {
+#pragma omp parallel for schedule(dynamic, 16) private(k)
+        for (k = 0; k < num_rows; ++k)
+        {
+            int a2, b;
+            const int a1 = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            const double* s = station_std + c * num_stations;
+            double4c* v = xcorr + num_baselines * tc;
+            b = a1 * (2 * num_stations - a1 - 1) / 2;
+            for (a2 = a1 + 1; a2 < num_stations; ++a2, ++b)
+                oskar_system_noise_cross_matrix_d(seed,
+                        2 * b + counters_per_time * t, block_idx,
+                        s[a1], s[a2], &v[b]);
         }
-        break;
     }
-    case OSKAR_DOUBLE_COMPLEX_MATRIX:
+    if (acorr)
     {
-        const double* station_std;
-        double4c* data;
-        station_std = oskar_mem_double_const(station_std_dev, status);
-        for (t = 0; t < num_times; ++t)
+#pragma omp parallel for private(k)
+        for (k = 0; k < num_rows; ++k)
         {
-            if (have_crosscorr)
-            {
-                /* Cross-correlation noise. */
-                block_start = num_baselines * (num_channels * t + channel_idx);
-                data = (double4c*) xcorr_ptr + block_start;
-                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                {
-                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                    {
-                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
-                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd + 4);
-                        std = sqrt(station_std[a1] * station_std[a2]);
-                        data[b].a.x += std * rnd[0];
-                        data[b].a.y += std * rnd[1];
-                        data[b].b.x += std * rnd[2];
-                        data[b].b.y += std * rnd[3];
-                        data[b].c.x += std * rnd[4];
-                        data[b].c.y += std * rnd[5];
-                        data[b].d.x += std * rnd[6];
-                        data[b].d.y += std * rnd[7];
-                    }
-                }
-            }
-
-            if (have_autocorr)
-            {
-                /* Autocorrelation noise. Phases are all zero after
-                 * autocorrelation, so ignore the imaginary components. */
-                block_start = num_stations * (num_channels * t + channel_idx);
-                data = (double4c*) acorr_ptr + block_start;
-                for (a1 = 0; a1 < num_stations; ++a1)
-                {
-                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
-                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd+4);
-                    std  = station_std[a1]*sqrt(2.0);
-                    mean = std * sefd_conversion;
-                    data[a1].a.x += std * rnd[0] + mean;
-                    data[a1].b.x += std * rnd[1];
-                    data[a1].b.y += std * rnd[2];
-                    data[a1].c.x += std * rnd[3];
-                    data[a1].c.y += std * rnd[4];
-                    data[a1].d.x += std * rnd[5] + mean;
-                }
-            }
+            const int a = k % num_stations, tc = k / num_stations;
+            const int c = tc % num_channels, t = tc / num_channels;
+            oskar_system_noise_auto_matrix_d(seed,
+                    counter_offset + 2 * a + counters_per_time * t,
+                    block_idx, station_std[c * num_stations + a],
+                    sefd_factor, &acorr[k]);
         }
-        break;
     }
-    };
 }
 
 void oskar_vis_block_add_system_noise(oskar_VisBlock* vis,
         const oskar_VisHeader* header, const oskar_Telescope* telescope,
         unsigned int block_index, oskar_Mem* station_work, int* status)
 {
-    int c, num_channels;
-    unsigned int seed;
-    double freq_hz, freq_start_hz, freq_inc_hz;
-    double channel_bandwidth_hz, time_int_sec;
+    int have_xc, have_ac, location, type, num_channels, num_stations;
+    int num_baselines, num_times;
+    unsigned int seed, block_idx, counters_per_vis, counters_per_time;
+    unsigned int counter_offset;
+    double sefd_conversion;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -309,23 +273,133 @@ void oskar_vis_block_add_system_noise(oskar_VisBlock* vis,
         return;
     }
 
-    /* Get frequency start and increment. */
-    seed                 = oskar_telescope_noise_seed(telescope);
-    num_channels         = oskar_vis_block_num_channels(vis);
-    channel_bandwidth_hz = oskar_vis_header_channel_bandwidth_hz(header);
-    time_int_sec         = oskar_vis_header_time_average_sec(header);
-    freq_start_hz        = oskar_vis_header_freq_start_hz(header);
-    freq_inc_hz          = oskar_vis_header_freq_inc_hz(header);
+    /* Get the block dimensions. */
+    location       = oskar_vis_block_location(vis);
+    have_xc        = oskar_vis_block_has_cross_correlations(vis);
+    have_ac        = oskar_vis_block_has_auto_correlations(vis);
+    num_baselines  = oskar_vis_block_num_baselines(vis);
+    num_channels   = oskar_vis_block_num_channels(vis);
+    num_stations   = oskar_vis_block_num_stations(vis);
+    num_times      = oskar_vis_block_num_times(vis);
+    type           = oskar_mem_type(oskar_vis_block_cross_correlations(vis));
+    seed           = oskar_telescope_noise_seed(telescope);
+    block_idx      = block_index;
 
-    /* Apply noise to each channel. */
-    for (c = 0; c < num_channels; ++c)
+    /* Get factor for conversion of sigma to SEFD. */
+    sefd_conversion = sqrt(2.0 *
+            oskar_vis_header_channel_bandwidth_hz(header) *
+            oskar_vis_header_time_average_sec(header));
+
+    /* Get the station noise levels for all channels, on the host. */
+    oskar_get_station_std_dev(station_work, num_channels,
+            oskar_vis_header_freq_start_hz(header),
+            oskar_vis_header_freq_inc_hz(header), telescope, status);
+    if (*status) return;
+
+    /* Get the random number counter layout. */
+    counters_per_vis = oskar_type_is_matrix(type) ? 2 : 1;
+    counters_per_time = 0;
+    if (have_xc) counters_per_time += num_baselines * counters_per_vis;
+    counter_offset = counters_per_time;
+    if (have_ac) counters_per_time += num_stations * counters_per_vis;
+
+    /* If we are adding noise directly to Stokes I, the noise is defined
+     * as single dipole noise, so we have to divide by sqrt(2) to take into
+     * account of the two different dipoles that go into the calculation of
+     * Stokes I. For polarised visibilities this is not required, as this
+     * falls out naturally when evaluating Stokes I from the dipole
+     * correlations (i.e. I = 0.5 (XX+YY) ). */
+    if (location == OSKAR_CPU)
     {
-        freq_hz = freq_start_hz + c * freq_inc_hz;
-        oskar_get_station_std_dev_for_channel(station_work, freq_hz,
-                telescope, status);
-        oskar_vis_block_apply_noise(vis, station_work, seed,
-                block_index, c, channel_bandwidth_hz, time_int_sec, status);
+        void *xc = 0, *ac = 0;
+        if (have_xc)
+            xc = oskar_mem_void(oskar_vis_block_cross_correlations(vis));
+        if (have_ac)
+            ac = oskar_mem_void(oskar_vis_block_auto_correlations(vis));
+        switch (type)
+        {
+        case OSKAR_SINGLE_COMPLEX:
+            add_noise_scalar_f(num_times, num_channels, num_stations, seed,
+                    block_idx, counters_per_time, counter_offset,
+                    oskar_mem_float_const(station_work, status),
+                    sefd_conversion, (float2*) xc, (float2*) ac);
+            break;
+        case OSKAR_SINGLE_COMPLEX_MATRIX:
+            add_noise_matrix_f(num_times, num_channels, num_stations, seed,
+                    block_idx, counters_per_time, counter_offset,
+                    oskar_mem_float_const(station_work, status),
+                    sefd_conversion, (float4c*) xc, (float4c*) ac);
+            break;
+        case OSKAR_DOUBLE_COMPLEX:
+            add_noise_scalar_d(num_times, num_channels, num_stations, seed,
+                    block_idx, counters_per_time, counter_offset,
+                    oskar_mem_double_const(station_work, status),
+                    sefd_conversion, (double2*) xc, (double2*) ac);
+            break;
+        case OSKAR_DOUBLE_COMPLEX_MATRIX:
+            add_noise_matrix_d(num_times, num_channels, num_stations, seed,
+                    block_idx, counters_per_time, counter_offset,
+                    oskar_mem_double_const(station_work, status),
+                    sefd_conversion, (double4c*) xc, (double4c*) ac);
+            break;
+        default:
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            break;
+        }
+    }
+    else if (location == OSKAR_GPU)
+    {
+#ifdef OSKAR_HAVE_CUDA
+        void *xc = 0, *ac = 0;
+        oskar_Mem* station_std;
+        station_std = oskar_mem_create_copy(station_work, location, status);
+        if (have_xc)
+            xc = oskar_mem_void(oskar_vis_block_cross_correlations(vis));
+        if (have_ac)
+            ac = oskar_mem_void(oskar_vis_block_auto_correlations(vis));
+        if (*status)
+        {
+            oskar_mem_free(station_std, status);
+            return;
+        }
+        switch (type)
+        {
+        case OSKAR_SINGLE_COMPLEX:
+            oskar_vis_block_add_system_noise_cuda_scalar_f(num_times,
+                    num_channels, num_stations, seed, block_idx,
+                    oskar_mem_float_const(station_std, status),
+                    sefd_conversion, (float2*) xc, (float2*) ac);
+            break;
+        case OSKAR_SINGLE_COMPLEX_MATRIX:
+            oskar_vis_block_add_system_noise_cuda_matrix_f(num_times,
+                    num_channels, num_stations, seed, block_idx,
+                    oskar_mem_float_const(station_std, status),
+                    sefd_conversion, (float4c*) xc, (float4c*) ac);
+            break;
+        case OSKAR_DOUBLE_COMPLEX:
+            oskar_vis_block_add_system_noise_cuda_scalar_d(num_times,
+                    num_channels, num_stations, seed, block_idx,
+                    oskar_mem_double_const(station_std, status),
+                    sefd_conversion, (double2*) xc, (double2*) ac);
+            break;
+        case OSKAR_DOUBLE_COMPLEX_MATRIX:
+            oskar_vis_block_add_system_noise_cuda_matrix_d(num_times,
+                    num_channels, num_stations, seed, block_idx,
+                    oskar_mem_double_const(station_std, status),
+                    sefd_conversion, (double4c*) xc, (double4c*) ac);
+            break;
+        default:
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            break;
+        }
+        oskar_device_check_error(status);
+        oskar_mem_free(station_std, status);
+#else
+        *status = OSKAR_ERR_CUDA_NOT_AVAILABLE;
+#endif
     }
+    else
+        *status = OSKAR_ERR_BAD_LOCATION;
 }
 
 #ifdef __cplusplus
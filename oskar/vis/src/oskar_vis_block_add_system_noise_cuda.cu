@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vis/oskar_vis_block_add_system_noise_cuda.h"
+#include "vis/oskar_system_noise_inline.h"
+
+/* Overloads to select the precision of the noise functions. */
+__device__ __forceinline__
+void add_cross(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, float s1, float s2, float2* v)
+{
+    oskar_system_noise_cross_scalar_f(seed, counter, block_idx, s1, s2, v);
+}
+
+__device__ __forceinline__
+void add_cross(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, double s1, double s2, double2* v)
+{
+    oskar_system_noise_cross_scalar_d(seed, counter, block_idx, s1, s2, v);
+}
+
+__device__ __forceinline__
+void add_cross(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, float s1, float s2, float4c* v)
+{
+    oskar_system_noise_cross_matrix_f(seed, counter, block_idx, s1, s2, v);
+}
+
+__device__ __forceinline__
+void add_cross(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, double s1, double s2, double4c* v)
+{
+    oskar_system_noise_cross_matrix_d(seed, counter, block_idx, s1, s2, v);
+}
+
+__device__ __forceinline__
+void add_auto(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, float s, double sefd_factor, float2* v)
+{
+    oskar_system_noise_auto_scalar_f(seed, counter, block_idx, s,
+            sefd_factor, v);
+}
+
+__device__ __forceinline__
+void add_auto(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, double s, double sefd_factor, double2* v)
+{
+    oskar_system_noise_auto_scalar_d(seed, counter, block_idx, s,
+            sefd_factor, v);
+}
+
+__device__ __forceinline__
+void add_auto(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, float s, double sefd_factor, float4c* v)
+{
+    oskar_system_noise_auto_matrix_f(seed, counter, block_idx, s,
+            sefd_factor, v);
+}
+
+__device__ __forceinline__
+void add_auto(unsigned int seed, unsigned int counter,
+        unsigned int block_idx, double s, double sefd_factor, double4c* v)
+{
+    oskar_system_noise_auto_matrix_d(seed, counter, block_idx, s,
+            sefd_factor, v);
+}
+
+/* Kernels. ================================================================ */
+
+/* One thread per cross-correlation, with data index
+ * i = num_baselines * (num_channels * t + c) + b. */
+template<typename T, typename VT>
+__global__
+void oskar_system_noise_cross_cudak(const int num_times,
+        const int num_channels, const int num_stations,
+        const unsigned int seed, const unsigned int block_idx,
+        const unsigned int counters_per_time,
+        const unsigned int counters_per_vis, const T* restrict std,
+        VT* restrict vis)
+{
+    int a1, a2, b, c, t, ct;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    const int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= num_times * num_channels * num_baselines) return;
+    b = i % num_baselines;
+    ct = i / num_baselines;
+    c = ct % num_channels;
+    t = ct / num_channels;
+
+    /* Get station indices from baseline index. */
+    const int n2 = 2 * num_stations - 1;
+    a1 = (int) floor(0.5 * (n2 - sqrt((double)n2 * n2 - 8.0 * b)));
+    if (a1 < 0) a1 = 0;
+    while (a1 > 0 && a1 * (n2 - a1) / 2 > b) --a1;
+    while ((a1 + 1) * (n2 - a1 - 1) / 2 <= b) ++a1;
+    a2 = b - a1 * (n2 - a1) / 2 + a1 + 1;
+
+    std += c * num_stations;
+    add_cross(seed, counters_per_vis * b + counters_per_time * t,
+            block_idx, std[a1], std[a2], &vis[i]);
+}
+
+/* One thread per autocorrelation, with data index
+ * i = num_stations * (num_channels * t + c) + a. */
+template<typename T, typename VT>
+__global__
+void oskar_system_noise_auto_cudak(const int num_times,
+        const int num_channels, const int num_stations,
+        const unsigned int seed, const unsigned int block_idx,
+        const unsigned int counters_per_time,
+        const unsigned int counter_offset,
+        const unsigned int counters_per_vis, const T* restrict std,
+        const double sefd_factor, VT* restrict vis)
+{
+    int a, c, t, ct;
+    const int i = blockDim.x * blockIdx.x + threadIdx.x;
+    if (i >= num_times * num_channels * num_stations) return;
+    a = i % num_stations;
+    ct = i / num_stations;
+    c = ct % num_channels;
+    t = ct / num_channels;
+    add_auto(seed, counter_offset + counters_per_vis * a +
+            counters_per_time * t, block_idx, std[c * num_stations + a],
+            sefd_factor, &vis[i]);
+}
+
+template<typename T, typename VT>
+static void add_noise(int num_times, int num_channels, int num_stations,
+        unsigned int seed, unsigned int block_idx, const T* d_station_std,
+        double sefd_factor, VT* d_xcorr, VT* d_acorr,
+        unsigned int counters_per_vis)
+{
+    int num, num_blocks, num_threads = 256;
+    unsigned int counters_per_time = 0, counter_offset;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    if (d_xcorr) counters_per_time += num_baselines * counters_per_vis;
+    counter_offset = counters_per_time;
+    if (d_acorr) counters_per_time += num_stations * counters_per_vis;
+    if (d_xcorr)
+    {
+        num = num_times * num_channels * num_baselines;
+        num_blocks = (num + num_threads - 1) / num_threads;
+        oskar_system_noise_cross_cudak<T, VT>
+        OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_times, num_channels,
+                num_stations, seed, block_idx, counters_per_time,
+                counters_per_vis, d_station_std, d_xcorr);
+    }
+    if (d_acorr)
+    {
+        num = num_times * num_channels * num_stations;
+        num_blocks = (num + num_threads - 1) / num_threads;
+        oskar_system_noise_auto_cudak<T, VT>
+        OSKAR_CUDAK_CONF(num_blocks, num_threads) (num_times, num_channels,
+                num_stations, seed, block_idx, counters_per_time,
+                counter_offset, counters_per_vis, d_station_std,
+                sefd_factor, d_acorr);
+    }
+}
+
+/* Kernel wrappers. ======================================================== */
+
+void oskar_vis_block_add_system_noise_cuda_scalar_f(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const float* d_station_std,
+        double sefd_factor, float2* d_xcorr, float2* d_acorr)
+{
+    add_noise(num_times, num_channels, num_stations, seed, block_idx,
+            d_station_std, sefd_factor, d_xcorr, d_acorr, 1);
+}
+
+void oskar_vis_block_add_system_noise_cuda_scalar_d(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const double* d_station_std,
+        double sefd_factor, double2* d_xcorr, double2* d_acorr)
+{
+    add_noise(num_times, num_channels, num_stations, seed, block_idx,
+            d_station_std, sefd_factor, d_xcorr, d_acorr, 1);
+}
+
+void oskar_vis_block_add_system_noise_cuda_matrix_f(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const float* d_station_std,
+        double sefd_factor, float4c* d_xcorr, float4c* d_acorr)
+{
+    add_noise(num_times, num_channels, num_stations, seed, block_idx,
+            d_station_std, sefd_factor, d_xcorr, d_acorr, 2);
+}
+
+void oskar_vis_block_add_system_noise_cuda_matrix_d(int num_times,
+        int num_channels, int num_stations, unsigned int seed,
+        unsigned int block_idx, const double* d_station_std,
+        double sefd_factor, double4c* d_xcorr, double4c* d_acorr)
+{
+    add_noise(num_times, num_channels, num_stations, seed, block_idx,
+            d_station_std, sefd_factor, d_xcorr, d_acorr, 2);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vis/private_vis_block.h"
+#include "binary/oskar_binary.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static oskar_Mem* read_array(oskar_Binary* h, int type, unsigned char id_tag,
+        int block_index, int search_start, int* status)
+{
+    oskar_Mem* mem = 0;
+    void* data;
+    size_t size_bytes = 0, element_size, align;
+    int chunk;
+
+    /* Find the payload. */
+    chunk = oskar_binary_query_from(h, search_start, (unsigned char) type,
+            OSKAR_TAG_GROUP_VIS_BLOCK, id_tag, block_index,
+            &size_bytes, status);
+    if (*status) return oskar_mem_create(type, OSKAR_CPU, 0, status);
+    element_size = oskar_mem_element_size(type);
+    align = oskar_mem_element_size(oskar_type_precision(type));
+
+    /* Alias the mapped payload, if it is aligned. */
+    data = oskar_binary_map_block(h, chunk, status);
+    if (data && ((size_t) data) % align == 0)
+        return oskar_mem_create_alias_from_raw(data, type,
+                OSKAR_CPU, size_bytes / element_size, status);
+
+    /* Otherwise, read it. */
+    mem = oskar_mem_create(type, OSKAR_CPU, size_bytes / element_size, status);
+    oskar_binary_read_block(h, chunk, size_bytes, oskar_mem_void(mem), status);
+    return mem;
+}
+
+oskar_VisBlock* oskar_vis_block_create_alias_from_binary(
+        const oskar_VisHeader* hdr, oskar_Binary* h, int block_index,
+        int* status)
+{
+    oskar_VisBlock* vis = 0;
+    int amp_type, coord_type, search_start, chunk;
+
+    /* Check if safe to proceed. */
+    if (*status) return 0;
+
+    /* Check type. */
+    amp_type = oskar_vis_header_amp_type(hdr);
+    if (!oskar_type_is_complex(amp_type))
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return 0;
+    }
+    coord_type = oskar_type_precision(amp_type);
+
+    /* Allocate the structure. */
+    vis = (oskar_VisBlock*) calloc(1, sizeof(oskar_VisBlock));
+    if (!vis)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return 0;
+    }
+    vis->has_auto_correlations =
+            oskar_vis_header_write_auto_correlations(hdr);
+    vis->has_cross_correlations =
+            oskar_vis_header_write_cross_correlations(hdr);
+
+    /* Read visibility metadata.
+     * The search starts at the first tag of the block, but a local copy of
+     * the start index is used so that the file handle is not modified. */
+    search_start = block_index * oskar_vis_header_num_tags_per_block(hdr);
+    chunk = oskar_binary_query_from(h, search_start, OSKAR_INT,
+            OSKAR_TAG_GROUP_VIS_BLOCK,
+            OSKAR_VIS_BLOCK_TAG_DIM_START_AND_SIZE, block_index, 0, status);
+    oskar_binary_read_block(h, chunk, sizeof(vis->dim_start_size),
+            vis->dim_start_size, status);
+
+    /* Read the auto-correlation data. */
+    if (vis->has_auto_correlations)
+        vis->auto_correlations = read_array(h, amp_type,
+                OSKAR_VIS_BLOCK_TAG_AUTO_CORRELATIONS, block_index,
+                search_start, status);
+    else
+        vis->auto_correlations = oskar_mem_create(amp_type, OSKAR_CPU, 0,
+                status);
+
+    /* Read the cross-correlation data and baseline coordinates. */
+    if (vis->has_cross_correlations)
+    {
+        vis->cross_correlations = read_array(h, amp_type,
+                OSKAR_VIS_BLOCK_TAG_CROSS_CORRELATIONS, block_index,
+                search_start, status);
+        vis->baseline_uu_metres = read_array(h, coord_type,
+                OSKAR_VIS_BLOCK_TAG_BASELINE_UU, block_index,
+                search_start, status);
+        vis->baseline_vv_metres = read_array(h, coord_type,
+                OSKAR_VIS_BLOCK_TAG_BASELINE_VV, block_index,
+                search_start, status);
+        vis->baseline_ww_metres = read_array(h, coord_type,
+                OSKAR_VIS_BLOCK_TAG_BASELINE_WW, block_index,
+                search_start, status);
+    }
+    else
+    {
+        vis->cross_correlations = oskar_mem_create(amp_type, OSKAR_CPU, 0,
+                status);
+        vis->baseline_uu_metres = oskar_mem_create(coord_type, OSKAR_CPU, 0,
+                status);
+        vis->baseline_vv_metres = oskar_mem_create(coord_type, OSKAR_CPU, 0,
+                status);
+        vis->baseline_ww_metres = oskar_mem_create(coord_type, OSKAR_CPU, 0,
+                status);
+    }
+
+    /* Return handle to structure. */
+    return vis;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -37,19 +37,134 @@ extern "C" {
 
 #define D2R (M_PI / 180.0)
 
+/* Size of the square tiles of (rows, channels) used when reordering. */
+#define TILE 32
+
+/* Reorders amplitude data from the block dimension order
+ * (time, channel, baseline, polarisation) to the Measurement Set order
+ * (time, row, channel, polarisation), inserting auto-correlations
+ * and expanding scalar data to four polarisations if required.
+ * Tiles of (rows, channels) are processed in parallel, so that both the
+ * reads and the writes stay in cache. */
+static void reorder_vis_f(const unsigned int num_times,
+        const unsigned int num_channels, const unsigned int num_stations,
+        const unsigned int num_baseln_in, const unsigned int num_baseln_out,
+        const unsigned int num_pols_in, const unsigned int num_pols_out,
+        const int* row_src, const float* xcorr, const float* acorr, float* out)
+{
+    int j;
+    const int num_row_tiles = (num_baseln_out + TILE - 1) / TILE;
+    const int num_tiles = num_times * num_row_tiles;
+    const unsigned int n_in = 2 * num_pols_in, n_out = 2 * num_pols_out;
+#pragma omp parallel for private(j)
+    for (j = 0; j < num_tiles; ++j)
+    {
+        unsigned int c, c0, c1, k, r, r0, r1;
+        const unsigned int t = j / num_row_tiles;
+        r0 = (j % num_row_tiles) * TILE;
+        r1 = r0 + TILE;
+        if (r1 > num_baseln_out) r1 = num_baseln_out;
+        for (c0 = 0; c0 < num_channels; c0 += TILE)
+        {
+            c1 = c0 + TILE;
+            if (c1 > num_channels) c1 = num_channels;
+            for (r = r0; r < r1; ++r)
+            {
+                const int src = row_src[r];
+                float* o = out + n_out *
+                        (num_channels * (num_baseln_out * t + r) + c0);
+                for (c = c0; c < c1; ++c, o += n_out)
+                {
+                    const float* in = (src < 0) ?
+                            acorr + n_in * (num_stations *
+                                    (num_channels * t + c) - src - 1) :
+                            xcorr + n_in * (num_baseln_in *
+                                    (num_channels * t + c) + src);
+                    if (n_in == n_out)
+                    {
+                        for (k = 0; k < n_in; ++k) o[k] = (float) in[k];
+                    }
+                    else
+                    {
+                        /* Scalar data: XX = YY = amplitude, XY = YX = 0. */
+                        o[0] = (float) in[0]; o[1] = (float) in[1];
+                        o[2] = 0.0f;          o[3] = 0.0f;
+                        o[4] = 0.0f;          o[5] = 0.0f;
+                        o[6] = (float) in[0]; o[7] = (float) in[1];
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void reorder_vis_d(const unsigned int num_times,
+        const unsigned int num_channels, const unsigned int num_stations,
+        const unsigned int num_baseln_in, const unsigned int num_baseln_out,
+        const unsigned int num_pols_in, const unsigned int num_pols_out,
+        const int* row_src, const double* xcorr, const double* acorr, float* out)
+{
+    int j;
+    const int num_row_tiles = (num_baseln_out + TILE - 1) / TILE;
+    const int num_tiles = num_times * num_row_tiles;
+    const unsigned int n_in = 2 * num_pols_in, n_out = 2 * num_pols_out;
+#pragma omp parallel for private(j)
+    for (j = 0; j < num_tiles; ++j)
+    {
+        unsigned int c, c0, c1, k, r, r0, r1;
+        const unsigned int t = j / num_row_tiles;
+        r0 = (j % num_row_tiles) * TILE;
+        r1 = r0 + TILE;
+        if (r1 > num_baseln_out) r1 = num_baseln_out;
+        for (c0 = 0; c0 < num_channels; c0 += TILE)
+        {
+            c1 = c0 + TILE;
+            if (c1 > num_channels) c1 = num_channels;
+            for (r = r0; r < r1; ++r)
+            {
+                const int src = row_src[r];
+                float* o = out + n_out *
+                        (num_channels * (num_baseln_out * t + r) + c0);
+                for (c = c0; c < c1; ++c, o += n_out)
+                {
+                    const double* in = (src < 0) ?
+                            acorr + n_in * (num_stations *
+                                    (num_channels * t + c) - src - 1) :
+                            xcorr + n_in * (num_baseln_in *
+                                    (num_channels * t + c) + src);
+                    if (n_in == n_out)
+                    {
+                        for (k = 0; k < n_in; ++k) o[k] = (float) in[k];
+                    }
+                    else
+                    {
+                        /* Scalar data: XX = YY = amplitude, XY = YX = 0. */
+                        o[0] = (float) in[0]; o[1] = (float) in[1];
+                        o[2] = 0.0f;          o[3] = 0.0f;
+                        o[4] = 0.0f;          o[5] = 0.0f;
+                        o[6] = (float) in[0]; o[7] = (float) in[1];
+                    }
+                }
+            }
+        }
+    }
+}
+
 void oskar_vis_block_write_ms(const oskar_VisBlock* blk,
         const oskar_VisHeader* header, oskar_MeasurementSet* ms, int* status)
 {
     const oskar_Mem *in_acorr, *in_xcorr, *in_uu, *in_vv, *in_ww;
-    oskar_Mem *temp_vis = 0, *temp_uu = 0, *temp_vv = 0, *temp_ww = 0;
     double exposure_sec, interval_sec, t_start_mjd, t_start_sec;
     double ra_rad, dec_rad, freq_start_hz;
     unsigned int a1, a2, num_baseln_in, num_baseln_out, num_channels;
-    unsigned int num_pols_in, num_pols_out, num_stations, num_times, b, c, t;
-    unsigned int i, i_out, prec, start_time_index, start_chan_index;
+    unsigned int num_pols_in, num_pols_out, num_stations, num_times, b, t;
+    unsigned int prec, start_time_index, start_chan_index;
     unsigned int have_autocorr, have_crosscorr;
-    const void *xcorr, *acorr;
-    void* out;
+    size_t vis_bytes, coord_bytes;
+    int i, *row_src;
+    char* buffer;
+    float* vis;
+    void *uu, *vv, *ww;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -118,271 +233,109 @@ void oskar_vis_block_write_ms(const oskar_VisBlock* blk,
         return;
     }
 
-    /* Add visibilities and u,v,w coordinates. */
-    temp_vis = oskar_mem_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
-            num_baseln_out * num_channels * num_pols_out, status);
-    temp_uu = oskar_mem_create(prec, OSKAR_CPU, num_baseln_out, status);
-    temp_vv = oskar_mem_create(prec, OSKAR_CPU, num_baseln_out, status);
-    temp_ww = oskar_mem_create(prec, OSKAR_CPU, num_baseln_out, status);
-    xcorr   = oskar_mem_void_const(in_xcorr);
-    acorr   = oskar_mem_void_const(in_acorr);
-    out     = oskar_mem_void(temp_vis);
-    if (prec == OSKAR_DOUBLE)
+    /* Get staging buffers for visibilities, coordinates and row indices.
+     * These are owned by the Measurement Set, so are reused for each block. */
+    vis_bytes = (size_t)num_times * num_baseln_out * num_channels *
+            num_pols_out * 2 * sizeof(float);
+    coord_bytes = 3 * num_baseln_out * oskar_mem_element_size(prec);
+    buffer = (char*) oskar_ms_stage_buffer(ms,
+            vis_bytes + coord_bytes + num_baseln_out * sizeof(int));
+    if (!buffer)
     {
-        const double *uu_in, *vv_in, *ww_in;
-        double *uu_out, *vv_out, *ww_out;
-        uu_in = oskar_mem_double_const(in_uu, status);
-        vv_in = oskar_mem_double_const(in_vv, status);
-        ww_in = oskar_mem_double_const(in_ww, status);
-        uu_out = oskar_mem_double(temp_uu, status);
-        vv_out = oskar_mem_double(temp_vv, status);
-        ww_out = oskar_mem_double(temp_ww, status);
-        for (t = 0; t < num_times; ++t)
-        {
-            /* Construct the baseline coordinates for the given time. */
-            unsigned int start_row = (start_time_index + t) * num_baseln_out;
-            for (a1 = 0, b = 0, i_out = 0; a1 < num_stations; ++a1)
-            {
-                if (have_autocorr)
-                {
-                    uu_out[i_out] = 0.0;
-                    vv_out[i_out] = 0.0;
-                    ww_out[i_out] = 0.0;
-                    ++i_out;
-                }
-                if (have_crosscorr)
-                {
-                    for (a2 = a1 + 1; a2 < num_stations; ++a2, ++b, ++i_out)
-                    {
-                        i = num_baseln_in * t + b;
-                        uu_out[i_out] = uu_in[i];
-                        vv_out[i_out] = vv_in[i];
-                        ww_out[i_out] = ww_in[i];
-                    }
-                }
-            }
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+    vis = (float*) buffer;
+    uu = buffer + vis_bytes;
+    vv = (char*)uu + coord_bytes / 3;
+    ww = (char*)vv + coord_bytes / 3;
+    row_src = (int*) (buffer + vis_bytes + coord_bytes);
 
-            for (c = 0, i_out = 0; c < num_channels; ++c)
-            {
-                /* Construct amplitude data for the given time and channel. */
-                if (num_pols_in == 4)
-                {
-                    for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                    {
-                        if (have_autocorr)
-                        {
-                            i = num_stations * (t * num_channels + c) + a1;
-                            ((double4c*)out)[i_out++] =
-                                    ((const double4c*)acorr)[i];
-                        }
-                        if (have_crosscorr)
-                        {
-                            for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                            {
-                                i = num_baseln_in * (t * num_channels + c) + b;
-                                ((double4c*)out)[i_out++] =
-                                        ((const double4c*)xcorr)[i];
-                            }
-                        }
-                    }
-                }
-                else if (num_pols_in == 1 && num_pols_out == 1)
-                {
-                    for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                    {
-                        if (have_autocorr)
-                        {
-                            i = num_stations * (t * num_channels + c) + a1;
-                            ((double2*)out)[i_out++] =
-                                    ((const double2*)acorr)[i];
-                        }
-                        if (have_crosscorr)
-                        {
-                            for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                            {
-                                i = num_baseln_in * (t * num_channels + c) + b;
-                                ((double2*)out)[i_out++] =
-                                        ((const double2*)xcorr)[i];
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    double2 vis_amp, *out_;
-                    out_ = (double2*)out;
-                    for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                    {
-                        if (have_autocorr)
-                        {
-                            i = num_stations * (t * num_channels + c) + a1;
-                            vis_amp = ((const double2*)acorr)[i];
-                            out_[i_out + 0] = vis_amp;  /* XX */
-                            out_[i_out + 1].x = 0.0;    /* XY */
-                            out_[i_out + 1].y = 0.0;    /* XY */
-                            out_[i_out + 2].x = 0.0;    /* YX */
-                            out_[i_out + 2].y = 0.0;    /* YX */
-                            out_[i_out + 3] = vis_amp;  /* YY */
-                            i_out += 4;
-                        }
-                        if (have_crosscorr)
-                        {
-                            for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                            {
-                                i = num_baseln_in * (t * num_channels + c) + b;
-                                vis_amp = ((const double2*)xcorr)[i];
-                                out_[i_out + 0] = vis_amp;  /* XX */
-                                out_[i_out + 1].x = 0.0;    /* XY */
-                                out_[i_out + 1].y = 0.0;    /* XY */
-                                out_[i_out + 2].x = 0.0;    /* YX */
-                                out_[i_out + 2].y = 0.0;    /* YX */
-                                out_[i_out + 3] = vis_amp;  /* YY */
-                                i_out += 4;
-                            }
-                        }
-                    }
-                }
-            }
-            oskar_ms_write_coords_d(ms, start_row, num_baseln_out,
-                    uu_out, vv_out, ww_out, exposure_sec, interval_sec,
-                    (start_time_index + t + 0.5) * interval_sec + t_start_sec);
-            oskar_ms_write_vis_d(ms, start_row, start_chan_index,
-                    num_channels, num_baseln_out, (const double*)out);
-        }
+    /* Get the source of each output row within a time step:
+     * non-negative values are cross-correlation baseline indices,
+     * negative values are -(1 + station index) for auto-correlations. */
+    for (a1 = 0, b = 0, i = 0; a1 < num_stations; ++a1)
+    {
+        if (have_autocorr)
+            row_src[i++] = -(1 + (int)a1);
+        if (have_crosscorr)
+            for (a2 = a1 + 1; a2 < num_stations; ++a2)
+                row_src[i++] = (int)(b++);
     }
+
+    /* Reorder amplitudes for all time steps, and write them in one go. */
+    if (prec == OSKAR_DOUBLE)
+        reorder_vis_d(num_times, num_channels, num_stations, num_baseln_in,
+                num_baseln_out, num_pols_in, num_pols_out, row_src,
+                oskar_mem_double_const(in_xcorr, status),
+                oskar_mem_double_const(in_acorr, status), vis);
     else if (prec == OSKAR_SINGLE)
+        reorder_vis_f(num_times, num_channels, num_stations, num_baseln_in,
+                num_baseln_out, num_pols_in, num_pols_out, row_src,
+                oskar_mem_float_const(in_xcorr, status),
+                oskar_mem_float_const(in_acorr, status), vis);
+    else
     {
-        const float *uu_in, *vv_in, *ww_in;
-        float *uu_out, *vv_out, *ww_out;
-        uu_in = oskar_mem_float_const(in_uu, status);
-        vv_in = oskar_mem_float_const(in_vv, status);
-        ww_in = oskar_mem_float_const(in_ww, status);
-        uu_out = oskar_mem_float(temp_uu, status);
-        vv_out = oskar_mem_float(temp_vv, status);
-        ww_out = oskar_mem_float(temp_ww, status);
-        for (t = 0; t < num_times; ++t)
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+    oskar_ms_write_vis_rows_f(ms, start_time_index * num_baseln_out,
+            start_chan_index, num_channels, num_times * num_baseln_out, vis);
+
+    /* Write the baseline coordinates for each time step.
+     * These are only copied if auto-correlations need to be inserted. */
+    for (t = 0; t < num_times; ++t)
+    {
+        const unsigned int start_row = (start_time_index + t) * num_baseln_out;
+        const double time_stamp =
+                (start_time_index + t + 0.5) * interval_sec + t_start_sec;
+        if (prec == OSKAR_DOUBLE)
         {
-            /* Construct the baseline coordinates for the given time. */
-            unsigned int start_row = (start_time_index + t) * num_baseln_out;
-            for (a1 = 0, b = 0, i_out = 0; a1 < num_stations; ++a1)
+            const double *uu_in, *vv_in, *ww_in;
+            uu_in = oskar_mem_double_const(in_uu, status) + num_baseln_in * t;
+            vv_in = oskar_mem_double_const(in_vv, status) + num_baseln_in * t;
+            ww_in = oskar_mem_double_const(in_ww, status) + num_baseln_in * t;
+            if (have_autocorr)
             {
-                if (have_autocorr)
+                for (b = 0; b < num_baseln_out; ++b)
                 {
-                    uu_out[i_out] = 0.0;
-                    vv_out[i_out] = 0.0;
-                    ww_out[i_out] = 0.0;
-                    ++i_out;
-                }
-                if (have_crosscorr)
-                {
-                    for (a2 = a1 + 1; a2 < num_stations; ++a2, ++b, ++i_out)
-                    {
-                        i = num_baseln_in * t + b;
-                        uu_out[i_out] = uu_in[i];
-                        vv_out[i_out] = vv_in[i];
-                        ww_out[i_out] = ww_in[i];
-                    }
+                    i = row_src[b];
+                    ((double*)uu)[b] = (i < 0) ? 0.0 : uu_in[i];
+                    ((double*)vv)[b] = (i < 0) ? 0.0 : vv_in[i];
+                    ((double*)ww)[b] = (i < 0) ? 0.0 : ww_in[i];
                 }
+                uu_in = (const double*)uu;
+                vv_in = (const double*)vv;
+                ww_in = (const double*)ww;
             }
-
-            for (c = 0, i_out = 0; c < num_channels; ++c)
+            oskar_ms_write_coords_d(ms, start_row, num_baseln_out,
+                    uu_in, vv_in, ww_in, exposure_sec, interval_sec,
+                    time_stamp);
+        }
+        else
+        {
+            const float *uu_in, *vv_in, *ww_in;
+            uu_in = oskar_mem_float_const(in_uu, status) + num_baseln_in * t;
+            vv_in = oskar_mem_float_const(in_vv, status) + num_baseln_in * t;
+            ww_in = oskar_mem_float_const(in_ww, status) + num_baseln_in * t;
+            if (have_autocorr)
             {
-                /* Construct amplitude data for the given time and channel. */
-                if (num_pols_in == 4)
-                {
-                    for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                    {
-                        if (have_autocorr)
-                        {
-                            i = num_stations * (t * num_channels + c) + a1;
-                            ((float4c*)out)[i_out++] =
-                                    ((const float4c*)acorr)[i];
-                        }
-                        if (have_crosscorr)
-                        {
-                            for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                            {
-                                i = num_baseln_in * (t * num_channels + c) + b;
-                                ((float4c*)out)[i_out++] =
-                                        ((const float4c*)xcorr)[i];
-                            }
-                        }
-                    }
-                }
-                else if (num_pols_in == 1 && num_pols_out == 1)
+                for (b = 0; b < num_baseln_out; ++b)
                 {
-                    for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                    {
-                        if (have_autocorr)
-                        {
-                            i = num_stations * (t * num_channels + c) + a1;
-                            ((float2*)out)[i_out++] =
-                                    ((const float2*)acorr)[i];
-                        }
-                        if (have_crosscorr)
-                        {
-                            for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                            {
-                                i = num_baseln_in * (t * num_channels + c) + b;
-                                ((float2*)out)[i_out++] =
-                                        ((const float2*)xcorr)[i];
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    float2 vis_amp, *out_;
-                    out_ = (float2*)out;
-                    for (a1 = 0, b = 0; a1 < num_stations; ++a1)
-                    {
-                        if (have_autocorr)
-                        {
-                            i = num_stations * (t * num_channels + c) + a1;
-                            vis_amp = ((const float2*)acorr)[i];
-                            out_[i_out + 0] = vis_amp;  /* XX */
-                            out_[i_out + 1].x = 0.0;    /* XY */
-                            out_[i_out + 1].y = 0.0;    /* XY */
-                            out_[i_out + 2].x = 0.0;    /* YX */
-                            out_[i_out + 2].y = 0.0;    /* YX */
-                            out_[i_out + 3] = vis_amp;  /* YY */
-                            i_out += 4;
-                        }
-                        if (have_crosscorr)
-                        {
-                            for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
-                            {
-                                i = num_baseln_in * (t * num_channels + c) + b;
-                                vis_amp = ((const float2*)xcorr)[i];
-                                out_[i_out + 0] = vis_amp;  /* XX */
-                                out_[i_out + 1].x = 0.0;    /* XY */
-                                out_[i_out + 1].y = 0.0;    /* XY */
-                                out_[i_out + 2].x = 0.0;    /* YX */
-                                out_[i_out + 2].y = 0.0;    /* YX */
-                                out_[i_out + 3] = vis_amp;  /* YY */
-                                i_out += 4;
-                            }
-                        }
-                    }
+                    i = row_src[b];
+                    ((float*)uu)[b] = (i < 0) ? 0.0f : uu_in[i];
+                    ((float*)vv)[b] = (i < 0) ? 0.0f : vv_in[i];
+                    ((float*)ww)[b] = (i < 0) ? 0.0f : ww_in[i];
                 }
+                uu_in = (const float*)uu;
+                vv_in = (const float*)vv;
+                ww_in = (const float*)ww;
             }
             oskar_ms_write_coords_f(ms, start_row, num_baseln_out,
-                    uu_out, vv_out, ww_out, exposure_sec, interval_sec,
-                    (start_time_index + t + 0.5) * interval_sec + t_start_sec);
-            oskar_ms_write_vis_f(ms, start_row, start_chan_index,
-                    num_channels, num_baseln_out, (const float*)out);
+                    uu_in, vv_in, ww_in, exposure_sec, interval_sec,
+                    time_stamp);
         }
     }
-    else
-    {
-        *status = OSKAR_ERR_BAD_DATA_TYPE;
-    }
-
-    /* Cleanup. */
-    oskar_mem_free(temp_vis, status);
-    oskar_mem_free(temp_uu, status);
-    oskar_mem_free(temp_vv, status);
-    oskar_mem_free(temp_ww, status);
 }
 
 #ifdef __cplusplus
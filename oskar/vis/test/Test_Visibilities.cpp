@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -29,12 +29,15 @@
 #include <gtest/gtest.h>
 
 #include "vis/oskar_vis.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
 #include "utility/oskar_get_error_string.h"
 
 #include <cstring>
 #include <iostream>
 #include <cstdio>
 #include <cmath>
+#include <vector>
 
 TEST(Visibilities, create)
 {
@@ -293,3 +296,111 @@ TEST(Visibilities, read_write)
     // Delete temporary file.
     remove(filename);
 }
+
+
+TEST(Visibilities, read_blocks_mapped)
+{
+    int status = 0;
+    const int num_stations = 7, num_times = 11, max_times_per_block = 3;
+    const int num_channels = 4;
+    const int num_blocks = (num_times + max_times_per_block - 1) /
+            max_times_per_block;
+    const char* filename = "temp_test_vis_read_blocks_mapped.vis";
+
+    // Write a file with a few blocks of data.
+    oskar_VisHeader* hdr = oskar_vis_header_create(OSKAR_SINGLE_COMPLEX_MATRIX,
+            OSKAR_SINGLE, max_times_per_block, num_times, num_channels,
+            num_channels, num_stations, 1, 1, &status);
+    oskar_VisBlock* blk = oskar_vis_block_create_from_header(OSKAR_CPU,
+            hdr, &status);
+    oskar_Binary* h = oskar_vis_header_write(hdr, filename, &status);
+    for (int b = 0; b < num_blocks; ++b)
+    {
+        int block_times = num_times - b * max_times_per_block;
+        if (block_times > max_times_per_block)
+            block_times = max_times_per_block;
+        oskar_vis_block_set_num_times(blk, block_times, &status);
+        oskar_vis_block_set_start_time_index(blk, b * max_times_per_block);
+        oskar_mem_random_gaussian(oskar_vis_block_baseline_uu_metres(blk),
+                b, 1, 2, 3, 200.0, &status);
+        oskar_mem_random_gaussian(oskar_vis_block_baseline_vv_metres(blk),
+                b, 4, 5, 6, 200.0, &status);
+        oskar_mem_random_gaussian(oskar_vis_block_baseline_ww_metres(blk),
+                b, 7, 8, 9, 10.0, &status);
+        oskar_mem_random_gaussian(oskar_vis_block_cross_correlations(blk),
+                b, 10, 11, 12, 1.0, &status);
+        oskar_mem_random_gaussian(oskar_vis_block_auto_correlations(blk),
+                b, 13, 14, 15, 1.0, &status);
+        oskar_vis_block_write(blk, h, b, &status);
+    }
+    oskar_binary_free(h);
+    oskar_vis_block_free(blk, &status);
+    oskar_vis_header_free(hdr, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Read the blocks in reverse order, with and without memory mapping,
+    // and check that they match those read in the usual way.
+    for (int mapped = 0; mapped <= 1; ++mapped)
+    {
+        h = oskar_binary_create(filename, mapped ? 'm' : 'r', &status);
+        hdr = oskar_vis_header_read(h, &status);
+        blk = oskar_vis_block_create_from_header(OSKAR_CPU, hdr, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        for (int b = num_blocks - 1; b >= 0; --b)
+        {
+            oskar_VisBlock* alias = oskar_vis_block_create_alias_from_binary(
+                    hdr, h, b, &status);
+            oskar_vis_block_read(blk, hdr, h, b, &status);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            EXPECT_EQ(oskar_vis_block_start_time_index(blk),
+                    oskar_vis_block_start_time_index(alias));
+            EXPECT_EQ(oskar_vis_block_num_times(blk),
+                    oskar_vis_block_num_times(alias));
+            EXPECT_EQ(1, oskar_vis_block_has_auto_correlations(alias));
+            EXPECT_EQ(1, oskar_vis_block_has_cross_correlations(alias));
+            EXPECT_FALSE(oskar_mem_different(
+                    oskar_vis_block_cross_correlations(blk),
+                    oskar_vis_block_cross_correlations(alias), 0, &status));
+            EXPECT_FALSE(oskar_mem_different(
+                    oskar_vis_block_auto_correlations(blk),
+                    oskar_vis_block_auto_correlations(alias), 0, &status));
+            EXPECT_FALSE(oskar_mem_different(
+                    oskar_vis_block_baseline_uu_metres(blk),
+                    oskar_vis_block_baseline_uu_metres(alias), 0, &status));
+            EXPECT_FALSE(oskar_mem_different(
+                    oskar_vis_block_baseline_ww_metres(blk),
+                    oskar_vis_block_baseline_ww_metres(alias), 0, &status));
+            oskar_vis_block_free(alias, &status);
+        }
+
+        // If the file is mapped, read all the blocks concurrently.
+        if (mapped)
+        {
+            std::vector<int> times_read(num_blocks, 0);
+            std::vector<int> block_status(num_blocks, 0);
+#pragma omp parallel for
+            for (int b = 0; b < num_blocks; ++b)
+            {
+                oskar_VisBlock* alias =
+                        oskar_vis_block_create_alias_from_binary(
+                                hdr, h, b, &block_status[b]);
+                if (!block_status[b])
+                    times_read[b] = oskar_vis_block_num_times(alias);
+                oskar_vis_block_free(alias, &block_status[b]);
+            }
+            for (int b = 0; b < num_blocks; ++b)
+            {
+                int block_times = num_times - b * max_times_per_block;
+                if (block_times > max_times_per_block)
+                    block_times = max_times_per_block;
+                EXPECT_EQ(0, block_status[b]);
+                EXPECT_EQ(block_times, times_read[b]);
+            }
+        }
+        oskar_vis_block_free(blk, &status);
+        oskar_vis_header_free(hdr, &status);
+        oskar_binary_free(h);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+    remove(filename);
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "utility/oskar_get_error_string.h"
+#include "vis/oskar_bda.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
+
+#include <cmath>
+#include <vector>
+
+TEST(bda, averages_per_baseline)
+{
+    int status = 0;
+    const int num_stations = 3, num_baselines = 3, num_channels = 2;
+    const int num_times = 12, max_times_per_block = 5;
+    const double freq_start_hz = 100e6, freq_inc_hz = 1e6;
+    const double time_start_mjd = 58000.0, time_inc_sec = 1.0;
+    const double wavelength = 299792458.0 / (freq_start_hz + freq_inc_hz);
+
+    // Create the header.
+    oskar_VisHeader* hdr = oskar_vis_header_create(OSKAR_DOUBLE_COMPLEX,
+            OSKAR_DOUBLE, max_times_per_block, num_times, num_channels,
+            num_channels, num_stations, 0, 1, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_vis_header_set_freq_start_hz(hdr, freq_start_hz);
+    oskar_vis_header_set_freq_inc_hz(hdr, freq_inc_hz);
+    oskar_vis_header_set_time_start_mjd_utc(hdr, time_start_mjd);
+    oskar_vis_header_set_time_inc_sec(hdr, time_inc_sec);
+    oskar_vis_header_set_time_average_sec(hdr, time_inc_sec);
+    oskar_VisBlock* blk = oskar_vis_block_create_from_header(OSKAR_CPU,
+            hdr, &status);
+
+    // Limit averages to 4 samples, or 2.5 wavelengths.
+    oskar_BDA* bda = oskar_bda_create(hdr, 1, 4.0, 2.5, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Baseline 0 is stationary, so is limited only by the duration.
+    // Baseline 1 moves 1 wavelength per sample, so averages 3 samples.
+    // Baseline 2 moves 10 wavelengths per sample, so is not averaged.
+    // The real part of each amplitude is its time index, and
+    // the imaginary part is its channel index.
+    std::vector<int> a1, a2;
+    std::vector<double> uu, time, weight, exposure;
+    std::vector<float> vis;
+    for (int start = 0; start < num_times; start += max_times_per_block)
+    {
+        int block_times = num_times - start;
+        if (block_times > max_times_per_block)
+            block_times = max_times_per_block;
+        oskar_vis_block_set_start_time_index(blk, start);
+        oskar_vis_block_set_num_times(blk, block_times, &status);
+        double* u = oskar_mem_double(
+                oskar_vis_block_baseline_uu_metres(blk), &status);
+        double* v = oskar_mem_double(
+                oskar_vis_block_baseline_vv_metres(blk), &status);
+        double* w = oskar_mem_double(
+                oskar_vis_block_baseline_ww_metres(blk), &status);
+        double* amp = oskar_mem_double(
+                oskar_vis_block_cross_correlations(blk), &status);
+        for (int t = 0; t < block_times; ++t)
+        {
+            const int i = t * num_baselines;
+            const double time_index = start + t;
+            u[i + 0] = 10.0;
+            u[i + 1] = time_index * wavelength;
+            u[i + 2] = time_index * 10.0 * wavelength;
+            for (int b = 0; b < num_baselines; ++b)
+                v[i + b] = w[i + b] = 0.0;
+            for (int c = 0; c < num_channels; ++c)
+            {
+                for (int b = 0; b < num_baselines; ++b)
+                {
+                    const int j = (t * num_channels + c) * num_baselines + b;
+                    amp[2 * j + 0] = time_index;
+                    amp[2 * j + 1] = c;
+                }
+            }
+        }
+        oskar_bda_add_block(bda, blk, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Collect the completed rows.
+        const int num_rows = oskar_bda_num_rows(bda);
+        for (int r = 0; r < num_rows; ++r)
+        {
+            a1.push_back(oskar_bda_antenna1(bda)[r]);
+            a2.push_back(oskar_bda_antenna2(bda)[r]);
+            uu.push_back(oskar_bda_uu_metres(bda)[r]);
+            time.push_back(oskar_bda_time_centroid(bda)[r]);
+            weight.push_back(oskar_bda_weight(bda)[r]);
+            exposure.push_back(oskar_bda_exposure_sec(bda)[r]);
+            for (int c = 0; c < num_channels; ++c)
+            {
+                vis.push_back(oskar_bda_vis(bda)[2 * (r * num_channels + c)]);
+                vis.push_back(
+                        oskar_bda_vis(bda)[2 * (r * num_channels + c) + 1]);
+            }
+        }
+        oskar_bda_clear_rows(bda);
+    }
+
+    // Check the number of rows on each baseline, and their contents.
+    const int expected_rows[] = {3, 4, 12};
+    int rows[] = {0, 0, 0};
+    double total_weight[] = {0.0, 0.0, 0.0};
+    ASSERT_EQ(19, (int) a1.size());
+    ASSERT_EQ(19, oskar_bda_num_rows_total(bda));
+    for (size_t r = 0; r < a1.size(); ++r)
+    {
+        const int b = (a1[r] == 0) ? (a2[r] == 1 ? 0 : 1) : 2;
+        rows[b]++;
+        total_weight[b] += weight[r];
+        EXPECT_DOUBLE_EQ(weight[r] * time_inc_sec, exposure[r]);
+
+        // The mean time index is the mean real amplitude.
+        const double mean_t =
+                (time[r] - time_start_mjd * 86400.0) / time_inc_sec - 0.5;
+        for (int c = 0; c < num_channels; ++c)
+        {
+            EXPECT_NEAR(mean_t, vis[2 * (r * num_channels + c)], 1e-6);
+            EXPECT_NEAR(c, vis[2 * (r * num_channels + c) + 1], 1e-6);
+        }
+        if (b == 0)
+            EXPECT_DOUBLE_EQ(10.0, uu[r]);
+        else
+            EXPECT_NEAR(mean_t * wavelength * (b == 1 ? 1.0 : 10.0),
+                    uu[r], 1e-6);
+    }
+    for (int b = 0; b < num_baselines; ++b)
+    {
+        EXPECT_EQ(expected_rows[b], rows[b]);
+        EXPECT_DOUBLE_EQ((double) num_times, total_weight[b]);
+    }
+
+    oskar_bda_free(bda);
+    oskar_vis_block_free(blk, &status);
+    oskar_vis_header_free(hdr, &status);
+}
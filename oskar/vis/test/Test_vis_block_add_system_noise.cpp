@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2017, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "math/oskar_find_closest_match.h"
+#include "math/oskar_random_gaussian.h"
+#include "telescope/oskar_telescope.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_timer.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef OSKAR_HAVE_CUDA
+static int device_loc = OSKAR_GPU;
+#else
+static int device_loc = OSKAR_CPU;
+#endif
+
+// Serial reference version, with one call per channel.
+/* Applies noise to data in a visibility block, for the given channel. */
+static void reference_apply_noise(oskar_VisBlock* vis,
+        const oskar_Mem* station_std_dev, unsigned int seed,
+        unsigned int block_idx, unsigned int channel_idx,
+        double channel_bandwidth_hz, double time_int_sec, int* status)
+{
+    int a1, a2, have_autocorr, have_crosscorr, block_start, b, c = 0, t;
+    int num_baselines, num_channels, num_stations, num_times;
+    void *acorr_ptr, *xcorr_ptr;
+    (void)num_times;
+    double rnd[8], std, mean, sefd_conversion;
+    const double inv_sqrt2 = 1.0 / sqrt(2.0);
+
+    /* Get pointer to start of block, and block dimensions. */
+    have_autocorr  = oskar_vis_block_has_auto_correlations(vis);
+    have_crosscorr = oskar_vis_block_has_cross_correlations(vis);
+    acorr_ptr      = oskar_mem_void(oskar_vis_block_auto_correlations(vis));
+    xcorr_ptr      = oskar_mem_void(oskar_vis_block_cross_correlations(vis));
+    num_baselines  = oskar_vis_block_num_baselines(vis);
+    num_channels   = oskar_vis_block_num_channels(vis);
+    num_stations   = oskar_vis_block_num_stations(vis);
+    num_times      = oskar_vis_block_num_times(vis);
+
+    /* Get factor for conversion of sigma to SEFD. */
+    sefd_conversion = sqrt(2.0*channel_bandwidth_hz * time_int_sec);
+
+    /* If we are adding noise directly to Stokes I, the noise is defined
+     * as single dipole noise, so we have to divide by sqrt(2) to take into
+     * account of the two different dipoles that go into the calculation of
+     * Stokes I. For polarised visibilities this is not required, as this
+     * falls out naturally when evaluating Stokes I from the dipole
+     * correlations (i.e. I = 0.5 (XX+YY) ). */
+
+    switch (oskar_mem_type(oskar_vis_block_cross_correlations(vis)))
+    {
+    case OSKAR_SINGLE_COMPLEX:
+    {
+        const float* station_std;
+        float2* data;
+        station_std = oskar_mem_float_const(station_std_dev, status);
+        for (t = 0; t < num_times; ++t)
+        {
+            if (have_crosscorr)
+            {
+                /* Cross-correlation noise. */
+                block_start = num_baselines * (num_channels * t + channel_idx);
+                data = (float2*) xcorr_ptr + block_start;
+                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
+                {
+                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
+                    {
+                        oskar_random_gaussian2(seed, c++, block_idx, rnd);
+                        std = sqrt((double)(station_std[a1] * station_std[a2])) * inv_sqrt2;
+                        data[b].x += std * rnd[0];
+                        data[b].y += std * rnd[1];
+                    }
+                }
+            }
+
+            if (have_autocorr)
+            {
+                /* Autocorrelation noise. Phases are all zero after
+                 * autocorrelation, so ignore the imaginary components. */
+                block_start = num_stations * (num_channels * t + channel_idx);
+                data = (float2*) acorr_ptr + block_start;
+                for (a1 = 0; a1 < num_stations; ++a1)
+                {
+                    oskar_random_gaussian2(seed, c++, block_idx, rnd);
+                    std = (double)station_std[a1];
+                    mean = sqrt(2.0)*station_std[a1];
+                    data[a1].x += std * rnd[0] + mean * sefd_conversion;
+                }
+            }
+        }
+        break;
+    }
+    case OSKAR_SINGLE_COMPLEX_MATRIX:
+    {
+        const float* station_std;
+        float4c* data;
+        station_std = oskar_mem_float_const(station_std_dev, status);
+        for (t = 0; t < num_times; ++t)
+        {
+            if (have_crosscorr)
+            {
+                /* Cross-correlation noise. */
+                block_start = num_baselines * (num_channels * t + channel_idx);
+                data = (float4c*) xcorr_ptr + block_start;
+                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
+                {
+                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
+                    {
+                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
+                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd + 4);
+                        std = sqrt((double)(station_std[a1] * station_std[a2]));
+                        data[b].a.x += std * rnd[0];
+                        data[b].a.y += std * rnd[1];
+                        data[b].b.x += std * rnd[2];
+                        data[b].b.y += std * rnd[3];
+                        data[b].c.x += std * rnd[4];
+                        data[b].c.y += std * rnd[5];
+                        data[b].d.x += std * rnd[6];
+                        data[b].d.y += std * rnd[7];
+                    }
+                }
+            }
+
+            if (have_autocorr)
+            {
+                /* Autocorrelation noise. Phases are all zero after
+                 * autocorrelation, so ignore the imaginary components. */
+                block_start = num_stations * (num_channels * t + channel_idx);
+                data = (float4c*) acorr_ptr + block_start;
+                for (a1 = 0; a1 < num_stations; ++a1)
+                {
+                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
+                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd + 4);
+                    std = station_std[a1] * sqrt(2.0);
+                    mean = std * sefd_conversion;
+                    data[a1].a.x += std * rnd[0] + mean;
+                    data[a1].b.x += std * rnd[1];
+                    data[a1].b.y += std * rnd[2];
+                    data[a1].c.x += std * rnd[3];
+                    data[a1].c.y += std * rnd[4];
+                    data[a1].d.x += std * rnd[5] + mean;
+                }
+            }
+        }
+        break;
+    }
+    case OSKAR_DOUBLE_COMPLEX:
+    {
+        const double* station_std;
+        double2* data;
+        station_std = oskar_mem_double_const(station_std_dev, status);
+        for (t = 0; t < num_times; ++t)
+        {
+            if (have_crosscorr)
+            {
+                /* Cross-correlation noise. */
+                block_start = num_baselines * (num_channels * t + channel_idx);
+                data = (double2*) xcorr_ptr + block_start;
+                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
+                {
+                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
+                    {
+                        oskar_random_gaussian2(seed, c++, block_idx, rnd);
+                        std = sqrt((double)(station_std[a1] * station_std[a2])) * inv_sqrt2;
+                        data[b].x += std * rnd[0];
+                        data[b].y += std * rnd[1];
+                    }
+                }
+            }
+
+            if (have_autocorr)
+            {
+                /* Autocorrelation noise. Phases are all zero after
+                 * autocorrelation, so ignore the imaginary components. */
+                block_start = num_stations * (num_channels * t + channel_idx);
+                data = (double2*) acorr_ptr + block_start;
+                for (a1 = 0; a1 < num_stations; ++a1)
+                {
+                    oskar_random_gaussian2(seed, c++, block_idx, rnd);
+                    std  = station_std[a1];
+                    mean = station_std[a1] * sefd_conversion * sqrt(2.0);
+                    data[a1].x += std * rnd[0] + mean;
+                }
+            }
+        }
+        break;
+    }
+    case OSKAR_DOUBLE_COMPLEX_MATRIX:
+    {
+        const double* station_std;
+        double4c* data;
+        station_std = oskar_mem_double_const(station_std_dev, status);
+        for (t = 0; t < num_times; ++t)
+        {
+            if (have_crosscorr)
+            {
+                /* Cross-correlation noise. */
+                block_start = num_baselines * (num_channels * t + channel_idx);
+                data = (double4c*) xcorr_ptr + block_start;
+                for (a1 = 0, b = 0; a1 < num_stations; ++a1)
+                {
+                    for (a2 = a1 + 1; a2 < num_stations; ++b, ++a2)
+                    {
+                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
+                        oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd + 4);
+                        std = sqrt((double)(station_std[a1] * station_std[a2]));
+                        data[b].a.x += std * rnd[0];
+                        data[b].a.y += std * rnd[1];
+                        data[b].b.x += std * rnd[2];
+                        data[b].b.y += std * rnd[3];
+                        data[b].c.x += std * rnd[4];
+                        data[b].c.y += std * rnd[5];
+                        data[b].d.x += std * rnd[6];
+                        data[b].d.y += std * rnd[7];
+                    }
+                }
+            }
+
+            if (have_autocorr)
+            {
+                /* Autocorrelation noise. Phases are all zero after
+                 * autocorrelation, so ignore the imaginary components. */
+                block_start = num_stations * (num_channels * t + channel_idx);
+                data = (double4c*) acorr_ptr + block_start;
+                for (a1 = 0; a1 < num_stations; ++a1)
+                {
+                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd);
+                    oskar_random_gaussian4(seed, c++, block_idx, 0, 0, rnd+4);
+                    std  = station_std[a1]*sqrt(2.0);
+                    mean = std * sefd_conversion;
+                    data[a1].a.x += std * rnd[0] + mean;
+                    data[a1].b.x += std * rnd[1];
+                    data[a1].b.y += std * rnd[2];
+                    data[a1].c.x += std * rnd[3];
+                    data[a1].c.y += std * rnd[4];
+                    data[a1].d.x += std * rnd[5] + mean;
+                }
+            }
+        }
+        break;
+    }
+    };
+}
+
+
+static void reference_add_noise(oskar_VisBlock* vis,
+        const oskar_VisHeader* header, const oskar_Telescope* tel,
+        unsigned int block_index, oskar_Mem* std_dev, int* status)
+{
+    int num_stations = oskar_telescope_num_stations(tel);
+    oskar_mem_realloc(std_dev, num_stations, status);
+    for (int c = 0; c < oskar_vis_block_num_channels(vis); ++c)
+    {
+        double freq_hz = oskar_vis_header_freq_start_hz(header) +
+                c * oskar_vis_header_freq_inc_hz(header);
+        for (int i = 0; i < num_stations; ++i)
+        {
+            const oskar_Station* s = oskar_telescope_station_const(tel, i);
+            int j = oskar_find_closest_match(freq_hz,
+                    oskar_station_noise_freq_hz_const(s), status);
+            oskar_mem_copy_contents(std_dev,
+                    oskar_station_noise_rms_jy_const(s), i, j, 1, status);
+        }
+        reference_apply_noise(vis, std_dev, oskar_telescope_noise_seed(tel),
+                block_index, c, oskar_vis_header_channel_bandwidth_hz(header),
+                oskar_vis_header_time_average_sec(header), status);
+    }
+}
+
+static void fill_block(oskar_VisBlock* vis, int* status)
+{
+    oskar_Mem* xc = oskar_vis_block_cross_correlations(vis);
+    oskar_Mem* ac = oskar_vis_block_auto_correlations(vis);
+    oskar_mem_random_uniform(xc, 1, 2, 3, 4, status);
+    oskar_mem_random_uniform(ac, 5, 6, 7, 8, status);
+}
+
+TEST(vis_block_add_system_noise, matches_serial_reference)
+{
+    const int num_stations = 40, num_times = 3, num_channels = 4;
+    const unsigned int block_index = 5;
+    const int types[] = {OSKAR_SINGLE_COMPLEX, OSKAR_SINGLE_COMPLEX_MATRIX,
+            OSKAR_DOUBLE_COMPLEX, OSKAR_DOUBLE_COMPLEX_MATRIX};
+    oskar_Timer* tmr = oskar_timer_create(OSKAR_TIMER_NATIVE);
+    for (int k = 0; k < 4; ++k)
+    {
+        int status = 0;
+        const int type = types[k];
+        const int prec = oskar_type_precision(type);
+
+        // Create a telescope model with two noise frequencies per station.
+        oskar_Telescope* tel = oskar_telescope_create(prec, OSKAR_CPU,
+                num_stations, &status);
+        oskar_telescope_set_enable_noise(tel, 1, 42);
+        for (int i = 0; i < num_stations; ++i)
+        {
+            oskar_Station* s = oskar_telescope_station(tel, i);
+            oskar_Mem* f = oskar_station_noise_freq_hz(s);
+            oskar_Mem* r = oskar_station_noise_rms_jy(s);
+            oskar_mem_realloc(f, 2, &status);
+            oskar_mem_realloc(r, 2, &status);
+            oskar_mem_set_element_real(f, 0, 100e6, &status);
+            oskar_mem_set_element_real(f, 1, 200e6, &status);
+            oskar_mem_set_element_real(r, 0, 1.0 + 0.1 * i, &status);
+            oskar_mem_set_element_real(r, 1, 2.0 + 0.05 * i, &status);
+        }
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Create a visibility header and blocks.
+        oskar_VisHeader* hdr = oskar_vis_header_create(type, prec,
+                num_times, num_times, num_channels, num_channels,
+                num_stations, 1, 1, &status);
+        oskar_vis_header_set_freq_start_hz(hdr, 100e6);
+        oskar_vis_header_set_freq_inc_hz(hdr, 40e6);
+        oskar_vis_header_set_channel_bandwidth_hz(hdr, 1e6);
+        oskar_vis_header_set_time_average_sec(hdr, 10.0);
+        oskar_VisBlock* ref = oskar_vis_block_create_from_header(OSKAR_CPU,
+                hdr, &status);
+        oskar_VisBlock* out = oskar_vis_block_create_from_header(OSKAR_CPU,
+                hdr, &status);
+        fill_block(ref, &status);
+        oskar_vis_block_copy(out, ref, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Add noise using the serial reference version.
+        oskar_Mem* work = oskar_mem_create(prec, OSKAR_CPU, 0, &status);
+        oskar_timer_start(tmr);
+        reference_add_noise(ref, hdr, tel, block_index, work, &status);
+        double t_ref = oskar_timer_elapsed(tmr);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Add noise using the parallel version, with 1 and then all threads.
+        // Results must be identical to the reference.
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            oskar_VisBlock* test = oskar_vis_block_create_from_header(
+                    OSKAR_CPU, hdr, &status);
+            oskar_vis_block_copy(test, out, &status);
+#ifdef _OPENMP
+            int num_threads = omp_get_max_threads();
+            if (pass == 0) omp_set_num_threads(1);
+#endif
+            oskar_timer_start(tmr);
+            oskar_vis_block_add_system_noise(test, hdr, tel, block_index,
+                    work, &status);
+            double t_test = oskar_timer_elapsed(tmr);
+#ifdef _OPENMP
+            omp_set_num_threads(num_threads);
+#endif
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            int len_xc = (int)oskar_mem_length(
+                    oskar_vis_block_cross_correlations(ref));
+            int len_ac = (int)oskar_mem_length(
+                    oskar_vis_block_auto_correlations(ref));
+            EXPECT_EQ(0, memcmp(
+                    oskar_mem_void_const(oskar_vis_block_cross_correlations(ref)),
+                    oskar_mem_void_const(oskar_vis_block_cross_correlations(test)),
+                    len_xc * oskar_mem_element_size(type)));
+            EXPECT_EQ(0, memcmp(
+                    oskar_mem_void_const(oskar_vis_block_auto_correlations(ref)),
+                    oskar_mem_void_const(oskar_vis_block_auto_correlations(test)),
+                    len_ac * oskar_mem_element_size(type)));
+            if (pass == 1)
+                printf("Type %d: serial %.4f s, parallel %.4f s\n",
+                        type, t_ref, t_test);
+            oskar_vis_block_free(test, &status);
+        }
+
+        // Check the version on the device gives the same result, to within
+        // rounding of the device maths library.
+        if (device_loc != OSKAR_CPU)
+        {
+            oskar_VisBlock* test = oskar_vis_block_create_from_header(
+                    device_loc, hdr, &status);
+            oskar_vis_block_copy(test, out, &status);
+            oskar_vis_block_add_system_noise(test, hdr, tel, block_index,
+                    work, &status);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            oskar_VisBlock* temp = oskar_vis_block_create_from_header(
+                    OSKAR_CPU, hdr, &status);
+            oskar_vis_block_copy(temp, test, &status);
+            double max_err = 0.0;
+            oskar_mem_evaluate_relative_error(
+                    oskar_vis_block_cross_correlations(temp),
+                    oskar_vis_block_cross_correlations(ref),
+                    0, &max_err, 0, 0, &status);
+            EXPECT_LT(max_err, prec == OSKAR_SINGLE ? 1e-5 : 1e-10);
+            oskar_vis_block_free(temp, &status);
+            oskar_vis_block_free(test, &status);
+        }
+
+        oskar_mem_free(work, &status);
+        oskar_vis_block_free(ref, &status);
+        oskar_vis_block_free(out, &status);
+        oskar_vis_header_free(hdr, &status);
+        oskar_telescope_free(tel, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+    oskar_timer_free(tmr);
+}
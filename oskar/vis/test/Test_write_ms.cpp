@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2017, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -38,6 +38,7 @@
 #include "math/oskar_cmath.h"
 
 #include <cstdio>
+#include <cstdlib>
 
 TEST(write_ms, test_write)
 {
@@ -221,3 +222,79 @@ TEST(write_ms, test_write_partial)
     oskar_dir_remove(filename);
 }
 
+
+
+TEST(write_ms, test_write_read_autocorrelations)
+{
+    int status = 0;
+    int num_antennas  = 4;
+    int num_channels  = 3;
+    int num_times     = 3;
+    int num_baselines = num_antennas * (num_antennas - 1) / 2;
+    int num_rows      = num_baselines + num_antennas;
+
+    // Create a visibility block with auto- and cross-correlations.
+    oskar_VisHeader* hdr = oskar_vis_header_create(OSKAR_SINGLE_COMPLEX_MATRIX,
+            OSKAR_SINGLE, num_times, num_times, num_channels,
+            num_channels, num_antennas, 1, 1, &status);
+    oskar_VisBlock* blk = oskar_vis_block_create_from_header(OSKAR_CPU,
+            hdr, &status);
+    float* xc = oskar_mem_float(
+            oskar_vis_block_cross_correlations(blk), &status);
+    float* ac = oskar_mem_float(
+            oskar_vis_block_auto_correlations(blk), &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    int num_xc = num_times * num_channels * num_baselines * 8;
+    int num_ac = num_times * num_channels * num_antennas * 8;
+    for (int i = 0; i < num_xc; ++i) xc[i] = (float)i + 0.5f;
+    for (int i = 0; i < num_ac; ++i) ac[i] = -(float)i - 0.5f;
+    oskar_vis_header_set_phase_centre(hdr, 0, 160.0, 89.0);
+    oskar_vis_header_set_freq_start_hz(hdr, 222.22e6);
+    oskar_vis_header_set_freq_inc_hz(hdr, 11.1e6);
+    oskar_vis_header_set_time_start_mjd_utc(hdr,
+            oskar_convert_date_time_to_mjd(2011, 11, 17, 0.0));
+    oskar_vis_header_set_time_inc_sec(hdr, 1.0);
+
+    // Write the block.
+    const char filename[] = "temp_test_write_ms_auto.ms";
+    oskar_MeasurementSet* ms = oskar_vis_header_write_ms(hdr, filename,
+            OSKAR_TRUE, OSKAR_FALSE, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_vis_block_write_ms(blk, hdr, ms, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Read it back and check each row, one time step at a time.
+    float* vis = (float*) malloc(num_channels * num_rows * 8 * sizeof(float));
+    for (int t = 0; t < num_times; ++t)
+    {
+        oskar_ms_read_vis_f(ms, t * num_rows, 0, num_channels, num_rows,
+                "DATA", vis, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        for (int c = 0; c < num_channels; ++c)
+        {
+            for (int a1 = 0, b = 0, r = 0; a1 < num_antennas; ++a1)
+            {
+                const float* in = ac +
+                        8 * (num_antennas * (t * num_channels + c) + a1);
+                const float* out = vis + 8 * (num_rows * c + r);
+                for (int k = 0; k < 8; ++k) EXPECT_FLOAT_EQ(in[k], out[k]);
+                ++r;
+                for (int a2 = a1 + 1; a2 < num_antennas; ++a2, ++b, ++r)
+                {
+                    in = xc + 8 * (num_baselines * (t * num_channels + c) + b);
+                    out = vis + 8 * (num_rows * c + r);
+                    for (int k = 0; k < 8; ++k)
+                        EXPECT_FLOAT_EQ(in[k], out[k]);
+                }
+            }
+        }
+    }
+
+    // Clean up.
+    free(vis);
+    oskar_vis_header_free(hdr, &status);
+    oskar_vis_block_free(blk, &status);
+    oskar_ms_close(ms);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    oskar_dir_remove(filename);
+}
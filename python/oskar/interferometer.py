@@ -385,6 +385,19 @@ class Interferometer(object):
         _interferometer_lib.set_telescope_model(
             self._capsule, telescope_model.capsule)
 
+    def set_use_opencl(self, value):
+        """Sets whether OpenCL devices are used instead of CUDA devices.
+
+        All available devices of the selected type are used.
+        The OpenCL device type and vendor can be restricted using the
+        environment variables OSKAR_CL_DEVICE_TYPE and OSKAR_CL_DEVICE_VENDOR.
+
+        Args:
+            value (bool): If set, use OpenCL devices.
+        """
+        self.capsule_ensure()
+        _interferometer_lib.set_use_opencl(self._capsule, value)
+
     def vis_header(self):
         """Returns the visibility header.
 
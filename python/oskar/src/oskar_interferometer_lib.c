@@ -536,6 +536,27 @@ static PyObject* set_telescope_model(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_use_opencl(PyObject* self, PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    int status = 0, value = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &capsule, &value)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_use_opencl(h, value, &status);
+
+    /* Check for errors. */
+    if (status)
+    {
+        PyErr_Format(PyExc_RuntimeError,
+                "oskar_interferometer_set_use_opencl() failed with code %d (%s).",
+                status, oskar_get_error_string(status));
+        return 0;
+    }
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_zero_failed_gaussians(PyObject* self, PyObject* args)
 {
     oskar_Interferometer* h = 0;
@@ -655,6 +676,8 @@ static PyMethodDef methods[] =
                 METH_VARARGS, "set_sky_model(sky)"},
         {"set_telescope_model", (PyCFunction)set_telescope_model,
                 METH_VARARGS, "set_telescope_model(telescope)"},
+        {"set_use_opencl", (PyCFunction)set_use_opencl,
+                METH_VARARGS, "set_use_opencl(value)"},
         {"set_zero_failed_gaussians", (PyCFunction)set_zero_failed_gaussians,
                 METH_VARARGS, "set_zero_failed_gaussians(value)"},
         {"vis_header", (PyCFunction)vis_header, METH_VARARGS, "vis_header()"},